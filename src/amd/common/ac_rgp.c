@@ -1169,9 +1169,20 @@ int ac_dump_rgp_capture(struct radeon_info *info,
    t = time(NULL);
    now = *localtime(&t);
 
-   snprintf(filename, sizeof(filename), "/tmp/%s_%04d.%02d.%02d_%02d.%02d.%02d.rgp",
-            util_get_process_name(), 1900 + now.tm_year, now.tm_mon + 1, now.tm_mday, now.tm_hour,
-            now.tm_min, now.tm_sec);
+   int len = snprintf(filename, sizeof(filename), "/tmp/%s_%04d.%02d.%02d_%02d.%02d.%02d",
+                      util_get_process_name(), 1900 + now.tm_year, now.tm_mon + 1, now.tm_mday,
+                      now.tm_hour, now.tm_min, now.tm_sec);
+   if (len < 0 || (size_t)len >= sizeof(filename) - 16)
+      return -1;
+
+   /* Periodic captures can end several times within the same second, don't
+    * overwrite the previous one.
+    */
+   snprintf(filename + len, sizeof(filename) - len, ".rgp");
+   for (unsigned i = 1; (f = fopen(filename, "r")); i++) {
+      fclose(f);
+      snprintf(filename + len, sizeof(filename) - len, "_%u.rgp", i);
+   }
 
    f = fopen(filename, "w+");
    if (!f)
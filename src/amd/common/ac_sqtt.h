@@ -43,6 +43,8 @@ struct ac_thread_trace_data {
    void *ptr;
    uint32_t buffer_size;
    int start_frame;
+   /* When non-zero, capture again every interval frames after start_frame. */
+   unsigned interval;
    char *trigger_file;
 
    struct rgp_code_object rgp_code_object;
@@ -35,6 +35,7 @@
 #include "amd_family.h"
 #include "sid.h"
 #include "util/hash_table.h"
+#include "util/list.h"
 #include "util/macros.h"
 #include "util/simple_mtx.h"
 #include "util/u_atomic.h"
@@ -91,9 +92,33 @@
 #define CIASICIDGFXENGINE_ARCTICISLAND 0x0000000D
 #endif
 
+#define AC_SURF_CACHE_SIZE 64
+
 struct ac_addrlib {
    ADDR_HANDLE handle;
    simple_mtx_t lock;
+
+   /* Recently computed surfaces, most recently used first. */
+   simple_mtx_t surf_cache_lock;
+   struct hash_table *surf_cache;
+   struct list_head surf_cache_lru;
+};
+
+/* Everything the computed layout depends on. The input radeon_surf contains the flags, the
+ * modifier, the format and the hints. The surface index counters are left out because
+ * surfaces using them are never cached.
+ */
+struct ac_surf_cache_key {
+   struct ac_surf_info info;
+   uint8_t is_1d, is_3d, is_cube;
+   enum radeon_surf_mode mode;
+   struct radeon_surf surf;
+};
+
+struct ac_surf_cache_entry {
+   struct list_head link;
+   struct ac_surf_cache_key key;
+   struct radeon_surf surf;
 };
 
 bool ac_modifier_has_dcc(uint64_t modifier)
@@ -492,6 +517,16 @@ static ADDR_E_RETURNCODE ADDR_API freeSysMem(const ADDR_FREESYSMEM_INPUT *pInput
    return ADDR_OK;
 }
 
+static uint32_t ac_surf_cache_key_hash(const void *key)
+{
+   return _mesa_hash_data(key, sizeof(struct ac_surf_cache_key));
+}
+
+static bool ac_surf_cache_key_equals(const void *a, const void *b)
+{
+   return memcmp(a, b, sizeof(struct ac_surf_cache_key)) == 0;
+}
+
 struct ac_addrlib *ac_addrlib_create(const struct radeon_info *info,
                                      uint64_t *max_alignment)
 {
@@ -562,11 +597,19 @@ struct ac_addrlib *ac_addrlib_create(const struct radeon_info *info,
 
    addrlib->handle = addrCreateOutput.hLib;
    simple_mtx_init(&addrlib->lock, mtx_plain);
+   simple_mtx_init(&addrlib->surf_cache_lock, mtx_plain);
+   addrlib->surf_cache = _mesa_hash_table_create(NULL, ac_surf_cache_key_hash,
+                                                 ac_surf_cache_key_equals);
+   list_inithead(&addrlib->surf_cache_lru);
    return addrlib;
 }
 
 void ac_addrlib_destroy(struct ac_addrlib *addrlib)
 {
+   list_for_each_entry_safe(struct ac_surf_cache_entry, entry, &addrlib->surf_cache_lru, link)
+      free(entry);
+   _mesa_hash_table_destroy(addrlib->surf_cache, NULL);
+   simple_mtx_destroy(&addrlib->surf_cache_lock);
    simple_mtx_destroy(&addrlib->lock);
    AddrDestroy(addrlib->handle);
    free(addrlib);
@@ -2484,9 +2527,9 @@ static int gfx9_compute_surface(struct ac_addrlib *addrlib, const struct radeon_
    return 0;
 }
 
-int ac_compute_surface(struct ac_addrlib *addrlib, const struct radeon_info *info,
-                       const struct ac_surf_config *config, enum radeon_surf_mode mode,
-                       struct radeon_surf *surf)
+static int ac_compute_surface_uncached(struct ac_addrlib *addrlib, const struct radeon_info *info,
+                                       const struct ac_surf_config *config,
+                                       enum radeon_surf_mode mode, struct radeon_surf *surf)
 {
    int r;
 
@@ -2548,6 +2591,82 @@ int ac_compute_surface(struct ac_addrlib *addrlib, const struct radeon_info *inf
    return 0;
 }
 
+/* Computing a layout goes through addrlib and is fairly expensive, while apps streaming textures
+ * tend to create the same images over and over, so the last few results are cached.
+ */
+int ac_compute_surface(struct ac_addrlib *addrlib, const struct radeon_info *info,
+                       const struct ac_surf_config *config, enum radeon_surf_mode mode,
+                       struct radeon_surf *surf)
+{
+   /* The surface index counters make the tile swizzle differ for every surface. */
+   if (config->info.surf_index || config->info.fmask_surf_index)
+      return ac_compute_surface_uncached(addrlib, info, config, mode, surf);
+
+   struct ac_surf_cache_key key;
+
+   /* Zero the padding too, keys are compared with memcmp. */
+   memset(&key, 0, sizeof(key));
+   key.info.width = config->info.width;
+   key.info.height = config->info.height;
+   key.info.depth = config->info.depth;
+   key.info.samples = config->info.samples;
+   key.info.storage_samples = config->info.storage_samples;
+   key.info.levels = config->info.levels;
+   key.info.num_channels = config->info.num_channels;
+   key.info.array_size = config->info.array_size;
+   key.is_1d = config->is_1d;
+   key.is_3d = config->is_3d;
+   key.is_cube = config->is_cube;
+   key.mode = mode;
+   memcpy(&key.surf, surf, sizeof(*surf));
+
+   simple_mtx_lock(&addrlib->surf_cache_lock);
+   struct hash_entry *he = _mesa_hash_table_search(addrlib->surf_cache, &key);
+   if (he) {
+      struct ac_surf_cache_entry *entry = he->data;
+
+      list_del(&entry->link);
+      list_add(&entry->link, &addrlib->surf_cache_lru);
+      memcpy(surf, &entry->surf, sizeof(*surf));
+      simple_mtx_unlock(&addrlib->surf_cache_lock);
+      return 0;
+   }
+   simple_mtx_unlock(&addrlib->surf_cache_lock);
+
+   int r = ac_compute_surface_uncached(addrlib, info, config, mode, surf);
+   if (r)
+      return r;
+
+   struct ac_surf_cache_entry *entry = malloc(sizeof(*entry));
+   if (!entry)
+      return 0;
+
+   memcpy(&entry->key, &key, sizeof(key));
+   memcpy(&entry->surf, surf, sizeof(*surf));
+
+   simple_mtx_lock(&addrlib->surf_cache_lock);
+   if (_mesa_hash_table_search(addrlib->surf_cache, &entry->key)) {
+      /* Another thread computed the same surface in the meantime. */
+      simple_mtx_unlock(&addrlib->surf_cache_lock);
+      free(entry);
+      return 0;
+   }
+
+   if (addrlib->surf_cache->entries >= AC_SURF_CACHE_SIZE) {
+      struct ac_surf_cache_entry *oldest =
+         list_last_entry(&addrlib->surf_cache_lru, struct ac_surf_cache_entry, link);
+
+      _mesa_hash_table_remove_key(addrlib->surf_cache, &oldest->key);
+      list_del(&oldest->link);
+      free(oldest);
+   }
+
+   _mesa_hash_table_insert(addrlib->surf_cache, &entry->key, entry);
+   list_add(&entry->link, &addrlib->surf_cache_lru);
+   simple_mtx_unlock(&addrlib->surf_cache_lock);
+   return 0;
+}
+
 /* This is meant to be used for disabling DCC. */
 void ac_surface_zero_dcc_fields(struct radeon_surf *surf)
 {
@@ -252,17 +252,23 @@ public:
 
    std::array<uint32_t, 512> regs;
    std::map<uint32_t, std::array<uint32_t, 4>> subdword_regs;
+   /* One bit per non-zero entry of regs, so that whole intervals can be checked at once */
+   std::bitset<512> used;
 
    const uint32_t& operator[](PhysReg index) const { return regs[index]; }
 
    uint32_t& operator[](PhysReg index) { return regs[index]; }
 
+   static std::bitset<512> mask(PhysRegInterval reg_interval)
+   {
+      if (reg_interval.size == 0)
+         return std::bitset<512>();
+      return (~std::bitset<512>() >> (512 - reg_interval.size)) << reg_interval.lo().reg();
+   }
+
    unsigned count_zero(PhysRegInterval reg_interval)
    {
-      unsigned res = 0;
-      for (PhysReg reg : reg_interval)
-         res += !regs[reg];
-      return res;
+      return reg_interval.size - (used & mask(reg_interval)).count();
    }
 
    /* Returns true if any of the bytes in the given range are allocated or blocked */
@@ -349,8 +355,10 @@ public:
 private:
    void fill(PhysReg start, unsigned size, uint32_t val)
    {
-      for (unsigned i = 0; i < size; i++)
+      for (unsigned i = 0; i < size; i++) {
          regs[start + i] = val;
+         used[start + i] = val != 0;
+      }
    }
 
    void fill_subdword(PhysReg start, unsigned num_bytes, uint32_t val)
@@ -366,6 +374,7 @@ private:
          if (sub == std::array<uint32_t, 4>{0, 0, 0, 0}) {
             subdword_regs.erase(i);
             regs[i] = 0;
+            used.reset(i);
          }
       }
    }
@@ -968,7 +977,8 @@ get_reg_simple(ra_ctx& ctx, RegisterFile& reg_file, DefInfo info)
          continue;
       }
 
-      bool is_valid = std::all_of(std::next(reg_win.begin()), reg_win.end(), is_free);
+      const PhysRegInterval rest = {PhysReg{reg_win.lo() + 1}, size - 1};
+      bool is_valid = ((reg_file.used | ctx.war_hint) & RegisterFile::mask(rest)).none();
       if (is_valid) {
          adjust_max_used_regs(ctx, rc, reg_win.lo());
          return {reg_win.lo(), true};
@@ -61,7 +61,7 @@ void ac_llvm_context_init(struct ac_llvm_context *ctx, struct ac_llvm_compiler *
                           enum ac_float_mode float_mode, unsigned wave_size,
                           unsigned ballot_mask_bits)
 {
-   ctx->context = LLVMContextCreate();
+   ctx->context = ac_llvm_compiler_get_context(compiler);
 
    ctx->gfx_level = gfx_level;
    ctx->family = family;
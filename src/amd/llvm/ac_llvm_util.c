@@ -338,6 +338,19 @@ void ac_llvm_set_target_features(LLVMValueRef F, struct ac_llvm_context *ctx)
    LLVMAddTargetDependentFunctionAttr(F, "target-features", features);
 }
 
+/* Check that LLVM can generate code for the family without creating the pass managers
+ * and the rest of a compiler instance.
+ */
+bool ac_is_llvm_family_supported(enum radeon_family family)
+{
+   LLVMTargetMachineRef tm = ac_create_target_machine(family, 0, LLVMCodeGenLevelDefault, NULL);
+   if (!tm)
+      return false;
+
+   LLVMDisposeTargetMachine(tm);
+   return true;
+}
+
 bool ac_init_llvm_compiler(struct ac_llvm_compiler *compiler, enum radeon_family family,
                            enum ac_target_machine_options tm_options)
 {
@@ -383,4 +396,46 @@ void ac_destroy_llvm_compiler(struct ac_llvm_compiler *compiler)
       LLVMDisposeTargetMachine(compiler->low_opt_tm);
    if (compiler->tm)
       LLVMDisposeTargetMachine(compiler->tm);
+   if (compiler->context) {
+      assert(!compiler->context_refs);
+      LLVMContextDispose(compiler->context);
+   }
+}
+
+/* Types and constants are uniqued in the LLVM context and only freed with it, so a shared
+ * context is recreated after this many compiles to bound its memory usage.
+ */
+#define AC_LLVM_CONTEXT_MAX_USES 64
+
+/* Return the LLVM context for a new module. Creating an LLVMContext is expensive compared
+ * to small shaders, so consecutive compiles on the same compiler share one.
+ */
+LLVMContextRef ac_llvm_compiler_get_context(struct ac_llvm_compiler *compiler)
+{
+   if (!compiler->context) {
+      compiler->context = LLVMContextCreate();
+      compiler->context_uses = 0;
+   }
+
+   compiler->context_uses++;
+   compiler->context_refs++;
+   return compiler->context;
+}
+
+/* Release a context returned by ac_llvm_compiler_get_context. All modules created in it
+ * must have been disposed.
+ */
+void ac_llvm_compiler_put_context(struct ac_llvm_compiler *compiler)
+{
+   assert(compiler->context_refs);
+   if (--compiler->context_refs)
+      return;
+
+   /* The handler data usually points to the stack of the previous compile. */
+   LLVMContextSetDiagnosticHandler(compiler->context, NULL, NULL);
+
+   if (compiler->context_uses >= AC_LLVM_CONTEXT_MAX_USES) {
+      LLVMContextDispose(compiler->context);
+      compiler->context = NULL;
+   }
 }
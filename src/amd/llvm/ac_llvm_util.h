@@ -87,6 +87,11 @@ struct ac_llvm_compiler {
     */
    LLVMTargetMachineRef low_opt_tm; /* uses -O1 instead of -O2 */
    struct ac_compiler_passes *low_opt_passes;
+
+   /* LLVM context shared by consecutive compiles on this thread. */
+   LLVMContextRef context;
+   unsigned context_uses;
+   unsigned context_refs;
 };
 
 LLVMTargetRef ac_get_llvm_target(const char *triple);
@@ -121,9 +126,12 @@ void ac_dispose_target_library_info(LLVMTargetLibraryInfoRef library_info);
 PUBLIC void ac_init_shared_llvm_once(void); /* Do not use directly, use ac_init_llvm_once */
 void ac_init_llvm_once(void);
 
+bool ac_is_llvm_family_supported(enum radeon_family family);
 bool ac_init_llvm_compiler(struct ac_llvm_compiler *compiler, enum radeon_family family,
                            enum ac_target_machine_options tm_options);
 void ac_destroy_llvm_compiler(struct ac_llvm_compiler *compiler);
+LLVMContextRef ac_llvm_compiler_get_context(struct ac_llvm_compiler *compiler);
+void ac_llvm_compiler_put_context(struct ac_llvm_compiler *compiler);
 
 struct ac_compiler_passes *ac_create_llvm_passes(LLVMTargetMachineRef tm);
 void ac_destroy_llvm_passes(struct ac_compiler_passes *p);
@@ -372,7 +372,11 @@ radv_handle_thread_trace(VkQueue _queue)
    }
 
    if (!thread_trace_enabled) {
-      bool frame_trigger = num_frames == queue->device->thread_trace.start_frame;
+      const int start_frame = queue->device->thread_trace.start_frame;
+      const unsigned interval = queue->device->thread_trace.interval;
+      bool frame_trigger = num_frames == start_frame;
+      if (interval && start_frame >= 0 && num_frames > start_frame)
+         frame_trigger = (num_frames - start_frame) % interval == 0;
       bool file_trigger = false;
 #ifndef _WIN32
       if (queue->device->thread_trace.trigger_file &&
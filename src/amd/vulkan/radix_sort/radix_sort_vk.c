@@ -819,6 +819,228 @@ radix_sort_vk_sort_devaddr(radix_sort_vk_t const *                   rs,
 #endif
 }
 
+//
+// Dimensions of one direct sort.
+//
+struct rs_sort_dims
+{
+  uint32_t passes;
+  uint32_t pass_idx;  // first pass
+  uint32_t scatter_blocks;
+  uint32_t histo_blocks;
+  uint32_t count_ru_histo;
+};
+
+static void
+rs_get_sort_dims(radix_sort_vk_t const *                   rs,
+                 radix_sort_vk_sort_devaddr_info_t const * info,
+                 struct rs_sort_dims *                     dims)
+{
+  uint32_t const keyval_bytes = rs->config.keyval_dwords * (uint32_t)sizeof(uint32_t);
+  uint32_t const keyval_bits  = keyval_bytes * 8;
+  uint32_t const key_bits     = MIN_MACRO(uint32_t, info->key_bits, keyval_bits);
+
+  dims->passes   = (key_bits + RS_RADIX_LOG2 - 1) / RS_RADIX_LOG2;
+  dims->pass_idx = keyval_bytes - dims->passes;
+
+  uint32_t const scatter_wg_size   = 1 << rs->config.scatter.workgroup_size_log2;
+  uint32_t const scatter_block_kvs = scatter_wg_size * rs->config.scatter.block_rows;
+  dims->scatter_blocks = (info->count + scatter_block_kvs - 1) / scatter_block_kvs;
+
+  uint32_t const histo_wg_size   = 1 << rs->config.histogram.workgroup_size_log2;
+  uint32_t const histo_block_kvs = histo_wg_size * rs->config.histogram.block_rows;
+
+  dims->histo_blocks   = (dims->scatter_blocks * scatter_block_kvs + histo_block_kvs - 1) /  //
+                       histo_block_kvs;
+  dims->count_ru_histo = dims->histo_blocks * histo_block_kvs;
+}
+
+//
+// Same as radix_sort_vk_sort_devaddr() for several independent sorts at once.
+//
+// Each phase is recorded for every sort before the barrier that ends it, so
+// sorting N arrays needs as many barriers as sorting one.  The sorts must not
+// share any of their buffers.
+//
+void
+radix_sort_vk_sort_devaddr_batch(radix_sort_vk_t const *                   rs,
+                                 radix_sort_vk_sort_devaddr_info_t const * infos,
+                                 uint32_t                                  info_count,
+                                 VkDevice                                  device,
+                                 VkCommandBuffer                           cb,
+                                 VkDeviceAddress *                         keyvals_sorted)
+{
+  uint32_t const keyval_bytes   = rs->config.keyval_dwords * (uint32_t)sizeof(uint32_t);
+  uint32_t       first_pass_idx = keyval_bytes;
+
+  //
+  // Pad the keyvals and zero the histograms/partitions of every sort.
+  //
+  for (uint32_t ii = 0; ii < info_count; ii++)
+    {
+      radix_sort_vk_sort_devaddr_info_t const * info = infos + ii;
+
+      keyvals_sorted[ii] = info->keyvals_even.devaddr;
+
+      if ((info->count <= 1) || (info->key_bits == 0))
+        continue;
+
+      struct rs_sort_dims dims;
+
+      rs_get_sort_dims(rs, info, &dims);
+
+      if ((dims.passes & 1) != 0)
+        keyvals_sorted[ii] = info->keyvals_odd;
+
+      first_pass_idx = MIN_MACRO(uint32_t, first_pass_idx, dims.pass_idx);
+
+      if (dims.count_ru_histo > info->count)
+        {
+          info->fill_buffer(cb,
+                            &info->keyvals_even,
+                            info->count * keyval_bytes,
+                            (dims.count_ru_histo - info->count) * keyval_bytes,
+                            0xFFFFFFFF);
+        }
+
+      uint32_t const     histo_partition_count = dims.passes + dims.scatter_blocks - 1;
+      VkDeviceSize const fill_base             = dims.pass_idx * (RS_RADIX_SIZE * sizeof(uint32_t));
+
+      info->fill_buffer(cb,
+                        &info->internal,
+                        rs->internal.histograms.offset + fill_base,
+                        histo_partition_count * (RS_RADIX_SIZE * sizeof(uint32_t)),
+                        0);
+    }
+
+  //
+  // Anything to do?
+  //
+  if (first_pass_idx == keyval_bytes)
+    return;
+
+  //
+  // Pipeline: HISTOGRAM
+  //
+  vk_barrier_transfer_w_to_compute_r(cb);
+
+  vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_COMPUTE, rs->pipelines.named.histogram);
+
+  for (uint32_t ii = 0; ii < info_count; ii++)
+    {
+      radix_sort_vk_sort_devaddr_info_t const * info = infos + ii;
+
+      if ((info->count <= 1) || (info->key_bits == 0))
+        continue;
+
+      struct rs_sort_dims dims;
+
+      rs_get_sort_dims(rs, info, &dims);
+
+      struct rs_push_histogram const push_histogram = {
+
+        .devaddr_histograms = info->internal.devaddr + rs->internal.histograms.offset,
+        .devaddr_keyvals    = info->keyvals_even.devaddr,
+        .passes             = dims.passes
+      };
+
+      vkCmdPushConstants(cb,
+                         rs->pipeline_layouts.named.histogram,
+                         VK_SHADER_STAGE_COMPUTE_BIT,
+                         0,
+                         sizeof(push_histogram),
+                         &push_histogram);
+
+      vkCmdDispatch(cb, dims.histo_blocks, 1, 1);
+    }
+
+  //
+  // Pipeline: PREFIX
+  //
+  vk_barrier_compute_w_to_compute_r(cb);
+
+  vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_COMPUTE, rs->pipelines.named.prefix);
+
+  for (uint32_t ii = 0; ii < info_count; ii++)
+    {
+      radix_sort_vk_sort_devaddr_info_t const * info = infos + ii;
+
+      if ((info->count <= 1) || (info->key_bits == 0))
+        continue;
+
+      struct rs_sort_dims dims;
+
+      rs_get_sort_dims(rs, info, &dims);
+
+      struct rs_push_prefix const push_prefix = {
+
+        .devaddr_histograms = info->internal.devaddr + rs->internal.histograms.offset,
+      };
+
+      vkCmdPushConstants(cb,
+                         rs->pipeline_layouts.named.prefix,
+                         VK_SHADER_STAGE_COMPUTE_BIT,
+                         0,
+                         sizeof(push_prefix),
+                         &push_prefix);
+
+      vkCmdDispatch(cb, dims.passes, 1, 1);
+    }
+
+  //
+  // Pipeline: SCATTER
+  //
+  // Sorts with fewer passes join in once the pass index reaches their first
+  // pass, so they all finish on the last one.
+  //
+  for (uint32_t pass_idx = first_pass_idx; pass_idx < keyval_bytes; pass_idx++)
+    {
+      vk_barrier_compute_w_to_compute_r(cb);
+
+      uint32_t const pass_dword = pass_idx / 4;
+
+      for (uint32_t ii = 0; ii < info_count; ii++)
+        {
+          radix_sort_vk_sort_devaddr_info_t const * info = infos + ii;
+
+          if ((info->count <= 1) || (info->key_bits == 0))
+            continue;
+
+          struct rs_sort_dims dims;
+
+          rs_get_sort_dims(rs, info, &dims);
+
+          if (pass_idx < dims.pass_idx)
+            continue;
+
+          bool const is_even = ((pass_idx - dims.pass_idx) & 1) == 0;
+
+          VkDeviceAddress const devaddr_histograms =
+            info->internal.devaddr + rs->internal.histograms.offset;
+
+          struct rs_push_scatter const push_scatter = {
+
+            .devaddr_keyvals_even = info->keyvals_even.devaddr,
+            .devaddr_keyvals_odd  = info->keyvals_odd,
+            .devaddr_partitions   = info->internal.devaddr + rs->internal.partitions.offset,
+            .devaddr_histograms   = devaddr_histograms + pass_idx * (RS_RADIX_SIZE * sizeof(uint32_t)),
+            .pass_offset          = (pass_idx & 3) * RS_RADIX_LOG2,
+          };
+
+          VkPipelineLayout const pl = is_even ? rs->pipeline_layouts.named.scatter[pass_dword].even  //
+                                              : rs->pipeline_layouts.named.scatter[pass_dword].odd;
+          VkPipeline const       p  = is_even ? rs->pipelines.named.scatter[pass_dword].even  //
+                                              : rs->pipelines.named.scatter[pass_dword].odd;
+
+          vkCmdPushConstants(cb, pl, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(push_scatter), &push_scatter);
+
+          vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_COMPUTE, p);
+
+          vkCmdDispatch(cb, dims.scatter_blocks, 1, 1);
+        }
+    }
+}
+
 //
 //
 //
@@ -64,6 +64,16 @@ radix_sort_vk_sort_devaddr(radix_sort_vk_t const *                   rs,
                            VkCommandBuffer                           cb,
                            VkDeviceAddress *                         keyvals_sorted);
 
+// Several independent direct sorts recorded together, sharing their barriers.
+// keyvals_sorted receives one address per sort.
+void
+radix_sort_vk_sort_devaddr_batch(radix_sort_vk_t const *                   rs,
+                                 radix_sort_vk_sort_devaddr_info_t const * infos,
+                                 uint32_t                                  info_count,
+                                 VkDevice                                  device,
+                                 VkCommandBuffer                           cb,
+                                 VkDeviceAddress *                         keyvals_sorted);
+
 //
 // Indirect dispatch sorting using buffer device addresses
 // -------------------------------------------------------
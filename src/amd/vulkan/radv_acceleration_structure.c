@@ -614,39 +614,54 @@ morton_sort(VkCommandBuffer commandBuffer, uint32_t infoCount,
             enum radv_cmd_flush_bits flush_bits)
 {
    RADV_FROM_HANDLE(radv_cmd_buffer, cmd_buffer, commandBuffer);
+
+   struct radix_sort_vk_sort_devaddr_info *infos = malloc(infoCount * sizeof(*infos));
+   VkDeviceAddress *result_addrs = malloc(infoCount * sizeof(*result_addrs));
+   if (!infos || !result_addrs) {
+      free(infos);
+      free(result_addrs);
+      vk_command_buffer_set_error(&cmd_buffer->vk, VK_ERROR_OUT_OF_HOST_MEMORY);
+      return;
+   }
+
    for (uint32_t i = 0; i < infoCount; ++i) {
-      struct radix_sort_vk_memory_requirements requirements;
-      radix_sort_vk_get_memory_requirements(
-         cmd_buffer->device->meta_state.accel_struct_build.radix_sort, bvh_states[i].node_count,
-         &requirements);
-
-      struct radix_sort_vk_sort_devaddr_info info =
-         cmd_buffer->device->meta_state.accel_struct_build.radix_sort_info;
-      info.count = bvh_states[i].node_count;
-
-      info.keyvals_even.buffer = VK_NULL_HANDLE;
-      info.keyvals_even.offset = 0;
-      info.keyvals_even.devaddr =
+      struct radix_sort_vk_sort_devaddr_info *info = &infos[i];
+
+      *info = cmd_buffer->device->meta_state.accel_struct_build.radix_sort_info;
+      info->count = bvh_states[i].node_count;
+
+      info->keyvals_even.buffer = VK_NULL_HANDLE;
+      info->keyvals_even.offset = 0;
+      info->keyvals_even.devaddr =
          pInfos[i].scratchData.deviceAddress + bvh_states[i].scratch.sort_buffer_offset[0];
 
-      info.keyvals_odd =
+      info->keyvals_odd =
          pInfos[i].scratchData.deviceAddress + bvh_states[i].scratch.sort_buffer_offset[1];
 
-      info.internal.buffer = VK_NULL_HANDLE;
-      info.internal.offset = 0;
-      info.internal.devaddr =
+      info->internal.buffer = VK_NULL_HANDLE;
+      info->internal.offset = 0;
+      info->internal.devaddr =
          pInfos[i].scratchData.deviceAddress + bvh_states[i].scratch.sort_internal_offset;
+   }
 
-      VkDeviceAddress result_addr;
-      radix_sort_vk_sort_devaddr(cmd_buffer->device->meta_state.accel_struct_build.radix_sort,
-                                 &info, radv_device_to_handle(cmd_buffer->device), commandBuffer,
-                                 &result_addr);
+   /* Every build sorts its own scratch memory, so record each sort phase for all of them before
+    * the barrier that ends it.
+    */
+   radix_sort_vk_sort_devaddr_batch(cmd_buffer->device->meta_state.accel_struct_build.radix_sort,
+                                    infos, infoCount, radv_device_to_handle(cmd_buffer->device),
+                                    commandBuffer, result_addrs);
 
-      assert(result_addr == info.keyvals_even.devaddr || result_addr == info.keyvals_odd);
+   for (uint32_t i = 0; i < infoCount; ++i) {
+      assert(result_addrs[i] == infos[i].keyvals_even.devaddr ||
+             result_addrs[i] == infos[i].keyvals_odd);
 
-      bvh_states[i].scratch_offset = (uint32_t)(result_addr - pInfos[i].scratchData.deviceAddress);
+      bvh_states[i].scratch_offset =
+         (uint32_t)(result_addrs[i] - pInfos[i].scratchData.deviceAddress);
    }
 
+   free(infos);
+   free(result_addrs);
+
    cmd_buffer->state.flush_bits |= flush_bits;
 }
 
@@ -778,6 +778,14 @@ radv_check_gpu_hangs(struct radv_queue *queue, struct radeon_cmdbuf *cs)
       fclose(f);
    }
 
+   /* Dump shader arena usage. */
+   snprintf(dump_path, sizeof(dump_path), "%s/%s", dump_dir, "shader_arenas.log");
+   f = fopen(dump_path, "w+");
+   if (f) {
+      radv_dump_shader_arenas(device, f);
+      fclose(f);
+   }
+
    /* Dump BO log. */
    snprintf(dump_path, sizeof(dump_path), "%s/%s", dump_dir, "bo_history.log");
    f = fopen(dump_path, "w+");
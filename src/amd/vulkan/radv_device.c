@@ -65,6 +65,7 @@ typedef void *drmDevicePtr;
 #include "util/os_time.h"
 #include "util/timespec.h"
 #include "util/u_atomic.h"
+#include "util/u_cpu_detect.h"
 #include "winsys/null/radv_null_winsys_public.h"
 #include "git_sha1.h"
 #include "sid.h"
@@ -1081,6 +1082,7 @@ static const driOptionDescription radv_dri_options[] = {
       DRI_CONF_VK_X11_STRICT_IMAGE_COUNT(false)
       DRI_CONF_VK_X11_ENSURE_MIN_IMAGE_COUNT(false)
       DRI_CONF_VK_XWAYLAND_WAIT_READY(true)
+      DRI_CONF_VK_X11_MAX_PENDING_FRAMES(0)
       DRI_CONF_RADV_REPORT_LLVM9_VERSION_STRING(false)
       DRI_CONF_RADV_ENABLE_MRT_OUTPUT_NAN_FIXUP(false)
       DRI_CONF_RADV_DISABLE_SHRINK_IMAGE_STORE(false)
@@ -3653,6 +3655,16 @@ radv_CreateDevice(VkPhysicalDevice physicalDevice, const VkDeviceCreateInfo *pCr
 
    radv_init_shader_arenas(device);
 
+   /* The thread creating the pipeline compiles one of the stages itself. A
+    * pipeline has at most 5 stages that are compiled separately.
+    */
+   unsigned num_compile_threads = MIN2(util_get_cpu_caps()->nr_cpus - 1, 4);
+   if (num_compile_threads > 0) {
+      util_queue_init(&device->shader_compile_queue, "radv_sc", 16, num_compile_threads,
+                      UTIL_QUEUE_INIT_RESIZE_IF_FULL | UTIL_QUEUE_INIT_SET_FULL_THREAD_AFFINITY,
+                      NULL);
+   }
+
    device->overallocation_disallowed = overallocation_disallowed;
    mtx_init(&device->overallocation_mutex, mtx_plain);
 
@@ -3925,6 +3937,9 @@ fail:
    radv_device_finish_vs_prologs(device);
    radv_device_finish_border_color(device);
 
+   if (util_queue_is_initialized(&device->shader_compile_queue))
+      util_queue_destroy(&device->shader_compile_queue);
+
    for (unsigned i = 0; i < RADV_MAX_QUEUE_FAMILIES; i++) {
       for (unsigned q = 0; q < device->queue_count[i]; q++)
          radv_queue_finish(&device->queues[i][q]);
@@ -3994,6 +4009,9 @@ radv_DestroyDevice(VkDevice _device, const VkAllocationCallbacks *pAllocator)
    radv_trap_handler_finish(device);
    radv_finish_trace(device);
 
+   if (util_queue_is_initialized(&device->shader_compile_queue))
+      util_queue_destroy(&device->shader_compile_queue);
+
    radv_destroy_shader_arenas(device);
 
    radv_thread_trace_finish(device);
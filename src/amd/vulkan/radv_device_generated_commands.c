@@ -135,18 +135,12 @@ struct radv_dgc_params {
    uint32_t upload_stride;
    uint32_t upload_addr;
    uint32_t sequence_count;
-   uint32_t stream_stride;
 
    /* draw info */
-   uint16_t draw_indexed;
-   uint16_t draw_params_offset;
    uint16_t base_index_size;
    uint16_t vtx_base_sgpr;
    uint32_t max_index_count;
 
-   /* bind index buffer info. Valid if base_index_size == 0 && draw_indexed */
-   uint16_t index_buffer_offset;
-
    uint8_t vbo_cnt;
 
    uint8_t const_copy;
@@ -157,16 +151,9 @@ struct radv_dgc_params {
    uint16_t vbo_reg;
    uint16_t const_copy_size;
 
-   uint64_t push_constant_mask;
-
-   uint32_t ibo_type_32;
-   uint32_t ibo_type_8;
-
    uint16_t push_constant_shader_cnt;
 
-   uint16_t emit_state;
    uint32_t pa_su_sc_mode_cntl_base;
-   uint16_t state_offset;
    uint16_t scissor_count;
    uint16_t scissor_offset; /* in parameter buffer. */
 };
@@ -221,10 +208,6 @@ dgc_emit(nir_builder *b, struct dgc_cmdbuf *cs, nir_ssa_def *value)
                              .base = (offsetof(struct radv_dgc_params, field) & ~3), .range = 4),  \
       (offsetof(struct radv_dgc_params, field) & 3) * 8, 8)
 
-#define load_param64(b, field)                                                                     \
-   nir_pack_64_2x32((b), nir_load_push_constant((b), 2, 32, nir_imm_int((b), 0),                   \
-                          .base = offsetof(struct radv_dgc_params, field), .range = 8))
-
 static nir_ssa_def *
 nir_pkt3(nir_builder *b, unsigned op, nir_ssa_def *len)
 {
@@ -329,8 +312,11 @@ build_dgc_buffer_tail(nir_builder *b, nir_ssa_def *sequence_count)
    nir_pop_if(b, NULL);
 }
 
+/* The shader is specialized for each indirect commands layout: everything that only depends on
+ * the layout is a constant, so the tokens it doesn't use are compiled out.
+ */
 static nir_shader *
-build_dgc_prepare_shader(struct radv_device *dev)
+build_dgc_prepare_shader(struct radv_device *dev, const struct radv_indirect_command_layout *layout)
 {
    nir_builder b = radv_meta_init_shader(dev, MESA_SHADER_COMPUTE, "meta_dgc_prepare");
    b.shader->info.workgroup_size[0] = 64;
@@ -341,7 +327,7 @@ build_dgc_prepare_shader(struct radv_device *dev)
 
    nir_ssa_def *cmd_buf_stride = load_param32(&b, cmd_buf_stride);
    nir_ssa_def *sequence_count = load_param32(&b, sequence_count);
-   nir_ssa_def *stream_stride = load_param32(&b, stream_stride);
+   nir_ssa_def *stream_stride = nir_imm_int(&b, layout->input_stride);
 
    nir_variable *count_var = nir_variable_create(b.shader, nir_var_shader_temp, glsl_uint_type(), "sequence_count");
    nir_store_var(&b, count_var, sequence_count, 0x1);
@@ -377,7 +363,7 @@ build_dgc_prepare_shader(struct radv_device *dev)
 
       nir_ssa_def *vbo_bind_mask = load_param32(&b, vbo_bind_mask);
       nir_ssa_def *vbo_cnt = load_param8(&b, vbo_cnt);
-      nir_push_if(&b, nir_ine_imm(&b, vbo_bind_mask, 0));
+      nir_push_if(&b, layout->bind_vbo_mask ? nir_ine_imm(&b, vbo_bind_mask, 0) : nir_imm_false(&b));
       {
          nir_variable *vbo_idx =
             nir_variable_create(b.shader, nir_var_shader_temp, glsl_uint_type(), "vbo_idx");
@@ -544,7 +530,7 @@ build_dgc_prepare_shader(struct radv_device *dev)
       nir_pop_if(&b, NULL);
 
 
-      nir_ssa_def *push_const_mask = load_param64(&b, push_constant_mask);
+      nir_ssa_def *push_const_mask = nir_imm_int64(&b, layout->push_constant_mask);
       nir_push_if(&b, nir_ine_imm(&b, push_const_mask, 0));
       {
          nir_ssa_def *const_copy = nir_ine_imm(&b, load_param8(&b, const_copy), 0);
@@ -702,9 +688,9 @@ build_dgc_prepare_shader(struct radv_device *dev)
       }
       nir_pop_if(&b, 0);
 
-      nir_push_if(&b, nir_ieq_imm(&b, load_param16(&b, emit_state), 1));
+      nir_push_if(&b, nir_imm_bool(&b, layout->binds_state));
       {
-         nir_ssa_def *stream_offset = nir_iadd(&b, load_param16(&b, state_offset), stream_base);
+         nir_ssa_def *stream_offset = nir_iadd_imm(&b, stream_base, layout->state_offset);
          nir_ssa_def *state = nir_load_ssbo(&b, 1, 32, stream_buf, stream_offset);
          state = nir_iand_imm(&b, state, 1);
 
@@ -720,7 +706,7 @@ build_dgc_prepare_shader(struct radv_device *dev)
       nir_pop_if(&b, NULL);
 
       nir_ssa_def *scissor_count = load_param16(&b, scissor_count);
-      nir_push_if(&b, nir_ine_imm(&b, scissor_count, 0));
+      nir_push_if(&b, layout->binds_state ? nir_ine_imm(&b, scissor_count, 0) : nir_imm_false(&b));
       {
          nir_ssa_def *scissor_offset = load_param16(&b, scissor_offset);
          nir_variable *idx = nir_variable_create(b.shader, nir_var_shader_temp, glsl_uint_type(),
@@ -748,11 +734,10 @@ build_dgc_prepare_shader(struct radv_device *dev)
       }
       nir_pop_if(&b, NULL);
 
-      nir_push_if(&b, nir_ieq_imm(&b, load_param16(&b, draw_indexed), 0));
+      nir_push_if(&b, nir_imm_bool(&b, !layout->indexed));
       {
          nir_ssa_def *vtx_base_sgpr = load_param16(&b, vtx_base_sgpr);
-         nir_ssa_def *stream_offset =
-            nir_iadd(&b, load_param16(&b, draw_params_offset), stream_base);
+         nir_ssa_def *stream_offset = nir_iadd_imm(&b, stream_base, layout->draw_params_offset);
 
          nir_ssa_def *draw_data0 =
             nir_load_ssbo(&b, 4, 32, stream_buf, stream_offset);
@@ -778,19 +763,19 @@ build_dgc_prepare_shader(struct radv_device *dev)
             nir_variable_create(b.shader, nir_var_shader_temp, glsl_uint_type(), "max_index_count");
          nir_store_var(&b, max_index_count_var, load_param32(&b, max_index_count), 0x1);
 
-         nir_ssa_def *bind_index_buffer = nir_ieq_imm(&b, nir_load_var(&b, index_size_var), 0);
+         nir_ssa_def *bind_index_buffer = nir_imm_bool(&b, layout->binds_index_buffer);
          nir_push_if(&b, bind_index_buffer);
          {
             nir_ssa_def *index_stream_offset =
-               nir_iadd(&b, load_param16(&b, index_buffer_offset), stream_base);
+               nir_iadd_imm(&b, stream_base, layout->index_buffer_offset);
             nir_ssa_def *data =
                nir_load_ssbo(&b, 4, 32, stream_buf, index_stream_offset);
 
             nir_ssa_def *vk_index_type = nir_channel(&b, data, 3);
             nir_ssa_def *index_type = nir_bcsel(
-               &b, nir_ieq(&b, vk_index_type, load_param32(&b, ibo_type_32)),
+               &b, nir_ieq_imm(&b, vk_index_type, layout->ibo_type_32),
                nir_imm_int(&b, V_028A7C_VGT_INDEX_32), nir_imm_int(&b, V_028A7C_VGT_INDEX_16));
-            index_type = nir_bcsel(&b, nir_ieq(&b, vk_index_type, load_param32(&b, ibo_type_8)),
+            index_type = nir_bcsel(&b, nir_ieq_imm(&b, vk_index_type, layout->ibo_type_8),
                                    nir_imm_int(&b, V_028A7C_VGT_INDEX_8), index_type);
 
             nir_ssa_def *index_size = nir_iand_imm(
@@ -834,8 +819,7 @@ build_dgc_prepare_shader(struct radv_device *dev)
          nir_ssa_def *index_size = nir_load_var(&b, index_size_var);
          nir_ssa_def *max_index_count = nir_load_var(&b, max_index_count_var);
          nir_ssa_def *vtx_base_sgpr = load_param16(&b, vtx_base_sgpr);
-         nir_ssa_def *stream_offset =
-            nir_iadd(&b, load_param16(&b, draw_params_offset), stream_base);
+         nir_ssa_def *stream_offset = nir_iadd_imm(&b, stream_base, layout->draw_params_offset);
 
          index_size =
             nir_bcsel(&b, bind_index_buffer, nir_load_var(&b, index_size_var), index_size);
@@ -883,8 +867,6 @@ build_dgc_prepare_shader(struct radv_device *dev)
 void
 radv_device_finish_dgc_prepare_state(struct radv_device *device)
 {
-   radv_DestroyPipeline(radv_device_to_handle(device), device->meta_state.dgc_prepare.pipeline,
-                        &device->meta_state.alloc);
    radv_DestroyPipelineLayout(radv_device_to_handle(device),
                               device->meta_state.dgc_prepare.p_layout, &device->meta_state.alloc);
    device->vk.dispatch_table.DestroyDescriptorSetLayout(radv_device_to_handle(device),
@@ -896,7 +878,6 @@ VkResult
 radv_device_init_dgc_prepare_state(struct radv_device *device)
 {
    VkResult result;
-   nir_shader *cs = build_dgc_prepare_shader(device);
 
    VkDescriptorSetLayoutCreateInfo ds_create_info = {
       .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
@@ -929,7 +910,7 @@ radv_device_init_dgc_prepare_state(struct radv_device *device)
                                            &device->meta_state.alloc,
                                            &device->meta_state.dgc_prepare.ds_layout);
    if (result != VK_SUCCESS)
-      goto cleanup;
+      return result;
 
    const VkPipelineLayoutCreateInfo leaf_pl_create_info = {
       .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
@@ -940,11 +921,17 @@ radv_device_init_dgc_prepare_state(struct radv_device *device)
          &(VkPushConstantRange){VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(struct radv_dgc_params)},
    };
 
-   result = radv_CreatePipelineLayout(radv_device_to_handle(device), &leaf_pl_create_info,
-                                      &device->meta_state.alloc,
-                                      &device->meta_state.dgc_prepare.p_layout);
-   if (result != VK_SUCCESS)
-      goto cleanup;
+   return radv_CreatePipelineLayout(radv_device_to_handle(device), &leaf_pl_create_info,
+                                    &device->meta_state.alloc,
+                                    &device->meta_state.dgc_prepare.p_layout);
+}
+
+static VkResult
+radv_create_dgc_prepare_pipeline(struct radv_device *device,
+                                 struct radv_indirect_command_layout *layout)
+{
+   VkResult result;
+   nir_shader *cs = build_dgc_prepare_shader(device, layout);
 
    VkPipelineShaderStageCreateInfo shader_stage = {
       .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
@@ -961,13 +948,10 @@ radv_device_init_dgc_prepare_state(struct radv_device *device)
       .layout = device->meta_state.dgc_prepare.p_layout,
    };
 
-   result = radv_CreateComputePipelines(
-      radv_device_to_handle(device), device->meta_state.cache, 1,
-      &pipeline_info, &device->meta_state.alloc, &device->meta_state.dgc_prepare.pipeline);
-   if (result != VK_SUCCESS)
-      goto cleanup;
+   result = radv_CreateComputePipelines(radv_device_to_handle(device), device->meta_state.cache, 1,
+                                        &pipeline_info, &device->meta_state.alloc,
+                                        &layout->pipeline);
 
-cleanup:
    ralloc_free(cs);
    return result;
 }
@@ -1044,6 +1028,13 @@ radv_CreateIndirectCommandsLayoutNV(VkDevice _device,
    if (!layout->indexed)
       layout->binds_index_buffer = false;
 
+   VkResult result = radv_create_dgc_prepare_pipeline(device, layout);
+   if (result != VK_SUCCESS) {
+      vk_object_base_finish(&layout->base);
+      vk_free2(&device->vk.alloc, pAllocator, layout);
+      return vk_error(device, result);
+   }
+
    *pIndirectCommandsLayout = radv_indirect_command_layout_to_handle(layout);
    return VK_SUCCESS;
 }
@@ -1059,6 +1050,8 @@ radv_DestroyIndirectCommandsLayoutNV(VkDevice _device,
    if (!layout)
       return;
 
+   radv_DestroyPipeline(_device, layout->pipeline, &device->meta_state.alloc);
+
    vk_object_base_finish(&layout->base);
    vk_free2(&device->vk.alloc, pAllocator, layout);
 }
@@ -1160,20 +1153,12 @@ radv_prepare_dgc(struct radv_cmd_buffer *cmd_buffer,
       .upload_addr = (uint32_t)upload_addr,
       .upload_stride = upload_stride,
       .sequence_count = pGeneratedCommandsInfo->sequencesCount,
-      .stream_stride = layout->input_stride,
-      .draw_indexed = layout->indexed,
-      .draw_params_offset = layout->draw_params_offset,
       .base_index_size =
          layout->binds_index_buffer ? 0 : radv_get_vgt_index_size(cmd_buffer->state.index_type),
       .vtx_base_sgpr = vtx_base_sgpr,
       .max_index_count = cmd_buffer->state.max_index_count,
-      .index_buffer_offset = layout->index_buffer_offset,
       .vbo_reg = vbo_sgpr,
-      .ibo_type_32 = layout->ibo_type_32,
-      .ibo_type_8 = layout->ibo_type_8,
-      .emit_state = layout->binds_state,
       .pa_su_sc_mode_cntl_base = radv_get_pa_su_sc_mode_cntl(cmd_buffer) & C_028814_FACE,
-      .state_offset = layout->state_offset,
    };
 
    if (layout->bind_vbo_mask) {
@@ -1241,7 +1226,6 @@ radv_prepare_dgc(struct radv_cmd_buffer *cmd_buffer,
 
       params.const_copy_size = graphics_pipeline->base.push_constant_size +
                                16 * graphics_pipeline->base.dynamic_offset_count;
-      params.push_constant_mask = layout->push_constant_mask;
 
       memcpy(upload_data, layout->push_constant_offsets, sizeof(layout->push_constant_offsets));
       upload_data = (char *)upload_data + sizeof(layout->push_constant_offsets);
@@ -1331,7 +1315,7 @@ radv_prepare_dgc(struct radv_cmd_buffer *cmd_buffer,
       RADV_META_SAVE_COMPUTE_PIPELINE | RADV_META_SAVE_DESCRIPTORS | RADV_META_SAVE_CONSTANTS);
 
    radv_CmdBindPipeline(radv_cmd_buffer_to_handle(cmd_buffer), VK_PIPELINE_BIND_POINT_COMPUTE,
-                        cmd_buffer->device->meta_state.dgc_prepare.pipeline);
+                        layout->pipeline);
 
    radv_CmdPushConstants(radv_cmd_buffer_to_handle(cmd_buffer),
                          cmd_buffer->device->meta_state.dgc_prepare.p_layout,
@@ -97,12 +97,12 @@ radv_compile_to_elf(struct ac_llvm_compiler *info, LLVMModuleRef module, char **
 }
 
 bool
-radv_init_llvm_compiler(struct ac_llvm_compiler *info, enum radeon_family family,
+radv_init_llvm_compiler(struct ac_llvm_compiler **info, enum radeon_family family,
                         enum ac_target_machine_options tm_options, unsigned wave_size)
 {
    for (auto &I : radv_llvm_per_thread_list) {
       if (I.is_same(family, tm_options, wave_size)) {
-         *info = I.llvm_info;
+         *info = &I.llvm_info;
          return true;
       }
    }
@@ -115,6 +115,6 @@ radv_init_llvm_compiler(struct ac_llvm_compiler *info, enum radeon_family family
       return false;
    }
 
-   *info = tinfo.llvm_info;
+   *info = &tinfo.llvm_info;
    return true;
 }
@@ -29,7 +29,7 @@
 extern "C" {
 #endif
 
-bool radv_init_llvm_compiler(struct ac_llvm_compiler *info, enum radeon_family family,
+bool radv_init_llvm_compiler(struct ac_llvm_compiler **info, enum radeon_family family,
                              enum ac_target_machine_options tm_options, unsigned wave_size);
 
 bool radv_compile_to_elf(struct ac_llvm_compiler *info, LLVMModuleRef module, char **pelf_buffer,
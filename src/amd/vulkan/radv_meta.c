@@ -25,6 +25,7 @@
 
 #include "radv_meta.h"
 
+#include "util/simple_mtx.h"
 #include "vk_util.h"
 
 #include <fcntl.h>
@@ -293,9 +294,87 @@ radv_builtin_cache_path(char *path)
 }
 #endif
 
+/* Meta pipeline cache data of the last device destroyed in this process.
+ * Later devices load it instead of going back to disk, or compiling meta
+ * shaders on demand if the builtin cache file can't be used.
+ */
+static simple_mtx_t process_meta_cache_mtx = SIMPLE_MTX_INITIALIZER;
+static void *process_meta_cache_data;
+static size_t process_meta_cache_size;
+
+static bool
+radv_load_process_meta_cache(struct radv_device *device)
+{
+   bool ret = false;
+
+   simple_mtx_lock(&process_meta_cache_mtx);
+
+   if (process_meta_cache_data) {
+      VkPipelineCacheCreateInfo create_info = {
+         .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+         .initialDataSize = process_meta_cache_size,
+         .pInitialData = process_meta_cache_data,
+      };
+
+      if (radv_CreatePipelineCache(radv_device_to_handle(device), &create_info, NULL,
+                                   &device->meta_state.cache) == VK_SUCCESS) {
+         device->meta_state.initial_cache_entries =
+            radv_pipeline_cache_from_handle(device->meta_state.cache)->kernel_count;
+         ret = device->meta_state.initial_cache_entries > 0;
+
+         /* Probably from another GPU, fall back to the cache file. */
+         if (!ret) {
+            radv_DestroyPipelineCache(radv_device_to_handle(device), device->meta_state.cache,
+                                      NULL);
+            device->meta_state.cache = VK_NULL_HANDLE;
+         }
+      }
+   }
+
+   simple_mtx_unlock(&process_meta_cache_mtx);
+   return ret;
+}
+
+static void
+radv_store_process_meta_cache(struct radv_device *device)
+{
+   size_t size;
+
+   if (device->meta_state.cache == VK_NULL_HANDLE)
+      return;
+
+   /* Nothing new compared to what this device started with. */
+   if (radv_pipeline_cache_from_handle(device->meta_state.cache)->kernel_count <=
+       device->meta_state.initial_cache_entries)
+      return;
+
+   if (radv_GetPipelineCacheData(radv_device_to_handle(device), device->meta_state.cache, &size,
+                                 NULL))
+      return;
+
+   void *data = malloc(size);
+   if (!data)
+      return;
+
+   if (radv_GetPipelineCacheData(radv_device_to_handle(device), device->meta_state.cache, &size,
+                                 data)) {
+      free(data);
+      return;
+   }
+
+   simple_mtx_lock(&process_meta_cache_mtx);
+   free(process_meta_cache_data);
+   process_meta_cache_data = data;
+   process_meta_cache_size = size;
+   simple_mtx_unlock(&process_meta_cache_mtx);
+}
+
 static bool
 radv_load_meta_pipeline(struct radv_device *device)
 {
+   if (radv_load_process_meta_cache(device))
+      return true;
+
 #ifdef _WIN32
    return false;
 #else
@@ -543,6 +622,7 @@ radv_device_finish_meta(struct radv_device *device)
    radv_device_finish_meta_copy_vrs_htile_state(device);
    radv_device_finish_meta_fmask_copy_state(device);
 
+   radv_store_process_meta_cache(device);
    radv_store_meta_pipeline(device);
    radv_DestroyPipelineCache(radv_device_to_handle(device), device->meta_state.cache, NULL);
    mtx_destroy(&device->meta_state.mtx);
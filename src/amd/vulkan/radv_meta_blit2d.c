@@ -71,6 +71,7 @@ create_iview(struct radv_cmd_buffer *cmd_buffer, struct radv_meta_blit2d_surf *s
                                                 .layerCount = 1},
                         },
                         0, &(struct radv_image_view_extra_create_info){
+                           .disable_compression = surf->disable_compression,
                            .disable_dcc_mrt = surf->disable_compression
                         });
 }
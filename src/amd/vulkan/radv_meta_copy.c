@@ -349,6 +349,18 @@ radv_CmdCopyImageToBuffer2(VkCommandBuffer commandBuffer,
    }
 }
 
+/* Size in bytes of the part of the image a copy region touches, the unit of work of DCC
+ * decompression.
+ */
+static uint64_t
+radv_copy_subresource_size(const struct radv_image *image, const VkImageSubresourceLayers *subres)
+{
+   return (uint64_t)radv_minify(image->info.width, subres->mipLevel) *
+          radv_minify(image->info.height, subres->mipLevel) *
+          radv_minify(image->info.depth, subres->mipLevel) * subres->layerCount *
+          vk_format_get_blocksize(image->vk.format);
+}
+
 static void
 copy_image(struct radv_cmd_buffer *cmd_buffer, struct radv_image *src_image,
            VkImageLayout src_image_layout, struct radv_image *dst_image,
@@ -448,6 +460,22 @@ copy_image(struct radv_cmd_buffer *cmd_buffer, struct radv_image *src_image,
          b_src.format = b_dst.format;
       } else if (!dst_compressed) {
          b_dst.format = b_src.format;
+      } else if (radv_copy_subresource_size(src_image, &region->srcSubresource) <
+                 radv_copy_subresource_size(dst_image, &region->dstSubresource)) {
+         /* Both are compressed with incompatible formats, decompress the smaller one because
+          * that pass always covers the whole subresource. This is common when copying small
+          * images into a large one.
+          */
+         radv_decompress_dcc(cmd_buffer, src_image,
+                             &(VkImageSubresourceRange){
+                                .aspectMask = src_aspects[a],
+                                .baseMipLevel = region->srcSubresource.mipLevel,
+                                .levelCount = 1,
+                                .baseArrayLayer = region->srcSubresource.baseArrayLayer,
+                                .layerCount = region->srcSubresource.layerCount,
+                             });
+         b_src.format = b_dst.format;
+         b_src.disable_compression = true;
       } else {
          radv_decompress_dcc(cmd_buffer, dst_image,
                              &(VkImageSubresourceRange){
@@ -1584,9 +1584,8 @@ ac_compile_llvm_module(struct ac_llvm_compiler *ac_llvm, LLVMModuleRef llvm_modu
       fprintf(stderr, "compile failed\n");
    }
 
-   LLVMContextRef ctx = LLVMGetModuleContext(llvm_module);
    LLVMDisposeModule(llvm_module);
-   LLVMContextDispose(ctx);
+   ac_llvm_compiler_put_context(ac_llvm);
 
    size_t llvm_ir_size = llvm_ir_string ? strlen(llvm_ir_string) : 0;
    size_t alloc_size = sizeof(struct radv_shader_binary_rtld) + elf_size + llvm_ir_size + 1;
@@ -1759,17 +1758,18 @@ llvm_compile_shader(const struct radv_nir_compiler_options *options,
                     const struct radv_shader_args *args)
 {
    enum ac_target_machine_options tm_options = 0;
-   struct ac_llvm_compiler ac_llvm;
+   struct ac_llvm_compiler *ac_llvm;
 
    tm_options |= AC_TM_SUPPORTS_SPILL;
    if (options->check_ir)
       tm_options |= AC_TM_CHECK_IR;
 
+   /* Use the per-thread compiler directly, it owns the LLVM context shared between compiles. */
    radv_init_llvm_compiler(&ac_llvm, options->family, tm_options, info->wave_size);
 
    if (args->is_gs_copy_shader) {
-      radv_compile_gs_copy_shader(&ac_llvm, options, info, *shaders, binary, args);
+      radv_compile_gs_copy_shader(ac_llvm, options, info, *shaders, binary, args);
    } else {
-      radv_compile_nir_shader(&ac_llvm, options, info, binary, args, shaders, shader_count);
+      radv_compile_nir_shader(ac_llvm, options, info, binary, args, shaders, shader_count);
    }
 }
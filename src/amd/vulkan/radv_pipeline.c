@@ -3666,6 +3666,34 @@ radv_pipeline_create_gs_copy_shader(struct radv_pipeline *pipeline,
                                      pipeline_key->optimisations_disabled);
 }
 
+struct radv_nir_to_asm_job {
+   struct util_queue_fence fence;
+
+   struct radv_device *device;
+   struct radv_pipeline_stage *stage;
+   nir_shader *shaders[2];
+   unsigned shader_count;
+   const struct radv_pipeline_key *pipeline_key;
+   bool keep_executable_info;
+   bool keep_statistic_info;
+
+   struct radv_shader *shader;
+   struct radv_shader_binary **binary;
+};
+
+static void
+radv_nir_to_asm_job_execute(void *data, void *gdata, int thread_index)
+{
+   struct radv_nir_to_asm_job *job = data;
+   int64_t stage_start = os_time_get_nano();
+
+   job->shader = radv_shader_nir_to_asm(job->device, job->stage, job->shaders, job->shader_count,
+                                        job->pipeline_key, job->keep_executable_info,
+                                        job->keep_statistic_info, job->binary);
+
+   job->stage->feedback.duration += os_time_get_nano() - stage_start;
+}
+
 static void
 radv_pipeline_nir_to_asm(struct radv_pipeline *pipeline, struct radv_pipeline_stage *stages,
                          const struct radv_pipeline_key *pipeline_key,
@@ -3693,12 +3721,24 @@ radv_pipeline_nir_to_asm(struct radv_pipeline *pipeline, struct radv_pipeline_st
                                              gs_copy_binary);
    }
 
+   struct radv_nir_to_asm_job jobs[MESA_VULKAN_SHADER_STAGES];
+   unsigned num_jobs = 0;
+
    for (int s = MESA_VULKAN_SHADER_STAGES - 1; s >= 0; s--) {
       if (!(active_stages & (1 << s)) || pipeline->shaders[s])
          continue;
 
-      nir_shader *shaders[2] = { stages[s].nir, NULL };
-      unsigned shader_count = 1;
+      struct radv_nir_to_asm_job *job = &jobs[num_jobs++];
+      *job = (struct radv_nir_to_asm_job) {
+         .device = device,
+         .stage = &stages[s],
+         .shaders = { stages[s].nir, NULL },
+         .shader_count = 1,
+         .pipeline_key = pipeline_key,
+         .keep_executable_info = keep_executable_info,
+         .keep_statistic_info = keep_statistic_info,
+         .binary = &binaries[s],
+      };
 
       /* On GFX9+, TES is merged with GS and VS is merged with TCS or GS. */
       if (device->physical_device->rad_info.gfx_level >= GFX9 &&
@@ -3711,23 +3751,39 @@ radv_pipeline_nir_to_asm(struct radv_pipeline *pipeline, struct radv_pipeline_st
             pre_stage = MESA_SHADER_VERTEX;
          }
 
-         shaders[0] = stages[pre_stage].nir;
-         shaders[1] = stages[s].nir;
-         shader_count = 2;
+         job->shaders[0] = stages[pre_stage].nir;
+         job->shaders[1] = stages[s].nir;
+         job->shader_count = 2;
       }
 
-      int64_t stage_start = os_time_get_nano();
+      active_stages &= ~(1 << job->shaders[0]->info.stage);
+      if (job->shaders[1])
+         active_stages &= ~(1 << job->shaders[1]->info.stage);
+   }
 
-      pipeline->shaders[s] = radv_shader_nir_to_asm(device, &stages[s], shaders, shader_count,
-                                                    pipeline_key, keep_executable_info,
-                                                    keep_statistic_info, &binaries[s]);
+   /* Once linked, every job has its own NIR and only writes to its own stage, so they can be
+    * compiled in parallel.  Keep one of them for this thread instead of just waiting.
+    */
+   unsigned num_queued = 0;
+   if (num_jobs > 1 && util_queue_is_initialized(&device->shader_compile_queue)) {
+      for (unsigned i = 1; i < num_jobs; i++) {
+         util_queue_fence_init(&jobs[i].fence);
+         util_queue_add_job(&device->shader_compile_queue, &jobs[i], &jobs[i].fence,
+                            radv_nir_to_asm_job_execute, NULL, 0);
+      }
+      num_queued = num_jobs - 1;
+   }
 
-      stages[s].feedback.duration += os_time_get_nano() - stage_start;
+   for (unsigned i = 0; i < num_jobs - num_queued; i++)
+      radv_nir_to_asm_job_execute(&jobs[i], NULL, 0);
 
-      active_stages &= ~(1 << shaders[0]->info.stage);
-      if (shaders[1])
-         active_stages &= ~(1 << shaders[1]->info.stage);
+   for (unsigned i = num_jobs - num_queued; i < num_jobs; i++) {
+      util_queue_fence_wait(&jobs[i].fence);
+      util_queue_fence_destroy(&jobs[i].fence);
    }
+
+   for (unsigned i = 0; i < num_jobs; i++)
+      pipeline->shaders[jobs[i].stage->stage] = jobs[i].shader;
 }
 
 static void
@@ -52,6 +52,7 @@
 #include "util/list.h"
 #include "util/macros.h"
 #include "util/rwlock.h"
+#include "util/u_queue.h"
 #include "util/xmlconfig.h"
 #include "vk_alloc.h"
 #include "vk_buffer.h"
@@ -692,7 +693,6 @@ struct radv_meta_state {
    struct {
       VkDescriptorSetLayout ds_layout;
       VkPipelineLayout p_layout;
-      VkPipeline pipeline;
    } dgc_prepare;
 };
 
@@ -852,6 +852,9 @@ struct radv_device {
    struct list_head shader_block_obj_pool;
    mtx_t shader_arena_mutex;
 
+   /* Worker threads for compiling the stages of a pipeline in parallel. */
+   struct util_queue shader_compile_queue;
+
    /* For detecting VM faults reported by dmesg. */
    uint64_t dmesg_timestamp;
 
@@ -2927,6 +2930,9 @@ struct radv_indirect_command_layout {
    uint32_t ibo_type_32;
    uint32_t ibo_type_8;
 
+   /* Preprocess shader specialized for this layout. */
+   VkPipeline pipeline;
+
    VkIndirectCommandsLayoutTokenNV tokens[0];
 };
 
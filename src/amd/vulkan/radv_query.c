@@ -39,6 +39,9 @@
 
 #define TIMESTAMP_NOT_READY UINT64_MAX
 
+/* Copies of up to this many timestamps are done with CP packets. */
+#define RADV_QUERY_CP_COPY_MAX_COUNT 16
+
 /* TODO: Add support for mesh/task queries on GFX11 */
 static const unsigned pipeline_statistics_indices[] = {7, 6, 3, 4, 5, 2, 1, 0, 8, 9, 10};
 
@@ -1575,6 +1578,33 @@ radv_CmdCopyQueryPoolResults(VkCommandBuffer commandBuffer, VkQueryPool queryPoo
          }
       }
 
+      /* Once the CP has waited for them, a few timestamps are copied much
+       * faster with COPY_DATA than by setting up a compute dispatch.  The
+       * EOP timestamp writes and the CP are coherent through L2 on GFX9+.
+       */
+      if (pool->type == VK_QUERY_TYPE_TIMESTAMP && (flags & VK_QUERY_RESULT_WAIT_BIT) &&
+          !(flags & (VK_QUERY_RESULT_WITH_AVAILABILITY_BIT | VK_QUERY_RESULT_PARTIAL_BIT)) &&
+          queryCount <= RADV_QUERY_CP_COPY_MAX_COUNT &&
+          cmd_buffer->device->physical_device->rad_info.gfx_level >= GFX9) {
+         dest_va = radv_buffer_get_va(dst_buffer->bo) + dst_buffer->offset + dstOffset;
+
+         radeon_check_space(cmd_buffer->device->ws, cs, 6 * queryCount);
+
+         for (unsigned i = 0; i < queryCount; ++i, dest_va += stride) {
+            uint64_t src_va = va + (firstQuery + i) * pool->stride;
+
+            radeon_emit(cs, PKT3(PKT3_COPY_DATA, 4, 0));
+            radeon_emit(cs, COPY_DATA_SRC_SEL(COPY_DATA_SRC_MEM) |
+                            COPY_DATA_DST_SEL(COPY_DATA_DST_MEM) | COPY_DATA_WR_CONFIRM |
+                            ((flags & VK_QUERY_RESULT_64_BIT) ? COPY_DATA_COUNT_SEL : 0));
+            radeon_emit(cs, src_va);
+            radeon_emit(cs, src_va >> 32);
+            radeon_emit(cs, dest_va);
+            radeon_emit(cs, dest_va >> 32);
+         }
+         break;
+      }
+
       radv_query_shader(cmd_buffer, &cmd_buffer->device->meta_state.query.timestamp_query_pipeline,
                         pool->bo, dst_buffer->bo, firstQuery * pool->stride,
                         dst_buffer->offset + dstOffset, pool->stride, stride, dst_size, queryCount,
@@ -1541,8 +1541,8 @@ radv_alloc_shader_memory(struct radv_device *device, uint32_t size, void *ptr)
 
    mtx_lock(&device->shader_arena_mutex);
 
-   /* Try to use an existing hole. Unless the shader is very large, this should only have to look
-    * at the first one available.
+   /* Try to use an existing hole. Every hole in the chosen size class fits, so take the smallest
+    * one to keep the larger holes around for larger shaders.
     */
    unsigned free_list_mask = BITFIELD_MASK(RADV_SHADER_ALLOC_NUM_FREE_LISTS);
    unsigned size_class =
@@ -1550,12 +1550,19 @@ radv_alloc_shader_memory(struct radv_device *device, uint32_t size, void *ptr)
    if (size_class) {
       size_class--;
 
-      list_for_each_entry(union radv_shader_arena_block, hole,
+      union radv_shader_arena_block *hole = NULL;
+      list_for_each_entry(union radv_shader_arena_block, candidate,
                           &device->shader_free_lists[size_class], freelist)
       {
-         if (hole->size < size)
+         if (candidate->size < size || (hole && hole->size <= candidate->size))
             continue;
 
+         hole = candidate;
+         if (hole->size == size)
+            break;
+      }
+
+      if (hole) {
          assert(hole->offset % RADV_SHADER_ALLOC_ALIGNMENT == 0);
 
          if (size == hole->size) {
@@ -1705,6 +1712,45 @@ radv_free_shader_memory(struct radv_device *device, union radv_shader_arena_bloc
    mtx_unlock(&device->shader_arena_mutex);
 }
 
+void
+radv_dump_shader_arenas(struct radv_device *device, FILE *f)
+{
+   mtx_lock(&device->shader_arena_mutex);
+
+   uint64_t total_size = 0, total_used = 0;
+   unsigned num_arenas = 0;
+
+   list_for_each_entry(struct radv_shader_arena, arena, &device->shader_arenas, list)
+   {
+      uint32_t size = 0, used = 0, largest_hole = 0;
+      unsigned num_allocs = 0, num_holes = 0;
+
+      list_for_each_entry(union radv_shader_arena_block, block, &arena->entries, list)
+      {
+         size += block->size;
+         if (block->freelist.prev) {
+            largest_hole = MAX2(largest_hole, block->size);
+            num_holes++;
+         } else {
+            used += block->size;
+            num_allocs++;
+         }
+      }
+
+      fprintf(f, "Arena %u: %u/%u bytes used by %u allocations, %u holes (largest %u bytes)\n",
+              num_arenas, used, size, num_allocs, num_holes, largest_hole);
+
+      total_size += size;
+      total_used += used;
+      num_arenas++;
+   }
+
+   fprintf(f, "\nTotal: %" PRIu64 "/%" PRIu64 " bytes used in %u arenas\n", total_used, total_size,
+           num_arenas);
+
+   mtx_unlock(&device->shader_arena_mutex);
+}
+
 void
 radv_init_shader_arenas(struct radv_device *device)
 {
@@ -552,6 +552,7 @@ void radv_nir_lower_abi(nir_shader *shader, enum amd_gfx_level gfx_level,
 
 void radv_init_shader_arenas(struct radv_device *device);
 void radv_destroy_shader_arenas(struct radv_device *device);
+void radv_dump_shader_arenas(struct radv_device *device, FILE *f);
 
 struct radv_pipeline_shader_stack_size;
 
@@ -457,6 +457,8 @@ radv_thread_trace_init(struct radv_device *device)
    device->thread_trace.buffer_size =
       radv_get_int_debug_option("RADV_THREAD_TRACE_BUFFER_SIZE", 32 * 1024 * 1024);
    device->thread_trace.start_frame = radv_get_int_debug_option("RADV_THREAD_TRACE", -1);
+   device->thread_trace.interval =
+      MAX2(radv_get_int_debug_option("RADV_THREAD_TRACE_INTERVAL", 0), 0);
 
    const char *trigger_file = getenv("RADV_THREAD_TRACE_TRIGGER");
    if (trigger_file)
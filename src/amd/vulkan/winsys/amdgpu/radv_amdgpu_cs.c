@@ -748,6 +748,19 @@ radv_amdgpu_cs_execute_secondary(struct radeon_cmdbuf *_parent, struct radeon_cm
    }
 }
 
+static int
+radv_amdgpu_bo_list_entry_compare(const void *a, const void *b)
+{
+   const struct drm_amdgpu_bo_list_entry *entry_a = a;
+   const struct drm_amdgpu_bo_list_entry *entry_b = b;
+
+   if (entry_a->bo_handle != entry_b->bo_handle)
+      return entry_a->bo_handle < entry_b->bo_handle ? -1 : 1;
+
+   /* Keep the highest priority of duplicated BOs first. */
+   return (int)entry_b->bo_priority - (int)entry_a->bo_priority;
+}
+
 static VkResult
 radv_amdgpu_get_bo_list(struct radv_amdgpu_winsys *ws, struct radeon_cmdbuf **cs_array,
                         unsigned count, struct radv_amdgpu_winsys_bo **extra_bo_array,
@@ -783,17 +796,14 @@ radv_amdgpu_get_bo_list(struct radv_amdgpu_winsys *ws, struct radeon_cmdbuf **cs
    } else {
       unsigned total_buffer_count = num_extra_bo;
       num_handles = num_extra_bo;
-      for (unsigned i = 0; i < count; ++i) {
-         struct radv_amdgpu_cs *cs = (struct radv_amdgpu_cs *)cs_array[i];
+      for (unsigned i = 0; i < count + !!extra_cs; ++i) {
+         struct radv_amdgpu_cs *cs =
+            (struct radv_amdgpu_cs *)(i == count ? extra_cs : cs_array[i]);
          total_buffer_count += cs->num_buffers;
          for (unsigned j = 0; j < cs->num_virtual_buffers; ++j)
             total_buffer_count += radv_amdgpu_winsys_bo(cs->virtual_buffers[j])->bo_count;
       }
 
-      if (extra_cs) {
-         total_buffer_count += ((struct radv_amdgpu_cs *)extra_cs)->num_buffers;
-      }
-
       total_buffer_count += ws->global_bo_list.count;
 
       if (total_buffer_count == 0)
@@ -808,6 +818,9 @@ radv_amdgpu_get_bo_list(struct radv_amdgpu_winsys *ws, struct radeon_cmdbuf **cs
          handles[i].bo_priority = extra_bo_array[i]->priority;
       }
 
+      /* Gather everything first and remove the duplicates afterwards, looking every BO up in the
+       * handles gathered so far is quadratic in the number of BOs.
+       */
       for (unsigned i = 0; i < count + !!extra_cs; ++i) {
          struct radv_amdgpu_cs *cs;
 
@@ -816,65 +829,38 @@ radv_amdgpu_get_bo_list(struct radv_amdgpu_winsys *ws, struct radeon_cmdbuf **cs
          else
             cs = (struct radv_amdgpu_cs *)cs_array[i];
 
-         if (!cs->num_buffers)
-            continue;
+         memcpy(handles + num_handles, cs->handles,
+                cs->num_buffers * sizeof(struct drm_amdgpu_bo_list_entry));
+         num_handles += cs->num_buffers;
 
-         if (num_handles == 0 && !cs->num_virtual_buffers) {
-            memcpy(handles, cs->handles, cs->num_buffers * sizeof(struct drm_amdgpu_bo_list_entry));
-            num_handles = cs->num_buffers;
-            continue;
-         }
-         int unique_bo_so_far = num_handles;
-         for (unsigned j = 0; j < cs->num_buffers; ++j) {
-            bool found = false;
-            for (unsigned k = 0; k < unique_bo_so_far; ++k) {
-               if (handles[k].bo_handle == cs->handles[j].bo_handle) {
-                  found = true;
-                  break;
-               }
-            }
-            if (!found) {
-               handles[num_handles] = cs->handles[j];
-               ++num_handles;
-            }
-         }
          for (unsigned j = 0; j < cs->num_virtual_buffers; ++j) {
             struct radv_amdgpu_winsys_bo *virtual_bo =
                radv_amdgpu_winsys_bo(cs->virtual_buffers[j]);
             for (unsigned k = 0; k < virtual_bo->bo_count; ++k) {
                struct radv_amdgpu_winsys_bo *bo = virtual_bo->bos[k];
-               bool found = false;
-               for (unsigned m = 0; m < num_handles; ++m) {
-                  if (handles[m].bo_handle == bo->bo_handle) {
-                     found = true;
-                     break;
-                  }
-               }
-               if (!found) {
-                  handles[num_handles].bo_handle = bo->bo_handle;
-                  handles[num_handles].bo_priority = bo->priority;
-                  ++num_handles;
-               }
+               handles[num_handles].bo_handle = bo->bo_handle;
+               handles[num_handles].bo_priority = bo->priority;
+               ++num_handles;
             }
          }
       }
 
-      unsigned unique_bo_so_far = num_handles;
       for (unsigned i = 0; i < ws->global_bo_list.count; ++i) {
          struct radv_amdgpu_winsys_bo *bo = ws->global_bo_list.bos[i];
-         bool found = false;
-         for (unsigned j = 0; j < unique_bo_so_far; ++j) {
-            if (bo->bo_handle == handles[j].bo_handle) {
-               found = true;
-               break;
-            }
-         }
-         if (!found) {
-            handles[num_handles].bo_handle = bo->bo_handle;
-            handles[num_handles].bo_priority = bo->priority;
-            ++num_handles;
-         }
+         handles[num_handles].bo_handle = bo->bo_handle;
+         handles[num_handles].bo_priority = bo->priority;
+         ++num_handles;
+      }
+
+      assert(num_handles == total_buffer_count);
+      qsort(handles, num_handles, sizeof(handles[0]), radv_amdgpu_bo_list_entry_compare);
+
+      unsigned unique_count = 1;
+      for (unsigned i = 1; i < num_handles; ++i) {
+         if (handles[i].bo_handle != handles[unique_count - 1].bo_handle)
+            handles[unique_count++] = handles[i];
       }
+      num_handles = unique_count;
    }
 
    *rhandles = handles;
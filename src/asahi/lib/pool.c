@@ -69,6 +69,33 @@ agx_pool_cleanup(struct agx_pool *pool)
    util_dynarray_fini(&pool->bos);
 }
 
+void
+agx_pool_reset(struct agx_pool *pool)
+{
+   unsigned count = agx_pool_num_bos(pool);
+   struct agx_bo **bos = util_dynarray_begin(&pool->bos);
+   struct agx_bo *keep = NULL;
+
+   /* Hold on to the first slab-sized BO and release anything else, so a pool
+    * that is reset every batch doesn't allocate fresh backing each time.
+    */
+   for (unsigned i = 0; i < count; ++i) {
+      if (!keep && bos[i]->size == POOL_SLAB_SIZE)
+         keep = bos[i];
+      else
+         agx_bo_unreference(bos[i]);
+   }
+
+   util_dynarray_clear(&pool->bos);
+   pool->transient_bo = NULL;
+   pool->transient_offset = 0;
+
+   if (keep) {
+      util_dynarray_append(&pool->bos, struct agx_bo *, keep);
+      pool->transient_bo = keep;
+   }
+}
+
 void
 agx_pool_get_bo_handles(struct agx_pool *pool, uint32_t *handles)
 {
@@ -60,6 +60,11 @@ agx_pool_init(struct agx_pool *pool, struct agx_device *dev,
 void
 agx_pool_cleanup(struct agx_pool *pool);
 
+/* Release the pool's contents for reuse. The caller must ensure the GPU is
+ * done with everything allocated from the pool. */
+void
+agx_pool_reset(struct agx_pool *pool);
+
 static inline unsigned
 agx_pool_num_bos(struct agx_pool *pool)
 {
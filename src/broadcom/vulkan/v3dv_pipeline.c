@@ -35,6 +35,7 @@
 #include "util/u_atomic.h"
 #include "util/u_prim.h"
 #include "util/os_time.h"
+#include "util/u_thread.h"
 
 #include "vk_pipeline.h"
 #include "vulkan/util/vk_format.h"
@@ -1619,6 +1620,54 @@ pipeline_compile_shader_variant(struct v3dv_pipeline_stage *p_stage,
    return variant;
 }
 
+struct v3dv_variant_compile_job {
+   struct v3dv_pipeline_stage *p_stage;
+   struct v3d_key *key;
+   size_t key_size;
+   const VkAllocationCallbacks *pAllocator;
+   struct v3dv_shader_variant *variant;
+   VkResult vk_result;
+};
+
+static int
+variant_compile_job_run(void *data)
+{
+   struct v3dv_variant_compile_job *job = data;
+   job->variant = pipeline_compile_shader_variant(job->p_stage, job->key,
+                                                  job->key_size,
+                                                  job->pAllocator,
+                                                  &job->vk_result);
+   return 0;
+}
+
+/* Compiles the render and binning variants of a stage. Both variants are
+ * compiled from their own NIR clone of the already lowered and linked
+ * render shader, so the backend compiles don't share any mutable state and
+ * we can run the binning one in a separate thread while the render one is
+ * compiled in the calling thread. If we can't spawn the thread we just
+ * compile both sequentially.
+ */
+static VkResult
+pipeline_compile_render_and_bin_variants(struct v3dv_variant_compile_job *render,
+                                         struct v3dv_variant_compile_job *bin)
+{
+   thrd_t bin_thread;
+   bool threaded =
+      u_thread_create(&bin_thread, variant_compile_job_run, bin) == thrd_success;
+
+   variant_compile_job_run(render);
+
+   if (threaded)
+      thrd_join(bin_thread, NULL);
+   else
+      variant_compile_job_run(bin);
+
+   if (render->vk_result != VK_SUCCESS)
+      return render->vk_result;
+
+   return bin->vk_result;
+}
+
 static void
 link_shaders(nir_shader *producer, nir_shader *consumer)
 {
@@ -1790,19 +1839,28 @@ pipeline_compile_vertex_shader(struct v3dv_pipeline *pipeline,
       p_stage_vs_bin->nir = nir_shader_clone(NULL, p_stage_vs->nir);
    }
 
-   VkResult vk_result;
-   struct v3d_vs_key key;
+   struct v3d_vs_key key, bin_key;
    pipeline_populate_v3d_vs_key(&key, pCreateInfo, p_stage_vs);
-   pipeline->shared_data->variants[BROADCOM_SHADER_VERTEX] =
-      pipeline_compile_shader_variant(p_stage_vs, &key.base, sizeof(key),
-                                      pAllocator, &vk_result);
-   if (vk_result != VK_SUCCESS)
-      return vk_result;
+   pipeline_populate_v3d_vs_key(&bin_key, pCreateInfo, p_stage_vs_bin);
 
-   pipeline_populate_v3d_vs_key(&key, pCreateInfo, p_stage_vs_bin);
-   pipeline->shared_data->variants[BROADCOM_SHADER_VERTEX_BIN] =
-      pipeline_compile_shader_variant(p_stage_vs_bin, &key.base, sizeof(key),
-                                      pAllocator, &vk_result);
+   struct v3dv_variant_compile_job render = {
+      .p_stage = p_stage_vs,
+      .key = &key.base,
+      .key_size = sizeof(key),
+      .pAllocator = pAllocator,
+   };
+   struct v3dv_variant_compile_job bin = {
+      .p_stage = p_stage_vs_bin,
+      .key = &bin_key.base,
+      .key_size = sizeof(bin_key),
+      .pAllocator = pAllocator,
+   };
+
+   VkResult vk_result =
+      pipeline_compile_render_and_bin_variants(&render, &bin);
+
+   pipeline->shared_data->variants[BROADCOM_SHADER_VERTEX] = render.variant;
+   pipeline->shared_data->variants[BROADCOM_SHADER_VERTEX_BIN] = bin.variant;
 
    return vk_result;
 }
@@ -1824,19 +1882,28 @@ pipeline_compile_geometry_shader(struct v3dv_pipeline *pipeline,
       p_stage_gs_bin->nir = nir_shader_clone(NULL, p_stage_gs->nir);
    }
 
-   VkResult vk_result;
-   struct v3d_gs_key key;
+   struct v3d_gs_key key, bin_key;
    pipeline_populate_v3d_gs_key(&key, pCreateInfo, p_stage_gs);
-   pipeline->shared_data->variants[BROADCOM_SHADER_GEOMETRY] =
-      pipeline_compile_shader_variant(p_stage_gs, &key.base, sizeof(key),
-                                      pAllocator, &vk_result);
-   if (vk_result != VK_SUCCESS)
-      return vk_result;
+   pipeline_populate_v3d_gs_key(&bin_key, pCreateInfo, p_stage_gs_bin);
 
-   pipeline_populate_v3d_gs_key(&key, pCreateInfo, p_stage_gs_bin);
-   pipeline->shared_data->variants[BROADCOM_SHADER_GEOMETRY_BIN] =
-      pipeline_compile_shader_variant(p_stage_gs_bin, &key.base, sizeof(key),
-                                      pAllocator, &vk_result);
+   struct v3dv_variant_compile_job render = {
+      .p_stage = p_stage_gs,
+      .key = &key.base,
+      .key_size = sizeof(key),
+      .pAllocator = pAllocator,
+   };
+   struct v3dv_variant_compile_job bin = {
+      .p_stage = p_stage_gs_bin,
+      .key = &bin_key.base,
+      .key_size = sizeof(bin_key),
+      .pAllocator = pAllocator,
+   };
+
+   VkResult vk_result =
+      pipeline_compile_render_and_bin_variants(&render, &bin);
+
+   pipeline->shared_data->variants[BROADCOM_SHADER_GEOMETRY] = render.variant;
+   pipeline->shared_data->variants[BROADCOM_SHADER_GEOMETRY_BIN] = bin.variant;
 
    return vk_result;
 }
@@ -60,6 +60,7 @@
 #include "serialize.h"
 #include "shader_cache.h"
 #include "util/mesa-sha1.h"
+#include "util/u_thread.h"
 #include "string_to_uint_map.h"
 #include "main/mtypes.h"
 
@@ -69,11 +70,51 @@ extern "C" {
 #include "program/program.h"
 }
 
+struct compile_job {
+   struct gl_context *ctx;
+   struct gl_shader *shader;
+};
+
+static int
+compile_shader_thread(void *data)
+{
+   struct compile_job *job = (struct compile_job *) data;
+
+   _mesa_glsl_compile_shader(job->ctx, job->shader, false, false, true);
+   return 0;
+}
+
 static void
 compile_shaders(struct gl_context *ctx, struct gl_shader_program *prog) {
-   for (unsigned i = 0; i < prog->NumShaders; i++) {
+   struct compile_job jobs[MESA_SHADER_STAGES];
+   thrd_t threads[MESA_SHADER_STAGES];
+   unsigned num_threads = 0;
+   unsigned i = 0;
+
+   /* The shaders of a program don't depend on each other before linking,
+    * and the only state the front-end shares between compiles (builtins
+    * and types) is locked, so compile all but the last one on their own
+    * threads.  Keep compiling on this thread when debug output is active,
+    * since messages must reach the app's callback from its own thread.
+    */
+   if (!ctx->Debug) {
+      for (; i + 1 < prog->NumShaders && num_threads < ARRAY_SIZE(threads);
+           i++) {
+         jobs[num_threads].ctx = ctx;
+         jobs[num_threads].shader = prog->Shaders[i];
+         if (u_thread_create(&threads[num_threads], compile_shader_thread,
+                             &jobs[num_threads]) != thrd_success)
+            break;
+         num_threads++;
+      }
+   }
+
+   for (; i < prog->NumShaders; i++) {
       _mesa_glsl_compile_shader(ctx, prog->Shaders[i], false, false, true);
    }
+
+   for (unsigned t = 0; t < num_threads; t++)
+      thrd_join(threads[t], NULL);
 }
 
 static void
@@ -583,15 +583,11 @@ nir_block_create(nir_shader *shader)
    block->successors[0] = block->successors[1] = NULL;
    block->predecessors = _mesa_pointer_set_create(block);
    block->imm_dom = NULL;
-   /* XXX maybe it would be worth it to defer allocation?  This
-    * way it doesn't get allocated for shader refs that never run
-    * nir_calc_dominance?  For example, state-tracker creates an
-    * initial IR, clones that, runs appropriate lowering pass, passes
-    * to driver which does common lowering/opt, and then stores ref
-    * which is later used to do state specific lowering and futher
-    * opt.  Do any of the references not need dominance metadata?
+   /* The dominance frontier is allocated by nir_calc_dominance_impl().
+    * Plenty of blocks never have dominance computed, e.g. in shaders that
+    * are cloned and lowered again later, and nir_sweep() drops it.
     */
-   block->dom_frontier = _mesa_pointer_set_create(block);
+   block->dom_frontier = NULL;
 
    exec_list_make_empty(&block->instr_list);
 
@@ -2702,7 +2702,9 @@ typedef struct nir_block {
    unsigned num_dom_children;
    struct nir_block **dom_children;
 
-   /* Set of nir_blocks on the dominance frontier of this block */
+   /* Set of nir_blocks on the dominance frontier of this block, NULL until
+    * dominance has been computed
+    */
    struct set *dom_frontier;
 
    /*
@@ -4416,6 +4418,14 @@ static inline bool should_skip_nir(UNUSED const char *pass_name) { return false;
 static inline bool should_print_nir(UNUSED nir_shader *shader) { return false; }
 #endif /* NDEBUG */
 
+/** Per-pass statistics, enabled with the NIR_PASS_STATS environment variable
+ *
+ * nir_pass_stats_start() returns 0 when statistics are disabled, and a
+ * timestamp to hand to nir_pass_stats_end() otherwise.
+ */
+int64_t nir_pass_stats_start(void);
+void nir_pass_stats_end(const char *pass, int64_t start, bool progress);
+
 #define _PASS(pass, nir, do_pass) do {                               \
    if (should_skip_nir(#pass)) {                                     \
       printf("skipping %s\n", #pass);                                \
@@ -4435,7 +4445,11 @@ static inline bool should_print_nir(UNUSED nir_shader *shader) { return false; }
    nir_metadata_set_validation_flag(nir);                            \
    if (should_print_nir(nir))                                        \
       printf("%s\n", #pass);                                         \
-   if (pass(nir, ##__VA_ARGS__)) {                                   \
+   const int64_t _pass_start = nir_pass_stats_start();               \
+   const bool _pass_progress = pass(nir, ##__VA_ARGS__);             \
+   if (unlikely(_pass_start))                                        \
+      nir_pass_stats_end(#pass, _pass_start, _pass_progress);        \
+   if (_pass_progress) {                                             \
       nir_validate_shader(nir, "after " #pass " in " __FILE__);      \
       UNUSED bool _;                                                 \
       progress = true;                                               \
@@ -4448,7 +4462,10 @@ static inline bool should_print_nir(UNUSED nir_shader *shader) { return false; }
 #define NIR_PASS_V(nir, pass, ...) _PASS(pass, nir,                  \
    if (should_print_nir(nir))                                        \
       printf("%s\n", #pass);                                         \
+   const int64_t _pass_start = nir_pass_stats_start();               \
    pass(nir, ##__VA_ARGS__);                                         \
+   if (unlikely(_pass_start))                                        \
+      nir_pass_stats_end(#pass, _pass_start, false);                 \
    nir_validate_shader(nir, "after " #pass " in " __FILE__);         \
    if (should_print_nir(nir))                                        \
       nir_print_shader(nir, stdout);                                 \
@@ -4456,6 +4473,44 @@ static inline bool should_print_nir(UNUSED nir_shader *shader) { return false; }
 
 #define NIR_SKIP(name) should_skip_nir(#name)
 
+/** Remembers which passes of an optimization loop have nothing left to do
+ *
+ * Passes only look at the shader and their arguments, so a pass which made
+ * no progress can't make any when run again before some other pass changed
+ * the shader.  NIR_LOOP_PASS() records, for each call site, how many passes
+ * had made progress when it last did nothing, and skips the call site while
+ * that count is unchanged.  In a fixed-point loop, this skips most of the
+ * final iteration, where every pass runs without finding anything to do.
+ *
+ * While the state is in use, the shader must only be changed by passes run
+ * through NIR_LOOP_PASS() with that state, and each call site must always
+ * pass the same arguments.
+ */
+typedef struct {
+   unsigned progress_count;
+
+   /* Call site -> progress_count + 1 when it last made no progress */
+   struct hash_table *idle_sites;
+} nir_loop_pass_state;
+
+void nir_loop_pass_state_init(nir_loop_pass_state *state);
+void nir_loop_pass_state_finish(nir_loop_pass_state *state);
+bool nir_loop_pass_is_idle(const nir_loop_pass_state *state,
+                           const void *site);
+void nir_loop_pass_record(nir_loop_pass_state *state, const void *site,
+                          bool progress);
+
+#define NIR_LOOP_PASS(progress, state, nir, pass, ...) do {                \
+   static char _site;                                                       \
+   if (!nir_loop_pass_is_idle(state, &_site)) {                             \
+      bool _loop_progress = false;                                          \
+      NIR_PASS(_loop_progress, nir, pass, ##__VA_ARGS__);                   \
+      nir_loop_pass_record(state, &_site, _loop_progress);                  \
+      if (_loop_progress)                                                   \
+         progress = true;                                                   \
+   }                                                                        \
+} while (0)
+
 /** An instruction filtering callback with writemask
  *
  * Returns true if the instruction should be processed with the associated
@@ -5566,6 +5621,8 @@ bool nir_opt_if(nir_shader *shader, nir_opt_if_options options);
 
 bool nir_opt_intrinsics(nir_shader *shader);
 
+bool nir_opt_licm(nir_shader *shader, unsigned max_components);
+
 bool nir_opt_large_constants(nir_shader *shader,
                              glsl_type_size_align_func size_align,
                              unsigned threshold);
@@ -5588,6 +5645,8 @@ bool nir_opt_sink(nir_shader *shader, nir_move_options options);
 
 bool nir_opt_move(nir_shader *shader, nir_move_options options);
 
+bool nir_opt_narrow_int(nir_shader *shader);
+
 typedef struct {
    /** nir_load_uniform max base offset */
    uint32_t uniform_max;
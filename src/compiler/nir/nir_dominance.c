@@ -46,7 +46,10 @@ init_block(nir_block *block, nir_function_impl *impl)
    block->dom_pre_index = UINT32_MAX;
    block->dom_post_index = 0;
 
-   _mesa_set_clear(block->dom_frontier, NULL);
+   if (block->dom_frontier)
+      _mesa_set_clear(block->dom_frontier, NULL);
+   else
+      block->dom_frontier = _mesa_pointer_set_create(block);
 
    return true;
 }
@@ -182,6 +185,16 @@ nir_calc_dominance_impl(nir_function_impl *impl)
          if (block != nir_start_block(impl))
             progress |= calc_dominance(block);
       }
+
+      /* Structured control flow is reducible and the blocks come in reverse
+       * post-order, so every predecessor other than a loop back-edge has its
+       * final immediate dominator by the time we get to a block.  Back-edges
+       * come from blocks the loop header dominates and never change the
+       * result, so the first pass is exact and there's no need to run a
+       * second one just to see nothing change.
+       */
+      if (impl->structured)
+         break;
    }
 
    nir_foreach_block_unstructured(block, impl) {
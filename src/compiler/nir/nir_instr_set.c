@@ -93,31 +93,52 @@ hash_src(uint32_t hash, const nir_src *src)
    return hash;
 }
 
+/* ALU instructions are by far the most common ones to be hashed, so their
+ * fields are packed and hashed with a single XXH32 call each rather than one
+ * call per field.
+ */
+struct alu_src_hash_data {
+   nir_ssa_def *ssa;
+   uint8_t abs;
+   uint8_t negate;
+   uint8_t swizzle[NIR_MAX_VEC_COMPONENTS];
+};
+
 static uint32_t
 hash_alu_src(uint32_t hash, const nir_alu_src *src, unsigned num_components)
 {
-   hash = HASH(hash, src->abs);
-   hash = HASH(hash, src->negate);
+   assert(src->src.is_ssa);
 
-   for (unsigned i = 0; i < num_components; i++)
-      hash = HASH(hash, src->swizzle[i]);
+   struct alu_src_hash_data data;
 
-   hash = hash_src(hash, &src->src);
-   return hash;
+   data.ssa = src->src.ssa;
+   data.abs = src->abs;
+   data.negate = src->negate;
+   memcpy(data.swizzle, src->swizzle, num_components);
+
+   return XXH32(&data, offsetof(struct alu_src_hash_data, swizzle) + num_components,
+                hash);
 }
 
 static uint32_t
 hash_alu(uint32_t hash, const nir_alu_instr *instr)
 {
-   hash = HASH(hash, instr->op);
-
+   struct {
+      uint32_t op;
+      uint8_t flags;
+      uint8_t num_components;
+      uint8_t bit_size;
+      uint8_t pad;
+   } header;
+
+   header.op = instr->op;
    /* We explicitly don't hash instr->exact. */
-   uint8_t flags = instr->no_signed_wrap |
-                   instr->no_unsigned_wrap << 1;
-   hash = HASH(hash, flags);
-
-   hash = HASH(hash, instr->dest.dest.ssa.num_components);
-   hash = HASH(hash, instr->dest.dest.ssa.bit_size);
+   header.flags = instr->no_signed_wrap |
+                  instr->no_unsigned_wrap << 1;
+   header.num_components = instr->dest.dest.ssa.num_components;
+   header.bit_size = instr->dest.dest.ssa.bit_size;
+   header.pad = 0;
+   hash = HASH(hash, header);
 
    if (nir_op_infos[instr->op].algebraic_properties & NIR_OP_IS_2SRC_COMMUTATIVE) {
       assert(nir_op_infos[instr->op].num_inputs >= 2);
@@ -27,6 +27,7 @@
 #include "nir.h"
 #include "nir_worklist.h"
 #include "nir_vla.h"
+#include "util/u_dynarray.h"
 
 /*
  * Basic liveness analysis.  This works only in SSA form.
@@ -42,12 +43,25 @@
  * block but not in the live-in of the block containing the phi node.
  */
 
+/* What walking a block backwards does to a live set, see
+ * init_block_transfer().  These are ranges in live_ssa_defs_state::indices.
+ */
+struct live_block_transfer {
+   unsigned kill_start;
+   unsigned gen_start;
+   unsigned gen_end;
+};
+
 struct live_ssa_defs_state {
    unsigned bitset_words;
 
-   /* Used in propagate_across_edge() */
+   /* Used in propagate_across_edge() and init_block_transfer() */
    BITSET_WORD *tmp_live;
 
+   /* SSA indices killed and made live by each block */
+   struct util_dynarray indices;
+   struct live_block_transfer *transfer;
+
    nir_block_worklist worklist;
 };
 
@@ -95,6 +109,59 @@ set_ssa_def_dead(nir_ssa_def *def, void *void_live)
    return true;
 }
 
+static bool
+kill_ssa_def(nir_ssa_def *def, void *void_state)
+{
+   struct live_ssa_defs_state *state = void_state;
+
+   BITSET_CLEAR(state->tmp_live, def->index);
+   util_dynarray_append(&state->indices, uint32_t, def->index);
+
+   return true;
+}
+
+/* Walks the block once to find the SSA defs it kills and the uses it makes
+ * live coming in, so that live_in = (live_out & ~kill) | gen.  Blocks get
+ * revisited every time their live out grows and this way doing so doesn't
+ * require walking the instructions again.
+ */
+static void
+init_block_transfer(nir_block *block, struct live_ssa_defs_state *state)
+{
+   struct live_block_transfer *transfer = &state->transfer[block->index];
+   BITSET_WORD *live = state->tmp_live;
+   memset(live, 0, state->bitset_words * sizeof(BITSET_WORD));
+
+   transfer->kill_start =
+      util_dynarray_num_elements(&state->indices, uint32_t);
+
+   nir_if *following_if = nir_block_get_following_if(block);
+   if (following_if)
+      set_src_live(&following_if->condition, live);
+
+   nir_foreach_instr_reverse(instr, block) {
+      /* Phi nodes are handled seperately so we want to skip them.  Since
+       * we are going backwards and they are at the beginning, we can just
+       * break as soon as we see one.
+       */
+      if (instr->type == nir_instr_type_phi)
+         break;
+
+      nir_foreach_ssa_def(instr, kill_ssa_def, state);
+      nir_foreach_src(instr, set_src_live, live);
+   }
+
+   transfer->gen_start =
+      util_dynarray_num_elements(&state->indices, uint32_t);
+
+   unsigned i;
+   BITSET_FOREACH_SET(i, live, state->bitset_words * BITSET_WORDBITS)
+      util_dynarray_append(&state->indices, uint32_t, i);
+
+   transfer->gen_end =
+      util_dynarray_num_elements(&state->indices, uint32_t);
+}
+
 /** Propagates the live in of succ across the edge to the live out of pred
  *
  * Phi nodes exist "between" blocks and all the phi nodes at the start of a
@@ -152,17 +219,25 @@ nir_live_ssa_defs_impl(nir_function_impl *impl)
    /* Number the instructions so we can do cheap interference tests using the
     * instruction index.
     */
-   nir_metadata_require(impl, nir_metadata_instr_index);
+   nir_metadata_require(impl, nir_metadata_block_index |
+                              nir_metadata_instr_index);
 
    nir_block_worklist_init(&state.worklist, impl->num_blocks, NULL);
 
+   util_dynarray_init(&state.indices, NULL);
+   state.transfer = ralloc_array(NULL, struct live_block_transfer,
+                                 impl->num_blocks);
+
    /* Allocate live_in and live_out sets and add all of the blocks to the
     * worklist.
     */
    nir_foreach_block(block, impl) {
       init_liveness_block(block, &state);
+      init_block_transfer(block, &state);
    }
 
+   const uint32_t *indices = state.indices.data;
+
 
    /* We're now ready to work through the worklist and update the liveness
     * sets of each of the blocks.  By the time we get to this point, every
@@ -180,21 +255,12 @@ nir_live_ssa_defs_impl(nir_function_impl *impl)
       memcpy(block->live_in, block->live_out,
              state.bitset_words * sizeof(BITSET_WORD));
 
-      nir_if *following_if = nir_block_get_following_if(block);
-      if (following_if)
-         set_src_live(&following_if->condition, block->live_in);
-
-      nir_foreach_instr_reverse(instr, block) {
-         /* Phi nodes are handled seperately so we want to skip them.  Since
-          * we are going backwards and they are at the beginning, we can just
-          * break as soon as we see one.
-          */
-         if (instr->type == nir_instr_type_phi)
-            break;
-
-         nir_foreach_ssa_def(instr, set_ssa_def_dead, block->live_in);
-         nir_foreach_src(instr, set_src_live, block->live_in);
-      }
+      const struct live_block_transfer *transfer =
+         &state.transfer[block->index];
+      for (unsigned i = transfer->kill_start; i < transfer->gen_start; i++)
+         BITSET_CLEAR(block->live_in, indices[i]);
+      for (unsigned i = transfer->gen_start; i < transfer->gen_end; i++)
+         BITSET_SET(block->live_in, indices[i]);
 
       /* Walk over all of the predecessors of the current block updating
        * their live in with the live out of this one.  If anything has
@@ -209,6 +275,8 @@ nir_live_ssa_defs_impl(nir_function_impl *impl)
    }
 
    ralloc_free(state.tmp_live);
+   ralloc_free(state.transfer);
+   util_dynarray_fini(&state.indices);
    nir_block_worklist_fini(&state.worklist);
 }
 
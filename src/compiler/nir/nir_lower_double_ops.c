@@ -467,6 +467,23 @@ lower_doubles_instr_to_soft(nir_builder *b, nir_alu_instr *instr,
 
    assert(instr->dest.dest.is_ssa);
 
+   /* fabs and fneg only touch the sign bit.  They are very common, so emit
+    * the bit operation directly instead of inlining a clone of the library
+    * function, which then needs its return variable and derefs cleaned up.
+    */
+   if (instr->op == nir_op_fabs || instr->op == nir_op_fneg) {
+      nir_ssa_def *src = nir_mov_alu(b, instr->src[0], 1);
+      nir_ssa_def *lo = nir_unpack_64_2x32_split_x(b, src);
+      nir_ssa_def *hi = nir_unpack_64_2x32_split_y(b, src);
+
+      if (instr->op == nir_op_fabs)
+         hi = nir_iand_imm(b, hi, 0x7fffffff);
+      else
+         hi = nir_ixor(b, hi, nir_imm_int(b, INT32_MIN));
+
+      return nir_pack_64_2x32_split(b, lo, hi);
+   }
+
    const char *name;
    const char *mangled_name;
    const struct glsl_type *return_type = glsl_uint64_t_type();
@@ -534,14 +551,6 @@ lower_doubles_instr_to_soft(nir_builder *b, nir_alu_instr *instr,
          mangled_name = "__uint_to_fp64(u1;";
       }
       break;
-   case nir_op_fabs:
-      name = "__fabs64";
-      mangled_name = "__fabs64(u641;";
-      break;
-   case nir_op_fneg:
-      name = "__fneg64";
-      mangled_name = "__fneg64(u641;";
-      break;
    case nir_op_fround_even:
       name = "__fround64";
       mangled_name = "__fround64(u641;";
@@ -76,6 +76,39 @@ nir_shader_preserve_all_metadata(nir_shader *shader)
    }
 }
 
+void
+nir_loop_pass_state_init(nir_loop_pass_state *state)
+{
+   state->progress_count = 0;
+   state->idle_sites = _mesa_pointer_hash_table_create(NULL);
+}
+
+void
+nir_loop_pass_state_finish(nir_loop_pass_state *state)
+{
+   _mesa_hash_table_destroy(state->idle_sites, NULL);
+}
+
+bool
+nir_loop_pass_is_idle(const nir_loop_pass_state *state, const void *site)
+{
+   struct hash_entry *entry = _mesa_hash_table_search(state->idle_sites, site);
+   return entry != NULL &&
+          (uintptr_t)entry->data == (uintptr_t)state->progress_count + 1;
+}
+
+void
+nir_loop_pass_record(nir_loop_pass_state *state, const void *site,
+                     bool progress)
+{
+   if (progress) {
+      state->progress_count++;
+   } else {
+      _mesa_hash_table_insert(state->idle_sites, site,
+                              (void *)((uintptr_t)state->progress_count + 1));
+   }
+}
+
 #ifndef NDEBUG
 /**
  * Make sure passes properly invalidate metadata (part 1).
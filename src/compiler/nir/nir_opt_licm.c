@@ -0,0 +1,248 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "nir.h"
+#include "nir_builder.h"
+
+/*
+ * Loop-invariant code motion.
+ *
+ * Moves instructions whose sources are all defined outside of a loop into
+ * the block right before it.  Loops are handled innermost first, so values
+ * which are invariant in several nested loops bubble all the way out.
+ *
+ * ALU instructions can't trap, so they are hoisted from anywhere in the loop
+ * even if they only run conditionally.  Everything else is only hoisted from
+ * the first block of the loop: NIR loops always run their first block at
+ * least once and, on the first iteration, with exactly the invocations that
+ * reached the block before the loop.  That makes loads and texture
+ * instructions there safe to move, including the ones which need uniform
+ * control flow or a uniform binding.
+ *
+ * Every hoisted value is live across the whole loop, so the number of
+ * components hoisted per loop is capped by max_components to keep register
+ * pressure in check.  Constants and undefs inside the loop don't stop their
+ * users from moving, they're moved or copied along with them.
+ */
+
+struct licm_state {
+   nir_shader *shader;
+
+   unsigned max_components;
+   unsigned components;
+
+   /* The loop being processed: its block index range and the block right
+    * before it
+    */
+   unsigned first_index, last_index;
+   nir_block *preheader;
+};
+
+static bool
+is_const_or_undef(const nir_instr *instr)
+{
+   return instr->type == nir_instr_type_load_const ||
+          instr->type == nir_instr_type_ssa_undef;
+}
+
+static bool
+def_is_invariant(const nir_ssa_def *def, const struct licm_state *state)
+{
+   const unsigned index = def->parent_instr->block->index;
+   return index < state->first_index || index > state->last_index;
+}
+
+static bool
+src_is_invariant(nir_src *src, void *data)
+{
+   struct licm_state *state = data;
+
+   if (!src->is_ssa)
+      return false;
+
+   return def_is_invariant(src->ssa, state) ||
+          is_const_or_undef(src->ssa->parent_instr);
+}
+
+/* Brings constant and undef sources from inside the loop along */
+static bool
+hoist_const_src(nir_src *src, void *data)
+{
+   struct licm_state *state = data;
+   nir_instr *parent = src->ssa->parent_instr;
+
+   if (def_is_invariant(src->ssa, state))
+      return true;
+
+   assert(is_const_or_undef(parent));
+   nir_cursor cursor = nir_after_block_before_jump(state->preheader);
+
+   if (list_is_singular(&src->ssa->uses) && list_is_empty(&src->ssa->if_uses)) {
+      nir_instr_move(cursor, parent);
+      return true;
+   }
+
+   nir_instr *copy = nir_instr_clone(state->shader, parent);
+   nir_instr_insert(cursor, copy);
+   nir_instr_rewrite_src_ssa(src->parent_instr, src,
+                             nir_instr_ssa_def(copy));
+   return true;
+}
+
+static bool
+alu_can_move(const nir_alu_instr *alu, bool in_header)
+{
+   if (!alu->dest.dest.is_ssa)
+      return false;
+
+   switch (alu->op) {
+   case nir_op_fddx:
+   case nir_op_fddy:
+   case nir_op_fddx_fine:
+   case nir_op_fddy_fine:
+   case nir_op_fddx_coarse:
+   case nir_op_fddy_coarse:
+      /* These need to stay in control flow that is at least as uniform */
+      return in_header;
+   default:
+      return true;
+   }
+}
+
+static bool
+instr_can_move(nir_instr *instr, bool in_header)
+{
+   switch (instr->type) {
+   case nir_instr_type_alu:
+      return alu_can_move(nir_instr_as_alu(instr), in_header);
+
+   case nir_instr_type_intrinsic: {
+      nir_intrinsic_instr *intrin = nir_instr_as_intrinsic(instr);
+      return in_header &&
+             nir_intrinsic_infos[intrin->intrinsic].has_dest &&
+             intrin->dest.is_ssa &&
+             nir_intrinsic_can_reorder(intrin);
+   }
+
+   case nir_instr_type_tex:
+      return in_header && nir_instr_as_tex(instr)->dest.is_ssa;
+
+   default:
+      /* Constants and undefs only move along with their users, phis belong
+       * to the loop and derefs are expected to stay next to their users.
+       */
+      return false;
+   }
+}
+
+static unsigned
+instr_components(nir_instr *instr)
+{
+   switch (instr->type) {
+   case nir_instr_type_alu:
+      return nir_dest_num_components(nir_instr_as_alu(instr)->dest.dest);
+   case nir_instr_type_intrinsic:
+      return nir_dest_num_components(nir_instr_as_intrinsic(instr)->dest);
+   case nir_instr_type_tex:
+      return nir_dest_num_components(nir_instr_as_tex(instr)->dest);
+   default:
+      unreachable("Unhandled instruction type");
+   }
+}
+
+static bool
+licm_loop(nir_loop *loop, struct licm_state *state)
+{
+   nir_block *header = nir_loop_first_block(loop);
+
+   state->preheader = nir_cf_node_as_block(nir_cf_node_prev(&loop->cf_node));
+   state->first_index = header->index;
+   state->last_index = nir_loop_last_block(loop)->index;
+   state->components = 0;
+
+   bool progress = false;
+   nir_foreach_block_in_cf_node(block, &loop->cf_node) {
+      nir_foreach_instr_safe(instr, block) {
+         if (!instr_can_move(instr, block == header) ||
+             !nir_foreach_src(instr, src_is_invariant, state))
+            continue;
+
+         const unsigned components = instr_components(instr);
+         if (state->components + components > state->max_components)
+            return progress;
+
+         /* Sources are checked by block, so a hoisted value makes its users
+          * invariant as well.  The walk is in program order, so they come
+          * after it.
+          */
+         nir_foreach_src(instr, hoist_const_src, state);
+         nir_instr_move(nir_after_block_before_jump(state->preheader), instr);
+         state->components += components;
+         progress = true;
+      }
+   }
+
+   return progress;
+}
+
+static bool
+licm_cf_list(struct exec_list *cf_list, struct licm_state *state)
+{
+   bool progress = false;
+
+   foreach_list_typed(nir_cf_node, node, node, cf_list) {
+      switch (node->type) {
+      case nir_cf_node_block:
+         break;
+
+      case nir_cf_node_if: {
+         nir_if *nif = nir_cf_node_as_if(node);
+         progress |= licm_cf_list(&nif->then_list, state);
+         progress |= licm_cf_list(&nif->else_list, state);
+         break;
+      }
+
+      case nir_cf_node_loop: {
+         nir_loop *loop = nir_cf_node_as_loop(node);
+         progress |= licm_cf_list(&loop->body, state);
+         progress |= licm_loop(loop, state);
+         break;
+      }
+
+      default:
+         unreachable("Invalid CF node type");
+      }
+   }
+
+   return progress;
+}
+
+bool
+nir_opt_licm(nir_shader *shader, unsigned max_components)
+{
+   bool progress = false;
+
+   nir_foreach_function(function, shader) {
+      nir_function_impl *impl = function->impl;
+      if (!impl || !impl->structured)
+         continue;
+
+      nir_metadata_require(impl, nir_metadata_block_index);
+
+      struct licm_state state = {
+         .shader = shader,
+         .max_components = max_components,
+      };
+
+      if (licm_cf_list(&impl->body, &state)) {
+         nir_metadata_preserve(impl, nir_metadata_block_index |
+                                     nir_metadata_dominance);
+         progress = true;
+      } else {
+         nir_metadata_preserve(impl, nir_metadata_all);
+      }
+   }
+
+   return progress;
+}
@@ -183,6 +183,8 @@ struct entry_key {
 struct entry {
    struct list_head head;
    unsigned index;
+   /* Number of stores of the same mode before this entry in the block. */
+   unsigned num_stores_before;
 
    struct entry_key *key;
    union {
@@ -1023,6 +1025,12 @@ check_for_aliasing(struct vectorize_ctx *ctx, struct entry *first, struct entry
             return true;
       }
    } else {
+      /* Stores only ever move later when vectorized, so if the counts match
+       * there is no store between the two loads and nothing to walk.
+       */
+      if (first->num_stores_before == second->num_stores_before)
+         return false;
+
       /* find previous store that aliases this load */
       list_for_each_entry_from_rev(struct entry, prev, second, &ctx->entries[mode_index], head) {
          if (prev == second)
@@ -1450,6 +1458,7 @@ process_block(nir_function_impl *impl, struct vectorize_ctx *ctx, nir_block *blo
 
    /* create entries */
    unsigned next_index = 0;
+   unsigned num_stores[nir_num_variable_modes] = {0};
 
    nir_foreach_instr_safe(instr, block) {
       if (handle_barrier(ctx, &progress, impl, instr))
@@ -1474,6 +1483,9 @@ process_block(nir_function_impl *impl, struct vectorize_ctx *ctx, nir_block *blo
       /* create entry */
       struct entry *entry = create_entry(ctx, info, intrin);
       entry->index = next_index++;
+      entry->num_stores_before = num_stores[mode_index];
+      if (entry->is_store)
+         num_stores[mode_index]++;
 
       list_addtail(&entry->head, &ctx->entries[mode_index]);
 
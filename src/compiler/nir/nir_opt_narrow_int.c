@@ -0,0 +1,237 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "nir.h"
+#include "nir_builder.h"
+#include "nir_range_analysis.h"
+
+/*
+ * Narrows 32-bit integer ALU instructions whose operands are all known to be
+ * small (constants or up-converted 8/16-bit values) to 8 or 16 bits, when
+ * doing so provably gives the same result.  The narrowed result is converted
+ * back with u2u32, which nir_opt_algebraic folds into the next narrowed user,
+ * so once a chain is seeded by a narrow load or conversion it gets narrowed
+ * all the way through.
+ *
+ * Two kinds of instructions are handled:
+ *
+ *  - Wrapping arithmetic and bitwise ops, where the low N bits of the result
+ *    only depend on the low N bits of the operands.  These are narrowed when
+ *    nothing reads the upper bits of the result, or when range analysis says
+ *    the result fits in N bits anyway.
+ *
+ *  - Ops whose result depends on every bit of the operands (unsigned
+ *    compares, min/max, division, shifts right).  These are narrowed when
+ *    range analysis says every operand fits in N bits.
+ *
+ * Floats are left alone: range analysis can bound a value but says nothing
+ * about how many mantissa bits it needs.
+ */
+
+struct narrow_state {
+   struct hash_table *range_ht;
+};
+
+static bool
+op_wraps(nir_op op)
+{
+   switch (op) {
+   case nir_op_iadd:
+   case nir_op_isub:
+   case nir_op_imul:
+   case nir_op_iand:
+   case nir_op_ior:
+   case nir_op_ixor:
+   case nir_op_inot:
+   case nir_op_ineg:
+   case nir_op_ishl:
+      return true;
+   default:
+      return false;
+   }
+}
+
+static bool
+op_needs_small_srcs(nir_op op)
+{
+   switch (op) {
+   case nir_op_ult:
+   case nir_op_uge:
+   case nir_op_ieq:
+   case nir_op_ine:
+   case nir_op_umin:
+   case nir_op_umax:
+   case nir_op_udiv:
+   case nir_op_umod:
+   case nir_op_ushr:
+      return true;
+   default:
+      return false;
+   }
+}
+
+static uint32_t
+max_mask(unsigned bit_size)
+{
+   return (uint32_t)BITFIELD64_MASK(bit_size);
+}
+
+static bool
+is_shift(nir_op op)
+{
+   return op == nir_op_ishl || op == nir_op_ushr;
+}
+
+/* Sources which get converted to bit_size.  Shift counts are always 32-bit
+ * in NIR so they stay as they are.
+ */
+static unsigned
+num_narrowed_srcs(nir_op op)
+{
+   return is_shift(op) ? 1 : nir_op_infos[op].num_inputs;
+}
+
+/* Whether a source will be narrow once converted, so narrowing doesn't
+ * just trade one instruction for a conversion.
+ */
+static bool
+src_is_narrow(const nir_alu_instr *alu, unsigned src, unsigned bit_size)
+{
+   if (nir_src_is_const(alu->src[src].src))
+      return true;
+
+   nir_instr *parent = alu->src[src].src.ssa->parent_instr;
+   if (parent->type != nir_instr_type_alu)
+      return false;
+
+   nir_alu_instr *conv = nir_instr_as_alu(parent);
+   if (conv->op != nir_op_u2u32 && conv->op != nir_op_i2i32)
+      return false;
+
+   return nir_src_bit_size(conv->src[0].src) <= bit_size;
+}
+
+static bool
+src_fits(nir_shader *shader, struct narrow_state *state,
+         const nir_alu_instr *alu, unsigned src, uint32_t max)
+{
+   for (unsigned c = 0; c < nir_dest_num_components(alu->dest.dest); c++) {
+      nir_ssa_scalar s =
+         nir_get_ssa_scalar(alu->src[src].src.ssa, alu->src[src].swizzle[c]);
+      if (nir_unsigned_upper_bound(shader, state->range_ht, s, NULL) > max)
+         return false;
+   }
+
+   return true;
+}
+
+static bool
+result_fits(nir_shader *shader, struct narrow_state *state,
+            nir_alu_instr *alu, unsigned bit_size)
+{
+   const uint64_t upper_bits = ~(uint64_t)max_mask(bit_size);
+   if (!(nir_ssa_def_bits_used(&alu->dest.dest.ssa) & upper_bits))
+      return true;
+
+   for (unsigned c = 0; c < nir_dest_num_components(alu->dest.dest); c++) {
+      nir_ssa_scalar s = nir_get_ssa_scalar(&alu->dest.dest.ssa, c);
+      if (nir_unsigned_upper_bound(shader, state->range_ht, s, NULL) >
+          max_mask(bit_size))
+         return false;
+   }
+
+   return true;
+}
+
+static bool
+can_narrow(nir_shader *shader, struct narrow_state *state, nir_alu_instr *alu,
+           unsigned bit_size)
+{
+   const unsigned num_srcs = num_narrowed_srcs(alu->op);
+
+   for (unsigned i = 0; i < num_srcs; i++) {
+      if (!src_is_narrow(alu, i, bit_size))
+         return false;
+   }
+
+   /* Shifts only look at the bottom log2(bit_size) bits of the count, so it
+    * has to be in range for the narrow size too.
+    */
+   if (is_shift(alu->op) && !src_fits(shader, state, alu, 1, bit_size - 1))
+      return false;
+
+   if (op_wraps(alu->op))
+      return result_fits(shader, state, alu, bit_size);
+
+   for (unsigned i = 0; i < num_srcs; i++) {
+      if (!src_fits(shader, state, alu, i, max_mask(bit_size)))
+         return false;
+   }
+
+   return true;
+}
+
+static bool
+narrow_instr(nir_builder *b, nir_instr *instr, void *data)
+{
+   struct narrow_state *state = data;
+
+   if (instr->type != nir_instr_type_alu)
+      return false;
+
+   nir_alu_instr *alu = nir_instr_as_alu(instr);
+   if (!op_wraps(alu->op) && !op_needs_small_srcs(alu->op))
+      return false;
+
+   if (!alu->dest.dest.is_ssa || nir_src_bit_size(alu->src[0].src) != 32)
+      return false;
+
+   const nir_shader_compiler_options *options = b->shader->options;
+   unsigned bit_size;
+   if (options->support_8bit_alu && can_narrow(b->shader, state, alu, 8))
+      bit_size = 8;
+   else if (options->support_16bit_alu && can_narrow(b->shader, state, alu, 16))
+      bit_size = 16;
+   else
+      return false;
+
+   b->cursor = nir_before_instr(instr);
+
+   nir_ssa_def *srcs[2] = { NULL, NULL };
+   for (unsigned i = 0; i < nir_op_infos[alu->op].num_inputs; i++) {
+      srcs[i] = nir_ssa_for_alu_src(b, alu, i);
+      if (i < num_narrowed_srcs(alu->op))
+         srcs[i] = nir_u2uN(b, srcs[i], bit_size);
+   }
+
+   nir_ssa_def *res = nir_build_alu(b, alu->op, srcs[0], srcs[1], NULL, NULL);
+   if (alu->dest.dest.ssa.bit_size != 1)
+      res = nir_u2u32(b, res);
+
+   nir_ssa_def_rewrite_uses(&alu->dest.dest.ssa, res);
+   nir_instr_remove(instr);
+
+   return true;
+}
+
+bool
+nir_opt_narrow_int(nir_shader *shader)
+{
+   if (!shader->options->support_8bit_alu &&
+       !shader->options->support_16bit_alu)
+      return false;
+
+   struct narrow_state state = {
+      .range_ht = _mesa_pointer_hash_table_create(NULL),
+   };
+
+   bool progress = nir_shader_instructions_pass(shader, narrow_instr,
+                                                nir_metadata_block_index |
+                                                nir_metadata_dominance,
+                                                &state);
+
+   _mesa_hash_table_destroy(state.range_ht, NULL);
+
+   return progress;
+}
@@ -0,0 +1,127 @@
+/* SPDX-License-Identifier: MIT */
+
+/*
+ * Per-pass statistics for NIR_PASS() and NIR_PASS_V().
+ *
+ * When NIR_PASS_STATS is set, every pass run through those macros records how
+ * often it ran, how often it made progress and how long it took, summed by
+ * pass name over all shaders and threads.  The totals are written as CSV when
+ * the process exits, so compile-time changes can be compared between builds
+ * by replaying the same shaders.
+ */
+
+#include "nir.h"
+#include "c11/threads.h"
+#include "util/hash_table.h"
+#include "util/os_time.h"
+#include "util/simple_mtx.h"
+
+struct pass_stats {
+   const char *name;
+   uint64_t calls;
+   uint64_t progress;
+   int64_t time_ns;
+};
+
+static const char *stats_path;
+static struct hash_table *stats;
+static simple_mtx_t stats_mtx = SIMPLE_MTX_INITIALIZER;
+
+static int
+pass_stats_compare(const void *a, const void *b)
+{
+   const struct pass_stats *sa = *(const struct pass_stats **)a;
+   const struct pass_stats *sb = *(const struct pass_stats **)b;
+
+   /* Most expensive first. */
+   if (sa->time_ns != sb->time_ns)
+      return sa->time_ns < sb->time_ns ? 1 : -1;
+   return strcmp(sa->name, sb->name);
+}
+
+static void
+pass_stats_dump(void)
+{
+   simple_mtx_lock(&stats_mtx);
+
+   FILE *fp = strcmp(stats_path, "stderr") ? fopen(stats_path, "w") : stderr;
+   if (!fp) {
+      fprintf(stderr, "NIR: failed to open %s for pass statistics\n",
+              stats_path);
+      goto out;
+   }
+
+   unsigned count = _mesa_hash_table_num_entries(stats);
+   struct pass_stats **sorted = malloc(count * sizeof(*sorted));
+   if (sorted) {
+      unsigned i = 0;
+      hash_table_foreach(stats, entry)
+         sorted[i++] = entry->data;
+      qsort(sorted, count, sizeof(*sorted), pass_stats_compare);
+
+      fprintf(fp, "pass,calls,progress,time_ns\n");
+      for (i = 0; i < count; i++) {
+         fprintf(fp, "%s,%" PRIu64 ",%" PRIu64 ",%" PRId64 "\n",
+                 sorted[i]->name, sorted[i]->calls, sorted[i]->progress,
+                 sorted[i]->time_ns);
+      }
+      free(sorted);
+   }
+
+   if (fp != stderr)
+      fclose(fp);
+
+out:
+   simple_mtx_unlock(&stats_mtx);
+}
+
+static void
+pass_stats_init_once(void)
+{
+   stats_path = getenv("NIR_PASS_STATS");
+   if (!stats_path || !stats_path[0]) {
+      stats_path = NULL;
+      return;
+   }
+
+   stats = _mesa_hash_table_create(NULL, _mesa_hash_string,
+                                   _mesa_key_string_equal);
+   atexit(pass_stats_dump);
+}
+
+int64_t
+nir_pass_stats_start(void)
+{
+   static once_flag flag = ONCE_FLAG_INIT;
+   call_once(&flag, pass_stats_init_once);
+
+   if (likely(!stats_path))
+      return 0;
+
+   /* Never return 0 for an enabled start, that means disabled. */
+   return MAX2(os_time_get_nano(), 1);
+}
+
+void
+nir_pass_stats_end(const char *pass, int64_t start, bool progress)
+{
+   int64_t time_ns = os_time_get_nano() - start;
+
+   simple_mtx_lock(&stats_mtx);
+
+   struct hash_entry *entry = _mesa_hash_table_search(stats, pass);
+   struct pass_stats *s;
+   if (entry) {
+      s = entry->data;
+   } else {
+      s = rzalloc(stats, struct pass_stats);
+      s->name = pass;
+      _mesa_hash_table_insert(stats, s->name, s);
+   }
+
+   s->calls++;
+   s->progress += progress;
+   s->time_ns += time_ns;
+
+   simple_mtx_unlock(&stats_mtx);
+}
@@ -105,8 +105,8 @@ typedef struct {
     */
    uint32_t time;
 
-   /* Number of channels currently used by the NIR instructions that have been
-    * scheduled.
+   /* Number of channels (or value_size_cb units) currently used by the NIR
+    * instructions that have been scheduled.
     */
    int pressure;
 
@@ -171,27 +171,48 @@ nir_schedule_scoreboard_get_src(nir_schedule_scoreboard *scoreboard, nir_src *sr
 }
 
 static int
-nir_schedule_def_pressure(nir_ssa_def *def)
+nir_schedule_value_pressure(nir_schedule_scoreboard *scoreboard,
+                            unsigned num_components, unsigned bit_size)
 {
-   return def->num_components;
+   const nir_schedule_options *options = scoreboard->options;
+
+   if (options->value_size_cb) {
+      return options->value_size_cb(num_components, bit_size,
+                                    options->value_size_cb_data);
+   }
+
+   return num_components;
+}
+
+static int
+nir_schedule_def_pressure(nir_schedule_scoreboard *scoreboard,
+                          nir_ssa_def *def)
+{
+   return nir_schedule_value_pressure(scoreboard, def->num_components,
+                                      def->bit_size);
 }
 
 static int
-nir_schedule_src_pressure(nir_src *src)
+nir_schedule_src_pressure(nir_schedule_scoreboard *scoreboard, nir_src *src)
 {
    if (src->is_ssa)
-      return nir_schedule_def_pressure(src->ssa);
+      return nir_schedule_def_pressure(scoreboard, src->ssa);
    else
-      return src->reg.reg->num_components;
+      return nir_schedule_value_pressure(scoreboard,
+                                         src->reg.reg->num_components,
+                                         src->reg.reg->bit_size);
 }
 
 static int
-nir_schedule_dest_pressure(nir_dest *dest)
+nir_schedule_dest_pressure(nir_schedule_scoreboard *scoreboard,
+                           nir_dest *dest)
 {
    if (dest->is_ssa)
-      return nir_schedule_def_pressure(&dest->ssa);
+      return nir_schedule_def_pressure(scoreboard, &dest->ssa);
    else
-      return dest->reg.reg->num_components;
+      return nir_schedule_value_pressure(scoreboard,
+                                         dest->reg.reg->num_components,
+                                         dest->reg.reg->bit_size);
 }
 
 /**
@@ -556,7 +577,7 @@ nir_schedule_regs_freed_src_cb(nir_src *src, void *in_state)
 
    if (remaining_uses->entries == 1 &&
        _mesa_set_search(remaining_uses, src->parent_instr)) {
-      state->regs_freed += nir_schedule_src_pressure(src);
+      state->regs_freed += nir_schedule_src_pressure(scoreboard, src);
    }
 
    return true;
@@ -567,7 +588,7 @@ nir_schedule_regs_freed_def_cb(nir_ssa_def *def, void *in_state)
 {
    nir_schedule_regs_freed_state *state = in_state;
 
-   state->regs_freed -= nir_schedule_def_pressure(def);
+   state->regs_freed -= nir_schedule_def_pressure(state->scoreboard, def);
 
    return true;
 }
@@ -585,7 +606,7 @@ nir_schedule_regs_freed_dest_cb(nir_dest *dest, void *in_state)
 
    /* Only the first def of a reg counts against register pressure. */
    if (!_mesa_set_search(scoreboard->live_values, reg))
-      state->regs_freed -= nir_schedule_dest_pressure(dest);
+      state->regs_freed -= nir_schedule_dest_pressure(scoreboard, dest);
 
    return true;
 }
@@ -903,7 +924,7 @@ nir_schedule_mark_src_scheduled(nir_src *src, void *state)
    nir_schedule_mark_use(scoreboard,
                          src->is_ssa ? (void *)src->ssa : (void *)src->reg.reg,
                          src->parent_instr,
-                         nir_schedule_src_pressure(src));
+                         nir_schedule_src_pressure(scoreboard, src));
 
    return true;
 }
@@ -914,7 +935,7 @@ nir_schedule_mark_def_scheduled(nir_ssa_def *def, void *state)
    nir_schedule_scoreboard *scoreboard = state;
 
    nir_schedule_mark_use(scoreboard, def, def->parent_instr,
-                         nir_schedule_def_pressure(def));
+                         nir_schedule_def_pressure(scoreboard, def));
 
    return true;
 }
@@ -936,7 +957,7 @@ nir_schedule_mark_dest_scheduled(nir_dest *dest, void *state)
     */
    nir_schedule_mark_use(scoreboard, dest->reg.reg,
                          dest->reg.parent_instr,
-                         nir_schedule_dest_pressure(dest));
+                         nir_schedule_dest_pressure(scoreboard, dest));
 
    return true;
 }
@@ -1191,7 +1212,8 @@ nir_schedule_validate_uses(nir_schedule_scoreboard *scoreboard)
  * registers available (counting any that may be occupied by system value
  * payload values, for example), since the heuristic may not always be able to
  * free a register immediately.  The amount below the limit is up to you to
- * tune.
+ * tune.  Backends whose registers don't map to one channel each can provide
+ * value_size_cb to count in their own units instead.
  */
 void
 nir_schedule(nir_shader *shader,
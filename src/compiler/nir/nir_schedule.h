@@ -81,6 +81,17 @@ typedef struct nir_schedule_options {
    /* Data to pass to the instruction delay callback */
    void *instr_delay_cb_data;
 
+   /* Callback used to specify how much of the register file a value with the
+    * given size takes up, in the same units as threshold.  This lets
+    * backends account for 64-bit values taking two registers or 16-bit
+    * values being packed.  If NULL, every channel counts as one.
+    */
+   unsigned (* value_size_cb)(unsigned num_components, unsigned bit_size,
+                              void *user_data);
+
+   /* Data to pass to the value size callback */
+   void *value_size_cb_data;
+
 } nir_schedule_options;
 
 void nir_schedule(nir_shader *shader, const nir_schedule_options *options);
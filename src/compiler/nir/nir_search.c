@@ -315,14 +315,15 @@ match_value(const nir_algebraic_table *table,
              instr->src[src].src.ssa->parent_instr->type != nir_instr_type_load_const)
             return false;
 
-         if (var->cond_index != -1 && !table->variable_cond[var->cond_index](state->range_ht, instr,
-                                                                             src, num_components, new_swizzle))
-            return false;
-
          if (var->type != nir_type_invalid &&
              !src_is_type(instr->src[src].src, var->type))
             return false;
 
+         /* Variable conditions may run range analysis; check them last. */
+         if (var->cond_index != -1 && !table->variable_cond[var->cond_index](state->range_ht, instr,
+                                                                             src, num_components, new_swizzle))
+            return false;
+
          state->variables_seen |= (1 << var->variable);
          state->variables[var->variable].src = instr->src[src].src;
          state->variables[var->variable].abs = false;
@@ -395,9 +396,6 @@ match_expression(const nir_algebraic_table *table, const nir_search_expression *
                  unsigned num_components, const uint8_t *swizzle,
                  struct match_state *state)
 {
-   if (expr->cond_index != -1 && !table->expression_cond[expr->cond_index](instr))
-      return false;
-
    if (!nir_op_matches_search_op(instr->op, expr->opcode))
       return false;
 
@@ -407,6 +405,12 @@ match_expression(const nir_algebraic_table *table, const nir_search_expression *
        instr->dest.dest.ssa.bit_size != expr->value.bit_size)
       return false;
 
+   /* Conditions such as is_used_once walk the uses of the instruction, so
+    * only evaluate them once the cheap opcode and bit size checks pass.
+    */
+   if (expr->cond_index != -1 && !table->expression_cond[expr->cond_index](instr))
+      return false;
+
    state->inexact_match = expr->inexact || state->inexact_match;
    state->has_exact_alu = (instr->exact && !expr->ignore_exact) || state->has_exact_alu;
    if (state->inexact_match && state->has_exact_alu)
@@ -711,6 +715,18 @@ nir_replace_instr(nir_builder *build, nir_alu_instr *instr,
 
    STATIC_ASSERT(sizeof(state.comm_op_direction) * 8 >= NIR_SEARCH_MAX_COMM_OPS);
 
+   /* The bit size and condition of the root expression don't depend on the
+    * order of commutative sources.  If they fail, there's no point in trying
+    * every combination below.
+    */
+   if (search->value.bit_size > 0 &&
+       instr->dest.dest.ssa.bit_size != search->value.bit_size)
+      return NULL;
+
+   if (search->comm_exprs > 0 && search->cond_index != -1 &&
+       !table->expression_cond[search->cond_index](instr))
+      return NULL;
+
    unsigned comm_expr_combinations =
       1 << MIN2(search->comm_exprs, NIR_SEARCH_MAX_COMM_OPS);
 
@@ -71,6 +71,9 @@ typedef struct {
 
    struct blob_reader *blob;
 
+   /* The impl whose body is being read */
+   nir_function_impl *impl;
+
    /* the next index to assign to a NIR in-memory object */
    uint32_t next_idx;
 
@@ -774,6 +777,13 @@ read_dest(read_ctx *ctx, nir_dest *dst, nir_instr *instr,
          num_components = decode_num_components_in_3bits(dest.ssa.num_components);
       nir_ssa_dest_init(instr, dst, num_components, bit_size, NULL);
       dst->ssa.divergent = dest.ssa.divergent;
+
+      /* Instructions are created before they're inserted, so the def gets no
+       * index yet.  Hand it out here, in the same order inserting would, so
+       * that inserting doesn't have to walk up the CF tree to find the impl.
+       * load_const and ssa_undef do the same.
+       */
+      dst->ssa.index = ctx->impl->ssa_alloc++;
       read_add_object(ctx, &dst->ssa);
    } else {
       dst->reg.reg = read_object(ctx);
@@ -1394,6 +1404,7 @@ read_load_const(read_ctx *ctx, union packed_instr header)
       nir_load_const_instr_create(ctx->nir, header.load_const.last_component + 1,
                                   decode_bit_size_3bits(header.load_const.bit_size));
    lc->def.divergent = false;
+   lc->def.index = ctx->impl->ssa_alloc++;
 
    switch (header.load_const.packing) {
    case load_const_scalar_hi_19bits:
@@ -1484,6 +1495,7 @@ read_ssa_undef(read_ctx *ctx, union packed_instr header)
                                  decode_bit_size_3bits(header.undef.bit_size));
 
    undef->def.divergent = false;
+   undef->def.index = ctx->impl->ssa_alloc++;
 
    read_add_object(ctx, &undef->def);
    return undef;
@@ -1997,8 +2009,10 @@ read_function_impl(read_ctx *ctx, nir_function *fxn)
    read_reg_list(ctx, &fi->registers);
    fi->reg_alloc = blob_read_uint32(ctx->blob);
 
+   ctx->impl = fi;
    read_cf_list(ctx, &fi->body);
    read_fixup_phis(ctx);
+   ctx->impl = NULL;
 
    fi->valid_metadata = 0;
 
@@ -0,0 +1,113 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+#include "nir.h"
+#include "nir_builder.h"
+
+class nir_opt_licm_test : public ::testing::Test {
+protected:
+   nir_opt_licm_test()
+   {
+      glsl_type_singleton_init_or_ref();
+
+      static const nir_shader_compiler_options options = { };
+      bld = nir_builder_init_simple_shader(MESA_SHADER_COMPUTE, &options,
+                                           "opt_licm test");
+   }
+
+   ~nir_opt_licm_test()
+   {
+      ralloc_free(bld.shader);
+      glsl_type_singleton_decref();
+   }
+
+   nir_ssa_def *load_ssbo(nir_ssa_def *offset)
+   {
+      return nir_load_ssbo(&bld, 1, 32, nir_imm_int(&bld, 0), offset);
+   }
+
+   void store_ssbo(nir_ssa_def *value)
+   {
+      nir_store_ssbo(&bld, value, nir_imm_int(&bld, 0), nir_imm_int(&bld, 0));
+   }
+
+   struct nir_builder bld;
+};
+
+TEST_F(nir_opt_licm_test, hoist_invariant_alu)
+{
+   nir_ssa_def *a = load_ssbo(nir_imm_int(&bld, 0));
+   nir_ssa_def *b = load_ssbo(nir_imm_int(&bld, 4));
+   nir_block *preheader = nir_cursor_current_block(bld.cursor);
+
+   nir_loop *loop = nir_push_loop(&bld);
+   nir_ssa_def *sum = nir_iadd(&bld, a, b);
+   nir_ssa_def *prod = nir_imul(&bld, sum, a);
+   store_ssbo(prod);
+   nir_jump(&bld, nir_jump_break);
+   nir_pop_loop(&bld, loop);
+
+   ASSERT_TRUE(nir_opt_licm(bld.shader, UINT_MAX));
+   nir_validate_shader(bld.shader, NULL);
+
+   EXPECT_EQ(sum->parent_instr->block, preheader);
+   EXPECT_EQ(prod->parent_instr->block, preheader);
+}
+
+TEST_F(nir_opt_licm_test, keep_variant_alu)
+{
+   nir_ssa_def *a = load_ssbo(nir_imm_int(&bld, 0));
+
+   nir_loop *loop = nir_push_loop(&bld);
+   nir_ssa_def *b = load_ssbo(nir_imm_int(&bld, 4));
+   nir_ssa_def *sum = nir_iadd(&bld, a, b);
+   store_ssbo(sum);
+   nir_jump(&bld, nir_jump_break);
+   nir_pop_loop(&bld, loop);
+
+   EXPECT_FALSE(nir_opt_licm(bld.shader, UINT_MAX));
+   EXPECT_EQ(sum->parent_instr->block, nir_loop_first_block(loop));
+}
+
+TEST_F(nir_opt_licm_test, keep_conditional_load)
+{
+   nir_ssa_def *a = load_ssbo(nir_imm_int(&bld, 0));
+
+   nir_loop *loop = nir_push_loop(&bld);
+   nir_push_if(&bld, nir_ieq_imm(&bld, a, 0));
+   nir_ssa_def *b = nir_load_push_constant(&bld, 1, 32, nir_imm_int(&bld, 0));
+   nir_ssa_def *sum = nir_iadd(&bld, a, b);
+   store_ssbo(sum);
+   nir_pop_if(&bld, NULL);
+   nir_jump(&bld, nir_jump_break);
+   nir_pop_loop(&bld, loop);
+
+   nir_block *load_block = b->parent_instr->block;
+
+   /* The compare is hoisted, the load only runs conditionally */
+   ASSERT_TRUE(nir_opt_licm(bld.shader, UINT_MAX));
+   nir_validate_shader(bld.shader, NULL);
+
+   EXPECT_EQ(b->parent_instr->block, load_block);
+   EXPECT_EQ(sum->parent_instr->block, load_block);
+}
+
+TEST_F(nir_opt_licm_test, component_limit)
+{
+   nir_ssa_def *a = load_ssbo(nir_imm_int(&bld, 0));
+   nir_block *preheader = nir_cursor_current_block(bld.cursor);
+
+   nir_loop *loop = nir_push_loop(&bld);
+   nir_ssa_def *first = nir_iadd_imm(&bld, a, 1);
+   nir_ssa_def *second = nir_iadd_imm(&bld, a, 2);
+   store_ssbo(nir_iadd(&bld, first, second));
+   nir_jump(&bld, nir_jump_break);
+   nir_pop_loop(&bld, loop);
+
+   ASSERT_TRUE(nir_opt_licm(bld.shader, 1));
+   nir_validate_shader(bld.shader, NULL);
+
+   EXPECT_EQ(first->parent_instr->block, preheader);
+   EXPECT_EQ(second->parent_instr->block, nir_loop_first_block(loop));
+}
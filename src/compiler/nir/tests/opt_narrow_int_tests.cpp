@@ -0,0 +1,101 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+#include <gtest/gtest.h>
+#include "nir.h"
+#include "nir_builder.h"
+
+class nir_opt_narrow_int_test : public ::testing::Test {
+protected:
+   nir_opt_narrow_int_test()
+   {
+      glsl_type_singleton_init_or_ref();
+
+      static nir_shader_compiler_options options = { };
+      options.support_16bit_alu = true;
+      bld = nir_builder_init_simple_shader(MESA_SHADER_COMPUTE, &options,
+                                           "opt_narrow_int test");
+   }
+
+   ~nir_opt_narrow_int_test()
+   {
+      ralloc_free(bld.shader);
+      glsl_type_singleton_decref();
+   }
+
+   nir_ssa_def *narrow_value()
+   {
+      return nir_u2u32(&bld, nir_ssa_undef(&bld, 1, 16));
+   }
+
+   struct nir_builder bld;
+};
+
+static nir_alu_instr *
+src_alu(nir_ssa_def *def, unsigned src)
+{
+   nir_alu_instr *alu = nir_instr_as_alu(def->parent_instr);
+   return nir_instr_as_alu(alu->src[src].src.ssa->parent_instr);
+}
+
+TEST_F(nir_opt_narrow_int_test, iadd_with_low_bits_used)
+{
+   nir_ssa_def *sum = nir_iadd(&bld, narrow_value(), narrow_value());
+   nir_ssa_def *res = nir_u2u16(&bld, sum);
+
+   ASSERT_TRUE(nir_opt_narrow_int(bld.shader));
+   nir_validate_shader(bld.shader, NULL);
+
+   nir_alu_instr *conv = src_alu(res, 0);
+   ASSERT_EQ(conv->op, nir_op_u2u32);
+
+   nir_alu_instr *add = nir_instr_as_alu(conv->src[0].src.ssa->parent_instr);
+   EXPECT_EQ(add->op, nir_op_iadd);
+   EXPECT_EQ(add->dest.dest.ssa.bit_size, 16);
+}
+
+TEST_F(nir_opt_narrow_int_test, iadd_with_all_bits_used)
+{
+   nir_ssa_def *sum = nir_iadd(&bld, narrow_value(), narrow_value());
+   nir_ine(&bld, sum, nir_imm_int(&bld, 0));
+
+   EXPECT_FALSE(nir_opt_narrow_int(bld.shader));
+   EXPECT_EQ(sum->bit_size, 32);
+}
+
+TEST_F(nir_opt_narrow_int_test, umin_with_small_srcs)
+{
+   nir_ssa_def *min = nir_umin(&bld, narrow_value(), nir_imm_int(&bld, 100));
+   nir_ssa_def *res = nir_ine(&bld, min, nir_imm_int(&bld, 0));
+
+   ASSERT_TRUE(nir_opt_narrow_int(bld.shader));
+   nir_validate_shader(bld.shader, NULL);
+
+   nir_alu_instr *conv = src_alu(res, 0);
+   ASSERT_EQ(conv->op, nir_op_u2u32);
+
+   nir_alu_instr *narrow = nir_instr_as_alu(conv->src[0].src.ssa->parent_instr);
+   EXPECT_EQ(narrow->op, nir_op_umin);
+   EXPECT_EQ(narrow->dest.dest.ssa.bit_size, 16);
+}
+
+TEST_F(nir_opt_narrow_int_test, ushr_count_too_large)
+{
+   nir_ssa_def *shr = nir_ushr(&bld, narrow_value(), nir_imm_int(&bld, 20));
+   nir_ine(&bld, shr, nir_imm_int(&bld, 0));
+
+   EXPECT_FALSE(nir_opt_narrow_int(bld.shader));
+   EXPECT_EQ(shr->bit_size, 32);
+}
+
+TEST_F(nir_opt_narrow_int_test, no_16bit_alu)
+{
+   static const nir_shader_compiler_options options = { };
+   bld.shader->options = &options;
+
+   nir_ssa_def *min = nir_umin(&bld, narrow_value(), nir_imm_int(&bld, 100));
+   nir_ine(&bld, min, nir_imm_int(&bld, 0));
+
+   EXPECT_FALSE(nir_opt_narrow_int(bld.shader));
+   EXPECT_EQ(min->bit_size, 32);
+}
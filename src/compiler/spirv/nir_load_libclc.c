@@ -355,9 +355,22 @@ nir_load_libclc_shader(unsigned ptr_bit_size,
 
    NIR_PASS_V(nir, libclc_add_generic_variants);
 
-   /* TODO: One day, we may want to run some optimizations on the libclc
-    * shader once and cache them to save time in each shader call.
+   /* Every kernel that calls into libclc gets a copy of these functions
+    * inlined and is then optimized as a whole.  Clean the library functions
+    * up once here, before they go into the cache, so each kernel starts from
+    * smaller bodies.  Stick to passes which only look at a single impl; the
+    * variables and calling convention have to stay the way nir_lower_libclc
+    * needs.
     */
+   bool progress;
+   do {
+      progress = false;
+      NIR_PASS(progress, nir, nir_copy_prop);
+      NIR_PASS(progress, nir, nir_opt_dce);
+      NIR_PASS(progress, nir, nir_opt_cse);
+      NIR_PASS(progress, nir, nir_opt_constant_folding);
+      NIR_PASS(progress, nir, nir_opt_algebraic);
+   } while (progress);
 
 #ifdef ENABLE_SHADER_CACHE
    if (disk_cache) {
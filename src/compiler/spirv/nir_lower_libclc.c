@@ -31,23 +31,47 @@
 #include "nir_builder.h"
 #include "nir_spirv.h"
 
+struct lower_libclc_state {
+   const nir_shader *clc_shader;
+
+   /* Function name -> nir_function in clc_shader, built on first use */
+   struct hash_table *functions;
+
+   struct hash_table *copy_vars;
+   void *mem_ctx;
+};
+
+static nir_function *
+find_clc_function(struct lower_libclc_state *state, const char *name)
+{
+   /* Libclc has thousands of functions and kernels call into it all over the
+    * place, so don't scan the whole function list for every call.
+    */
+   if (state->functions == NULL) {
+      state->functions = _mesa_hash_table_create(state->mem_ctx,
+                                                 _mesa_hash_string,
+                                                 _mesa_key_string_equal);
+      nir_foreach_function(function, state->clc_shader) {
+         if (function->name &&
+             !_mesa_hash_table_search(state->functions, function->name))
+            _mesa_hash_table_insert(state->functions, function->name, function);
+      }
+   }
+
+   struct hash_entry *entry = _mesa_hash_table_search(state->functions, name);
+   return entry ? entry->data : NULL;
+}
+
 static bool
 lower_clc_call_instr(nir_instr *instr, nir_builder *b,
-                     const nir_shader *clc_shader,
-                     struct hash_table *copy_vars)
+                     struct lower_libclc_state *state)
 {
    nir_call_instr *call = nir_instr_as_call(instr);
-   nir_function *func = NULL;
 
    if (!call->callee->name)
       return false;
 
-   nir_foreach_function(function, clc_shader) {
-      if (strcmp(function->name, call->callee->name) == 0) {
-         func = function;
-         break;
-      }
-   }
+   nir_function *func = find_clc_function(state, call->callee->name);
    if (!func || !func->impl) {
       return false;
    }
@@ -60,7 +84,7 @@ lower_clc_call_instr(nir_instr *instr, nir_builder *b,
    }
 
    b->cursor = nir_instr_remove(&call->instr);
-   nir_inline_function_impl(b, func->impl, params, copy_vars);
+   nir_inline_function_impl(b, func->impl, params, state->copy_vars);
 
    ralloc_free(params);
 
@@ -69,8 +93,7 @@ lower_clc_call_instr(nir_instr *instr, nir_builder *b,
 
 static bool
 nir_lower_libclc_impl(nir_function_impl *impl,
-                      const nir_shader *clc_shader,
-                      struct hash_table *copy_vars)
+                      struct lower_libclc_state *state)
 {
    nir_builder b;
    nir_builder_init(&b, impl);
@@ -79,7 +102,7 @@ nir_lower_libclc_impl(nir_function_impl *impl,
    nir_foreach_block_safe(block, impl) {
       nir_foreach_instr_safe(instr, block) {
          if (instr->type == nir_instr_type_call)
-            progress |= lower_clc_call_instr(instr, &b, clc_shader, copy_vars);
+            progress |= lower_clc_call_instr(instr, &b, state);
       }
    }
 
@@ -99,7 +122,11 @@ nir_lower_libclc(nir_shader *shader,
                  const nir_shader *clc_shader)
 {
    void *ra_ctx = ralloc_context(NULL);
-   struct hash_table *copy_vars = _mesa_pointer_hash_table_create(ra_ctx);
+   struct lower_libclc_state state = {
+      .clc_shader = clc_shader,
+      .copy_vars = _mesa_pointer_hash_table_create(ra_ctx),
+      .mem_ctx = ra_ctx,
+   };
    bool progress = false, overall_progress = false;
 
    /* do progress passes inside the pass */
@@ -107,7 +134,7 @@ nir_lower_libclc(nir_shader *shader,
       progress = false;
       nir_foreach_function(function, shader) {
          if (function->impl)
-            progress |= nir_lower_libclc_impl(function->impl, clc_shader, copy_vars);
+            progress |= nir_lower_libclc_impl(function->impl, &state);
       }
       overall_progress |= progress;
    } while (progress);
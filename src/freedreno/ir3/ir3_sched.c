@@ -118,6 +118,11 @@ struct ir3_sched_ctx {
     */
    int sy_index, first_outstanding_sy_index;
    int ss_index, first_outstanding_ss_index;
+
+   /* Bumped whenever scheduling state that live_effect() depends on
+    * changes, to invalidate the per-node cached values.
+    */
+   unsigned live_effect_epoch;
 };
 
 struct ir3_sched_node {
@@ -167,6 +172,12 @@ struct ir3_sched_node {
     * register pressure (or at least are neutral)
     */
    bool output;
+
+   /* live_effect() of the instruction, valid while live_effect_epoch
+    * matches the one in the context.
+    */
+   int live_effect;
+   unsigned live_effect_epoch;
 };
 
 #define foreach_sched_node(__n, __list)                                        \
@@ -283,6 +294,7 @@ schedule(struct ir3_sched_ctx *ctx, struct ir3_instruction *instr)
    }
 
    instr->flags |= IR3_INSTR_MARK;
+   ctx->live_effect_epoch++;
 
    di(instr, "schedule");
 
@@ -605,6 +617,20 @@ live_effect(struct ir3_instruction *instr)
    return new_live - freed_live;
 }
 
+/* live_effect() only changes when something gets scheduled, but each
+ * choice evaluates it for every ready instruction, in up to two passes.
+ */
+static int
+node_live_effect(struct ir3_sched_ctx *ctx, struct ir3_sched_node *n)
+{
+   if (n->live_effect_epoch != ctx->live_effect_epoch) {
+      n->live_effect = live_effect(n->instr);
+      n->live_effect_epoch = ctx->live_effect_epoch;
+   }
+
+   return n->live_effect;
+}
+
 /* Determine if this is an instruction that we'd prefer not to schedule
  * yet, in order to avoid an (ss)/(sy) sync.  This is limited by the
  * ss_delay/sy_delay counters, ie. the more cycles it has been since
@@ -699,7 +725,7 @@ choose_instr_dec(struct ir3_sched_ctx *ctx, struct ir3_sched_notes *notes,
 
       unsigned d = node_delay(ctx, n);
 
-      int live = live_effect(n->instr);
+      int live = node_live_effect(ctx, n);
       if (live > 0)
          continue;
 
@@ -1283,6 +1309,9 @@ sched_block(struct ir3_sched_ctx *ctx, struct ir3_block *block)
             list_addtail(&new_instr->node, &ctx->unscheduled_list);
          }
 
+         /* Splitting rewrites the uses of the split instruction. */
+         ctx->live_effect_epoch++;
+
          /* If we produced a new instruction, do not schedule it next to
           * guarantee progress.
           */
@@ -1298,6 +1327,9 @@ ir3_sched(struct ir3 *ir)
 {
    struct ir3_sched_ctx *ctx = rzalloc(NULL, struct ir3_sched_ctx);
 
+   /* Nodes start out with epoch 0, so this makes their cache invalid. */
+   ctx->live_effect_epoch = 1;
+
    foreach_block (block, &ir->block_list) {
       foreach_instr (instr, &block->instr_list) {
          instr->data = NULL;
@@ -316,12 +316,20 @@ needs_binning_variant(struct ir3_shader_variant *v)
    return false;
 }
 
+/*
+ * Allocate a variant and its binning variant, and fill them from the disk
+ * cache if possible.  Otherwise *needs_compile is set and the caller has to
+ * compile them with compile_variants(), which only touches the new variants
+ * and can run without shader->variants_lock.
+ */
 static struct ir3_shader_variant *
-create_variant(struct ir3_shader *shader, const struct ir3_shader_key *key,
-               bool write_disasm, void *mem_ctx)
+prepare_variant(struct ir3_shader *shader, const struct ir3_shader_key *key,
+                bool write_disasm, void *mem_ctx, bool *needs_compile)
 {
    struct ir3_shader_variant *v = alloc_variant(shader, key, NULL, mem_ctx);
 
+   *needs_compile = false;
+
    if (!v)
       goto fail;
 
@@ -352,19 +360,46 @@ create_variant(struct ir3_shader *shader, const struct ir3_shader_key *key,
       shader->nir_finalized = true;
    }
 
+   *needs_compile = true;
+   return v;
+
+fail:
+   ralloc_free(v);
+   return NULL;
+}
+
+/*
+ * The binning variant reuses the const state and input registers of the
+ * main variant, so the two are compiled in order.
+ */
+static bool
+compile_variants(struct ir3_shader *shader, struct ir3_shader_variant *v)
+{
    if (!compile_variant(shader, v))
-      goto fail;
+      return false;
 
    if (needs_binning_variant(v) && !compile_variant(shader, v->binning))
-      goto fail;
+      return false;
 
    ir3_disk_cache_store(shader, v);
 
-   return v;
+   return true;
+}
 
-fail:
-   ralloc_free(v);
-   return NULL;
+static struct ir3_shader_variant *
+create_variant(struct ir3_shader *shader, const struct ir3_shader_key *key,
+               bool write_disasm, void *mem_ctx)
+{
+   bool needs_compile;
+   struct ir3_shader_variant *v =
+      prepare_variant(shader, key, write_disasm, mem_ctx, &needs_compile);
+
+   if (v && needs_compile && !compile_variants(shader, v)) {
+      ralloc_free(v);
+      return NULL;
+   }
+
+   return v;
 }
 
 struct ir3_shader_variant *
@@ -396,9 +431,29 @@ ir3_shader_get_variant(struct ir3_shader *shader,
    struct ir3_shader_variant *v = shader_variant(shader, key);
 
    if (!v) {
-      /* compile new variant if it doesn't exist already: */
-      v = create_variant(shader, key, write_disasm, shader);
-      if (v) {
+      /* compile new variant if it doesn't exist already.  The compile
+       * itself runs without the lock, so that a draw needing another
+       * variant of this shader (or one that is already compiled) doesn't
+       * wait for it, e.g. behind the initial variants being compiled on
+       * the screen's compile queue.
+       */
+      bool needs_compile;
+      v = prepare_variant(shader, key, write_disasm, shader, &needs_compile);
+
+      if (v && needs_compile) {
+         mtx_unlock(&shader->variants_lock);
+         bool ok = compile_variants(shader, v);
+         mtx_lock(&shader->variants_lock);
+
+         /* ralloc isn't thread-safe, so free under the lock. */
+         struct ir3_shader_variant *other = shader_variant(shader, key);
+         if (!ok || other) {
+            ralloc_free(v);
+            v = other;
+         }
+      }
+
+      if (v && !shader_variant(shader, key)) {
          v->next = shader->variants;
          shader->variants = v;
          *created = true;
@@ -11,6 +11,10 @@
 #include "tu_image.h"
 #include "tu_pass.h"
 
+#include "util/blob.h"
+#include "util/disk_cache.h"
+#include "util/mesa-sha1.h"
+
 /* How does it work?
  *
  * - For each renderpass we calculate the number of samples passed
@@ -52,6 +56,8 @@ tu_autotune_free_results_locked(struct tu_device *dev, struct list_head *results
 
 /* How many last renderpass stats are taken into account. */
 #define MAX_HISTORY_RESULTS 5
+/* How many history entries are stored in the disk cache at most. */
+#define MAX_PERSISTENT_HISTORY 1024
 /* For how many submissions we store renderpass stats. */
 #define MAX_HISTORY_LIFETIME 128
 
@@ -72,6 +78,11 @@ struct tu_renderpass_history {
    uint32_t num_results;
 
    uint32_t avg_samples;
+
+   /* avg_samples was loaded from the disk cache and no result of this run
+    * has replaced it yet.
+    */
+   bool from_disk_cache;
 };
 
 /* Holds per-submission cs which writes the fence. */
@@ -194,7 +205,7 @@ get_history(struct tu_autotune *at, uint64_t rp_key, uint32_t *avg_samples)
       _mesa_hash_table_search(at->ht, &rp_key);
    if (entry) {
       struct tu_renderpass_history *history = entry->data;
-      if (history->num_results > 0) {
+      if (history->num_results > 0 || history->from_disk_cache) {
          *avg_samples = p_atomic_read(&history->avg_samples);
          has_history = true;
       }
@@ -242,6 +253,7 @@ history_add_result(struct tu_device *dev, struct tu_renderpass_history *history,
 
    float avg_samples = (float)total_samples / (float)history->num_results;
    p_atomic_set(&history->avg_samples, (uint32_t)avg_samples);
+   history->from_disk_cache = false;
 }
 
 static void
@@ -385,6 +397,115 @@ renderpass_key_hash(const void *_a)
    return *((uint64_t *) _a) & 0xffffffff;
 }
 
+/* Renderpass keys only hash the attachments and the pass, so keep the
+ * histories of different applications apart.
+ */
+static bool
+get_persistent_history_key(struct tu_device *dev, cache_key key)
+{
+   struct disk_cache *cache = dev->physical_device->vk.disk_cache;
+   const struct vk_app_info *app = &dev->instance->vk.app_info;
+
+   if (!cache)
+      return false;
+
+   struct mesa_sha1 ctx;
+   unsigned char sha1[SHA1_DIGEST_LENGTH];
+
+   _mesa_sha1_init(&ctx);
+   _mesa_sha1_update(&ctx, "tu autotune", 11);
+   if (app->app_name)
+      _mesa_sha1_update(&ctx, app->app_name, strlen(app->app_name) + 1);
+   _mesa_sha1_update(&ctx, &app->app_version, sizeof(app->app_version));
+   if (app->engine_name)
+      _mesa_sha1_update(&ctx, app->engine_name, strlen(app->engine_name) + 1);
+   _mesa_sha1_update(&ctx, &app->engine_version, sizeof(app->engine_version));
+   _mesa_sha1_final(&ctx, sha1);
+
+   disk_cache_compute_key(cache, sha1, sizeof(sha1), key);
+   return true;
+}
+
+/* Seed the history with the average sample counts of the previous run, so
+ * that the GMEM/sysmem decision is right from the first frame instead of
+ * after MAX_HISTORY_RESULTS submissions.
+ */
+static void
+load_persistent_history(struct tu_autotune *at, struct tu_device *dev)
+{
+   cache_key key;
+   if (!get_persistent_history_key(dev, key))
+      return;
+
+   size_t size;
+   void *data = disk_cache_get(dev->physical_device->vk.disk_cache, key,
+                               &size);
+   if (!data)
+      return;
+
+   struct blob_reader blob;
+   blob_reader_init(&blob, data, size);
+
+   uint32_t count = blob_read_uint32(&blob);
+   for (uint32_t i = 0;
+        i < MIN2(count, MAX_PERSISTENT_HISTORY) && !blob.overrun; i++) {
+      uint64_t rp_key = blob_read_uint64(&blob);
+      uint32_t avg_samples = blob_read_uint32(&blob);
+      if (blob.overrun ||
+          _mesa_hash_table_search(at->ht, &rp_key))
+         continue;
+
+      struct tu_renderpass_history *history = calloc(1, sizeof(*history));
+      if (!history)
+         break;
+
+      history->key = rp_key;
+      history->avg_samples = avg_samples;
+      history->from_disk_cache = true;
+      history->last_fence = at->fence_counter;
+      list_inithead(&history->results);
+      _mesa_hash_table_insert(at->ht, &history->key, history);
+   }
+
+   free(data);
+}
+
+static void
+store_persistent_history(struct tu_autotune *at, struct tu_device *dev)
+{
+   cache_key key;
+   if (!at->ht->entries || !get_persistent_history_key(dev, key))
+      return;
+
+   struct blob blob;
+   blob_init(&blob);
+
+   size_t count_offset = blob_reserve_uint32(&blob);
+   uint32_t count = 0;
+
+   hash_table_foreach(at->ht, entry) {
+      struct tu_renderpass_history *history = entry->data;
+
+      if (count == MAX_PERSISTENT_HISTORY)
+         break;
+      if (!history->num_results && !history->from_disk_cache)
+         continue;
+
+      blob_write_uint64(&blob, history->key);
+      blob_write_uint32(&blob, history->avg_samples);
+      count++;
+   }
+
+   blob_overwrite_uint32(&blob, count_offset, count);
+
+   if (count && !blob.out_of_memory) {
+      disk_cache_put(dev->physical_device->vk.disk_cache, key,
+                     blob.data, blob.size, NULL);
+   }
+
+   blob_finish(&blob);
+}
+
 VkResult
 tu_autotune_init(struct tu_autotune *at, struct tu_device *dev)
 {
@@ -402,6 +523,8 @@ tu_autotune_init(struct tu_autotune *at, struct tu_device *dev)
    /* start from 1 because tu6_global::autotune_fence is initialized to 0 */
    at->fence_counter = 1;
 
+   load_persistent_history(at, dev);
+
    return VK_SUCCESS;
 }
 
@@ -424,6 +547,8 @@ tu_autotune_fini(struct tu_autotune *at, struct tu_device *dev)
 
    tu_autotune_free_results(dev, &at->pending_results);
 
+   store_persistent_history(at, dev);
+
    mtx_lock(&dev->autotune_mutex);
    hash_table_foreach(at->ht, entry) {
       struct tu_renderpass_history *history = entry->data;
@@ -1667,6 +1667,14 @@ tu_create_cmd_buffer(struct vk_command_pool *pool,
    tu_cs_init(&cmd_buffer->pre_chain.draw_cs, device, TU_CS_MODE_GROW, 4096, "prechain draw cs");
    tu_cs_init(&cmd_buffer->pre_chain.draw_epilogue_cs, device, TU_CS_MODE_GROW, 4096, "prechain draw epiligoue cs");
 
+   cmd_buffer->cs.recycle_bos = true;
+   cmd_buffer->draw_cs.recycle_bos = true;
+   cmd_buffer->tile_store_cs.recycle_bos = true;
+   cmd_buffer->draw_epilogue_cs.recycle_bos = true;
+   cmd_buffer->sub_cs.recycle_bos = true;
+   cmd_buffer->pre_chain.draw_cs.recycle_bos = true;
+   cmd_buffer->pre_chain.draw_epilogue_cs.recycle_bos = true;
+
    *cmd_buffer_out = &cmd_buffer->vk;
 
    return VK_SUCCESS;
@@ -60,6 +60,66 @@ tu_cs_init_suballoc(struct tu_cs *cs, struct tu_device *device,
    cs->refcount_bo = tu_bo_get_ref(suballoc_bo->bo);
 }
 
+/* Take an idle BO of at least \a size bytes from the device's CS BO cache.
+ * BOs much larger than requested are left alone so that short command
+ * streams don't pin down the big BOs of long ones.
+ */
+static struct tu_bo *
+tu_cs_bo_cache_get(struct tu_device *dev, uint64_t size)
+{
+   struct tu_bo *bo = NULL;
+
+   mtx_lock(&dev->cs_bo_mutex);
+   for (uint32_t i = 0; i < dev->cs_bo_cache_count; i++) {
+      struct tu_bo *cached = dev->cs_bo_cache[i];
+      if (cached->size >= size && cached->size <= 4 * size) {
+         dev->cs_bo_cache[i] = dev->cs_bo_cache[--dev->cs_bo_cache_count];
+         dev->cs_bo_cache_size -= cached->size;
+         bo = cached;
+         break;
+      }
+   }
+   mtx_unlock(&dev->cs_bo_mutex);
+
+   return bo;
+}
+
+/* Release a BO owned by a command stream, either to the device's CS BO cache
+ * or back to the kernel if the cache is full.
+ */
+static void
+tu_cs_release_bo(struct tu_cs *cs, struct tu_bo *bo)
+{
+   struct tu_device *dev = cs->device;
+
+   if (cs->recycle_bos) {
+      mtx_lock(&dev->cs_bo_mutex);
+      if (dev->cs_bo_cache_count < ARRAY_SIZE(dev->cs_bo_cache) &&
+          dev->cs_bo_cache_size + bo->size <= TU_CS_BO_CACHE_MAX_SIZE) {
+         dev->cs_bo_cache[dev->cs_bo_cache_count++] = bo;
+         dev->cs_bo_cache_size += bo->size;
+         bo = NULL;
+      }
+      mtx_unlock(&dev->cs_bo_mutex);
+   }
+
+   if (bo)
+      tu_bo_finish(dev, bo);
+}
+
+/**
+ * Release all the BOs held in the device's CS BO cache.
+ */
+void
+tu_cs_bo_cache_finish(struct tu_device *dev)
+{
+   for (uint32_t i = 0; i < dev->cs_bo_cache_count; i++)
+      tu_bo_finish(dev, dev->cs_bo_cache[i]);
+
+   dev->cs_bo_cache_count = 0;
+   dev->cs_bo_cache_size = 0;
+}
+
 /**
  * Finish and release all resources owned by a command stream.
  */
@@ -67,7 +127,7 @@ void
 tu_cs_finish(struct tu_cs *cs)
 {
    for (uint32_t i = 0; i < cs->bo_count; ++i) {
-      tu_bo_finish(cs->device, cs->bos[i]);
+      tu_cs_release_bo(cs, cs->bos[i]);
    }
 
    if (cs->refcount_bo)
@@ -125,19 +185,25 @@ tu_cs_add_bo(struct tu_cs *cs, uint32_t size)
       cs->bos = new_bos;
    }
 
-   struct tu_bo *new_bo;
+   struct tu_bo *new_bo = NULL;
 
-   VkResult result =
-      tu_bo_init_new(cs->device, &new_bo, size * sizeof(uint32_t),
-                     TU_BO_ALLOC_GPU_READ_ONLY | TU_BO_ALLOC_ALLOW_DUMP, cs->name);
-   if (result != VK_SUCCESS) {
-      return result;
-   }
+   if (cs->recycle_bos)
+      new_bo = tu_cs_bo_cache_get(cs->device, size * sizeof(uint32_t));
 
-   result = tu_bo_map(cs->device, new_bo);
-   if (result != VK_SUCCESS) {
-      tu_bo_finish(cs->device, new_bo);
-      return result;
+   if (!new_bo) {
+      VkResult result =
+         tu_bo_init_new(cs->device, &new_bo, size * sizeof(uint32_t),
+                        TU_BO_ALLOC_GPU_READ_ONLY | TU_BO_ALLOC_ALLOW_DUMP,
+                        cs->name);
+      if (result != VK_SUCCESS) {
+         return result;
+      }
+
+      result = tu_bo_map(cs->device, new_bo);
+      if (result != VK_SUCCESS) {
+         tu_bo_finish(cs->device, new_bo);
+         return result;
+      }
    }
 
    cs->bos[cs->bo_count++] = new_bo;
@@ -422,7 +488,7 @@ tu_cs_reset(struct tu_cs *cs)
    }
 
    for (uint32_t i = 0; i + 1 < cs->bo_count; ++i) {
-      tu_bo_finish(cs->device, cs->bos[i]);
+      tu_cs_release_bo(cs, cs->bos[i]);
    }
 
    if (cs->bo_count) {
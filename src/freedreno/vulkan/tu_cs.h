@@ -94,6 +94,13 @@ struct tu_cs
    /* Optional BO that this CS is sub-allocated from for TU_CS_MODE_SUB_STREAM */
    struct tu_bo *refcount_bo;
 
+   /* Whether BOs released by tu_cs_reset()/tu_cs_finish() may be handed to
+    * the device's CS BO cache.  Only safe when the API guarantees that the
+    * GPU is done with the CS when it is reset or finished, i.e. for command
+    * buffers.
+    */
+   bool recycle_bos;
+
    /* state for cond_exec_start/cond_exec_end */
    uint32_t cond_stack_depth;
    uint32_t cond_flags[TU_COND_EXEC_STACK_SIZE];
@@ -108,6 +115,9 @@ tu_breadcrumbs_init(struct tu_device *device);
 void
 tu_breadcrumbs_finish(struct tu_device *device);
 
+void
+tu_cs_bo_cache_finish(struct tu_device *device);
+
 void
 tu_cs_init(struct tu_cs *cs,
            struct tu_device *device,
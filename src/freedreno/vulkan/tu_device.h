@@ -262,6 +262,16 @@ struct tu_device
    struct tu_suballocator autotune_suballoc;
    mtx_t autotune_mutex;
 
+   /* Idle command stream BOs released by command buffer resets and frees,
+    * reused by the next command buffers before allocating new ones.
+    * Synchronized by cs_bo_mutex.
+    */
+#define TU_CS_BO_CACHE_MAX_SIZE (16 * 1024 * 1024)
+   struct tu_bo *cs_bo_cache[64];
+   uint32_t cs_bo_cache_count;
+   uint64_t cs_bo_cache_size;
+   mtx_t cs_bo_mutex;
+
    /* the blob seems to always use 8K factor and 128K param sizes, copy them */
 #define TU_TESS_FACTOR_SIZE (8 * 1024)
 #define TU_TESS_PARAM_SIZE (128 * 1024)
@@ -101,6 +101,13 @@ struct cso_context {
    void *blend, *blend_saved;
    void *depth_stencil, *depth_stencil_saved;
    void *rasterizer, *rasterizer_saved;
+   /* The cache entries of the bound (and saved) states above, binds of the
+    * same state again are checked against them before hashing. Bound
+    * entries are never evicted from the cache.
+    */
+   struct cso_blend *blend_cso, *blend_cso_saved;
+   struct cso_depth_stencil_alpha *depth_stencil_cso, *depth_stencil_cso_saved;
+   struct cso_rasterizer *rasterizer_cso, *rasterizer_cso_saved;
    void *fragment_shader, *fragment_shader_saved;
    void *vertex_shader, *vertex_shader_saved;
    void *geometry_shader, *geometry_shader_saved;
@@ -474,7 +481,13 @@ cso_set_blend(struct cso_context *ctx,
 {
    unsigned key_size, hash_key;
    struct cso_hash_iter iter;
-   void *handle;
+   struct cso_blend *cso;
+
+   if (ctx->blend_cso &&
+       !memcmp(&ctx->blend_cso->state, templ,
+               templ->independent_blend_enable ? CSO_BLEND_KEY_SIZE_ALL_RT :
+                                                 CSO_BLEND_KEY_SIZE_RT0))
+      return PIPE_OK;
 
    if (templ->independent_blend_enable) {
       /* This is duplicated with the else block below because we want key_size
@@ -493,7 +506,7 @@ cso_set_blend(struct cso_context *ctx,
    }
 
    if (cso_hash_iter_is_null(iter)) {
-      struct cso_blend *cso = MALLOC(sizeof(struct cso_blend));
+      cso = MALLOC(sizeof(struct cso_blend));
       if (!cso)
          return PIPE_ERROR_OUT_OF_MEMORY;
 
@@ -506,15 +519,14 @@ cso_set_blend(struct cso_context *ctx,
          FREE(cso);
          return PIPE_ERROR_OUT_OF_MEMORY;
       }
-
-      handle = cso->data;
    } else {
-      handle = ((struct cso_blend *)cso_hash_iter_data(iter))->data;
+      cso = (struct cso_blend *)cso_hash_iter_data(iter);
    }
 
-   if (ctx->blend != handle) {
-      ctx->blend = handle;
-      ctx->pipe->bind_blend_state(ctx->pipe, handle);
+   ctx->blend_cso = cso;
+   if (ctx->blend != cso->data) {
+      ctx->blend = cso->data;
+      ctx->pipe->bind_blend_state(ctx->pipe, cso->data);
    }
    return PIPE_OK;
 }
@@ -525,6 +537,7 @@ cso_save_blend(struct cso_context *ctx)
 {
    assert(!ctx->blend_saved);
    ctx->blend_saved = ctx->blend;
+   ctx->blend_cso_saved = ctx->blend_cso;
 }
 
 
@@ -535,7 +548,9 @@ cso_restore_blend(struct cso_context *ctx)
       ctx->blend = ctx->blend_saved;
       ctx->pipe->bind_blend_state(ctx->pipe, ctx->blend_saved);
    }
+   ctx->blend_cso = ctx->blend_cso_saved;
    ctx->blend_saved = NULL;
+   ctx->blend_cso_saved = NULL;
 }
 
 
@@ -544,16 +559,20 @@ cso_set_depth_stencil_alpha(struct cso_context *ctx,
                             const struct pipe_depth_stencil_alpha_state *templ)
 {
    const unsigned key_size = sizeof(struct pipe_depth_stencil_alpha_state);
+
+   if (ctx->depth_stencil_cso &&
+       !memcmp(&ctx->depth_stencil_cso->state, templ, key_size))
+      return PIPE_OK;
+
    const unsigned hash_key = cso_construct_key(templ, key_size);
    struct cso_hash_iter iter = cso_find_state_template(&ctx->cache,
                                                        hash_key,
                                                        CSO_DEPTH_STENCIL_ALPHA,
                                                        templ, key_size);
-   void *handle;
+   struct cso_depth_stencil_alpha *cso;
 
    if (cso_hash_iter_is_null(iter)) {
-      struct cso_depth_stencil_alpha *cso =
-         MALLOC(sizeof(struct cso_depth_stencil_alpha));
+      cso = MALLOC(sizeof(struct cso_depth_stencil_alpha));
       if (!cso)
          return PIPE_ERROR_OUT_OF_MEMORY;
 
@@ -567,16 +586,14 @@ cso_set_depth_stencil_alpha(struct cso_context *ctx,
          FREE(cso);
          return PIPE_ERROR_OUT_OF_MEMORY;
       }
-
-      handle = cso->data;
    } else {
-      handle = ((struct cso_depth_stencil_alpha *)
-                cso_hash_iter_data(iter))->data;
+      cso = (struct cso_depth_stencil_alpha *)cso_hash_iter_data(iter);
    }
 
-   if (ctx->depth_stencil != handle) {
-      ctx->depth_stencil = handle;
-      ctx->pipe->bind_depth_stencil_alpha_state(ctx->pipe, handle);
+   ctx->depth_stencil_cso = cso;
+   if (ctx->depth_stencil != cso->data) {
+      ctx->depth_stencil = cso->data;
+      ctx->pipe->bind_depth_stencil_alpha_state(ctx->pipe, cso->data);
    }
    return PIPE_OK;
 }
@@ -587,6 +604,7 @@ cso_save_depth_stencil_alpha(struct cso_context *ctx)
 {
    assert(!ctx->depth_stencil_saved);
    ctx->depth_stencil_saved = ctx->depth_stencil;
+   ctx->depth_stencil_cso_saved = ctx->depth_stencil_cso;
 }
 
 
@@ -598,7 +616,9 @@ cso_restore_depth_stencil_alpha(struct cso_context *ctx)
       ctx->pipe->bind_depth_stencil_alpha_state(ctx->pipe,
                                                 ctx->depth_stencil_saved);
    }
+   ctx->depth_stencil_cso = ctx->depth_stencil_cso_saved;
    ctx->depth_stencil_saved = NULL;
+   ctx->depth_stencil_cso_saved = NULL;
 }
 
 
@@ -607,12 +627,17 @@ cso_set_rasterizer(struct cso_context *ctx,
                    const struct pipe_rasterizer_state *templ)
 {
    const unsigned key_size = sizeof(struct pipe_rasterizer_state);
+
+   if (ctx->rasterizer_cso &&
+       !memcmp(&ctx->rasterizer_cso->state, templ, key_size))
+      return PIPE_OK;
+
    const unsigned hash_key = cso_construct_key(templ, key_size);
    struct cso_hash_iter iter = cso_find_state_template(&ctx->cache,
                                                        hash_key,
                                                        CSO_RASTERIZER,
                                                        templ, key_size);
-   void *handle = NULL;
+   struct cso_rasterizer *cso;
 
    /* We can't have both point_quad_rasterization (sprites) and point_smooth
     * (round AA points) enabled at the same time.
@@ -620,7 +645,7 @@ cso_set_rasterizer(struct cso_context *ctx,
    assert(!(templ->point_quad_rasterization && templ->point_smooth));
 
    if (cso_hash_iter_is_null(iter)) {
-      struct cso_rasterizer *cso = MALLOC(sizeof(struct cso_rasterizer));
+      cso = MALLOC(sizeof(struct cso_rasterizer));
       if (!cso)
          return PIPE_ERROR_OUT_OF_MEMORY;
 
@@ -632,18 +657,17 @@ cso_set_rasterizer(struct cso_context *ctx,
          FREE(cso);
          return PIPE_ERROR_OUT_OF_MEMORY;
       }
-
-      handle = cso->data;
    } else {
-      handle = ((struct cso_rasterizer *)cso_hash_iter_data(iter))->data;
+      cso = (struct cso_rasterizer *)cso_hash_iter_data(iter);
    }
 
-   if (ctx->rasterizer != handle) {
-      ctx->rasterizer = handle;
+   ctx->rasterizer_cso = cso;
+   if (ctx->rasterizer != cso->data) {
+      ctx->rasterizer = cso->data;
       ctx->flatshade_first = templ->flatshade_first;
       if (ctx->vbuf)
          u_vbuf_set_flatshade_first(ctx->vbuf, ctx->flatshade_first);
-      ctx->pipe->bind_rasterizer_state(ctx->pipe, handle);
+      ctx->pipe->bind_rasterizer_state(ctx->pipe, cso->data);
    }
    return PIPE_OK;
 }
@@ -654,6 +678,7 @@ cso_save_rasterizer(struct cso_context *ctx)
 {
    assert(!ctx->rasterizer_saved);
    ctx->rasterizer_saved = ctx->rasterizer;
+   ctx->rasterizer_cso_saved = ctx->rasterizer_cso;
    ctx->flatshade_first_saved = ctx->flatshade_first;
 }
 
@@ -668,7 +693,9 @@ cso_restore_rasterizer(struct cso_context *ctx)
          u_vbuf_set_flatshade_first(ctx->vbuf, ctx->flatshade_first);
       ctx->pipe->bind_rasterizer_state(ctx->pipe, ctx->rasterizer_saved);
    }
+   ctx->rasterizer_cso = ctx->rasterizer_cso_saved;
    ctx->rasterizer_saved = NULL;
+   ctx->rasterizer_cso_saved = NULL;
 }
 
 
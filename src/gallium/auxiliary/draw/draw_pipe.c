@@ -147,6 +147,11 @@ do_line(struct draw_context *draw,
    prim.v[0] = (struct vertex_header *)v0;
    prim.v[1] = (struct vertex_header *)v1;
 
+   /* the clipper would drop it anyway */
+   if (draw->pipeline.first == draw->pipeline.clip &&
+       (prim.v[0]->clipmask & prim.v[1]->clipmask))
+      return;
+
    draw->pipeline.first->line(draw->pipeline.first, &prim);
 }
 
@@ -170,6 +175,14 @@ do_triangle(struct draw_context *draw,
    prim.flags = flags;
    prim.pad = 0;
 
+   /* Trivially reject triangles outside of a single clip plane before going
+    * through the stages, the clipper would drop them anyway.  Scenes with
+    * lots of off screen geometry spend most of their pipeline time here.
+    */
+   if (draw->pipeline.first == draw->pipeline.clip &&
+       (prim.v[0]->clipmask & prim.v[1]->clipmask & prim.v[2]->clipmask))
+      return;
+
    draw->pipeline.first->tri(draw->pipeline.first, &prim);
 }
 
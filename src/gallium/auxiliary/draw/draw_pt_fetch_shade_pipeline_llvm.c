@@ -28,6 +28,9 @@
 #include "util/u_math.h"
 #include "util/u_memory.h"
 #include "util/u_prim.h"
+#include "util/u_cpu_detect.h"
+#include "util/u_debug.h"
+#include "util/u_queue.h"
 #include "draw/draw_context.h"
 #include "draw/draw_gs.h"
 #include "draw/draw_tess.h"
@@ -58,6 +61,26 @@ struct llvm_middle_end {
 
    struct draw_llvm *llvm;
    struct draw_llvm_variant *current_variant;
+
+   /* helper threads running chunks of large vertex shader invocations */
+   struct util_queue vs_queue;
+   unsigned vs_threads;
+};
+
+
+/* draws are split into vs chunks of at least this many vertices */
+#define LLVM_VS_MIN_CHUNK 512
+#define LLVM_VS_MAX_THREADS 8
+
+struct llvm_vs_job {
+   struct util_queue_fence fence;
+   struct llvm_middle_end *fpme;
+   struct vertex_header *verts;
+   unsigned count;
+   unsigned start;
+   unsigned vertex_id_offset;
+   const unsigned *elts;
+   boolean clipped;
 };
 
 
@@ -542,6 +565,103 @@ emit(struct pt_emit *emit,
 }
 
 
+static void
+llvm_vs_job_run(struct llvm_vs_job *job)
+{
+   struct llvm_middle_end *fpme = job->fpme;
+   struct draw_context *draw = fpme->draw;
+
+   job->clipped = fpme->current_variant->jit_func(&fpme->llvm->jit_context,
+                                                  job->verts,
+                                                  draw->pt.user.vbuffer,
+                                                  job->count,
+                                                  job->start,
+                                                  fpme->vertex_size,
+                                                  draw->pt.vertex_buffer,
+                                                  draw->instance_id,
+                                                  job->vertex_id_offset,
+                                                  draw->start_instance,
+                                                  job->elts,
+                                                  draw->pt.user.drawid,
+                                                  draw->pt.user.viewid);
+}
+
+
+static void
+llvm_vs_job_execute(void *data, void *gdata, int thread_index)
+{
+   llvm_vs_job_run(data);
+}
+
+
+/**
+ * Run vertex fetch and shading, splitting large runs into chunks which are
+ * shaded in parallel.  Each chunk writes to its own range of the output
+ * vertices, so clipping and emission still see them in order.
+ */
+static boolean
+llvm_vs_run(struct llvm_middle_end *fpme,
+            struct vertex_header *verts,
+            unsigned count,
+            unsigned start,
+            unsigned vertex_id_offset,
+            const unsigned *elts)
+{
+   struct llvm_vs_job jobs[LLVM_VS_MAX_THREADS];
+   unsigned num_jobs = MIN2(fpme->vs_threads + 1, count / LLVM_VS_MIN_CHUNK);
+
+   if (num_jobs <= 1) {
+      struct llvm_vs_job job = {
+         .fpme = fpme,
+         .verts = verts,
+         .count = count,
+         .start = start,
+         .vertex_id_offset = vertex_id_offset,
+         .elts = elts,
+      };
+      llvm_vs_job_run(&job);
+      return job.clipped;
+   }
+
+   /* keep whole simd vectors in each chunk */
+   const unsigned chunk = align(DIV_ROUND_UP(count, num_jobs),
+                                lp_native_vector_width / 32);
+   num_jobs = DIV_ROUND_UP(count, chunk);
+
+   for (unsigned i = 0; i < num_jobs; i++) {
+      const unsigned offset = i * chunk;
+      struct llvm_vs_job *job = &jobs[i];
+
+      job->fpme = fpme;
+      job->verts = (struct vertex_header *)
+         ((char *)verts + offset * fpme->vertex_size);
+      job->count = MIN2(chunk, count - offset);
+      /* with elts, start is the max element index rather than an offset */
+      job->start = elts ? start : start + offset;
+      job->vertex_id_offset = vertex_id_offset;
+      job->elts = elts ? elts + offset : NULL;
+      job->clipped = FALSE;
+
+      if (i > 0) {
+         util_queue_fence_init(&job->fence);
+         util_queue_add_job(&fpme->vs_queue, job, &job->fence,
+                            llvm_vs_job_execute, NULL, 0);
+      }
+   }
+
+   llvm_vs_job_run(&jobs[0]);
+
+   boolean clipped = jobs[0].clipped;
+   for (unsigned i = 1; i < num_jobs; i++) {
+      util_queue_fence_wait(&jobs[i].fence);
+      util_queue_fence_destroy(&jobs[i].fence);
+      clipped |= jobs[i].clipped;
+   }
+
+   return clipped;
+}
+
+
 static void
 llvm_pipeline_generic(struct draw_pt_middle_end *middle,
                       const struct draw_fetch_info *fetch_info,
@@ -606,19 +726,8 @@ llvm_pipeline_generic(struct draw_pt_middle_end *middle,
          elts = fetch_info->elts;
       }
       /* Run vertex fetch shader */
-      clipped = fpme->current_variant->jit_func(&fpme->llvm->jit_context,
-                                                llvm_vert_info.verts,
-                                                draw->pt.user.vbuffer,
-                                                fetch_info->count,
-                                                start,
-                                                fpme->vertex_size,
-                                                draw->pt.vertex_buffer,
-                                                draw->instance_id,
-                                                vertex_id_offset,
-                                                draw->start_instance,
-                                                elts,
-                                                draw->pt.user.drawid,
-                                                draw->pt.user.viewid);
+      clipped = llvm_vs_run(fpme, llvm_vert_info.verts, fetch_info->count,
+                            start, vertex_id_offset, elts);
 
       /* Finished with fetch and vs */
       fetch_info = NULL;
@@ -897,6 +1006,9 @@ llvm_middle_end_destroy(struct draw_pt_middle_end *middle)
    if (fpme->post_vs)
       draw_pt_post_vs_destroy(fpme->post_vs);
 
+   if (fpme->vs_threads)
+      util_queue_destroy(&fpme->vs_queue);
+
    FREE(middle);
 }
 
@@ -945,6 +1057,15 @@ draw_pt_fetch_pipeline_or_emit_llvm(struct draw_context *draw)
 
    fpme->current_variant = NULL;
 
+   /* the draw thread shades a chunk itself */
+   unsigned vs_threads = MIN2(util_get_cpu_caps()->nr_cpus, LLVM_VS_MAX_THREADS);
+   vs_threads = debug_get_num_option("DRAW_VS_THREADS", vs_threads);
+   vs_threads = MIN2(vs_threads, LLVM_VS_MAX_THREADS);
+   if (vs_threads > 1 &&
+       util_queue_init(&fpme->vs_queue, "drawvs", LLVM_VS_MAX_THREADS,
+                       vs_threads - 1, UTIL_QUEUE_INIT_SCALE_THREADS, NULL))
+      fpme->vs_threads = vs_threads - 1;
+
    return &fpme->base;
 
  fail:
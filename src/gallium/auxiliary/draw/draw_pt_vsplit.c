@@ -32,6 +32,7 @@
 
 #define SEGMENT_SIZE 1024
 #define MAP_SIZE     256
+#define MAP_WAYS     2
 
 /* The largest possible index within an index buffer */
 #define MAX_ELT_IDX 0xffffffff
@@ -53,9 +54,12 @@ struct vsplit_frontend {
    ushort identity_draw_elts[SEGMENT_SIZE];
 
    struct {
-      /* map a fetch element to a draw element */
-      unsigned fetches[MAP_SIZE];
-      ushort draws[MAP_SIZE];
+      /* map a fetch element to a draw element, each set is replaced in lru
+       * order so that indices hashing to the same set don't thrash
+       */
+      unsigned fetches[MAP_SIZE][MAP_WAYS];
+      ushort draws[MAP_SIZE][MAP_WAYS];
+      ubyte lru[MAP_SIZE];
       boolean has_max_fetch;
 
       ushort num_fetch_elts;
@@ -68,6 +72,7 @@ static void
 vsplit_clear_cache(struct vsplit_frontend *vsplit)
 {
    memset(vsplit->cache.fetches, 0xff, sizeof(vsplit->cache.fetches));
+   memset(vsplit->cache.lru, 0, sizeof(vsplit->cache.lru));
    vsplit->cache.has_max_fetch = FALSE;
    vsplit->cache.num_fetch_elts = 0;
    vsplit->cache.num_draw_elts = 0;
@@ -89,23 +94,28 @@ vsplit_flush_cache(struct vsplit_frontend *vsplit, unsigned flags)
 static inline void
 vsplit_add_cache(struct vsplit_frontend *vsplit, unsigned fetch)
 {
-   unsigned hash;
+   unsigned hash, way;
 
    hash = fetch % MAP_SIZE;
 
-   /* If the value isn't in the cache or it's an overflow due to the
-    * element bias */
-   if (vsplit->cache.fetches[hash] != fetch) {
-      /* update cache */
-      vsplit->cache.fetches[hash] = fetch;
-      vsplit->cache.draws[hash] = vsplit->cache.num_fetch_elts;
+   if (vsplit->cache.fetches[hash][0] == fetch) {
+      way = 0;
+   } else if (vsplit->cache.fetches[hash][1] == fetch) {
+      way = 1;
+   } else {
+      /* If the value isn't in the cache or it's an overflow due to the
+       * element bias, replace the least recently used way */
+      way = vsplit->cache.lru[hash];
+      vsplit->cache.fetches[hash][way] = fetch;
+      vsplit->cache.draws[hash][way] = vsplit->cache.num_fetch_elts;
 
       /* add fetch */
       assert(vsplit->cache.num_fetch_elts < vsplit->segment_size);
       vsplit->fetch_elts[vsplit->cache.num_fetch_elts++] = fetch;
    }
+   vsplit->cache.lru[hash] = !way;
 
-   vsplit->draw_elts[vsplit->cache.num_draw_elts++] = vsplit->cache.draws[hash];
+   vsplit->draw_elts[vsplit->cache.num_draw_elts++] = vsplit->cache.draws[hash][way];
 }
 
 
@@ -131,7 +141,8 @@ vsplit_add_cache_ubyte(struct vsplit_frontend *vsplit, const ubyte *elts,
    /* unlike the uint case this can only happen with elt_bias */
    if (elt_bias && elt_idx == DRAW_MAX_FETCH_IDX && !vsplit->cache.has_max_fetch) {
       unsigned hash = elt_idx % MAP_SIZE;
-      vsplit->cache.fetches[hash] = 0;
+      vsplit->cache.fetches[hash][0] = 0;
+      vsplit->cache.fetches[hash][1] = 0;
       vsplit->cache.has_max_fetch = TRUE;
    }
    vsplit_add_cache(vsplit, elt_idx);
@@ -149,7 +160,8 @@ vsplit_add_cache_ushort(struct vsplit_frontend *vsplit, const ushort *elts,
    /* unlike the uint case this can only happen with elt_bias */
    if (elt_bias && elt_idx == DRAW_MAX_FETCH_IDX && !vsplit->cache.has_max_fetch) {
       unsigned hash = elt_idx % MAP_SIZE;
-      vsplit->cache.fetches[hash] = 0;
+      vsplit->cache.fetches[hash][0] = 0;
+      vsplit->cache.fetches[hash][1] = 0;
       vsplit->cache.has_max_fetch = TRUE;
    }
    vsplit_add_cache(vsplit, elt_idx);
@@ -175,7 +187,8 @@ vsplit_add_cache_uint(struct vsplit_frontend *vsplit, const uint *elts,
    if (elt_idx == DRAW_MAX_FETCH_IDX && !vsplit->cache.has_max_fetch) {
       unsigned hash = elt_idx % MAP_SIZE;
       /* force update - any value will do except DRAW_MAX_FETCH_IDX */
-      vsplit->cache.fetches[hash] = 0;
+      vsplit->cache.fetches[hash][0] = 0;
+      vsplit->cache.fetches[hash][1] = 0;
       vsplit->cache.has_max_fetch = TRUE;
    }
    vsplit_add_cache(vsplit, elt_idx);
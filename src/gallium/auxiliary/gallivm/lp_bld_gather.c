@@ -272,6 +272,44 @@ lp_build_gather_elem_vec(struct gallivm_state *gallivm,
 }
 
 
+/**
+ * 16-wide 32bit gather using the AVX-512 gather instructions.
+ */
+static LLVMValueRef
+lp_build_gather_avx512(struct gallivm_state *gallivm,
+                       struct lp_type dst_type,
+                       LLVMValueRef base_ptr,
+                       LLVMValueRef offsets)
+{
+   LLVMBuilderRef builder = gallivm->builder;
+   LLVMTypeRef i8_type = LLVMIntTypeInContext(gallivm->context, 8);
+   LLVMTypeRef i16_type = LLVMIntTypeInContext(gallivm->context, 16);
+   LLVMTypeRef i32_type = LLVMIntTypeInContext(gallivm->context, 32);
+   LLVMTypeRef src_type = dst_type.floating ?
+      LLVMFloatTypeInContext(gallivm->context) : i32_type;
+   LLVMTypeRef src_vec_type = LLVMVectorType(src_type, 16);
+   struct lp_type res_type = dst_type;
+   res_type.length *= 16;
+
+   assert(LLVMTypeOf(base_ptr) == LLVMPointerType(i8_type, 0));
+
+   const char *intrinsic = dst_type.floating ?
+      "llvm.x86.avx512.gather.dps.512" : "llvm.x86.avx512.gather.dpi.512";
+
+   LLVMValueRef args[] = {
+      LLVMGetUndef(src_vec_type),            /* passthru */
+      base_ptr,
+      offsets,
+      LLVMConstAllOnes(i16_type),            /* mask */
+      LLVMConstInt(i32_type, 1, 0),          /* scale */
+   };
+
+   LLVMValueRef res = lp_build_intrinsic(builder, intrinsic, src_vec_type,
+                                         args, ARRAY_SIZE(args), 0);
+   return LLVMBuildBitCast(builder, res,
+                           lp_build_vec_type(gallivm, res_type), "");
+}
+
 
 
 static LLVMValueRef
@@ -491,6 +529,9 @@ lp_build_gather(struct gallivm_state *gallivm,
               src_width == 32 && (length == 4 || length == 8)) {
       return lp_build_gather_avx2(gallivm, length, src_width, dst_type,
                                   base_ptr, offsets);
+   } else if (util_get_cpu_caps()->has_avx512f && !need_expansion &&
+              src_width == 32 && length == 16) {
+      return lp_build_gather_avx512(gallivm, dst_type, base_ptr, offsets);
    /*
     * This looks bad on paper wrt throughtput/latency on Haswell.
     * Even on Broadwell it doesn't look stellar.
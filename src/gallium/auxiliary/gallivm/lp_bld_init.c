@@ -32,6 +32,7 @@
 #include "util/u_cpu_detect.h"
 #include "util/u_debug.h"
 #include "util/u_memory.h"
+#include "util/hash_table.h"
 #include "util/os_time.h"
 #include "lp_bld.h"
 #include "lp_bld_debug.h"
@@ -105,6 +106,13 @@ enum LLVM_CodeGenOpt_Level {
 };
 
 
+static inline boolean
+gallivm_no_opt(const struct gallivm_state *gallivm)
+{
+   return gallivm->no_opt || (gallivm_perf & GALLIVM_PERF_NO_OPT);
+}
+
+
 /**
  * Create the LLVM (optimization) pass manager and install
  * relevant optimization passes.
@@ -148,7 +156,7 @@ create_pass_manager(struct gallivm_state *gallivm)
    LLVMAddCoroElidePass(gallivm->cgpassmgr);
 #endif
 
-   if ((gallivm_perf & GALLIVM_PERF_NO_OPT) == 0) {
+   if (!gallivm_no_opt(gallivm)) {
       /*
        * TODO: Evaluate passes some more - keeping in mind
        * both quality of generated code and compile times.
@@ -231,6 +239,8 @@ gallivm_free_ir(struct gallivm_state *gallivm)
    if (gallivm->builder)
       LLVMDisposeBuilder(gallivm->builder);
 
+   _mesa_hash_table_destroy(gallivm->inlined_tex_funcs, NULL);
+
    /* The LLVMContext should be owned by the parent of gallivm. */
 
    gallivm->engine = NULL;
@@ -246,6 +256,7 @@ gallivm_free_ir(struct gallivm_state *gallivm)
    gallivm->context = NULL;
    gallivm->builder = NULL;
    gallivm->cache = NULL;
+   gallivm->inlined_tex_funcs = NULL;
 }
 
 
@@ -272,7 +283,7 @@ init_gallivm_engine(struct gallivm_state *gallivm)
       char *error = NULL;
       int ret;
 
-      if (gallivm_perf & GALLIVM_PERF_NO_OPT) {
+      if (gallivm_no_opt(gallivm)) {
          optlevel = None;
       }
       else {
@@ -496,6 +507,34 @@ gallivm_create(const char *name, LLVMContextRef context,
 }
 
 
+/**
+ * Compile the module quickly: skip the IR optimization passes and use the
+ * lowest codegen optimization level.  Must be called before any IR is
+ * built.
+ */
+void
+gallivm_set_no_opt(struct gallivm_state *gallivm)
+{
+   assert(!gallivm->compiled);
+
+   if (gallivm->no_opt)
+      return;
+
+   gallivm->no_opt = TRUE;
+
+#if GALLIVM_USE_NEW_PASS == 0
+   /* The pass managers are set up at creation, rebuild them. */
+   LLVMDisposePassManager(gallivm->passmgr);
+   gallivm->passmgr = NULL;
+#if GALLIVM_HAVE_CORO == 1
+   LLVMDisposePassManager(gallivm->cgpassmgr);
+   gallivm->cgpassmgr = NULL;
+#endif
+   create_pass_manager(gallivm);
+#endif
+}
+
+
 /**
  * Destroy a gallivm_state object.
  */
@@ -576,10 +615,10 @@ gallivm_compile_module(struct gallivm_state *gallivm)
       LLVMWriteBitcodeToFile(gallivm->module, filename);
       debug_printf("%s written\n", filename);
       debug_printf("Invoke as \"opt %s %s | llc -O%d %s%s\"\n",
-                   gallivm_perf & GALLIVM_PERF_NO_OPT ? "-mem2reg" :
+                   gallivm_no_opt(gallivm) ? "-mem2reg" :
                    "-sroa -early-cse -simplifycfg -reassociate "
                    "-mem2reg -constprop -instcombine -gvn",
-                   filename, gallivm_perf & GALLIVM_PERF_NO_OPT ? 0 : 2,
+                   filename, gallivm_no_opt(gallivm) ? 0 : 2,
                    "[-mcpu=<-mcpu option>] ",
                    "[-mattr=<-mattr option(s)>]");
    }
@@ -600,7 +639,7 @@ gallivm_compile_module(struct gallivm_state *gallivm)
    LLVMPassBuilderOptionsRef opts = LLVMCreatePassBuilderOptions();
    LLVMRunPasses(gallivm->module, passes, LLVMGetExecutionEngineTargetMachine(gallivm->engine), opts);
 
-   if (!(gallivm_perf & GALLIVM_PERF_NO_OPT))
+   if (!gallivm_no_opt(gallivm))
       strcpy(passes, "sroa,early-cse,simplifycfg,reassociate,mem2reg,instsimplify,instcombine");
    else
       strcpy(passes, "mem2reg");
@@ -58,6 +58,7 @@ struct gallivm_state
    struct lp_generated_code *code;
    struct lp_cached_code *cache;
    unsigned compiled;
+   boolean no_opt;      /**< see gallivm_set_no_opt() */
    LLVMValueRef coro_malloc_hook;
    LLVMValueRef coro_free_hook;
    LLVMValueRef debug_printf_hook;
@@ -66,6 +67,9 @@ struct gallivm_state
    LLVMTypeRef coro_free_hook_type;
 
    LLVMValueRef get_time_hook;
+
+   /** Texture function name -> number of times its code was inlined */
+   struct hash_table *inlined_tex_funcs;
 };
 
 
@@ -77,6 +81,9 @@ struct gallivm_state *
 gallivm_create(const char *name, LLVMContextRef context,
                struct lp_cached_code *cache);
 
+void
+gallivm_set_no_opt(struct gallivm_state *gallivm);
+
 void
 gallivm_destroy(struct gallivm_state *gallivm);
 
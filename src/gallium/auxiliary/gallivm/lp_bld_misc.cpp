@@ -76,7 +76,7 @@
 #include <llvm/Support/CBindingWrapping.h>
 
 #include <llvm/Config/llvm-config.h>
-#if LLVM_USE_INTEL_JITEVENTS
+#if LLVM_USE_INTEL_JITEVENTS || LLVM_VERSION_MAJOR >= 8
 #include <llvm/ExecutionEngine/JITEventListener.h>
 #endif
 
@@ -323,62 +323,19 @@ public:
 
 };
 
-/**
- * Same as LLVMCreateJITCompilerForModule, but:
- * - allows using MCJIT and enabling AVX feature where available.
- * - set target options
- *
- * See also:
- * - llvm/lib/ExecutionEngine/ExecutionEngineBindings.cpp
- * - llvm/tools/lli/lli.cpp
- * - http://markmail.org/message/ttkuhvgj4cxxy2on#query:+page:1+mid:aju2dggerju3ivd3+state:results
+/* The target attributes and CPU name only depend on the host, but the ARM
+ * feature query reads /proc/cpuinfo, so work them out once instead of for
+ * every module we compile.
  */
-extern "C"
-LLVMBool
-lp_build_create_jit_compiler_for_module(LLVMExecutionEngineRef *OutJIT,
-                                        lp_generated_code **OutCode,
-                                        struct lp_cached_code *cache_out,
-                                        LLVMModuleRef M,
-                                        LLVMMCJITMemoryManagerRef CMM,
-                                        unsigned OptLevel,
-                                        char **OutError)
+static llvm::SmallVector<std::string, 16> host_mattrs;
+static std::string host_mcpu;
+static once_flag host_target_once = ONCE_FLAG_INIT;
+
+static void
+init_host_target(void)
 {
    using namespace llvm;
 
-   std::string Error;
-   EngineBuilder builder(std::unique_ptr<Module>(unwrap(M)));
-
-   /**
-    * LLVM 3.1+ haven't more "extern unsigned llvm::StackAlignmentOverride" and
-    * friends for configuring code generation options, like stack alignment.
-    */
-   TargetOptions options;
-#if defined(PIPE_ARCH_X86) && LLVM_VERSION_MAJOR < 13
-   options.StackAlignmentOverride = 4;
-#endif
-
-   builder.setEngineKind(EngineKind::JIT)
-          .setErrorStr(&Error)
-          .setTargetOptions(options)
-          .setOptLevel((CodeGenOpt::Level)OptLevel);
-
-#ifdef _WIN32
-    /*
-     * MCJIT works on Windows, but currently only through ELF object format.
-     *
-     * XXX: We could use `LLVM_HOST_TRIPLE "-elf"` but LLVM_HOST_TRIPLE has
-     * different strings for MinGW/MSVC, so better play it safe and be
-     * explicit.
-     */
-#  ifdef _WIN64
-    LLVMSetTarget(M, "x86_64-pc-win32-elf");
-#  else
-    LLVMSetTarget(M, "i686-pc-win32-elf");
-#  endif
-#endif
-
-   llvm::SmallVector<std::string, 16> MAttrs;
-
 #if defined(PIPE_ARCH_ARM)
    /* llvm-3.3+ implements sys::getHostCPUFeatures for Arm,
     * which allows us to enable/disable code generation based
@@ -390,7 +347,7 @@ lp_build_create_jit_compiler_for_module(LLVMExecutionEngineRef *OutJIT,
    for (StringMapIterator<bool> f = features.begin();
         f != features.end();
         ++f) {
-      MAttrs.push_back(((*f).second ? "+" : "-") + (*f).first().str());
+      host_mattrs.push_back(((*f).second ? "+" : "-") + (*f).first().str());
    }
 #elif defined(PIPE_ARCH_X86) || defined(PIPE_ARCH_X86_64)
    /*
@@ -398,42 +355,42 @@ lp_build_create_jit_compiler_for_module(LLVMExecutionEngineRef *OutJIT,
     * so we do not use llvm::sys::getHostCPUFeatures to detect cpu features
     * but using util_get_cpu_caps() instead.
     */
-   MAttrs.push_back(util_get_cpu_caps()->has_sse    ? "+sse"    : "-sse"   );
-   MAttrs.push_back(util_get_cpu_caps()->has_sse2   ? "+sse2"   : "-sse2"  );
-   MAttrs.push_back(util_get_cpu_caps()->has_sse3   ? "+sse3"   : "-sse3"  );
-   MAttrs.push_back(util_get_cpu_caps()->has_ssse3  ? "+ssse3"  : "-ssse3" );
-   MAttrs.push_back(util_get_cpu_caps()->has_sse4_1 ? "+sse4.1" : "-sse4.1");
-   MAttrs.push_back(util_get_cpu_caps()->has_sse4_2 ? "+sse4.2" : "-sse4.2");
+   host_mattrs.push_back(util_get_cpu_caps()->has_sse    ? "+sse"    : "-sse"   );
+   host_mattrs.push_back(util_get_cpu_caps()->has_sse2   ? "+sse2"   : "-sse2"  );
+   host_mattrs.push_back(util_get_cpu_caps()->has_sse3   ? "+sse3"   : "-sse3"  );
+   host_mattrs.push_back(util_get_cpu_caps()->has_ssse3  ? "+ssse3"  : "-ssse3" );
+   host_mattrs.push_back(util_get_cpu_caps()->has_sse4_1 ? "+sse4.1" : "-sse4.1");
+   host_mattrs.push_back(util_get_cpu_caps()->has_sse4_2 ? "+sse4.2" : "-sse4.2");
    /*
     * AVX feature is not automatically detected from CPUID by the X86 target
     * yet, because the old (yet default) JIT engine is not capable of
     * emitting the opcodes. On newer llvm versions it is and at least some
     * versions (tested with 3.3) will emit avx opcodes without this anyway.
     */
-   MAttrs.push_back(util_get_cpu_caps()->has_avx  ? "+avx"  : "-avx");
-   MAttrs.push_back(util_get_cpu_caps()->has_f16c ? "+f16c" : "-f16c");
-   MAttrs.push_back(util_get_cpu_caps()->has_fma  ? "+fma"  : "-fma");
-   MAttrs.push_back(util_get_cpu_caps()->has_avx2 ? "+avx2" : "-avx2");
+   host_mattrs.push_back(util_get_cpu_caps()->has_avx  ? "+avx"  : "-avx");
+   host_mattrs.push_back(util_get_cpu_caps()->has_f16c ? "+f16c" : "-f16c");
+   host_mattrs.push_back(util_get_cpu_caps()->has_fma  ? "+fma"  : "-fma");
+   host_mattrs.push_back(util_get_cpu_caps()->has_avx2 ? "+avx2" : "-avx2");
 
    /* All avx512 have avx512f */
-   MAttrs.push_back(util_get_cpu_caps()->has_avx512f ? "+avx512f"  : "-avx512f");
-   MAttrs.push_back(util_get_cpu_caps()->has_avx512cd ? "+avx512cd"  : "-avx512cd");
-   MAttrs.push_back(util_get_cpu_caps()->has_avx512er ? "+avx512er"  : "-avx512er");
-   MAttrs.push_back(util_get_cpu_caps()->has_avx512pf ? "+avx512pf"  : "-avx512pf");
-   MAttrs.push_back(util_get_cpu_caps()->has_avx512bw ? "+avx512bw"  : "-avx512bw");
-   MAttrs.push_back(util_get_cpu_caps()->has_avx512dq ? "+avx512dq"  : "-avx512dq");
-   MAttrs.push_back(util_get_cpu_caps()->has_avx512vl ? "+avx512vl"  : "-avx512vl");
+   host_mattrs.push_back(util_get_cpu_caps()->has_avx512f ? "+avx512f"  : "-avx512f");
+   host_mattrs.push_back(util_get_cpu_caps()->has_avx512cd ? "+avx512cd"  : "-avx512cd");
+   host_mattrs.push_back(util_get_cpu_caps()->has_avx512er ? "+avx512er"  : "-avx512er");
+   host_mattrs.push_back(util_get_cpu_caps()->has_avx512pf ? "+avx512pf"  : "-avx512pf");
+   host_mattrs.push_back(util_get_cpu_caps()->has_avx512bw ? "+avx512bw"  : "-avx512bw");
+   host_mattrs.push_back(util_get_cpu_caps()->has_avx512dq ? "+avx512dq"  : "-avx512dq");
+   host_mattrs.push_back(util_get_cpu_caps()->has_avx512vl ? "+avx512vl"  : "-avx512vl");
 #endif
 #if defined(PIPE_ARCH_ARM)
    if (!util_get_cpu_caps()->has_neon) {
-      MAttrs.push_back("-neon");
-      MAttrs.push_back("-crypto");
-      MAttrs.push_back("-vfp2");
+      host_mattrs.push_back("-neon");
+      host_mattrs.push_back("-crypto");
+      host_mattrs.push_back("-vfp2");
    }
 #endif
 
 #if defined(PIPE_ARCH_PPC)
-   MAttrs.push_back(util_get_cpu_caps()->has_altivec ? "+altivec" : "-altivec");
+   host_mattrs.push_back(util_get_cpu_caps()->has_altivec ? "+altivec" : "-altivec");
    /*
     * Bug 25503 is fixed, by the same fix that fixed
     * bug 26775, in versions of LLVM later than 3.8 (starting with 3.8.1).
@@ -445,28 +402,16 @@ lp_build_create_jit_compiler_for_module(LLVMExecutionEngineRef *OutJIT,
     * VSX instructions are explicitly enabled/disabled via GALLIVM_VSX=1 or 0.
     */
    if (util_get_cpu_caps()->has_altivec) {
-      MAttrs.push_back(util_get_cpu_caps()->has_vsx ? "+vsx" : "-vsx");
+      host_mattrs.push_back(util_get_cpu_caps()->has_vsx ? "+vsx" : "-vsx");
    }
 #endif
 
 #if defined(PIPE_ARCH_MIPS64)
-   MAttrs.push_back(util_get_cpu_caps()->has_msa ? "+msa" : "-msa");
+   host_mattrs.push_back(util_get_cpu_caps()->has_msa ? "+msa" : "-msa");
    /* MSA requires a 64-bit FPU register file */
-   MAttrs.push_back("+fp64");
+   host_mattrs.push_back("+fp64");
 #endif
 
-   builder.setMAttrs(MAttrs);
-
-   if (gallivm_debug & (GALLIVM_DEBUG_IR | GALLIVM_DEBUG_ASM | GALLIVM_DEBUG_DUMP_BC)) {
-      int n = MAttrs.size();
-      if (n > 0) {
-         debug_printf("llc -mattr option(s): ");
-         for (int i = 0; i < n; i++)
-            debug_printf("%s%s", MAttrs[i].c_str(), (i < n - 1) ? "," : "");
-         debug_printf("\n");
-      }
-   }
-
    StringRef MCPU = llvm::sys::getHostCPUName();
    /*
     * The cpu bits are no longer set automatically, so need to set mcpu manually.
@@ -482,17 +427,6 @@ lp_build_create_jit_compiler_for_module(LLVMExecutionEngineRef *OutJIT,
     */
 
 #ifdef PIPE_ARCH_PPC_64
-   /*
-    * Large programs, e.g. gnome-shell and firefox, may tax the addressability
-    * of the Medium code model once dynamically generated JIT-compiled shader
-    * programs are linked in and relocated.  Yet the default code model as of
-    * LLVM 8 is Medium or even Small.
-    * The cost of changing from Medium to Large is negligible:
-    * - an additional 8-byte pointer stored immediately before the shader entrypoint;
-    * - change an add-immediate (addis) instruction to a load (ld).
-    */
-   builder.setCodeModel(CodeModel::Large);
-
 #if UTIL_ARCH_LITTLE_ENDIAN
    /*
     * Versions of LLVM prior to 4.0 lacked a table entry for "POWER8NVL",
@@ -520,9 +454,93 @@ lp_build_create_jit_compiler_for_module(LLVMExecutionEngineRef *OutJIT,
       MCPU = util_get_cpu_caps()->has_msa ? "mips64r5" : "mips64r2";
 #endif
 
-   builder.setMCPU(MCPU);
+   host_mcpu = MCPU.str();
+}
+
+/**
+ * Same as LLVMCreateJITCompilerForModule, but:
+ * - allows using MCJIT and enabling AVX feature where available.
+ * - set target options
+ *
+ * See also:
+ * - llvm/lib/ExecutionEngine/ExecutionEngineBindings.cpp
+ * - llvm/tools/lli/lli.cpp
+ * - http://markmail.org/message/ttkuhvgj4cxxy2on#query:+page:1+mid:aju2dggerju3ivd3+state:results
+ */
+extern "C"
+LLVMBool
+lp_build_create_jit_compiler_for_module(LLVMExecutionEngineRef *OutJIT,
+                                        lp_generated_code **OutCode,
+                                        struct lp_cached_code *cache_out,
+                                        LLVMModuleRef M,
+                                        LLVMMCJITMemoryManagerRef CMM,
+                                        unsigned OptLevel,
+                                        char **OutError)
+{
+   using namespace llvm;
+
+   std::string Error;
+   EngineBuilder builder(std::unique_ptr<Module>(unwrap(M)));
+
+   /**
+    * LLVM 3.1+ haven't more "extern unsigned llvm::StackAlignmentOverride" and
+    * friends for configuring code generation options, like stack alignment.
+    */
+   TargetOptions options;
+#if defined(PIPE_ARCH_X86) && LLVM_VERSION_MAJOR < 13
+   options.StackAlignmentOverride = 4;
+#endif
+
+   builder.setEngineKind(EngineKind::JIT)
+          .setErrorStr(&Error)
+          .setTargetOptions(options)
+          .setOptLevel((CodeGenOpt::Level)OptLevel);
+
+#ifdef _WIN32
+    /*
+     * MCJIT works on Windows, but currently only through ELF object format.
+     *
+     * XXX: We could use `LLVM_HOST_TRIPLE "-elf"` but LLVM_HOST_TRIPLE has
+     * different strings for MinGW/MSVC, so better play it safe and be
+     * explicit.
+     */
+#  ifdef _WIN64
+    LLVMSetTarget(M, "x86_64-pc-win32-elf");
+#  else
+    LLVMSetTarget(M, "i686-pc-win32-elf");
+#  endif
+#endif
+
+   call_once(&host_target_once, init_host_target);
+
+   builder.setMAttrs(host_mattrs);
+
+   if (gallivm_debug & (GALLIVM_DEBUG_IR | GALLIVM_DEBUG_ASM | GALLIVM_DEBUG_DUMP_BC)) {
+      int n = host_mattrs.size();
+      if (n > 0) {
+         debug_printf("llc -mattr option(s): ");
+         for (int i = 0; i < n; i++)
+            debug_printf("%s%s", host_mattrs[i].c_str(), (i < n - 1) ? "," : "");
+         debug_printf("\n");
+      }
+   }
+
+#ifdef PIPE_ARCH_PPC_64
+   /*
+    * Large programs, e.g. gnome-shell and firefox, may tax the addressability
+    * of the Medium code model once dynamically generated JIT-compiled shader
+    * programs are linked in and relocated.  Yet the default code model as of
+    * LLVM 8 is Medium or even Small.
+    * The cost of changing from Medium to Large is negligible:
+    * - an additional 8-byte pointer stored immediately before the shader entrypoint;
+    * - change an add-immediate (addis) instruction to a load (ld).
+    */
+   builder.setCodeModel(CodeModel::Large);
+#endif
+
+   builder.setMCPU(host_mcpu);
    if (gallivm_debug & (GALLIVM_DEBUG_IR | GALLIVM_DEBUG_ASM | GALLIVM_DEBUG_DUMP_BC)) {
-      debug_printf("llc -mcpu option: %s\n", MCPU.str().c_str());
+      debug_printf("llc -mcpu option: %s\n", host_mcpu.c_str());
    }
 
    ShaderMemoryManager *MM = NULL;
@@ -546,6 +564,17 @@ lp_build_create_jit_compiler_for_module(LLVMExecutionEngineRef *OutJIT,
 #if LLVM_USE_INTEL_JITEVENTS
    JITEventListener *JEL = JITEventListener::createIntelJITEventListener();
    JIT->RegisterJITEventListener(JEL);
+#endif
+#if LLVM_VERSION_MAJOR >= 8
+   /* Write jitdump records with the code of every function, for
+    * "perf inject --jit".  This is a no-op unless LLVM was built with
+    * LLVM_USE_PERF.
+    */
+   if (JIT && debug_get_bool_option("GALLIVM_JITDUMP", false)) {
+      JITEventListener *perf = JITEventListener::createPerfJITEventListener();
+      if (perf)
+         JIT->RegisterJITEventListener(perf);
+   }
 #endif
    if (JIT) {
       *OutJIT = wrap(JIT);
@@ -44,6 +44,8 @@
 #include "util/format/u_format.h"
 #include "util/u_cpu_detect.h"
 #include "util/format_rgb9e5.h"
+#include "util/hash_table.h"
+#include "util/ralloc.h"
 #include "lp_bld_debug.h"
 #include "lp_bld_type.h"
 #include "lp_bld_const.h"
@@ -4012,6 +4014,11 @@ lp_build_sample_soa_code(struct gallivm_state *gallivm,
 
 #define USE_TEX_FUNC_CALL 1
 
+/* How many times the code of a "simple" texture function gets inlined into
+ * a module before further uses call a shared function instead.
+ */
+#define MAX_TEX_FUNC_INLINES 4
+
 #define LP_MAX_TEX_FUNC_ARGS 32
 
 static inline void
@@ -4173,6 +4180,23 @@ lp_build_sample_gen_func(struct gallivm_state *gallivm,
 }
 
 
+/*
+ * texture function matches are found by name.
+ * Thus the name has to include both the texture and sampler unit
+ * (which covers all static state) plus the actual texture function
+ * (including things like offsets, shadow coord, lod control).
+ * Additionally lod_property has to be included too.
+ */
+static void
+get_tex_func_name(char *func_name, size_t size,
+                  unsigned texture_index, unsigned sampler_index,
+                  unsigned sample_key)
+{
+   snprintf(func_name, size, "texfunc_res_%d_sam_%d_%x",
+            texture_index, sampler_index, sample_key);
+}
+
+
 /**
  * Call the matching function for texture sampling.
  * If there's no match, generate a new one.
@@ -4219,16 +4243,9 @@ lp_build_sample_soa_func(struct gallivm_state *gallivm,
       }
    }
 
-   /*
-    * texture function matches are found by name.
-    * Thus the name has to include both the texture and sampler unit
-    * (which covers all static state) plus the actual texture function
-    * (including things like offsets, shadow coord, lod control).
-    * Additionally lod_property has to be included too.
-    */
    char func_name[64];
-   snprintf(func_name, sizeof(func_name), "texfunc_res_%d_sam_%d_%x",
-            texture_index, sampler_index, sample_key);
+   get_tex_func_name(func_name, sizeof(func_name),
+                     texture_index, sampler_index, sample_key);
 
    LLVMValueRef function = LLVMGetNamedFunction(module, func_name);
    LLVMTypeRef arg_types[LP_MAX_TEX_FUNC_ARGS];
@@ -4401,6 +4418,39 @@ lp_build_sample_soa(const struct lp_static_texture_state *static_texture_state,
             static_sampler_state->min_img_filter == static_sampler_state->mag_img_filter);
 
       use_tex_func = !(simple_format && simple_tex);
+
+      /* Inlining is what makes simple sampling cheap, but shaders which
+       * sample the same unit the same way over and over would get a copy
+       * of the code each time, which bloats the IR and the JIT time.  So
+       * only inline the first few and call a shared function for the rest.
+       */
+      if (!use_tex_func) {
+         char func_name[64];
+         get_tex_func_name(func_name, sizeof(func_name),
+                           params->texture_index, params->sampler_index,
+                           params->sample_key);
+
+         if (!gallivm->inlined_tex_funcs) {
+            gallivm->inlined_tex_funcs =
+               _mesa_hash_table_create(NULL, _mesa_hash_string,
+                                       _mesa_key_string_equal);
+         }
+
+         struct hash_entry *entry =
+            _mesa_hash_table_search(gallivm->inlined_tex_funcs, func_name);
+         if (!entry) {
+            entry = _mesa_hash_table_insert(gallivm->inlined_tex_funcs,
+                                            ralloc_strdup(gallivm->inlined_tex_funcs,
+                                                          func_name),
+                                            (void *)(uintptr_t)0);
+         }
+
+         uintptr_t count = (uintptr_t)entry->data;
+         if (count >= MAX_TEX_FUNC_INLINES)
+            use_tex_func = TRUE;
+         else
+            entry->data = (void *)(count + 1);
+      }
    }
 
    if (use_tex_func) {
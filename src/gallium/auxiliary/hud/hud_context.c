@@ -61,6 +61,7 @@
 #include "util/u_inlines.h"
 #include "util/u_memory.h"
 #include "util/u_math.h"
+#include "util/os_time.h"
 #include "util/u_sampler.h"
 #include "util/u_simple_shaders.h"
 #include "util/u_string.h"
@@ -967,7 +968,16 @@ hud_pane_add_graph(struct hud_pane *pane, struct hud_graph *gr)
 void
 hud_graph_add_value(struct hud_graph *gr, double value)
 {
+   struct hud_context *hud = gr->pane->hud;
+
    gr->current_value = value;
+
+   if (hud->dump_csv) {
+      fprintf(hud->dump_csv, "%" PRId64 ",%s,%f\n",
+              (os_time_get_nano() - hud->dump_csv_start) / 1000,
+              gr->name, value);
+   }
+
    value = value > gr->pane->ceiling ? gr->pane->ceiling : value;
 
    if (gr->fd) {
@@ -1063,6 +1073,32 @@ hud_graph_set_dump_file(struct hud_graph *gr)
    }
 }
 
+/**
+ * If the GALLIUM_HUD_DUMP_CSV env var is set, all HUD values are written
+ * as they are sampled into a single CSV file, one "time_us,graph,value"
+ * row per value.  Unlike GALLIUM_HUD_DUMP_DIR, the values are not clamped
+ * to the pane ceiling and carry a timestamp.  Combined with
+ * GALLIUM_HUD_VISIBLE=false, this records the counters without drawing
+ * anything.
+ */
+static void
+hud_set_dump_csv(struct hud_context *hud)
+{
+   const char *path = debug_get_option("GALLIUM_HUD_DUMP_CSV", NULL);
+
+   if (!path || !*path)
+      return;
+
+   hud->dump_csv = fopen(path, "w");
+   if (!hud->dump_csv) {
+      fprintf(stderr, "gallium_hud: unable to open %s for writing\n", path);
+      return;
+   }
+
+   fprintf(hud->dump_csv, "time_us,graph,value\n");
+   hud->dump_csv_start = os_time_get_nano();
+}
+
 /**
  * Read a string from the environment variable.
  * The separators "+", ",", ":", and ";" terminate the string.
@@ -1282,6 +1318,13 @@ hud_parse_env_var(struct hud_context *hud, struct pipe_screen *screen,
       else if (strcmp(name, "main-thread-busy") == 0) {
          hud_thread_busy_install(pane, name, true);
       }
+      else if (strncmp(name, "tc-", 3) == 0 &&
+               hud_tc_counter_install(pane, name)) {
+         if (strcmp(name, "tc-map-copied-bytes") == 0)
+            pane->type = PIPE_DRIVER_QUERY_TYPE_BYTES;
+         else if (strncmp(name, "tc-call-time-", 13) == 0)
+            pane->type = PIPE_DRIVER_QUERY_TYPE_MICROSECONDS;
+      }
 #ifdef HAVE_GALLIUM_EXTRA_HUD
       else if (sscanf(name, "nic-rx-%s", arg_name) == 1) {
          hud_nic_graph_install(pane, arg_name, NIC_DIRECTION_RX);
@@ -1596,6 +1639,11 @@ print_help(struct pipe_screen *screen)
       puts("    cs-invocations");
    }
 
+   puts("    tc-syncs-{flush,query,buffer-map,texture-map,texture-subdata,fence,other}");
+   puts("    tc-calls-<call>, e.g. tc-calls-draw_single");
+   puts("    tc-call-time-<call>, e.g. tc-call-time-draw_single");
+   puts("    tc-map-copied-bytes");
+
 #ifdef HAVE_GALLIUM_EXTRA_HUD
    hud_get_num_disks(1);
    hud_get_num_nics(1);
@@ -1897,6 +1945,8 @@ hud_create(struct cso_context *cso, struct st_context_iface *st,
 
    hud->refcount = 1;
 
+   hud_set_dump_csv(hud);
+
    static const enum pipe_format srgb_formats[] = {
       PIPE_FORMAT_B8G8R8A8_SRGB,
       PIPE_FORMAT_B8G8R8X8_SRGB
@@ -1992,6 +2042,8 @@ hud_destroy(struct hud_context *hud, struct cso_context *cso)
 
    if (p_atomic_dec_zero(&hud->refcount)) {
       pipe_resource_reference(&hud->font.texture, NULL);
+      if (hud->dump_csv)
+         fclose(hud->dump_csv);
       FREE(hud);
    }
 }
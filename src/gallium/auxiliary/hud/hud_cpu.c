@@ -33,6 +33,7 @@
 #include "os/os_thread.h"
 #include "util/u_memory.h"
 #include "util/u_queue.h"
+#include "util/u_threaded_context.h"
 #include <stdio.h>
 #include <inttypes.h>
 #ifdef PIPE_OS_WINDOWS
@@ -474,3 +475,110 @@ void hud_thread_counter_install(struct hud_pane *pane, const char *name,
    hud_pane_add_graph(pane, gr);
    hud_pane_set_max_value(pane, 100);
 }
+
+struct tc_counter_info {
+   enum hud_tc_counter counter;
+   unsigned index;
+   uint64_t last_value;
+};
+
+static uint64_t
+get_tc_counter(struct threaded_context *tc, struct tc_counter_info *info)
+{
+   switch (info->counter) {
+   case HUD_TC_COUNTER_SYNCS:
+      return tc->num_syncs_per_reason[info->index];
+   case HUD_TC_COUNTER_CALLS:
+      return tc->call_stats[info->index].num_calls;
+   case HUD_TC_COUNTER_CALL_TIME:
+      return p_atomic_read(&tc->call_stats[info->index].exec_time_ns) / 1000;
+   case HUD_TC_COUNTER_MAP_COPIED_BYTES:
+      return tc->num_map_copied_bytes;
+   default:
+      assert(0);
+      return 0;
+   }
+}
+
+static void
+query_tc_counter(struct hud_graph *gr, struct pipe_context *pipe)
+{
+   struct tc_counter_info *info = gr->query_data;
+   struct threaded_context *tc = threaded_context_from_pipe(pipe);
+   uint64_t value = tc ? get_tc_counter(tc, info) : 0;
+
+   /* The counters are cumulative, display the difference per frame. */
+   hud_graph_add_value(gr, value - MIN2(value, info->last_value));
+   info->last_value = value;
+}
+
+/**
+ * Install a graph for a threaded context counter:
+ *   tc-syncs-<reason>, tc-calls-<call>, tc-call-time-<call> (in us),
+ *   tc-map-copied-bytes
+ *
+ * Returns false if the name isn't a threaded context counter.
+ */
+bool
+hud_tc_counter_install(struct hud_pane *pane, const char *name)
+{
+   enum hud_tc_counter counter;
+   int index = 0;
+
+   if (strncmp(name, "tc-syncs-", 9) == 0) {
+      counter = HUD_TC_COUNTER_SYNCS;
+      for (index = 0; index < TC_NUM_SYNC_REASONS; index++) {
+         if (!strcmp(name + 9, threaded_context_get_sync_reason_name(index)))
+            break;
+      }
+      if (index == TC_NUM_SYNC_REASONS)
+         return false;
+   } else if (strncmp(name, "tc-calls-", 9) == 0) {
+      counter = HUD_TC_COUNTER_CALLS;
+      index = threaded_context_get_call_id(name + 9);
+   } else if (strncmp(name, "tc-call-time-", 13) == 0) {
+      counter = HUD_TC_COUNTER_CALL_TIME;
+      index = threaded_context_get_call_id(name + 13);
+   } else if (strcmp(name, "tc-map-copied-bytes") == 0) {
+      counter = HUD_TC_COUNTER_MAP_COPIED_BYTES;
+   } else {
+      return false;
+   }
+
+   if (index < 0)
+      return false;
+
+   struct threaded_context *tc =
+      threaded_context_from_pipe(pane->hud->record_pipe);
+   if (tc && counter == HUD_TC_COUNTER_CALL_TIME)
+      threaded_context_enable_call_profiling(tc);
+
+   struct hud_graph *gr = CALLOC_STRUCT(hud_graph);
+   if (!gr)
+      return true;
+
+   strcpy(gr->name, name);
+
+   struct tc_counter_info *info = CALLOC_STRUCT(tc_counter_info);
+   if (!info) {
+      FREE(gr);
+      return true;
+   }
+
+   info->counter = counter;
+   info->index = index;
+   if (tc)
+      info->last_value = get_tc_counter(tc, info);
+
+   gr->query_data = info;
+   gr->query_new_value = query_tc_counter;
+
+   /* Don't use free() as our callback as that messes up Gallium's
+    * memory debugger.  Use simple free_query_data() wrapper.
+    */
+   gr->free_query_data = free_query_data;
+
+   hud_pane_add_graph(pane, gr);
+   hud_pane_set_max_value(pane, 100);
+   return true;
+}
@@ -41,6 +41,13 @@ enum hud_counter {
    HUD_COUNTER_BATCHES,
 };
 
+enum hud_tc_counter {
+   HUD_TC_COUNTER_SYNCS,      /* index is enum tc_sync_reason */
+   HUD_TC_COUNTER_CALLS,      /* index is the call id */
+   HUD_TC_COUNTER_CALL_TIME,  /* index is the call id */
+   HUD_TC_COUNTER_MAP_COPIED_BYTES,
+};
+
 struct hud_context {
    int refcount;
    bool simple;
@@ -58,6 +65,10 @@ struct hud_context {
 
    struct util_queue_monitoring *monitored_queue;
 
+   /* GALLIUM_HUD_DUMP_CSV: every graph value as "time_us,graph,value" */
+   FILE *dump_csv;
+   int64_t dump_csv_start;
+
    /* states */
    struct pipe_blend_state no_blend, alpha_blend;
    struct pipe_depth_stencil_alpha_state dsa;
@@ -165,6 +176,7 @@ void hud_cpu_graph_install(struct hud_pane *pane, unsigned cpu_index);
 void hud_thread_busy_install(struct hud_pane *pane, const char *name, bool main);
 void hud_thread_counter_install(struct hud_pane *pane, const char *name,
                                 enum hud_counter counter);
+bool hud_tc_counter_install(struct hud_pane *pane, const char *name);
 void hud_pipe_query_install(struct hud_batch_query_context **pbq,
                             struct hud_pane *pane,
                             const char *name,
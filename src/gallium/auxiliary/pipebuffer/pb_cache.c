@@ -27,10 +27,24 @@
  **************************************************************************/
 
 #include "pb_cache.h"
+#include "util/u_math.h"
 #include "util/u_memory.h"
 #include "util/os_time.h"
 
 
+static unsigned
+pb_cache_size_class(pb_size size)
+{
+   return MIN2(util_logbase2_64(MAX2(size, 1)), PB_CACHE_SIZE_CLASSES - 1);
+}
+
+static struct list_head *
+pb_cache_get_list(struct pb_cache *mgr, unsigned bucket_index, unsigned size_class)
+{
+   return &mgr->buckets[bucket_index * PB_CACHE_SIZE_CLASSES + size_class];
+}
+
+
 /**
  * Actually destroy the buffer.
  */
@@ -43,6 +57,7 @@ destroy_buffer_locked(struct pb_cache_entry *entry)
    assert(!pipe_is_referenced(&buf->reference));
    if (list_is_linked(&entry->head)) {
       list_del(&entry->head);
+      list_del(&entry->lru);
       assert(mgr->num_buffers);
       --mgr->num_buffers;
       mgr->cache_size -= buf->size;
@@ -51,27 +66,16 @@ destroy_buffer_locked(struct pb_cache_entry *entry)
 }
 
 /**
- * Free as many cache buffers from the list head as possible.
+ * Free as many cache buffers from the head of the age list as possible.
  */
 static void
-release_expired_buffers_locked(struct list_head *cache,
-                               int64_t current_time)
+release_expired_buffers_locked(struct pb_cache *mgr, int64_t current_time)
 {
-   struct list_head *curr, *next;
-   struct pb_cache_entry *entry;
-
-   curr = cache->next;
-   next = curr->next;
-   while (curr != cache) {
-      entry = list_entry(curr, struct pb_cache_entry, head);
-
+   list_for_each_entry_safe(struct pb_cache_entry, entry, &mgr->lru, lru) {
       if (!os_time_timeout(entry->start, entry->end, current_time))
          break;
 
       destroy_buffer_locked(entry);
-
-      curr = next;
-      next = curr->next;
    }
 }
 
@@ -83,17 +87,16 @@ void
 pb_cache_add_buffer(struct pb_cache_entry *entry)
 {
    struct pb_cache *mgr = entry->mgr;
-   struct list_head *cache = &mgr->buckets[entry->bucket_index];
    struct pb_buffer *buf = entry->buffer;
-   unsigned i;
+   struct list_head *cache =
+      pb_cache_get_list(mgr, entry->bucket_index, pb_cache_size_class(buf->size));
 
    simple_mtx_lock(&mgr->mutex);
    assert(!pipe_is_referenced(&buf->reference));
 
    int64_t current_time = os_time_get();
 
-   for (i = 0; i < mgr->num_heaps; i++)
-      release_expired_buffers_locked(&mgr->buckets[i], current_time);
+   release_expired_buffers_locked(mgr, current_time);
 
    /* Directly release any buffer that exceeds the limit. */
    if (mgr->cache_size + buf->size > mgr->max_cache_size) {
@@ -102,9 +105,10 @@ pb_cache_add_buffer(struct pb_cache_entry *entry)
       return;
    }
 
-   entry->start = os_time_get();
+   entry->start = current_time;
    entry->end = entry->start + mgr->usecs;
    list_addtail(&entry->head, cache);
+   list_addtail(&entry->lru, &mgr->lru);
    ++mgr->num_buffers;
    mgr->cache_size += buf->size;
    simple_mtx_unlock(&mgr->mutex);
@@ -148,58 +152,32 @@ pb_cache_reclaim_buffer(struct pb_cache *mgr, pb_size size,
                         unsigned alignment, unsigned usage,
                         unsigned bucket_index)
 {
-   struct pb_cache_entry *entry;
-   struct pb_cache_entry *cur_entry;
-   struct list_head *cur, *next;
-   int64_t now;
-   int ret = 0;
+   struct pb_cache_entry *entry = NULL;
 
    assert(bucket_index < mgr->num_heaps);
-   struct list_head *cache = &mgr->buckets[bucket_index];
 
-   simple_mtx_lock(&mgr->mutex);
+   /* Buffers up to size_factor times bigger than requested are hits. */
+   unsigned first_class = pb_cache_size_class(size);
+   unsigned last_class = pb_cache_size_class((pb_size)(mgr->size_factor * size));
 
-   entry = NULL;
-   cur = cache->next;
-   next = cur->next;
-
-   /* search in the expired buffers, freeing them in the process */
-   now = os_time_get();
-   while (cur != cache) {
-      cur_entry = list_entry(cur, struct pb_cache_entry, head);
-
-      if (!entry && (ret = pb_cache_is_buffer_compat(cur_entry, size,
-                                                     alignment, usage)) > 0)
-         entry = cur_entry;
-      else if (os_time_timeout(cur_entry->start, cur_entry->end, now))
-         destroy_buffer_locked(cur_entry);
-      else
-         /* This buffer (and all hereafter) are still hot in cache */
-         break;
+   simple_mtx_lock(&mgr->mutex);
 
-      /* the buffer is busy (and probably all remaining ones too) */
-      if (ret == -1)
-         break;
+   release_expired_buffers_locked(mgr, os_time_get());
 
-      cur = next;
-      next = cur->next;
-   }
+   for (unsigned c = first_class; c <= last_class && !entry; c++) {
+      struct list_head *cache = pb_cache_get_list(mgr, bucket_index, c);
 
-   /* keep searching in the hot buffers */
-   if (!entry && ret != -1) {
-      while (cur != cache) {
-         cur_entry = list_entry(cur, struct pb_cache_entry, head);
-         ret = pb_cache_is_buffer_compat(cur_entry, size, alignment, usage);
+      list_for_each_entry(struct pb_cache_entry, cur_entry, cache, head) {
+         int ret = pb_cache_is_buffer_compat(cur_entry, size, alignment, usage);
 
          if (ret > 0) {
             entry = cur_entry;
             break;
          }
+
+         /* the buffer is busy (and probably all remaining ones too) */
          if (ret == -1)
             break;
-         /* no need to check the timeout here */
-         cur = next;
-         next = cur->next;
       }
    }
 
@@ -209,6 +187,7 @@ pb_cache_reclaim_buffer(struct pb_cache *mgr, pb_size size,
 
       mgr->cache_size -= buf->size;
       list_del(&entry->head);
+      list_del(&entry->lru);
       --mgr->num_buffers;
       simple_mtx_unlock(&mgr->mutex);
       /* Increase refcount */
@@ -226,23 +205,9 @@ pb_cache_reclaim_buffer(struct pb_cache *mgr, pb_size size,
 void
 pb_cache_release_all_buffers(struct pb_cache *mgr)
 {
-   struct list_head *curr, *next;
-   struct pb_cache_entry *buf;
-   unsigned i;
-
    simple_mtx_lock(&mgr->mutex);
-   for (i = 0; i < mgr->num_heaps; i++) {
-      struct list_head *cache = &mgr->buckets[i];
-
-      curr = cache->next;
-      next = curr->next;
-      while (curr != cache) {
-         buf = list_entry(curr, struct pb_cache_entry, head);
-         destroy_buffer_locked(buf);
-         curr = next;
-         next = curr->next;
-      }
-   }
+   list_for_each_entry_safe(struct pb_cache_entry, entry, &mgr->lru, lru)
+      destroy_buffer_locked(entry);
    simple_mtx_unlock(&mgr->mutex);
 }
 
@@ -286,12 +251,14 @@ pb_cache_init(struct pb_cache *mgr, uint num_heaps,
 {
    unsigned i;
 
-   mgr->buckets = CALLOC(num_heaps, sizeof(struct list_head));
+   mgr->buckets = CALLOC(num_heaps * PB_CACHE_SIZE_CLASSES,
+                         sizeof(struct list_head));
    if (!mgr->buckets)
       return;
 
-   for (i = 0; i < num_heaps; i++)
+   for (i = 0; i < num_heaps * PB_CACHE_SIZE_CLASSES; i++)
       list_inithead(&mgr->buckets[i]);
+   list_inithead(&mgr->lru);
 
    (void) simple_mtx_init(&mgr->mutex, mtx_plain);
    mgr->winsys = winsys;
@@ -34,12 +34,19 @@
 #include "util/list.h"
 #include "os/os_thread.h"
 
+/**
+ * Each bucket is split into lists of buffers with the same log2 size, so
+ * that reclaiming only has to look at buffers of a matching size.
+ */
+#define PB_CACHE_SIZE_CLASSES 32
+
 /**
  * Statically inserted into the driver-specific buffer structure.
  */
 struct pb_cache_entry
 {
-   struct list_head head;
+   struct list_head head; /**< Link in the size class list */
+   struct list_head lru;  /**< Link in the cache-wide age list */
    struct pb_buffer *buffer; /**< Pointer to the structure this is part of. */
    struct pb_cache *mgr;
    int64_t start, end; /**< Caching time interval */
@@ -50,8 +57,11 @@ struct pb_cache
 {
    /* The cache is divided into buckets for minimizing cache misses.
     * The driver controls which buffer goes into which bucket.
+    * Each bucket has PB_CACHE_SIZE_CLASSES lists, oldest buffers first.
     */
    struct list_head *buckets;
+   /* All cached buffers, oldest first, for expiring them. */
+   struct list_head lru;
 
    simple_mtx_t mutex;
    void *winsys;
@@ -27,6 +27,7 @@
 
 #include "pb_slab.h"
 
+#include "util/u_atomic.h"
 #include "util/u_math.h"
 #include "util/u_memory.h"
 
@@ -71,6 +72,31 @@ pb_slab_reclaim(struct pb_slabs *slabs, struct pb_slab_entry *entry)
    }
 }
 
+/* Move the entries freed since the last call to the reclaim list, keeping
+ * it ordered from least to most recently freed.
+ */
+static void
+pb_slabs_take_deferred_locked(struct pb_slabs *slabs)
+{
+   struct pb_slab_entry *deferred = p_atomic_read(&slabs->deferred);
+
+   while (deferred) {
+      struct pb_slab_entry *prev =
+         p_atomic_cmpxchg_ptr(&slabs->deferred, deferred, NULL);
+      if (prev == deferred)
+         break;
+      deferred = prev;
+   }
+
+   struct list_head *pos = &slabs->reclaim;
+   while (deferred) {
+      /* Insert each older entry before the newer one. */
+      list_addtail(&deferred->head, pos);
+      pos = &deferred->head;
+      deferred = deferred->deferred_next;
+   }
+}
+
 #define MAX_FAILED_RECLAIMS 2
 
 static void
@@ -78,6 +104,8 @@ pb_slabs_reclaim_locked(struct pb_slabs *slabs)
 {
    struct pb_slab_entry *entry, *next;
    unsigned num_failed_reclaims = 0;
+
+   pb_slabs_take_deferred_locked(slabs);
    LIST_FOR_EACH_ENTRY_SAFE(entry, next, &slabs->reclaim, head) {
       if (slabs->can_reclaim(slabs->priv, entry)) {
          pb_slab_reclaim(slabs, entry);
@@ -99,6 +127,9 @@ static void
 pb_slabs_reclaim_all_locked(struct pb_slabs *slabs)
 {
    struct pb_slab_entry *entry, *next;
+
+   pb_slabs_take_deferred_locked(slabs);
+
    LIST_FOR_EACH_ENTRY_SAFE(entry, next, &slabs->reclaim, head) {
       if (slabs->can_reclaim(slabs->priv, entry)) {
          pb_slab_reclaim(slabs, entry);
@@ -200,13 +231,24 @@ pb_slab_alloc(struct pb_slabs *slabs, unsigned size, unsigned heap)
  * The entry may still be in use e.g. by in-flight command submissions. The
  * can_reclaim callback function will be called to determine whether the entry
  * can be handed out again by pb_slab_alloc.
+ *
+ * This doesn't take the mutex; the entry is pushed to a lock-free list that
+ * is only looked at when entries are reclaimed.
  */
 void
 pb_slab_free(struct pb_slabs* slabs, struct pb_slab_entry *entry)
 {
-   simple_mtx_lock(&slabs->mutex);
-   list_addtail(&entry->head, &slabs->reclaim);
-   simple_mtx_unlock(&slabs->mutex);
+   struct pb_slab_entry *head = p_atomic_read(&slabs->deferred);
+
+   while (true) {
+      entry->deferred_next = head;
+
+      struct pb_slab_entry *prev =
+         p_atomic_cmpxchg_ptr(&slabs->deferred, head, entry);
+      if (prev == head)
+         break;
+      head = prev;
+   }
 }
 
 /* Check if any of the entries handed to pb_slab_free are ready to be re-used.
@@ -256,6 +298,7 @@ pb_slabs_init(struct pb_slabs *slabs,
    slabs->slab_free = slab_free;
 
    list_inithead(&slabs->reclaim);
+   slabs->deferred = NULL;
 
    num_groups = slabs->num_orders * slabs->num_heaps *
                 (1 + allow_three_fourth_allocations);
@@ -285,6 +328,8 @@ pb_slabs_deinit(struct pb_slabs *slabs)
    /* Reclaim all slab entries (even those that are still in flight). This
     * implicitly calls slab_free for everything.
     */
+   pb_slabs_take_deferred_locked(slabs);
+
    while (!list_is_empty(&slabs->reclaim)) {
       struct pb_slab_entry *entry =
          list_entry(slabs->reclaim.next, struct pb_slab_entry, head);
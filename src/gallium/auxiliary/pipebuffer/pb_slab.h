@@ -61,6 +61,7 @@ struct pb_slab_group;
 struct pb_slab_entry
 {
    struct list_head head;
+   struct pb_slab_entry *deferred_next; /* link in pb_slabs::deferred */
    struct pb_slab *slab; /* the slab that contains this buffer */
    unsigned group_index; /* index into pb_slabs::groups */
    unsigned entry_size;
@@ -128,6 +129,12 @@ struct pb_slabs
     */
    struct list_head reclaim;
 
+   /* Entries passed to pb_slab_free that haven't been moved to the reclaim
+    * list yet, most-recently freed first. Pushed to without the mutex so
+    * that frees from other threads don't contend with allocations.
+    */
+   struct pb_slab_entry *deferred;
+
    void *priv;
    slab_can_reclaim_fn *can_reclaim;
    slab_alloc_fn *slab_alloc;
@@ -44,6 +44,12 @@ namespace pipe_tessellator_wrap
       alignas(32) float      domain_points_v[MAX_POINT_COUNT];
       uint32_t               num_domain_points;
 
+      /// Factors of the previous patch, whose output is still in the
+      /// buffers above.  Neighbouring patches very often share factors.
+      float                  last_outer_tf[4];
+      float                  last_inner_tf[2];
+      bool                   have_last;
+
    public:
       void Init(enum pipe_prim_type tes_prim_mode,
                 enum pipe_tess_spacing ts_spacing,
@@ -70,11 +76,19 @@ namespace pipe_tessellator_wrap
 
          prim_mode          = tes_prim_mode;
          num_domain_points = 0;
+         have_last = false;
       }
 
       void Tessellate(const struct pipe_tessellation_factors *tess_factors,
                       struct pipe_tessellator_data *tess_data)
       {
+         if (have_last &&
+             memcmp(last_outer_tf, tess_factors->outer_tf, sizeof(last_outer_tf)) == 0 &&
+             memcmp(last_inner_tf, tess_factors->inner_tf, sizeof(last_inner_tf)) == 0) {
+            FillData(tess_data);
+            return;
+         }
+
          switch (prim_mode)
             {
             case PIPE_PRIM_QUADS:
@@ -113,6 +127,17 @@ namespace pipe_tessellator_wrap
             domain_points_u[i] = points[i].u;
             domain_points_v[i] = points[i].v;
          }
+
+         memcpy(last_outer_tf, tess_factors->outer_tf, sizeof(last_outer_tf));
+         memcpy(last_inner_tf, tess_factors->inner_tf, sizeof(last_inner_tf));
+         have_last = true;
+
+         FillData(tess_data);
+      }
+
+   private:
+      void FillData(struct pipe_tessellator_data *tess_data)
+      {
          tess_data->num_domain_points = num_domain_points;
          tess_data->domain_points_u = &domain_points_u[0];
          tess_data->domain_points_v = &domain_points_v[0];
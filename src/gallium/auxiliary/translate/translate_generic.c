@@ -40,6 +40,9 @@
 
 #define DRAW_DBG 0
 
+/* vertices converted per attribute at a time by linear runs */
+#define GENERIC_RUN_CHUNK 64
+
 typedef void (*emit_func)(const void *attrib, void *ptr);
 
 
@@ -73,6 +76,11 @@ struct translate_generic {
        */
       int copy_size;
 
+      /* size of a single element in the input buffer, used to fetch runs
+       * of tightly packed vertices at once
+       */
+      unsigned input_size;
+
    } attrib[TRANSLATE_MAX_ATTRIBS];
 
    unsigned nr_attrib;
@@ -584,6 +592,66 @@ get_emit_func(enum pipe_format format)
    }
 }
 
+static ALWAYS_INLINE void
+generic_run_attr(struct translate_generic *tg,
+                 unsigned attr,
+                 unsigned elt,
+                 unsigned start_instance,
+                 unsigned instance_id,
+                 void *vert)
+{
+   float data[4];
+   uint8_t *dst = (uint8_t *)vert + tg->attrib[attr].output_offset;
+
+   if (tg->attrib[attr].type == TRANSLATE_ELEMENT_NORMAL) {
+      const uint8_t *src;
+      unsigned index;
+      int copy_size;
+
+      if (tg->attrib[attr].instance_divisor) {
+         index = start_instance;
+         index += (instance_id  / tg->attrib[attr].instance_divisor);
+         /* XXX we need to clamp the index here too, but to a
+          * per-array max value, not the draw->pt.max_index value
+          * that's being given to us via translate->set_buffer().
+          */
+      }
+      else {
+         index = elt;
+         /* clamp to avoid going out of bounds */
+         index = MIN2(index, tg->attrib[attr].max_index);
+      }
+
+      src = tg->attrib[attr].input_ptr +
+            (ptrdiff_t)tg->attrib[attr].input_stride * index;
+
+      copy_size = tg->attrib[attr].copy_size;
+      if (likely(copy_size >= 0)) {
+         memcpy(dst, src, copy_size);
+      } else {
+         tg->attrib[attr].fetch(data, src, 1);
+
+         if (0)
+            debug_printf("Fetch linear attr %d  from %p  stride %d  index %d: "
+                      " %f, %f, %f, %f \n",
+                      attr,
+                      tg->attrib[attr].input_ptr,
+                      tg->attrib[attr].input_stride,
+                      index,
+                      data[0], data[1],data[2], data[3]);
+
+         tg->attrib[attr].emit(data, dst);
+      }
+   } else {
+      if (likely(tg->attrib[attr].copy_size >= 0)) {
+         memcpy(dst, &instance_id, 4);
+      } else {
+         data[0] = (float)instance_id;
+         tg->attrib[attr].emit(data, dst);
+      }
+   }
+}
+
 static ALWAYS_INLINE void PIPE_CDECL
 generic_run_one(struct translate_generic *tg,
                 unsigned elt,
@@ -594,58 +662,8 @@ generic_run_one(struct translate_generic *tg,
    unsigned nr_attrs = tg->nr_attrib;
    unsigned attr;
 
-   for (attr = 0; attr < nr_attrs; attr++) {
-      float data[4];
-      uint8_t *dst = (uint8_t *)vert + tg->attrib[attr].output_offset;
-
-      if (tg->attrib[attr].type == TRANSLATE_ELEMENT_NORMAL) {
-         const uint8_t *src;
-         unsigned index;
-         int copy_size;
-
-         if (tg->attrib[attr].instance_divisor) {
-            index = start_instance;
-            index += (instance_id  / tg->attrib[attr].instance_divisor);
-            /* XXX we need to clamp the index here too, but to a
-             * per-array max value, not the draw->pt.max_index value
-             * that's being given to us via translate->set_buffer().
-             */
-         }
-         else {
-            index = elt;
-            /* clamp to avoid going out of bounds */
-            index = MIN2(index, tg->attrib[attr].max_index);
-         }
-
-         src = tg->attrib[attr].input_ptr +
-               (ptrdiff_t)tg->attrib[attr].input_stride * index;
-
-         copy_size = tg->attrib[attr].copy_size;
-         if (likely(copy_size >= 0)) {
-            memcpy(dst, src, copy_size);
-         } else {
-            tg->attrib[attr].fetch(data, src, 1);
-
-            if (0)
-               debug_printf("Fetch linear attr %d  from %p  stride %d  index %d: "
-                         " %f, %f, %f, %f \n",
-                         attr,
-                         tg->attrib[attr].input_ptr,
-                         tg->attrib[attr].input_stride,
-                         index,
-                         data[0], data[1],data[2], data[3]);
-
-            tg->attrib[attr].emit(data, dst);
-         }
-      } else {
-         if (likely(tg->attrib[attr].copy_size >= 0)) {
-            memcpy(data, &instance_id, 4);
-         } else {
-            data[0] = (float)instance_id;
-            tg->attrib[attr].emit(data, dst);
-         }
-      }
-   }
+   for (attr = 0; attr < nr_attrs; attr++)
+      generic_run_attr(tg, attr, elt, start_instance, instance_id, vert);
 }
 
 /**
@@ -714,12 +732,39 @@ generic_run(struct translate *translate,
             void *output_buffer)
 {
    struct translate_generic *tg = translate_generic(translate);
-   char *vert = output_buffer;
-   unsigned i;
+   const unsigned output_stride = tg->translate.key.output_stride;
+   float data[GENERIC_RUN_CHUNK][4];
 
-   for (i = 0; i < count; i++) {
-      generic_run_one(tg, start + i, start_instance, instance_id, vert);
-      vert += tg->translate.key.output_stride;
+   /* Go through the vertices in chunks, one attribute at a time, so that
+    * converted attributes which are tightly packed get unpacked with a
+    * single call for the whole chunk instead of one call per vertex.
+    */
+   for (unsigned base = 0; base < count; base += GENERIC_RUN_CHUNK) {
+      const unsigned n = MIN2(count - base, GENERIC_RUN_CHUNK);
+      char *vert = (char *)output_buffer + base * output_stride;
+
+      for (unsigned attr = 0; attr < tg->nr_attrib; attr++) {
+         if (tg->attrib[attr].type == TRANSLATE_ELEMENT_NORMAL &&
+             !tg->attrib[attr].instance_divisor &&
+             tg->attrib[attr].copy_size < 0 &&
+             tg->attrib[attr].input_stride == tg->attrib[attr].input_size &&
+             start + base + n - 1 >= start + base &&
+             start + base + n - 1 <= tg->attrib[attr].max_index) {
+            const uint8_t *src = tg->attrib[attr].input_ptr +
+               (ptrdiff_t)tg->attrib[attr].input_stride * (start + base);
+
+            tg->attrib[attr].fetch(data, src, n);
+            for (unsigned i = 0; i < n; i++) {
+               tg->attrib[attr].emit(data[i], vert + i * output_stride +
+                                     tg->attrib[attr].output_offset);
+            }
+         } else {
+            for (unsigned i = 0; i < n; i++) {
+               generic_run_attr(tg, attr, start + base + i, start_instance,
+                                instance_id, vert + i * output_stride);
+            }
+         }
+      }
    }
 }
 
@@ -818,6 +863,7 @@ translate_generic_create(const struct translate_key *key)
       tg->attrib[i].instance_divisor = key->element[i].instance_divisor;
 
       tg->attrib[i].output_offset = key->element[i].output_offset;
+      tg->attrib[i].input_size = format_desc->block.bits / 8;
 
       tg->attrib[i].copy_size = -1;
       if (tg->attrib[i].type == TRANSLATE_ELEMENT_INSTANCE_ID) {
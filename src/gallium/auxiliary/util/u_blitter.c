@@ -135,6 +135,9 @@ struct blitter_context_priv
    void *rs_state[2][2];  /**< [scissor][msaa] */
    void *rs_discard_state;
 
+   /* Whether the blitter bound its own stream output targets. */
+   bool so_targets_changed;
+
    /* Destination surface dimensions. */
    unsigned dst_width;
    unsigned dst_height;
@@ -659,27 +662,37 @@ void util_blitter_restore_vertex_states(struct blitter_context *blitter)
    pipe->bind_vs_state(pipe, ctx->base.saved_vs);
    ctx->base.saved_vs = INVALID_PTR;
 
+   /* The blitter only ever unbinds these, and it skips that when they were
+    * already unbound, so there is nothing to restore in that case.
+    */
+
    /* Geometry shader. */
    if (ctx->has_geometry_shader) {
-      pipe->bind_gs_state(pipe, ctx->base.saved_gs);
+      if (ctx->base.saved_gs)
+         pipe->bind_gs_state(pipe, ctx->base.saved_gs);
       ctx->base.saved_gs = INVALID_PTR;
    }
 
    if (ctx->has_tessellation) {
-      pipe->bind_tcs_state(pipe, ctx->base.saved_tcs);
-      pipe->bind_tes_state(pipe, ctx->base.saved_tes);
+      if (ctx->base.saved_tcs)
+         pipe->bind_tcs_state(pipe, ctx->base.saved_tcs);
+      if (ctx->base.saved_tes)
+         pipe->bind_tes_state(pipe, ctx->base.saved_tes);
       ctx->base.saved_tcs = INVALID_PTR;
       ctx->base.saved_tes = INVALID_PTR;
    }
 
    /* Stream outputs. */
    if (ctx->has_stream_out) {
-      unsigned offsets[PIPE_MAX_SO_BUFFERS];
-      for (i = 0; i < ctx->base.saved_num_so_targets; i++)
-         offsets[i] = (unsigned)-1;
-      pipe->set_stream_output_targets(pipe,
-                                      ctx->base.saved_num_so_targets,
-                                      ctx->base.saved_so_targets, offsets);
+      if (ctx->base.saved_num_so_targets || ctx->so_targets_changed) {
+         unsigned offsets[PIPE_MAX_SO_BUFFERS];
+         for (i = 0; i < ctx->base.saved_num_so_targets; i++)
+            offsets[i] = (unsigned)-1;
+         pipe->set_stream_output_targets(pipe,
+                                         ctx->base.saved_num_so_targets,
+                                         ctx->base.saved_so_targets, offsets);
+      }
+      ctx->so_targets_changed = false;
 
       for (i = 0; i < ctx->base.saved_num_so_targets; i++)
          pipe_so_target_reference(&ctx->base.saved_so_targets[i], NULL);
@@ -1382,13 +1395,16 @@ static void blitter_set_common_draw_rect_state(struct blitter_context_priv *ctx,
 
    pipe->bind_rasterizer_state(pipe, ctx->rs_state[scissor][msaa]);
 
-   if (ctx->has_geometry_shader)
+   /* Only unbind what is bound, restoring it is skipped the same way. */
+   if (ctx->has_geometry_shader && ctx->base.saved_gs)
       pipe->bind_gs_state(pipe, NULL);
    if (ctx->has_tessellation) {
-      pipe->bind_tcs_state(pipe, NULL);
-      pipe->bind_tes_state(pipe, NULL);
+      if (ctx->base.saved_tcs)
+         pipe->bind_tcs_state(pipe, NULL);
+      if (ctx->base.saved_tes)
+         pipe->bind_tes_state(pipe, NULL);
    }
-   if (ctx->has_stream_out)
+   if (ctx->has_stream_out && ctx->base.saved_num_so_targets)
       pipe->set_stream_output_targets(pipe, 0, NULL, NULL);
 }
 
@@ -2635,16 +2651,19 @@ void util_blitter_clear_buffer(struct blitter_context *blitter,
    pipe->bind_vertex_elements_state(pipe,
                                     ctx->velem_state_readbuf[num_channels-1]);
    bind_vs_pos_only(ctx, num_channels);
-   if (ctx->has_geometry_shader)
+   if (ctx->has_geometry_shader && ctx->base.saved_gs)
       pipe->bind_gs_state(pipe, NULL);
    if (ctx->has_tessellation) {
-      pipe->bind_tcs_state(pipe, NULL);
-      pipe->bind_tes_state(pipe, NULL);
+      if (ctx->base.saved_tcs)
+         pipe->bind_tcs_state(pipe, NULL);
+      if (ctx->base.saved_tes)
+         pipe->bind_tes_state(pipe, NULL);
    }
    pipe->bind_rasterizer_state(pipe, ctx->rs_discard_state);
 
    so_target = pipe->create_stream_output_target(pipe, dst, offset, size);
    pipe->set_stream_output_targets(pipe, 1, &so_target, offsets);
+   ctx->so_targets_changed = true;
 
    util_draw_arrays(pipe, PIPE_PRIM_POINTS, 0, size / 4);
 
@@ -23,6 +23,7 @@
 #include "pipe/p_context.h"
 #include "util/u_index_modify.h"
 #include "util/u_inlines.h"
+#include "util/u_sse.h"
 
 /* Ubyte indices. */
 
@@ -49,7 +50,26 @@ void util_shorten_ubyte_elts_to_userptr(struct pipe_context *context,
     }
     in_map += start;
 
-    for (i = 0; i < count; i++) {
+    i = 0;
+#if defined(PIPE_ARCH_SSE)
+    {
+        /* Widen 16 indices at a time, the bias wraps the same way as below. */
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i bias = _mm_set1_epi16((short)index_bias);
+
+        for (; i + 16 <= count; i += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i *)in_map);
+            __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(v, zero), bias);
+            __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(v, zero), bias);
+            _mm_storeu_si128((__m128i *)out_map, lo);
+            _mm_storeu_si128((__m128i *)(out_map + 8), hi);
+            in_map += 16;
+            out_map += 16;
+        }
+    }
+#endif
+
+    for (; i < count; i++) {
         *out_map = (unsigned short)(*in_map + index_bias);
         in_map++;
         out_map++;
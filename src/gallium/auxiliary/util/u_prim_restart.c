@@ -29,6 +29,7 @@
 #include "util/u_memory.h"
 #include "u_prim_restart.h"
 #include "u_prim.h"
+#include "u_sse.h"
 
 typedef struct {
   uint32_t count;
@@ -142,6 +143,60 @@ add_range(enum pipe_prim_type mode, struct range_info *info, unsigned start, uns
    return TRUE;
 }
 
+/**
+ * Return the position of the first restart index in [start, count), or count
+ * if there is none.  Restart indices are usually rare, so skip over whole
+ * vectors of indices without one.
+ */
+#if defined(PIPE_ARCH_SSE)
+#define FIND_RESTART(TYPE, CMPEQ, SET1) \
+static inline unsigned \
+find_restart_##TYPE(const void *map, unsigned start, unsigned count, \
+                    unsigned restart_index) \
+{ \
+   const TYPE *indices = map; \
+   const unsigned per_vec = 16 / sizeof(TYPE); \
+   const __m128i restart = SET1((TYPE)restart_index); \
+   unsigned i = start; \
+ \
+   if (restart_index != (TYPE)restart_index) \
+      return count; \
+ \
+   for (; i + per_vec <= count; i += per_vec) { \
+      __m128i v = _mm_loadu_si128((const __m128i *)(indices + i)); \
+      int mask = _mm_movemask_epi8(CMPEQ(v, restart)); \
+      if (mask) \
+         return i + (ffs(mask) - 1) / sizeof(TYPE); \
+   } \
+   for (; i < count; i++) { \
+      if (indices[i] == restart_index) \
+         return i; \
+   } \
+   return count; \
+}
+
+FIND_RESTART(uint8_t, _mm_cmpeq_epi8, _mm_set1_epi8)
+FIND_RESTART(uint16_t, _mm_cmpeq_epi16, _mm_set1_epi16)
+FIND_RESTART(uint32_t, _mm_cmpeq_epi32, _mm_set1_epi32)
+#else
+#define FIND_RESTART(TYPE) \
+static inline unsigned \
+find_restart_##TYPE(const void *map, unsigned start, unsigned count, \
+                    unsigned restart_index) \
+{ \
+   const TYPE *indices = map; \
+   for (unsigned i = start; i < count; i++) { \
+      if (indices[i] == restart_index) \
+         return i; \
+   } \
+   return count; \
+}
+
+FIND_RESTART(uint8_t)
+FIND_RESTART(uint16_t)
+FIND_RESTART(uint32_t)
+#endif
+
 struct pipe_draw_start_count_bias *
 util_prim_restart_convert_to_direct(const void *index_map,
                                     const struct pipe_draw_info *info,
@@ -152,32 +207,22 @@ util_prim_restart_convert_to_direct(const void *index_map,
                                     unsigned *total_index_count)
 {
    struct range_info ranges = { .min_index = UINT32_MAX, 0 };
-   unsigned i, start, count;
+   unsigned i, start;
    ranges.min_index = UINT32_MAX;
 
    assert(info->index_size);
    assert(info->primitive_restart);
 
 #define SCAN_INDEXES(TYPE) \
-   for (i = 0; i <= draw->count; i++) { \
-      if (i == draw->count || \
-          ((const TYPE *) index_map)[i] == info->restart_index) { \
-         /* cut / restart */ \
-         if (count > 0) { \
-            if (!add_range(info->mode, &ranges, draw->start + start, count, draw->index_bias)) { \
-               return NULL; \
-            } \
+   for (start = 0; start <= draw->count; start = i + 1) { \
+      i = find_restart_##TYPE(index_map, start, draw->count, info->restart_index); \
+      if (i > start) { \
+         if (!add_range(info->mode, &ranges, draw->start + start, i - start, draw->index_bias)) { \
+            return NULL; \
          } \
-         start = i + 1; \
-         count = 0; \
-      } \
-      else { \
-         count++; \
       } \
    }
 
-   start = 0;
-   count = 0;
    switch (info->index_size) {
    case 1:
       SCAN_INDEXES(uint8_t);
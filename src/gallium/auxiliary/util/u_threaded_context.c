@@ -30,6 +30,7 @@
 #include "util/u_inlines.h"
 #include "util/u_memory.h"
 #include "util/u_upload_mgr.h"
+#include "util/os_time.h"
 #include "driver_trace/tr_context.h"
 #include "util/log.h"
 #include "util/perf/cpu_trace.h"
@@ -60,13 +61,21 @@ enum tc_call_id {
    TC_NUM_CALLS,
 };
 
-#if TC_DEBUG >= 3 || defined(TC_TRACE)
 static const char *tc_call_names[] = {
 #define CALL(name) #name,
 #include "u_threaded_context_calls.h"
 #undef CALL
 };
-#endif
+
+static const char *tc_sync_reason_names[] = {
+   [TC_SYNC_FLUSH] = "flush",
+   [TC_SYNC_QUERY] = "query",
+   [TC_SYNC_BUFFER_MAP] = "buffer-map",
+   [TC_SYNC_TEXTURE_MAP] = "texture-map",
+   [TC_SYNC_TEXTURE_SUBDATA] = "texture-subdata",
+   [TC_SYNC_FENCE] = "fence",
+   [TC_SYNC_OTHER] = "other",
+};
 
 #ifdef TC_TRACE
 #  define TC_TRACE_SCOPE(call_id) MESA_TRACE_SCOPE(tc_call_names[call_id])
@@ -88,7 +97,7 @@ static void
 tc_batch_check(UNUSED struct tc_batch *batch)
 {
    tc_assert(batch->sentinel == TC_SENTINEL);
-   tc_assert(batch->num_total_slots <= TC_SLOTS_PER_BATCH);
+   tc_assert(batch->num_total_slots <= TC_MAX_SLOTS_PER_BATCH);
 }
 
 static void
@@ -309,7 +318,15 @@ batch_execute(struct tc_batch *batch, struct pipe_context *pipe, uint64_t *last,
 
       TC_TRACE_SCOPE(call->call_id);
 
-      iter += execute_func[call->call_id](pipe, call, last);
+      if (unlikely(batch->tc->profile_calls)) {
+         unsigned call_id = call->call_id;
+         int64_t start = os_time_get_nano();
+
+         iter += execute_func[call_id](pipe, call, last);
+         batch->tc->call_stats[call_id].exec_time_ns += os_time_get_nano() - start;
+      } else {
+         iter += execute_func[call->call_id](pipe, call, last);
+      }
 
       if (parsing) {
          if (call->call_id == TC_CALL_flush) {
@@ -347,6 +364,11 @@ tc_batch_execute(void *job, UNUSED void *gdata, int thread_index)
 
    assert(!batch->token);
 
+   /* Running average of the time batches wait for the driver thread. */
+   int64_t latency = os_time_get_nano() - batch->flush_time;
+   p_atomic_set(&batch->tc->batch_latency,
+                (p_atomic_read(&batch->tc->batch_latency) * 7 + latency) / 8);
+
    /* setup renderpass info */
    batch->tc->renderpass_info = batch->renderpass_infos.data;
 
@@ -420,6 +442,7 @@ tc_batch_flush(struct threaded_context *tc, bool full_copy)
    /* reset renderpass info index for subsequent use */
    next->renderpass_info_idx = -1;
 
+   next->flush_time = os_time_get_nano();
    util_queue_add_job(&tc->queue, next, &next->fence, tc_batch_execute,
                       NULL, 0);
    tc->last = tc->next;
@@ -435,6 +458,25 @@ tc_batch_flush(struct threaded_context *tc, bool full_copy)
    }
 }
 
+/* Adapt the batch size when a batch is flushed because it's full.
+ *
+ * If the driver thread is already done with the previous batch, it's idle
+ * and each flush costs a wakeup, so make batches larger. If batches wait in
+ * the queue for too long, the driver thread is behind, and large batches
+ * only delay the start of their execution, so make them smaller.
+ */
+static void
+tc_update_batch_slot_limit(struct threaded_context *tc)
+{
+   if (util_queue_fence_is_signalled(&tc->batch_slots[tc->last].fence)) {
+      tc->batch_slot_limit = MIN2(tc->batch_slot_limit + TC_SLOTS_PER_BATCH,
+                                  TC_MAX_SLOTS_PER_BATCH);
+   } else if (p_atomic_read(&tc->batch_latency) > TC_MAX_BATCH_LATENCY_NS) {
+      tc->batch_slot_limit = MAX2(tc->batch_slot_limit - TC_SLOTS_PER_BATCH,
+                                  TC_SLOTS_PER_BATCH);
+   }
+}
+
 /* This is the function that adds variable-sized calls into the current
  * batch. It also flushes the batch if there is not enough space there.
  * All other higher-level "add" functions use it.
@@ -448,7 +490,8 @@ tc_add_sized_call(struct threaded_context *tc, enum tc_call_id id,
    assert(num_slots <= TC_SLOTS_PER_BATCH);
    tc_debug_check(tc);
 
-   if (unlikely(next->num_total_slots + num_slots > TC_SLOTS_PER_BATCH)) {
+   if (unlikely(next->num_total_slots + num_slots > tc->batch_slot_limit)) {
+      tc_update_batch_slot_limit(tc);
       /* copy existing renderpass info during flush */
       tc_batch_flush(tc, true);
       next = &tc->batch_slots[tc->next];
@@ -469,6 +512,7 @@ tc_add_sized_call(struct threaded_context *tc, enum tc_call_id id,
 
 #if TC_DEBUG >= 3
    tc_printf("ENQUEUE: %s", tc_call_names[id]);
+   tc->call_stats[id].num_calls++;
 #endif
 
    tc_debug_check(tc);
@@ -514,7 +558,7 @@ tc_enlarge_last_mergeable_call(struct threaded_context *tc, unsigned desired_num
 
    unsigned added_slots = desired_num_slots - call->num_slots;
 
-   if (unlikely(batch->num_total_slots + added_slots > TC_SLOTS_PER_BATCH))
+   if (unlikely(batch->num_total_slots + added_slots > tc->batch_slot_limit))
       return false;
 
    batch->num_total_slots += added_slots;
@@ -543,7 +587,8 @@ tc_is_sync(struct threaded_context *tc)
 }
 
 static void
-_tc_sync(struct threaded_context *tc, UNUSED const char *info, UNUSED const char *func)
+_tc_sync(struct threaded_context *tc, enum tc_sync_reason reason,
+         UNUSED const char *info, UNUSED const char *func)
 {
    struct tc_batch *last = &tc->batch_slots[tc->last];
    struct tc_batch *next = &tc->batch_slots[tc->next];
@@ -579,6 +624,7 @@ _tc_sync(struct threaded_context *tc, UNUSED const char *info, UNUSED const char
 
    if (synced) {
       p_atomic_inc(&tc->num_syncs);
+      tc->num_syncs_per_reason[reason]++;
 
       if (tc_strcmp(func, "tc_destroy") != 0) {
          tc_printf("sync %s %s", func, info);
@@ -601,8 +647,8 @@ _tc_sync(struct threaded_context *tc, UNUSED const char *info, UNUSED const char
    MESA_TRACE_END();
 }
 
-#define tc_sync(tc) _tc_sync(tc, "", __func__)
-#define tc_sync_msg(tc, info) _tc_sync(tc, info, __func__)
+#define tc_sync(tc, reason) _tc_sync(tc, reason, "", __func__)
+#define tc_sync_msg(tc, reason, info) _tc_sync(tc, reason, info, __func__)
 
 /**
  * Call this from fence_finish for same-context fence waits of deferred fences
@@ -628,7 +674,7 @@ threaded_context_flush(struct pipe_context *_pipe,
       if (prefer_async || !util_queue_fence_is_signalled(&last->fence))
          tc_batch_flush(tc, false);
       else
-         tc_sync(token->tc);
+         tc_sync(token->tc, TC_SYNC_FLUSH);
    }
 }
 
@@ -975,7 +1021,7 @@ threaded_context_unwrap_sync(struct pipe_context *pipe)
    if (!pipe || !pipe->priv)
       return pipe;
 
-   tc_sync(threaded_context(pipe));
+   tc_sync(threaded_context(pipe), TC_SYNC_OTHER);
    return (struct pipe_context*)pipe->priv;
 }
 
@@ -1135,7 +1181,7 @@ tc_get_query_result(struct pipe_context *_pipe,
    bool flushed = tq->flushed;
 
    if (!flushed) {
-      tc_sync_msg(tc, wait ? "wait" : "nowait");
+      tc_sync_msg(tc, TC_SYNC_QUERY, wait ? "wait" : "nowait");
       tc_set_driver_thread(tc);
    }
 
@@ -1501,6 +1547,20 @@ tc_call_set_constant_buffer(struct pipe_context *pipe, void *call, uint64_t *las
    return call_size(tc_constant_buffer);
 }
 
+static bool
+is_mergeable_constant_buffer(const struct tc_call_base *previous_call,
+                             enum pipe_shader_type shader, uint index)
+{
+   if (!previous_call || previous_call->call_id != TC_CALL_set_constant_buffer ||
+       previous_call->num_slots != call_size(tc_constant_buffer))
+      return false;
+
+   const struct tc_constant_buffer_base *base =
+      (const struct tc_constant_buffer_base *)previous_call;
+
+   return !base->is_null && base->shader == shader && base->index == index;
+}
+
 static void
 tc_set_constant_buffer(struct pipe_context *_pipe,
                        enum pipe_shader_type shader, uint index,
@@ -1537,8 +1597,21 @@ tc_set_constant_buffer(struct pipe_context *_pipe,
       offset = cb->buffer_offset;
    }
 
-   struct tc_constant_buffer *p =
-      tc_add_call(tc, TC_CALL_set_constant_buffer, tc_constant_buffer);
+   /* If the previous call set the same slot, nothing can have observed it,
+    * so overwrite it instead of adding another call. This is common when
+    * user constant buffers are updated repeatedly between draws.
+    */
+   struct tc_call_base *last_call = tc_get_last_mergeable_call(tc);
+   struct tc_constant_buffer *p;
+
+   if (is_mergeable_constant_buffer(last_call, shader, index)) {
+      p = (struct tc_constant_buffer *)last_call;
+      tc_drop_resource_reference(p->cb.buffer);
+   } else {
+      p = tc_add_call(tc, TC_CALL_set_constant_buffer, tc_constant_buffer);
+      tc_mark_call_mergeable(tc, &p->base.base);
+   }
+
    p->base.shader = shader;
    p->base.index = index;
    p->base.is_null = false;
@@ -2109,7 +2182,7 @@ tc_set_compute_resources(struct pipe_context *_pipe, unsigned start,
    struct threaded_context *tc = threaded_context(_pipe);
    struct pipe_context *pipe = tc->pipe;
 
-   tc_sync(tc);
+   tc_sync(tc, TC_SYNC_OTHER);
    pipe->set_compute_resources(pipe, start, count, resources);
 }
 
@@ -2121,7 +2194,7 @@ tc_set_global_binding(struct pipe_context *_pipe, unsigned first,
    struct threaded_context *tc = threaded_context(_pipe);
    struct pipe_context *pipe = tc->pipe;
 
-   tc_sync(tc);
+   tc_sync(tc, TC_SYNC_OTHER);
    pipe->set_global_binding(pipe, first, count, resources, handles);
 }
 
@@ -2218,7 +2291,7 @@ tc_create_texture_handle(struct pipe_context *_pipe,
    struct threaded_context *tc = threaded_context(_pipe);
    struct pipe_context *pipe = tc->pipe;
 
-   tc_sync(tc);
+   tc_sync(tc, TC_SYNC_OTHER);
    return pipe->create_texture_handle(pipe, view, state);
 }
 
@@ -2261,7 +2334,7 @@ tc_create_image_handle(struct pipe_context *_pipe,
    if (image->resource->target == PIPE_BUFFER)
       tc_buffer_disable_cpu_storage(image->resource);
 
-   tc_sync(tc);
+   tc_sync(tc, TC_SYNC_OTHER);
    return pipe->create_image_handle(pipe, image);
 }
 
@@ -2533,8 +2606,9 @@ tc_buffer_map(struct pipe_context *_pipe,
             unsigned valid_range_len = tres->valid_buffer_range.end - tres->valid_buffer_range.start;
             u_box_1d(tres->valid_buffer_range.start, valid_range_len, &box2);
 
-            tc_sync_msg(tc, "cpu storage GPU -> CPU copy");
+            tc_sync_msg(tc, TC_SYNC_BUFFER_MAP, "cpu storage GPU -> CPU copy");
             tc_set_driver_thread(tc);
+            tc->num_map_copied_bytes += valid_range_len;
 
             void *ret = pipe->buffer_map(pipe, tres->latest ? tres->latest : resource,
                                          0, PIPE_MAP_READ, &box2, &transfer2);
@@ -2591,6 +2665,7 @@ tc_buffer_map(struct pipe_context *_pipe,
       p_atomic_inc(&tres->pending_staging_uploads);
       util_range_add(resource, &tres->pending_staging_uploads_range,
                      box->x, box->x + box->width);
+      tc->num_map_copied_bytes += box->width;
 
       return map + (box->x % tc->map_buffer_alignment);
    }
@@ -2610,8 +2685,9 @@ tc_buffer_map(struct pipe_context *_pipe,
 
    /* Unsychronized buffer mappings don't have to synchronize the thread. */
    if (!(usage & TC_TRANSFER_MAP_THREADED_UNSYNC)) {
-      tc_sync_msg(tc, usage & PIPE_MAP_DISCARD_RANGE ? "  discard_range" :
-                      usage & PIPE_MAP_READ ? "  read" : "  staging conflict");
+      tc_sync_msg(tc, TC_SYNC_BUFFER_MAP,
+                  usage & PIPE_MAP_DISCARD_RANGE ? "  discard_range" :
+                  usage & PIPE_MAP_READ ? "  read" : "  staging conflict");
       tc_set_driver_thread(tc);
    }
 
@@ -2638,7 +2714,7 @@ tc_texture_map(struct pipe_context *_pipe,
    struct threaded_resource *tres = threaded_resource(resource);
    struct pipe_context *pipe = tc->pipe;
 
-   tc_sync_msg(tc, "texture");
+   tc_sync_msg(tc, TC_SYNC_TEXTURE_MAP, "texture");
    tc_set_driver_thread(tc);
 
    tc->bytes_mapped_estimate += box->width;
@@ -3084,7 +3160,7 @@ tc_texture_subdata(struct pipe_context *_pipe,
    } else {
       struct pipe_context *pipe = tc->pipe;
 
-      tc_sync(tc);
+      tc_sync(tc, TC_SYNC_TEXTURE_SUBDATA);
       tc_set_driver_thread(tc);
       pipe->texture_subdata(pipe, resource, level, usage, box, data,
                             stride, layer_stride);
@@ -3103,7 +3179,7 @@ tc_texture_subdata(struct pipe_context *_pipe,
    { \
       struct threaded_context *tc = threaded_context(_pipe); \
       struct pipe_context *pipe = tc->pipe; \
-      tc_sync(tc); \
+      tc_sync(tc, TC_SYNC_QUERY); \
       return pipe->func(pipe); \
    }
 
@@ -3117,7 +3193,7 @@ tc_get_sample_position(struct pipe_context *_pipe,
    struct threaded_context *tc = threaded_context(_pipe);
    struct pipe_context *pipe = tc->pipe;
 
-   tc_sync(tc);
+   tc_sync(tc, TC_SYNC_OTHER);
    pipe->get_sample_position(pipe, sample_count, sample_index,
                              out_value);
 }
@@ -3129,7 +3205,7 @@ tc_get_device_reset_status(struct pipe_context *_pipe)
    struct pipe_context *pipe = tc->pipe;
 
    if (!tc->options.unsynchronized_get_device_reset_status)
-      tc_sync(tc);
+      tc_sync(tc, TC_SYNC_OTHER);
 
    return pipe->get_device_reset_status(pipe);
 }
@@ -3141,7 +3217,7 @@ tc_set_device_reset_callback(struct pipe_context *_pipe,
    struct threaded_context *tc = threaded_context(_pipe);
    struct pipe_context *pipe = tc->pipe;
 
-   tc_sync(tc);
+   tc_sync(tc, TC_SYNC_OTHER);
    pipe->set_device_reset_callback(pipe, cb);
 }
 
@@ -3174,7 +3250,7 @@ tc_emit_string_marker(struct pipe_context *_pipe,
    } else {
       struct pipe_context *pipe = tc->pipe;
 
-      tc_sync(tc);
+      tc_sync(tc, TC_SYNC_OTHER);
       tc_set_driver_thread(tc);
       pipe->emit_string_marker(pipe, string, len);
       tc_clear_driver_thread(tc);
@@ -3188,7 +3264,7 @@ tc_dump_debug_state(struct pipe_context *_pipe, FILE *stream,
    struct threaded_context *tc = threaded_context(_pipe);
    struct pipe_context *pipe = tc->pipe;
 
-   tc_sync(tc);
+   tc_sync(tc, TC_SYNC_OTHER);
    pipe->dump_debug_state(pipe, stream, flags);
 }
 
@@ -3199,7 +3275,7 @@ tc_set_debug_callback(struct pipe_context *_pipe,
    struct threaded_context *tc = threaded_context(_pipe);
    struct pipe_context *pipe = tc->pipe;
 
-   tc_sync(tc);
+   tc_sync(tc, TC_SYNC_OTHER);
 
    /* Drop all synchronous debug callbacks. Drivers are expected to be OK
     * with this. shader-db will use an environment variable to disable
@@ -3217,7 +3293,7 @@ tc_set_log_context(struct pipe_context *_pipe, struct u_log_context *log)
    struct threaded_context *tc = threaded_context(_pipe);
    struct pipe_context *pipe = tc->pipe;
 
-   tc_sync(tc);
+   tc_sync(tc, TC_SYNC_OTHER);
    pipe->set_log_context(pipe, log);
 }
 
@@ -3230,7 +3306,7 @@ tc_create_fence_fd(struct pipe_context *_pipe,
    struct pipe_context *pipe = tc->pipe;
 
    if (!tc->options.unsynchronized_create_fence_fd)
-      tc_sync(tc);
+      tc_sync(tc, TC_SYNC_FENCE);
 
    pipe->create_fence_fd(pipe, fence, fd, type);
 }
@@ -3269,7 +3345,7 @@ tc_fence_server_signal(struct pipe_context *_pipe,
 {
    struct threaded_context *tc = threaded_context(_pipe);
    struct pipe_context *pipe = tc->pipe;
-   tc_sync(tc);
+   tc_sync(tc, TC_SYNC_FENCE);
    pipe->fence_server_signal(pipe, fence);
 }
 
@@ -3396,6 +3472,29 @@ tc_call_flush(struct pipe_context *pipe, void *call, uint64_t *last)
    return call_size(tc_flush_call);
 }
 
+/* Emit the cumulative sync statistics once per frame. */
+static void
+tc_trace_counters(struct threaded_context *tc)
+{
+   if (!util_perfetto_is_category_enabled(UTIL_PERFETTO_CATEGORY_DEFAULT))
+      return;
+
+   static const char *sync_counter_names[] = {
+      [TC_SYNC_FLUSH] = "tc syncs: flush",
+      [TC_SYNC_QUERY] = "tc syncs: query",
+      [TC_SYNC_BUFFER_MAP] = "tc syncs: buffer-map",
+      [TC_SYNC_TEXTURE_MAP] = "tc syncs: texture-map",
+      [TC_SYNC_TEXTURE_SUBDATA] = "tc syncs: texture-subdata",
+      [TC_SYNC_FENCE] = "tc syncs: fence",
+      [TC_SYNC_OTHER] = "tc syncs: other",
+   };
+
+   for (unsigned i = 0; i < TC_NUM_SYNC_REASONS; i++)
+      util_perfetto_counter_set(sync_counter_names[i], tc->num_syncs_per_reason[i]);
+
+   util_perfetto_counter_set("tc map copied bytes", tc->num_map_copied_bytes);
+}
+
 static void
 tc_flush(struct pipe_context *_pipe, struct pipe_fence_handle **fence,
          unsigned flags)
@@ -3407,6 +3506,9 @@ tc_flush(struct pipe_context *_pipe, struct pipe_fence_handle **fence,
 
    tc->in_renderpass = false;
 
+   if (flags & PIPE_FLUSH_END_OF_FRAME)
+      tc_trace_counters(tc);
+
    if (async && tc->options.create_fence) {
       if (fence) {
          struct tc_batch *next = &tc->batch_slots[tc->next];
@@ -3449,8 +3551,9 @@ tc_flush(struct pipe_context *_pipe, struct pipe_fence_handle **fence,
 
 out_of_memory:
    /* renderpass info is signaled during sync */
-   tc_sync_msg(tc, flags & PIPE_FLUSH_END_OF_FRAME ? "end of frame" :
-                   flags & PIPE_FLUSH_DEFERRED ? "deferred fence" : "normal");
+   tc_sync_msg(tc, TC_SYNC_FLUSH,
+               flags & PIPE_FLUSH_END_OF_FRAME ? "end of frame" :
+               flags & PIPE_FLUSH_DEFERRED ? "deferred fence" : "normal");
 
    if (!(flags & PIPE_FLUSH_DEFERRED)) {
       tc_flush_queries(tc);
@@ -3553,7 +3656,7 @@ tc_call_draw_single(struct pipe_context *pipe, void *call, uint64_t *last_ptr)
        next->base.call_id == TC_CALL_draw_single) {
       if (is_next_call_a_mergeable_draw(first, next)) {
          /* The maximum number of merged draws is given by the batch size. */
-         struct pipe_draw_start_count_bias multi[TC_SLOTS_PER_BATCH / call_size(tc_draw_single)];
+         struct pipe_draw_start_count_bias multi[TC_MAX_SLOTS_PER_BATCH / call_size(tc_draw_single)];
          unsigned num_draws = 2;
          bool index_bias_varies = first->index_bias != next->index_bias;
 
@@ -3807,10 +3910,10 @@ tc_draw_vbo(struct pipe_context *_pipe, const struct pipe_draw_info *info,
       while (num_draws) {
          struct tc_batch *next = &tc->batch_slots[tc->next];
 
-         int nb_slots_left = TC_SLOTS_PER_BATCH - next->num_total_slots;
+         int nb_slots_left = tc->batch_slot_limit - next->num_total_slots;
          /* If there isn't enough place for one draw, try to fill the next one */
          if (nb_slots_left < slots_for_one_draw)
-            nb_slots_left = TC_SLOTS_PER_BATCH;
+            nb_slots_left = tc->batch_slot_limit;
          const int size_left_bytes = nb_slots_left * sizeof(struct tc_call_base);
 
          /* How many draws can we fit in the current batch */
@@ -3860,10 +3963,10 @@ tc_draw_vbo(struct pipe_context *_pipe, const struct pipe_draw_info *info,
       while (num_draws) {
          struct tc_batch *next = &tc->batch_slots[tc->next];
 
-         int nb_slots_left = TC_SLOTS_PER_BATCH - next->num_total_slots;
+         int nb_slots_left = tc->batch_slot_limit - next->num_total_slots;
          /* If there isn't enough place for one draw, try to fill the next one */
          if (nb_slots_left < slots_for_one_draw)
-            nb_slots_left = TC_SLOTS_PER_BATCH;
+            nb_slots_left = tc->batch_slot_limit;
          const int size_left_bytes = nb_slots_left * sizeof(struct tc_call_base);
 
          /* How many draws can we fit in the current batch */
@@ -3932,7 +4035,7 @@ tc_call_draw_vstate_single(struct pipe_context *pipe, void *call, uint64_t *last
    if (next != last &&
        is_next_call_a_mergeable_draw_vstate(first, next)) {
       /* The maximum number of merged draws is given by the batch size. */
-      struct pipe_draw_start_count_bias draws[TC_SLOTS_PER_BATCH /
+      struct pipe_draw_start_count_bias draws[TC_MAX_SLOTS_PER_BATCH /
                                               call_size(tc_draw_vstate_single)];
       unsigned num_draws = 2;
 
@@ -4028,10 +4131,10 @@ tc_draw_vertex_state(struct pipe_context *_pipe,
    while (num_draws) {
       struct tc_batch *next = &tc->batch_slots[tc->next];
 
-      int nb_slots_left = TC_SLOTS_PER_BATCH - next->num_total_slots;
+      int nb_slots_left = tc->batch_slot_limit - next->num_total_slots;
       /* If there isn't enough place for one draw, try to fill the next one */
       if (nb_slots_left < slots_for_one_draw)
-         nb_slots_left = TC_SLOTS_PER_BATCH;
+         nb_slots_left = tc->batch_slot_limit;
       const int size_left_bytes = nb_slots_left * sizeof(struct tc_call_base);
 
       /* How many draws can we fit in the current batch */
@@ -4568,7 +4671,7 @@ tc_get_intel_perf_query_info(struct pipe_context *_pipe,
    struct threaded_context *tc = threaded_context(_pipe);
    struct pipe_context *pipe = tc->pipe;
 
-   tc_sync(tc); /* n_active vs begin/end_intel_perf_query */
+   tc_sync(tc, TC_SYNC_QUERY); /* n_active vs begin/end_intel_perf_query */
    pipe->get_intel_perf_query_info(pipe, query_index, name, data_size,
          n_counters, n_active);
 }
@@ -4640,7 +4743,7 @@ tc_delete_intel_perf_query(struct pipe_context *_pipe, struct pipe_query *q)
    struct threaded_context *tc = threaded_context(_pipe);
    struct pipe_context *pipe = tc->pipe;
 
-   tc_sync(tc); /* flush potentially pending begin/end_intel_perf_queries */
+   tc_sync(tc, TC_SYNC_QUERY); /* flush potentially pending begin/end_intel_perf_queries */
    pipe->delete_intel_perf_query(pipe, q);
 }
 
@@ -4650,7 +4753,7 @@ tc_wait_intel_perf_query(struct pipe_context *_pipe, struct pipe_query *q)
    struct threaded_context *tc = threaded_context(_pipe);
    struct pipe_context *pipe = tc->pipe;
 
-   tc_sync(tc); /* flush potentially pending begin/end_intel_perf_queries */
+   tc_sync(tc, TC_SYNC_QUERY); /* flush potentially pending begin/end_intel_perf_queries */
    pipe->wait_intel_perf_query(pipe, q);
 }
 
@@ -4660,7 +4763,7 @@ tc_is_intel_perf_query_ready(struct pipe_context *_pipe, struct pipe_query *q)
    struct threaded_context *tc = threaded_context(_pipe);
    struct pipe_context *pipe = tc->pipe;
 
-   tc_sync(tc); /* flush potentially pending begin/end_intel_perf_queries */
+   tc_sync(tc, TC_SYNC_QUERY); /* flush potentially pending begin/end_intel_perf_queries */
    return pipe->is_intel_perf_query_ready(pipe, q);
 }
 
@@ -4674,7 +4777,7 @@ tc_get_intel_perf_query_data(struct pipe_context *_pipe,
    struct threaded_context *tc = threaded_context(_pipe);
    struct pipe_context *pipe = tc->pipe;
 
-   tc_sync(tc); /* flush potentially pending begin/end_intel_perf_queries */
+   tc_sync(tc, TC_SYNC_QUERY); /* flush potentially pending begin/end_intel_perf_queries */
    return pipe->get_intel_perf_query_data(pipe, q, data_size, data, bytes_written);
 }
 
@@ -4732,7 +4835,7 @@ tc_destroy(struct pipe_context *_pipe)
    if (tc->base.stream_uploader)
       u_upload_destroy(tc->base.stream_uploader);
 
-   tc_sync(tc);
+   tc_sync(tc, TC_SYNC_OTHER);
 
    if (util_queue_is_initialized(&tc->queue)) {
       util_queue_destroy(&tc->queue);
@@ -4754,6 +4857,7 @@ tc_destroy(struct pipe_context *_pipe)
       util_queue_fence_destroy(&tc->buffer_lists[i].driver_flushed_fence);
    }
 
+   FREE(tc->call_stats);
    FREE(tc);
 }
 
@@ -4840,6 +4944,10 @@ threaded_context_create(struct pipe_context *pipe,
    if (!tc->base.stream_uploader || !tc->base.const_uploader)
       goto fail;
 
+   tc->call_stats = CALLOC(TC_NUM_CALLS, sizeof(*tc->call_stats));
+   if (!tc->call_stats)
+      goto fail;
+
    tc->use_forced_staging_uploads = true;
 
    /* The queue size is the number of batches "waiting". Batches are removed
@@ -4849,6 +4957,8 @@ threaded_context_create(struct pipe_context *pipe,
    if (!util_queue_init(&tc->queue, "gdrv", TC_MAX_BATCHES - 2, 1, 0, NULL))
       goto fail;
 
+   tc->batch_slot_limit = TC_SLOTS_PER_BATCH;
+
    for (unsigned i = 0; i < TC_MAX_BATCHES; i++) {
 #if !defined(NDEBUG) && TC_DEBUG >= 1
       tc->batch_slots[i].sentinel = TC_SENTINEL;
@@ -5030,6 +5140,35 @@ fail:
    return NULL;
 }
 
+struct threaded_context *
+threaded_context_from_pipe(struct pipe_context *pipe)
+{
+   return pipe && pipe->destroy == tc_destroy ? threaded_context(pipe) : NULL;
+}
+
+const char *
+threaded_context_get_sync_reason_name(enum tc_sync_reason reason)
+{
+   assert(reason < TC_NUM_SYNC_REASONS);
+   return tc_sync_reason_names[reason];
+}
+
+int
+threaded_context_get_call_id(const char *name)
+{
+   for (unsigned i = 0; i < TC_NUM_CALLS; i++) {
+      if (!strcmp(tc_call_names[i], name))
+         return i;
+   }
+   return -1;
+}
+
+void
+threaded_context_enable_call_profiling(struct threaded_context *tc)
+{
+   p_atomic_set(&tc->profile_calls, true);
+}
+
 void
 threaded_context_init_bytes_mapped_limit(struct threaded_context *tc, unsigned divisor)
 {
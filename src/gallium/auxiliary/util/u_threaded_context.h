@@ -246,8 +246,17 @@ struct tc_unflushed_batch_token;
  *
  * The idea is to have batches as small as possible but large enough so that
  * the queuing and mutex overhead is negligible.
+ *
+ * This is the initial and minimum size. Batches grow up to
+ * TC_MAX_SLOTS_PER_BATCH when every flush has to wake up the idle driver
+ * thread, and shrink back when batches wait too long to be executed, see
+ * tc_update_batch_slot_limit.
  */
 #define TC_SLOTS_PER_BATCH    1536
+#define TC_MAX_SLOTS_PER_BATCH (TC_SLOTS_PER_BATCH * 4)
+
+/* Shrink batches when they wait longer than this in the queue on average. */
+#define TC_MAX_BATCH_LATENCY_NS  (2 * 1000 * 1000)
 
 /* The buffer list queue is much deeper than the batch queue because buffer
  * lists need to stay around until the driver internally flushes its command
@@ -501,7 +510,8 @@ struct tc_batch {
    /* whether the first set_framebuffer_state call has been seen by this batch */
    bool first_set_fb;
    struct tc_unflushed_batch_token *token;
-   uint64_t slots[TC_SLOTS_PER_BATCH];
+   int64_t flush_time; /* os_time_get_nano() of tc_batch_flush */
+   uint64_t slots[TC_MAX_SLOTS_PER_BATCH];
    struct util_dynarray renderpass_infos;
 };
 
@@ -540,6 +550,27 @@ struct threaded_context_options {
    void (*fs_parse)(void *state, struct tc_renderpass_info *info);
 };
 
+/* Why the frontend thread had to wait for the driver thread. */
+enum tc_sync_reason {
+   TC_SYNC_FLUSH,
+   TC_SYNC_QUERY,
+   TC_SYNC_BUFFER_MAP,
+   TC_SYNC_TEXTURE_MAP,
+   TC_SYNC_TEXTURE_SUBDATA,
+   TC_SYNC_FENCE,
+   TC_SYNC_OTHER,
+   TC_NUM_SYNC_REASONS,
+};
+
+/* Per call type counters. The number of calls is updated by the frontend
+ * thread, the execution time by the driver thread, and only if
+ * threaded_context_enable_call_profiling was called.
+ */
+struct tc_call_stats {
+   uint64_t num_calls;
+   uint64_t exec_time_ns;
+};
+
 struct threaded_context {
    struct pipe_context base;
    struct pipe_context *pipe;
@@ -555,6 +586,14 @@ struct threaded_context {
    unsigned num_offloaded_slots;
    unsigned num_direct_slots;
    unsigned num_syncs;
+   unsigned num_syncs_per_reason[TC_NUM_SYNC_REASONS];
+   /* Bytes copied instead of mapping buffers directly (staging uploads
+    * and CPU storage).
+    */
+   uint64_t num_map_copied_bytes;
+   /* Indexed by the private call id, see threaded_context_get_call_id. */
+   struct tc_call_stats *call_stats;
+   bool profile_calls;
 
    bool use_forced_staging_uploads;
    bool add_all_gfx_bindings_to_buffer_list;
@@ -599,6 +638,11 @@ struct threaded_context {
 
    unsigned last, next, next_buf_list;
 
+   /* Number of slots after which batches are flushed. */
+   unsigned batch_slot_limit;
+   /* Average time batches wait in the queue, updated by the driver thread. */
+   int64_t batch_latency;
+
    /* The list fences that the driver should signal after the next flush.
     * If this is empty, all driver command buffers have been flushed.
     */
@@ -656,6 +700,23 @@ threaded_context_create(struct pipe_context *pipe,
 void
 threaded_context_init_bytes_mapped_limit(struct threaded_context *tc, unsigned divisor);
 
+/* Return the threaded context if pipe is one, or NULL. */
+struct threaded_context *
+threaded_context_from_pipe(struct pipe_context *pipe);
+
+const char *
+threaded_context_get_sync_reason_name(enum tc_sync_reason reason);
+
+/* Return the index into threaded_context::call_stats for the call with
+ * the given name (e.g. "draw_single"), or -1 if there is no such call.
+ */
+int
+threaded_context_get_call_id(const char *name);
+
+/* Start measuring the execution time of calls in the driver thread. */
+void
+threaded_context_enable_call_profiling(struct threaded_context *tc);
+
 void
 threaded_context_flush(struct pipe_context *_pipe,
                        struct tc_unflushed_batch_token *token,
@@ -26,6 +26,7 @@
 #include "util/u_box.h"
 #include "util/format/u_format.h"
 #include "util/format/u_format_zs.h"
+#include "util/u_atomic.h"
 #include "util/u_inlines.h"
 #include "util/u_transfer_helper.h"
 
@@ -37,8 +38,47 @@ struct u_transfer_helper {
    bool msaa_map;
    bool z24_in_z32f; /* the z24 values are stored in a z32 - translate them. */
    bool interleave_in_place;
+
+   /* Last CPU staging buffer released by an unmap, kept around so that
+    * repeated small Z/S and format-emulation maps don't hit malloc/free
+    * every time.  Swapped in and out atomically since the helper is shared
+    * by all contexts of the screen.
+    */
+   struct u_transfer_staging *staging;
 };
 
+struct u_transfer_staging {
+   uint64_t size;
+   uint8_t data[];
+};
+
+static void *
+get_staging(struct u_transfer_helper *helper, size_t size)
+{
+   struct u_transfer_staging *staging = p_atomic_xchg(&helper->staging, NULL);
+   if (staging && staging->size >= size)
+      return staging->data;
+
+   free(staging);
+   staging = malloc(sizeof(*staging) + size);
+   if (!staging)
+      return NULL;
+
+   staging->size = size;
+   return staging->data;
+}
+
+static void
+put_staging(struct u_transfer_helper *helper, void *data)
+{
+   if (!data)
+      return;
+
+   struct u_transfer_staging *staging =
+      container_of(data, struct u_transfer_staging, data);
+   free(p_atomic_xchg(&helper->staging, staging));
+}
+
 static inline bool need_interleave_path(struct u_transfer_helper *helper,
                                         enum pipe_format format)
 {
@@ -286,7 +326,7 @@ u_transfer_helper_transfer_map(struct pipe_context *pctx,
    ptrans->stride = util_format_get_stride(format, box->width);
    ptrans->layer_stride = ptrans->stride * box->height;
 
-   trans->staging = malloc(ptrans->layer_stride);
+   trans->staging = get_staging(helper, ptrans->layer_stride);
    if (!trans->staging)
       goto fail;
 
@@ -358,7 +398,7 @@ fail:
    if (trans->trans2)
       helper->vtbl->transfer_unmap(pctx, trans->trans2);
    pipe_resource_reference(&ptrans->resource, NULL);
-   free(trans->staging);
+   put_staging(helper, trans->staging);
    free(trans);
    return NULL;
 }
@@ -535,7 +575,7 @@ u_transfer_helper_transfer_unmap(struct pipe_context *pctx,
 
       pipe_resource_reference(&ptrans->resource, NULL);
 
-      free(trans->staging);
+      put_staging(helper, trans->staging);
       free(trans);
    } else {
       helper->vtbl->transfer_unmap(pctx, ptrans);
@@ -561,6 +601,7 @@ u_transfer_helper_create(const struct u_transfer_vtbl *vtbl,
 void
 u_transfer_helper_destroy(struct u_transfer_helper *helper)
 {
+   free(helper->staging);
    free(helper);
 }
 
@@ -604,7 +645,7 @@ u_transfer_helper_deinterleave_transfer_map(struct pipe_context *pctx,
 
    bool has_stencil = util_format_is_depth_and_stencil(format);
 
-   trans->staging = malloc(ptrans->layer_stride);
+   trans->staging = get_staging(helper, ptrans->layer_stride);
    if (!trans->staging)
       goto fail;
 
@@ -670,7 +711,7 @@ fail:
    if (trans->trans2)
       helper->vtbl->transfer_unmap(pctx, trans->trans2);
    pipe_resource_reference(&ptrans->resource, NULL);
-   free(trans->staging);
+   put_staging(helper, trans->staging);
    free(trans);
    return NULL;
 }
@@ -701,6 +742,6 @@ u_transfer_helper_deinterleave_transfer_unmap(struct pipe_context *pctx,
 
    pipe_resource_reference(&ptrans->resource, NULL);
 
-   free(trans->staging);
+   put_staging(helper, trans->staging);
    free(trans);
 }
@@ -37,11 +37,18 @@
 
 #include "u_upload_mgr.h"
 
+/* Number of full upload buffers kept around for reuse once the GPU is done
+ * with them, and how far the buffer size may grow past default_size when
+ * all of them are still busy.
+ */
+#define UPLOAD_MAX_RETIRED 4
+#define UPLOAD_MAX_GROWTH  8
 
 struct u_upload_mgr {
    struct pipe_context *pipe;
 
    unsigned default_size;  /* Minimum size of the upload buffer, in bytes. */
+   unsigned alloc_size;    /* Size of new upload buffers, in bytes. */
    unsigned bind;          /* Bitmask of PIPE_BIND_* flags. */
    enum pipe_resource_usage usage;
    unsigned flags;
@@ -55,6 +62,10 @@ struct u_upload_mgr {
    unsigned offset; /* Aligned offset to the upload buffer, pointing
                      * at the first unused byte. */
    int buffer_private_refcount;
+
+   /* Full upload buffers, oldest first, only referenced by us. */
+   struct pipe_resource *retired[UPLOAD_MAX_RETIRED];
+   unsigned num_retired;
 };
 
 
@@ -68,6 +79,7 @@ u_upload_create(struct pipe_context *pipe, unsigned default_size,
 
    upload->pipe = pipe;
    upload->default_size = default_size;
+   upload->alloc_size = default_size;
    upload->bind = bind;
    upload->usage = usage;
    upload->flags = flags;
@@ -148,9 +160,8 @@ u_upload_unmap(struct u_upload_mgr *upload)
 
 
 static void
-u_upload_release_buffer(struct u_upload_mgr *upload)
+u_upload_release_private_refs(struct u_upload_mgr *upload)
 {
-   /* Unmap and unreference the upload buffer. */
    upload_unmap_internal(upload, TRUE);
    if (upload->buffer_private_refcount) {
       /* Subtract the remaining private references before unreferencing
@@ -161,15 +172,87 @@ u_upload_release_buffer(struct u_upload_mgr *upload)
                    -upload->buffer_private_refcount);
       upload->buffer_private_refcount = 0;
    }
+}
+
+
+static void
+u_upload_release_buffer(struct u_upload_mgr *upload)
+{
+   /* Unmap and unreference the upload buffer. */
+   u_upload_release_private_refs(upload);
    pipe_resource_reference(&upload->buffer, NULL);
    upload->buffer_size = 0;
 }
 
 
+/* Keep the current upload buffer for reuse instead of releasing it, so that
+ * a context streaming data doesn't allocate a new buffer every time one
+ * fills up.
+ */
+static void
+u_upload_retire_buffer(struct u_upload_mgr *upload)
+{
+   if (!upload->buffer)
+      return;
+
+   u_upload_release_private_refs(upload);
+
+   if (upload->num_retired == UPLOAD_MAX_RETIRED) {
+      pipe_resource_reference(&upload->retired[0], NULL);
+      memmove(upload->retired, upload->retired + 1,
+              sizeof(upload->retired[0]) * (UPLOAD_MAX_RETIRED - 1));
+      upload->num_retired--;
+   }
+
+   upload->retired[upload->num_retired++] = upload->buffer;
+   upload->buffer = NULL;
+   upload->buffer_size = 0;
+}
+
+
+/* Find a retired buffer of at least min_size that nobody else references
+ * and the GPU is done with, map it and make it the upload buffer.
+ * Return its size or 0 if there is none.
+ */
+static unsigned
+u_upload_reuse_buffer(struct u_upload_mgr *upload, unsigned min_size)
+{
+   for (unsigned i = 0; i < upload->num_retired; i++) {
+      struct pipe_resource *buffer = upload->retired[i];
+
+      /* Suballocations that are still bound or queued hold a reference. */
+      if (buffer->width0 < min_size ||
+          p_atomic_read(&buffer->reference.count) != 1)
+         continue;
+
+      upload->map = pipe_buffer_map_range(upload->pipe, buffer,
+                                          0, buffer->width0,
+                                          (upload->map_flags &
+                                           ~PIPE_MAP_UNSYNCHRONIZED) |
+                                          PIPE_MAP_DONTBLOCK,
+                                          &upload->transfer);
+      if (!upload->map) {
+         upload->transfer = NULL;
+         continue;
+      }
+
+      upload->buffer = buffer;
+      upload->num_retired--;
+      memmove(upload->retired + i, upload->retired + i + 1,
+              sizeof(upload->retired[0]) * (upload->num_retired - i));
+      return buffer->width0;
+   }
+
+   return 0;
+}
+
+
 void
 u_upload_destroy(struct u_upload_mgr *upload)
 {
    u_upload_release_buffer(upload);
+   for (unsigned i = 0; i < upload->num_retired; i++)
+      pipe_resource_reference(&upload->retired[i], NULL);
    FREE(upload);
 }
 
@@ -181,13 +264,25 @@ u_upload_alloc_buffer(struct u_upload_mgr *upload, unsigned min_size)
    struct pipe_resource buffer;
    unsigned size;
 
-   /* Release the old buffer, if present:
+   /* Retire the old buffer, if present, and try to reuse an idle one:
     */
-   u_upload_release_buffer(upload);
+   u_upload_retire_buffer(upload);
+
+   size = u_upload_reuse_buffer(upload, min_size);
+   if (size)
+      goto reserve_refs;
+
+   /* Every retired buffer is still in flight, so buffers are being filled
+    * faster than they are consumed.  Make the next ones bigger.
+    */
+   if (upload->num_retired == UPLOAD_MAX_RETIRED) {
+      upload->alloc_size = MIN2(upload->alloc_size * 2,
+                                upload->default_size * UPLOAD_MAX_GROWTH);
+   }
 
    /* Allocate a new one:
     */
-   size = align(MAX2(upload->default_size, min_size), 4096);
+   size = align(MAX2(upload->alloc_size, min_size), 4096);
 
    memset(&buffer, 0, sizeof buffer);
    buffer.target = PIPE_BUFFER;
@@ -209,6 +304,7 @@ u_upload_alloc_buffer(struct u_upload_mgr *upload, unsigned min_size)
    if (upload->buffer == NULL)
       return 0;
 
+reserve_refs:
    /* Since atomic operations are very very slow when 2 threads are not
     * sharing the same L3 cache (which happens on AMD Zen), eliminate all
     * atomics in u_upload_alloc as follows:
@@ -237,12 +333,14 @@ u_upload_alloc_buffer(struct u_upload_mgr *upload, unsigned min_size)
    p_atomic_add(&upload->buffer->reference.count, upload->buffer_private_refcount);
 
    /* Map the new buffer. */
-   upload->map = pipe_buffer_map_range(upload->pipe, upload->buffer,
-                                       0, size, upload->map_flags,
-                                       &upload->transfer);
-   if (upload->map == NULL) {
-      u_upload_release_buffer(upload);
-      return 0;
+   if (!upload->map) {
+      upload->map = pipe_buffer_map_range(upload->pipe, upload->buffer,
+                                          0, size, upload->map_flags,
+                                          &upload->transfer);
+      if (upload->map == NULL) {
+         u_upload_release_buffer(upload);
+         return 0;
+      }
    }
 
    upload->buffer_size = size;
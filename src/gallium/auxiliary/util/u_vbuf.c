@@ -194,6 +194,18 @@ struct u_vbuf {
    uint32_t nonzero_stride_vb_mask; /* each bit describes a corresp. buffer */
    /* Which buffers are allowed (supported by hardware). */
    uint32_t allowed_vb_mask;
+
+   /* Buffers translated by the current draw_vbo call. The inputs can't
+    * change until it returns, so the following draws of a multidraw reuse
+    * them if they cover the same range. */
+   struct {
+      struct translate_key key;
+      unsigned vb_mask;
+      int start;
+      unsigned num;
+      struct pipe_resource *buffer;
+      unsigned offset;
+   } translated[VB_NUM];
 };
 
 static void *
@@ -450,11 +462,60 @@ void u_vbuf_destroy(struct u_vbuf *mgr)
    if (mgr->pc)
       util_primconvert_destroy(mgr->pc);
 
+   for (i = 0; i < VB_NUM; i++)
+      pipe_resource_reference(&mgr->translated[i].buffer, NULL);
+
    translate_cache_destroy(mgr->translate_cache);
    cso_cache_delete(&mgr->cso_cache);
    FREE(mgr);
 }
 
+static void
+u_vbuf_reset_translated(struct u_vbuf *mgr)
+{
+   for (unsigned i = 0; i < VB_NUM; i++)
+      pipe_resource_reference(&mgr->translated[i].buffer, NULL);
+}
+
+/* Reuse vertices translated by a previous draw of the same draw_vbo call. */
+static bool
+u_vbuf_reuse_translated(struct u_vbuf *mgr, unsigned type,
+                        const struct translate_key *key, unsigned vb_mask,
+                        unsigned out_vb, int start, unsigned num)
+{
+   struct pipe_vertex_buffer *vb = &mgr->real_vertex_buffer[out_vb];
+
+   if (!mgr->translated[type].buffer ||
+       mgr->translated[type].vb_mask != vb_mask ||
+       start < mgr->translated[type].start ||
+       (int64_t)start + num > (int64_t)mgr->translated[type].start + mgr->translated[type].num ||
+       translate_key_compare(&mgr->translated[type].key, key))
+      return false;
+
+   /* The offset points at vertex 0, so it covers any range within the
+    * translated one. */
+   pipe_vertex_buffer_unreference(vb);
+   pipe_resource_reference(&vb->buffer.resource, mgr->translated[type].buffer);
+   vb->is_user_buffer = false;
+   vb->buffer_offset = mgr->translated[type].offset;
+   vb->stride = key->output_stride;
+   return true;
+}
+
+static void
+u_vbuf_save_translated(struct u_vbuf *mgr, unsigned type,
+                       const struct translate_key *key, unsigned vb_mask,
+                       unsigned out_vb, int start, unsigned num)
+{
+   mgr->translated[type].key = *key;
+   mgr->translated[type].vb_mask = vb_mask;
+   mgr->translated[type].start = start;
+   mgr->translated[type].num = num;
+   mgr->translated[type].offset = mgr->real_vertex_buffer[out_vb].buffer_offset;
+   pipe_resource_reference(&mgr->translated[type].buffer,
+                           mgr->real_vertex_buffer[out_vb].buffer.resource);
+}
+
 static enum pipe_error
 u_vbuf_translate_buffers(struct u_vbuf *mgr, struct translate_key *key,
                          const struct pipe_draw_info *info,
@@ -794,14 +855,27 @@ u_vbuf_translate_begin(struct u_vbuf *mgr,
    for (type = 0; type < VB_NUM; type++) {
       if (key[type].nr_elements) {
          enum pipe_error err;
+         const bool unroll = unroll_indices && type == VB_VERTEX;
+         unsigned out_vb = mgr->fallback_vbs[type];
+
          if (!mgr->caps.attrib_component_unaligned)
             key[type].output_stride = align(key[type].output_stride, min_alignment[type]);
-         err = u_vbuf_translate_buffers(mgr, &key[type], info, draw,
-                                        mask[type], mgr->fallback_vbs[type],
-                                        start[type], num[type], min_index,
-                                        unroll_indices && type == VB_VERTEX);
-         if (err != PIPE_OK)
-            return FALSE;
+
+         /* Unrolled vertices depend on the indices of each draw. */
+         if (unroll ||
+             !u_vbuf_reuse_translated(mgr, type, &key[type], mask[type],
+                                      out_vb, start[type], num[type])) {
+            err = u_vbuf_translate_buffers(mgr, &key[type], info, draw,
+                                           mask[type], out_vb,
+                                           start[type], num[type], min_index,
+                                           unroll);
+            if (err != PIPE_OK)
+               return FALSE;
+
+            if (!unroll)
+               u_vbuf_save_translated(mgr, type, &key[type], mask[type],
+                                      out_vb, start[type], num[type]);
+         }
 
          /* Fixup the stride for constant attribs. */
          if (type == VB_CONST) {
@@ -859,6 +933,8 @@ static void u_vbuf_translate_end(struct u_vbuf *mgr)
    /* This will cause the buffer to be unbound in the driver later. */
    mgr->dirty_real_vb_mask |= mgr->fallback_vbs_mask;
    mgr->fallback_vbs_mask = 0;
+
+   u_vbuf_reset_translated(mgr);
 }
 
 static void *
@@ -1432,6 +1508,10 @@ u_vbuf_split_indexed_multidraw(struct u_vbuf *mgr, struct pipe_draw_info *info,
                                unsigned *indirect_data, unsigned stride,
                                unsigned draw_count)
 {
+   /* Don't reuse translations of earlier calls, the inputs may have changed
+    * since then. */
+   u_vbuf_reset_translated(mgr);
+
    /* Increase refcount to be able to use take_index_buffer_ownership with
     * all draws.
     */
@@ -62,6 +62,8 @@ const char *compute_shader_video_buffer =
       "IMM[1] FLT32 { 1.0, 0.0, 0.0, 0.0}\n"
 
       "UMAD TEMP[0].xy, SV[1].xyyy, IMM[0].xyyy, SV[0].xyyy\n"
+      /* The grid starts at the top left of the drawn area */
+      "UADD TEMP[0].xy, TEMP[0].xyyy, CONST[4].xyyy\n"
 
       /* Drawn area check */
       "USGE TEMP[1].xy, TEMP[0].xyxy, CONST[4].xyxy\n"
@@ -125,6 +127,8 @@ const char *compute_shader_weave =
       "IMM[3] FLT32 { 0.25, 0.5, 0.125, 0.125}\n"
 
       "UMAD TEMP[0].xy, SV[1].xyyy, IMM[0].xyyy, SV[0].xyyy\n"
+      /* The grid starts at the top left of the drawn area */
+      "UADD TEMP[0].xy, TEMP[0].xyyy, CONST[4].xyyy\n"
 
       /* Drawn area check */
       "USGE TEMP[1].xy, TEMP[0].xyxy, CONST[4].xyxy\n"
@@ -240,6 +244,8 @@ const char *compute_shader_rgba =
       "IMM[1] FLT32 { 1.0, 2.0, 0.0, 0.0}\n"
 
       "UMAD TEMP[0].xy, SV[1].xyyy, IMM[0].xyyy, SV[0].xyyy\n"
+      /* The grid starts at the top left of the drawn area */
+      "UADD TEMP[0].xy, TEMP[0].xyyy, CONST[4].xyyy\n"
 
       /* Drawn area check */
       "USGE TEMP[1].xy, TEMP[0].xyxy, CONST[4].xyxy\n"
@@ -286,6 +292,8 @@ static const char *compute_shader_yuv_weave_y =
       "IMM[3] FLT32 { 0.25, 0.5, 0.125, 0.125}\n"
 
       "UMAD TEMP[0], SV[1], IMM[0], SV[0]\n"
+      /* The grid starts at the top left of the drawn area */
+      "UADD TEMP[0].xy, TEMP[0].xyyy, CONST[4].xyyy\n"
 
       /* Drawn area check */
       "USGE TEMP[1].xy, TEMP[0].xyxy, CONST[4].xyxy\n"
@@ -392,6 +400,8 @@ static const char *compute_shader_yuv_weave_uv =
       "IMM[3] FLT32 { 0.25, 0.5, 0.125, 0.125}\n"
 
       "UMAD TEMP[0], SV[1], IMM[0], SV[0]\n"
+      /* The grid starts at the top left of the drawn area */
+      "UADD TEMP[0].xy, TEMP[0].xyyy, CONST[4].xyyy\n"
 
       /* Drawn area check */
       "USGE TEMP[1].xy, TEMP[0].xyxy, CONST[4].xyxy\n"
@@ -498,6 +508,8 @@ static const char *compute_shader_yuv_bob_y =
       "IMM[1] FLT32 { 1.0, 2.0, 0.0, 0.0}\n"
 
       "UMAD TEMP[0], SV[1], IMM[0], SV[0]\n"
+      /* The grid starts at the top left of the drawn area */
+      "UADD TEMP[0].xy, TEMP[0].xyyy, CONST[4].xyyy\n"
 
       /* Drawn area check */
       "USGE TEMP[1].xy, TEMP[0].xyxy, CONST[4].xyxy\n"
@@ -550,6 +562,8 @@ static const char *compute_shader_yuv_bob_uv =
       "IMM[1] FLT32 { 1.0, 2.0, 0.0, 0.0}\n"
 
       "UMAD TEMP[0], SV[1], IMM[0], SV[0]\n"
+      /* The grid starts at the top left of the drawn area */
+      "UADD TEMP[0].xy, TEMP[0].xyyy, CONST[4].xyyy\n"
 
       /* Drawn area check */
       "USGE TEMP[1].xy, TEMP[0].xyxy, CONST[4].xyxy\n"
@@ -591,6 +605,9 @@ cs_launch(struct vl_compositor *c,
 {
    struct pipe_context *ctx = c->pipe;
 
+   if (draw_area->x1 <= draw_area->x0 || draw_area->y1 <= draw_area->y0)
+      return;
+
    /* Bind the image */
    struct pipe_image_view image = {0};
    image.resource = c->fb_state.cbufs[0]->texture;
@@ -607,8 +624,8 @@ cs_launch(struct vl_compositor *c,
    info.block[0] = 8;
    info.block[1] = 8;
    info.block[2] = 1;
-   info.grid[0] = DIV_ROUND_UP(draw_area->x1, info.block[0]);
-   info.grid[1] = DIV_ROUND_UP(draw_area->y1, info.block[1]);
+   info.grid[0] = DIV_ROUND_UP(draw_area->x1 - draw_area->x0, info.block[0]);
+   info.grid[1] = DIV_ROUND_UP(draw_area->y1 - draw_area->y0, info.block[1]);
    info.grid[2] = 1;
 
    ctx->launch_grid(ctx, &info);
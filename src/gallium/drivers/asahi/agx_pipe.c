@@ -574,10 +574,12 @@ agx_flush(struct pipe_context *pctx,
    }
 
    memset(batch->bo_list.set, 0, batch->bo_list.word_count * sizeof(BITSET_WORD));
-   agx_pool_cleanup(&ctx->batch->pool);
-   agx_pool_cleanup(&ctx->batch->pipeline_pool);
-   agx_pool_init(&ctx->batch->pool, dev, AGX_MEMORY_TYPE_FRAMEBUFFER, true);
-   agx_pool_init(&ctx->batch->pipeline_pool, dev, AGX_MEMORY_TYPE_CMDBUF_32, true);
+
+   /* We waited for the submission above, so the pools are idle and their
+    * backing can be recycled for the next batch.
+    */
+   agx_pool_reset(&ctx->batch->pool);
+   agx_pool_reset(&ctx->batch->pipeline_pool);
    ctx->batch->clear = 0;
    ctx->batch->draw = 0;
    ctx->batch->load = 0;
@@ -147,6 +147,16 @@ struct d3d12_shader_state {
    unsigned state_dirty;
 };
 
+/* Last descriptor table written for a stage in a batch, so identical
+ * bindings can point at it again instead of copying the descriptors.
+ */
+struct d3d12_descriptor_table_cache {
+   uint64_t submit_id;
+   unsigned num_descs;
+   D3D12_CPU_DESCRIPTOR_HANDLE descs[PIPE_MAX_SHADER_SAMPLER_VIEWS];
+   D3D12_GPU_DESCRIPTOR_HANDLE table;
+};
+
 struct blitter_context;
 struct primconvert_context;
 
@@ -237,6 +247,8 @@ struct d3d12_context {
    struct d3d12_gfx_pipeline_state gfx_pipeline_state;
    struct d3d12_compute_pipeline_state compute_pipeline_state;
    unsigned shader_dirty[PIPE_SHADER_TYPES];
+   struct d3d12_descriptor_table_cache srv_tables[PIPE_SHADER_TYPES];
+   struct d3d12_descriptor_table_cache sampler_tables[PIPE_SHADER_TYPES];
    unsigned state_dirty;
    unsigned cmdlist_dirty;
    ID3D12PipelineState *current_gfx_pso;
@@ -57,6 +57,33 @@ static const D3D12_RECT MAX_SCISSOR_ARRAY[] = {
 };
 static_assert(ARRAY_SIZE(MAX_SCISSOR_ARRAY) == PIPE_MAX_VIEWPORTS, "Wrong scissor count");
 
+/* Within a batch, sampler views are referenced and deleted samplers are
+ * zombies, so their CPU handles aren't reused and equal handles mean equal
+ * descriptors.
+ */
+static D3D12_GPU_DESCRIPTOR_HANDLE
+append_descriptor_table(struct d3d12_batch *batch,
+                        struct d3d12_descriptor_heap *heap,
+                        struct d3d12_descriptor_table_cache *cache,
+                        const D3D12_CPU_DESCRIPTOR_HANDLE *descs,
+                        unsigned num_descs)
+{
+   if (cache->submit_id == batch->submit_id &&
+       cache->num_descs == num_descs &&
+       memcmp(cache->descs, descs, num_descs * sizeof(*descs)) == 0)
+      return cache->table;
+
+   struct d3d12_descriptor_handle table_start;
+   d2d12_descriptor_heap_get_next_handle(heap, &table_start);
+   d3d12_descriptor_heap_append_handles(heap, descs, num_descs);
+
+   cache->submit_id = batch->submit_id;
+   cache->num_descs = num_descs;
+   memcpy(cache->descs, descs, num_descs * sizeof(*descs));
+   cache->table = table_start.gpu_handle;
+   return cache->table;
+}
+
 static D3D12_GPU_DESCRIPTOR_HANDLE
 fill_cbv_descriptors(struct d3d12_context *ctx,
                      struct d3d12_shader *shader,
@@ -96,9 +123,6 @@ fill_srv_descriptors(struct d3d12_context *ctx,
    struct d3d12_batch *batch = d3d12_current_batch(ctx);
    struct d3d12_screen *screen = d3d12_screen(ctx->base.screen);
    D3D12_CPU_DESCRIPTOR_HANDLE descs[PIPE_MAX_SHADER_SAMPLER_VIEWS];
-   struct d3d12_descriptor_handle table_start;
-
-   d2d12_descriptor_heap_get_next_handle(batch->view_heap, &table_start);
 
    for (unsigned i = shader->begin_srv_binding; i < shader->end_srv_binding; i++)
    {
@@ -120,6 +144,9 @@ fill_srv_descriptors(struct d3d12_context *ctx,
          if (view->texture_generation_id != res->generation_id) {
             d3d12_init_sampler_view_descriptor(view);
             view->texture_generation_id = res->generation_id;
+            /* Same handle, new contents */
+            for (unsigned s = 0; s < PIPE_SHADER_TYPES; s++)
+               ctx->srv_tables[s].submit_id = 0;
          }
 
          D3D12_RESOURCE_STATES state = (stage == PIPE_SHADER_FRAGMENT) ?
@@ -143,9 +170,8 @@ fill_srv_descriptors(struct d3d12_context *ctx,
       }
    }
 
-   d3d12_descriptor_heap_append_handles(batch->view_heap, descs, shader->end_srv_binding - shader->begin_srv_binding);
-
-   return table_start.gpu_handle;
+   return append_descriptor_table(batch, batch->view_heap, &ctx->srv_tables[stage],
+                                  descs, shader->end_srv_binding - shader->begin_srv_binding);
 }
 
 static D3D12_GPU_DESCRIPTOR_HANDLE
@@ -195,9 +221,6 @@ fill_sampler_descriptors(struct d3d12_context *ctx,
    const struct d3d12_shader *shader = shader_sel->current;
    struct d3d12_batch *batch = d3d12_current_batch(ctx);
    D3D12_CPU_DESCRIPTOR_HANDLE descs[PIPE_MAX_SHADER_SAMPLER_VIEWS];
-   struct d3d12_descriptor_handle table_start;
-
-   d2d12_descriptor_heap_get_next_handle(batch->sampler_heap, &table_start);
 
    for (unsigned i = shader->begin_srv_binding; i < shader->end_srv_binding; i++)
    {
@@ -219,8 +242,8 @@ fill_sampler_descriptors(struct d3d12_context *ctx,
          descs[desc_idx] = ctx->null_sampler.cpu_handle;
    }
 
-   d3d12_descriptor_heap_append_handles(batch->sampler_heap, descs, shader->end_srv_binding - shader->begin_srv_binding);
-   return table_start.gpu_handle;
+   return append_descriptor_table(batch, batch->sampler_heap, &ctx->sampler_tables[stage],
+                                  descs, shader->end_srv_binding - shader->begin_srv_binding);
 }
 
 static D3D12_UAV_DIMENSION
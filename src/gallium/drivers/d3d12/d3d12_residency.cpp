@@ -107,6 +107,11 @@ static constexpr int64_t eviction_grace_period_microseconds_min =
 static constexpr int64_t eviction_grace_period_microseconds_max =
    eviction_grace_period_seconds_max * microseconds_per_second;
 static constexpr double trim_percentage_usage_threshold = 0.7;
+/* When we have to evict to fit a batch, free this much of the budget beyond
+ * what the batch needs, so the following batches don't immediately stall on
+ * another fence wait and evict again.
+ */
+static constexpr double eviction_budget_headroom = 0.05;
 
 static int64_t
 get_eviction_grace_period(struct d3d12_memory_info *mem_info)
@@ -228,7 +233,9 @@ d3d12_process_batch_residency(struct d3d12_screen *screen, struct d3d12_batch *b
             break;
          }
 
-         evict_to_fence_or_budget(screen, oldest_resident_bo->last_used_fence, mem_info.usage + size_to_make_resident, mem_info.budget);
+         uint64_t headroom = (uint64_t)(mem_info.budget * eviction_budget_headroom);
+         evict_to_fence_or_budget(screen, oldest_resident_bo->last_used_fence,
+                                  mem_info.usage + size_to_make_resident + headroom, mem_info.budget);
          continue;
       }
 
@@ -33,6 +33,15 @@
 #define TEX_TILE_HEIGHT (4)
 #define TEX_TILE_WORDS (TEX_TILE_WIDTH * TEX_TILE_HEIGHT)
 
+/* Within a row, each group of TEX_TILE_WIDTH horizontally adjacent texels
+ * is contiguous in the tiled layout.  Handle the unaligned head and tail of
+ * a row one texel at a time and copy the aligned groups in between as whole
+ * tile rows, which avoids the per-texel divisions and lets the compiler
+ * vectorize the copy.
+ */
+#define TILE_OFFSET(x) \
+   (((x) / TEX_TILE_WIDTH) * TEX_TILE_WORDS + ((x) % TEX_TILE_WIDTH))
+
 #define DO_TILE(type)                                                   \
    src_stride /= sizeof(type);                                          \
    dst_stride = (dst_stride * TEX_TILE_HEIGHT) / sizeof(type);          \
@@ -40,12 +49,18 @@
       unsigned dsty = basey + srcy;                                     \
       unsigned ty = (dsty / TEX_TILE_HEIGHT) * dst_stride +             \
                     (dsty % TEX_TILE_HEIGHT) * TEX_TILE_WIDTH;          \
-      for (unsigned srcx = 0; srcx < width; ++srcx) {                   \
-         unsigned dstx = basex + srcx;                                  \
-         ((type *)dest)[ty + (dstx / TEX_TILE_WIDTH) * TEX_TILE_WORDS + \
-                        (dstx % TEX_TILE_WIDTH)] =                      \
-            ((type *)src)[srcy * src_stride + srcx];                    \
+      type *d = (type *)dest + ty;                                      \
+      const type *s = (const type *)src + srcy * src_stride;            \
+      unsigned srcx = 0;                                                \
+      for (; srcx < width && (basex + srcx) % TEX_TILE_WIDTH; ++srcx)   \
+         d[TILE_OFFSET(basex + srcx)] = s[srcx];                        \
+      for (; srcx + TEX_TILE_WIDTH <= width; srcx += TEX_TILE_WIDTH) {  \
+         type *dt = d + TILE_OFFSET(basex + srcx);                      \
+         for (unsigned i = 0; i < TEX_TILE_WIDTH; ++i)                  \
+            dt[i] = s[srcx + i];                                        \
       }                                                                 \
+      for (; srcx < width; ++srcx)                                      \
+         d[TILE_OFFSET(basex + srcx)] = s[srcx];                        \
    }
 
 #define DO_UNTILE(type)                                                   \
@@ -55,12 +70,18 @@
       unsigned srcy = basey + dsty;                                       \
       unsigned sy = (srcy / TEX_TILE_HEIGHT) * src_stride +               \
                     (srcy % TEX_TILE_HEIGHT) * TEX_TILE_WIDTH;            \
-      for (unsigned dstx = 0; dstx < width; ++dstx) {                     \
-         unsigned srcx = basex + dstx;                                    \
-         ((type *)dest)[dsty * dst_stride + dstx] =                       \
-            ((type *)src)[sy + (srcx / TEX_TILE_WIDTH) * TEX_TILE_WORDS + \
-                          (srcx % TEX_TILE_WIDTH)];                       \
+      type *d = (type *)dest + dsty * dst_stride;                         \
+      const type *s = (const type *)src + sy;                             \
+      unsigned dstx = 0;                                                  \
+      for (; dstx < width && (basex + dstx) % TEX_TILE_WIDTH; ++dstx)     \
+         d[dstx] = s[TILE_OFFSET(basex + dstx)];                          \
+      for (; dstx + TEX_TILE_WIDTH <= width; dstx += TEX_TILE_WIDTH) {    \
+         const type *st = s + TILE_OFFSET(basex + dstx);                  \
+         for (unsigned i = 0; i < TEX_TILE_WIDTH; ++i)                    \
+            d[dstx + i] = st[i];                                          \
       }                                                                   \
+      for (; dstx < width; ++dstx)                                        \
+         d[dstx] = s[TILE_OFFSET(basex + dstx)];                          \
    }
 
 void
@@ -431,12 +431,18 @@ fd_batch_add_dep(struct fd_batch *batch, struct fd_batch *dep)
    DBG("%p: added dependency on %p", batch, dep);
 }
 
+/* Flush the batch with a pending write to rsc, because \a batch needs to
+ * access rsc.  Note that the writer may belong to a different context,
+ * the hazard is accounted to the context of \a batch.
+ */
 static void
-flush_write_batch(struct fd_resource *rsc) assert_dt
+flush_write_batch(struct fd_batch *batch, struct fd_resource *rsc) assert_dt
 {
    struct fd_batch *b = NULL;
    fd_batch_reference_locked(&b, rsc->track->write_batch);
 
+   batch->ctx->stats.flush_hazard++;
+
    fd_screen_unlock(b->ctx->screen);
    fd_batch_flush(b);
    fd_screen_lock(b->ctx->screen);
@@ -488,7 +494,7 @@ fd_batch_resource_write(struct fd_batch *batch, struct fd_resource *rsc)
       struct fd_batch *dep;
 
       if (rsc->track->write_batch)
-         flush_write_batch(rsc);
+         flush_write_batch(batch, rsc);
 
       foreach_batch (dep, cache, rsc->track->batch_mask) {
          struct fd_batch *b = NULL;
@@ -524,7 +530,7 @@ fd_batch_resource_read_slowpath(struct fd_batch *batch, struct fd_resource *rsc)
     * flush the current batch in _resource_used()
     */
    if (unlikely(rsc->track->write_batch && rsc->track->write_batch != batch))
-      flush_write_batch(rsc);
+      flush_write_batch(batch, rsc);
 
    fd_batch_add_resource(batch, rsc);
 }
@@ -541,12 +547,15 @@ fd_batch_check_size(struct fd_batch *batch)
    const unsigned limit_bits = 8 * 8 * 1024 * 1024;
    if ((batch->prim_strm_bits > limit_bits) ||
        (batch->draw_strm_bits > limit_bits)) {
+      batch->ctx->stats.flush_size++;
       fd_batch_flush(batch);
       return;
    }
 
-   if (!fd_ringbuffer_check_size(batch->draw))
+   if (!fd_ringbuffer_check_size(batch->draw)) {
+      batch->ctx->stats.flush_size++;
       fd_batch_flush(batch);
+   }
 }
 
 /* emit a WAIT_FOR_IDLE only if needed, ie. if there has not already
@@ -394,10 +394,12 @@ fd_context_destroy(struct pipe_context *pctx)
    if (FD_DBG(BSTAT) || FD_DBG(MSGS)) {
       mesa_logi(
          "batch_total=%u, batch_sysmem=%u, batch_gmem=%u, batch_nondraw=%u, "
-         "batch_restore=%u\n",
+         "batch_restore=%u, flush_hazard=%u, flush_size=%u, "
+         "flush_fb_switch=%u\n",
          (uint32_t)ctx->stats.batch_total, (uint32_t)ctx->stats.batch_sysmem,
          (uint32_t)ctx->stats.batch_gmem, (uint32_t)ctx->stats.batch_nondraw,
-         (uint32_t)ctx->stats.batch_restore);
+         (uint32_t)ctx->stats.batch_restore, (uint32_t)ctx->stats.flush_hazard,
+         (uint32_t)ctx->stats.flush_size, (uint32_t)ctx->stats.flush_fb_switch);
    }
 }
 
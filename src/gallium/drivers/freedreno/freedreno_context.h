@@ -282,6 +282,8 @@ struct fd_context {
       uint64_t draw_calls;
       uint64_t batch_total, batch_sysmem, batch_gmem, batch_nondraw,
          batch_restore;
+      /* Why batches were flushed before the app asked for it: */
+      uint64_t flush_hazard, flush_size, flush_fb_switch;
       uint64_t staging_uploads, shadow_uploads;
       uint64_t vs_regs, hs_regs, ds_regs, gs_regs, fs_regs;
    } stats dt;
@@ -145,6 +145,9 @@ static const struct pipe_driver_query_info sw_query_list[] = {
    FQ("shadow", SHADOW_UPLOADS, UINT64, AVERAGE),
    FQ("vsregs", VS_REGS, FLOAT, AVERAGE),
    FQ("fsregs", FS_REGS, FLOAT, AVERAGE),
+   FQ("flush-hazard", FLUSH_HAZARD, UINT64, AVERAGE),
+   FQ("flush-size", FLUSH_SIZE, UINT64, AVERAGE),
+   FQ("flush-fb-switch", FLUSH_FB_SWITCH, UINT64, AVERAGE),
 };
 
 static int
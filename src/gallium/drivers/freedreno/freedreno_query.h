@@ -88,10 +88,19 @@ fd_query(struct pipe_query *pq)
 #define FD_QUERY_FS_REGS                                                       \
    (PIPE_QUERY_DRIVER_SPECIFIC +                                               \
     9) /* avg # of VS registers (scaled up by 100x) */
+#define FD_QUERY_FLUSH_HAZARD                                                  \
+   (PIPE_QUERY_DRIVER_SPECIFIC +                                               \
+    10) /* batches flushed early due to a resource hazard */
+#define FD_QUERY_FLUSH_SIZE                                                    \
+   (PIPE_QUERY_DRIVER_SPECIFIC +                                               \
+    11) /* batches flushed early due to cmdstream size */
+#define FD_QUERY_FLUSH_FB_SWITCH                                               \
+   (PIPE_QUERY_DRIVER_SPECIFIC +                                               \
+    12) /* batches flushed early due to framebuffer switch (no reorder) */
 /* insert any new non-perfcntr queries here, the first perfcntr index
  * needs to come last!
  */
-#define FD_QUERY_FIRST_PERFCNTR (PIPE_QUERY_DRIVER_SPECIFIC + 10)
+#define FD_QUERY_FIRST_PERFCNTR (PIPE_QUERY_DRIVER_SPECIFIC + 13)
 
 void fd_query_screen_init(struct pipe_screen *pscreen);
 void fd_query_context_init(struct pipe_context *pctx);
@@ -75,6 +75,12 @@ read_counter(struct fd_context *ctx, int type) assert_dt
       return ctx->stats.vs_regs;
    case FD_QUERY_FS_REGS:
       return ctx->stats.fs_regs;
+   case FD_QUERY_FLUSH_HAZARD:
+      return ctx->stats.flush_hazard;
+   case FD_QUERY_FLUSH_SIZE:
+      return ctx->stats.flush_size;
+   case FD_QUERY_FLUSH_FB_SWITCH:
+      return ctx->stats.flush_fb_switch;
    }
    return 0;
 }
@@ -90,6 +96,9 @@ is_time_rate_query(struct fd_query *q)
    case FD_QUERY_BATCH_RESTORE:
    case FD_QUERY_STAGING_UPLOADS:
    case FD_QUERY_SHADOW_UPLOADS:
+   case FD_QUERY_FLUSH_HAZARD:
+   case FD_QUERY_FLUSH_SIZE:
+   case FD_QUERY_FLUSH_FB_SWITCH:
       return true;
    default:
       return false;
@@ -186,6 +195,9 @@ fd_sw_create_query(struct fd_context *ctx, unsigned query_type, unsigned index)
    case FD_QUERY_SHADOW_UPLOADS:
    case FD_QUERY_VS_REGS:
    case FD_QUERY_FS_REGS:
+   case FD_QUERY_FLUSH_HAZARD:
+   case FD_QUERY_FLUSH_SIZE:
+   case FD_QUERY_FLUSH_FB_SWITCH:
       break;
    default:
       return NULL;
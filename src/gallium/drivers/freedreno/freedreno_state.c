@@ -307,6 +307,7 @@ fd_set_framebuffer_state(struct pipe_context *pctx,
    } else if (ctx->batch) {
       DBG("%d: cbufs[0]=%p, zsbuf=%p", ctx->batch->needs_flush,
           framebuffer->cbufs[0], framebuffer->zsbuf);
+      ctx->stats.flush_fb_switch++;
       fd_batch_flush(ctx->batch);
    }
 
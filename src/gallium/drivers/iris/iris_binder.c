@@ -76,6 +76,9 @@ binder_realloc(struct iris_context *ice)
    /* Avoid using offset 0 - tools consider it NULL. */
    binder->insert_point = binder->alignment;
 
+   /* Old binding tables live in the old BO, so none of them can be reused */
+   memset(binder->prev_bt_offset, 0, sizeof(binder->prev_bt_offset));
+
    /* Allocating a new binder requires changing Surface State Base Address,
     * which also invalidates all our previous binding tables - each entry
     * in those tables is an offset from the old base.
@@ -133,6 +136,8 @@ iris_binder_reserve_3d(struct iris_context *ice)
    unsigned sizes[MESA_SHADER_STAGES] = {};
    unsigned total_size;
 
+   binder->reserve_3d_start = binder->reserve_3d_end = 0;
+
    /* If nothing is dirty, skip all this. */
    if (!(ice->state.dirty & IRIS_DIRTY_RENDER_BUFFER) &&
        !(ice->state.stage_dirty & IRIS_ALL_STAGE_DIRTY_BINDINGS_FOR_RENDER))
@@ -173,8 +178,12 @@ iris_binder_reserve_3d(struct iris_context *ice)
    /* Assign space and record the new binding table offsets. */
    uint32_t offset = binder_insert(binder, total_size);
 
+   binder->reserve_3d_start = offset;
+   binder->reserve_3d_end = binder->insert_point;
+
    for (int stage = 0; stage <= MESA_SHADER_FRAGMENT; stage++) {
       if (ice->state.stage_dirty & (IRIS_STAGE_DIRTY_BINDINGS_VS << stage)) {
+         binder->prev_bt_offset[stage] = binder->bt_offset[stage];
          binder->bt_offset[stage] = sizes[stage] > 0 ? offset : 0;
          iris_record_state_size(ice->state.sizes,
                                 binder->bo->address + offset, sizes[stage]);
@@ -183,6 +192,54 @@ iris_binder_reserve_3d(struct iris_context *ice)
    }
 }
 
+/**
+ * Point dirty 3D stages back at their previous binding table when the one
+ * just populated is identical to it.
+ *
+ * Rebinding the same resources still flags the bindings dirty, so redundant
+ * tables would otherwise keep filling the binder, eventually forcing a new
+ * BO (and on Gfx8-10 a new Surface State Base Address).  If every stage's
+ * table turned out to be redundant, the reservation is given back as well.
+ *
+ * Must be called after populating the tables from the last
+ * iris_binder_reserve_3d(), before anything else reserves binder space.
+ */
+void
+iris_binder_dedup_3d(struct iris_context *ice, uint64_t stage_dirty)
+{
+   struct iris_compiled_shader **shaders = ice->shaders.prog;
+   struct iris_binder *binder = &ice->state.binder;
+   bool all_reused = true;
+
+   /* Nothing was reserved */
+   if (binder->reserve_3d_end == 0)
+      return;
+
+   for (int stage = 0; stage <= MESA_SHADER_FRAGMENT; stage++) {
+      if (!(stage_dirty & (IRIS_STAGE_DIRTY_BINDINGS_VS << stage)))
+         continue;
+
+      const uint32_t offset = binder->bt_offset[stage];
+      const uint32_t prev = binder->prev_bt_offset[stage];
+      const unsigned size = shaders[stage] ? shaders[stage]->bt.size_bytes : 0;
+
+      if (offset == 0)
+         continue;
+
+      /* Previous tables all precede the new reservation */
+      if (prev == 0 || prev + size > binder->reserve_3d_start ||
+          memcmp(binder->map + prev, binder->map + offset, size) != 0) {
+         all_reused = false;
+         continue;
+      }
+
+      binder->bt_offset[stage] = prev;
+   }
+
+   if (all_reused && binder->insert_point == binder->reserve_3d_end)
+      binder->insert_point = binder->reserve_3d_start;
+}
+
 void
 iris_binder_reserve_compute(struct iris_context *ice)
 {
@@ -53,12 +53,22 @@ struct iris_binder
     * Zero is considered invalid and means there's no binding table.
     */
    uint32_t bt_offset[MESA_SHADER_STAGES];
+
+   /**
+    * Binding table offsets replaced by the last 3D reservation, still valid
+    * in the current BO.  Zero if there was none.
+    */
+   uint32_t prev_bt_offset[MESA_SHADER_STAGES];
+
+   /** Range of the last 3D reservation, in bytes */
+   uint32_t reserve_3d_start, reserve_3d_end;
 };
 
 void iris_init_binder(struct iris_context *ice);
 void iris_destroy_binder(struct iris_binder *binder);
 uint32_t iris_binder_reserve(struct iris_context *ice, unsigned size);
 void iris_binder_reserve_3d(struct iris_context *ice);
+void iris_binder_dedup_3d(struct iris_context *ice, uint64_t stage_dirty);
 void iris_binder_reserve_compute(struct iris_context *ice);
 
 #endif
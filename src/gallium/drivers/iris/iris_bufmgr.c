@@ -61,6 +61,7 @@
 #include "util/list.h"
 #include "util/os_file.h"
 #include "util/u_dynarray.h"
+#include "util/u_thread.h"
 #include "util/vma.h"
 #include "iris_bufmgr.h"
 #include "iris_context.h"
@@ -221,6 +222,17 @@ struct iris_bufmgr {
     */
    struct list_head zombie_list;
 
+   /**
+    * Thread periodically freeing old cached BOs and idle zombies, so that
+    * doesn't happen inline in iris_bo_unreference().  Protected by
+    * reaper_mutex rather than lock.
+    */
+   thrd_t reaper_thread;
+   mtx_t reaper_mutex;
+   cnd_t reaper_cond;
+   bool reaper_running;
+   bool reaper_exit;
+
    struct util_vma_heap vma_allocator[IRIS_MEMZONE_COUNT];
 
    uint64_t vma_min_align;
@@ -1467,6 +1479,78 @@ cleanup_bo_cache(struct iris_bufmgr *bufmgr, time_t time)
    bufmgr->time = time;
 }
 
+static int
+iris_bufmgr_reaper(void *data)
+{
+   struct iris_bufmgr *bufmgr = data;
+
+   mtx_lock(&bufmgr->reaper_mutex);
+   while (!bufmgr->reaper_exit) {
+      struct timespec timeout;
+      timespec_get(&timeout, TIME_UTC);
+      timeout.tv_sec += 1;
+
+      cnd_timedwait(&bufmgr->reaper_cond, &bufmgr->reaper_mutex, &timeout);
+      if (bufmgr->reaper_exit)
+         break;
+
+      mtx_unlock(&bufmgr->reaper_mutex);
+
+      struct timespec time;
+      clock_gettime(CLOCK_MONOTONIC, &time);
+
+      simple_mtx_lock(&bufmgr->lock);
+      cleanup_bo_cache(bufmgr, time.tv_sec);
+      simple_mtx_unlock(&bufmgr->lock);
+
+      mtx_lock(&bufmgr->reaper_mutex);
+   }
+   mtx_unlock(&bufmgr->reaper_mutex);
+
+   return 0;
+}
+
+static void
+iris_bufmgr_start_reaper(struct iris_bufmgr *bufmgr)
+{
+   if (mtx_init(&bufmgr->reaper_mutex, mtx_plain) != thrd_success)
+      return;
+
+   if (cnd_init(&bufmgr->reaper_cond) != thrd_success) {
+      mtx_destroy(&bufmgr->reaper_mutex);
+      return;
+   }
+
+   bufmgr->reaper_exit = false;
+   if (u_thread_create(&bufmgr->reaper_thread, iris_bufmgr_reaper,
+                       bufmgr) != thrd_success) {
+      /* iris_bo_unreference() will keep cleaning up inline */
+      cnd_destroy(&bufmgr->reaper_cond);
+      mtx_destroy(&bufmgr->reaper_mutex);
+      return;
+   }
+
+   bufmgr->reaper_running = true;
+}
+
+static void
+iris_bufmgr_stop_reaper(struct iris_bufmgr *bufmgr)
+{
+   if (!bufmgr->reaper_running)
+      return;
+
+   mtx_lock(&bufmgr->reaper_mutex);
+   bufmgr->reaper_exit = true;
+   cnd_signal(&bufmgr->reaper_cond);
+   mtx_unlock(&bufmgr->reaper_mutex);
+
+   thrd_join(bufmgr->reaper_thread, NULL);
+
+   cnd_destroy(&bufmgr->reaper_cond);
+   mtx_destroy(&bufmgr->reaper_mutex);
+   bufmgr->reaper_running = false;
+}
+
 static void
 bo_unreference_final(struct iris_bo *bo, time_t time)
 {
@@ -1512,7 +1596,9 @@ iris_bo_unreference(struct iris_bo *bo)
 
          if (p_atomic_dec_zero(&bo->refcount)) {
             bo_unreference_final(bo, time.tv_sec);
-            cleanup_bo_cache(bufmgr, time.tv_sec);
+
+            if (!bufmgr->reaper_running)
+               cleanup_bo_cache(bufmgr, time.tv_sec);
          }
 
          simple_mtx_unlock(&bufmgr->lock);
@@ -1763,6 +1849,8 @@ iris_bo_wait_rendering(struct iris_bo *bo)
 static void
 iris_bufmgr_destroy(struct iris_bufmgr *bufmgr)
 {
+   iris_bufmgr_stop_reaper(bufmgr);
+
    iris_destroy_border_color_pool(&bufmgr->border_color_pool);
 
    /* Free aux-map buffers */
@@ -2508,6 +2596,8 @@ iris_bufmgr_create(struct intel_device_info *devinfo, int fd, bool bo_reuse)
 
    iris_init_border_color_pool(bufmgr, &bufmgr->border_color_pool);
 
+   iris_bufmgr_start_reaper(bufmgr);
+
    return bufmgr;
 }
 
@@ -87,6 +87,8 @@ iris_destroy_screen_measure(struct iris_screen *screen)
 
    struct intel_measure_device *measure_device = &screen->measure;
 
+   intel_measure_finish(measure_device);
+
    if (measure_device->config->file &&
        measure_device->config->file != stderr)
       fclose(screen->measure.config->file);
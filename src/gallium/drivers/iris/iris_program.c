@@ -2495,6 +2495,43 @@ iris_create_uncompiled_shader(struct iris_screen *screen,
    return ish;
 }
 
+static void
+iris_compile_shader(void *_job, UNUSED void *_gdata, UNUSED int thread_index)
+{
+   const struct iris_threaded_compile_job *job =
+      (struct iris_threaded_compile_job *) _job;
+
+   struct iris_screen *screen = job->screen;
+   struct u_upload_mgr *uploader = job->uploader;
+   struct util_debug_callback *dbg = job->dbg;
+   struct iris_uncompiled_shader *ish = job->ish;
+   struct iris_compiled_shader *shader = job->shader;
+
+   switch (ish->nir->info.stage) {
+   case MESA_SHADER_VERTEX:
+      iris_compile_vs(screen, uploader, dbg, ish, shader);
+      break;
+   case MESA_SHADER_TESS_CTRL:
+      iris_compile_tcs(screen, NULL, uploader, dbg, ish, shader);
+      break;
+   case MESA_SHADER_TESS_EVAL:
+      iris_compile_tes(screen, uploader, dbg, ish, shader);
+      break;
+   case MESA_SHADER_GEOMETRY:
+      iris_compile_gs(screen, uploader, dbg, ish, shader);
+      break;
+   case MESA_SHADER_FRAGMENT:
+      iris_compile_fs(screen, uploader, dbg, ish, shader, NULL);
+      break;
+   case MESA_SHADER_COMPUTE:
+      iris_compile_cs(screen, uploader, dbg, ish, shader);
+      break;
+
+   default:
+      unreachable("Invalid shader stage.");
+   }
+}
+
 static void *
 iris_create_compute_state(struct pipe_context *ctx,
                           const struct pipe_compute_state *state)
@@ -2550,45 +2587,21 @@ iris_create_compute_state(struct pipe_context *ctx,
 
       if (!iris_disk_cache_retrieve(screen, uploader, ish, shader,
                                     &key, sizeof(key))) {
-         iris_compile_cs(screen, uploader, &ice->dbg, ish, shader);
-      }
-   }
-
-   return ish;
-}
-
-static void
-iris_compile_shader(void *_job, UNUSED void *_gdata, UNUSED int thread_index)
-{
-   const struct iris_threaded_compile_job *job =
-      (struct iris_threaded_compile_job *) _job;
+         assert(!util_queue_fence_is_signalled(&shader->ready));
 
-   struct iris_screen *screen = job->screen;
-   struct u_upload_mgr *uploader = job->uploader;
-   struct util_debug_callback *dbg = job->dbg;
-   struct iris_uncompiled_shader *ish = job->ish;
-   struct iris_compiled_shader *shader = job->shader;
+         struct iris_threaded_compile_job *job = calloc(1, sizeof(*job));
 
-   switch (ish->nir->info.stage) {
-   case MESA_SHADER_VERTEX:
-      iris_compile_vs(screen, uploader, dbg, ish, shader);
-      break;
-   case MESA_SHADER_TESS_CTRL:
-      iris_compile_tcs(screen, NULL, uploader, dbg, ish, shader);
-      break;
-   case MESA_SHADER_TESS_EVAL:
-      iris_compile_tes(screen, uploader, dbg, ish, shader);
-      break;
-   case MESA_SHADER_GEOMETRY:
-      iris_compile_gs(screen, uploader, dbg, ish, shader);
-      break;
-   case MESA_SHADER_FRAGMENT:
-      iris_compile_fs(screen, uploader, dbg, ish, shader, NULL);
-      break;
+         job->screen = screen;
+         job->uploader = uploader;
+         job->ish = ish;
+         job->shader = shader;
 
-   default:
-      unreachable("Invalid shader stage.");
+         iris_schedule_compile(screen, &ish->ready, &ice->dbg, job,
+                               iris_compile_shader);
+      }
    }
+
+   return ish;
 }
 
 static void *
@@ -29,9 +29,36 @@
  */
 
 #include "util/u_thread.h"
+#include "util/u_atomic.h"
 #include "util/u_memory.h"
+#include "util/u_cpu_detect.h"
 #include "lp_cs_tpool.h"
 
+/**
+ * Claim the next chunk of iterations of a task.  The chunk size is a
+ * fraction of the remaining iterations, so that large grids are handed
+ * out in few big chunks while the tail is still balanced between the
+ * threads.
+ * \return number of iterations claimed, 0 if none are left
+ */
+static unsigned
+lp_cs_tpool_claim_iters(struct lp_cs_tpool_task *task, unsigned *first)
+{
+   unsigned start = p_atomic_read(&task->iter_start);
+
+   while (start < task->iter_total) {
+      unsigned remaining = task->iter_total - start;
+      unsigned count = MAX2(remaining / (2 * task->num_threads), 1);
+      unsigned old = p_atomic_cmpxchg(&task->iter_start, start, start + count);
+      if (old == start) {
+         *first = start;
+         return count;
+      }
+      start = old;
+   }
+   return 0;
+}
+
 static int
 lp_cs_tpool_worker(void *data)
 {
@@ -43,7 +70,7 @@ lp_cs_tpool_worker(void *data)
 
    while (!pool->shutdown) {
       struct lp_cs_tpool_task *task;
-      unsigned iter_per_thread;
+      unsigned first, count;
 
       while (list_is_empty(&pool->workqueue) && !pool->shutdown)
          cnd_wait(&pool->new_work, &pool->m);
@@ -54,28 +81,28 @@ lp_cs_tpool_worker(void *data)
       task = list_first_entry(&pool->workqueue, struct lp_cs_tpool_task,
                               list);
 
-      unsigned this_iter = task->iter_start;
-
-      iter_per_thread = task->iter_per_thread;
-
-      if (task->iter_remainder &&
-          task->iter_start + task->iter_remainder == task->iter_total) {
-         task->iter_remainder--;
-         iter_per_thread = 1;
+      /* Once all iterations of a task have been claimed, move on to the
+       * next one so that queued tasks overlap.
+       */
+      if (p_atomic_read(&task->iter_start) >= task->iter_total) {
+         list_delinit(&task->list);
+         continue;
       }
 
-      task->iter_start += iter_per_thread;
-
-      if (task->iter_start == task->iter_total)
-         list_del(&task->list);
-
+      task->num_workers++;
       mtx_unlock(&pool->m);
-      for (unsigned i = 0; i < iter_per_thread; i++)
-         task->work(task->data, this_iter + i, &lmem);
+
+      while ((count = lp_cs_tpool_claim_iters(task, &first))) {
+         for (unsigned i = 0; i < count; i++)
+            task->work(task->data, first + i, &lmem);
+         p_atomic_add(&task->iter_finished, count);
+      }
 
       mtx_lock(&pool->m);
-      task->iter_finished += iter_per_thread;
-      if (task->iter_finished == task->iter_total)
+      if (!list_is_empty(&task->list))
+         list_delinit(&task->list);
+      if (--task->num_workers == 0 &&
+          p_atomic_read(&task->iter_finished) == task->iter_total)
          cnd_broadcast(&task->finish);
    }
    mtx_unlock(&pool->m);
@@ -84,7 +111,7 @@ lp_cs_tpool_worker(void *data)
 }
 
 struct lp_cs_tpool *
-lp_cs_tpool_create(unsigned num_threads)
+lp_cs_tpool_create(unsigned num_threads, unsigned num_groups)
 {
    struct lp_cs_tpool *pool = CALLOC_STRUCT(lp_cs_tpool);
 
@@ -102,6 +129,16 @@ lp_cs_tpool_create(unsigned num_threads)
          break;
       }
    }
+
+   if (num_groups > 1) {
+      const struct util_cpu_caps_t *caps = util_get_cpu_caps();
+      for (unsigned i = 0; i < num_threads; i++) {
+         unsigned group = lp_thread_group(i, num_threads, num_groups);
+         util_set_thread_affinity(pool->threads[i],
+                                  caps->L3_affinity_mask[group],
+                                  NULL, caps->num_cpu_mask_bits);
+      }
+   }
    pool->num_threads = num_threads;
    return pool;
 }
@@ -150,9 +187,7 @@ lp_cs_tpool_queue_task(struct lp_cs_tpool *pool,
    task->work = work;
    task->data = data;
    task->iter_total = num_iters;
-
-   task->iter_per_thread = num_iters / pool->num_threads;
-   task->iter_remainder = num_iters % pool->num_threads;
+   task->num_threads = pool->num_threads;
 
    cnd_init(&task->finish);
 
@@ -175,7 +210,8 @@ lp_cs_tpool_wait_for_task(struct lp_cs_tpool *pool,
       return;
 
    mtx_lock(&pool->m);
-   while (task->iter_finished < task->iter_total)
+   while (p_atomic_read(&task->iter_finished) < task->iter_total ||
+          task->num_workers)
       cnd_wait(&task->finish, &pool->m);
    mtx_unlock(&pool->m);
 
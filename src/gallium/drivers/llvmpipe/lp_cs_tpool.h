@@ -58,6 +58,11 @@ struct lp_cs_local_mem {
 
 typedef void (*lp_cs_tpool_task_func)(void *data, int iter_idx, struct lp_cs_local_mem *lmem);
 
+/* Iterations are claimed by the workers in chunks which shrink as the
+ * task nears completion (guided scheduling), with atomic operations on
+ * iter_start and iter_finished.  The pool mutex is only taken when a
+ * worker starts or stops working on a task.
+ */
 struct lp_cs_tpool_task {
    lp_cs_tpool_task_func work;
    void *data;
@@ -66,11 +71,13 @@ struct lp_cs_tpool_task {
    unsigned iter_total;
    unsigned iter_start;
    unsigned iter_finished;
-   unsigned iter_per_thread;
-   unsigned iter_remainder;
+   /** Workers currently claiming iterations from the task, under pool->m */
+   unsigned num_workers;
+   unsigned num_threads;
 };
 
-struct lp_cs_tpool *lp_cs_tpool_create(unsigned num_threads);
+struct lp_cs_tpool *lp_cs_tpool_create(unsigned num_threads,
+                                       unsigned num_groups);
 void lp_cs_tpool_destroy(struct lp_cs_tpool *);
 
 struct lp_cs_tpool_task *lp_cs_tpool_queue_task(struct lp_cs_tpool *,
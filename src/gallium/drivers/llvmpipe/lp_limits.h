@@ -66,7 +66,18 @@
 
 #define LP_MAX_SAMPLES 4
 
-#define LP_MAX_THREADS 32
+#define LP_MAX_THREADS 64
+
+/**
+ * Map a rasterizer or compute worker thread to a thread group, when the
+ * threads are split into groups pinned to one L3 cache (NUMA node) each.
+ * Threads are assigned to groups in contiguous ranges.
+ */
+static inline unsigned
+lp_thread_group(unsigned thread, unsigned num_threads, unsigned num_groups)
+{
+   return num_threads ? thread * num_groups / num_threads : 0;
+}
 
 
 /**
@@ -29,6 +29,9 @@ struct lp_linear_sampler {
    int width;
    boolean axis_aligned;
 
+   /** BGRA fetch wrapped by fetch_swap_rb() for RGBA textures */
+   lp_linear_func fetch_bgra;
+
    alignas(16) uint32_t row[64];
    alignas(16) uint32_t stretched_row[2][64];
 
@@ -656,6 +656,31 @@ fetch_bgrx_linear(struct lp_linear_elem *elem)
 }
 
 
+/*
+ * Fetch a row with the BGRA routine and swap red and blue, so RGBA and
+ * RGBX textures can share all of the BGRA sampling code.
+ */
+static const uint32_t *
+fetch_swap_rb(struct lp_linear_elem *elem)
+{
+   struct lp_linear_sampler *samp = (struct lp_linear_sampler *)elem;
+   const uint32_t *src = samp->fetch_bgra(elem);
+   uint32_t *row = samp->row;
+   const __m128i ga_mask = _mm_set1_epi32(0xff00ff00);
+   const __m128i rb_mask = _mm_set1_epi32(0x00ff00ff);
+
+   for (int i = 0; i < samp->width; i += 4) {
+      __m128i texels = _mm_loadu_si128((const __m128i *)&src[i]);
+      __m128i rb = _mm_and_si128(texels, rb_mask);
+      rb = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+      texels = _mm_or_si128(_mm_and_si128(texels, ga_mask), rb);
+      *(__m128i *)&row[i] = texels;
+   }
+
+   return row;
+}
+
+
 static boolean
 sampler_is_nearest(const struct lp_linear_sampler *samp,
                    const struct lp_sampler_static_state *sampler_state,
@@ -759,6 +784,19 @@ lp_linear_init_sampler(struct lp_linear_sampler *samp,
    boolean minify;
    boolean need_wrap;
    boolean is_nearest;
+   enum pipe_format format = sampler_state->texture_state.format;
+   boolean swap_rb = FALSE;
+
+   /* RGBA textures are sampled as BGRA, with red and blue swapped after
+    * the fetch.
+    */
+   if (format == PIPE_FORMAT_R8G8B8A8_UNORM) {
+      format = PIPE_FORMAT_B8G8R8A8_UNORM;
+      swap_rb = TRUE;
+   } else if (format == PIPE_FORMAT_R8G8B8X8_UNORM) {
+      format = PIPE_FORMAT_B8G8R8X8_UNORM;
+      swap_rb = TRUE;
+   }
 
    samp->texture = texture;
    samp->width = width;
@@ -872,7 +910,7 @@ lp_linear_init_sampler(struct lp_linear_sampler *samp,
    }
 
    if (is_nearest) {
-      switch (sampler_state->texture_state.format) {
+      switch (format) {
       case PIPE_FORMAT_B8G8R8A8_UNORM:
          if (need_wrap)
             samp->base.fetch = fetch_bgra_clamp;
@@ -882,7 +920,7 @@ lp_linear_init_sampler(struct lp_linear_sampler *samp,
             samp->base.fetch = fetch_bgra_axis_aligned;
          else
             samp->base.fetch = fetch_bgra_memcpy;
-         return TRUE;
+         break;
       case PIPE_FORMAT_B8G8R8X8_UNORM:
          if (need_wrap)
             samp->base.fetch = fetch_bgrx_clamp;
@@ -892,18 +930,16 @@ lp_linear_init_sampler(struct lp_linear_sampler *samp,
             samp->base.fetch = fetch_bgrx_axis_aligned;
          else
             samp->base.fetch = fetch_bgrx_memcpy;
-         return TRUE;
-      default:
          break;
+      default:
+         FAIL("unknown format for nearest");
       }
-
-      FAIL("unknown format for nearest");
    } else {
       samp->stretched_row_y[0] = -1;
       samp->stretched_row_y[1] = -1;
       samp->stretched_row_index = 0;
 
-      switch (sampler_state->texture_state.format) {
+      switch (format) {
       case PIPE_FORMAT_B8G8R8A8_UNORM:
          if (need_wrap)
             samp->base.fetch = fetch_bgra_clamp_linear;
@@ -911,7 +947,7 @@ lp_linear_init_sampler(struct lp_linear_sampler *samp,
             samp->base.fetch = fetch_bgra_linear;
          else
             samp->base.fetch = fetch_bgra_axis_aligned_linear;
-         return TRUE;
+         break;
       case PIPE_FORMAT_B8G8R8X8_UNORM:
          if (need_wrap)
             samp->base.fetch = fetch_bgrx_clamp_linear;
@@ -919,13 +955,18 @@ lp_linear_init_sampler(struct lp_linear_sampler *samp,
             samp->base.fetch = fetch_bgrx_linear;
          else
             samp->base.fetch = fetch_bgrx_axis_aligned_linear;
-         return TRUE;
-      default:
          break;
+      default:
+         FAIL("unknown format");
       }
+   }
 
-      FAIL("unknown format");
+   if (swap_rb) {
+      samp->fetch_bgra = samp->base.fetch;
+      samp->base.fetch = fetch_swap_rb;
    }
+
+   return TRUE;
 }
 
 
@@ -974,7 +1015,9 @@ lp_linear_check_sampler(const struct lp_sampler_static_state *sampler,
    /* These are the only texture formats we support at the moment
     */
    if (sampler->texture_state.format != PIPE_FORMAT_B8G8R8A8_UNORM &&
-       sampler->texture_state.format != PIPE_FORMAT_B8G8R8X8_UNORM)
+       sampler->texture_state.format != PIPE_FORMAT_B8G8R8X8_UNORM &&
+       sampler->texture_state.format != PIPE_FORMAT_R8G8B8A8_UNORM &&
+       sampler->texture_state.format != PIPE_FORMAT_R8G8B8X8_UNORM)
       return FALSE;
 
    /* We don't support sampler view swizzling on the linear path */
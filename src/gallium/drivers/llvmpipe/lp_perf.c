@@ -74,6 +74,7 @@ lp_print_counters(void)
       debug_printf("llvmpipe:        nr_pure_shade:         %9u (%3.0f%% of %u)\n", lp_count.nr_pure_shade_64, 0.0, lp_count.nr_shade_64);
       debug_printf("llvmpipe:   nr_partially_covered_64x64: %9u (%3.0f%% of %u)\n", lp_count.nr_partially_covered_64, p3, total_64);
       debug_printf("llvmpipe:   nr_empty_64x64:             %9u (%3.0f%% of %u)\n", lp_count.nr_empty_64, p1, total_64);
+      debug_printf("llvmpipe:   nr_zculled_64x64:           %9u\n", lp_count.nr_zculled_64);
 
       total_16 = (lp_count.nr_empty_16 + 
                   lp_count.nr_fully_covered_16 +
@@ -122,5 +123,9 @@ lp_print_counters(void)
       debug_printf("llvmpipe: total LLVM compile time:      %.2f sec\n", lp_count.llvm_compile_time / 1000000.0);
       debug_printf("llvmpipe: average LLVM compile time:    %.2f sec\n", lp_count.llvm_compile_time / 1000000.0 / lp_count.nr_llvm_compiles);
 
+      debug_printf("llvmpipe: nr_cs_dispatches:             %u\n", lp_count.nr_cs_dispatches);
+      debug_printf("llvmpipe: total compute dispatch time:  %.2f sec\n", lp_count.cs_dispatch_time / 1000000.0);
+      debug_printf("llvmpipe: average compute dispatch time: %.2f usec\n", (double) lp_count.cs_dispatch_time / lp_count.nr_cs_dispatches);
+
    }
 }
@@ -47,6 +47,7 @@ struct lp_counters
    unsigned nr_empty_64;
    unsigned nr_fully_covered_64;
    unsigned nr_partially_covered_64;
+   unsigned nr_zculled_64;
    unsigned nr_blit_64;
    unsigned nr_pure_blit_64;
    unsigned nr_pure_shade_opaque_64;
@@ -64,6 +65,8 @@ struct lp_counters
    unsigned nr_non_empty_4;
    unsigned nr_llvm_compiles;
    int64_t llvm_compile_time;  /**< total, in microseconds */
+   unsigned nr_cs_dispatches;
+   int64_t cs_dispatch_time;  /**< total, in microseconds */
 
    unsigned nr_color_tile_clear;
    unsigned nr_color_tile_load;
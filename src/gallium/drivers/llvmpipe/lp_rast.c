@@ -27,6 +27,7 @@
 
 #include <limits.h>
 #include "util/u_memory.h"
+#include "util/u_cpu_detect.h"
 #include "util/u_math.h"
 #include "util/u_rect.h"
 #include "util/u_surface.h"
@@ -78,7 +79,7 @@ lp_rast_begin(struct lp_rasterizer *rast,
    LP_DBG(DEBUG_RAST, "%s\n", __FUNCTION__);
 
    lp_scene_begin_rasterization(scene);
-   lp_scene_bin_iter_begin(scene);
+   lp_scene_bin_iter_begin(scene, rast->num_threads, rast->num_groups);
 }
 
 
@@ -1060,7 +1061,8 @@ rasterize_scene(struct lp_rasterizer_task *task,
          int i, j;
 
          assert(scene);
-         while ((bin = lp_scene_bin_iter_next(scene, &i, &j))) {
+         while ((bin = lp_scene_bin_iter_next(scene, task->thread_index,
+                                                &i, &j))) {
             if (!is_empty_bin(bin))
                rasterize_bin(task, bin, i, j);
          }
@@ -1245,6 +1247,18 @@ create_rast_threads(struct lp_rasterizer *rast)
          break;
       }
    }
+
+   rast->num_groups = MIN2(rast->num_groups, MAX2(rast->num_threads, 1));
+   if (rast->num_groups > 1) {
+      const struct util_cpu_caps_t *caps = util_get_cpu_caps();
+      for (unsigned i = 0; i < rast->num_threads; i++) {
+         unsigned group = lp_thread_group(i, rast->num_threads,
+                                          rast->num_groups);
+         util_set_thread_affinity(rast->threads[i],
+                                  caps->L3_affinity_mask[group],
+                                  NULL, caps->num_cpu_mask_bits);
+      }
+   }
 }
 
 
@@ -1254,7 +1268,7 @@ create_rast_threads(struct lp_rasterizer *rast)
  * \param num_threads  number of rasterizer threads to create
  */
 struct lp_rasterizer *
-lp_rast_create(unsigned num_threads)
+lp_rast_create(unsigned num_threads, unsigned num_groups)
 {
    struct lp_rasterizer *rast;
    unsigned i;
@@ -1281,6 +1295,7 @@ lp_rast_create(unsigned num_threads)
    }
 
    rast->num_threads = num_threads;
+   rast->num_groups = num_threads ? MAX2(num_groups, 1) : 1;
 
    rast->no_rast = debug_get_bool_option("LP_NO_RAST", FALSE);
 
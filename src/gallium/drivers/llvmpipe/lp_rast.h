@@ -230,7 +230,7 @@ GET_PLANES(const struct lp_rast_triangle *tri)
 
 
 struct lp_rasterizer *
-lp_rast_create(unsigned num_threads);
+lp_rast_create(unsigned num_threads, unsigned num_groups);
 
 void
 lp_rast_destroy(struct lp_rasterizer *);
@@ -127,6 +127,9 @@ struct lp_rasterizer
    unsigned num_threads;
    thrd_t threads[LP_MAX_THREADS];
 
+   /** Number of L3-cache groups the threads are pinned to (1 = none) */
+   unsigned num_groups;
+
    /** For synchronizing the rasterization threads */
    util_barrier barrier;
 
@@ -73,8 +73,6 @@ lp_scene_create(struct lp_setup_context *setup)
    scene->setup = setup;
    scene->data.head = &scene->data.first;
 
-   (void) mtx_init(&scene->mutex, mtx_plain);
-
 #ifdef DEBUG
    /* Do some scene limit sanity checks here */
    {
@@ -101,7 +99,7 @@ void
 lp_scene_destroy(struct lp_scene *scene)
 {
    lp_scene_end_rasterization(scene);
-   mtx_destroy(&scene->mutex);
+   free(scene->bin_order);
    free(scene->tiles);
    assert(scene->data.head == &scene->data.first);
    slab_free_st(&scene->setup->scene_slab, scene);
@@ -533,60 +531,164 @@ lp_scene_is_resource_referenced(const struct lp_scene *scene,
 }
 
 
-/** advance curr_x,y to the next bin */
-static boolean
-next_bin(struct lp_scene *scene)
+static int
+compare_bin_cost(const void *a, const void *b)
 {
-   scene->curr_x++;
-   if (scene->curr_x >= scene->tiles_x) {
-      scene->curr_x = 0;
-      scene->curr_y++;
+   const uint64_t ka = *(const uint64_t *)a;
+   const uint64_t kb = *(const uint64_t *)b;
+
+   /* decreasing cost */
+   return ka < kb ? 1 : ka > kb ? -1 : 0;
+}
+
+
+/**
+ * Prepare the per-thread bin queues for rasterization.
+ *
+ * The cost of each bin is estimated from the number of commands binned
+ * into it by setup.  Bins are sorted by decreasing cost and dealt out
+ * round-robin to the thread queues, so every thread starts on the most
+ * expensive tiles and the cheap ones are left over for balancing the load
+ * at the end through stealing.  Empty bins are never queued.
+ *
+ * When the threads are split in groups (one per L3 cache), the screen is
+ * split in as many horizontal bands, and the bins of each band are only
+ * dealt to the threads of the matching group.
+ */
+void
+lp_scene_bin_iter_begin(struct lp_scene *scene, unsigned num_threads,
+                        unsigned num_groups)
+{
+   const unsigned num_bins = lp_scene_get_num_bins(scene);
+   uint64_t *sorted = scene->bin_order + num_bins;
+   unsigned queue_start[LP_MAX_THREADS];
+   unsigned queue_count[LP_MAX_THREADS] = {0};
+   unsigned group_first[LP_MAX_THREADS + 1];
+   unsigned group_next[LP_MAX_THREADS] = {0};
+   unsigned num_queued = 0;
+
+   for (unsigned i = 0; i < num_bins; i++) {
+      const struct cmd_bin *bin = &scene->tiles[i];
+      uint64_t cost = 0;
+
+      if (!bin->head)
+         continue;
+
+      for (const struct cmd_block *block = bin->head; block;
+           block = block->next)
+         cost += block->count;
+
+      sorted[num_queued++] = (cost << 32) | i;
    }
-   if (scene->curr_y >= scene->tiles_y) {
-      /* no more bins */
-      return FALSE;
+
+   qsort(sorted, num_queued, sizeof(sorted[0]), compare_bin_cost);
+
+   scene->num_queues = CLAMP(num_threads, 1, LP_MAX_THREADS);
+   scene->num_groups = CLAMP(num_groups, 1, scene->num_queues);
+
+   /* first thread of each group */
+   for (unsigned g = 0, t = 0; g <= scene->num_groups; g++) {
+      while (t < scene->num_queues &&
+             lp_thread_group(t, scene->num_queues, scene->num_groups) < g)
+         t++;
+      group_first[g] = t;
+   }
+
+   /* Deal the bins to the queues.  The queue of each bin is stashed in
+    * the cost bits which are no longer needed once sorted.
+    */
+   for (unsigned i = 0; i < num_queued; i++) {
+      const unsigned idx = sorted[i] & 0xffffffff;
+      const unsigned g = (idx / scene->tiles_x) * scene->num_groups /
+                         scene->tiles_y;
+      const unsigned group_size = group_first[g + 1] - group_first[g];
+      const unsigned q = group_first[g] + group_next[g]++ % group_size;
+      sorted[i] = ((uint64_t)q << 32) | idx;
+      queue_count[q]++;
+   }
+
+   for (unsigned q = 0, start = 0; q < scene->num_queues; q++) {
+      queue_start[q] = start;
+      scene->queues[q].range = ((uint64_t)start << 32) |
+                               (start + queue_count[q]);
+      start += queue_count[q];
+   }
+
+   /* Scatter into per-queue ranges, keeping the decreasing cost order */
+   for (unsigned i = 0; i < num_queued; i++) {
+      const unsigned q = sorted[i] >> 32;
+      scene->bin_order[queue_start[q]++] = sorted[i] & 0xffffffff;
    }
-   return TRUE;
 }
 
 
-void
-lp_scene_bin_iter_begin(struct lp_scene *scene)
+/**
+ * Claim an entry from a bin queue, either from the head (owner) or the
+ * tail (thief).  Returns the bin index or -1 if the queue is empty.
+ */
+static int
+bin_queue_pop(struct lp_scene *scene, unsigned q, bool steal)
 {
-   scene->curr_x = scene->curr_y = -1;
+   struct lp_bin_queue *queue = &scene->queues[q];
+   uint64_t old = p_atomic_read(&queue->range);
+
+   while (1) {
+      const uint32_t head = old >> 32;
+      const uint32_t tail = old & 0xffffffff;
+      uint64_t new;
+      uint32_t entry;
+
+      if (head >= tail)
+         return -1;
+
+      if (steal) {
+         entry = tail - 1;
+         new = ((uint64_t)head << 32) | entry;
+      } else {
+         entry = head;
+         new = ((uint64_t)(head + 1) << 32) | tail;
+      }
+
+      uint64_t cur = p_atomic_cmpxchg(&queue->range, old, new);
+      if (cur == old)
+         return scene->bin_order[entry];
+      old = cur;
+   }
 }
 
 
 /**
- * Return pointer to next bin to be rendered.
- * The lp_scene::curr_x and ::curr_y fields will be advanced.
+ * Return pointer to next bin to be rendered by the given thread.
  * Multiple rendering threads will call this function to get a chunk
- * of work (a bin) to work on.
+ * of work (a bin) to work on.  A thread first drains its own queue and
+ * then steals from the other threads' queues.
  */
 struct cmd_bin *
-lp_scene_bin_iter_next(struct lp_scene *scene , int *x, int *y)
+lp_scene_bin_iter_next(struct lp_scene *scene, unsigned thread_index,
+                       int *x, int *y)
 {
-   struct cmd_bin *bin = NULL;
-
-   mtx_lock(&scene->mutex);
-
-   if (scene->curr_x < 0) {
-      /* first bin */
-      scene->curr_x = 0;
-      scene->curr_y = 0;
-   } else if (!next_bin(scene)) {
-      /* no more bins left */
-      goto end;
+   const unsigned num_queues = scene->num_queues;
+   const unsigned group = lp_thread_group(thread_index, num_queues,
+                                          scene->num_groups);
+   int idx = bin_queue_pop(scene, thread_index, false);
+
+   /* Steal from the threads of the same group first, then anywhere. */
+   for (unsigned pass = 0; pass < 2 && idx < 0; pass++) {
+      for (unsigned i = 1; i < num_queues && idx < 0; i++) {
+         unsigned q = (thread_index + i) % num_queues;
+         bool same_group =
+            lp_thread_group(q, num_queues, scene->num_groups) == group;
+         if (same_group == (pass == 0))
+            idx = bin_queue_pop(scene, q, true);
+      }
    }
 
-   bin = lp_scene_get_bin(scene, scene->curr_x, scene->curr_y);
-   *x = scene->curr_x;
-   *y = scene->curr_y;
+   if (idx < 0)
+      return NULL;
 
-end:
-   /*printf("return bin %p at %d, %d\n", (void *) bin, *bin_x, *bin_y);*/
-   mtx_unlock(&scene->mutex);
-   return bin;
+   *x = idx % scene->tiles_x;
+   *y = idx / scene->tiles_x;
+   return &scene->tiles[idx];
 }
 
 
@@ -609,6 +711,12 @@ lp_scene_begin_binning(struct lp_scene *scene,
                                   sizeof(struct cmd_bin));
       if (!scene->tiles)
          return;
+      /* second half is scratch space for sorting */
+      scene->bin_order = reallocarray(scene->bin_order,
+                                      2 * num_required_tiles,
+                                      sizeof(uint64_t));
+      if (!scene->bin_order)
+         return;
       memset(scene->tiles, 0, sizeof(struct cmd_bin) * num_required_tiles);
       scene->num_alloced_tiles = num_required_tiles;
    }
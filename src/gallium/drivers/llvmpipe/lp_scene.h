@@ -120,6 +120,21 @@ struct resource_ref;
 
 struct shader_ref;
 
+/**
+ * Per-thread queue of bins to rasterize.
+ *
+ * The owning thread pops bins from the head while threads which ran out of
+ * work steal from the tail.  Both ends are packed into a single 64-bit word
+ * (head in the upper half, tail in the lower half) so either end can be
+ * claimed with one compare-and-swap.  Padded to a cache line to avoid false
+ * sharing between threads.
+ */
+struct lp_bin_queue {
+   uint64_t range;
+   uint8_t pad[CACHE_LINE_SIZE - sizeof(uint64_t)];
+};
+
+
 struct lp_scene_surface {
    uint8_t *map;
    unsigned stride;
@@ -195,8 +210,14 @@ struct lp_scene {
     */
    unsigned tiles_x, tiles_y;
 
-   int curr_x, curr_y;  /**< for iterating over bins */
-   mtx_t mutex;
+   /**
+    * Indices of the non-empty bins, split in one contiguous range per
+    * queue, each sorted by decreasing estimated cost.
+    */
+   uint64_t *bin_order;
+   unsigned num_queues;
+   unsigned num_groups;
+   struct lp_bin_queue queues[LP_MAX_THREADS];
 
    unsigned num_alloced_tiles;
    struct cmd_bin *tiles;
@@ -396,10 +417,12 @@ lp_scene_get_num_bins(const struct lp_scene *scene)
 
 
 void
-lp_scene_bin_iter_begin(struct lp_scene *scene);
+lp_scene_bin_iter_begin(struct lp_scene *scene, unsigned num_threads,
+                        unsigned num_groups);
 
 struct cmd_bin *
-lp_scene_bin_iter_next(struct lp_scene *scene, int *x, int *y);
+lp_scene_bin_iter_next(struct lp_scene *scene, unsigned thread_index,
+                       int *x, int *y);
 
 
 
@@ -97,6 +97,7 @@ static const struct debug_named_value lp_perf_flags[] = {
    { "no_alphatest",   PERF_NO_ALPHATEST, NULL },
    { "no_rast_linear", PERF_NO_RAST_LINEAR, NULL },
    { "no_shade",       PERF_NO_SHADE, NULL },
+   { "no_zcull",       PERF_NO_ZCULL, NULL },
    DEBUG_NAMED_VALUE_END
 };
 
@@ -857,6 +858,9 @@ llvmpipe_destroy_screen(struct pipe_screen *_screen)
    struct llvmpipe_screen *screen = llvmpipe_screen(_screen);
    struct sw_winsys *winsys = screen->winsys;
 
+   if (screen->late_init_done && screen->async_fs_compile)
+      util_queue_destroy(&screen->fs_compile_queue);
+
    if (screen->cs_tpool)
       lp_cs_tpool_destroy(screen->cs_tpool);
 
@@ -948,6 +952,11 @@ lp_disk_cache_create(struct llvmpipe_screen *screen)
       return;
 
    _mesa_sha1_update(&ctx, &gallivm_perf, sizeof(gallivm_perf));
+   /* The SoA vector width (LP_NATIVE_VECTOR_WIDTH) changes the layout of
+    * all the generated code, so cached objects can't be shared across it.
+    */
+   _mesa_sha1_update(&ctx, &lp_native_vector_width,
+                     sizeof(lp_native_vector_width));
    update_cache_sha1_cpu(&ctx);
    _mesa_sha1_final(&ctx, sha1);
    disk_cache_format_hex_id(cache_id, sha1, 20 * 2);
@@ -1016,19 +1025,28 @@ llvmpipe_screen_late_init(struct llvmpipe_screen *screen)
    if (screen->late_init_done)
       goto out;
 
-   screen->rast = lp_rast_create(screen->num_threads);
+   screen->rast = lp_rast_create(screen->num_threads,
+                                 screen->num_thread_groups);
    if (!screen->rast) {
       ret = false;
       goto out;
    }
 
-   screen->cs_tpool = lp_cs_tpool_create(screen->num_threads);
+   screen->cs_tpool = lp_cs_tpool_create(screen->num_threads,
+                                          screen->num_thread_groups);
    if (!screen->cs_tpool) {
       lp_rast_destroy(screen->rast);
       ret = false;
       goto out;
    }
 
+   if (screen->async_fs_compile &&
+       !util_queue_init(&screen->fs_compile_queue, "lpfs", 64,
+                        MAX2(1, screen->num_threads / 4),
+                        UTIL_QUEUE_INIT_RESIZE_IF_FULL |
+                        UTIL_QUEUE_INIT_USE_MINIMUM_PRIORITY, NULL))
+      screen->async_fs_compile = false;
+
    lp_disk_cache_create(screen);
    screen->late_init_done = true;
 out:
@@ -1103,6 +1121,23 @@ llvmpipe_create_screen(struct sw_winsys *winsys)
                                               screen->num_threads);
    screen->num_threads = MIN2(screen->num_threads, LP_MAX_THREADS);
 
+   /* In NUMA mode, rasterizer and compute threads are split in groups
+    * pinned to one L3 cache each, and each group rasterizes its own
+    * band of the screen.
+    */
+   screen->num_thread_groups = 1;
+   if (debug_get_bool_option("LP_NUMA", FALSE) && screen->num_threads > 1)
+      screen->num_thread_groups = CLAMP(util_get_cpu_caps()->num_L3_caches,
+                                        1, screen->num_threads);
+
+   /* Compile fragment shader variants without optimizations first and
+    * swap in the optimized code once it's been compiled in the background.
+    */
+#ifndef EMBEDDED_DEVICE
+   screen->async_fs_compile = debug_get_bool_option("LP_ASYNC_FS_COMPILE",
+                                                    FALSE);
+#endif
+
    lp_build_init(); /* get lp_native_vector_width initialised */
 
    snprintf(screen->renderer_string, sizeof(screen->renderer_string),
@@ -38,6 +38,7 @@
 #include "pipe/p_defines.h"
 #include "os/os_thread.h"
 #include "util/list.h"
+#include "util/u_queue.h"
 #include "gallivm/lp_bld.h"
 #include "gallivm/lp_bld_misc.h"
 
@@ -51,6 +52,8 @@ struct llvmpipe_screen
    struct sw_winsys *winsys;
 
    unsigned num_threads;
+   /** Number of L3-cache groups the worker threads are pinned to */
+   unsigned num_thread_groups;
 
    /* Increments whenever textures are modified.  Contexts can track this.
     */
@@ -62,6 +65,10 @@ struct llvmpipe_screen
    struct lp_cs_tpool *cs_tpool;
    mtx_t cs_mutex;
 
+   /** Background compilation of optimized fragment shader variants */
+   struct util_queue fs_compile_queue;
+   bool async_fs_compile;
+
    bool use_tgsi;
    bool allow_cl;
 
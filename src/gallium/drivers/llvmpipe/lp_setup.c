@@ -65,17 +65,48 @@ static boolean
 try_update_scene_state(struct lp_setup_context *setup);
 
 
+/**
+ * Wait for the oldest scene in flight to be rasterized and return its
+ * index so it can be reused.
+ */
 static unsigned
 lp_setup_wait_empty_scene(struct lp_setup_context *setup)
 {
-   /* just use the first scene if we run out */
-   if (setup->scenes[0]->fence) {
-      debug_printf("%s: wait for scene %d\n",
-                   __FUNCTION__, setup->scenes[0]->fence->id);
-      lp_fence_wait(setup->scenes[0]->fence);
-      lp_scene_end_rasterization(setup->scenes[0]);
-   }
-   return 0;
+   unsigned oldest = 0;
+
+   for (unsigned i = 1; i < setup->num_active_scenes; i++) {
+      const struct lp_fence *fence = setup->scenes[i]->fence;
+      const struct lp_fence *oldest_fence = setup->scenes[oldest]->fence;
+      if (fence && (!oldest_fence || fence->id < oldest_fence->id))
+         oldest = i;
+   }
+
+   struct lp_scene *scene = setup->scenes[oldest];
+   if (scene->fence) {
+      LP_DBG(DEBUG_SETUP, "%s: wait for scene %d\n",
+             __FUNCTION__, scene->fence->id);
+      lp_fence_wait(scene->fence);
+      lp_scene_end_rasterization(scene);
+   }
+   return oldest;
+}
+
+
+/**
+ * Return the amount of scene data currently in flight, that is
+ * allocated by scenes which have been queued for rasterization but not
+ * yet recycled.
+ */
+static uint64_t
+lp_setup_inflight_size(const struct lp_setup_context *setup)
+{
+   uint64_t size = 0;
+
+   for (unsigned i = 0; i < setup->num_active_scenes; i++) {
+      if (setup->scenes[i]->fence)
+         size += setup->scenes[i]->scene_size;
+   }
+   return size;
 }
 
 
@@ -97,19 +128,27 @@ lp_setup_get_empty_scene(struct lp_setup_context *setup)
       }
    }
 
-   if (setup->num_active_scenes + 1 > MAX_SCENES) {
-      i = lp_setup_wait_empty_scene(setup);
-   } else if (i == setup->num_active_scenes) {
-      /* allocate a new scene */
-      struct lp_scene *scene = lp_scene_create(setup);
-      if (!scene) {
-         /* block and reuse scenes */
+   if (i == setup->num_active_scenes) {
+      if (setup->num_active_scenes + 1 > setup->max_scenes ||
+          lp_setup_inflight_size(setup) + LP_SCENE_MAX_SIZE >
+          setup->max_inflight_size) {
+         /* Too many scenes or too much scene memory in flight: block
+          * until the oldest scene is done and reuse it.
+          */
          i = lp_setup_wait_empty_scene(setup);
       } else {
-         LP_DBG(DEBUG_SETUP, "allocated scene: %d\n", setup->num_active_scenes);
-         setup->scenes[setup->num_active_scenes] = scene;
-         i = setup->num_active_scenes;
-         setup->num_active_scenes++;
+         /* allocate a new scene */
+         struct lp_scene *scene = lp_scene_create(setup);
+         if (!scene) {
+            /* block and reuse scenes */
+            i = lp_setup_wait_empty_scene(setup);
+         } else {
+            LP_DBG(DEBUG_SETUP, "allocated scene: %d\n",
+                   setup->num_active_scenes);
+            setup->scenes[setup->num_active_scenes] = scene;
+            i = setup->num_active_scenes;
+            setup->num_active_scenes++;
+         }
       }
    }
 
@@ -360,6 +399,8 @@ set_scene_state(struct lp_setup_context *setup,
             goto fail;
       lp_setup_rasterize_scene(setup);
       assert(setup->scene == NULL);
+      /* The depth buffer may be written outside of setup from now on. */
+      setup->zcull.valid = FALSE;
       break;
    default:
       assert(0 && "invalid setup state mode");
@@ -413,6 +454,16 @@ lp_setup_bind_framebuffer(struct lp_setup_context *setup,
    setup->framebuffer.x1 = fb->width-1;
    setup->framebuffer.y1 = fb->height-1;
    setup->dirty |= LP_SETUP_NEW_SCISSOR;
+
+   setup->zcull.zfloat = fb->zsbuf && util_format_is_float(fb->zsbuf->format);
+   setup->zcull.tiles_x = DIV_ROUND_UP(fb->width, TILE_SIZE);
+   setup->zcull.tiles_y = DIV_ROUND_UP(fb->height, TILE_SIZE);
+   const unsigned num_tiles = setup->zcull.tiles_x * setup->zcull.tiles_y;
+   if (num_tiles > setup->zcull.num_tiles) {
+      FREE(setup->zcull.tile_zmax);
+      setup->zcull.tile_zmax = MALLOC(num_tiles * sizeof(float));
+      setup->zcull.num_tiles = setup->zcull.tile_zmax ? num_tiles : 0;
+   }
 }
 
 
@@ -532,6 +583,17 @@ lp_setup_try_clear_zs(struct lp_setup_context *setup,
          (setup->clear.zsvalue & ~zsmask) | (zsvalue & zsmask);
    }
 
+   if ((flags & PIPE_CLEAR_DEPTH) && setup->zcull.tile_zmax &&
+       util_framebuffer_get_num_layers(&setup->fb) <= 1) {
+      const unsigned num_tiles = setup->zcull.tiles_x * setup->zcull.tiles_y;
+      float zmax = (float) depth;
+      if (!setup->zcull.zfloat)
+         zmax = CLAMP(zmax, 0.0f, 1.0f);
+      for (unsigned i = 0; i < num_tiles; i++)
+         setup->zcull.tile_zmax[i] = zmax;
+      setup->zcull.valid = TRUE;
+   }
+
    return TRUE;
 }
 
@@ -1417,6 +1479,68 @@ try_update_scene_state(struct lp_setup_context *setup)
 }
 
 
+/**
+ * Work out what the current state lets us do with the per-tile depth
+ * bounds.  They remain upper bounds as long as every depth write can only
+ * lower the stored value, anything else drops them until the next clear.
+ */
+static void
+update_zcull_state(struct lp_setup_context *setup)
+{
+   const struct lp_fragment_shader_variant *variant =
+      setup->fs.current.variant;
+
+   setup->zcull.cull = FALSE;
+   setup->zcull.update = FALSE;
+
+   if (!setup->zcull.valid || !variant)
+      return;
+
+   const struct lp_fragment_shader_variant_key *key = &variant->key;
+   const struct tgsi_shader_info *info = &variant->shader->info.base;
+   const unsigned func = key->depth.func;
+   const boolean func_less = func == PIPE_FUNC_LESS ||
+                             func == PIPE_FUNC_LEQUAL;
+
+   if (key->depth.enabled && key->depth.writemask &&
+       !func_less && func != PIPE_FUNC_EQUAL && func != PIPE_FUNC_NEVER) {
+      setup->zcull.valid = FALSE;
+      return;
+   }
+
+   if (LP_PERF & PERF_NO_ZCULL)
+      return;
+
+   /* Fragments failing the depth test must not have any other effect. */
+   if (!key->depth.enabled ||
+       !(func_less || func == PIPE_FUNC_EQUAL) ||
+       key->stencil[0].enabled ||
+       info->writes_z ||
+       info->writes_memory ||
+       setup->setup.variant->key.pgon_offset_units != 0.0f ||
+       setup->setup.variant->key.pgon_offset_scale != 0.0f)
+      return;
+
+   for (unsigned i = 0; i < setup->active_binned_queries; i++) {
+      if (setup->active_queries[i]->type == PIPE_QUERY_PIPELINE_STATISTICS)
+         return;
+   }
+
+   setup->zcull.cull = TRUE;
+
+   /* Fully covered tiles end up no deeper than the triangle only if every
+    * pixel is depth tested and written.
+    */
+   setup->zcull.update = key->depth.writemask &&
+                         func_less &&
+                         !key->alpha.enabled &&
+                         !key->multisample &&
+                         !key->blend.alpha_to_coverage &&
+                         !info->uses_kill &&
+                         !info->writes_samplemask;
+}
+
+
 boolean
 lp_setup_update_state(struct lp_setup_context *setup,
                       boolean update_scene)
@@ -1455,6 +1579,8 @@ lp_setup_update_state(struct lp_setup_context *setup,
       assert(memcmp(&lp->setup_variant.key,
                     &setup->setup.variant->key,
                     setup->setup.variant->key.size) == 0);
+
+      update_zcull_state(setup);
    }
 
    if (update_scene && setup->state != SETUP_ACTIVE) {
@@ -1530,6 +1656,7 @@ lp_setup_destroy(struct lp_setup_context *setup)
    LP_DBG(DEBUG_SETUP, "number of scenes used: %d\n", setup->num_active_scenes);
    slab_destroy(&setup->scene_slab);
 
+   FREE(setup->zcull.tile_zmax);
    FREE(setup);
 }
 
@@ -1564,6 +1691,16 @@ lp_setup_create(struct pipe_context *pipe,
    draw_set_rasterize_stage(draw, setup->vbuf);
    draw_set_render(draw, &setup->base);
 
+   /* Number of scenes which may be in flight at once, and the total
+    * amount of scene data (in MB) they are allowed to hold.
+    */
+   setup->max_scenes = CLAMP(debug_get_num_option("LP_MAX_SCENES",
+                                                  MAX_SCENES),
+                             1, MAX_SCENES);
+   setup->max_inflight_size =
+      (uint64_t)debug_get_num_option("LP_MAX_SCENE_MEMORY",
+                                     LP_MAX_INFLIGHT_SCENE_SIZE >> 20) << 20;
+
    slab_create(&setup->scene_slab,
                sizeof(struct lp_scene),
                INITIAL_SCENES);
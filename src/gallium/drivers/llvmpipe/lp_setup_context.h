@@ -59,6 +59,9 @@ struct lp_setup_variant;
 #define INITIAL_SCENES 4
 #define MAX_SCENES 64
 
+/** Default total size of the data of all scenes in flight */
+#define LP_MAX_INFLIGHT_SCENE_SIZE ((uint64_t)MAX_SCENES * LP_SCENE_MAX_SIZE)
+
 
 
 /**
@@ -93,6 +96,8 @@ struct lp_setup_context
 
    struct slab_mempool scene_slab;
    int num_active_scenes;
+   unsigned max_scenes;           /**< max number of scenes in flight */
+   uint64_t max_inflight_size;    /**< max scene data in flight, in bytes */
    struct lp_scene *scenes[MAX_SCENES];  /**< all the scenes */
    struct lp_scene *scene;               /**< current scene being built */
 
@@ -133,6 +138,22 @@ struct lp_setup_context
       uint64_t zsvalue;               /**< lp_rast_clear_zstencil() cmd */
    } clear;
 
+   /**
+    * Conservative upper bound of the depth buffer contents per tile, used
+    * to skip binning triangles which are entirely behind what's already
+    * there.  Only known after a depth clear, and only kept while depth
+    * values can't increase.
+    */
+   struct {
+      float *tile_zmax;
+      unsigned tiles_x, tiles_y;
+      unsigned num_tiles;             /**< allocated size of tile_zmax */
+      boolean zfloat;                 /**< depth isn't clamped to [0, 1] */
+      boolean valid;                  /**< tile_zmax holds for this scene */
+      boolean cull;                   /**< current state allows culling */
+      boolean update;                 /**< current state lowers tile_zmax */
+   } zcull;
+
    enum setup_state {
       SETUP_FLUSHED,    /**< scene is null */
       SETUP_CLEARED,    /**< scene exists but has only clears */
@@ -299,7 +320,8 @@ lp_setup_bin_triangle(struct lp_setup_context *setup,
                       boolean opaque,
                       const struct u_rect *bbox,
                       int nr_planes,
-                      unsigned scissor_index);
+                      unsigned scissor_index,
+                      const float *zrange);
 
 boolean
 lp_setup_bin_rectangle(struct lp_setup_context *setup,
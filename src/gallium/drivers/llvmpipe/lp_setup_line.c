@@ -689,7 +689,7 @@ try_setup_line(struct lp_setup_context *setup,
    }
 
    return lp_setup_bin_triangle(setup, line, use_32bits, false,
-                                &bboxpos, nr_planes, viewport_index);
+                                &bboxpos, nr_planes, viewport_index, NULL);
 }
 
 
@@ -544,7 +544,7 @@ try_setup_point(struct lp_setup_context *setup,
 
       return lp_setup_bin_triangle(setup, point, use_32bits,
                                    setup->fs.current.variant->opaque,
-                                   &bbox, nr_planes, viewport_index);
+                                   &bbox, nr_planes, viewport_index, NULL);
 
    } else {
       struct lp_rast_rectangle *point =
@@ -737,9 +737,25 @@ do_triangle_ccw(struct lp_setup_context *setup,
                                   s_planes, setup->multisample);
    }
 
+   /* Depth range of the triangle, for culling against the tile bounds. */
+   float zrange[2];
+   if (setup->zcull.valid && setup->zcull.cull) {
+      const struct lp_jit_viewport *vp = &setup->viewports[viewport_index];
+      float zlo = MIN2(vp->min_depth, vp->max_depth);
+      float zhi = MAX2(vp->min_depth, vp->max_depth);
+      if (!setup->zcull.zfloat) {
+         zlo = MAX2(zlo, 0.0f);
+         zhi = MIN2(zhi, 1.0f);
+      }
+      zrange[0] = CLAMP(MIN3(v0[0][2], v1[0][2], v2[0][2]), zlo, zhi);
+      zrange[1] = CLAMP(MAX3(v0[0][2], v1[0][2], v2[0][2]), zlo, zhi);
+   }
+
    return lp_setup_bin_triangle(setup, tri, use_32bits,
                                 check_opaque(setup, v0, v1, v2),
-                                &bbox, nr_planes, viewport_index);
+                                &bbox, nr_planes, viewport_index,
+                                setup->zcull.valid && setup->zcull.cull ?
+                                zrange : NULL);
 }
 
 /*
@@ -770,6 +786,31 @@ floor_pot(uint32_t n)
 }
 
 
+/* Slack for depth interpolation and quantization when comparing against
+ * the tile bounds.
+ */
+#define LP_ZCULL_EPSILON (1.0f / (1 << 15))
+
+
+/**
+ * Whether all of the triangle within tile (x, y) is known to fail the
+ * depth test.
+ */
+static inline boolean
+tile_occluded(const struct lp_setup_context *setup, const float *zrange,
+              int x, int y)
+{
+   assert(x < setup->zcull.tiles_x && y < setup->zcull.tiles_y);
+   return zrange &&
+      zrange[0] > setup->zcull.tile_zmax[y * setup->zcull.tiles_x + x] +
+                  LP_ZCULL_EPSILON;
+}
+
+
+/**
+ * Bin a triangle, skipping tiles where it is entirely occluded if
+ * \p zrange (the clamped min/max depth of the vertices) is given.
+ */
 boolean
 lp_setup_bin_triangle(struct lp_setup_context *setup,
                       struct lp_rast_triangle *tri,
@@ -777,7 +818,8 @@ lp_setup_bin_triangle(struct lp_setup_context *setup,
                       boolean opaque,
                       const struct u_rect *bbox,
                       int nr_planes,
-                      unsigned viewport_index)
+                      unsigned viewport_index,
+                      const float *zrange)
 {
    struct lp_scene *scene = setup->scene;
    unsigned cmd;
@@ -821,6 +863,11 @@ lp_setup_bin_triangle(struct lp_setup_context *setup,
       assert(iy0 == bbox->y1 / TILE_SIZE &&
              ix0 == bbox->x1 / TILE_SIZE);
 
+      if (tile_occluded(setup, zrange, ix0, iy0)) {
+         LP_COUNT(nr_zculled_64);
+         return TRUE;
+      }
+
       if (nr_planes == 3) {
          if (sz < 4) {
             /* Triangle is contained in a single 4x4 stamp:
@@ -942,6 +989,10 @@ lp_setup_bin_triangle(struct lp_setup_context *setup,
                if (in)
                   break;  /* exiting triangle, all done with this row */
                LP_COUNT(nr_empty_64);
+            } else if (tile_occluded(setup, zrange, x, y)) {
+               /* behind everything already in the tile */
+               in = TRUE;
+               LP_COUNT(nr_zculled_64);
             } else if (partial) {
                /* Not trivially accepted by at least one plane -
                 * rasterize/shade partial tile
@@ -965,6 +1016,12 @@ lp_setup_bin_triangle(struct lp_setup_context *setup,
                in = TRUE;
                if (!lp_setup_whole_tile(setup, &tri->inputs, x, y, opaque))
                   goto fail;
+
+               if (zrange && setup->zcull.update) {
+                  float *zmax =
+                     &setup->zcull.tile_zmax[y * setup->zcull.tiles_x + x];
+                  *zmax = MIN2(*zmax, zrange[1]);
+               }
             }
 
             /* Iterate cx values across the region: */
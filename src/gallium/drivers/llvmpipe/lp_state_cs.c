@@ -1434,11 +1434,20 @@ llvmpipe_launch_grid(struct pipe_context *pipe,
    int num_tasks = job_info.grid_size[2] * job_info.grid_size[1] * job_info.grid_size[0];
    if (num_tasks) {
       struct lp_cs_tpool_task *task;
+      int64_t t0 = 0;
+      if (LP_DEBUG & DEBUG_COUNTERS)
+         t0 = os_time_get();
+
       mtx_lock(&screen->cs_mutex);
       task = lp_cs_tpool_queue_task(screen->cs_tpool, cs_exec_fn, &job_info, num_tasks);
       mtx_unlock(&screen->cs_mutex);
 
       lp_cs_tpool_wait_for_task(screen->cs_tpool, &task);
+
+      if (LP_DEBUG & DEBUG_COUNTERS) {
+         LP_COUNT(nr_cs_dispatches);
+         LP_COUNT_ADD(cs_dispatch_time, os_time_get() - t0);
+      }
    }
    if (!llvmpipe->queries_disabled)
       llvmpipe->pipeline_statistics.cs_invocations += num_tasks * info->block[0] * info->block[1] * info->block[2];
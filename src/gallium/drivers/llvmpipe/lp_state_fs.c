@@ -3189,7 +3189,7 @@ generate_fragment(struct llvmpipe_context *lp,
    blend_vec_type = lp_build_vec_type(gallivm, blend_type);
 
    char func_name[64];
-   snprintf(func_name, sizeof(func_name), "fs_variant_%s",
+   snprintf(func_name, sizeof(func_name), "fs_%08x_%s", variant->name_hash,
             partial_mask ? "partial" : "whole");
 
    arg_types[0] = variant->jit_context_ptr_type;       /* context */
@@ -3721,50 +3721,16 @@ lp_fs_get_ir_cache_key(struct lp_fragment_shader_variant *variant,
 
 
 /**
- * Generate a new fragment shader variant from the shader code and
- * other state indicated by the key.
+ * Build and compile the code of a fragment shader variant in its gallivm.
+ * Only the variant's own gallivm and LLVM context are used, which is what
+ * makes background compilation possible.
  */
-static struct lp_fragment_shader_variant *
-generate_variant(struct llvmpipe_context *lp,
-                 struct lp_fragment_shader *shader,
-                 const struct lp_fragment_shader_variant_key *key)
+static void
+generate_variant_code(struct llvmpipe_context *lp,
+                      struct lp_fragment_shader *shader,
+                      struct lp_fragment_shader_variant *variant)
 {
-   struct lp_fragment_shader_variant *variant =
-      MALLOC(sizeof *variant + shader->variant_key_size - sizeof variant->key);
-   if (!variant)
-      return NULL;
-
-   memset(variant, 0, sizeof(*variant));
-
-   pipe_reference_init(&variant->reference, 1);
-   lp_fs_reference(lp, &variant->shader, shader);
-
-   memcpy(&variant->key, key, shader->variant_key_size);
-
-   struct llvmpipe_screen *screen = llvmpipe_screen(lp->pipe.screen);
-   struct lp_cached_code cached = { 0 };
-   unsigned char ir_sha1_cache_key[20];
-   bool needs_caching = false;
-   if (shader->base.ir.nir) {
-      lp_fs_get_ir_cache_key(variant, ir_sha1_cache_key);
-
-      lp_disk_cache_find_shader(screen, &cached, ir_sha1_cache_key);
-      if (!cached.data_size)
-         needs_caching = true;
-   }
-
-   char module_name[64];
-   snprintf(module_name, sizeof(module_name), "fs%u_variant%u",
-            shader->no, shader->variants_created);
-   variant->gallivm = gallivm_create(module_name, lp->context, &cached);
-   if (!variant->gallivm) {
-      FREE(variant);
-      return NULL;
-   }
-
-   variant->list_item_global.base = variant;
-   variant->list_item_local.base = variant;
-   variant->no = shader->variants_created++;
+   const struct lp_fragment_shader_variant_key *key = &variant->key;
 
    /*
     * Determine whether we are touching all channels in the color buffer.
@@ -3862,8 +3828,6 @@ generate_variant(struct llvmpipe_context *lp,
          (key->cbuf_format[0] == PIPE_FORMAT_B8G8R8A8_UNORM ||
           key->cbuf_format[0] == PIPE_FORMAT_B8G8R8X8_UNORM);
 
-   memcpy(&variant->key, key, sizeof *key);
-
    if ((LP_DEBUG & DEBUG_FS) || (gallivm_debug & GALLIVM_DEBUG_IR)) {
       lp_debug_fs_variant(variant);
    }
@@ -3947,13 +3911,199 @@ generate_variant(struct llvmpipe_context *lp,
        */
       lp_linear_check_variant(variant);
    }
+}
+
+
+/**
+ * Background compilation of the optimized code of a variant.
+ */
+struct lp_fs_compile_job
+{
+   struct llvmpipe_screen *screen;
+   struct lp_fragment_shader_variant *variant;
+   /* Copy of the shader with a private NIR clone, as translating the NIR
+    * to LLVM IR modifies it.
+    */
+   struct lp_fragment_shader shader;
+   bool needs_caching;
+   unsigned char ir_sha1_cache_key[20];
+};
+
+
+static void
+lp_fs_compile_job_execute(void *data, void *gdata, int thread_index)
+{
+   struct lp_fs_compile_job *job = data;
+   struct lp_fragment_shader_variant *variant = job->variant;
+   const unsigned key_size = job->shader.variant_key_size;
+
+   struct lp_fragment_shader_variant *opt =
+      CALLOC(1, sizeof *opt + key_size - sizeof opt->key);
+   if (!opt)
+      return;
+
+   memcpy(&opt->key, &variant->key, key_size);
+   opt->shader = &job->shader;
+   opt->no = variant->no;
+
+   LLVMContextRef context = LLVMContextCreate();
+   if (!context)
+      goto fail;
+#if LLVM_VERSION_MAJOR >= 15
+   LLVMContextSetOpaquePointers(context, false);
+#endif
+
+   char module_name[64];
+   snprintf(module_name, sizeof(module_name), "fs%u_variant%u_opt",
+            job->shader.no, variant->no);
+   struct lp_cached_code cached = { 0 };
+   opt->gallivm = gallivm_create(module_name, context, &cached);
+   if (!opt->gallivm) {
+      LLVMContextDispose(context);
+      goto fail;
+   }
+
+   generate_variant_code(NULL, &job->shader, opt);
+
+   if (job->needs_caching)
+      lp_disk_cache_insert_shader(job->screen, &cached, job->ir_sha1_cache_key);
+
+   gallivm_free_ir(opt->gallivm);
+
+   /* Swap in the optimized code.  The unoptimized code stays alive until
+    * the variant is destroyed, as scenes in flight may still be using it.
+    */
+   variant->opt_gallivm = opt->gallivm;
+   variant->opt_context = context;
+   p_atomic_set(&variant->jit_linear_llvm, opt->jit_linear_llvm);
+   p_atomic_set(&variant->jit_function[RAST_EDGE_TEST],
+                opt->jit_function[RAST_EDGE_TEST]);
+   p_atomic_set(&variant->jit_function[RAST_WHOLE],
+                opt->jit_function[RAST_WHOLE]);
+
+fail:
+   FREE(opt);
+}
+
 
-   if (needs_caching) {
+static void
+lp_fs_compile_job_cleanup(void *data, void *gdata, int thread_index)
+{
+   struct lp_fs_compile_job *job = data;
+
+   ralloc_free(job->shader.base.ir.nir);
+   FREE(job);
+}
+
+
+/**
+ * Queue the compilation of the optimized code of a variant which was
+ * compiled without optimizations.
+ */
+static void
+queue_variant_opt_compile(struct llvmpipe_screen *screen,
+                          struct lp_fragment_shader *shader,
+                          struct lp_fragment_shader_variant *variant,
+                          bool needs_caching,
+                          const unsigned char ir_sha1_cache_key[20])
+{
+   struct lp_fs_compile_job *job = CALLOC_STRUCT(lp_fs_compile_job);
+   if (!job)
+      return;
+
+   job->screen = screen;
+   job->variant = variant;
+   job->shader = *shader;
+   if (shader->base.type == PIPE_SHADER_IR_NIR) {
+      job->shader.base.ir.nir = nir_shader_clone(NULL, shader->base.ir.nir);
+      if (!job->shader.base.ir.nir) {
+         FREE(job);
+         return;
+      }
+   }
+   job->needs_caching = needs_caching;
+   memcpy(job->ir_sha1_cache_key, ir_sha1_cache_key,
+          sizeof(job->ir_sha1_cache_key));
+
+   util_queue_add_job(&screen->fs_compile_queue, job, &variant->opt_fence,
+                      lp_fs_compile_job_execute, lp_fs_compile_job_cleanup, 0);
+}
+
+
+/**
+ * Generate a new fragment shader variant from the shader code and
+ * other state indicated by the key.
+ *
+ * With LP_ASYNC_FS_COMPILE, variants which aren't in the disk cache are
+ * first compiled without optimizations, which is much faster, and the
+ * optimized code is compiled in the background and swapped in once ready.
+ */
+static struct lp_fragment_shader_variant *
+generate_variant(struct llvmpipe_context *lp,
+                 struct lp_fragment_shader *shader,
+                 const struct lp_fragment_shader_variant_key *key)
+{
+   struct lp_fragment_shader_variant *variant =
+      MALLOC(sizeof *variant + shader->variant_key_size - sizeof variant->key);
+   if (!variant)
+      return NULL;
+
+   memset(variant, 0, sizeof(*variant));
+
+   pipe_reference_init(&variant->reference, 1);
+   util_queue_fence_init(&variant->opt_fence);
+   lp_fs_reference(lp, &variant->shader, shader);
+
+   memcpy(&variant->key, key, shader->variant_key_size);
+
+   struct llvmpipe_screen *screen = llvmpipe_screen(lp->pipe.screen);
+   struct lp_cached_code cached = { 0 };
+   unsigned char ir_sha1_cache_key[20] = { 0 };
+   bool needs_caching = false;
+   if (shader->base.ir.nir) {
+      lp_fs_get_ir_cache_key(variant, ir_sha1_cache_key);
+      variant->name_hash = (uint32_t)ir_sha1_cache_key[0] << 24 |
+                           (uint32_t)ir_sha1_cache_key[1] << 16 |
+                           (uint32_t)ir_sha1_cache_key[2] << 8 |
+                           ir_sha1_cache_key[3];
+
+      lp_disk_cache_find_shader(screen, &cached, ir_sha1_cache_key);
+      if (!cached.data_size)
+         needs_caching = true;
+   }
+
+   const bool async = screen->async_fs_compile && !cached.data_size;
+
+   char module_name[64];
+   snprintf(module_name, sizeof(module_name), "fs%u_variant%u",
+            shader->no, shader->variants_created);
+   variant->gallivm = gallivm_create(module_name, lp->context, &cached);
+   if (!variant->gallivm) {
+      FREE(variant);
+      return NULL;
+   }
+
+   if (async)
+      gallivm_set_no_opt(variant->gallivm);
+
+   variant->list_item_global.base = variant;
+   variant->list_item_local.base = variant;
+   variant->no = shader->variants_created++;
+
+   generate_variant_code(lp, shader, variant);
+
+   /* Only the optimized code goes into the disk cache */
+   if (needs_caching && !async) {
       lp_disk_cache_insert_shader(screen, &cached, ir_sha1_cache_key);
    }
 
    gallivm_free_ir(variant->gallivm);
 
+   if (async) {
+      queue_variant_opt_compile(screen, shader, variant, needs_caching,
+                                ir_sha1_cache_key);
+   }
+
    return variant;
 }
 
@@ -4116,6 +4266,14 @@ void
 llvmpipe_destroy_shader_variant(struct llvmpipe_context *lp,
                                 struct lp_fragment_shader_variant *variant)
 {
+   /* Wait for a pending background compilation */
+   util_queue_fence_wait(&variant->opt_fence);
+   util_queue_fence_destroy(&variant->opt_fence);
+   if (variant->opt_gallivm) {
+      gallivm_destroy(variant->opt_gallivm);
+      LLVMContextDispose(variant->opt_context);
+   }
+
    gallivm_destroy(variant->gallivm);
    lp_fs_reference(lp, &variant->shader, NULL);
    FREE(variant);
@@ -38,6 +38,7 @@
 #include "gallivm/lp_bld_tgsi.h" /* for lp_tgsi_info */
 #include "lp_bld_interp.h" /* for struct lp_shader_input */
 #include "util/u_inlines.h"
+#include "util/u_queue.h"
 #include "lp_jit.h"
 
 struct tgsi_token;
@@ -173,6 +174,13 @@ struct lp_fragment_shader_variant
 
    struct gallivm_state *gallivm;
 
+   /* Optimized code compiled in the background (LP_ASYNC_FS_COMPILE),
+    * swapped into jit_function[] and jit_linear_llvm once ready.
+    */
+   struct util_queue_fence opt_fence;
+   struct gallivm_state *opt_gallivm;
+   LLVMContextRef opt_context;
+
    LLVMTypeRef jit_context_type;
    LLVMTypeRef jit_context_ptr_type;
    LLVMTypeRef jit_thread_data_type;
@@ -207,6 +215,12 @@ struct lp_fragment_shader_variant
    /* For debugging/profiling purposes */
    unsigned no;
 
+   /* First 8 hex digits of the IR cache key, used in the names of the
+    * generated functions so that profiles tell shaders apart.  It's derived from the
+    * shader and the key only, so cached code keeps matching its module.
+    */
+   uint32_t name_hash;
+
    /* key is variable-sized, must be last */
    struct lp_fragment_shader_variant_key key;
 };
@@ -36,6 +36,7 @@
 #include "pipe/p_defines.h"
 
 #include "util/u_inlines.h"
+#include "util/detect_os.h"
 #include "util/u_cpu_detect.h"
 #include "util/format/u_format.h"
 #include "util/u_math.h"
@@ -57,6 +58,10 @@
 #include "drm-uapi/drm_fourcc.h"
 #endif
 
+#if DETECT_OS_LINUX
+#include <sys/mman.h>
+#endif
+
 
 #ifdef DEBUG
 static struct llvmpipe_resource resource_list;
@@ -65,6 +70,10 @@ static mtx_t resource_list_mutex = _MTX_INITIALIZER_NP;
 static unsigned id_counter = 0;
 
 
+/* Row strides that are a multiple of this get padded, see below. */
+#define LP_ROW_STRIDE_ALIAS 2048
+
+
 /**
  * Conventional allocation path for non-display textures:
  * Compute strides and allocate data (unless asked not to).
@@ -81,6 +90,10 @@ llvmpipe_texture_layout(struct llvmpipe_screen *screen,
    uint64_t total_size = 0;
    unsigned layers = pt->array_size;
    unsigned num_samples = util_res_sample_count(pt);
+   const bool pad_rows =
+      !lpr->user_ptr && !util_format_is_compressed(pt->format) &&
+      !(pt->bind & (PIPE_BIND_LINEAR | PIPE_BIND_SHARED |
+                    PIPE_BIND_SCANOUT | PIPE_BIND_DISPLAY_TARGET));
 
    /* XXX: This alignment here (same for displaytarget) was added for the
     * purpose of ARB_map_buffer_alignment. I am not convinced it's needed for
@@ -139,6 +152,15 @@ llvmpipe_texture_layout(struct llvmpipe_screen *screen,
          lpr->row_stride[level] = align(nblocksx * block_size,
                                         util_get_cpu_caps()->cacheline);
 
+      /* With a row stride that's a multiple of 2KB, the texels of a column
+       * all map to the same few L1 cache sets, so vertical or rotated
+       * access patterns keep evicting each other.  Pad such rows by a cache
+       * line, unless someone else needs to know the layout.
+       */
+      if (pad_rows && nblocksy > 1 &&
+          lpr->row_stride[level] % LP_ROW_STRIDE_ALIAS == 0)
+         lpr->row_stride[level] += util_get_cpu_caps()->cacheline;
+
       lpr->img_stride[level] = (uint64_t)lpr->row_stride[level] * nblocksy;
 
       /* Number of 3D image slices, cube faces or texture array layers */
@@ -661,6 +683,7 @@ llvmpipe_resource_from_user_memory(struct pipe_screen *_screen,
    pipe_reference_init(&lpr->base.reference, 1);
    lpr->base.screen = _screen;
 
+   lpr->user_ptr = true;
    if (llvmpipe_resource_is_texture(&lpr->base)) {
       if (!llvmpipe_texture_layout(screen, lpr, false))
          goto fail;
@@ -668,7 +691,6 @@ llvmpipe_resource_from_user_memory(struct pipe_screen *_screen,
       lpr->tex_data = user_memory;
    } else
       lpr->data = user_memory;
-   lpr->user_ptr = true;
 #ifdef DEBUG
    mtx_lock(&resource_list_mutex);
    list_addtail(&lpr->list, &resource_list.list);
@@ -963,13 +985,38 @@ llvmpipe_memory_barrier(struct pipe_context *pipe,
 }
 
 
+/* allocations at least this big ask for transparent huge pages */
+#define LP_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+/**
+ * Device memory is backed by anonymous mappings where available, so that
+ * pages only get committed once they're touched instead of up front.  The
+ * first page holds the size of the mapping.
+ */
 static struct pipe_memory_allocation *
 llvmpipe_allocate_memory(struct pipe_screen *screen, uint64_t size)
 {
    uint64_t alignment;
    if (!os_get_page_size(&alignment))
       alignment = 256;
+#if DETECT_OS_LINUX
+   if (size > SIZE_MAX - 2 * alignment)
+      return NULL;
+
+   size_t map_size = align64(size, alignment) + alignment;
+   uint8_t *map = mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   if (map == MAP_FAILED)
+      return NULL;
+#ifdef MADV_HUGEPAGE
+   if (size >= LP_HUGE_PAGE_SIZE)
+      madvise(map, map_size, MADV_HUGEPAGE);
+#endif
+   *(size_t *)map = map_size;
+   return (struct pipe_memory_allocation *)(map + alignment);
+#else
    return os_malloc_aligned(size, alignment);
+#endif
 }
 
 
@@ -977,7 +1024,15 @@ static void
 llvmpipe_free_memory(struct pipe_screen *screen,
                      struct pipe_memory_allocation *pmem)
 {
+#if DETECT_OS_LINUX
+   uint64_t alignment;
+   if (!os_get_page_size(&alignment))
+      alignment = 256;
+   uint8_t *map = (uint8_t *)pmem - alignment;
+   munmap(map, *(size_t *)map);
+#else
    os_free_aligned(pmem);
+#endif
 }
 
 
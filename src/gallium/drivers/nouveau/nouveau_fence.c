@@ -147,10 +147,18 @@ _nouveau_fence_update(struct nouveau_screen *screen, bool flushed)
    struct nouveau_fence *fence;
    struct nouveau_fence *next = NULL;
    struct nouveau_fence_list *fence_list = &screen->fence;
-   u32 sequence = fence_list->update(&screen->base);
 
    simple_mtx_assert_locked(&fence_list->lock);
 
+   /* Nothing is pending, so there is no need to read back the sequence from
+    * the fence buffer, which is uncached on most setups.  This is hit on
+    * every pushbuf kick.
+    */
+   if (!fence_list->head)
+      return;
+
+   u32 sequence = fence_list->update(&screen->base);
+
    /* If running under drm-shim, let all fences be signalled so things run to
     * completion (avoids a hang at the end of shader-db).
     */
@@ -1833,23 +1833,32 @@ panfrost_emit_sampler_descriptors(struct panfrost_batch *batch,
                                   enum pipe_shader_type stage)
 {
         struct panfrost_context *ctx = batch->ctx;
+        struct panfrost_pool_ref *descs = &ctx->sampler_descs[stage];
 
         if (!ctx->sampler_count[stage])
                 return 0;
 
-        struct panfrost_ptr T =
-                pan_pool_alloc_desc_array(&batch->pool.base,
-                                          ctx->sampler_count[stage],
-                                          SAMPLER);
-        struct mali_sampler_packed *out = (struct mali_sampler_packed *) T.cpu;
+        /* Sampler state rarely changes between batches, so the descriptors
+         * live in the persistent pool and are only uploaded again once the
+         * bound samplers change. */
+        if (!descs->bo) {
+                struct panfrost_ptr T =
+                        pan_pool_alloc_desc_array(&ctx->descs.base,
+                                                  ctx->sampler_count[stage],
+                                                  SAMPLER);
+                struct mali_sampler_packed *out = (struct mali_sampler_packed *) T.cpu;
 
-        for (unsigned i = 0; i < ctx->sampler_count[stage]; ++i) {
-                struct panfrost_sampler_state *st = ctx->samplers[stage][i];
+                for (unsigned i = 0; i < ctx->sampler_count[stage]; ++i) {
+                        struct panfrost_sampler_state *st = ctx->samplers[stage][i];
 
-                out[i] = st ? st->hw : (struct mali_sampler_packed){0};
+                        out[i] = st ? st->hw : (struct mali_sampler_packed){0};
+                }
+
+                *descs = panfrost_pool_take_ref(&ctx->descs, T.gpu);
         }
 
-        return T.gpu;
+        panfrost_batch_add_bo(batch, descs->bo, stage);
+        return descs->gpu;
 }
 
 #if PAN_ARCH <= 7
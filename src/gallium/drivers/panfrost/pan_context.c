@@ -313,6 +313,16 @@ panfrost_bind_vertex_elements_state(
         ctx->dirty |= PAN_DIRTY_VERTEX;
 }
 
+static void
+panfrost_invalidate_sampler_descs(struct panfrost_context *ctx,
+                                  enum pipe_shader_type shader)
+{
+        if (ctx->sampler_descs[shader].bo)
+                panfrost_bo_unreference(ctx->sampler_descs[shader].bo);
+
+        ctx->sampler_descs[shader] = (struct panfrost_pool_ref) { 0 };
+}
+
 static void
 panfrost_bind_sampler_states(
         struct pipe_context *pctx,
@@ -325,11 +335,38 @@ panfrost_bind_sampler_states(
         struct panfrost_context *ctx = pan_context(pctx);
         ctx->dirty_shader[shader] |= PAN_DIRTY_STAGE_SAMPLER;
 
-        ctx->sampler_count[shader] = sampler ? num_sampler : 0;
+        unsigned count = sampler ? num_sampler : 0;
+
+        /* Rebinding the same samplers keeps the uploaded descriptors */
+        if (count != ctx->sampler_count[shader] ||
+            (count && memcmp(ctx->samplers[shader], sampler,
+                             count * sizeof (void *))))
+                panfrost_invalidate_sampler_descs(ctx, shader);
+
+        ctx->sampler_count[shader] = count;
         if (sampler)
                 memcpy(ctx->samplers[shader], sampler, num_sampler * sizeof (void *));
 }
 
+static void
+panfrost_delete_sampler_state(struct pipe_context *pctx, void *hwcso)
+{
+        struct panfrost_context *ctx = pan_context(pctx);
+
+        /* The CSO address could be reused by a later sampler, so drop any
+         * uploaded descriptors that were built from it. */
+        for (unsigned s = 0; s < PIPE_SHADER_TYPES; ++s) {
+                for (unsigned i = 0; i < ctx->sampler_count[s]; ++i) {
+                        if (ctx->samplers[s][i] == hwcso) {
+                                panfrost_invalidate_sampler_descs(ctx, s);
+                                break;
+                        }
+                }
+        }
+
+        free(hwcso);
+}
+
 static void
 panfrost_set_vertex_buffers(
         struct pipe_context *pctx,
@@ -575,6 +612,9 @@ panfrost_destroy(struct pipe_context *pipe)
         util_unreference_framebuffer_state(&panfrost->pipe_framebuffer);
         u_upload_destroy(pipe->stream_uploader);
 
+        for (unsigned s = 0; s < PIPE_SHADER_TYPES; ++s)
+                panfrost_invalidate_sampler_descs(panfrost, s);
+
         panfrost_pool_cleanup(&panfrost->descs);
         panfrost_pool_cleanup(&panfrost->shaders);
 
@@ -880,7 +920,7 @@ panfrost_create_context(struct pipe_screen *screen, void *priv, unsigned flags)
         gallium->bind_vertex_elements_state = panfrost_bind_vertex_elements_state;
         gallium->delete_vertex_elements_state = panfrost_generic_cso_delete;
 
-        gallium->delete_sampler_state = panfrost_generic_cso_delete;
+        gallium->delete_sampler_state = panfrost_delete_sampler_state;
         gallium->bind_sampler_states = panfrost_bind_sampler_states;
 
         gallium->bind_depth_stencil_alpha_state   = panfrost_bind_depth_stencil_state;
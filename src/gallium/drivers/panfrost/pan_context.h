@@ -202,6 +202,11 @@ struct panfrost_context {
         struct panfrost_sampler_state *samplers[PIPE_SHADER_TYPES][PIPE_MAX_SAMPLERS];
         unsigned sampler_count[PIPE_SHADER_TYPES];
 
+        /* Sampler descriptor arrays for the bound samplers, uploaded to the
+         * persistent descriptor pool so batches can keep referencing them by
+         * GPU address until the bound samplers change. */
+        struct panfrost_pool_ref sampler_descs[PIPE_SHADER_TYPES];
+
         struct panfrost_sampler_view *sampler_views[PIPE_SHADER_TYPES][PIPE_MAX_SHADER_SAMPLER_VIEWS];
         unsigned sampler_view_count[PIPE_SHADER_TYPES];
 
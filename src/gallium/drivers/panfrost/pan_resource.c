@@ -1493,6 +1493,36 @@ panfrost_resource_screen_destroy(struct pipe_screen *pscreen)
         u_transfer_helper_destroy(pscreen->transfer_helper);
 }
 
+/* Copies involving AFBC would otherwise go through staging blits to map the
+ * resources for a CPU copy, decompressing both sides. Copy on the GPU instead
+ * so AFBC stays compressed end to end. */
+
+static void
+panfrost_resource_copy_region(struct pipe_context *pctx,
+                              struct pipe_resource *dst,
+                              unsigned dst_level,
+                              unsigned dstx, unsigned dsty, unsigned dstz,
+                              struct pipe_resource *src,
+                              unsigned src_level,
+                              const struct pipe_box *src_box)
+{
+        struct panfrost_context *ctx = pan_context(pctx);
+
+        if (dst->target != PIPE_BUFFER && src->target != PIPE_BUFFER &&
+            (drm_is_afbc(pan_resource(dst)->image.layout.modifier) ||
+             drm_is_afbc(pan_resource(src)->image.layout.modifier)) &&
+            util_blitter_is_copy_supported(ctx->blitter, dst, src)) {
+                panfrost_blitter_save(ctx, false);
+                util_blitter_copy_texture(ctx->blitter, dst, dst_level,
+                                          dstx, dsty, dstz, src, src_level,
+                                          src_box);
+                return;
+        }
+
+        util_resource_copy_region(pctx, dst, dst_level, dstx, dsty, dstz,
+                                  src, src_level, src_box);
+}
+
 void
 panfrost_resource_context_init(struct pipe_context *pctx)
 {
@@ -1502,7 +1532,7 @@ panfrost_resource_context_init(struct pipe_context *pctx)
         pctx->texture_unmap = u_transfer_helper_transfer_unmap;
         pctx->create_surface = panfrost_create_surface;
         pctx->surface_destroy = panfrost_surface_destroy;
-        pctx->resource_copy_region = util_resource_copy_region;
+        pctx->resource_copy_region = panfrost_resource_copy_region;
         pctx->blit = panfrost_blit;
         pctx->generate_mipmap = panfrost_generate_mipmap;
         pctx->flush_resource = panfrost_flush_resource;
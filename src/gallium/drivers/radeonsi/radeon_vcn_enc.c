@@ -611,11 +611,15 @@ static void radeon_enc_encode_bitstream(struct pipe_video_codec *encoder,
    enc->get_buffer(destination, &enc->bs_handle, NULL);
    enc->bs_size = destination->width0;
 
-   *fb = enc->fb = CALLOC_STRUCT(rvid_buffer);
+   if (enc->num_free_fb) {
+      *fb = enc->fb = enc->free_fb[--enc->num_free_fb];
+   } else {
+      *fb = enc->fb = CALLOC_STRUCT(rvid_buffer);
 
-   if (!si_vid_create_buffer(enc->screen, enc->fb, 4096, PIPE_USAGE_STAGING)) {
-      RVID_ERR("Can't create feedback buffer.\n");
-      return;
+      if (!si_vid_create_buffer(enc->screen, enc->fb, 4096, PIPE_USAGE_STAGING)) {
+         RVID_ERR("Can't create feedback buffer.\n");
+         return;
+      }
    }
 
    enc->need_feedback = true;
@@ -645,6 +649,8 @@ static void radeon_enc_destroy(struct pipe_video_codec *encoder)
    }
 
    RADEON_ENC_DESTROY_VIDEO_BUFFER(enc->dpb);
+   while (enc->num_free_fb)
+      RADEON_ENC_DESTROY_VIDEO_BUFFER(enc->free_fb[--enc->num_free_fb]);
    enc->ws->cs_destroy(&enc->cs);
    FREE(enc);
 }
@@ -662,7 +668,14 @@ static void radeon_enc_get_feedback(struct pipe_video_codec *encoder, void *feed
          *size = ptr[6];
       else
          *size = 0;
+      /* Clear the status so a recycled buffer doesn't report a stale size. */
+      ptr[1] = 0;
       enc->ws->buffer_unmap(enc->ws, fb->res->buf);
+
+      if (enc->num_free_fb < RADEON_ENC_MAX_FREE_FEEDBACK_BUFFERS) {
+         enc->free_fb[enc->num_free_fb++] = fb;
+         return;
+      }
    }
 
    si_vid_destroy_buffer(fb);
@@ -135,6 +135,8 @@
 
 #define RENCODE_MAX_NUM_TEMPORAL_LAYERS                                             4
 
+#define RADEON_ENC_MAX_FREE_FEEDBACK_BUFFERS                                        16
+
 #define PIPE_H265_ENC_CTB_SIZE                                                      64
 #define PIPE_H264_MB_SIZE                                                           16
 
@@ -609,6 +611,9 @@ struct radeon_encoder {
    struct rvid_buffer *si;
    struct rvid_buffer *fb;
    struct rvid_buffer *dpb;
+   /* feedback buffers returned by get_feedback, reused by later frames */
+   struct rvid_buffer *free_fb[RADEON_ENC_MAX_FREE_FEEDBACK_BUFFERS];
+   unsigned num_free_fb;
    struct radeon_enc_pic enc_pic;
    rvcn_enc_cmd_t cmd;
 
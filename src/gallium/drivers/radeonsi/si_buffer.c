@@ -23,6 +23,7 @@
  */
 
 #include "si_pipe.h"
+#include "util/streaming-load-memcpy.h"
 #include "util/u_memory.h"
 #include "util/u_transfer.h"
 #include "util/u_upload_mgr.h"
@@ -555,7 +556,15 @@ static void si_buffer_subdata(struct pipe_context *ctx, struct pipe_resource *bu
    if (!map)
       return;
 
-   memcpy(map, data, size);
+   /* Staging buffers are write-combined too, so large writes only need to
+    * avoid going through the cache.
+    */
+   struct si_resource *buf = si_resource(buffer);
+   if (size >= 4096 &&
+       (buf->domains & RADEON_DOMAIN_VRAM || buf->flags & RADEON_FLAG_GTT_WC))
+      util_streaming_store_memcpy(map, data, size);
+   else
+      memcpy(map, data, size);
    si_buffer_transfer_unmap(ctx, transfer);
 }
 
@@ -183,6 +183,32 @@
    } \
 } while (0)
 
+/**
+ * Set consecutive tracked registers, only emitting the range between the first
+ * and the last register whose value is different.
+ * @param offset        offset of the first register
+ * @param reg           first tracked register
+ * @param values        array of num values
+ */
+#define radeon_opt_set_context_reg_range(sctx, offset, reg, values, num) do { \
+   unsigned __first = (num), __last = 0; \
+   for (unsigned __i = 0; __i < (num); __i++) { \
+      if (!(sctx->tracked_regs.reg_saved & BITFIELD64_BIT((reg) + __i)) || \
+          sctx->tracked_regs.reg_value[(reg) + __i] != (values)[__i]) { \
+         __first = MIN2(__first, __i); \
+         __last = __i; \
+      } \
+   } \
+   if (__first < (num)) { \
+      unsigned __count = __last - __first + 1; \
+      radeon_set_context_reg_seq((offset) + __first * 4, __count); \
+      radeon_emit_array((values) + __first, __count); \
+      memcpy(&sctx->tracked_regs.reg_value[(reg) + __first], (values) + __first, \
+             sizeof(uint32_t) * __count); \
+      sctx->tracked_regs.reg_saved |= BITFIELD64_RANGE((reg) + __first, __count); \
+   } \
+} while (0)
+
 /**
  * Set 2 consecutive registers if any registers value is different.
  * @param offset        starting register offset
@@ -190,70 +216,41 @@
  * @param val2          is written to second register
  */
 #define radeon_opt_set_context_reg2(sctx, offset, reg, val1, val2) do { \
-   unsigned __value1 = (val1), __value2 = (val2); \
-   if (((sctx->tracked_regs.reg_saved >> (reg)) & 0x3) != 0x3 || \
-       sctx->tracked_regs.reg_value[reg] != __value1 || \
-       sctx->tracked_regs.reg_value[(reg) + 1] != __value2) { \
-      radeon_set_context_reg_seq(offset, 2); \
-      radeon_emit(__value1); \
-      radeon_emit(__value2); \
-      sctx->tracked_regs.reg_value[reg] = __value1; \
-      sctx->tracked_regs.reg_value[(reg) + 1] = __value2; \
-      sctx->tracked_regs.reg_saved |= 0x3ull << (reg); \
-   } \
+   const uint32_t __values[] = { (val1), (val2) }; \
+   radeon_opt_set_context_reg_range(sctx, offset, reg, __values, 2); \
 } while (0)
 
 /**
  * Set 3 consecutive registers if any registers value is different.
  */
 #define radeon_opt_set_context_reg3(sctx, offset, reg, val1, val2, val3) do { \
-   unsigned __value1 = (val1), __value2 = (val2), __value3 = (val3); \
-   if (((sctx->tracked_regs.reg_saved >> (reg)) & 0x7) != 0x7 || \
-       sctx->tracked_regs.reg_value[reg] != __value1 || \
-       sctx->tracked_regs.reg_value[(reg) + 1] != __value2 || \
-       sctx->tracked_regs.reg_value[(reg) + 2] != __value3) { \
-      radeon_set_context_reg_seq(offset, 3); \
-      radeon_emit(__value1); \
-      radeon_emit(__value2); \
-      radeon_emit(__value3); \
-      sctx->tracked_regs.reg_value[reg] = __value1; \
-      sctx->tracked_regs.reg_value[(reg) + 1] = __value2; \
-      sctx->tracked_regs.reg_value[(reg) + 2] = __value3; \
-      sctx->tracked_regs.reg_saved |= 0x7ull << (reg); \
-   } \
+   const uint32_t __values[] = { (val1), (val2), (val3) }; \
+   radeon_opt_set_context_reg_range(sctx, offset, reg, __values, 3); \
 } while (0)
 
 /**
  * Set 4 consecutive registers if any registers value is different.
  */
 #define radeon_opt_set_context_reg4(sctx, offset, reg, val1, val2, val3, val4) do { \
-   unsigned __value1 = (val1), __value2 = (val2), __value3 = (val3), __value4 = (val4); \
-   if (((sctx->tracked_regs.reg_saved >> (reg)) & 0xf) != 0xf || \
-       sctx->tracked_regs.reg_value[reg] != __value1 || \
-       sctx->tracked_regs.reg_value[(reg) + 1] != __value2 || \
-       sctx->tracked_regs.reg_value[(reg) + 2] != __value3 || \
-       sctx->tracked_regs.reg_value[(reg) + 3] != __value4) { \
-      radeon_set_context_reg_seq(offset, 4); \
-      radeon_emit(__value1); \
-      radeon_emit(__value2); \
-      radeon_emit(__value3); \
-      radeon_emit(__value4); \
-      sctx->tracked_regs.reg_value[reg] = __value1; \
-      sctx->tracked_regs.reg_value[(reg) + 1] = __value2; \
-      sctx->tracked_regs.reg_value[(reg) + 2] = __value3; \
-      sctx->tracked_regs.reg_value[(reg) + 3] = __value4; \
-      sctx->tracked_regs.reg_saved |= 0xfull << (reg); \
-   } \
+   const uint32_t __values[] = { (val1), (val2), (val3), (val4) }; \
+   radeon_opt_set_context_reg_range(sctx, offset, reg, __values, 4); \
 } while (0)
 
 /**
- * Set consecutive registers if any registers value is different.
+ * Set consecutive registers if any registers value is different, only
+ * emitting the range between the first and the last changed register.
  */
 #define radeon_opt_set_context_regn(sctx, offset, value, saved_val, num) do { \
-   if (memcmp(value, saved_val, sizeof(uint32_t) * (num))) { \
-      radeon_set_context_reg_seq(offset, num); \
-      radeon_emit_array(value, num); \
-      memcpy(saved_val, value, sizeof(uint32_t) * (num)); \
+   unsigned __first = 0, __last = (num); \
+   while (__first < (num) && (value)[__first] == (saved_val)[__first]) \
+      __first++; \
+   if (__first < (num)) { \
+      while ((value)[__last - 1] == (saved_val)[__last - 1]) \
+         __last--; \
+      radeon_set_context_reg_seq((offset) + __first * 4, __last - __first); \
+      radeon_emit_array((value) + __first, __last - __first); \
+      memcpy((saved_val) + __first, (value) + __first, \
+             sizeof(uint32_t) * (__last - __first)); \
    } \
 } while (0)
 
@@ -1162,10 +1162,11 @@ static struct pipe_screen *radeonsi_screen_create_impl(struct radeon_winsys *ws,
       return NULL;
    }
 
-   /* Initialize just one compiler instance to check for errors. The other compiler instances are
-    * initialized on demand.
+   /* Only check that LLVM supports the chip here. All compiler instances are initialized
+    * on demand, which keeps them off the startup path of processes that never compile.
     */
-   if (!si_init_compiler(sscreen, &sscreen->compiler[0])) {
+   ac_init_llvm_once();
+   if (!ac_is_llvm_family_supported(sscreen->info.family)) {
       /* The callee prints the error message. */
       FREE(sscreen);
       return NULL;
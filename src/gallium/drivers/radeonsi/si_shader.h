@@ -519,6 +519,10 @@ struct si_shader_selector {
    ubyte cs_images_num_sgprs;
    ubyte cs_num_images_in_user_sgprs;
    unsigned ngg_cull_vert_threshold; /* UINT32_MAX = disabled */
+   /* Saturating counter of whether NGG culling was enabled when this VS was unbound.
+    * It's only a hint, so races between contexts are harmless.
+    */
+   uint8_t ngg_cull_history;
    enum pipe_prim_type rast_prim;
 
    /* GS parameters. */
@@ -266,7 +266,7 @@ void si_llvm_optimize_module(struct si_shader_context *ctx)
 void si_llvm_dispose(struct si_shader_context *ctx)
 {
    LLVMDisposeModule(ctx->ac.module);
-   LLVMContextDispose(ctx->ac.context);
+   ac_llvm_compiler_put_context(ctx->compiler);
    ac_llvm_context_dispose(&ctx->ac);
 }
 
@@ -1409,6 +1409,33 @@ static void si_emit_draw_registers(struct si_context *sctx,
       }                                                                  \
    } while (0)
 
+/* Return the number of vertices per primitive if consecutive draws with adjacent index
+ * ranges can be merged into one draw packet, or 0 if they can't.
+ *
+ * This is only the case for list topologies without primitive restart, where draws
+ * don't share anything the shaders can observe: a GS could read the primitive ID,
+ * which starts from 0 in each draw, and so could the PS.
+ */
+static unsigned si_get_mergeable_draw_prim_size(struct si_context *sctx,
+                                                const struct pipe_draw_info *info,
+                                                unsigned instance_count)
+{
+   if (instance_count != 1 || info->primitive_restart || sctx->shader.gs.cso ||
+       (sctx->shader.ps.cso && sctx->shader.ps.cso->info.uses_primid))
+      return 0;
+
+   switch (info->mode) {
+   case PIPE_PRIM_POINTS:
+      return 1;
+   case PIPE_PRIM_LINES:
+      return 2;
+   case PIPE_PRIM_TRIANGLES:
+      return 3;
+   default:
+      return 0;
+   }
+}
+
 template <amd_gfx_level GFX_VERSION, si_has_ngg NGG, si_is_draw_vertex_state IS_DRAW_VERTEX_STATE>
 ALWAYS_INLINE
 static void si_emit_draw_packets(struct si_context *sctx, const struct pipe_draw_info *info,
@@ -1753,14 +1780,27 @@ static void si_emit_draw_packets(struct si_context *sctx, const struct pipe_draw
                      num_draws--;
                }
 
+               /* Draws which continue where the previous one ended are merged, which helps
+                * apps issuing many small draws from the same index buffer.
+                */
+               unsigned prim_size = num_draws > 1 ?
+                  si_get_mergeable_draw_prim_size(sctx, info, instance_count) : 0;
+
                for (unsigned i = 0; i < num_draws; i++) {
                   uint64_t va = index_va + draws[i].start * index_size;
+                  unsigned count = draws[i].count;
+
+                  while (prim_size && i + 1 < num_draws && count % prim_size == 0 &&
+                         draws[i + 1].start == draws[i].start + draws[i].count) {
+                     i++;
+                     count += draws[i].count;
+                  }
 
                   radeon_emit(PKT3(PKT3_DRAW_INDEX_2, 4, render_cond_bit));
                   radeon_emit(index_max_size);
                   radeon_emit(va);
                   radeon_emit(va >> 32);
-                  radeon_emit(draws[i].count);
+                  radeon_emit(count);
                   radeon_emit(V_0287F0_DI_SRC_SEL_DMA |
                               S_0287F0_NOT_EOP(GFX_VERSION >= GFX10 && i < num_draws - 1));
                }
@@ -2355,8 +2395,10 @@ static void si_draw(struct pipe_context *ctx,
           (HAS_TESS || HAS_GS || util_rast_prim_is_lines_or_triangles(sctx->current_rast_prim)) &&
           /* Only the first draw for a shader starts with culling disabled and it's disabled
            * until we pass the total_direct_count check and then it stays enabled until
-           * the shader is changed. This eliminates most culling on/off state changes. */
-          (old_ngg_culling || total_direct_count > hw_vs->ngg_cull_vert_threshold)) {
+           * the shader is changed. This eliminates most culling on/off state changes.
+           * Shaders that used culling in their recent binds start with it enabled. */
+          (old_ngg_culling || hw_vs->ngg_cull_history >= 2 ||
+           total_direct_count > hw_vs->ngg_cull_vert_threshold)) {
          struct si_state_rasterizer *rs = sctx->queued.named.rasterizer;
 
          /* Check that the current shader allows culling. */
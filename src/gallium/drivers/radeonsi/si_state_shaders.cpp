@@ -2581,38 +2581,61 @@ static void si_build_shader_variant_low_priority(void *job, void *gdata, int thr
 /* This should be const, but C++ doesn't allow implicit zero-initialization with const. */
 static union si_shader_key zeroed;
 
+static bool si_has_main_part(struct si_shader_selector *sel, const union si_shader_key *key)
+{
+   simple_mtx_lock(&sel->mutex);
+   bool present = *si_get_main_shader_part(sel, key) != NULL;
+   simple_mtx_unlock(&sel->mutex);
+   return present;
+}
+
+/* Compile the main part for the key if it doesn't exist yet. The compilation happens without
+ * holding the selector mutex, so that other threads can keep selecting and building variants of
+ * the same shader in the meantime. If two threads race, the first main part to finish wins.
+ */
 static bool si_check_missing_main_part(struct si_screen *sscreen, struct si_shader_selector *sel,
                                        struct si_compiler_ctx_state *compiler_state,
                                        const union si_shader_key *key)
 {
-   struct si_shader **mainp = si_get_main_shader_part(sel, key);
+   if (si_has_main_part(sel, key))
+      return true;
 
-   if (!*mainp) {
-      struct si_shader *main_part = CALLOC_STRUCT(si_shader);
+   struct si_shader *main_part = CALLOC_STRUCT(si_shader);
 
-      if (!main_part)
-         return false;
+   if (!main_part)
+      return false;
 
-      /* We can leave the fence as permanently signaled because the
-       * main part becomes visible globally only after it has been
-       * compiled. */
-      util_queue_fence_init(&main_part->ready);
+   /* We can leave the fence as permanently signaled because the
+    * main part becomes visible globally only after it has been
+    * compiled. */
+   util_queue_fence_init(&main_part->ready);
 
-      main_part->selector = sel;
-      if (sel->stage <= MESA_SHADER_GEOMETRY) {
-         main_part->key.ge.as_es = key->ge.as_es;
-         main_part->key.ge.as_ls = key->ge.as_ls;
-         main_part->key.ge.as_ngg = key->ge.as_ngg;
-      }
-      main_part->is_monolithic = false;
-      main_part->wave_size = si_determine_wave_size(sscreen, main_part);
+   main_part->selector = sel;
+   if (sel->stage <= MESA_SHADER_GEOMETRY) {
+      main_part->key.ge.as_es = key->ge.as_es;
+      main_part->key.ge.as_ls = key->ge.as_ls;
+      main_part->key.ge.as_ngg = key->ge.as_ngg;
+   }
+   main_part->is_monolithic = false;
+   main_part->wave_size = si_determine_wave_size(sscreen, main_part);
 
-      if (!si_compile_shader(sscreen, compiler_state->compiler, main_part,
-                             &compiler_state->debug)) {
-         FREE(main_part);
-         return false;
-      }
+   if (!si_compile_shader(sscreen, compiler_state->compiler, main_part,
+                          &compiler_state->debug)) {
+      FREE(main_part);
+      return false;
+   }
+
+   simple_mtx_lock(&sel->mutex);
+   struct si_shader **mainp = si_get_main_shader_part(sel, key);
+   if (!*mainp) {
       *mainp = main_part;
+      main_part = NULL;
+   }
+   simple_mtx_unlock(&sel->mutex);
+
+   if (main_part) {
+      si_shader_destroy(main_part);
+      FREE(main_part);
    }
    return true;
 }
@@ -2794,7 +2817,7 @@ current_not_ready:
     * if the initial guess was wrong.
     */
    if (!is_pure_monolithic) {
-      bool ok = true;
+      union si_shader_key shader1_key = zeroed;
 
       /* Make sure the main shader part is present. This is needed
        * for shaders that can be compiled as VS, LS, or ES, and only
@@ -2807,8 +2830,6 @@ current_not_ready:
        * part is present.
        */
       if (previous_stage_sel) {
-         union si_shader_key shader1_key = zeroed;
-
          if (sel->stage == MESA_SHADER_TESS_CTRL) {
             shader1_key.ge.as_ls = 1;
          } else if (sel->stage == MESA_SHADER_GEOMETRY) {
@@ -2817,22 +2838,23 @@ current_not_ready:
          } else {
             assert(0);
          }
-
-         simple_mtx_lock(&previous_stage_sel->mutex);
-         ok = si_check_missing_main_part(sscreen, previous_stage_sel, &shader->compiler_ctx_state,
-                                         &shader1_key);
-         simple_mtx_unlock(&previous_stage_sel->mutex);
-      }
-
-      if (ok) {
-         ok = si_check_missing_main_part(sscreen, sel, &shader->compiler_ctx_state,
-                                         (union si_shader_key*)key);
       }
 
-      if (!ok) {
+      if (!*si_get_main_shader_part(sel, (union si_shader_key*)key) ||
+          (previous_stage_sel && !si_has_main_part(previous_stage_sel, &shader1_key))) {
+         /* Compile the missing parts without holding the mutex and start over. */
+         struct si_compiler_ctx_state compiler_state = shader->compiler_ctx_state;
          FREE(shader);
          simple_mtx_unlock(&sel->mutex);
-         return -ENOMEM; /* skip the draw call */
+
+         if ((previous_stage_sel &&
+              !si_check_missing_main_part(sscreen, previous_stage_sel, &compiler_state,
+                                          &shader1_key)) ||
+             !si_check_missing_main_part(sscreen, sel, &compiler_state,
+                                         (union si_shader_key*)key))
+            return -ENOMEM; /* skip the draw call */
+
+         goto again;
       }
    }
 
@@ -3383,6 +3405,18 @@ static void si_bind_vs_shader(struct pipe_context *ctx, void *state)
    if (sctx->shader.vs.cso == sel)
       return;
 
+   /* Remember whether the outgoing VS ended up using culling, so that its next bind can
+    * start with the culling variant instead of switching variants after the first large
+    * draw, and shaders only used for small draws keep starting without it.
+    */
+   if (old_hw_vs && old_hw_vs == sctx->shader.vs.cso &&
+       old_hw_vs->ngg_cull_vert_threshold != UINT_MAX) {
+      if (sctx->ngg_culling)
+         old_hw_vs->ngg_cull_history = MIN2(old_hw_vs->ngg_cull_history + 1, 3);
+      else if (old_hw_vs->ngg_cull_history)
+         old_hw_vs->ngg_cull_history--;
+   }
+
    sctx->shader.vs.cso = sel;
    sctx->shader.vs.current = (sel && sel->variants_count) ? sel->variants[0] : NULL;
    sctx->num_vs_blit_sgprs = sel ? sel->info.base.vs.blit_sgprs_amd : 0;
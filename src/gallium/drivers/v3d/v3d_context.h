@@ -326,6 +326,36 @@ struct v3d_perfmon_state {
         uint64_t values[DRM_V3D_MAX_PERF_COUNTERS];
 };
 
+/**
+ * Packed supertile configuration and supertile coordinate packets of the
+ * last RCL layer emitted without scissor culling.
+ *
+ * These packets carry no addresses and only depend on the tile layout and
+ * the drawn area of the job, so for the common case of rendering the same
+ * framebuffer frame after frame we can copy them into the RCL instead of
+ * packing every supertile coordinate again.
+ */
+struct v3d_rcl_supertiles {
+        bool valid;
+
+        /** @{ Key */
+        uint32_t draw_tiles_x;
+        uint32_t draw_tiles_y;
+        uint32_t tile_width;
+        uint32_t tile_height;
+        uint32_t draw_min_x;
+        uint32_t draw_min_y;
+        uint32_t draw_max_x;
+        uint32_t draw_max_y;
+        /** @} */
+
+        /** MULTICORE_RENDERING_SUPERTILE_CFG packet. */
+        uint8_t *cfg;
+        /** SUPERTILE_COORDINATES packets. */
+        uint8_t *coords;
+        uint32_t coords_size;
+};
+
 /**
  * A complete bin/render job.
  *
@@ -530,6 +560,9 @@ struct v3d_context {
 
         struct v3d_compiler_state *compiler_state;
 
+        /** Supertile packets reused across RCLs, see v3dx_rcl.c. */
+        struct v3d_rcl_supertiles rcl_supertiles;
+
         uint8_t prim_mode;
 
         /** Maximum index buffer valid for the current shader_rec. */
@@ -580,41 +580,47 @@ do_double_initial_tile_clear(const struct v3d_job *job)
 }
 #endif
 
+#define MAX_SUPERTILES 256
+
+static bool
+rcl_supertiles_match(const struct v3d_rcl_supertiles *st,
+                     const struct v3d_job *job)
+{
+        return st->valid &&
+               st->draw_tiles_x == job->draw_tiles_x &&
+               st->draw_tiles_y == job->draw_tiles_y &&
+               st->tile_width == job->tile_width &&
+               st->tile_height == job->tile_height &&
+               st->draw_min_x == job->draw_min_x &&
+               st->draw_min_y == job->draw_min_y &&
+               st->draw_max_x == job->draw_max_x &&
+               st->draw_max_y == job->draw_max_y;
+}
+
 static void
-emit_render_layer(struct v3d_job *job, uint32_t layer)
+pack_supertiles(struct v3d_job *job, struct v3d_rcl_supertiles *st)
 {
         uint32_t supertile_w = 1, supertile_h = 1;
+        uint32_t frame_w_in_supertiles, frame_h_in_supertiles;
+
+        /* Size up our supertiles until we get under the limit. */
+        for (;;) {
+                frame_w_in_supertiles = div_round_up(job->draw_tiles_x,
+                                                     supertile_w);
+                frame_h_in_supertiles = div_round_up(job->draw_tiles_y,
+                                                     supertile_h);
+                if (frame_w_in_supertiles *
+                        frame_h_in_supertiles < MAX_SUPERTILES) {
+                        break;
+                }
 
-        /* If doing multicore binning, we would need to initialize each
-         * core's tile list here.
-         */
-        uint32_t tile_alloc_offset =
-                layer * job->draw_tiles_x * job->draw_tiles_y * 64;
-        cl_emit(&job->rcl, MULTICORE_RENDERING_TILE_LIST_SET_BASE, list) {
-                list.address = cl_address(job->tile_alloc, tile_alloc_offset);
+                if (supertile_w < supertile_h)
+                        supertile_w++;
+                else
+                        supertile_h++;
         }
 
-        cl_emit(&job->rcl, MULTICORE_RENDERING_SUPERTILE_CFG, config) {
-                uint32_t frame_w_in_supertiles, frame_h_in_supertiles;
-                const uint32_t max_supertiles = 256;
-
-                /* Size up our supertiles until we get under the limit. */
-                for (;;) {
-                        frame_w_in_supertiles = div_round_up(job->draw_tiles_x,
-                                                             supertile_w);
-                        frame_h_in_supertiles = div_round_up(job->draw_tiles_y,
-                                                             supertile_h);
-                        if (frame_w_in_supertiles *
-                                frame_h_in_supertiles < max_supertiles) {
-                                break;
-                        }
-
-                        if (supertile_w < supertile_h)
-                                supertile_w++;
-                        else
-                                supertile_h++;
-                }
-
+        v3dx_pack(st->cfg, MULTICORE_RENDERING_SUPERTILE_CFG, config) {
                 config.number_of_bin_tile_lists = 1;
                 config.total_frame_width_in_tiles = job->draw_tiles_x;
                 config.total_frame_height_in_tiles = job->draw_tiles_y;
@@ -626,6 +632,112 @@ emit_render_layer(struct v3d_job *job, uint32_t layer)
                 config.total_frame_height_in_supertiles = frame_h_in_supertiles;
         }
 
+        /* XXX perf: We should expose GL_MESA_tile_raster_order to
+         * improve X11 performance, but we should use Morton order
+         * otherwise to improve cache locality.
+         */
+        uint32_t supertile_w_in_pixels = job->tile_width * supertile_w;
+        uint32_t supertile_h_in_pixels = job->tile_height * supertile_h;
+        uint32_t min_x_supertile = job->draw_min_x / supertile_w_in_pixels;
+        uint32_t min_y_supertile = job->draw_min_y / supertile_h_in_pixels;
+
+        uint32_t max_x_supertile = 0;
+        uint32_t max_y_supertile = 0;
+        if (job->draw_max_x != 0 && job->draw_max_y != 0) {
+                max_x_supertile = (job->draw_max_x - 1) / supertile_w_in_pixels;
+                max_y_supertile = (job->draw_max_y - 1) / supertile_h_in_pixels;
+        }
+
+        uint8_t *coords = st->coords;
+        for (int y = min_y_supertile; y <= max_y_supertile; y++) {
+                for (int x = min_x_supertile; x <= max_x_supertile; x++) {
+                        if (supertile_in_job_scissors(job, x, y,
+                                                      supertile_w_in_pixels,
+                                                      supertile_h_in_pixels)) {
+                                v3dx_pack(coords, SUPERTILE_COORDINATES, c) {
+                                      c.column_number_in_supertiles = x;
+                                      c.row_number_in_supertiles = y;
+                                }
+                                coords += cl_packet_length(SUPERTILE_COORDINATES);
+                        }
+                }
+        }
+        st->coords_size = coords - st->coords;
+}
+
+/* Returns the supertile packets for the job. When the job isn't culled by
+ * scissors these only depend on the framebuffer layout and drawn area, so we
+ * keep them in the context and reuse them across jobs that render the same
+ * area, which is what a compositor does every frame. Otherwise they are
+ * packed into the caller-provided scratch storage.
+ */
+static const struct v3d_rcl_supertiles *
+get_supertiles(struct v3d_job *job, struct v3d_rcl_supertiles *scratch)
+{
+        struct v3d_rcl_supertiles *st = &job->v3d->rcl_supertiles;
+
+        if (!job->scissor.disabled && job->scissor.count > 0) {
+                pack_supertiles(job, scratch);
+                return scratch;
+        }
+
+        if (rcl_supertiles_match(st, job))
+                return st;
+
+        if (!st->cfg) {
+                st->cfg = ralloc_size(job->v3d,
+                                      cl_packet_length(MULTICORE_RENDERING_SUPERTILE_CFG));
+                st->coords = ralloc_size(job->v3d,
+                                         MAX_SUPERTILES *
+                                         cl_packet_length(SUPERTILE_COORDINATES));
+                if (!st->cfg || !st->coords) {
+                        ralloc_free(st->cfg);
+                        ralloc_free(st->coords);
+                        st->cfg = NULL;
+                        st->coords = NULL;
+                        pack_supertiles(job, scratch);
+                        return scratch;
+                }
+        }
+
+        pack_supertiles(job, st);
+        st->draw_tiles_x = job->draw_tiles_x;
+        st->draw_tiles_y = job->draw_tiles_y;
+        st->tile_width = job->tile_width;
+        st->tile_height = job->tile_height;
+        st->draw_min_x = job->draw_min_x;
+        st->draw_min_y = job->draw_min_y;
+        st->draw_max_x = job->draw_max_x;
+        st->draw_max_y = job->draw_max_y;
+        st->valid = true;
+
+        return st;
+}
+
+static void
+emit_render_layer(struct v3d_job *job, uint32_t layer)
+{
+        uint8_t scratch_cfg[cl_packet_length(MULTICORE_RENDERING_SUPERTILE_CFG)];
+        uint8_t scratch_coords[MAX_SUPERTILES *
+                               cl_packet_length(SUPERTILE_COORDINATES)];
+        struct v3d_rcl_supertiles scratch = {
+                .cfg = scratch_cfg,
+                .coords = scratch_coords,
+        };
+        const struct v3d_rcl_supertiles *st = get_supertiles(job, &scratch);
+
+        /* If doing multicore binning, we would need to initialize each
+         * core's tile list here.
+         */
+        uint32_t tile_alloc_offset =
+                layer * job->draw_tiles_x * job->draw_tiles_y * 64;
+        cl_emit(&job->rcl, MULTICORE_RENDERING_TILE_LIST_SET_BASE, list) {
+                list.address = cl_address(job->tile_alloc, tile_alloc_offset);
+        }
+
+        cl_emit_prepacked_sized(&job->rcl, st->cfg,
+                                cl_packet_length(MULTICORE_RENDERING_SUPERTILE_CFG));
+
         /* Start by clearing the tile buffer. */
         cl_emit(&job->rcl, TILE_COORDINATES, coords) {
                 coords.tile_column_number = 0;
@@ -671,34 +783,7 @@ emit_render_layer(struct v3d_job *job, uint32_t layer)
 
         v3d_rcl_emit_generic_per_tile_list(job, layer);
 
-        /* XXX perf: We should expose GL_MESA_tile_raster_order to
-         * improve X11 performance, but we should use Morton order
-         * otherwise to improve cache locality.
-         */
-        uint32_t supertile_w_in_pixels = job->tile_width * supertile_w;
-        uint32_t supertile_h_in_pixels = job->tile_height * supertile_h;
-        uint32_t min_x_supertile = job->draw_min_x / supertile_w_in_pixels;
-        uint32_t min_y_supertile = job->draw_min_y / supertile_h_in_pixels;
-
-        uint32_t max_x_supertile = 0;
-        uint32_t max_y_supertile = 0;
-        if (job->draw_max_x != 0 && job->draw_max_y != 0) {
-                max_x_supertile = (job->draw_max_x - 1) / supertile_w_in_pixels;
-                max_y_supertile = (job->draw_max_y - 1) / supertile_h_in_pixels;
-        }
-
-        for (int y = min_y_supertile; y <= max_y_supertile; y++) {
-                for (int x = min_x_supertile; x <= max_x_supertile; x++) {
-                        if (supertile_in_job_scissors(job, x, y,
-                                                      supertile_w_in_pixels,
-                                                      supertile_h_in_pixels)) {
-                                cl_emit(&job->rcl, SUPERTILE_COORDINATES, coords) {
-                                      coords.column_number_in_supertiles = x;
-                                      coords.row_number_in_supertiles = y;
-                                }
-                        }
-                }
-        }
+        cl_emit_prepacked_sized(&job->rcl, st->coords, st->coords_size);
 }
 
 void
@@ -159,6 +159,43 @@ static bool transfers_intersect(struct virgl_transfer *queued,
          &current->base.box, true);
 }
 
+/* Two texture transfers can only be merged if their union covers exactly
+ * the texels of both, which is the case when their boxes line up in all
+ * dimensions but one and overlap or touch in that one.  A larger union would
+ * also upload texels of the guest storage that were never written.
+ */
+static bool transfers_adjacent(struct virgl_transfer *queued,
+                               struct virgl_transfer *current)
+{
+   const int dim_count = transfer_dim(current);
+   int merge_dim = -1;
+
+   if (queued->base.box.width <= 0 || queued->base.box.height <= 0 ||
+       queued->base.box.depth <= 0)
+      return false;
+
+   if (!transfer_overlap(queued, current->hw_res, current->base.level,
+                         &current->base.box, true))
+      return false;
+
+   for (int dim = 0; dim < dim_count; dim++) {
+      int queued_min, queued_max;
+      int current_min, current_max;
+
+      box_min_max(&queued->base.box, dim, &queued_min, &queued_max);
+      box_min_max(&current->base.box, dim, &current_min, &current_max);
+
+      if (queued_min == current_min && queued_max == current_max)
+         continue;
+
+      if (merge_dim >= 0)
+         return false;
+      merge_dim = dim;
+   }
+
+   return true;
+}
+
 static void remove_transfer(struct virgl_transfer_queue *queue,
                             struct virgl_transfer *queued)
 {
@@ -179,6 +216,26 @@ static void replace_unmapped_transfer(struct virgl_transfer_queue *queue,
    queue->num_dwords -= (VIRGL_TRANSFER3D_SIZE + 1);
 }
 
+static void merge_unmapped_transfer(struct virgl_transfer_queue *queue,
+                                    struct list_action_args *args)
+{
+   struct virgl_transfer *current = args->current;
+   struct virgl_transfer *queued = args->queued;
+
+   /* The merged box starts at the origin of one of the two boxes, so its
+    * offset in the guest storage is the offset of that transfer.
+    */
+   if (queued->base.box.x < current->base.box.x ||
+       queued->base.box.y < current->base.box.y ||
+       queued->base.box.z < current->base.box.z)
+      current->offset = queued->offset;
+
+   u_box_union_3d(&current->base.box, &current->base.box, &queued->base.box);
+
+   remove_transfer(queue, queued);
+   queue->num_dwords -= (VIRGL_TRANSFER3D_SIZE + 1);
+}
+
 static void transfer_put(struct virgl_transfer_queue *queue,
                          struct list_action_args *args)
 {
@@ -313,6 +370,14 @@ int virgl_transfer_queue_unmap(struct virgl_transfer_queue *queue,
       iter.compare = transfers_intersect;
       iter.action = replace_unmapped_transfer;
       compare_and_perform_action(queue, &iter);
+   } else if (transfer->base.box.width > 0 &&
+              transfer->base.box.height > 0 &&
+              transfer->base.box.depth > 0) {
+      memset(&iter, 0, sizeof(iter));
+      iter.current = transfer;
+      iter.compare = transfers_adjacent;
+      iter.action = merge_unmapped_transfer;
+      compare_and_perform_action(queue, &iter);
    }
 
    add_internal(queue, transfer);
@@ -533,14 +533,20 @@ submit_queue(void *data, void *gdata, int thread_index)
       }
    }
 
+   /* flush persistent mappings in as few calls as possible */
    while (util_dynarray_contains(&bs->persistent_resources, struct zink_resource_object*)) {
-      struct zink_resource_object *obj = util_dynarray_pop(&bs->persistent_resources, struct zink_resource_object*);
-       VkMappedMemoryRange range = zink_resource_init_mem_range(screen, obj, 0, obj->size);
+      VkMappedMemoryRange ranges[16];
+      unsigned num_ranges = 0;
+      while (num_ranges < ARRAY_SIZE(ranges) &&
+             util_dynarray_contains(&bs->persistent_resources, struct zink_resource_object*)) {
+         struct zink_resource_object *obj = util_dynarray_pop(&bs->persistent_resources, struct zink_resource_object*);
+         ranges[num_ranges++] = zink_resource_init_mem_range(screen, obj, 0, obj->size);
+      }
 
-       result = VKSCR(FlushMappedMemoryRanges)(screen->dev, 1, &range);
-       if (result != VK_SUCCESS) {
-          mesa_loge("ZINK: vkFlushMappedMemoryRanges failed (%s)", vk_Result_to_str(result));
-       }
+      result = VKSCR(FlushMappedMemoryRanges)(screen->dev, num_ranges, ranges);
+      if (result != VK_SUCCESS) {
+         mesa_loge("ZINK: vkFlushMappedMemoryRanges failed (%s)", vk_Result_to_str(result));
+      }
    }
 
    simple_mtx_lock(&screen->queue_lock);
@@ -453,6 +453,7 @@ zink_descriptor_program_init(struct zink_context *ctx, struct zink_program *pg)
             init_template_entry(shader, j, k, &entries[desc_type][entry_idx[desc_type]], &entry_idx[desc_type]);
             num_bindings[desc_type]++;
             has_bindings |= BITFIELD_BIT(desc_type);
+            pg->dd.stage_usage[desc_type] |= BITFIELD_BIT(stage);
          }
          num_type_sizes[desc_type] = screen->compact_descriptors ?
                                     descriptor_program_num_sizes_compact(sizes, desc_type) :
@@ -923,6 +924,7 @@ zink_descriptors_update(struct zink_context *ctx, bool is_compute)
       ctx->dd.push_state_changed[is_compute] = !!pg->dd.push_usage || ctx->dd.has_fbfetch != bs->dd.has_fbfetch;
    }
 
+   uint8_t layout_changed = 0;
    if (pg != bs->dd.pg[is_compute]) {
       /* if we don't already know that we have to update all sets,
        * check to see if any dsls changed
@@ -932,14 +934,25 @@ zink_descriptors_update(struct zink_context *ctx, bool is_compute)
        for (unsigned i = 0; i < ARRAY_SIZE(bs->dd.dsl[is_compute]); i++) {
           /* push set is already detected, start at 1 */
           if (bs->dd.dsl[is_compute][i] != pg->dsl[i + 1])
-             ctx->dd.state_changed[is_compute] |= BITFIELD_BIT(i);
+             layout_changed |= BITFIELD_BIT(i);
           bs->dd.dsl[is_compute][i] = pg->dsl[i + 1];
        }
        ctx->dd.push_state_changed[is_compute] |= bs->dd.push_usage[is_compute] != pg->dd.push_usage;
        bs->dd.push_usage[is_compute] = pg->dd.push_usage;
    }
+   ctx->dd.state_changed[is_compute] |= layout_changed;
 
    uint8_t changed_sets = pg->dd.binding_usage & ctx->dd.state_changed[is_compute];
+   /* a set whose layout is unchanged was written for the same stages: if only descriptors of
+    * stages this program doesn't read have changed, the bound set is still valid; any program
+    * reading those stages has a different layout and gets a new set
+    */
+   if (!is_compute && !batch_changed) {
+      u_foreach_bit(type, changed_sets & ~layout_changed) {
+         if (!(ctx->dd.gfx_stages_changed[type] & pg->dd.stage_usage[type]))
+            changed_sets &= ~BITFIELD_BIT(type);
+      }
+   }
    /*
     * when binding a pipeline, the pipeline can correctly access any previously bound
     * descriptor sets which were bound with compatible pipeline layouts
@@ -980,6 +993,8 @@ zink_descriptors_update(struct zink_context *ctx, bool is_compute)
    ctx->dd.pg[is_compute] = pg;
    bs->dd.compat_id[is_compute] = pg->compat_id;
    ctx->dd.state_changed[is_compute] = 0;
+   if (!is_compute)
+      memset(ctx->dd.gfx_stages_changed, 0, sizeof(ctx->dd.gfx_stages_changed));
 }
 
 /* called from gallium descriptor change hooks, e.g., set_sampler_views */
@@ -992,6 +1007,8 @@ zink_context_invalidate_descriptor_state(struct zink_context *ctx, gl_shader_sta
       if (zink_screen(ctx->base.screen)->compact_descriptors && type > ZINK_DESCRIPTOR_TYPE_SAMPLER_VIEW)
          type -= ZINK_DESCRIPTOR_COMPACT;
       ctx->dd.state_changed[shader == MESA_SHADER_COMPUTE] |= BITFIELD_BIT(type);
+      if (shader != MESA_SHADER_COMPUTE)
+         ctx->dd.gfx_stages_changed[type] |= BITFIELD_BIT(shader);
    }
 }
 
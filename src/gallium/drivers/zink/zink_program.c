@@ -689,13 +689,16 @@ optimized_compile_job(void *data, void *gdata, int thread_index)
    if (pipeline) {
       pc_entry->unoptimized_pipeline = pc_entry->pipeline;
       pc_entry->pipeline = pipeline;
+      pc_entry->prog->optimized_uncached = true;
    }
 }
 
 void
 zink_gfx_program_compile_queue(struct zink_context *ctx, struct zink_gfx_pipeline_cache_entry *pc_entry)
 {
-   util_queue_add_job(&zink_screen(ctx->base.screen)->cache_get_thread, pc_entry, &pc_entry->fence, optimized_compile_job, NULL, 0);
+   /* the unoptimized pipeline is used until this completes: don't hold up other jobs */
+   util_queue_add_job_with_deps(&zink_screen(ctx->base.screen)->cache_get_thread, pc_entry, &pc_entry->fence, optimized_compile_job, NULL, 0,
+                                UTIL_QUEUE_PRIORITY_BACKGROUND, NULL, 0);
 }
 
 static void
@@ -1173,6 +1176,14 @@ zink_destroy_gfx_program(struct zink_screen *screen,
       }
    }
 
+   /* background compiles finish after the cache was last written: store the optimized
+    * pipelines so the next run can skip the fast-linked ones
+    */
+   if (prog->optimized_uncached) {
+      util_queue_fence_wait(&prog->base.cache_fence);
+      zink_screen_update_pipeline_cache(screen, &prog->base, true);
+   }
+
    deinit_program(screen, &prog->base);
 
    for (int i = 0; i < ZINK_GFX_SHADER_COUNT; ++i) {
@@ -224,9 +224,16 @@ zink_get_gfx_pipeline(struct zink_context *ctx,
    ctx->vertex_state_changed = false;
 
    const int rp_idx = state->render_pass ? 1 : 0;
-   /* shortcut for reusing previous pipeline across program changes */
-   if (DYNAMIC_STATE == ZINK_DYNAMIC_VERTEX_INPUT || DYNAMIC_STATE == ZINK_DYNAMIC_VERTEX_INPUT2) {
-      if (prog->last_finalized_hash[rp_idx][idx] == state->final_hash && !prog->inline_variants && likely(prog->last_pipeline[rp_idx][idx])) {
+   /* shortcut for reusing previous pipeline across program changes
+    * (the fastpath arrays are indexed by primtype class, so dynamic topology is required)
+    */
+   if (DYNAMIC_STATE != ZINK_NO_DYNAMIC_STATE &&
+       prog->last_finalized_hash[rp_idx][idx] == state->final_hash && !prog->inline_variants && likely(prog->last_pipeline[rp_idx][idx])) {
+      /* without dynamic vertex input the key also has vertex strides and the full dynamic state:
+       * compare it like a table lookup would, but skip probing the table
+       */
+      if (DYNAMIC_STATE == ZINK_DYNAMIC_VERTEX_INPUT || DYNAMIC_STATE == ZINK_DYNAMIC_VERTEX_INPUT2 ||
+          prog->pipelines[rp_idx][idx].key_equals_function(state, &prog->last_pipeline[rp_idx][idx]->state)) {
          state->pipeline = prog->last_pipeline[rp_idx][idx]->pipeline;
          return state->pipeline;
       }
@@ -292,7 +299,7 @@ zink_get_gfx_pipeline(struct zink_context *ctx,
    struct zink_gfx_pipeline_cache_entry *cache_entry = (struct zink_gfx_pipeline_cache_entry *)entry->data;
    state->pipeline = cache_entry->pipeline;
    /* update states for fastpath */
-   if (DYNAMIC_STATE >= ZINK_DYNAMIC_VERTEX_INPUT) {
+   if (DYNAMIC_STATE != ZINK_NO_DYNAMIC_STATE) {
       prog->last_finalized_hash[rp_idx][idx] = state->final_hash;
       prog->last_pipeline[rp_idx][idx] = cache_entry;
    }
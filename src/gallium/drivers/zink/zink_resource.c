@@ -65,6 +65,8 @@
 #endif
 
 #define ZINK_EXTERNAL_MEMORY_HANDLE 999
+/* vkCmdUpdateBuffer copies the data into the cmdbuf, so only use it for small updates */
+#define ZINK_INLINE_UPDATE_MAX_SIZE 4096
 
 static bool
 equals_ivci(const void *a, const void *b)
@@ -2186,6 +2188,28 @@ zink_buffer_subdata(struct pipe_context *ctx, struct pipe_resource *buffer,
    if (!(usage & PIPE_MAP_DIRECTLY))
       usage |= PIPE_MAP_DISCARD_RANGE;
 
+   /* small updates to buffers which can't be written directly right now are
+    * inlined into the cmdbuf instead of going through a staging allocation
+    * and a copy:
+    *
+    * - dstOffset must be a multiple of 4
+    * - dataSize must be less than or equal to 65536 bytes and a multiple of 4
+    */
+   struct zink_screen *screen = zink_screen(ctx->screen);
+   struct zink_resource *res = zink_resource(buffer);
+   if (!(usage & (PIPE_MAP_DIRECTLY | PIPE_MAP_UNSYNCHRONIZED)) &&
+       offset % 4 == 0 && size % 4 == 0 && size <= ZINK_INLINE_UPDATE_MAX_SIZE &&
+       !res->base.is_user_ptr &&
+       (!res->obj->host_visible || !zink_resource_usage_check_completion(screen, res, ZINK_RESOURCE_ACCESS_RW))) {
+      struct zink_context *zctx = zink_context(ctx);
+      util_range_add(&res->base.b, &res->valid_buffer_range, offset, offset + size);
+      screen->buffer_barrier(zctx, res, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+      VkCommandBuffer cmdbuf = zink_get_cmdbuf(zctx, NULL, res);
+      zink_batch_reference_resource_rw(&zctx->batch, res, true);
+      VKSCR(CmdUpdateBuffer)(cmdbuf, res->obj->buffer, offset, size, data);
+      return;
+   }
+
    u_box_1d(offset, size, &box);
    map = zink_buffer_map(ctx, buffer, 0, usage, &box, &transfer);
    if (!map)
@@ -368,6 +368,8 @@ struct zink_descriptor_data {
    bool has_fbfetch;
    bool push_state_changed[2]; //gfx, compute
    uint8_t state_changed[2]; //gfx, compute
+   /* gfx stages whose descriptors changed, per set type */
+   uint8_t gfx_stages_changed[ZINK_DESCRIPTOR_BASE_TYPES];
    struct zink_descriptor_layout_key *push_layout_keys[2]; //gfx, compute
    struct zink_descriptor_layout *push_dsl[2]; //gfx, compute
    VkDescriptorUpdateTemplate push_template[2]; //gfx, compute
@@ -392,6 +394,8 @@ struct zink_program_descriptor_data {
    uint8_t push_usage;
    /* bitmask of which sets are used by the program */
    uint8_t binding_usage;
+   /* bitmask of the stages using each set */
+   uint8_t stage_usage[ZINK_DESCRIPTOR_BASE_TYPES];
    /* all the pool keys for the program */
    struct zink_descriptor_pool_key *pool_key[ZINK_DESCRIPTOR_BASE_TYPES]; //push set doesn't need one
    /* all the layouts for the program */
@@ -936,6 +940,7 @@ struct zink_gfx_program {
    uint32_t default_variant_hash;
    uint32_t last_variant_hash;
    uint8_t inline_variants; //which stages are using inlined uniforms
+   bool optimized_uncached; //optimized pipelines were compiled after the pipeline cache was last written
 
    uint32_t last_finalized_hash[2][4]; //[dynamic, renderpass][primtype idx]
    struct zink_gfx_pipeline_cache_entry *last_pipeline[2][4]; //[dynamic, renderpass][primtype idx]
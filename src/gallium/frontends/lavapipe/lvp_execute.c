@@ -106,6 +106,12 @@ struct rendering_state {
    struct pipe_rasterizer_state rs_state;
    struct pipe_depth_stencil_alpha_state dsa_state;
 
+   /* the last states passed to cso, dynamic state often sets them back to the same values */
+   bool cso_blend_valid, cso_rs_valid, cso_dsa_valid;
+   struct pipe_blend_state cso_blend_state;
+   struct pipe_rasterizer_state cso_rs_state;
+   struct pipe_depth_stencil_alpha_state cso_dsa_state;
+
    struct pipe_blend_color blend_color;
    struct pipe_stencil_ref stencil_ref;
    struct pipe_clip_state clip_state;
@@ -272,73 +278,122 @@ update_pcbuf(struct rendering_state *state, enum pipe_shader_type pstage)
 }
 
 static void
-update_inline_shader_state(struct rendering_state *state, enum pipe_shader_type sh, bool pcbuf_dirty, bool constbuf_dirty)
+fill_inline_uniforms(struct rendering_state *state, struct lvp_pipeline *pipeline,
+                     enum pipe_shader_type sh, unsigned slot, uint32_t *inline_uniforms)
 {
-   bool is_compute = sh == PIPE_SHADER_COMPUTE;
-   uint32_t inline_uniforms[MAX_INLINABLE_UNIFORMS];
    unsigned stage = tgsi_processor_to_shader_stage(sh);
-   state->inlines_dirty[sh] = false;
-   if (!state->pipeline[is_compute]->inlines[stage].can_inline)
-      return;
-   struct lvp_pipeline *pipeline = state->pipeline[is_compute];
+   unsigned count = pipeline->inlines[stage].count[slot];
    /* these buffers have already been flushed in llvmpipe, so they're safe to read */
-   nir_shader *base_nir = pipeline->pipeline_nir[stage];
-   if (stage == PIPE_SHADER_TESS_EVAL && state->tess_ccw)
-      base_nir = pipeline->tess_ccw;
-   nir_shader *nir = nir_shader_clone(pipeline->pipeline_nir[stage], base_nir);
-   nir_function_impl *impl = nir_shader_get_entrypoint(nir);
-   unsigned ssa_alloc = impl->ssa_alloc;
-   unsigned count = pipeline->inlines[stage].count[0];
-   if (count && pcbuf_dirty) {
+   if (slot == 0) {
       unsigned push_size = get_pcbuf_size(state, sh);
       for (unsigned i = 0; i < count; i++) {
          unsigned offset = pipeline->inlines[stage].uniform_offsets[0][i];
          if (offset < push_size) {
             memcpy(&inline_uniforms[i], &state->push_constants[offset], sizeof(uint32_t));
          } else {
-            for (unsigned i = 0; i < state->uniform_blocks[sh].count; i++) {
-               if (offset < push_size + state->uniform_blocks[sh].size[i]) {
-                  unsigned ubo_offset = offset - push_size;
-                  uint8_t *block = state->uniform_blocks[sh].block[i];
+            unsigned block_start = push_size;
+            for (unsigned j = 0; j < state->uniform_blocks[sh].count; j++) {
+               if (offset < block_start + state->uniform_blocks[sh].size[j]) {
+                  unsigned ubo_offset = offset - block_start;
+                  uint8_t *block = state->uniform_blocks[sh].block[j];
                   memcpy(&inline_uniforms[i], &block[ubo_offset], sizeof(uint32_t));
                   break;
                }
-               push_size += state->uniform_blocks[sh].size[i];
+               block_start += state->uniform_blocks[sh].size[j];
             }
          }
       }
-      NIR_PASS_V(nir, lvp_inline_uniforms, pipeline, inline_uniforms, 0);
-   }
-   if (constbuf_dirty) {
+   } else {
       struct pipe_box box = {0};
-      u_foreach_bit(slot, pipeline->inlines[stage].can_inline) {
-         unsigned count = pipeline->inlines[stage].count[slot];
-         struct pipe_constant_buffer *cbuf = &state->const_buffer[sh][slot - 1];
-         struct pipe_resource *pres = cbuf->buffer;
-         box.x = cbuf->buffer_offset;
-         box.width = cbuf->buffer_size - cbuf->buffer_offset;
-         struct pipe_transfer *xfer;
-         uint8_t *map = state->pctx->buffer_map(state->pctx, pres, 0, PIPE_MAP_READ, &box, &xfer);
-         for (unsigned i = 0; i < count; i++) {
-            unsigned offset = pipeline->inlines[stage].uniform_offsets[slot][i];
-            memcpy(&inline_uniforms[i], map + offset, sizeof(uint32_t));
-         }
-         state->pctx->buffer_unmap(state->pctx, xfer);
-         NIR_PASS_V(nir, lvp_inline_uniforms, pipeline, inline_uniforms, slot);
+      struct pipe_constant_buffer *cbuf = &state->const_buffer[sh][slot - 1];
+      struct pipe_resource *pres = cbuf->buffer;
+      box.x = cbuf->buffer_offset;
+      box.width = cbuf->buffer_size - cbuf->buffer_offset;
+      struct pipe_transfer *xfer;
+      uint8_t *map = state->pctx->buffer_map(state->pctx, pres, 0, PIPE_MAP_READ, &box, &xfer);
+      for (unsigned i = 0; i < count; i++) {
+         unsigned offset = pipeline->inlines[stage].uniform_offsets[slot][i];
+         memcpy(&inline_uniforms[i], map + offset, sizeof(uint32_t));
+      }
+      state->pctx->buffer_unmap(state->pctx, xfer);
+   }
+}
+
+static void
+update_inline_shader_state(struct rendering_state *state, enum pipe_shader_type sh)
+{
+   bool is_compute = sh == PIPE_SHADER_COMPUTE;
+   uint32_t inline_uniforms[MAX_INLINABLE_UNIFORMS] = {0};
+   unsigned stage = tgsi_processor_to_shader_stage(sh);
+   state->inlines_dirty[sh] = false;
+   if (!state->pipeline[is_compute]->inlines[stage].can_inline)
+      return;
+   struct lvp_pipeline *pipeline = state->pipeline[is_compute];
+   /* uniforms are only ever inlined from a single buffer */
+   assert(util_bitcount(pipeline->inlines[stage].can_inline) == 1);
+   unsigned slot = ffs(pipeline->inlines[stage].can_inline) - 1;
+   bool tess_ccw = sh == PIPE_SHADER_TESS_EVAL && state->tess_ccw;
+   fill_inline_uniforms(state, pipeline, sh, slot, inline_uniforms);
+
+   /* reuse a variant already specialized for these values, least recently used ones get replaced */
+   struct lvp_inline_variant *variant = NULL;
+   struct lvp_inline_variant *lru = &pipeline->inlines[stage].variants[0];
+   for (unsigned i = 0; i < pipeline->inlines[stage].num_variants; i++) {
+      struct lvp_inline_variant *v = &pipeline->inlines[stage].variants[i];
+      if (v->tess_ccw == tess_ccw && !memcmp(v->values, inline_uniforms, sizeof(inline_uniforms))) {
+         variant = v;
+         break;
       }
+      if (v->last_use < lru->last_use)
+         lru = v;
    }
-   lvp_shader_optimize(nir);
-   impl = nir_shader_get_entrypoint(nir);
+
    void *shader_state;
-   if (ssa_alloc - impl->ssa_alloc < ssa_alloc / 2 &&
-       !pipeline->inlines[stage].must_inline) {
-      /* not enough change; don't inline further */
-      pipeline->inlines[stage].can_inline = 0;
-      ralloc_free(nir);
-      pipeline->shader_cso[sh] = lvp_pipeline_compile(pipeline, nir_shader_clone(NULL, pipeline->pipeline_nir[stage]));
-      shader_state = pipeline->shader_cso[sh];
+   void *evicted = NULL;
+   if (variant) {
+      variant->last_use = ++pipeline->inlines[stage].use_count;
+      shader_state = variant->cso;
    } else {
-      shader_state = lvp_pipeline_compile(pipeline, nir);
+      bool full = pipeline->inlines[stage].num_variants == LVP_INLINE_VARIANTS;
+      bool specialize = true;
+      nir_shader *nir = NULL;
+      if (full && pipeline->inlines[stage].evictions >= LVP_INLINE_MAX_EVICTIONS &&
+          !pipeline->inlines[stage].must_inline) {
+         /* values change too often; don't inline further */
+         specialize = false;
+      } else {
+         nir_shader *base_nir = tess_ccw ? pipeline->tess_ccw : pipeline->pipeline_nir[stage];
+         nir = nir_shader_clone(pipeline->pipeline_nir[stage], base_nir);
+         nir_function_impl *impl = nir_shader_get_entrypoint(nir);
+         unsigned ssa_alloc = impl->ssa_alloc;
+         NIR_PASS_V(nir, lvp_inline_uniforms, pipeline, inline_uniforms, slot);
+         lvp_shader_optimize(nir);
+         impl = nir_shader_get_entrypoint(nir);
+         if (ssa_alloc - impl->ssa_alloc < ssa_alloc / 2 &&
+             !pipeline->inlines[stage].must_inline) {
+            /* not enough change; don't inline further */
+            specialize = false;
+            ralloc_free(nir);
+         }
+      }
+      if (!specialize) {
+         pipeline->inlines[stage].can_inline = 0;
+         pipeline->shader_cso[sh] = lvp_pipeline_compile(pipeline, nir_shader_clone(NULL, pipeline->pipeline_nir[stage]));
+         shader_state = pipeline->shader_cso[sh];
+      } else {
+         shader_state = lvp_pipeline_compile(pipeline, nir);
+         if (full) {
+            evicted = lru->cso;
+            variant = lru;
+            pipeline->inlines[stage].evictions++;
+         } else {
+            variant = &pipeline->inlines[stage].variants[pipeline->inlines[stage].num_variants++];
+         }
+         memcpy(variant->values, inline_uniforms, sizeof(inline_uniforms));
+         variant->tess_ccw = tess_ccw;
+         variant->last_use = ++pipeline->inlines[stage].use_count;
+         variant->cso = shader_state;
+      }
    }
    switch (sh) {
    case PIPE_SHADER_VERTEX:
@@ -361,6 +416,9 @@ update_inline_shader_state(struct rendering_state *state, enum pipe_shader_type
       break;
    default: break;
    }
+   /* only delete the replaced variant once it's no longer bound */
+   if (evicted)
+      lvp_pipeline_shader_delete(pipeline, sh, evicted);
 }
 
 static void emit_compute_state(struct rendering_state *state)
@@ -372,11 +430,9 @@ static void emit_compute_state(struct rendering_state *state)
       state->iv_dirty[PIPE_SHADER_COMPUTE] = false;
    }
 
-   bool pcbuf_dirty = state->pcbuf_dirty[PIPE_SHADER_COMPUTE];
    if (state->pcbuf_dirty[PIPE_SHADER_COMPUTE])
       update_pcbuf(state, PIPE_SHADER_COMPUTE);
 
-   bool constbuf_dirty = state->constbuf_dirty[PIPE_SHADER_COMPUTE];
    if (state->constbuf_dirty[PIPE_SHADER_COMPUTE]) {
       for (unsigned i = 0; i < state->num_const_bufs[PIPE_SHADER_COMPUTE]; i++)
          state->pctx->set_constant_buffer(state->pctx, PIPE_SHADER_COMPUTE,
@@ -385,7 +441,7 @@ static void emit_compute_state(struct rendering_state *state)
    }
 
    if (state->inlines_dirty[PIPE_SHADER_COMPUTE])
-      update_inline_shader_state(state, PIPE_SHADER_COMPUTE, pcbuf_dirty, constbuf_dirty);
+      update_inline_shader_state(state, PIPE_SHADER_COMPUTE);
 
    if (state->sb_dirty[PIPE_SHADER_COMPUTE]) {
       state->pctx->set_shader_buffers(state->pctx, PIPE_SHADER_COMPUTE,
@@ -418,7 +474,12 @@ static void emit_state(struct rendering_state *state)
             state->blend_state.rt[att].colormask = 0;
          }
       }
-      cso_set_blend(state->cso, &state->blend_state);
+      if (!state->cso_blend_valid ||
+          memcmp(&state->cso_blend_state, &state->blend_state, sizeof(state->blend_state))) {
+         cso_set_blend(state->cso, &state->blend_state);
+         state->cso_blend_state = state->blend_state;
+         state->cso_blend_valid = true;
+      }
       /* reset colormasks using saved bitmask */
       if (state->color_write_disables) {
          const uint32_t att_mask = BITFIELD_MASK(4);
@@ -447,13 +508,23 @@ static void emit_state(struct rendering_state *state)
          state->rs_state.offset_line = false;
          state->rs_state.offset_point = false;
       }
-      cso_set_rasterizer(state->cso, &state->rs_state);
+      if (!state->cso_rs_valid ||
+          memcmp(&state->cso_rs_state, &state->rs_state, sizeof(state->rs_state))) {
+         cso_set_rasterizer(state->cso, &state->rs_state);
+         state->cso_rs_state = state->rs_state;
+         state->cso_rs_valid = true;
+      }
       state->rs_dirty = false;
       state->rs_state.multisample = ms;
    }
 
    if (state->dsa_dirty) {
-      cso_set_depth_stencil_alpha(state->cso, &state->dsa_state);
+      if (!state->cso_dsa_valid ||
+          memcmp(&state->cso_dsa_state, &state->dsa_state, sizeof(state->dsa_state))) {
+         cso_set_depth_stencil_alpha(state->cso, &state->dsa_state);
+         state->cso_dsa_state = state->dsa_state;
+         state->cso_dsa_valid = true;
+      }
       state->dsa_dirty = false;
    }
 
@@ -487,10 +558,7 @@ static void emit_state(struct rendering_state *state)
       state->ve_dirty = false;
    }
 
-   bool constbuf_dirty[PIPE_SHADER_TYPES] = {false};
-   bool pcbuf_dirty[PIPE_SHADER_TYPES] = {false};
    for (sh = 0; sh < PIPE_SHADER_COMPUTE; sh++) {
-      constbuf_dirty[sh] = state->constbuf_dirty[sh];
       if (state->constbuf_dirty[sh]) {
          for (unsigned idx = 0; idx < state->num_const_bufs[sh]; idx++)
             state->pctx->set_constant_buffer(state->pctx, sh,
@@ -500,14 +568,13 @@ static void emit_state(struct rendering_state *state)
    }
 
    for (sh = 0; sh < PIPE_SHADER_COMPUTE; sh++) {
-      pcbuf_dirty[sh] = state->pcbuf_dirty[sh];
       if (state->pcbuf_dirty[sh])
          update_pcbuf(state, sh);
    }
 
    for (sh = 0; sh < PIPE_SHADER_COMPUTE; sh++) {
       if (state->inlines_dirty[sh])
-         update_inline_shader_state(state, sh, pcbuf_dirty[sh], constbuf_dirty[sh]);
+         update_inline_shader_state(state, sh);
    }
 
    for (sh = 0; sh < PIPE_SHADER_COMPUTE; sh++) {
@@ -2696,6 +2763,72 @@ static void handle_push_constants(struct vk_cmd_queue_entry *cmd,
    state->inlines_dirty[PIPE_SHADER_COMPUTE] |= (stage_flags & VK_SHADER_STAGE_COMPUTE_BIT) > 0;
 }
 
+/* commands which only record state for later work: a barrier following
+ * them without any work in between doesn't need to flush
+ */
+static bool
+cmd_is_state_only(enum vk_cmd_type type)
+{
+   switch (type) {
+   case VK_CMD_BIND_PIPELINE:
+   case VK_CMD_SET_VIEWPORT:
+   case VK_CMD_SET_VIEWPORT_WITH_COUNT:
+   case VK_CMD_SET_SCISSOR:
+   case VK_CMD_SET_SCISSOR_WITH_COUNT:
+   case VK_CMD_SET_LINE_WIDTH:
+   case VK_CMD_SET_DEPTH_BIAS:
+   case VK_CMD_SET_BLEND_CONSTANTS:
+   case VK_CMD_SET_DEPTH_BOUNDS:
+   case VK_CMD_SET_STENCIL_COMPARE_MASK:
+   case VK_CMD_SET_STENCIL_WRITE_MASK:
+   case VK_CMD_SET_STENCIL_REFERENCE:
+   case VK_CMD_BIND_DESCRIPTOR_SETS:
+   case VK_CMD_BIND_INDEX_BUFFER:
+   case VK_CMD_BIND_VERTEX_BUFFERS2:
+   case VK_CMD_PUSH_CONSTANTS:
+   case VK_CMD_PUSH_DESCRIPTOR_SET_KHR:
+   case VK_CMD_PUSH_DESCRIPTOR_SET_WITH_TEMPLATE_KHR:
+   case VK_CMD_BIND_TRANSFORM_FEEDBACK_BUFFERS_EXT:
+   case VK_CMD_SET_VERTEX_INPUT_EXT:
+   case VK_CMD_SET_CULL_MODE:
+   case VK_CMD_SET_FRONT_FACE:
+   case VK_CMD_SET_PRIMITIVE_TOPOLOGY:
+   case VK_CMD_SET_DEPTH_TEST_ENABLE:
+   case VK_CMD_SET_DEPTH_WRITE_ENABLE:
+   case VK_CMD_SET_DEPTH_COMPARE_OP:
+   case VK_CMD_SET_DEPTH_BOUNDS_TEST_ENABLE:
+   case VK_CMD_SET_STENCIL_TEST_ENABLE:
+   case VK_CMD_SET_STENCIL_OP:
+   case VK_CMD_SET_LINE_STIPPLE_EXT:
+   case VK_CMD_SET_DEPTH_BIAS_ENABLE:
+   case VK_CMD_SET_LOGIC_OP_EXT:
+   case VK_CMD_SET_PATCH_CONTROL_POINTS_EXT:
+   case VK_CMD_SET_PRIMITIVE_RESTART_ENABLE:
+   case VK_CMD_SET_RASTERIZER_DISCARD_ENABLE:
+   case VK_CMD_SET_COLOR_WRITE_ENABLE_EXT:
+   case VK_CMD_SET_DEVICE_MASK:
+   case VK_CMD_SET_POLYGON_MODE_EXT:
+   case VK_CMD_SET_TESSELLATION_DOMAIN_ORIGIN_EXT:
+   case VK_CMD_SET_DEPTH_CLAMP_ENABLE_EXT:
+   case VK_CMD_SET_DEPTH_CLIP_ENABLE_EXT:
+   case VK_CMD_SET_LOGIC_OP_ENABLE_EXT:
+   case VK_CMD_SET_SAMPLE_MASK_EXT:
+   case VK_CMD_SET_RASTERIZATION_SAMPLES_EXT:
+   case VK_CMD_SET_ALPHA_TO_COVERAGE_ENABLE_EXT:
+   case VK_CMD_SET_ALPHA_TO_ONE_ENABLE_EXT:
+   case VK_CMD_SET_DEPTH_CLIP_NEGATIVE_ONE_TO_ONE_EXT:
+   case VK_CMD_SET_LINE_RASTERIZATION_MODE_EXT:
+   case VK_CMD_SET_LINE_STIPPLE_ENABLE_EXT:
+   case VK_CMD_SET_PROVOKING_VERTEX_MODE_EXT:
+   case VK_CMD_SET_COLOR_BLEND_ENABLE_EXT:
+   case VK_CMD_SET_COLOR_WRITE_MASK_EXT:
+   case VK_CMD_SET_COLOR_BLEND_EQUATION_EXT:
+      return true;
+   default:
+      return false;
+   }
+}
+
 static void lvp_execute_cmd_buffer(struct lvp_cmd_buffer *cmd_buffer,
                                    struct rendering_state *state);
 
@@ -4304,6 +4437,8 @@ static void lvp_execute_cmd_buffer(struct lvp_cmd_buffer *cmd_buffer,
          unreachable("Unsupported command");
          break;
       }
+      if (cmd_is_state_only(cmd->type))
+         continue;
       first = false;
       did_flush = false;
    }
@@ -62,6 +62,12 @@ lvp_pipeline_destroy(struct lvp_device *device, struct lvp_pipeline *pipeline)
    if (pipeline->shader_cso[PIPE_SHADER_COMPUTE])
       device->queue.ctx->delete_compute_state(device->queue.ctx, pipeline->shader_cso[PIPE_SHADER_COMPUTE]);
 
+   for (unsigned i = 0; i < MESA_SHADER_STAGES; i++) {
+      for (unsigned j = 0; j < pipeline->inlines[i].num_variants; j++)
+         lvp_pipeline_shader_delete(pipeline, pipe_shader_type_from_mesa(i),
+                                    pipeline->inlines[i].variants[j].cso);
+   }
+
    for (unsigned i = 0; i < MESA_SHADER_STAGES; i++)
       ralloc_free(pipeline->pipeline_nir[i]);
 
@@ -637,6 +643,34 @@ lvp_pipeline_compile(struct lvp_pipeline *pipeline, nir_shader *nir)
    return lvp_pipeline_compile_stage(pipeline, nir);
 }
 
+void
+lvp_pipeline_shader_delete(struct lvp_pipeline *pipeline, enum pipe_shader_type sh, void *cso)
+{
+   struct pipe_context *ctx = pipeline->device->queue.ctx;
+   switch (sh) {
+   case PIPE_SHADER_VERTEX:
+      ctx->delete_vs_state(ctx, cso);
+      break;
+   case PIPE_SHADER_TESS_CTRL:
+      ctx->delete_tcs_state(ctx, cso);
+      break;
+   case PIPE_SHADER_TESS_EVAL:
+      ctx->delete_tes_state(ctx, cso);
+      break;
+   case PIPE_SHADER_GEOMETRY:
+      ctx->delete_gs_state(ctx, cso);
+      break;
+   case PIPE_SHADER_FRAGMENT:
+      ctx->delete_fs_state(ctx, cso);
+      break;
+   case PIPE_SHADER_COMPUTE:
+      ctx->delete_compute_state(ctx, cso);
+      break;
+   default:
+      unreachable("illegal shader");
+   }
+}
+
 #ifndef NDEBUG
 static bool
 layouts_equal(const struct lvp_descriptor_set_layout *a, const struct lvp_descriptor_set_layout *b)
@@ -403,6 +403,18 @@ struct lvp_access_info {
    uint64_t buffers_written;
 };
 
+/* specialized variants kept per stage for inlined uniform values */
+#define LVP_INLINE_VARIANTS 8
+/* once this many variants were evicted the values change too often to be worth inlining */
+#define LVP_INLINE_MAX_EVICTIONS 32
+
+struct lvp_inline_variant {
+   uint32_t values[MAX_INLINABLE_UNIFORMS];
+   bool tess_ccw;
+   uint32_t last_use;
+   void *cso;
+};
+
 struct lvp_pipeline {
    struct vk_object_base base;
    struct lvp_device *                          device;
@@ -423,6 +435,10 @@ struct lvp_pipeline {
       uint8_t count[PIPE_MAX_CONSTANT_BUFFERS];
       bool must_inline;
       uint32_t can_inline; //bitmask
+      struct lvp_inline_variant variants[LVP_INLINE_VARIANTS];
+      uint8_t num_variants;
+      uint32_t use_count;
+      unsigned evictions;
    } inlines[MESA_SHADER_STAGES];
    gl_shader_stage last_vertex;
    struct pipe_stream_output_info stream_output;
@@ -620,6 +636,8 @@ void
 lvp_inline_uniforms(nir_shader *shader, const struct lvp_pipeline *pipeline, const uint32_t *uniform_values, uint32_t ubo);
 void *
 lvp_pipeline_compile(struct lvp_pipeline *pipeline, nir_shader *base_nir);
+void
+lvp_pipeline_shader_delete(struct lvp_pipeline *pipeline, enum pipe_shader_type sh, void *cso);
 #ifdef __cplusplus
 }
 #endif
@@ -23,6 +23,7 @@
 #include "nine_queue.h"
 #include "os/os_thread.h"
 #include "util/macros.h"
+#include "util/u_atomic.h"
 #include "nine_helpers.h"
 
 #define NINE_CMD_BUF_INSTR (256)
@@ -56,6 +57,10 @@
  * Constrains:
  * Only a single consumer and a single producer are supported.
  *
+ * The full flag of a cmdbuf is only written with the matching mutex held,
+ * but it's read atomically first, so neither side takes a lock when the
+ * cmdbuf it needs is already available.
+ *
  */
 
 struct nine_cmdbuf {
@@ -85,14 +90,16 @@ nine_queue_wait_flush(struct nine_queue_pool* ctx)
     struct nine_cmdbuf *cmdbuf = &ctx->pool[ctx->tail];
 
     /* wait for cmdbuf full */
-    mtx_lock(&ctx->mutex_push);
-    while (!cmdbuf->full)
-    {
-        DBG("waiting for full cmdbuf\n");
-        cnd_wait(&ctx->event_push, &ctx->mutex_push);
+    if (!p_atomic_read(&cmdbuf->full)) {
+        mtx_lock(&ctx->mutex_push);
+        while (!cmdbuf->full)
+        {
+            DBG("waiting for full cmdbuf\n");
+            cnd_wait(&ctx->event_push, &ctx->mutex_push);
+        }
+        mtx_unlock(&ctx->mutex_push);
     }
     DBG("got cmdbuf=%p\n", cmdbuf);
-    mtx_unlock(&ctx->mutex_push);
 
     cmdbuf->offset = 0;
     ctx->cur_instr = 0;
@@ -113,7 +120,7 @@ nine_queue_get(struct nine_queue_pool* ctx)
         /* signal waiting producer */
         mtx_lock(&ctx->mutex_pop);
         DBG("freeing cmdbuf=%p\n", cmdbuf);
-        cmdbuf->full = 0;
+        p_atomic_set(&cmdbuf->full, 0);
         cnd_signal(&ctx->event_pop);
         mtx_unlock(&ctx->mutex_pop);
 
@@ -149,7 +156,7 @@ nine_queue_flush(struct nine_queue_pool* ctx)
 
     /* signal waiting worker */
     mtx_lock(&ctx->mutex_push);
-    cmdbuf->full = 1;
+    p_atomic_set(&cmdbuf->full, 1);
     cnd_signal(&ctx->event_push);
     mtx_unlock(&ctx->mutex_push);
 
@@ -158,14 +165,16 @@ nine_queue_flush(struct nine_queue_pool* ctx)
     cmdbuf = &ctx->pool[ctx->head];
 
     /* wait for queue empty */
-    mtx_lock(&ctx->mutex_pop);
-    while (cmdbuf->full)
-    {
-        DBG("waiting for empty cmdbuf\n");
-        cnd_wait(&ctx->event_pop, &ctx->mutex_pop);
+    if (p_atomic_read(&cmdbuf->full)) {
+        mtx_lock(&ctx->mutex_pop);
+        while (cmdbuf->full)
+        {
+            DBG("waiting for empty cmdbuf\n");
+            cnd_wait(&ctx->event_pop, &ctx->mutex_pop);
+        }
+        mtx_unlock(&ctx->mutex_pop);
     }
     DBG("got empty cmdbuf=%p\n", cmdbuf);
-    mtx_unlock(&ctx->mutex_pop);
     cmdbuf->offset = 0;
     cmdbuf->num_instr = 0;
 }
@@ -122,6 +122,13 @@ impl Event {
         self.status() < 0
     }
 
+    pub fn is_same_queue(&self, other: &Event) -> bool {
+        match (&self.queue, &other.queue) {
+            (Some(a), Some(b)) => Arc::ptr_eq(a, b),
+            _ => false,
+        }
+    }
+
     pub fn add_cb(&self, state: cl_int, cb: EventCB, data: *mut c_void) {
         let mut lock = self.state();
         let status = lock.status;
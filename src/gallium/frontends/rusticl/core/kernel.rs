@@ -329,6 +329,8 @@ pub struct Kernel {
     pub work_group_size: [usize; 3],
     pub attributes_string: String,
     internal_args: Vec<InternalKernelArg>,
+    // size of the kernel input buffer, so launches can allocate it in one go
+    input_size: usize,
     dev_state: Arc<KernelDevState>,
 }
 
@@ -852,6 +854,20 @@ impl Kernel {
         // can't use vec!...
         let values = args.iter().map(|_| RefCell::new(None)).collect();
 
+        // image and sampler offsets index into the format arrays, not the input buffer
+        let input_size = args
+            .iter()
+            .filter(|arg| {
+                arg.kind != KernelArgType::Image
+                    && arg.kind != KernelArgType::RWImage
+                    && arg.kind != KernelArgType::Texture
+                    && arg.kind != KernelArgType::Sampler
+            })
+            .map(|arg| arg.offset + arg.size)
+            .chain(internal_args.iter().map(|arg| arg.offset + arg.size))
+            .max()
+            .unwrap_or(0);
+
         // increase ref
         prog.kernel_count.fetch_add(1, Ordering::Relaxed);
 
@@ -864,6 +880,7 @@ impl Kernel {
             attributes_string: attributes_string,
             values: values,
             internal_args: internal_args,
+            input_size: input_size,
             dev_state: KernelDevState::new(nirs),
         })
     }
@@ -882,8 +899,8 @@ impl Kernel {
         let mut block = create_kernel_arr::<u32>(block, 1);
         let mut grid = create_kernel_arr::<u32>(grid, 1);
         let offsets = create_kernel_arr::<u64>(offsets, 0);
-        let mut input: Vec<u8> = Vec::new();
-        let mut resource_info = Vec::new();
+        let mut input: Vec<u8> = Vec::with_capacity(self.input_size);
+        let mut resource_info = Vec::with_capacity(self.args.len() + self.internal_args.len());
         // Set it once so we get the alignment padding right
         let static_local_size: u64 = dev_state.nir.shared_size() as u64;
         let mut variable_local_size: u64 = static_local_size;
@@ -1033,7 +1050,7 @@ impl Kernel {
             let dev_state = k.dev_state.get(&q.device);
             let mut input = input.clone();
             let mut resources = Vec::with_capacity(resource_info.len());
-            let mut globals: Vec<*mut u32> = Vec::new();
+            let mut globals: Vec<*mut u32> = Vec::with_capacity(resource_info.len());
             let printf_format = dev_state.nir.printf_format();
 
             let mut sviews: Vec<_> = sviews
@@ -1045,9 +1062,9 @@ impl Kernel {
                 .map(|s| ctx.create_sampler_state(s))
                 .collect();
 
-            for (res, offset) in resource_info.clone() {
-                resources.push(res);
-                globals.push(unsafe { input.as_mut_ptr().add(offset) }.cast());
+            for (res, offset) in &resource_info {
+                resources.push(res.clone());
+                globals.push(unsafe { input.as_mut_ptr().add(*offset) }.cast());
             }
 
             if let Some(printf_buf) = &printf_buf {
@@ -1205,6 +1222,7 @@ impl Clone for Kernel {
             work_group_size: self.work_group_size,
             attributes_string: self.attributes_string.clone(),
             internal_args: self.internal_args.clone(),
+            input_size: self.input_size,
             dev_state: self.dev_state.clone(),
         }
     }
@@ -56,8 +56,20 @@ impl Queue {
                         let new_events = r.unwrap();
                         for e in &new_events {
                             // all events should be processed, but we might have to wait on user
-                            // events to happen
-                            let err = e.deps.iter().map(|e| e.wait()).find(|s| *s < 0);
+                            // events to happen. Dependencies from this queue were already
+                            // submitted on the same context and execute in order, so there is no
+                            // need to stall on their fences.
+                            let err = e
+                                .deps
+                                .iter()
+                                .map(|dep| {
+                                    if dep.is_same_queue(e) {
+                                        dep.status()
+                                    } else {
+                                        dep.wait()
+                                    }
+                                })
+                                .find(|s| *s < 0);
                             if let Some(err) = err {
                                 // if a dependency failed, fail this event as well
                                 e.set_user_status(err);
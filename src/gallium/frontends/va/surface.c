@@ -931,6 +931,7 @@ vlVaCreateSurfaces2(VADriverContextP ctx, unsigned int format,
    VAStatus vaStatus;
    vlVaSurface *surf;
    bool protected;
+   bool export_hint;
    const uint64_t *modifiers;
    unsigned int modifiers_count;
 
@@ -954,6 +955,7 @@ vlVaCreateSurfaces2(VADriverContextP ctx, unsigned int format,
    memory_attribute = NULL;
    memory_type = VA_SURFACE_ATTRIB_MEM_TYPE_VA;
    expected_fourcc = 0;
+   export_hint = false;
    modifiers = NULL;
    modifiers_count = 0;
 
@@ -1017,6 +1019,10 @@ vlVaCreateSurfaces2(VADriverContextP ctx, unsigned int format,
       case VASurfaceAttribUsageHint:
          if (attrib_list[i].value.type != VAGenericValueTypeInteger)
             return VA_STATUS_ERROR_INVALID_PARAMETER;
+#ifdef VA_SURFACE_ATTRIB_USAGE_HINT_EXPORT
+         if (attrib_list[i].value.value.i & VA_SURFACE_ATTRIB_USAGE_HINT_EXPORT)
+            export_hint = true;
+#endif
          break;
       default:
          return VA_STATUS_ERROR_ATTR_NOT_SUPPORTED;
@@ -1081,6 +1087,16 @@ vlVaCreateSurfaces2(VADriverContextP ctx, unsigned int format,
                                   PIPE_VIDEO_ENTRYPOINT_BITSTREAM,
                                   PIPE_VIDEO_CAP_PREFERS_INTERLACED);
 
+   /* Surfaces that will be exported need a progressive layout, allocate
+    * them that way up front so vaExportSurfaceHandle doesn't have to
+    * reallocate and weave the frame into a new buffer.
+    */
+   if (export_hint && templat.interlaced &&
+       pscreen->get_video_param(pscreen, PIPE_VIDEO_PROFILE_UNKNOWN,
+                                PIPE_VIDEO_ENTRYPOINT_BITSTREAM,
+                                PIPE_VIDEO_CAP_SUPPORTS_PROGRESSIVE))
+      templat.interlaced = false;
+
    if (expected_fourcc) {
       enum pipe_format expected_format = VaFourccToPipeFormat(expected_fourcc);
 
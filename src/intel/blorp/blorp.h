@@ -108,12 +108,48 @@ enum blorp_batch_flags {
 
    /** Use the hardware blitter to perform any operations in this batch */
    BLORP_BATCH_USE_BLITTER = (1 << 4),
+
+   /**
+    * This flag indicates that blorp may skip re-emitting the 3D pipeline
+    * state of an operation when it matches the one of the previous operation
+    * in this batch.  The driver guarantees that it doesn't touch the 3D
+    * pipeline state between operations and that dynamic state allocated for
+    * one operation is still valid for the next.
+    */
+   BLORP_BATCH_REUSE_PIPELINE_STATE = (1 << 5),
+};
+
+/**
+ * Everything the 3D pipeline state emitted by blorp depends on, apart from
+ * per-operation surfaces, vertices and depth/stencil buffers.
+ */
+struct blorp_pipeline_key {
+   const void *vs_prog_data;
+   const void *sf_prog_data;
+   const void *wm_prog_data;
+   uint32_t vs_prog_kernel;
+   uint32_t wm_prog_kernel;
+   uint32_t depth_format;
+   unsigned num_samples;
+   unsigned num_draw_buffers;
+   uint8_t color_write_disable;
+   uint8_t stencil_mask;
+   uint8_t stencil_ref;
+   uint8_t fast_clear_op;
+   uint8_t hiz_op;
+   bool src_enabled;
+   bool depth_enabled;
+   bool stencil_enabled;
 };
 
 struct blorp_batch {
    struct blorp_context *blorp;
    void *driver_batch;
    enum blorp_batch_flags flags;
+
+   /** Pipeline state emitted by the last operation, if pipeline_valid */
+   struct blorp_pipeline_key pipeline;
+   bool pipeline_valid;
 };
 
 void blorp_batch_init(struct blorp_context *blorp, struct blorp_batch *batch,
@@ -2025,6 +2025,57 @@ blorp_update_clear_color(UNUSED struct blorp_batch *batch,
    }
 }
 
+static void
+blorp_get_pipeline_key(const struct blorp_params *params,
+                       struct blorp_pipeline_key *key)
+{
+   /* The key is compared with memcmp(), clear the padding */
+   memset(key, 0, sizeof(*key));
+
+   key->vs_prog_data = params->vs_prog_data;
+   key->sf_prog_data = params->sf_prog_data;
+   key->wm_prog_data = params->wm_prog_data;
+   key->vs_prog_kernel = params->vs_prog_kernel;
+   key->wm_prog_kernel = params->wm_prog_kernel;
+   key->depth_format = params->depth_format;
+   key->num_samples = params->num_samples;
+   key->num_draw_buffers = params->num_draw_buffers;
+   key->color_write_disable = params->color_write_disable;
+   key->stencil_mask = params->stencil_mask;
+   key->stencil_ref = params->stencil_ref;
+   key->fast_clear_op = params->fast_clear_op;
+   key->hiz_op = params->hiz_op;
+   key->src_enabled = params->src.enabled;
+   key->depth_enabled = params->depth.enabled;
+   key->stencil_enabled = params->stencil.enabled;
+}
+
+/**
+ * Returns whether the vertex elements and pipeline state emitted by the
+ * previous operation of the batch can be used as they are for this one.
+ * Mip generation, per-level resolves and multi-region copies typically
+ * issue long runs of operations which only differ in their surfaces and
+ * rectangles.
+ */
+static bool
+blorp_pipeline_is_current(struct blorp_batch *batch,
+                          const struct blorp_params *params)
+{
+   if (!(batch->flags & BLORP_BATCH_REUSE_PIPELINE_STATE))
+      return false;
+
+   struct blorp_pipeline_key key;
+   blorp_get_pipeline_key(params, &key);
+
+   if (batch->pipeline_valid &&
+       memcmp(&batch->pipeline, &key, sizeof(key)) == 0)
+      return true;
+
+   batch->pipeline = key;
+   batch->pipeline_valid = true;
+   return false;
+}
+
 static void
 blorp_exec_3d(struct blorp_batch *batch, const struct blorp_params *params)
 {
@@ -2035,6 +2086,8 @@ blorp_exec_3d(struct blorp_batch *batch, const struct blorp_params *params)
 
 #if GFX_VER >= 8
    if (params->hiz_op != ISL_AUX_OP_NONE) {
+      /* WM_HZ_OP overrides some of the pipeline state */
+      batch->pipeline_valid = false;
       blorp_emit_gfx8_hiz_op(batch, params);
       return;
    }
@@ -2043,9 +2096,11 @@ blorp_exec_3d(struct blorp_batch *batch, const struct blorp_params *params)
    blorp_measure_start(batch, params);
 
    blorp_emit_vertex_buffers(batch, params);
-   blorp_emit_vertex_elements(batch, params);
 
-   blorp_emit_pipeline(batch, params);
+   if (!blorp_pipeline_is_current(batch, params)) {
+      blorp_emit_vertex_elements(batch, params);
+      blorp_emit_pipeline(batch, params);
+   }
 
    blorp_emit_btp(batch, blorp_setup_binding_table(batch, params));
 
@@ -38,7 +38,9 @@
 #include <inttypes.h>
 
 #include "dev/intel_device_info.h"
+#include "util/hash_table.h"
 #include "util/u_debug.h"
+#include "util/u_math.h"
 #include "util/macros.h"
 
 
@@ -52,6 +54,37 @@ static const struct debug_control debug_control[] = {
 };
 static struct intel_measure_config config;
 
+/* Summary histograms have power of two buckets in microseconds, the first
+ * one counting events shorter than 1us and the last one everything longer
+ * than 2^(SUMMARY_BUCKETS - 2)us.
+ */
+#define SUMMARY_BUCKETS 16
+
+struct intel_measure_summary_key {
+   enum intel_measure_snapshot_type type;
+   uintptr_t framebuffer, vs, tcs, tes, gs, fs, cs, ms, ts;
+};
+
+struct intel_measure_summary_entry {
+   struct intel_measure_summary_key key;
+   const char *event_name;
+   unsigned event_count;
+   uint64_t total_ns, min_ns, max_ns;
+   unsigned buckets[SUMMARY_BUCKETS];
+};
+
+static uint32_t
+summary_key_hash(const void *key)
+{
+   return _mesa_hash_data(key, sizeof(struct intel_measure_summary_key));
+}
+
+static bool
+summary_key_equal(const void *a, const void *b)
+{
+   return memcmp(a, b, sizeof(struct intel_measure_summary_key)) == 0;
+}
+
 void
 intel_measure_init(struct intel_measure_device *device)
 {
@@ -97,6 +130,7 @@ intel_measure_init(struct intel_measure_device *device)
       const char *interval_s = strstr(env_copy, "interval=");
       const char *batch_size_s = strstr(env_copy, "batch_size=");
       const char *buffer_size_s = strstr(env_copy, "buffer_size=");
+      const char *summary_s = strstr(env_copy, "summary=");
       while (true) {
          char *sep = strrchr(env_copy, ',');
          if (sep == NULL)
@@ -206,10 +240,30 @@ intel_measure_init(struct intel_measure_device *device)
          config.buffer_size = buffer_size;
       }
 
-      fputs("draw_start,draw_end,frame,batch,"
-            "event_index,event_count,type,count,vs,tcs,tes,"
-            "gs,fs,cs,ms,ts,framebuffer,idle_us,time_us\n",
-            config.file);
+      if (summary_s) {
+         summary_s += 8;
+         const int summary_frames = atoi(summary_s);
+         if (summary_frames < 1) {
+            fprintf(stderr, "INTEL_MEASURE summary frame count must be "
+                    "positive: %d\n", summary_frames);
+            abort();
+         }
+         config.summary_frames = summary_frames;
+      }
+
+      if (config.summary_frames) {
+         fputs("frame_start,frame_end,type,vs,tcs,tes,gs,fs,cs,ms,ts,"
+               "framebuffer,event_count,total_us,mean_us,min_us,max_us",
+               config.file);
+         for (unsigned i = 0; i < SUMMARY_BUCKETS - 1; i++)
+            fprintf(config.file, ",lt%uus", 1u << i);
+         fprintf(config.file, ",ge%uus\n", 1u << (SUMMARY_BUCKETS - 2));
+      } else {
+         fputs("draw_start,draw_end,frame,batch,"
+               "event_index,event_count,type,count,vs,tcs,tes,"
+               "gs,fs,cs,ms,ts,framebuffer,idle_us,time_us\n",
+               config.file);
+      }
    }
 
    device->config = NULL;
@@ -217,9 +271,16 @@ intel_measure_init(struct intel_measure_device *device)
    device->release_batch = NULL;
    pthread_mutex_init(&device->mutex, NULL);
    list_inithead(&device->queued_snapshots);
+   device->summary = NULL;
+   device->summary_frame = 0;
 
    if (env)
       device->config = &config;
+
+   if (config.summary_frames) {
+      device->summary = _mesa_hash_table_create(NULL, summary_key_hash,
+                                                summary_key_equal);
+   }
 }
 
 const char *
@@ -563,6 +624,97 @@ buffered_event_count(struct intel_measure_device *device)
    return 0;
 }
 
+static void
+summary_entry_free(struct hash_entry *entry)
+{
+   free(entry->data);
+}
+
+/**
+ * Print one line per distinct key aggregated since device->summary_frame and
+ * start a new summary.
+ */
+static void
+print_summary(struct intel_measure_device *device, unsigned frame)
+{
+   hash_table_foreach(device->summary, entry) {
+      const struct intel_measure_summary_entry *e = entry->data;
+      const struct intel_measure_summary_key *key = &e->key;
+
+      fprintf(config.file, "%u,%u,%s,"
+              "0x%"PRIxPTR",0x%"PRIxPTR",0x%"PRIxPTR",0x%"PRIxPTR","
+              "0x%"PRIxPTR",0x%"PRIxPTR",0x%"PRIxPTR",0x%"PRIxPTR","
+              "0x%"PRIxPTR",%u,%.3lf,%.3lf,%.3lf,%.3lf",
+              device->summary_frame, frame, e->event_name,
+              key->vs, key->tcs, key->tes, key->gs, key->fs, key->cs,
+              key->ms, key->ts, key->framebuffer, e->event_count,
+              (double)e->total_ns / 1000.0,
+              (double)e->total_ns / e->event_count / 1000.0,
+              (double)e->min_ns / 1000.0,
+              (double)e->max_ns / 1000.0);
+      for (unsigned i = 0; i < SUMMARY_BUCKETS; i++)
+         fprintf(config.file, ",%u", e->buckets[i]);
+      fputc('\n', config.file);
+   }
+
+   _mesa_hash_table_clear(device->summary, summary_entry_free);
+   device->summary_frame = frame;
+}
+
+/**
+ * Add the duration of one line of output to the summary for its shaders and
+ * framebuffer.
+ */
+static void
+add_to_summary(struct intel_measure_device *device,
+               const struct intel_measure_buffered_result *result,
+               uint64_t duration_ns)
+{
+   if (result->frame >= device->summary_frame + config.summary_frames)
+      print_summary(device, result->frame);
+
+   const struct intel_measure_snapshot *begin = &result->snapshot;
+   struct intel_measure_summary_key key;
+
+   /* The key is hashed and compared as raw memory, clear the padding */
+   memset(&key, 0, sizeof(key));
+   key.type = begin->type;
+   key.framebuffer = begin->framebuffer;
+   key.vs = begin->vs;
+   key.tcs = begin->tcs;
+   key.tes = begin->tes;
+   key.gs = begin->gs;
+   key.fs = begin->fs;
+   key.cs = begin->cs;
+   key.ms = begin->ms;
+   key.ts = begin->ts;
+
+   struct intel_measure_summary_entry *e;
+   struct hash_entry *entry = _mesa_hash_table_search(device->summary, &key);
+   if (entry) {
+      e = entry->data;
+   } else {
+      e = calloc(1, sizeof(*e));
+      if (!e)
+         return;
+      memcpy(&e->key, &key, sizeof(key));
+      e->event_name = begin->event_name;
+      e->min_ns = UINT64_MAX;
+      _mesa_hash_table_insert(device->summary, &e->key, e);
+   }
+
+   const uint64_t duration_us = duration_ns / 1000;
+   const unsigned bucket =
+      duration_us ? MIN2(util_logbase2_64(duration_us) + 1,
+                         SUMMARY_BUCKETS - 1) : 0;
+
+   e->event_count++;
+   e->total_ns += duration_ns;
+   e->min_ns = MIN2(e->min_ns, duration_ns);
+   e->max_ns = MAX2(e->max_ns, duration_ns);
+   e->buckets[bucket]++;
+}
+
 /**
  * Take result_count events from the ringbuffer and output them as a single
  * line.
@@ -598,10 +750,16 @@ print_combined_results(struct intel_measure_device *measure_device,
       event_count += current_result->snapshot.event_count;
    }
 
-   uint64_t duration_idle_ns =
-      intel_device_info_timebase_scale(info, start_result->idle_duration);
    uint64_t duration_time_ns =
       intel_device_info_timebase_scale(info, duration_ts);
+
+   if (measure_device->summary) {
+      add_to_summary(measure_device, start_result, duration_time_ns);
+      return;
+   }
+
+   uint64_t duration_idle_ns =
+      intel_device_info_timebase_scale(info, start_result->idle_duration);
    const struct intel_measure_snapshot *begin = &start_result->snapshot;
    fprintf(config.file, "%"PRIu64",%"PRIu64",%u,%u,%u,%u,%s,%u,"
            "0x%"PRIxPTR",0x%"PRIxPTR",0x%"PRIxPTR",0x%"PRIxPTR",0x%"PRIxPTR","
@@ -672,3 +830,19 @@ intel_measure_gather(struct intel_measure_device *measure_device,
    pthread_mutex_unlock(&measure_device->mutex);
 }
 
+/**
+ * Print what is left of the summary and release it.
+ */
+void
+intel_measure_finish(struct intel_measure_device *device)
+{
+   if (!device->summary)
+      return;
+
+   pthread_mutex_lock(&device->mutex);
+   print_summary(device, device->frame);
+   pthread_mutex_unlock(&device->mutex);
+
+   _mesa_hash_table_destroy(device->summary, NULL);
+   device->summary = NULL;
+}
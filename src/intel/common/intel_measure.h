@@ -98,6 +98,13 @@ struct intel_measure_config {
     */
    int                        control_fh;
 
+   /* Number of frames to aggregate into each summary.  Set with
+    * INTEL_MEASURE=summary={num}.  When set, per-event output is replaced
+    * by a histogram of the durations of each distinct set of shaders and
+    * framebuffer.
+    */
+   unsigned                   summary_frames;
+
    /* true when snapshots are currently being collected */
    bool                       enabled;
 };
@@ -142,6 +149,12 @@ struct intel_measure_device {
     * written out
     */
    struct intel_measure_ringbuffer *ringbuffer;
+
+   /* With INTEL_MEASURE=summary, the aggregated results since summary_frame,
+    * keyed by intel_measure_summary_key.
+    */
+   struct hash_table *summary;
+   unsigned summary_frame;
 };
 
 struct intel_measure_batch {
@@ -166,5 +179,6 @@ bool intel_measure_ready(struct intel_measure_batch *batch);
 struct intel_device_info;
 void intel_measure_gather(struct intel_measure_device *device,
                           const struct intel_device_info *info);
+void intel_measure_finish(struct intel_measure_device *device);
 
 #endif /* INTEL_MEASURE_H */
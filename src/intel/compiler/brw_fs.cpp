@@ -7301,6 +7301,7 @@ brw_compile_fs(const struct brw_compiler *compiler,
    cfg_t *simd8_cfg = NULL, *simd16_cfg = NULL, *simd32_cfg = NULL;
    float throughput = 0;
    bool has_spilled = false;
+   bool simd16_inefficient = false;
 
    v8 = new fs_visitor(compiler, params->log_data, mem_ctx, &key->base,
                        &prog_data->base, nir, 8,
@@ -7358,6 +7359,10 @@ brw_compile_fs(const struct brw_compiler *compiler,
          prog_data->dispatch_grf_start_reg_16 = v16->payload().num_regs;
          prog_data->reg_blocks_16 = brw_register_blocks(v16->grf_used);
          const performance &perf = v16->performance_analysis.require();
+         /* If doubling the width didn't help, doubling it again won't
+          * either, so there's no point compiling SIMD32.
+          */
+         simd16_inefficient = simd8_cfg && perf.throughput <= throughput;
          throughput = MAX2(throughput, perf.throughput);
          has_spilled = v16->spilled_any_registers;
          allow_spilling = false;
@@ -7366,10 +7371,17 @@ brw_compile_fs(const struct brw_compiler *compiler,
 
    const bool simd16_failed = v16 && !simd16_cfg;
 
+   if (simd16_inefficient && !INTEL_DEBUG(DEBUG_DO32)) {
+      brw_shader_perf_log(compiler, params->log_data,
+                          "SIMD32 skipped because SIMD16 isn't faster "
+                          "than SIMD8\n");
+   }
+
    /* Currently, the compiler only supports SIMD32 on SNB+ */
    if (!has_spilled &&
        v8->max_dispatch_width >= 32 && !params->use_rep_send &&
        devinfo->ver >= 6 && !simd16_failed &&
+       (!simd16_inefficient || INTEL_DEBUG(DEBUG_DO32)) &&
        !INTEL_DEBUG(DEBUG_NO32)) {
       /* Try a SIMD32 compile */
       v32 = new fs_visitor(compiler, params->log_data, mem_ctx, &key->base,
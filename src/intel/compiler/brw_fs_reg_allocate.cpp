@@ -341,8 +341,10 @@ public:
    bool assign_regs(bool allow_spilling, bool spill_all);
 
 private:
+   void setup_fixed_interference(unsigned node, int node_start_ip);
    void setup_live_interference(unsigned node,
                                 int node_start_ip, int node_end_ip);
+   void setup_vgrf_live_interference();
    void setup_inst_interference(const fs_inst *inst);
 
    void build_interference_graph(bool allow_spilling);
@@ -482,8 +484,7 @@ namespace {
 }
 
 void
-fs_reg_alloc::setup_live_interference(unsigned node,
-                                      int node_start_ip, int node_end_ip)
+fs_reg_alloc::setup_fixed_interference(unsigned node, int node_start_ip)
 {
    /* Mark any virtual grf that is live between the start of the program and
     * the last use of a payload node interfering with that payload node.
@@ -511,6 +512,13 @@ fs_reg_alloc::setup_live_interference(unsigned node,
    /* Everything interferes with the scratch header */
    if (scratch_header_node >= 0)
       ra_add_node_interference(g, node, scratch_header_node);
+}
+
+void
+fs_reg_alloc::setup_live_interference(unsigned node,
+                                      int node_start_ip, int node_end_ip)
+{
+   setup_fixed_interference(node, node_start_ip);
 
    /* Add interference with every vgrf whose live range intersects this
     * node's.  We only need to look at nodes below this one as the reflexivity
@@ -525,6 +533,75 @@ fs_reg_alloc::setup_live_interference(unsigned node,
    }
 }
 
+struct live_range {
+   int start, end;
+   unsigned node;
+};
+
+static int
+compare_live_range_start(const void *_a, const void *_b)
+{
+   const struct live_range *a = (const struct live_range *)_a;
+   const struct live_range *b = (const struct live_range *)_b;
+
+   return a->start < b->start ? -1 : a->start > b->start;
+}
+
+/**
+ * Add interference between every pair of vgrfs whose live ranges intersect.
+ *
+ * Rather than testing every pair, walk the ranges in order of their start
+ * and keep the ones which are still live.  Each new range then only needs
+ * to be checked against that set, so the cost is proportional to the number
+ * of overlaps rather than to the square of the number of vgrfs.
+ */
+void
+fs_reg_alloc::setup_vgrf_live_interference()
+{
+   const unsigned count = fs->alloc.count;
+   struct live_range *ranges = ralloc_array(NULL, struct live_range, count);
+   struct live_range *active = ralloc_array(ranges, struct live_range, count);
+   unsigned num_ranges = 0, num_active = 0;
+
+   for (unsigned i = 0; i < count; i++) {
+      /* A vgrf which is never used has an empty range and can't intersect
+       * anything.
+       */
+      if (live.vgrf_end[i] < live.vgrf_start[i])
+         continue;
+
+      ranges[num_ranges++] = (struct live_range) {
+         live.vgrf_start[i], live.vgrf_end[i], first_vgrf_node + i,
+      };
+   }
+
+   qsort(ranges, num_ranges, sizeof(*ranges), compare_live_range_start);
+
+   for (unsigned i = 0; i < num_ranges; i++) {
+      const struct live_range *r = &ranges[i];
+      unsigned n = 0;
+
+      /* Everything in the active set starts at or before r, so it
+       * intersects r as long as it ends after r starts and r ends after it
+       * starts.  The same test as vgrfs_interfere().
+       */
+      for (unsigned j = 0; j < num_active; j++) {
+         if (active[j].end <= r->start)
+            continue;
+
+         if (active[j].start < r->end)
+            ra_add_node_interference(g, r->node, active[j].node);
+
+         active[n++] = active[j];
+      }
+
+      active[n++] = *r;
+      num_active = n;
+   }
+
+   ralloc_free(ranges);
+}
+
 void
 fs_reg_alloc::setup_inst_interference(const fs_inst *inst)
 {
@@ -731,11 +808,10 @@ fs_reg_alloc::build_interference_graph(bool allow_spilling)
    }
 
    /* Add interference based on the live range of the register */
-   for (unsigned i = 0; i < fs->alloc.count; i++) {
-      setup_live_interference(first_vgrf_node + i,
-                              live.vgrf_start[i],
-                              live.vgrf_end[i]);
-   }
+   for (unsigned i = 0; i < fs->alloc.count; i++)
+      setup_fixed_interference(first_vgrf_node + i, live.vgrf_start[i]);
+
+   setup_vgrf_live_interference();
 
    /* Add interference based on the instructions in which a register is used.
     */
@@ -57,6 +57,9 @@ static const uint32_t xtile_span = 64;
 static const uint32_t ytile_width = 128;
 static const uint32_t ytile_height = 32;
 static const uint32_t ytile_span = 16;
+static const uint32_t tile4_width = 128;
+static const uint32_t tile4_height = 32;
+static const uint32_t tile4_span = 16;
 
 static inline uint32_t
 ror(uint32_t n, uint32_t d)
@@ -405,6 +408,62 @@ linear_to_ytiled(uint32_t x0, uint32_t x1, uint32_t x2, uint32_t x3,
    }
 }
 
+/**
+ * Tile4 is made of 16B x 4 row blocks, arranged 4 wide and 2 high into 512B
+ * sub-tiles, which are in turn arranged 2 wide and 4 high into the 4KB
+ * tile.  The byte offset of (x, y) within the tile is therefore:
+ *
+ *    x[3:0] y[1:0] x[5:4] y[2] x[6] y[4:3]
+ *
+ * The X and Y bits don't mix, so the offset is the sum of a part only
+ * depending on x and a part only depending on y.
+ */
+static inline uint32_t
+tile4_x_offset(uint32_t x)
+{
+   return (x & 0xf) | ((x & 0x30) << 2) | ((x & 0x40) << 3);
+}
+
+static inline uint32_t
+tile4_y_offset(uint32_t y)
+{
+   return ((y & 0x3) << 4) | ((y & 0x4) << 6) | ((y & 0x18) << 7);
+}
+
+/**
+ * Copy texture data from linear to Tile4 layout.
+ *
+ * \copydoc tile_copy_fn
+ */
+static inline void
+linear_to_tile4(uint32_t x0, uint32_t x1, uint32_t x2, uint32_t x3,
+                uint32_t y0, uint32_t y1,
+                char *dst, const char *src,
+                int32_t src_pitch,
+                uint32_t swizzle_bit,
+                isl_mem_copy_fn mem_copy,
+                isl_mem_copy_fn mem_copy_align16)
+{
+   /* Platforms with Tile4 never swizzle */
+   assert(swizzle_bit == 0);
+
+   src += (ptrdiff_t)y0 * src_pitch;
+
+   for (uint32_t y = y0; y < y1; y++) {
+      char *row = dst + tile4_y_offset(y);
+
+      mem_copy(row + tile4_x_offset(x0), src + x0, x1 - x0);
+
+      /* Each span is a row of one 16B block and is contiguous */
+      for (uint32_t x = x1; x < x2; x += tile4_span)
+         mem_copy_align16(row + tile4_x_offset(x), src + x, tile4_span);
+
+      mem_copy_align16(row + tile4_x_offset(x2), src + x2, x3 - x2);
+
+      src += src_pitch;
+   }
+}
+
 /**
  * Copy texture data from X tile layout to linear.
  *
@@ -569,6 +628,39 @@ ytiled_to_linear(uint32_t x0, uint32_t x1, uint32_t x2, uint32_t x3,
    }
 }
 
+/**
+ * Copy texture data from Tile4 layout to linear.
+ *
+ * \copydoc tile_copy_fn
+ */
+static inline void
+tile4_to_linear(uint32_t x0, uint32_t x1, uint32_t x2, uint32_t x3,
+                uint32_t y0, uint32_t y1,
+                char *dst, const char *src,
+                int32_t dst_pitch,
+                uint32_t swizzle_bit,
+                isl_mem_copy_fn mem_copy,
+                isl_mem_copy_fn mem_copy_align16)
+{
+   /* Platforms with Tile4 never swizzle */
+   assert(swizzle_bit == 0);
+
+   dst += (ptrdiff_t)y0 * dst_pitch;
+
+   for (uint32_t y = y0; y < y1; y++) {
+      const char *row = src + tile4_y_offset(y);
+
+      mem_copy(dst + x0, row + tile4_x_offset(x0), x1 - x0);
+
+      for (uint32_t x = x1; x < x2; x += tile4_span)
+         mem_copy_align16(dst + x, row + tile4_x_offset(x), tile4_span);
+
+      mem_copy_align16(dst + x2, row + tile4_x_offset(x2), x3 - x2);
+
+      dst += dst_pitch;
+   }
+}
+
 #if defined(INLINE_SSE41)
 static ALWAYS_INLINE void *
 _memcpy_streaming_load(void *dest, const void *src, size_t count)
@@ -704,6 +796,48 @@ linear_to_ytiled_faster(uint32_t x0, uint32_t x1, uint32_t x2, uint32_t x3,
                     dst, src, src_pitch, swizzle_bit, mem_copy, mem_copy);
 }
 
+/**
+ * Copy texture data from linear to Tile4 layout, faster.
+ *
+ * Same as \ref linear_to_tile4 but faster, because it passes constant
+ * parameters for common cases, allowing the compiler to inline code
+ * optimized for those cases.
+ *
+ * \copydoc tile_copy_fn
+ */
+static FLATTEN void
+linear_to_tile4_faster(uint32_t x0, uint32_t x1, uint32_t x2, uint32_t x3,
+                       uint32_t y0, uint32_t y1,
+                       char *dst, const char *src,
+                       int32_t src_pitch,
+                       uint32_t swizzle_bit,
+                       isl_memcpy_type copy_type)
+{
+   isl_mem_copy_fn mem_copy = choose_copy_function(copy_type);
+
+   if (x0 == 0 && x3 == tile4_width && y0 == 0 && y1 == tile4_height) {
+      if (mem_copy == memcpy)
+         return linear_to_tile4(0, 0, tile4_width, tile4_width, 0, tile4_height,
+                                dst, src, src_pitch, swizzle_bit, memcpy, memcpy);
+      else if (mem_copy == rgba8_copy)
+         return linear_to_tile4(0, 0, tile4_width, tile4_width, 0, tile4_height,
+                                dst, src, src_pitch, swizzle_bit,
+                                rgba8_copy, rgba8_copy_aligned_dst);
+      else
+         unreachable("not reached");
+   } else {
+      if (mem_copy == memcpy)
+         return linear_to_tile4(x0, x1, x2, x3, y0, y1,
+                                dst, src, src_pitch, swizzle_bit, memcpy, memcpy);
+      else if (mem_copy == rgba8_copy)
+         return linear_to_tile4(x0, x1, x2, x3, y0, y1,
+                                dst, src, src_pitch, swizzle_bit,
+                                rgba8_copy, rgba8_copy_aligned_dst);
+      else
+         unreachable("not reached");
+   }
+}
+
 /**
  * Copy texture data from X tile layout to linear, faster.
  *
@@ -816,6 +950,60 @@ ytiled_to_linear_faster(uint32_t x0, uint32_t x1, uint32_t x2, uint32_t x3,
                     dst, src, dst_pitch, swizzle_bit, mem_copy, mem_copy);
 }
 
+/**
+ * Copy texture data from Tile4 layout to linear, faster.
+ *
+ * Same as \ref tile4_to_linear but faster, because it passes constant
+ * parameters for common cases, allowing the compiler to inline code
+ * optimized for those cases.
+ *
+ * \copydoc tile_copy_fn
+ */
+static FLATTEN void
+tile4_to_linear_faster(uint32_t x0, uint32_t x1, uint32_t x2, uint32_t x3,
+                       uint32_t y0, uint32_t y1,
+                       char *dst, const char *src,
+                       int32_t dst_pitch,
+                       uint32_t swizzle_bit,
+                       isl_memcpy_type copy_type)
+{
+   isl_mem_copy_fn mem_copy = choose_copy_function(copy_type);
+
+   if (x0 == 0 && x3 == tile4_width && y0 == 0 && y1 == tile4_height) {
+      if (mem_copy == memcpy)
+         return tile4_to_linear(0, 0, tile4_width, tile4_width, 0, tile4_height,
+                                dst, src, dst_pitch, swizzle_bit, memcpy, memcpy);
+      else if (mem_copy == rgba8_copy)
+         return tile4_to_linear(0, 0, tile4_width, tile4_width, 0, tile4_height,
+                                dst, src, dst_pitch, swizzle_bit,
+                                rgba8_copy, rgba8_copy_aligned_src);
+#if defined(INLINE_SSE41)
+      else if (copy_type == ISL_MEMCPY_STREAMING_LOAD)
+         return tile4_to_linear(0, 0, tile4_width, tile4_width, 0, tile4_height,
+                                dst, src, dst_pitch, swizzle_bit,
+                                memcpy, _memcpy_streaming_load);
+#endif
+      else
+         unreachable("not reached");
+   } else {
+      if (mem_copy == memcpy)
+         return tile4_to_linear(x0, x1, x2, x3, y0, y1,
+                                dst, src, dst_pitch, swizzle_bit, memcpy, memcpy);
+      else if (mem_copy == rgba8_copy)
+         return tile4_to_linear(x0, x1, x2, x3, y0, y1,
+                                dst, src, dst_pitch, swizzle_bit,
+                                rgba8_copy, rgba8_copy_aligned_src);
+#if defined(INLINE_SSE41)
+      else if (copy_type == ISL_MEMCPY_STREAMING_LOAD)
+         return tile4_to_linear(x0, x1, x2, x3, y0, y1,
+                                dst, src, dst_pitch, swizzle_bit,
+                                memcpy, _memcpy_streaming_load);
+#endif
+      else
+         unreachable("not reached");
+   }
+}
+
 /**
  * Copy from linear to tiled texture.
  *
@@ -853,6 +1041,11 @@ linear_to_tiled(uint32_t xt1, uint32_t xt2,
       th = ytile_height;
       span = ytile_span;
       tile_copy = linear_to_ytiled_faster;
+   } else if (tiling == ISL_TILING_4) {
+      tw = tile4_width;
+      th = tile4_height;
+      span = tile4_span;
+      tile_copy = linear_to_tile4_faster;
    } else {
       unreachable("unsupported tiling");
    }
@@ -944,6 +1137,11 @@ tiled_to_linear(uint32_t xt1, uint32_t xt2,
       th = ytile_height;
       span = ytile_span;
       tile_copy = ytiled_to_linear_faster;
+   } else if (tiling == ISL_TILING_4) {
+      tw = tile4_width;
+      th = tile4_height;
+      span = tile4_span;
+      tile_copy = tile4_to_linear_faster;
    } else {
       unreachable("unsupported tiling");
    }
@@ -1010,6 +1010,30 @@ anv_state_stream_finish(struct anv_state_stream *stream)
    VG(VALGRIND_DESTROY_MEMPOOL(stream));
 }
 
+/* Return all blocks but the first one to the state pool and start allocating
+ * from the beginning of the first block again.  This avoids going back to the
+ * shared pool when command buffers are reset and recorded again, which is
+ * what most apps do every frame.
+ */
+void
+anv_state_stream_reset(struct anv_state_stream *stream)
+{
+   util_dynarray_foreach(&stream->all_blocks, struct anv_state, block) {
+      VG(VALGRIND_MEMPOOL_FREE(stream, block->map));
+      VG(VALGRIND_MAKE_MEM_NOACCESS(block->map, block->alloc_size));
+      if (block != util_dynarray_begin(&stream->all_blocks))
+         anv_state_pool_free_no_vg(stream->state_pool, *block);
+   }
+
+   if (stream->all_blocks.size == 0)
+      return;
+
+   stream->all_blocks.size = sizeof(struct anv_state);
+   stream->block = *util_dynarray_element(&stream->all_blocks,
+                                          struct anv_state, 0);
+   stream->next = 0;
+}
+
 struct anv_state
 anv_state_stream_alloc(struct anv_state_stream *stream,
                        uint32_t size, uint32_t alignment)
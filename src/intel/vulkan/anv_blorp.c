@@ -131,6 +131,12 @@ anv_blorp_batch_init(struct anv_cmd_buffer *cmd_buffer,
       flags |= BLORP_BATCH_USE_COMPUTE;
    }
 
+   /* Nothing else emits 3D state while a blorp batch is in use and dynamic
+    * state lives as long as the command buffer, so blorp can reuse the
+    * pipeline state from one operation to the next.
+    */
+   flags |= BLORP_BATCH_REUSE_PIPELINE_STATE;
+
    blorp_batch_init(&cmd_buffer->device->blorp, batch, cmd_buffer, flags);
 }
 
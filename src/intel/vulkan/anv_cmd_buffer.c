@@ -224,17 +224,9 @@ anv_cmd_buffer_reset(struct anv_cmd_buffer *cmd_buffer)
    anv_cmd_buffer_reset_batch_bo_chain(cmd_buffer);
    anv_cmd_state_reset(cmd_buffer);
 
-   anv_state_stream_finish(&cmd_buffer->surface_state_stream);
-   anv_state_stream_init(&cmd_buffer->surface_state_stream,
-                         &cmd_buffer->device->surface_state_pool, 4096);
-
-   anv_state_stream_finish(&cmd_buffer->dynamic_state_stream);
-   anv_state_stream_init(&cmd_buffer->dynamic_state_stream,
-                         &cmd_buffer->device->dynamic_state_pool, 16384);
-
-   anv_state_stream_finish(&cmd_buffer->general_state_stream);
-   anv_state_stream_init(&cmd_buffer->general_state_stream,
-                         &cmd_buffer->device->general_state_pool, 16384);
+   anv_state_stream_reset(&cmd_buffer->surface_state_stream);
+   anv_state_stream_reset(&cmd_buffer->dynamic_state_stream);
+   anv_state_stream_reset(&cmd_buffer->general_state_stream);
 
    while (u_vector_length(&cmd_buffer->dynamic_bos) > 0) {
       struct anv_bo **bo = u_vector_remove(&cmd_buffer->dynamic_bos);
@@ -982,9 +982,7 @@ VkResult anv_ResetDescriptorPool(
       util_vma_heap_init(&pool->bo_heap, POOL_HEAP_OFFSET, pool->bo->size);
    }
 
-   anv_state_stream_finish(&pool->surface_state_stream);
-   anv_state_stream_init(&pool->surface_state_stream,
-                         &device->surface_state_pool, 4096);
+   anv_state_stream_reset(&pool->surface_state_stream);
    pool->surface_state_free_list = NULL;
 
    return VK_SUCCESS;
@@ -367,6 +367,8 @@ anv_measure_device_destroy(struct anv_physical_device *device)
    if (!config)
       return;
 
+   intel_measure_finish(measure_device);
+
    if (measure_device->ringbuffer != NULL) {
       vk_free(&device->instance->vk.alloc, measure_device->ringbuffer);
       measure_device->ringbuffer = NULL;
@@ -721,6 +721,61 @@ anv_pipeline_hash_graphics(struct anv_graphics_pipeline *pipeline,
    _mesa_sha1_final(&ctx, sha1_out);
 }
 
+/* Key for the NIR of a graphics stage after linking and lowering */
+struct anv_lowered_nir_key {
+   gl_shader_stage stage;
+   unsigned char sha1[20];
+};
+
+/* Hashes everything anv_graphics_pipeline_link_and_lower_nir() depends on.
+ * Linking ties all of the stages together so every stage goes into the
+ * hash, but the shader keys are left out.
+ */
+static void
+anv_pipeline_hash_graphics_lowered_nir(struct anv_graphics_pipeline *pipeline,
+                                       struct anv_pipeline_layout *layout,
+                                       struct anv_pipeline_stage *stages,
+                                       const struct vk_render_pass_state *rp,
+                                       unsigned char *sha1_out)
+{
+   struct mesa_sha1 ctx;
+   _mesa_sha1_init(&ctx);
+
+   /* Keep these keys apart from the ones of the final shader binaries */
+   static const char tag[] = "anv-lowered-nir";
+   _mesa_sha1_update(&ctx, tag, sizeof(tag));
+
+   _mesa_sha1_update(&ctx, &pipeline->view_mask,
+                     sizeof(pipeline->view_mask));
+
+   if (layout)
+      _mesa_sha1_update(&ctx, layout->sha1, sizeof(layout->sha1));
+
+   const struct anv_device *device = pipeline->base.device;
+
+   const bool rba = device->robust_buffer_access;
+   _mesa_sha1_update(&ctx, &rba, sizeof(rba));
+
+   const bool afs = device->physical->instance->assume_full_subgroups;
+   _mesa_sha1_update(&ctx, &afs, sizeof(afs));
+
+   for (uint32_t s = 0; s < ANV_GRAPHICS_SHADER_STAGE_COUNT; s++) {
+      if (stages[s].info) {
+         _mesa_sha1_update(&ctx, &s, sizeof(s));
+         _mesa_sha1_update(&ctx, stages[s].shader_sha1,
+                           sizeof(stages[s].shader_sha1));
+      }
+   }
+
+   /* Used by anv_pipeline_link_fs() */
+   if (stages[MESA_SHADER_FRAGMENT].info) {
+      _mesa_sha1_update(&ctx, &rp->color_attachment_count,
+                        sizeof(rp->color_attachment_count));
+   }
+
+   _mesa_sha1_final(&ctx, sha1_out);
+}
+
 static void
 anv_pipeline_hash_compute(struct anv_compute_pipeline *pipeline,
                           struct anv_pipeline_layout *layout,
@@ -1736,64 +1791,21 @@ anv_fixup_subgroup_size(struct anv_device *device, struct shader_info *info)
       info->subgroup_size = BRW_SUBGROUP_SIZE;
 }
 
-static VkResult
-anv_graphics_pipeline_compile(struct anv_graphics_pipeline *pipeline,
-                              struct vk_pipeline_cache *cache,
-                              const VkGraphicsPipelineCreateInfo *info,
-                              const struct vk_graphics_pipeline_state *state)
+/* Links the stages and runs the driver's NIR lowering on each of them.  None
+ * of this looks at the shader keys, apart from the bits of them which are
+ * computed from the NIR here and saved by
+ * anv_pipeline_stage_write_lowered_data().
+ */
+static void
+anv_graphics_pipeline_link_and_lower_nir(struct anv_graphics_pipeline *pipeline,
+                                         struct anv_pipeline_layout *layout,
+                                         const struct vk_graphics_pipeline_state *state,
+                                         struct anv_pipeline_stage *stages)
 {
-   ANV_FROM_HANDLE(anv_pipeline_layout, layout, info->layout);
-   VkResult result;
-
-   VkPipelineCreationFeedbackEXT pipeline_feedback = {
-      .flags = VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT,
-   };
-   int64_t pipeline_start = os_time_get_nano();
-
    struct anv_device *device = pipeline->base.device;
    const struct intel_device_info *devinfo = device->info;
    const struct brw_compiler *compiler = device->physical->compiler;
 
-   struct anv_pipeline_stage stages[ANV_GRAPHICS_SHADER_STAGE_COUNT] = {};
-   for (uint32_t i = 0; i < info->stageCount; i++) {
-      gl_shader_stage stage = vk_to_mesa_shader_stage(info->pStages[i].stage);
-      stages[stage].stage = stage;
-      stages[stage].info = &info->pStages[i];
-   }
-
-   anv_graphics_pipeline_init_keys(pipeline, state, stages);
-
-   unsigned char sha1[20];
-   anv_pipeline_hash_graphics(pipeline, layout, stages, sha1);
-
-   for (unsigned s = 0; s < ARRAY_SIZE(stages); s++) {
-      if (!stages[s].info)
-         continue;
-
-      stages[s].cache_key.stage = s;
-      memcpy(stages[s].cache_key.sha1, sha1, sizeof(sha1));
-   }
-
-   const bool skip_cache_lookup =
-      (pipeline->base.flags & VK_PIPELINE_CREATE_CAPTURE_INTERNAL_REPRESENTATIONS_BIT_KHR);
-   if (!skip_cache_lookup) {
-      bool found_all_shaders =
-         anv_graphics_pipeline_load_cached_shaders(pipeline, cache, stages,
-                                                   &pipeline_feedback);
-      if (found_all_shaders)
-         goto done;
-   }
-
-   if (info->flags & VK_PIPELINE_CREATE_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT)
-      return VK_PIPELINE_COMPILE_REQUIRED;
-
-   void *pipeline_ctx = ralloc_context(NULL);
-
-   result = anv_graphics_pipeline_load_nir(pipeline, cache, stages,
-                                           pipeline_ctx);
-   if (result != VK_SUCCESS)
-      goto fail;
-
    /* Walk backwards to link */
    struct anv_pipeline_stage *next_stage = NULL;
    for (int i = ARRAY_SIZE(graphics_shader_order) - 1; i >= 0; i--) {
@@ -1884,6 +1896,284 @@ anv_graphics_pipeline_compile(struct anv_graphics_pipeline *pipeline,
 
       prev_stage = stage;
    }
+}
+
+static void
+anv_pipeline_stage_write_lowered_data(const struct anv_pipeline_stage *stage,
+                                      struct blob *blob)
+{
+   const struct anv_pipeline_bind_map *bind_map = &stage->bind_map;
+   const struct brw_stage_prog_data *prog_data = &stage->prog_data.base;
+
+   /* Compute kernels are the only users of kernel args */
+   assert(bind_map->kernel_arg_count == 0);
+
+   blob_write_uint32(blob, stage->push_desc_info.used_descriptors);
+   blob_write_uint32(blob, stage->push_desc_info.fully_promoted_ubo_descriptors);
+   blob_write_uint8(blob, stage->push_desc_info.used_set_buffer);
+
+   blob_write_bytes(blob, bind_map->surface_sha1,
+                    sizeof(bind_map->surface_sha1));
+   blob_write_bytes(blob, bind_map->sampler_sha1,
+                    sizeof(bind_map->sampler_sha1));
+   blob_write_bytes(blob, bind_map->push_sha1,
+                    sizeof(bind_map->push_sha1));
+   blob_write_uint32(blob, bind_map->surface_count);
+   blob_write_uint32(blob, bind_map->sampler_count);
+   blob_write_bytes(blob, bind_map->surface_to_descriptor,
+                    bind_map->surface_count *
+                    sizeof(*bind_map->surface_to_descriptor));
+   blob_write_bytes(blob, bind_map->sampler_to_descriptor,
+                    bind_map->sampler_count *
+                    sizeof(*bind_map->sampler_to_descriptor));
+   blob_write_bytes(blob, bind_map->push_ranges,
+                    sizeof(bind_map->push_ranges));
+
+   blob_write_bytes(blob, prog_data->ubo_ranges,
+                    sizeof(prog_data->ubo_ranges));
+   blob_write_uint32(blob, prog_data->nr_params);
+   blob_write_uint64(blob, prog_data->zero_push_reg);
+   blob_write_uint32(blob, prog_data->push_reg_mask_param);
+
+   /* Key fields filled out while linking */
+   switch (stage->stage) {
+   case MESA_SHADER_TESS_CTRL:
+      blob_write_uint32(blob, stage->key.tcs._tes_primitive_mode);
+      break;
+   case MESA_SHADER_FRAGMENT:
+      blob_write_uint8(blob, stage->key.wm.color_outputs_valid);
+      blob_write_uint8(blob, stage->key.wm.nr_color_regions);
+      break;
+   default:
+      break;
+   }
+}
+
+static bool
+anv_pipeline_stage_read_lowered_data(struct anv_pipeline_stage *stage,
+                                     struct blob_reader *blob,
+                                     void *mem_ctx)
+{
+   struct anv_pipeline_bind_map *bind_map = &stage->bind_map;
+   struct brw_stage_prog_data *prog_data = &stage->prog_data.base;
+
+   stage->push_desc_info.used_descriptors = blob_read_uint32(blob);
+   stage->push_desc_info.fully_promoted_ubo_descriptors = blob_read_uint32(blob);
+   stage->push_desc_info.used_set_buffer = blob_read_uint8(blob);
+
+   blob_copy_bytes(blob, bind_map->surface_sha1,
+                   sizeof(bind_map->surface_sha1));
+   blob_copy_bytes(blob, bind_map->sampler_sha1,
+                   sizeof(bind_map->sampler_sha1));
+   blob_copy_bytes(blob, bind_map->push_sha1,
+                   sizeof(bind_map->push_sha1));
+   bind_map->surface_count = blob_read_uint32(blob);
+   bind_map->sampler_count = blob_read_uint32(blob);
+   if (bind_map->surface_count > ARRAY_SIZE(stage->surface_to_descriptor) ||
+       bind_map->sampler_count > ARRAY_SIZE(stage->sampler_to_descriptor))
+      return false;
+
+   blob_copy_bytes(blob, bind_map->surface_to_descriptor,
+                   bind_map->surface_count *
+                   sizeof(*bind_map->surface_to_descriptor));
+   blob_copy_bytes(blob, bind_map->sampler_to_descriptor,
+                   bind_map->sampler_count *
+                   sizeof(*bind_map->sampler_to_descriptor));
+   blob_copy_bytes(blob, bind_map->push_ranges,
+                   sizeof(bind_map->push_ranges));
+
+   blob_copy_bytes(blob, prog_data->ubo_ranges,
+                   sizeof(prog_data->ubo_ranges));
+   prog_data->nr_params = blob_read_uint32(blob);
+   prog_data->zero_push_reg = blob_read_uint64(blob);
+   prog_data->push_reg_mask_param = blob_read_uint32(blob);
+
+   switch (stage->stage) {
+   case MESA_SHADER_TESS_CTRL:
+      stage->key.tcs._tes_primitive_mode = blob_read_uint32(blob);
+      break;
+   case MESA_SHADER_FRAGMENT:
+      stage->key.wm.color_outputs_valid = blob_read_uint8(blob);
+      stage->key.wm.nr_color_regions = blob_read_uint8(blob);
+      break;
+   default:
+      break;
+   }
+
+   if (blob->overrun || blob->current != blob->end)
+      return false;
+
+   prog_data->param = rzalloc_array(mem_ctx, uint32_t, prog_data->nr_params);
+
+   return true;
+}
+
+/* Tries to load the NIR of every stage as it was after
+ * anv_graphics_pipeline_link_and_lower_nir().  This only succeeds if all the
+ * stages are found since linking ties them together.
+ */
+static bool
+anv_graphics_pipeline_load_lowered_nir(struct anv_graphics_pipeline *pipeline,
+                                       struct vk_pipeline_cache *cache,
+                                       struct anv_pipeline_stage *stages,
+                                       const unsigned char *sha1,
+                                       void *pipeline_ctx)
+{
+   struct anv_device *device = pipeline->base.device;
+   const struct brw_compiler *compiler = device->physical->compiler;
+
+   for (unsigned i = 0; i < ARRAY_SIZE(graphics_shader_order); i++) {
+      gl_shader_stage s = graphics_shader_order[i];
+      struct anv_pipeline_stage *stage = &stages[s];
+
+      if (!stage->info)
+         continue;
+
+      int64_t stage_start = os_time_get_nano();
+
+      struct anv_lowered_nir_key key = { .stage = s };
+      memcpy(key.sha1, sha1, sizeof(key.sha1));
+
+      stage->bind_map = (struct anv_pipeline_bind_map) {
+         .surface_to_descriptor = stage->surface_to_descriptor,
+         .sampler_to_descriptor = stage->sampler_to_descriptor
+      };
+
+      void *data;
+      size_t data_size;
+      stage->nir = anv_device_search_for_lowered_nir(device, cache,
+                                                     compiler->nir_options[s],
+                                                     &key, sizeof(key),
+                                                     pipeline_ctx,
+                                                     &data, &data_size);
+      if (stage->nir == NULL)
+         goto fail;
+
+      struct blob_reader blob;
+      blob_reader_init(&blob, data, data_size);
+      if (stage->nir->info.stage != s ||
+          !anv_pipeline_stage_read_lowered_data(stage, &blob, pipeline_ctx))
+         goto fail;
+
+      stage->feedback.duration += os_time_get_nano() - stage_start;
+   }
+
+   return true;
+
+fail:
+   /* Undo whatever the stages we did find filled out so that the full
+    * link and lower path starts from a clean slate.
+    */
+   for (unsigned s = 0; s < ANV_GRAPHICS_SHADER_STAGE_COUNT; s++) {
+      stages[s].nir = NULL;
+      memset(&stages[s].push_desc_info, 0, sizeof(stages[s].push_desc_info));
+      memset(&stages[s].prog_data, 0, sizeof(stages[s].prog_data));
+   }
+
+   return false;
+}
+
+static void
+anv_graphics_pipeline_upload_lowered_nir(struct anv_graphics_pipeline *pipeline,
+                                         struct vk_pipeline_cache *cache,
+                                         struct anv_pipeline_stage *stages,
+                                         const unsigned char *sha1)
+{
+   struct anv_device *device = pipeline->base.device;
+
+   for (unsigned s = 0; s < ANV_GRAPHICS_SHADER_STAGE_COUNT; s++) {
+      if (!stages[s].info)
+         continue;
+
+      struct anv_lowered_nir_key key = { .stage = s };
+      memcpy(key.sha1, sha1, sizeof(key.sha1));
+
+      struct blob blob;
+      blob_init(&blob);
+      anv_pipeline_stage_write_lowered_data(&stages[s], &blob);
+      if (!blob.out_of_memory) {
+         anv_device_upload_lowered_nir(device, cache, stages[s].nir,
+                                       &key, sizeof(key),
+                                       blob.data, blob.size);
+      }
+      blob_finish(&blob);
+   }
+}
+
+static VkResult
+anv_graphics_pipeline_compile(struct anv_graphics_pipeline *pipeline,
+                              struct vk_pipeline_cache *cache,
+                              const VkGraphicsPipelineCreateInfo *info,
+                              const struct vk_graphics_pipeline_state *state)
+{
+   ANV_FROM_HANDLE(anv_pipeline_layout, layout, info->layout);
+   VkResult result;
+
+   VkPipelineCreationFeedbackEXT pipeline_feedback = {
+      .flags = VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT,
+   };
+   int64_t pipeline_start = os_time_get_nano();
+
+   struct anv_device *device = pipeline->base.device;
+   const struct intel_device_info *devinfo = device->info;
+   const struct brw_compiler *compiler = device->physical->compiler;
+
+   struct anv_pipeline_stage stages[ANV_GRAPHICS_SHADER_STAGE_COUNT] = {};
+   for (uint32_t i = 0; i < info->stageCount; i++) {
+      gl_shader_stage stage = vk_to_mesa_shader_stage(info->pStages[i].stage);
+      stages[stage].stage = stage;
+      stages[stage].info = &info->pStages[i];
+   }
+
+   anv_graphics_pipeline_init_keys(pipeline, state, stages);
+
+   unsigned char sha1[20];
+   anv_pipeline_hash_graphics(pipeline, layout, stages, sha1);
+
+   for (unsigned s = 0; s < ARRAY_SIZE(stages); s++) {
+      if (!stages[s].info)
+         continue;
+
+      stages[s].cache_key.stage = s;
+      memcpy(stages[s].cache_key.sha1, sha1, sizeof(sha1));
+   }
+
+   const bool skip_cache_lookup =
+      (pipeline->base.flags & VK_PIPELINE_CREATE_CAPTURE_INTERNAL_REPRESENTATIONS_BIT_KHR);
+   if (!skip_cache_lookup) {
+      bool found_all_shaders =
+         anv_graphics_pipeline_load_cached_shaders(pipeline, cache, stages,
+                                                   &pipeline_feedback);
+      if (found_all_shaders)
+         goto done;
+   }
+
+   if (info->flags & VK_PIPELINE_CREATE_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT)
+      return VK_PIPELINE_COMPILE_REQUIRED;
+
+   void *pipeline_ctx = ralloc_context(NULL);
+
+   unsigned char lowered_sha1[20];
+   anv_pipeline_hash_graphics_lowered_nir(pipeline, layout, stages,
+                                          state->rp, lowered_sha1);
+
+   /* Pipelines which only differ in their shader keys (for instance in
+    * blend or multisample state) can pick up the lowered NIR from each
+    * other and skip straight to the back-end compile.
+    */
+   if (skip_cache_lookup ||
+       !anv_graphics_pipeline_load_lowered_nir(pipeline, cache, stages,
+                                               lowered_sha1, pipeline_ctx)) {
+      result = anv_graphics_pipeline_load_nir(pipeline, cache, stages,
+                                              pipeline_ctx);
+      if (result != VK_SUCCESS)
+         goto fail;
+
+      anv_graphics_pipeline_link_and_lower_nir(pipeline, layout, state,
+                                               stages);
+      anv_graphics_pipeline_upload_lowered_nir(pipeline, cache, stages,
+                                               lowered_sha1);
+   }
 
    /* In the case the platform can write the primitive variable shading rate,
     * figure out the last geometry stage that should write the primitive
@@ -1916,7 +2206,7 @@ anv_graphics_pipeline_compile(struct anv_graphics_pipeline *pipeline,
       last_psr->nir->info.outputs_written |= VARYING_BIT_PRIMITIVE_SHADING_RATE;
    }
 
-   prev_stage = NULL;
+   struct anv_pipeline_stage *prev_stage = NULL;
    for (unsigned i = 0; i < ARRAY_SIZE(graphics_shader_order); i++) {
       gl_shader_stage s = graphics_shader_order[i];
       struct anv_pipeline_stage *stage = &stages[s];
@@ -417,6 +417,36 @@ anv_device_upload_nir(struct anv_device *device,
    vk_pipeline_cache_add_nir(cache, sha1_key, SHA1_KEY_SIZE, nir);
 }
 
+struct nir_shader *
+anv_device_search_for_lowered_nir(struct anv_device *device,
+                                  struct vk_pipeline_cache *cache,
+                                  const nir_shader_compiler_options *nir_options,
+                                  const void *key_data, size_t key_size,
+                                  void *mem_ctx,
+                                  void **data, size_t *data_size)
+{
+   if (cache == NULL)
+      cache = device->default_pipeline_cache;
+
+   return vk_pipeline_cache_lookup_nir_with_data(cache, key_data, key_size,
+                                                 nir_options, NULL, mem_ctx,
+                                                 data, data_size);
+}
+
+void
+anv_device_upload_lowered_nir(struct anv_device *device,
+                              struct vk_pipeline_cache *cache,
+                              const struct nir_shader *nir,
+                              const void *key_data, size_t key_size,
+                              const void *data, size_t data_size)
+{
+   if (cache == NULL)
+      cache = device->default_pipeline_cache;
+
+   vk_pipeline_cache_add_nir_with_data(cache, key_data, key_size, nir,
+                                       data, data_size);
+}
+
 void
 anv_load_fp64_shader(struct anv_device *device)
 {
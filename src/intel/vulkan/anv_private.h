@@ -818,6 +818,7 @@ void anv_state_stream_init(struct anv_state_stream *stream,
                            struct anv_state_pool *state_pool,
                            uint32_t block_size);
 void anv_state_stream_finish(struct anv_state_stream *stream);
+void anv_state_stream_reset(struct anv_state_stream *stream);
 struct anv_state anv_state_stream_alloc(struct anv_state_stream *stream,
                                         uint32_t size, uint32_t alignment);
 
@@ -1121,6 +1122,21 @@ anv_device_upload_nir(struct anv_device *device,
                       const struct nir_shader *nir,
                       unsigned char sha1_key[20]);
 
+struct nir_shader *
+anv_device_search_for_lowered_nir(struct anv_device *device,
+                                  struct vk_pipeline_cache *cache,
+                                  const struct nir_shader_compiler_options *nir_options,
+                                  const void *key_data, size_t key_size,
+                                  void *mem_ctx,
+                                  void **data, size_t *data_size);
+
+void
+anv_device_upload_lowered_nir(struct anv_device *device,
+                              struct vk_pipeline_cache *cache,
+                              const struct nir_shader *nir,
+                              const void *key_data, size_t key_size,
+                              const void *data, size_t data_size);
+
 void
 anv_load_fp64_shader(struct anv_device *device);
 
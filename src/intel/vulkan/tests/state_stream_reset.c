@@ -0,0 +1,49 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "anv_private.h"
+#include "test_common.h"
+
+int main(void)
+{
+   struct anv_physical_device physical_device = {};
+   struct anv_device device = {};
+   struct anv_state_pool state_pool;
+   struct anv_state_stream stream;
+
+   anv_device_set_physical(&device, &physical_device);
+   pthread_mutex_init(&device.mutex, NULL);
+   anv_bo_cache_init(&device.bo_cache, &device);
+   anv_state_pool_init(&state_pool, &device, "test", 4096, 0, 4096);
+   anv_state_stream_init(&stream, &state_pool, 4096);
+
+   /* Resetting an empty stream is fine */
+   anv_state_stream_reset(&stream);
+
+   /* Fill a few blocks */
+   struct anv_state first = anv_state_stream_alloc(&stream, 3000, 16);
+   for (unsigned i = 0; i < 3; i++)
+      anv_state_stream_alloc(&stream, 3000, 16);
+   ASSERT(util_dynarray_num_elements(&stream.all_blocks, struct anv_state) == 4);
+
+   /* Only the first block is kept and allocations start over in it */
+   anv_state_stream_reset(&stream);
+   ASSERT(util_dynarray_num_elements(&stream.all_blocks, struct anv_state) == 1);
+
+   struct anv_state state = anv_state_stream_alloc(&stream, 16, 16);
+   ASSERT(state.offset == first.offset);
+   ASSERT(state.map == first.map);
+
+   state = anv_state_stream_alloc(&stream, 16, 16);
+   ASSERT(state.offset == first.offset + 16);
+
+   /* The other blocks went back to the pool and get reused */
+   state = anv_state_stream_alloc(&stream, 4096, 16);
+   ASSERT(state.offset + state.alloc_size <= 4 * 4096);
+
+   anv_state_stream_finish(&stream);
+   anv_state_pool_finish(&state_pool);
+   anv_bo_cache_finish(&device.bo_cache);
+   pthread_mutex_destroy(&device.mutex);
+}
@@ -371,6 +371,10 @@ loader_dri3_drawable_fini(struct loader_dri3_drawable *draw)
    if (draw->region)
       xcb_xfixes_destroy_region(draw->conn, draw->region);
 
+#ifdef HAVE_DRI3_MODIFIERS
+   free(draw->mod_reply);
+#endif
+
    cnd_destroy(&draw->event_cnd);
    mtx_destroy(&draw->mtx);
 }
@@ -527,6 +531,9 @@ dri3_handle_present_event(struct loader_dri3_drawable *draw,
                if (draw->buffers[b])
                   draw->buffers[b]->reallocate = true;
             }
+#ifdef HAVE_DRI3_MODIFIERS
+            draw->mod_reply_stale = true;
+#endif
          }
 
          /* If the server tells us that our allocation is suboptimal, we
@@ -539,6 +546,7 @@ dri3_handle_present_event(struct loader_dri3_drawable *draw,
                if (draw->buffers[b])
                   draw->buffers[b]->reallocate = true;
             }
+            draw->mod_reply_stale = true;
          }
 #endif
          draw->last_present_mode = ce->mode;
@@ -1421,6 +1429,45 @@ has_supported_modifier(struct loader_dri3_drawable *draw, unsigned int format,
    free(supported_modifiers);
    return found;
 }
+
+/* Return the supported modifiers for the drawable's window.  The reply is
+ * cached on the drawable so that allocating several back buffers, or
+ * reallocating them on every resize, doesn't cost a server round trip each
+ * time.
+ */
+static const xcb_dri3_get_supported_modifiers_reply_t *
+dri3_get_supported_modifiers(struct loader_dri3_drawable *draw,
+                             int depth, int bpp)
+{
+   mtx_lock(&draw->mtx);
+   bool stale = draw->mod_reply_stale;
+   draw->mod_reply_stale = false;
+   mtx_unlock(&draw->mtx);
+
+   if (draw->mod_reply &&
+       (stale || draw->mod_reply_depth != depth ||
+        draw->mod_reply_bpp != bpp)) {
+      free(draw->mod_reply);
+      draw->mod_reply = NULL;
+   }
+
+   if (!draw->mod_reply) {
+      xcb_dri3_get_supported_modifiers_cookie_t mod_cookie;
+      xcb_generic_error_t *error = NULL;
+
+      mod_cookie = xcb_dri3_get_supported_modifiers(draw->conn,
+                                                    draw->window,
+                                                    depth, bpp);
+      draw->mod_reply = xcb_dri3_get_supported_modifiers_reply(draw->conn,
+                                                               mod_cookie,
+                                                               &error);
+      free(error);
+      draw->mod_reply_depth = depth;
+      draw->mod_reply_bpp = bpp;
+   }
+
+   return draw->mod_reply;
+}
 #endif
 
 /** loader_dri3_alloc_render_buffer
@@ -1474,26 +1521,16 @@ dri3_alloc_render_buffer(struct loader_dri3_drawable *draw, unsigned int format,
           draw->ext->image->base.version >= 15 &&
           draw->ext->image->queryDmaBufModifiers &&
           draw->ext->image->createImageWithModifiers) {
-         xcb_dri3_get_supported_modifiers_cookie_t mod_cookie;
-         xcb_dri3_get_supported_modifiers_reply_t *mod_reply;
-         xcb_generic_error_t *error = NULL;
-
-         mod_cookie = xcb_dri3_get_supported_modifiers(draw->conn,
-                                                       draw->window,
-                                                       depth, buffer->cpp * 8);
-         mod_reply = xcb_dri3_get_supported_modifiers_reply(draw->conn,
-                                                            mod_cookie,
-                                                            &error);
+         const xcb_dri3_get_supported_modifiers_reply_t *mod_reply =
+            dri3_get_supported_modifiers(draw, depth, buffer->cpp * 8);
          if (!mod_reply)
             goto no_image;
 
          if (mod_reply->num_window_modifiers) {
             count = mod_reply->num_window_modifiers;
             modifiers = malloc(count * sizeof(uint64_t));
-            if (!modifiers) {
-               free(mod_reply);
+            if (!modifiers)
                goto no_image;
-            }
 
             memcpy(modifiers,
                    xcb_dri3_get_supported_modifiers_window_modifiers(mod_reply),
@@ -1510,17 +1547,13 @@ dri3_alloc_render_buffer(struct loader_dri3_drawable *draw, unsigned int format,
          if (mod_reply->num_screen_modifiers && modifiers == NULL) {
             count = mod_reply->num_screen_modifiers;
             modifiers = malloc(count * sizeof(uint64_t));
-            if (!modifiers) {
-               free(mod_reply);
+            if (!modifiers)
                goto no_image;
-            }
 
             memcpy(modifiers,
                    xcb_dri3_get_supported_modifiers_screen_modifiers(mod_reply),
                    count * sizeof(uint64_t));
          }
-
-         free(mod_reply);
       }
 #endif
       buffer->image = loader_dri_create_image(draw->dri_screen, draw->ext->image,
@@ -186,10 +186,21 @@ struct loader_dri3_drawable {
 
    bool is_protected_content;
 
+#ifdef HAVE_DRI3_MODIFIERS
+   /* GetSupportedModifiers reply cached for back buffer allocation, along
+    * with the depth and bpp it was queried for.  Dropped when the present
+    * mode changes in a way that may change the supported modifiers.
+    */
+   xcb_dri3_get_supported_modifiers_reply_t *mod_reply;
+   int mod_reply_depth;
+   int mod_reply_bpp;
+   bool mod_reply_stale;
+#endif
+
    /* Currently protects the following fields:
     * event_cnd, has_event_waiter,
     * recv_sbc, ust, msc, recv_msc_serial,
-    * notify_ust, notify_msc
+    * notify_ust, notify_msc, mod_reply_stale
     */
    mtx_t mtx;
    cnd_t event_cnd;
@@ -1674,6 +1674,74 @@ invalidate_saved_current_state(struct gl_context *ctx)
 }
 
 
+/**
+ * Map an enable cap whose state is tracked while compiling a display list
+ * to its bit in ListState.Current.EnableKnown/EnableValue, or return -1.
+ * Only caps that aren't per texture unit and can't be changed as a side
+ * effect of other commands recorded in the list are tracked.
+ */
+static int
+saved_enable_bit(GLenum cap)
+{
+   switch (cap) {
+   case GL_ALPHA_TEST:           return 0;
+   case GL_BLEND:                return 1;
+   case GL_COLOR_MATERIAL:       return 2;
+   case GL_CULL_FACE:            return 3;
+   case GL_DEPTH_TEST:           return 4;
+   case GL_FOG:                  return 5;
+   case GL_LIGHTING:             return 6;
+   case GL_LINE_SMOOTH:          return 7;
+   case GL_LINE_STIPPLE:         return 8;
+   case GL_NORMALIZE:            return 9;
+   case GL_POLYGON_OFFSET_FILL:  return 10;
+   case GL_POLYGON_OFFSET_LINE:  return 11;
+   case GL_POLYGON_STIPPLE:      return 12;
+   case GL_RESCALE_NORMAL:       return 13;
+   case GL_SCISSOR_TEST:         return 14;
+   case GL_STENCIL_TEST:         return 15;
+   default:
+      if (cap >= GL_LIGHT0 && cap <= GL_LIGHT7)
+         return 16 + (cap - GL_LIGHT0);
+      return -1;
+   }
+}
+
+
+/**
+ * Return true if glEnable/glDisable(cap) would be a no-op given the state
+ * already set by the list being compiled, otherwise remember the new state.
+ */
+static bool
+saved_enable_is_redundant(struct gl_context *ctx, GLenum cap, bool state)
+{
+   int bit = saved_enable_bit(cap);
+   if (bit < 0)
+      return false;
+
+   GLbitfield mask = BITFIELD_BIT(bit);
+   if ((ctx->ListState.Current.EnableKnown & mask) &&
+       !!(ctx->ListState.Current.EnableValue & mask) == state)
+      return true;
+
+   ctx->ListState.Current.EnableKnown |= mask;
+   if (state)
+      ctx->ListState.Current.EnableValue |= mask;
+   else
+      ctx->ListState.Current.EnableValue &= ~mask;
+   return false;
+}
+
+
+static void
+forget_saved_enable(struct gl_context *ctx, GLenum cap)
+{
+   int bit = saved_enable_bit(cap);
+   if (bit >= 0)
+      ctx->ListState.Current.EnableKnown &= ~BITFIELD_BIT(bit);
+}
+
+
 static void GLAPIENTRY
 save_CallList(GLuint list)
 {
@@ -2261,14 +2329,23 @@ save_Disable(GLenum cap)
 {
    GET_CURRENT_CONTEXT(ctx);
    Node *n;
-   ASSERT_OUTSIDE_SAVE_BEGIN_END_AND_FLUSH(ctx);
+   ASSERT_OUTSIDE_SAVE_BEGIN_END(ctx);
+
+   if (ctx->ExecuteFlag) {
+      CALL_Disable(ctx->Exec, (cap));
+   }
+
+   /* Like glShadeModel, skip no-ops so that the surrounding geometry
+    * can stay in one vertex list.
+    */
+   if (saved_enable_is_redundant(ctx, cap, false))
+      return;
+
+   SAVE_FLUSH_VERTICES(ctx);
    n = alloc_instruction(ctx, OPCODE_DISABLE, 1);
    if (n) {
       n[1].e = cap;
    }
-   if (ctx->ExecuteFlag) {
-      CALL_Disable(ctx->Exec, (cap));
-   }
 }
 
 
@@ -2278,6 +2355,7 @@ save_Disablei(GLuint index, GLenum cap)
    GET_CURRENT_CONTEXT(ctx);
    Node *n;
    ASSERT_OUTSIDE_SAVE_BEGIN_END_AND_FLUSH(ctx);
+   forget_saved_enable(ctx, cap);
    n = alloc_instruction(ctx, OPCODE_DISABLE_INDEXED, 2);
    if (n) {
       n[1].ui = index;
@@ -2336,14 +2414,23 @@ save_Enable(GLenum cap)
 {
    GET_CURRENT_CONTEXT(ctx);
    Node *n;
-   ASSERT_OUTSIDE_SAVE_BEGIN_END_AND_FLUSH(ctx);
+   ASSERT_OUTSIDE_SAVE_BEGIN_END(ctx);
+
+   if (ctx->ExecuteFlag) {
+      CALL_Enable(ctx->Exec, (cap));
+   }
+
+   /* Like glShadeModel, skip no-ops so that the surrounding geometry
+    * can stay in one vertex list.
+    */
+   if (saved_enable_is_redundant(ctx, cap, true))
+      return;
+
+   SAVE_FLUSH_VERTICES(ctx);
    n = alloc_instruction(ctx, OPCODE_ENABLE, 1);
    if (n) {
       n[1].e = cap;
    }
-   if (ctx->ExecuteFlag) {
-      CALL_Enable(ctx->Exec, (cap));
-   }
 }
 
 
@@ -2354,6 +2441,7 @@ save_Enablei(GLuint index, GLenum cap)
    GET_CURRENT_CONTEXT(ctx);
    Node *n;
    ASSERT_OUTSIDE_SAVE_BEGIN_END_AND_FLUSH(ctx);
+   forget_saved_enable(ctx, cap);
    n = alloc_instruction(ctx, OPCODE_ENABLE_INDEXED, 2);
    if (n) {
       n[1].ui = index;
@@ -2762,14 +2850,24 @@ save_LineWidth(GLfloat width)
 {
    GET_CURRENT_CONTEXT(ctx);
    Node *n;
-   ASSERT_OUTSIDE_SAVE_BEGIN_END_AND_FLUSH(ctx);
+   ASSERT_OUTSIDE_SAVE_BEGIN_END(ctx);
+
+   if (ctx->ExecuteFlag) {
+      CALL_LineWidth(ctx->Exec, (width));
+   }
+
+   /* 0 means unknown; invalid values must still be compiled. */
+   if (width > 0.0f && ctx->ListState.Current.LineWidth == width)
+      return;
+
+   SAVE_FLUSH_VERTICES(ctx);
+
+   ctx->ListState.Current.LineWidth = width > 0.0f ? width : 0.0f;
+
    n = alloc_instruction(ctx, OPCODE_LINE_WIDTH, 1);
    if (n) {
       n[1].f = width;
    }
-   if (ctx->ExecuteFlag) {
-      CALL_LineWidth(ctx->Exec, (width));
-   }
 }
 
 
@@ -3309,14 +3407,24 @@ save_PointSize(GLfloat size)
 {
    GET_CURRENT_CONTEXT(ctx);
    Node *n;
-   ASSERT_OUTSIDE_SAVE_BEGIN_END_AND_FLUSH(ctx);
+   ASSERT_OUTSIDE_SAVE_BEGIN_END(ctx);
+
+   if (ctx->ExecuteFlag) {
+      CALL_PointSize(ctx->Exec, (size));
+   }
+
+   /* 0 means unknown; invalid values must still be compiled. */
+   if (size > 0.0f && ctx->ListState.Current.PointSize == size)
+      return;
+
+   SAVE_FLUSH_VERTICES(ctx);
+
+   ctx->ListState.Current.PointSize = size > 0.0f ? size : 0.0f;
+
    n = alloc_instruction(ctx, OPCODE_POINT_SIZE, 1);
    if (n) {
       n[1].f = size;
    }
-   if (ctx->ExecuteFlag) {
-      CALL_PointSize(ctx->Exec, (size));
-   }
 }
 
 
@@ -3400,6 +3508,9 @@ save_PopAttrib(void)
    if (ctx->ExecuteFlag) {
       CALL_PopAttrib(ctx->Exec, ());
    }
+
+   /* The restored state isn't known at compile time. */
+   invalidate_saved_current_state(ctx);
 }
 
 
@@ -1382,6 +1382,9 @@ find_custom_value(struct gl_context *ctx, const struct value_desc *d, union valu
  * \param func name of calling glGet*v() function for error reporting
  * \param d the struct value_desc that has the extra constraints
  *
+ * If func is NULL, no error is recorded and constraints that would need a
+ * state update or depend on non-constant state fail.
+ *
  * \return GL_FALSE if all of the constraints were not satisfied,
  *     otherwise GL_TRUE.
  */
@@ -1451,13 +1454,19 @@ check_extra(struct gl_context *ctx, const char *func, const struct value_desc *d
             api_found = GL_TRUE;
          break;
       case EXTRA_NEW_BUFFERS:
+         if (!func)
+            return GL_FALSE;
          if (ctx->NewState & _NEW_BUFFERS)
             _mesa_update_state(ctx);
          break;
       case EXTRA_FLUSH_CURRENT:
+         if (!func)
+            return GL_FALSE;
          FLUSH_CURRENT(ctx, 0);
          break;
       case EXTRA_VALID_DRAW_BUFFER:
+         if (!func)
+            return GL_FALSE;
          if (d->pname - GL_DRAW_BUFFER0_ARB >= ctx->Const.MaxDrawBuffers) {
             _mesa_error(ctx, GL_INVALID_OPERATION, "%s(draw buffer %u)",
                         func, d->pname - GL_DRAW_BUFFER0_ARB);
@@ -1465,6 +1474,8 @@ check_extra(struct gl_context *ctx, const char *func, const struct value_desc *d
          }
          break;
       case EXTRA_VALID_TEXTURE_UNIT:
+         if (!func)
+            return GL_FALSE;
          if (ctx->Texture.CurrentUnit >= ctx->Const.MaxTextureCoordUnits) {
             _mesa_error(ctx, GL_INVALID_OPERATION, "%s(texture %u)",
                         func, ctx->Texture.CurrentUnit);
@@ -1472,6 +1483,8 @@ check_extra(struct gl_context *ctx, const char *func, const struct value_desc *d
          }
          break;
       case EXTRA_VALID_CLIP_DISTANCE:
+         if (!func)
+            return GL_FALSE;
          if (d->pname - GL_CLIP_DISTANCE0 >= ctx->Const.MaxClipPlanes) {
             _mesa_error(ctx, GL_INVALID_ENUM, "%s(clip distance %u)",
                         func, d->pname - GL_CLIP_DISTANCE0);
@@ -1546,8 +1559,10 @@ check_extra(struct gl_context *ctx, const char *func, const struct value_desc *d
    }
 
    if (api_check && !api_found) {
-      _mesa_error(ctx, GL_INVALID_ENUM, "%s(pname=%s)", func,
-                  _mesa_enum_to_string(d->pname));
+      if (func) {
+         _mesa_error(ctx, GL_INVALID_ENUM, "%s(pname=%s)", func,
+                     _mesa_enum_to_string(d->pname));
+      }
       return GL_FALSE;
    }
 
@@ -1558,37 +1573,16 @@ static const struct value_desc error_value =
    { 0, 0, TYPE_INVALID, NO_OFFSET, NO_EXTRA };
 
 /**
- * Find the struct value_desc corresponding to the enum 'pname'.
- *
- * We hash the enum value to get an index into the 'table' array,
- * which holds the index in the 'values' array of struct value_desc.
- * Once we've found the entry, we do the extra checks, if any, then
- * look up the value and return a pointer to it.
- *
- * If the value has to be computed (for example, it's the result of a
- * function call or we need to add 1 to it), we use the tmp 'v' to
- * store the result.
- *
- * \param func name of glGet*v() func for error reporting
- * \param pname the enum value we're looking up
- * \param p is were we return the pointer to the value
- * \param v a tmp union value variable in the calling glGet*v() function
- *
- * \return the struct value_desc corresponding to the enum or a struct
- *     value_desc of TYPE_INVALID if not found.  This lets the calling
- *     glGet*v() function jump right into a switch statement and
- *     handle errors there instead of having to check for NULL.
+ * Look up the struct value_desc corresponding to the enum 'pname' in the
+ * table of the context's API, or return NULL if there is none.
  */
 static const struct value_desc *
-find_value(const char *func, GLenum pname, void **p, union value *v)
+lookup_value(struct gl_context *ctx, GLenum pname)
 {
-   GET_CURRENT_CONTEXT(ctx);
    int mask, hash;
    const struct value_desc *d;
    int api;
 
-   *p = NULL;
-
    api = ctx->API;
    /* We index into the table_set[] list of per-API hash tables using the API's
     * value in the gl_api enum. Since GLES 3 doesn't have an API_OPENGL* enum
@@ -1612,18 +1606,53 @@ find_value(const char *func, GLenum pname, void **p, union value *v)
       /* If the enum isn't valid, the hash walk ends with index 0,
        * pointing to the first entry of values[] which doesn't hold
        * any valid enum. */
-      if (unlikely(idx == 0)) {
-         _mesa_error(ctx, GL_INVALID_ENUM, "%s(pname=%s)", func,
-               _mesa_enum_to_string(pname));
-         return &error_value;
-      }
+      if (unlikely(idx == 0))
+         return NULL;
 
       d = &values[idx];
       if (likely(d->pname == pname))
-         break;
+         return d;
 
       hash += prime_step;
    }
+}
+
+/**
+ * Find the struct value_desc corresponding to the enum 'pname'.
+ *
+ * We hash the enum value to get an index into the 'table' array,
+ * which holds the index in the 'values' array of struct value_desc.
+ * Once we've found the entry, we do the extra checks, if any, then
+ * look up the value and return a pointer to it.
+ *
+ * If the value has to be computed (for example, it's the result of a
+ * function call or we need to add 1 to it), we use the tmp 'v' to
+ * store the result.
+ *
+ * \param func name of glGet*v() func for error reporting
+ * \param pname the enum value we're looking up
+ * \param p is were we return the pointer to the value
+ * \param v a tmp union value variable in the calling glGet*v() function
+ *
+ * \return the struct value_desc corresponding to the enum or a struct
+ *     value_desc of TYPE_INVALID if not found.  This lets the calling
+ *     glGet*v() function jump right into a switch statement and
+ *     handle errors there instead of having to check for NULL.
+ */
+static const struct value_desc *
+find_value(const char *func, GLenum pname, void **p, union value *v)
+{
+   GET_CURRENT_CONTEXT(ctx);
+   const struct value_desc *d;
+
+   *p = NULL;
+
+   d = lookup_value(ctx, pname);
+   if (unlikely(!d)) {
+      _mesa_error(ctx, GL_INVALID_ENUM, "%s(pname=%s)", func,
+                  _mesa_enum_to_string(pname));
+      return &error_value;
+   }
 
    if (unlikely(d->extra && !check_extra(ctx, func, d)))
       return &error_value;
@@ -1661,6 +1690,29 @@ find_value(const char *func, GLenum pname, void **p, union value *v)
    return &error_value;
 }
 
+/**
+ * Whether pname is a valid query of a value that can't change after context
+ * creation, i.e. CONST() and CONTEXT_*(Const.*) items in get_hash_params.py.
+ * glthread uses this to answer such queries without synchronizing with the
+ * driver thread. This has no side effects.
+ */
+bool
+_mesa_get_is_constant(struct gl_context *ctx, GLenum pname)
+{
+   const struct value_desc *d = lookup_value(ctx, pname);
+
+   if (!d || d->location != LOC_CONTEXT)
+      return false;
+
+   if (d->type != TYPE_CONST &&
+       (d->offset < offsetof(struct gl_context, Const) ||
+        d->offset >= offsetof(struct gl_context, Const) +
+                     sizeof(struct gl_constants)))
+      return false;
+
+   return !d->extra || check_extra(ctx, NULL, d);
+}
+
 static const int transpose[] = {
    0, 4,  8, 12,
    1, 5,  9, 13,
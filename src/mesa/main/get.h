@@ -32,12 +32,17 @@
 #define GET_H
 
 
+#include <stdbool.h>
 #include "util/glheader.h"
 
+struct gl_context;
 struct gl_vertex_array_object;
 
 extern void
 _get_vao_pointerv(GLenum pname, struct gl_vertex_array_object* vao,
                   GLvoid **params, const char* callerstr);
 
+bool
+_mesa_get_is_constant(struct gl_context *ctx, GLenum pname);
+
 #endif
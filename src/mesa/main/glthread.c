@@ -125,6 +125,12 @@ _mesa_glthread_init(struct gl_context *ctx)
    _mesa_glthread_reset_vao(&glthread->DefaultVAO);
    glthread->CurrentVAO = &glthread->DefaultVAO;
 
+   /* Nothing is queued yet, so the unpack state matches the context. */
+   glthread->Unpack.Alignment = ctx->Unpack.Alignment;
+   glthread->Unpack.RowLength = ctx->Unpack.RowLength;
+   glthread->Unpack.SkipPixels = ctx->Unpack.SkipPixels;
+   glthread->Unpack.SkipRows = ctx->Unpack.SkipRows;
+
    ctx->MarshalExec = _mesa_alloc_dispatch_table(true);
    if (!ctx->MarshalExec) {
       _mesa_DeleteHashTable(glthread->VAOs);
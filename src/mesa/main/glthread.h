@@ -113,6 +113,16 @@ struct glthread_batch
    uint64_t buffer[MARSHAL_MAX_CMD_SIZE / 8];
 };
 
+/* Pixel unpack state needed to know how much client memory a texture upload
+ * reads.
+ */
+struct glthread_unpack_state {
+   int Alignment;
+   int RowLength;
+   int SkipPixels;
+   int SkipRows;
+};
+
 struct glthread_client_attrib {
    struct glthread_vao VAO;
    GLuint CurrentArrayBufferName;
@@ -123,6 +133,9 @@ struct glthread_client_attrib {
 
    /** Whether this element of the client attrib stack contains saved state. */
    bool Valid;
+
+   struct glthread_unpack_state Unpack;
+   bool UnpackValid;
 };
 
 /* For glPushAttrib / glPopAttrib. */
@@ -215,6 +228,9 @@ struct glthread_state
    GLuint CurrentPixelUnpackBufferName;
    GLuint CurrentQueryBufferName;
 
+   /** Pixel unpack state for uploads from client memory. */
+   struct glthread_unpack_state Unpack;
+
    /**
     * The batch index of the last occurence of glLinkProgram or
     * glDeleteProgram or -1 if there is no such enqueued call.
@@ -338,6 +354,9 @@ void _mesa_glthread_ClientAttribDefault(struct gl_context *ctx, GLbitfield mask)
 void _mesa_glthread_InterleavedArrays(struct gl_context *ctx, GLenum format,
                                       GLsizei stride, const GLvoid *pointer);
 void _mesa_glthread_ProgramChanged(struct gl_context *ctx);
+void _mesa_glthread_PixelStorei(struct gl_context *ctx, GLenum pname,
+                                GLint param);
+void _mesa_glthread_reset_unpack(struct glthread_unpack_state *unpack);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,157 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Asynchronous texture uploads from client memory.
+ *
+ * glthread tracks the pixel unpack state to compute how much client memory
+ * a texture upload reads, copies it, and lets the upload execute in the
+ * worker thread instead of syncing.
+ */
+
+#include "main/glthread_marshal.h"
+#include "main/dispatch.h"
+#include "main/glformats.h"
+
+/* Uploads bigger than this are executed synchronously. */
+#define MARSHAL_MAX_TEX_UPLOAD_SIZE (16 * 1024 * 1024)
+
+void
+_mesa_glthread_PixelStorei(struct gl_context *ctx, GLenum pname, GLint param)
+{
+   struct glthread_unpack_state *unpack = &ctx->GLThread.Unpack;
+
+   /* Only track values that Mesa accepts, so that the tracked state never
+    * diverges from ctx->Unpack.
+    */
+   switch (pname) {
+   case GL_UNPACK_ALIGNMENT:
+      if (param == 1 || param == 2 || param == 4 || param == 8)
+         unpack->Alignment = param;
+      break;
+   case GL_UNPACK_ROW_LENGTH:
+      if (ctx->API != API_OPENGLES && param >= 0)
+         unpack->RowLength = param;
+      break;
+   case GL_UNPACK_SKIP_PIXELS:
+      if (ctx->API != API_OPENGLES && param >= 0)
+         unpack->SkipPixels = param;
+      break;
+   case GL_UNPACK_SKIP_ROWS:
+      if (ctx->API != API_OPENGLES && param >= 0)
+         unpack->SkipRows = param;
+      break;
+   default:
+      break;
+   }
+}
+
+void
+_mesa_glthread_reset_unpack(struct glthread_unpack_state *unpack)
+{
+   unpack->Alignment = 4;
+   unpack->RowLength = 0;
+   unpack->SkipPixels = 0;
+   unpack->SkipRows = 0;
+}
+
+/* Return the number of bytes a 2D upload reads from client memory, or -1 if
+ * it can't be determined.
+ */
+static int64_t
+get_image_2d_size(const struct glthread_unpack_state *unpack,
+                  GLsizei width, GLsizei height, GLenum format, GLenum type)
+{
+   if (type == GL_BITMAP)
+      return -1;
+
+   const GLint bytes_per_pixel = _mesa_bytes_per_pixel(format, type);
+   if (bytes_per_pixel <= 0)
+      return -1;
+
+   int64_t row_length = unpack->RowLength ? unpack->RowLength : width;
+   int64_t row_stride = align64(row_length * bytes_per_pixel,
+                                unpack->Alignment);
+
+   return (unpack->SkipRows + height - 1) * row_stride +
+          (int64_t)(unpack->SkipPixels + width) * bytes_per_pixel;
+}
+
+struct marshal_cmd_TexSubImage2D
+{
+   struct marshal_cmd_base cmd_base;
+   GLenum16 target;
+   GLenum16 format;
+   GLenum16 type;
+   bool free_pixels; /* pixels is a copy owned by the command */
+   GLint level;
+   GLint xoffset;
+   GLint yoffset;
+   GLsizei width;
+   GLsizei height;
+   const GLvoid *pixels;
+};
+
+uint32_t
+_mesa_unmarshal_TexSubImage2D(struct gl_context *ctx,
+                              const struct marshal_cmd_TexSubImage2D *cmd)
+{
+   CALL_TexSubImage2D(ctx->CurrentServerDispatch,
+                      (cmd->target, cmd->level, cmd->xoffset, cmd->yoffset,
+                       cmd->width, cmd->height, cmd->format, cmd->type,
+                       cmd->pixels));
+
+   if (cmd->free_pixels)
+      free((void *)cmd->pixels);
+
+   const unsigned cmd_size = align(sizeof(*cmd), 8) / 8;
+   assert(cmd_size == cmd->cmd_base.cmd_size);
+   return cmd_size;
+}
+
+void GLAPIENTRY
+_mesa_marshal_TexSubImage2D(GLenum target, GLint level, GLint xoffset,
+                            GLint yoffset, GLsizei width, GLsizei height,
+                            GLenum format, GLenum type, const GLvoid *pixels)
+{
+   GET_CURRENT_CONTEXT(ctx);
+   const GLvoid *copy = NULL;
+
+   /* Copy client memory, so that the caller can reuse it immediately.
+    * With a PBO bound, pixels is an offset and is passed as-is. Empty or
+    * invalid uploads don't read any memory.
+    */
+   if (_mesa_glthread_has_no_unpack_buffer(ctx) && pixels &&
+       width > 0 && height > 0) {
+      int64_t size = get_image_2d_size(&ctx->GLThread.Unpack, width, height,
+                                       format, type);
+
+      if (size > 0 && size <= MARSHAL_MAX_TEX_UPLOAD_SIZE)
+         copy = malloc(size);
+
+      if (!copy) {
+         _mesa_glthread_finish_before(ctx, "TexSubImage2D");
+         CALL_TexSubImage2D(ctx->CurrentServerDispatch,
+                            (target, level, xoffset, yoffset, width, height,
+                             format, type, pixels));
+         return;
+      }
+
+      memcpy((void *)copy, pixels, size);
+   }
+
+   int cmd_size = sizeof(struct marshal_cmd_TexSubImage2D);
+   struct marshal_cmd_TexSubImage2D *cmd =
+      _mesa_glthread_allocate_command(ctx, DISPATCH_CMD_TexSubImage2D,
+                                      cmd_size);
+   cmd->target = MIN2(target, 0xffff); /* clamped to 0xffff (invalid enum) */
+   cmd->format = MIN2(format, 0xffff);
+   cmd->type = MIN2(type, 0xffff);
+   cmd->free_pixels = copy != NULL;
+   cmd->level = level;
+   cmd->xoffset = xoffset;
+   cmd->yoffset = yoffset;
+   cmd->width = width;
+   cmd->height = height;
+   cmd->pixels = copy ? copy : pixels;
+}
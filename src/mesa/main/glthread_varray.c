@@ -594,6 +594,10 @@ _mesa_glthread_PushClientAttrib(struct gl_context *ctx, GLbitfield mask,
       top->Valid = false;
    }
 
+   top->UnpackValid = mask & GL_CLIENT_PIXEL_STORE_BIT;
+   if (top->UnpackValid)
+      top->Unpack = glthread->Unpack;
+
    glthread->ClientAttribStackTop++;
 
    if (set_default)
@@ -613,6 +617,9 @@ _mesa_glthread_PopClientAttrib(struct gl_context *ctx)
    struct glthread_client_attrib *top =
       &glthread->ClientAttribStack[glthread->ClientAttribStackTop];
 
+   if (top->UnpackValid)
+      glthread->Unpack = top->Unpack;
+
    if (!top->Valid)
       return;
 
@@ -644,6 +651,9 @@ _mesa_glthread_ClientAttribDefault(struct gl_context *ctx, GLbitfield mask)
 {
    struct glthread_state *glthread = &ctx->GLThread;
 
+   if (mask & GL_CLIENT_PIXEL_STORE_BIT)
+      _mesa_glthread_reset_unpack(&glthread->Unpack);
+
    if (!(mask & GL_CLIENT_VERTEX_ARRAY_BIT))
       return;
 
@@ -38,6 +38,7 @@
 #include "util/glheader.h"
 #include "hash.h"
 #include "util/hash_table.h"
+#include "util/u_atomic.h"
 #include "util/u_memory.h"
 #include "util/u_idalloc.h"
 
@@ -91,6 +92,8 @@ _mesa_DeleteHashTable(struct _mesa_HashTable *table)
    }
 
    _mesa_hash_table_destroy(table->ht, NULL);
+   for (unsigned i = 0; i < MESA_HASH_DIRECT_CHUNKS; i++)
+      free(table->Direct[i]);
    if (table->id_alloc) {
       util_idalloc_fini(table->id_alloc);
       free(table->id_alloc);
@@ -142,6 +145,38 @@ _mesa_HashLookup_unlocked(struct _mesa_HashTable *table, GLuint key)
 }
 
 
+/**
+ * Store \p data in the direct array slot of \p key, allocating the chunk if
+ * needed.  Must be called with the mutex held.
+ */
+static void
+direct_set(struct _mesa_HashTable *table, GLuint key, void *data)
+{
+   void **chunk = table->Direct[key / MESA_HASH_DIRECT_CHUNK_SIZE];
+
+   if (!chunk) {
+      if (!data)
+         return;
+
+      chunk = calloc(MESA_HASH_DIRECT_CHUNK_SIZE, sizeof(void *));
+      if (!chunk)
+         return;
+
+      /* Pick up names inserted while an earlier allocation of this chunk
+       * failed.
+       */
+      GLuint base = key - key % MESA_HASH_DIRECT_CHUNK_SIZE;
+      for (unsigned i = 0; i < MESA_HASH_DIRECT_CHUNK_SIZE; i++) {
+         if (base + i != 0)
+            chunk[i] = _mesa_HashLookup_unlocked(table, base + i);
+      }
+
+      p_atomic_set(&table->Direct[key / MESA_HASH_DIRECT_CHUNK_SIZE], chunk);
+   }
+
+   p_atomic_set(&chunk[key % MESA_HASH_DIRECT_CHUNK_SIZE], data);
+}
+
 /**
  * Lookup an entry in the hash table.
  * 
@@ -154,6 +189,19 @@ void *
 _mesa_HashLookup(struct _mesa_HashTable *table, GLuint key)
 {
    void *res;
+
+   /* Small names are served from the direct array without the mutex.  A
+    * missing chunk either means the name was never inserted or that
+    * allocating the chunk failed, so only then fall back to the locked
+    * lookup.
+    */
+   if (key < MESA_HASH_DIRECT_KEYS) {
+      void **chunk =
+         p_atomic_read(&table->Direct[key / MESA_HASH_DIRECT_CHUNK_SIZE]);
+      if (chunk)
+         return p_atomic_read(&chunk[key % MESA_HASH_DIRECT_CHUNK_SIZE]);
+   }
+
    _mesa_HashLockMutex(table);
    res = _mesa_HashLookup_unlocked(table, key);
    _mesa_HashUnlockMutex(table);
@@ -191,6 +239,9 @@ _mesa_HashInsert_unlocked(struct _mesa_HashTable *table, GLuint key, void *data)
    if (key > table->MaxKey)
       table->MaxKey = key;
 
+   if (key < MESA_HASH_DIRECT_KEYS)
+      direct_set(table, key, data);
+
    if (key == DELETED_KEY_VALUE) {
       table->deleted_key_data = data;
    } else {
@@ -271,6 +322,9 @@ _mesa_HashRemove_unlocked(struct _mesa_HashTable *table, GLuint key)
    assert(!table->InDeleteAll);
    #endif
 
+   if (key < MESA_HASH_DIRECT_KEYS)
+      direct_set(table, key, NULL);
+
    if (key == DELETED_KEY_VALUE) {
       table->deleted_key_data = NULL;
    } else {
@@ -326,6 +380,12 @@ _mesa_HashDeleteAll(struct _mesa_HashTable *table,
       callback(table->deleted_key_data, userData);
       table->deleted_key_data = NULL;
    }
+   for (unsigned i = 0; i < MESA_HASH_DIRECT_CHUNKS; i++) {
+      if (table->Direct[i]) {
+         for (unsigned j = 0; j < MESA_HASH_DIRECT_CHUNK_SIZE; j++)
+            p_atomic_set(&table->Direct[i][j], NULL);
+      }
+   }
    if (table->id_alloc) {
       util_idalloc_fini(table->id_alloc);
       free(table->id_alloc);
@@ -98,11 +98,24 @@ uint_key(GLuint id)
 }
 /** @} */
 
+/** @{
+ * Object names below MESA_HASH_DIRECT_KEYS are also stored in a two-level
+ * array indexed by the name, which _mesa_HashLookup() reads without taking
+ * the mutex.  Chunks are allocated on first insertion and only freed with
+ * the table, so a chunk pointer never changes once it's non-NULL.
+ */
+#define MESA_HASH_DIRECT_CHUNK_SIZE 1024
+#define MESA_HASH_DIRECT_CHUNKS 64
+#define MESA_HASH_DIRECT_KEYS \
+   (MESA_HASH_DIRECT_CHUNK_SIZE * MESA_HASH_DIRECT_CHUNKS)
+/** @} */
+
 /**
  * The hash table data structure.
  */
 struct _mesa_HashTable {
    struct hash_table *ht;
+   void **Direct[MESA_HASH_DIRECT_CHUNKS]; /**< see MESA_HASH_DIRECT_KEYS */
    GLuint MaxKey;                        /**< highest key inserted so far */
    simple_mtx_t Mutex;                   /**< mutual exclusion lock */
    /* Used when name reuse is enabled */
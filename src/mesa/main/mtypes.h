@@ -2935,6 +2935,10 @@ struct gl_dlist_state
        * list.  Used to eliminate some redundant state changes.
        */
       GLenum16 ShadeModel;
+      GLfloat LineWidth;
+      GLfloat PointSize;
+      GLbitfield EnableKnown;   /**< DLIST_ENABLE_* caps with known state */
+      GLbitfield EnableValue;   /**< their state, if known */
       bool UseLoopback;
    } Current;
 };
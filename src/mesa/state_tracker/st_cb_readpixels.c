@@ -304,9 +304,23 @@ blit_to_staging(struct st_context *st, struct gl_renderbuffer *rb,
                                    &dst_templ.width0, &dst_templ.height0,
                                    &dst_templ.depth0, &dst_templ.array_size);
 
-   dst = screen->resource_create(screen, &dst_templ);
-   if (!dst)
-      return NULL;
+   /* Apps that read back every frame ask for the same region over and over,
+    * so keep the last staging texture around.  Whoever used it last mapped
+    * it for reading, so once nobody else holds a reference the GPU is done
+    * with it and it can be blitted to again without allocating.
+    */
+   dst = st->readpix_cache.staging;
+   if (dst && p_atomic_read(&dst->reference.count) == 1 &&
+       dst->format == dst_templ.format && dst->bind == dst_templ.bind &&
+       dst->width0 >= dst_templ.width0 && dst->height0 >= dst_templ.height0) {
+      dst = NULL;
+      pipe_resource_reference(&dst, st->readpix_cache.staging);
+   } else {
+      dst = screen->resource_create(screen, &dst_templ);
+      if (!dst)
+         return NULL;
+      pipe_resource_reference(&st->readpix_cache.staging, dst);
+   }
 
    memset(&blit, 0, sizeof(blit));
    blit.src.resource = rb->texture;
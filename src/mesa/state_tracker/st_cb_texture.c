@@ -69,6 +69,7 @@
 
 #include "pipe/p_context.h"
 #include "pipe/p_defines.h"
+#include "util/u_cpu_detect.h"
 #include "util/u_inlines.h"
 #include "util/u_upload_mgr.h"
 #include "pipe/p_shader_tokens.h"
@@ -541,6 +542,132 @@ st_MapTextureImage(struct gl_context *ctx,
 }
 
 
+/** Image rows below which decompression isn't worth splitting up */
+#define ST_DECOMPRESS_MIN_ROWS 64
+#define ST_DECOMPRESS_MAX_JOBS 16
+
+struct st_decompress_job {
+   struct util_queue_fence fence;
+   mesa_format format;
+   bool bgra;
+   uint8_t *dst;
+   unsigned dst_stride;
+   const uint8_t *src;
+   unsigned src_stride;
+   unsigned width;
+   unsigned height;
+};
+
+static void
+decompress_rows(mesa_format format, bool bgra,
+                uint8_t *dst, unsigned dst_stride,
+                const uint8_t *src, unsigned src_stride,
+                unsigned width, unsigned height)
+{
+   if (format == MESA_FORMAT_ETC1_RGB8) {
+      _mesa_etc1_unpack_rgba8888(dst, dst_stride, src, src_stride,
+                                 width, height);
+   } else if (_mesa_is_format_etc2(format)) {
+      _mesa_unpack_etc2_format(dst, dst_stride, src, src_stride,
+                               width, height, format, bgra);
+   } else if (_mesa_is_format_astc_2d(format)) {
+      _mesa_unpack_astc_2d_ldr(dst, dst_stride, src, src_stride,
+                               width, height, format);
+   } else if (_mesa_is_format_s3tc(format)) {
+      _mesa_unpack_s3tc(dst, dst_stride, src, src_stride,
+                        width, height, format);
+   } else if (_mesa_is_format_rgtc(format) ||
+              _mesa_is_format_latc(format)) {
+      _mesa_unpack_rgtc(dst, dst_stride, src, src_stride,
+                        width, height, format);
+   } else if (_mesa_is_format_bptc(format)) {
+      _mesa_unpack_bptc(dst, dst_stride, src, src_stride,
+                        width, height, format);
+   } else {
+      unreachable("unexpected format for a compressed format fallback");
+   }
+}
+
+static void
+decompress_job_execute(void *data, void *gdata, int thread_index)
+{
+   struct st_decompress_job *job = data;
+
+   decompress_rows(job->format, job->bgra, job->dst, job->dst_stride,
+                   job->src, job->src_stride, job->width, job->height);
+}
+
+/**
+ * Decode a compressed image whose format the driver doesn't support.
+ *
+ * \param src_stride  bytes per row of blocks
+ *
+ * Large images are split into bands of whole block rows which are
+ * decoded in parallel; the decoders keep no state between blocks.
+ */
+static void
+st_decompress_fallback(struct st_context *st, mesa_format format, bool bgra,
+                       uint8_t *dst, unsigned dst_stride,
+                       const uint8_t *src, unsigned src_stride,
+                       unsigned width, unsigned height)
+{
+   unsigned bw, bh;
+   _mesa_get_format_block_size(format, &bw, &bh);
+
+   unsigned band = MAX2(DIV_ROUND_UP(height, ST_DECOMPRESS_MAX_JOBS),
+                        ST_DECOMPRESS_MIN_ROWS);
+   band = DIV_ROUND_UP(band, bh) * bh;
+   unsigned num_jobs = DIV_ROUND_UP(height, band);
+
+   if (num_jobs > 1 && !util_queue_is_initialized(&st->decompress_queue)) {
+      unsigned num_threads = MIN2(util_get_cpu_caps()->nr_cpus,
+                                  ST_DECOMPRESS_MAX_JOBS) - 1;
+
+      if (num_threads)
+         util_queue_init(&st->decompress_queue, "st_decomp",
+                         ST_DECOMPRESS_MAX_JOBS, num_threads,
+                         UTIL_QUEUE_INIT_RESIZE_IF_FULL, NULL);
+   }
+
+   if (num_jobs <= 1 || !util_queue_is_initialized(&st->decompress_queue)) {
+      decompress_rows(format, bgra, dst, dst_stride, src, src_stride,
+                      width, height);
+      return;
+   }
+
+   struct st_decompress_job jobs[ST_DECOMPRESS_MAX_JOBS];
+
+   for (unsigned i = 0; i < num_jobs; i++) {
+      unsigned y = i * band;
+
+      jobs[i] = (struct st_decompress_job) {
+         .format = format,
+         .bgra = bgra,
+         .dst = dst + (size_t)y * dst_stride,
+         .dst_stride = dst_stride,
+         .src = src + (size_t)(y / bh) * src_stride,
+         .src_stride = src_stride,
+         .width = width,
+         .height = MIN2(band, height - y),
+      };
+   }
+
+   /* The calling thread decodes the first band itself. */
+   for (unsigned i = 1; i < num_jobs; i++) {
+      util_queue_fence_init(&jobs[i].fence);
+      util_queue_add_job(&st->decompress_queue, &jobs[i], &jobs[i].fence,
+                         decompress_job_execute, NULL, 0);
+   }
+
+   decompress_job_execute(&jobs[0], NULL, 0);
+
+   for (unsigned i = 1; i < num_jobs; i++) {
+      util_queue_fence_wait(&jobs[i].fence);
+      util_queue_fence_destroy(&jobs[i].fence);
+   }
+}
+
+
 void
 st_UnmapTextureImage(struct gl_context *ctx,
                      struct gl_texture_image *texImage,
@@ -574,6 +701,8 @@ st_UnmapTextureImage(struct gl_context *ctx,
 
          assert(z == transfer->box.z);
 
+         bool bgra = texImage->pt->format == PIPE_FORMAT_B8G8R8A8_SRGB;
+
          if (util_format_is_compressed(texImage->pt->format)) {
             /* Transcode into a different compressed format. */
             unsigned size =
@@ -583,32 +712,12 @@ st_UnmapTextureImage(struct gl_context *ctx,
             void *tmp = malloc(size);
 
             /* Decompress to tmp. */
-            if (texImage->TexFormat == MESA_FORMAT_ETC1_RGB8) {
-               _mesa_etc1_unpack_rgba8888(tmp, transfer->box.width * 4,
-                                          itransfer->temp_data,
-                                          itransfer->temp_stride,
-                                          transfer->box.width,
-                                          transfer->box.height);
-            } else if (_mesa_is_format_etc2(texImage->TexFormat)) {
-               bool bgra = texImage->pt->format == PIPE_FORMAT_B8G8R8A8_SRGB;
-
-               _mesa_unpack_etc2_format(tmp, transfer->box.width * 4,
-                                        itransfer->temp_data,
-                                        itransfer->temp_stride,
-                                        transfer->box.width,
-                                        transfer->box.height,
-                                        texImage->TexFormat,
-                                        bgra);
-            } else if (_mesa_is_format_astc_2d(texImage->TexFormat)) {
-               _mesa_unpack_astc_2d_ldr(tmp, transfer->box.width * 4,
-                                        itransfer->temp_data,
-                                        itransfer->temp_stride,
-                                        transfer->box.width,
-                                        transfer->box.height,
-                                        texImage->TexFormat);
-            } else {
-               unreachable("unexpected format for a compressed format fallback");
-            }
+            st_decompress_fallback(st, texImage->TexFormat, bgra,
+                                   tmp, transfer->box.width * 4,
+                                   itransfer->temp_data,
+                                   itransfer->temp_stride,
+                                   transfer->box.width,
+                                   transfer->box.height);
 
             /* Compress it to the target format. */
             struct gl_pixelstore_attrib pack = {0};
@@ -622,49 +731,12 @@ st_UnmapTextureImage(struct gl_context *ctx,
             free(tmp);
          } else {
             /* Decompress into an uncompressed format. */
-            if (texImage->TexFormat == MESA_FORMAT_ETC1_RGB8) {
-               _mesa_etc1_unpack_rgba8888(map, transfer->stride,
-                                          itransfer->temp_data,
-                                          itransfer->temp_stride,
-                                          transfer->box.width,
-                                          transfer->box.height);
-            } else if (_mesa_is_format_etc2(texImage->TexFormat)) {
-               bool bgra = texImage->pt->format == PIPE_FORMAT_B8G8R8A8_SRGB;
-
-               _mesa_unpack_etc2_format(map, transfer->stride,
-                                        itransfer->temp_data,
-                                        itransfer->temp_stride,
-                                        transfer->box.width, transfer->box.height,
-                                        texImage->TexFormat,
-                                        bgra);
-            } else if (_mesa_is_format_astc_2d(texImage->TexFormat)) {
-               _mesa_unpack_astc_2d_ldr(map, transfer->stride,
-                                        itransfer->temp_data,
-                                        itransfer->temp_stride,
-                                        transfer->box.width, transfer->box.height,
-                                        texImage->TexFormat);
-            } else if (_mesa_is_format_s3tc(texImage->TexFormat)) {
-               _mesa_unpack_s3tc(map, transfer->stride,
-                                 itransfer->temp_data,
-                                 itransfer->temp_stride,
-                                 transfer->box.width, transfer->box.height,
-                                 texImage->TexFormat);
-            } else if (_mesa_is_format_rgtc(texImage->TexFormat) ||
-                       _mesa_is_format_latc(texImage->TexFormat)) {
-               _mesa_unpack_rgtc(map, transfer->stride,
-                                 itransfer->temp_data,
-                                 itransfer->temp_stride,
-                                 transfer->box.width, transfer->box.height,
-                                 texImage->TexFormat);
-            } else if (_mesa_is_format_bptc(texImage->TexFormat)) {
-               _mesa_unpack_bptc(map, transfer->stride,
-                                 itransfer->temp_data,
-                                 itransfer->temp_stride,
-                                 transfer->box.width, transfer->box.height,
-                                 texImage->TexFormat);
-            } else {
-               unreachable("unexpected format for a compressed format fallback");
-            }
+            st_decompress_fallback(st, texImage->TexFormat, bgra,
+                                   map, transfer->stride,
+                                   itransfer->temp_data,
+                                   itransfer->temp_stride,
+                                   transfer->box.width,
+                                   transfer->box.height);
          }
 
          st_texture_image_unmap(st, texImage, slice);
@@ -1647,6 +1719,7 @@ try_pbo_upload(struct gl_context *ctx, GLuint dims,
    struct pipe_context *pipe = st->pipe;
    struct pipe_screen *screen = st->screen;
    struct pipe_surface *surface = NULL;
+   struct pipe_resource *staging = NULL;
    struct st_pbo_addresses addr;
    enum pipe_format src_format;
    const struct util_format_description *desc;
@@ -1656,6 +1729,12 @@ try_pbo_upload(struct gl_context *ctx, GLuint dims,
    if (!st->pbo.upload_enabled)
       return false;
 
+   /* The shader only does the format conversion. */
+   if (!unpack->BufferObj &&
+       _mesa_texstore_needs_transfer_ops(ctx, texImage->_BaseFormat,
+                                         texImage->TexFormat))
+      return false;
+
    /* From now on, we need the gallium representation of dimensions. */
    if (gl_target == GL_TEXTURE_1D_ARRAY) {
       depth = height;
@@ -1714,9 +1793,15 @@ try_pbo_upload(struct gl_context *ctx, GLuint dims,
    addr.depth = depth;
    addr.bytes_per_pixel = desc->block.bits / 8;
 
-   if (!st_pbo_addresses_pixelstore(st, gl_target, dims == 3, unpack, pixels,
-                                    &addr))
-      return false;
+   if (unpack->BufferObj) {
+      if (!st_pbo_addresses_pixelstore(st, gl_target, dims == 3, unpack,
+                                       pixels, &addr))
+         return false;
+   } else {
+      if (!st_pbo_addresses_client_memory(st, gl_target, dims == 3, unpack,
+                                          pixels, &addr, &staging))
+         return false;
+   }
 
    /* Set up the surface */
    {
@@ -1734,13 +1819,16 @@ try_pbo_upload(struct gl_context *ctx, GLuint dims,
       templ.u.tex.last_layer = MIN2(zoffset + depth - 1, max_layer);
 
       surface = pipe->create_surface(pipe, texture, &templ);
-      if (!surface)
+      if (!surface) {
+         pipe_resource_reference(&staging, NULL);
          return false;
+      }
    }
 
    success = try_pbo_upload_common(ctx, surface, &addr, src_format);
 
    pipe_surface_reference(&surface, NULL);
+   pipe_resource_reference(&staging, NULL);
 
    return success;
 }
@@ -2046,6 +2134,17 @@ st_TexSubImage(struct gl_context *ctx, GLuint dims,
       goto fallback;
    }
 
+   /* Convert client memory on the GPU too: streaming the pixels into a
+    * buffer avoids creating a staging texture for every upload, and after
+    * that it's the same as a PBO upload.
+    */
+   if (!unpack->BufferObj && pixels) {
+      if (try_pbo_upload(ctx, dims, texImage, format, type, dst_format,
+                         xoffset, yoffset, zoffset,
+                         width, height, depth, pixels, unpack))
+         return;
+   }
+
    /* Choose the source format. */
    src_format = st_choose_matching_format(st, PIPE_BIND_SAMPLER_VIEW,
                                           format, type, unpack->SwapBytes);
@@ -383,8 +383,12 @@ st_destroy_context_priv(struct st_context *st, bool destroy_pipe)
 
    /* free glReadPixels cache data */
    st_invalidate_readpix_cache(st);
+   pipe_resource_reference(&st->readpix_cache.staging, NULL);
    util_throttle_deinit(st->screen, &st->throttle);
 
+   if (util_queue_is_initialized(&st->decompress_queue))
+      util_queue_destroy(&st->decompress_queue);
+
    cso_destroy_context(st->cso_context);
 
    if (st->pipe && destroy_pipe)
@@ -35,6 +35,7 @@
 #include "state_tracker/st_atom.h"
 #include "util/u_helpers.h"
 #include "util/u_inlines.h"
+#include "util/u_queue.h"
 #include "util/list.h"
 #include "vbo/vbo.h"
 #include "util/list.h"
@@ -188,6 +189,11 @@ struct st_context
     */
    boolean shader_has_one_variant[MESA_SHADER_STAGES];
 
+   /* Set while creating the variants predicted by the shader cache, so that
+    * they aren't recorded again. See st_precompile_predicted_variants.
+    */
+   boolean predicting_shader_variants;
+
    boolean needs_texcoord_semantic;
    boolean apply_texture_swizzle_to_border_color;
    boolean use_format_with_border_color;
@@ -308,6 +314,8 @@ struct st_context
       unsigned level;
       unsigned layer;
       unsigned hits;
+      /** Staging texture of the last uncached read, for reuse */
+      struct pipe_resource *staging;
    } readpix_cache;
 
    /** for glClear */
@@ -336,6 +344,8 @@ struct st_context
        */
       void *download_fs[5][PIPE_MAX_TEXTURE_TYPES][2];
       struct hash_table *shaders;
+      /** Staging ring for uploading pixels from client memory */
+      struct u_upload_mgr *uploader;
       bool upload_enabled;
       bool download_enabled;
       bool rgba_only;
@@ -343,6 +353,9 @@ struct st_context
       bool use_gs;
    } pbo;
 
+   /** Worker threads for decoding compressed formats the driver lacks */
+   struct util_queue decompress_queue;
+
    /** for drawing with st_util_vertex */
    struct cso_velems_state util_velems;
 
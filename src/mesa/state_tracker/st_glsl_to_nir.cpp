@@ -363,7 +363,7 @@ st_nir_preprocess(struct st_context *st, struct gl_program *prog,
        * desktop GLSL, so it will fail to compile (below) anyway.
        */
       if (_mesa_is_desktop_gl(st->ctx) && st->ctx->Const.GLSLVersion >= 400)
-         st->ctx->SoftFP64 = glsl_float64_funcs_to_nir(st->ctx, options);
+         st->ctx->SoftFP64 = st_get_soft_fp64(st, options);
    }
 
    prog->skip_pointsize_xfb = !(nir->info.outputs_written & VARYING_BIT_PSIZ);
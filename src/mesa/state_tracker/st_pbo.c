@@ -39,6 +39,7 @@
 #include "cso_cache/cso_context.h"
 #include "tgsi/tgsi_ureg.h"
 #include "util/format/u_format.h"
+#include "util/u_helpers.h"
 #include "util/u_inlines.h"
 #include "util/u_upload_mgr.h"
 
@@ -99,22 +100,15 @@ st_pbo_addresses_setup(struct st_context *st,
  * Returns false if some aspect of the addressing (e.g. alignment) prevents
  * PBO upload/download.
  */
-bool
-st_pbo_addresses_pixelstore(struct st_context *st,
-                            GLenum gl_target, bool skip_images,
-                            const struct gl_pixelstore_attrib *store,
-                            const void *pixels,
-                            struct st_pbo_addresses *addr)
+/* Fill in the row and image pitches of addr from the GL pixelstore
+ * attributes and return the offset of the first texel, in texels, relative
+ * to the start of the image.
+ */
+static bool
+pixelstore_layout(GLenum gl_target, bool skip_images,
+                  const struct gl_pixelstore_attrib *store,
+                  struct st_pbo_addresses *addr, intptr_t *texel_offset)
 {
-   struct pipe_resource *buf = store->BufferObj->buffer;
-   intptr_t buf_offset = (intptr_t) pixels;
-
-   if (buf_offset % addr->bytes_per_pixel)
-      return false;
-
-   /* Convert to texels */
-   buf_offset = buf_offset / addr->bytes_per_pixel;
-
    /* Determine image height */
    if (gl_target == GL_TEXTURE_1D_ARRAY) {
       addr->image_height = 1;
@@ -142,9 +136,40 @@ st_pbo_addresses_pixelstore(struct st_context *st,
        if (skip_images)
           offset_rows += addr->image_height * store->SkipImages;
 
-       buf_offset += store->SkipPixels + addr->pixels_per_row * offset_rows;
+       *texel_offset = store->SkipPixels + addr->pixels_per_row * offset_rows;
    }
 
+   return true;
+}
+
+/* Validate and fill buffer addressing information based on GL pixelstore
+ * attributes.
+ *
+ * Returns false if some aspect of the addressing (e.g. alignment) prevents
+ * PBO upload/download.
+ */
+bool
+st_pbo_addresses_pixelstore(struct st_context *st,
+                            GLenum gl_target, bool skip_images,
+                            const struct gl_pixelstore_attrib *store,
+                            const void *pixels,
+                            struct st_pbo_addresses *addr)
+{
+   struct pipe_resource *buf = store->BufferObj->buffer;
+   intptr_t buf_offset = (intptr_t) pixels;
+   intptr_t skip;
+
+   if (buf_offset % addr->bytes_per_pixel)
+      return false;
+
+   /* Convert to texels */
+   buf_offset = buf_offset / addr->bytes_per_pixel;
+
+   if (!pixelstore_layout(gl_target, skip_images, store, addr, &skip))
+      return false;
+
+   buf_offset += skip;
+
    if (!st_pbo_addresses_setup(st, buf, buf_offset, addr))
       return false;
 
@@ -157,6 +182,68 @@ st_pbo_addresses_pixelstore(struct st_context *st,
    return true;
 }
 
+/* Like st_pbo_addresses_pixelstore, but for pixels in client memory: the
+ * texels covered by the transfer are copied into a streaming buffer, which
+ * is returned in *buf and must be released by the caller once the upload
+ * has been recorded.
+ */
+bool
+st_pbo_addresses_client_memory(struct st_context *st,
+                               GLenum gl_target, bool skip_images,
+                               const struct gl_pixelstore_attrib *store,
+                               const void *pixels,
+                               struct st_pbo_addresses *addr,
+                               struct pipe_resource **buf)
+{
+   unsigned alignment = st->ctx->Const.TextureBufferOffsetAlignment;
+   unsigned offset;
+   intptr_t skip;
+
+   *buf = NULL;
+
+   if (!pixelstore_layout(gl_target, skip_images, store, addr, &skip))
+      return false;
+
+   uint64_t num_texels = addr->width +
+      (addr->height - 1 + (addr->depth - 1) * (uint64_t)addr->image_height) *
+      addr->pixels_per_row;
+   if (num_texels > st->ctx->Const.MaxTextureBufferSize)
+      return false;
+
+   if (!st->pbo.uploader) {
+      st->pbo.uploader = u_upload_create(st->pipe, 1024 * 1024,
+                                         PIPE_BIND_SAMPLER_VIEW,
+                                         PIPE_USAGE_STREAM, 0);
+      if (!st->pbo.uploader)
+         return false;
+   }
+
+   util_throttle_memory_usage(st->pipe, &st->throttle,
+                              num_texels * addr->bytes_per_pixel);
+
+   /* Keep the offset a multiple of the texel size as well, so that it can
+    * be expressed in texels.
+    */
+   if (alignment % addr->bytes_per_pixel)
+      alignment *= addr->bytes_per_pixel;
+
+   u_upload_data(st->pbo.uploader, 0, num_texels * addr->bytes_per_pixel,
+                 alignment,
+                 (const uint8_t *)pixels + skip * addr->bytes_per_pixel,
+                 &offset, buf);
+   u_upload_unmap(st->pbo.uploader);
+   if (!*buf)
+      return false;
+
+   if (!st_pbo_addresses_setup(st, *buf, offset / addr->bytes_per_pixel,
+                               addr)) {
+      pipe_resource_reference(buf, NULL);
+      return false;
+   }
+
+   return true;
+}
+
 /* For download from a framebuffer, we may have to invert the Y axis. The
  * setup is as follows:
  * - set viewport to inverted, so that the position sysval is correct for
@@ -745,5 +832,10 @@ st_destroy_pbo_helpers(struct st_context *st)
       st->pbo.vs = NULL;
    }
 
+   if (st->pbo.uploader) {
+      u_upload_destroy(st->pbo.uploader);
+      st->pbo.uploader = NULL;
+   }
+
    st_pbo_compute_deinit(st);
 }
@@ -84,6 +84,14 @@ st_pbo_addresses_pixelstore(struct st_context *st,
                             const void *pixels,
                             struct st_pbo_addresses *addr);
 
+bool
+st_pbo_addresses_client_memory(struct st_context *st,
+                               GLenum gl_target, bool skip_images,
+                               const struct gl_pixelstore_attrib *store,
+                               const void *pixels,
+                               struct st_pbo_addresses *addr,
+                               struct pipe_resource **buf);
+
 void
 st_pbo_addresses_invert_y(struct st_pbo_addresses *addr,
                           unsigned viewport_height);
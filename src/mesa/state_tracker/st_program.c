@@ -817,6 +817,7 @@ st_get_common_variant(struct st_context *st,
          }
 
          st_add_variant(&prog->variants, &v->base);
+         st_record_shader_variants(st, prog);
       }
    }
 
@@ -1103,6 +1104,7 @@ st_get_fp_variant(struct st_context *st,
          fpv->base.st = key->st;
 
          st_add_variant(&fp->variants, &fpv->base);
+         st_record_shader_variants(st, fp);
       }
    }
 
@@ -1332,6 +1334,9 @@ st_finalize_program(struct st_context *st, struct gl_program *prog)
 
    /* Always create the default variant of the program. */
    st_precompile_shader_variant(st, prog);
+
+   /* Also create the variants that previous runs needed at draw time. */
+   st_precompile_predicted_variants(st, prog);
 }
 
 /**
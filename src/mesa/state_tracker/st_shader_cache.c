@@ -26,6 +26,7 @@
 #include "st_program.h"
 #include "st_shader_cache.h"
 #include "st_util.h"
+#include "compiler/glsl/glsl_to_nir.h"
 #include "compiler/glsl/program.h"
 #include "compiler/nir/nir.h"
 #include "compiler/nir/nir_serialize.h"
@@ -137,6 +138,228 @@ read_stream_out_from_cache(struct blob_reader *blob_reader,
    }
 }
 
+/* Shader variant prediction
+ *
+ * Variants that depend on GL state are normally only discovered at draw
+ * time, and compiling them there stalls the draw. The keys of all variants
+ * of a GLSL program are recorded in the disk cache, and when the program is
+ * linked in a later run, the recorded variants are created right away.
+ */
+#define ST_MAX_PREDICTED_VARIANTS 16
+
+static bool
+get_variant_list_cache_key(struct st_context *st, struct gl_program *prog,
+                           cache_key key)
+{
+   if (!st->ctx->Cache || !prog->shader_program ||
+       st->shader_has_one_variant[prog->info.stage])
+      return false;
+
+   /* Same as st_store_nir_in_disk_cache. */
+   const uint8_t *program_sha1 = prog->shader_program->data->sha1;
+   static const uint8_t zero[SHA1_DIGEST_LENGTH] = {0};
+   if (memcmp(program_sha1, zero, sizeof(zero)) == 0)
+      return false;
+
+   uint8_t stage = prog->info.stage;
+   struct mesa_sha1 ctx;
+   unsigned char sha1[SHA1_DIGEST_LENGTH];
+
+   _mesa_sha1_init(&ctx);
+   _mesa_sha1_update(&ctx, "st variant keys", 15);
+   _mesa_sha1_update(&ctx, program_sha1, SHA1_DIGEST_LENGTH);
+   _mesa_sha1_update(&ctx, &stage, sizeof(stage));
+   _mesa_sha1_final(&ctx, sha1);
+
+   disk_cache_compute_key(st->ctx->Cache, sha1, sizeof(sha1), key);
+   return true;
+}
+
+static unsigned
+get_variant_key_size(struct gl_program *prog)
+{
+   return prog->info.stage == MESA_SHADER_FRAGMENT ?
+            sizeof(struct st_fp_variant_key) :
+            sizeof(struct st_common_variant_key);
+}
+
+/**
+ * Store the keys of all variants of the program in the disk cache.
+ * Called when a new variant is created.
+ */
+void
+st_record_shader_variants(struct st_context *st, struct gl_program *prog)
+{
+   cache_key cache_key;
+
+   /* The first variant is always precompiled. */
+   if (st->predicting_shader_variants || !prog->variants->next ||
+       !get_variant_list_cache_key(st, prog, cache_key))
+      return;
+
+   unsigned key_size = get_variant_key_size(prog);
+   unsigned count = 0;
+   struct blob blob;
+   blob_init(&blob);
+
+   blob_write_uint32(&blob, key_size);
+   size_t count_offset = blob_reserve_uint32(&blob);
+
+   /* Keys are compared with memcmp, so copy them with memcpy to preserve
+    * the padding.
+    */
+   for (struct st_variant *v = prog->variants;
+        v && count < ST_MAX_PREDICTED_VARIANTS; v = v->next) {
+      if (prog->info.stage == MESA_SHADER_FRAGMENT) {
+         struct st_fp_variant_key key;
+         memcpy(&key, &st_fp_variant(v)->key, sizeof(key));
+         key.st = NULL;
+         blob_write_bytes(&blob, &key, sizeof(key));
+      } else {
+         struct st_common_variant_key key;
+         memcpy(&key, &st_common_variant(v)->key, sizeof(key));
+         /* Draw module shaders are created on demand. */
+         if (key.is_draw_shader)
+            continue;
+         key.st = NULL;
+         blob_write_bytes(&blob, &key, sizeof(key));
+      }
+      count++;
+   }
+
+   blob_overwrite_uint32(&blob, count_offset, count);
+
+   if (!blob.out_of_memory)
+      disk_cache_put(st->ctx->Cache, cache_key, blob.data, blob.size, NULL);
+
+   blob_finish(&blob);
+}
+
+/**
+ * Create the variants recorded by st_record_shader_variants in a previous
+ * run. Drivers with asynchronous shader compilation compile them in the
+ * background, so they are usually ready by the time of the first draw.
+ */
+void
+st_precompile_predicted_variants(struct st_context *st,
+                                 struct gl_program *prog)
+{
+   cache_key cache_key;
+
+   if (!get_variant_list_cache_key(st, prog, cache_key))
+      return;
+
+   size_t size;
+   void *buffer = disk_cache_get(st->ctx->Cache, cache_key, &size);
+   if (!buffer)
+      return;
+
+   struct blob_reader blob_reader;
+   blob_reader_init(&blob_reader, buffer, size);
+
+   unsigned key_size = blob_read_uint32(&blob_reader);
+   unsigned count = blob_read_uint32(&blob_reader);
+
+   if (key_size != get_variant_key_size(prog) ||
+       count > ST_MAX_PREDICTED_VARIANTS) {
+      free(buffer);
+      return;
+   }
+
+   struct st_context *key_st = st->has_shareable_shaders ? NULL : st;
+
+   st->predicting_shader_variants = true;
+
+   for (unsigned i = 0; i < count && !blob_reader.overrun; i++) {
+      if (prog->info.stage == MESA_SHADER_FRAGMENT) {
+         struct st_fp_variant_key key;
+         blob_copy_bytes(&blob_reader, &key, sizeof(key));
+         key.st = key_st;
+         if (!blob_reader.overrun)
+            st_get_fp_variant(st, prog, &key);
+      } else {
+         struct st_common_variant_key key;
+         blob_copy_bytes(&blob_reader, &key, sizeof(key));
+         key.st = key_st;
+         if (!blob_reader.overrun)
+            st_get_common_variant(st, prog, &key);
+      }
+   }
+
+   st->predicting_shader_variants = false;
+
+   if (st->ctx->_Shader->Flags & GLSL_CACHE_INFO) {
+      fprintf(stderr, "precompiled %u predicted %s shader variants\n", count,
+              _mesa_shader_stage_to_string(prog->info.stage));
+   }
+
+   free(buffer);
+}
+
+/**
+ * Return the NIR library used to lower doubles in software, loading it from
+ * the disk cache if a previous run stored it.  Building it means compiling
+ * a large GLSL source with the whole front-end, on the first link of every
+ * context that uses doubles.
+ */
+nir_shader *
+st_get_soft_fp64(struct st_context *st,
+                 const nir_shader_compiler_options *options)
+{
+   struct disk_cache *cache = st->ctx->Cache;
+   cache_key cache_key;
+   nir_shader *nir;
+
+   if (cache) {
+      /* The library only depends on the Mesa build, which the cache key
+       * already covers, and on the NIR options.  Drop the callback so the
+       * key doesn't change between runs.
+       */
+      nir_shader_compiler_options key_options;
+      memcpy(&key_options, options, sizeof(key_options));
+      key_options.lower_to_scalar_filter = NULL;
+
+      struct mesa_sha1 ctx;
+      unsigned char sha1[SHA1_DIGEST_LENGTH];
+
+      _mesa_sha1_init(&ctx);
+      _mesa_sha1_update(&ctx, "st soft fp64", 12);
+      _mesa_sha1_update(&ctx, &key_options, sizeof(key_options));
+      _mesa_sha1_final(&ctx, sha1);
+
+      disk_cache_compute_key(cache, sha1, sizeof(sha1), cache_key);
+
+      size_t size;
+      void *buffer = disk_cache_get(cache, cache_key, &size);
+      if (buffer) {
+         struct blob_reader blob_reader;
+         blob_reader_init(&blob_reader, buffer, size);
+         nir = nir_deserialize(NULL, options, &blob_reader);
+         free(buffer);
+
+         if (nir && !blob_reader.overrun) {
+            if (st->ctx->_Shader->Flags & GLSL_CACHE_INFO)
+               fprintf(stderr, "soft fp64 library retrieved from cache\n");
+            return nir;
+         }
+         ralloc_free(nir);
+      }
+   }
+
+   nir = glsl_float64_funcs_to_nir(st->ctx, options);
+
+   if (nir && cache) {
+      struct blob blob;
+      blob_init(&blob);
+      nir_serialize(&blob, nir, false);
+      if (!blob.out_of_memory)
+         disk_cache_put(cache, cache_key, blob.data, blob.size, NULL);
+      blob_finish(&blob);
+   }
+
+   return nir;
+}
+
 void
 st_deserialise_nir_program(struct gl_context *ctx,
                           struct gl_shader_program *shProg,
@@ -70,6 +70,17 @@ st_load_nir_from_disk_cache(struct gl_context *ctx,
 void
 st_store_nir_in_disk_cache(struct st_context *st, struct gl_program *prog);
 
+void
+st_record_shader_variants(struct st_context *st, struct gl_program *prog);
+
+void
+st_precompile_predicted_variants(struct st_context *st,
+                                 struct gl_program *prog);
+
+struct nir_shader *
+st_get_soft_fp64(struct st_context *st,
+                 const struct nir_shader_compiler_options *options);
+
 #ifdef __cplusplus
 }
 #endif
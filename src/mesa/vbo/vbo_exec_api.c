@@ -481,6 +481,41 @@ is_vertex_position(const struct gl_context *ctx, GLuint index)
  * \param C  cast type (uint32_t or uint64_t)
  * \param V0, V1, v2, V3  attribute value
  */
+/**
+ * Copy the current non-position attributes into the vertex buffer and return
+ * the pointer past them.  This runs for every glVertex call, so the layouts
+ * that are common with fixed-function immediate mode (normal, color, normal +
+ * color, normal + texcoord, normal + color + texcoord, ...) get fixed-size
+ * copies the compiler can turn into a couple of vector moves instead of a
+ * dword loop with a variable trip count.
+ */
+static inline uint32_t *
+vbo_copy_vertex_no_pos(uint32_t *restrict dst, const uint32_t *restrict src,
+                       unsigned size)
+{
+#define VBO_COPY_CASE(n) case n: memcpy(dst, src, n * 4); return dst + n
+   switch (size) {
+   case 0:
+      return dst;
+   VBO_COPY_CASE(2);
+   VBO_COPY_CASE(3);
+   VBO_COPY_CASE(4);
+   VBO_COPY_CASE(5);
+   VBO_COPY_CASE(6);
+   VBO_COPY_CASE(7);
+   VBO_COPY_CASE(8);
+   VBO_COPY_CASE(9);
+   VBO_COPY_CASE(11);
+   VBO_COPY_CASE(12);
+   default:
+      for (unsigned i = 0; i < size; i++)
+         *dst++ = *src++;
+      return dst;
+   }
+#undef VBO_COPY_CASE
+}
+
+
 #define ATTR_UNION_BASE(A, N, T, C, V0, V1, V2, V3)                     \
 do {                                                                    \
    struct vbo_exec_context *exec = &vbo_context(ctx)->exec;             \
@@ -515,12 +550,10 @@ do {                                                                    \
       }                                                                 \
                                                                         \
       uint32_t *dst = (uint32_t *)exec->vtx.buffer_ptr;                 \
-      uint32_t *src = (uint32_t *)exec->vtx.vertex;                     \
-      unsigned vertex_size_no_pos = exec->vtx.vertex_size_no_pos;       \
                                                                         \
       /* Copy over attributes from exec. */                             \
-      for (unsigned i = 0; i < vertex_size_no_pos; i++)                 \
-         *dst++ = *src++;                                               \
+      dst = vbo_copy_vertex_no_pos(dst, (uint32_t *)exec->vtx.vertex,   \
+                                   exec->vtx.vertex_size_no_pos);       \
                                                                         \
       /* Store the position, which is always last and can have 32 or */ \
       /* 64 bits per channel. */                                        \
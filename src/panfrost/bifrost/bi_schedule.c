@@ -176,12 +176,17 @@ bi_supports_dtsel(bi_instr *ins)
         }
 }
 
-/* Adds an edge to the dependency graph */
+/* Adds an edge to the dependency graph. The dependents bitsets are quadratic
+ * in the block size, so only allocate them for instructions that actually
+ * have dependents. */
 
 static void
-bi_push_dependency(unsigned parent, unsigned child,
+bi_push_dependency(unsigned parent, unsigned child, unsigned count,
                 BITSET_WORD **dependents, unsigned *dep_counts)
 {
+        if (!dependents[parent])
+                dependents[parent] = calloc(BITSET_WORDS(count), sizeof(BITSET_WORD));
+
         if (!BITSET_TEST(dependents[parent], child)) {
                 BITSET_SET(dependents[parent], child);
                 dep_counts[child]++;
@@ -190,11 +195,11 @@ bi_push_dependency(unsigned parent, unsigned child,
 
 static void
 add_dependency(struct util_dynarray *table, unsigned index, unsigned child,
-                BITSET_WORD **dependents, unsigned *dep_counts)
+                unsigned count, BITSET_WORD **dependents, unsigned *dep_counts)
 {
         assert(index < 64);
         util_dynarray_foreach(table + index, unsigned, parent)
-                bi_push_dependency(*parent, child, dependents, dep_counts);
+                bi_push_dependency(*parent, child, count, dependents, dep_counts);
 }
 
 static void
@@ -226,14 +231,6 @@ bi_create_dependency_graph(struct bi_worklist st, bool inorder, bool is_blend)
                 util_dynarray_init(&last_write[i], NULL);
         }
 
-        /* Initialize dependency graph */
-        for (unsigned i = 0; i < st.count; ++i) {
-                st.dependents[i] =
-                        calloc(BITSET_WORDS(st.count), sizeof(BITSET_WORD));
-
-                st.dep_counts[i] = 0;
-        }
-
         unsigned prev_msg = ~0;
 
         /* Populate dependency graph */
@@ -245,7 +242,7 @@ bi_create_dependency_graph(struct bi_worklist st, bool inorder, bool is_blend)
                         unsigned count = bi_count_read_registers(ins, s);
 
                         for (unsigned c = 0; c < count; ++c)
-                                add_dependency(last_write, ins->src[s].value + c, i, st.dependents, st.dep_counts);
+                                add_dependency(last_write, ins->src[s].value + c, i, st.count, st.dependents, st.dep_counts);
                 }
 
                 /* Keep message-passing ops in order. (This pass only cares
@@ -254,7 +251,7 @@ bi_create_dependency_graph(struct bi_worklist st, bool inorder, bool is_blend)
 
                 if (bi_message_type_for_instr(ins)) {
                         if (prev_msg != ~0)
-                                bi_push_dependency(prev_msg, i, st.dependents, st.dep_counts);
+                                bi_push_dependency(prev_msg, i, st.count, st.dependents, st.dep_counts);
 
                         prev_msg = i;
                 }
@@ -264,7 +261,7 @@ bi_create_dependency_graph(struct bi_worklist st, bool inorder, bool is_blend)
                         for (unsigned j = 0; j < st.count; ++j) {
                                 if (i == j) continue;
 
-                                bi_push_dependency(MAX2(i, j), MIN2(i, j),
+                                bi_push_dependency(MAX2(i, j), MIN2(i, j), st.count,
                                                 st.dependents, st.dep_counts);
                         }
                 }
@@ -276,8 +273,8 @@ bi_create_dependency_graph(struct bi_worklist st, bool inorder, bool is_blend)
                         unsigned count = bi_count_write_registers(ins, d);
 
                         for (unsigned c = 0; c < count; ++c) {
-                                add_dependency(last_read, dest + c, i, st.dependents, st.dep_counts);
-                                add_dependency(last_write, dest + c, i, st.dependents, st.dep_counts);
+                                add_dependency(last_read, dest + c, i, st.count, st.dependents, st.dep_counts);
+                                add_dependency(last_write, dest + c, i, st.count, st.dependents, st.dep_counts);
                                 mark_access(last_write, dest + c, i);
                         }
                 }
@@ -287,8 +284,8 @@ bi_create_dependency_graph(struct bi_worklist st, bool inorder, bool is_blend)
                  */
                 if (ins->op == BI_OPCODE_BLEND && !is_blend) {
                         for (unsigned c = 0; c < 16; ++c) {
-                                add_dependency(last_read, c, i, st.dependents, st.dep_counts);
-                                add_dependency(last_write, c, i, st.dependents, st.dep_counts);
+                                add_dependency(last_read, c, i, st.count, st.dependents, st.dep_counts);
+                                add_dependency(last_write, c, i, st.count, st.dependents, st.dep_counts);
                                 mark_access(last_write, c, i);
                         }
                 }
@@ -309,7 +306,7 @@ bi_create_dependency_graph(struct bi_worklist st, bool inorder, bool is_blend)
         bi_instr *last = st.instructions[st.count - 1];
         if (last->branch_target || last->op == BI_OPCODE_JUMP) {
                 for (signed i = st.count - 2; i >= 0; --i)
-                        bi_push_dependency(st.count - 1, i, st.dependents, st.dep_counts);
+                        bi_push_dependency(st.count - 1, i, st.count, st.dependents, st.dep_counts);
         }
 
         /* Free the intermediate structures */
@@ -0,0 +1,190 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Make a prebuilt read-only shader cache database from a warm cache, to be
+ * used with MESA_DISK_CACHE_READ_ONLY_DB. The cache can be either a database
+ * cache (MESA_DISK_CACHE_DATABASE) or the default multi-file cache.
+ */
+
+#include <errno.h>
+#include <ftw.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "util/mesa_cache_db.h"
+#include "util/os_file.h"
+
+#define CACHE_KEY_SIZE 20
+
+static struct mesa_cache_db image;
+static unsigned num_entries;
+
+static bool
+write_entry(void *data, const uint8_t *key, const void *blob,
+            size_t blob_size)
+{
+   if (!mesa_cache_db_entry_write(&image, key, blob, blob_size))
+      return false;
+
+   num_entries++;
+   return true;
+}
+
+static bool
+copy_database(const char *cache_path)
+{
+   struct mesa_cache_db db;
+   size_t dict_size;
+   bool success;
+
+   if (!mesa_cache_db_open_read_only(&db, cache_path)) {
+      fprintf(stderr, "Failed to open the database in %s\n", cache_path);
+      return false;
+   }
+
+   /* The entries are copied as they are, so they need the dictionary that
+    * they were compressed with.
+    */
+   void *dict = mesa_cache_db_read_dictionary(&db, &dict_size);
+   if (dict) {
+      success = mesa_cache_db_set_dictionary(&image, dict, dict_size);
+      free(dict);
+      if (!success) {
+         fprintf(stderr, "Failed to store the compression dictionary\n");
+         mesa_cache_db_close(&db);
+         return false;
+      }
+   }
+
+   success = mesa_cache_db_foreach_entry(&db, write_entry, NULL);
+   mesa_cache_db_close(&db);
+
+   return success;
+}
+
+static int
+hex_value(char c)
+{
+   if (c >= '0' && c <= '9')
+      return c - '0';
+   if (c >= 'a' && c <= 'f')
+      return c - 'a' + 10;
+   return -1;
+}
+
+/* The entries of the multi-file cache are in files named after the hex
+ * digits of their keys, with the first two digits as the directory name.
+ */
+static bool
+parse_key(const char *path, int base, uint8_t key[CACHE_KEY_SIZE])
+{
+   char hex[CACHE_KEY_SIZE * 2];
+
+   if (base < 3 || path[base - 1] != '/' ||
+       strlen(path + base) != sizeof(hex) - 2)
+      return false;
+
+   hex[0] = path[base - 3];
+   hex[1] = path[base - 2];
+   memcpy(hex + 2, path + base, sizeof(hex) - 2);
+
+   for (unsigned i = 0; i < CACHE_KEY_SIZE; i++) {
+      int hi = hex_value(hex[i * 2]);
+      int lo = hex_value(hex[i * 2 + 1]);
+      if (hi < 0 || lo < 0)
+         return false;
+
+      key[i] = hi << 4 | lo;
+   }
+
+   return true;
+}
+
+static int
+copy_file(const char *path, const struct stat *sb, int type, struct FTW *ftw)
+{
+   uint8_t key[CACHE_KEY_SIZE];
+   size_t size;
+
+   if (type != FTW_F || ftw->level != 2 || !parse_key(path, ftw->base, key))
+      return 0;
+
+   char *blob = os_read_file(path, &size);
+   if (!blob) {
+      fprintf(stderr, "Failed to read %s: %s\n", path, strerror(errno));
+      return 0;
+   }
+
+   bool success = write_entry(NULL, key, blob, size);
+   free(blob);
+
+   return success ? 0 : -1;
+}
+
+int
+main(int argc, char **argv)
+{
+   struct stat st;
+   bool success;
+
+   if (argc != 3) {
+      fprintf(stderr, "Usage: %s <cache directory> <image directory>\n",
+              argv[0]);
+      return EXIT_FAILURE;
+   }
+
+   const char *cache_path = argv[1];
+   const char *image_path = argv[2];
+
+   if (mkdir(image_path, 0755) == -1 && errno != EEXIST) {
+      fprintf(stderr, "Failed to create %s: %s\n", image_path,
+              strerror(errno));
+      return EXIT_FAILURE;
+   }
+
+   /* Adding to an existing image could mix up compression dictionaries. */
+   char *image_file;
+   if (asprintf(&image_file, "%s/mesa_cache.db", image_path) == -1)
+      return EXIT_FAILURE;
+
+   bool exists = stat(image_file, &st) == 0;
+   free(image_file);
+   if (exists) {
+      fprintf(stderr, "%s already contains a database\n", image_path);
+      return EXIT_FAILURE;
+   }
+
+   if (!mesa_cache_db_open(&image, image_path)) {
+      fprintf(stderr, "Failed to create the database in %s\n", image_path);
+      return EXIT_FAILURE;
+   }
+
+   mesa_cache_db_set_size_limit(&image, UINT64_MAX);
+
+   char *db_file;
+   if (asprintf(&db_file, "%s/mesa_cache.db", cache_path) == -1)
+      return EXIT_FAILURE;
+
+   bool is_database = stat(db_file, &st) == 0;
+   free(db_file);
+
+   if (is_database)
+      success = copy_database(cache_path);
+   else
+      success = nftw(cache_path, copy_file, 16, FTW_PHYS) == 0;
+
+   mesa_cache_db_close(&image);
+
+   if (!success) {
+      fprintf(stderr, "Failed to copy the cache entries\n");
+      return EXIT_FAILURE;
+   }
+
+   printf("Wrote %u entries to %s\n", num_entries, image_path);
+
+   return EXIT_SUCCESS;
+}
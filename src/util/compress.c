@@ -36,8 +36,11 @@
 
 #ifdef HAVE_ZSTD
 #include "zstd.h"
+#include "zdict.h"
 #endif
 
+#include <stdlib.h>
+
 #include "util/compress.h"
 #include "macros.h"
 
@@ -163,4 +166,137 @@ util_compress_inflate(const uint8_t *in_data, size_t in_data_size,
 #endif
 }
 
+struct util_compress_dict {
+#ifdef HAVE_ZSTD
+   ZSTD_CDict *cdict;
+   ZSTD_DDict *ddict;
+   unsigned id;
+#endif
+};
+
+/**
+ * Train a dictionary from a set of samples concatenated in one buffer, for
+ * compressing small pieces of data that look like the samples. Returns the
+ * size of the dictionary, or 0 if there is no support for dictionaries or
+ * the training failed, which happens when there are too few samples.
+ */
+size_t
+util_compress_train_dict(void *dict_data, size_t dict_capacity,
+                         const void *samples, const size_t *sample_sizes,
+                         unsigned num_samples)
+{
+#ifdef HAVE_ZSTD
+   size_t ret = ZDICT_trainFromBuffer(dict_data, dict_capacity, samples,
+                                      sample_sizes, num_samples);
+   if (ZDICT_isError(ret))
+      return 0;
+
+   return ret;
+#else
+   return 0;
+#endif
+}
+
+/**
+ * Digest a dictionary made by util_compress_train_dict. Returns NULL if
+ * dictionaries aren't supported, in which case the plain functions are used.
+ */
+struct util_compress_dict *
+util_compress_dict_create(const void *dict_data, size_t dict_size)
+{
+#ifdef HAVE_ZSTD
+   struct util_compress_dict *dict = calloc(1, sizeof(*dict));
+   if (!dict)
+      return NULL;
+
+   /* Only trained dictionaries have an ID, which is what tells the frames
+    * compressed with the dictionary apart from the others.
+    */
+   dict->id = ZDICT_getDictID(dict_data, dict_size);
+   dict->cdict = ZSTD_createCDict(dict_data, dict_size, ZSTD_COMPRESSION_LEVEL);
+   dict->ddict = ZSTD_createDDict(dict_data, dict_size);
+
+   if (!dict->id || !dict->cdict || !dict->ddict) {
+      util_compress_dict_destroy(dict);
+      return NULL;
+   }
+
+   return dict;
+#else
+   return NULL;
+#endif
+}
+
+void
+util_compress_dict_destroy(struct util_compress_dict *dict)
+{
+#ifdef HAVE_ZSTD
+   if (!dict)
+      return;
+
+   ZSTD_freeCDict(dict->cdict);
+   ZSTD_freeDDict(dict->ddict);
+   free(dict);
+#endif
+}
+
+/* Compress data against the dictionary, or without one if dict is NULL. */
+size_t
+util_compress_deflate_with_dict(const struct util_compress_dict *dict,
+                                const uint8_t *in_data, size_t in_data_size,
+                                uint8_t *out_data, size_t out_buff_size)
+{
+#ifdef HAVE_ZSTD
+   if (dict) {
+      ZSTD_CCtx *cctx = ZSTD_createCCtx();
+      if (!cctx)
+         return 0;
+
+      size_t ret = ZSTD_compress_usingCDict(cctx, out_data, out_buff_size,
+                                            in_data, in_data_size,
+                                            dict->cdict);
+      ZSTD_freeCCtx(cctx);
+      if (ZSTD_isError(ret))
+         return 0;
+
+      return ret;
+   }
+#endif
+
+   return util_compress_deflate(in_data, in_data_size, out_data,
+                                out_buff_size);
+}
+
+/**
+ * Decompresses data that was compressed with or without the dictionary.
+ * Returns false if the data was compressed with a different dictionary.
+ */
+bool
+util_compress_inflate_with_dict(const struct util_compress_dict *dict,
+                                const uint8_t *in_data, size_t in_data_size,
+                                uint8_t *out_data, size_t out_data_size)
+{
+#ifdef HAVE_ZSTD
+   unsigned id = ZSTD_getDictID_fromFrame(in_data, in_data_size);
+
+   if (id) {
+      if (!dict || dict->id != id)
+         return false;
+
+      ZSTD_DCtx *dctx = ZSTD_createDCtx();
+      if (!dctx)
+         return false;
+
+      size_t ret = ZSTD_decompress_usingDDict(dctx, out_data, out_data_size,
+                                              in_data, in_data_size,
+                                              dict->ddict);
+      ZSTD_freeDCtx(dctx);
+      return !ZSTD_isError(ret);
+   }
+#endif
+
+   return util_compress_inflate(in_data, in_data_size, out_data,
+                                out_data_size);
+}
+
 #endif
@@ -37,6 +37,7 @@
 #include <dirent.h>
 #include <inttypes.h>
 
+#include "util/compress.h"
 #include "util/crc32.h"
 #include "util/u_debug.h"
 #include "util/rand_xor.h"
@@ -95,6 +96,9 @@ disk_cache_create(const char *gpu_name, const char *driver_id,
    /* Assume failure. */
    cache->path_init_failed = true;
 
+   simple_mtx_init(&cache->put_batch_mtx, mtx_plain);
+   simple_mtx_init(&cache->put_commit_mtx, mtx_plain);
+
 #ifdef ANDROID
    /* Android needs the "disk cache" to be enabled for
     * EGL_ANDROID_blob_cache's callbacks to be called, but it doesn't actually
@@ -201,6 +205,8 @@ disk_cache_create(const char *gpu_name, const char *driver_id,
                         UTIL_QUEUE_INIT_SET_FULL_THREAD_AFFINITY, NULL))
       goto fail;
 
+   cache->use_ro_cache_db = disk_cache_ro_db_open(cache);
+
    cache->path_init_failed = false;
 
  path_fail:
@@ -235,6 +241,10 @@ disk_cache_create(const char *gpu_name, const char *driver_id,
    DRV_KEY_CPY(drv_key_blob, &ptr_size, ptr_size_size)
    DRV_KEY_CPY(drv_key_blob, &driver_flags, driver_flags_size)
 
+   _mesa_sha1_init(&cache->driver_keys_sha1);
+   _mesa_sha1_update(&cache->driver_keys_sha1, cache->driver_keys_blob,
+                     cache->driver_keys_blob_size);
+
    /* Seed our rand function */
    s_rand_xorshift128plus(cache->seed_xorshift128plus, true);
 
@@ -260,12 +270,23 @@ disk_cache_destroy(struct disk_cache *cache)
       if (debug_get_bool_option("MESA_DISK_CACHE_SINGLE_FILE", false))
          foz_destroy(&cache->foz_db);
 
-      if (cache->use_cache_db)
+      if (cache->use_cache_db) {
          mesa_cache_db_close(&cache->cache_db);
+         util_compress_dict_destroy(cache->compress_dict);
+      }
+
+      if (cache->use_ro_cache_db)
+         disk_cache_ro_db_close(cache);
 
       disk_cache_destroy_mmap(cache);
    }
 
+   if (cache) {
+      assert(!cache->put_batch);
+      simple_mtx_destroy(&cache->put_batch_mtx);
+      simple_mtx_destroy(&cache->put_commit_mtx);
+   }
+
    ralloc_free(cache);
 }
 
@@ -297,6 +318,7 @@ create_put_job(struct disk_cache *cache, const cache_key key,
 
    if (dc_job) {
       dc_job->cache = cache;
+      dc_job->next = NULL;
       memcpy(dc_job->key, key, sizeof(cache_key));
       if (take_ownership) {
          dc_job->data = data;
@@ -386,6 +408,124 @@ done:
    }
 }
 
+static bool
+use_put_batches(struct disk_cache *cache)
+{
+   return cache->use_cache_db ||
+          debug_get_bool_option("MESA_DISK_CACHE_SINGLE_FILE", false);
+}
+
+static void
+destroy_put_batch(void *job, void *gdata, int thread_index)
+{
+   struct disk_cache_put_batch *batch = (struct disk_cache_put_batch *) job;
+   struct disk_cache_put_job *dc_job = batch->jobs;
+
+   while (dc_job) {
+      struct disk_cache_put_job *next = dc_job->next;
+
+      /* Jobs that own their data don't have it after the job itself. */
+      if (dc_job->data != dc_job + 1)
+         destroy_put_job_nocopy(dc_job, gdata, thread_index);
+      else
+         destroy_put_job(dc_job, gdata, thread_index);
+
+      dc_job = next;
+   }
+
+   util_queue_fence_destroy(&batch->fence);
+   free(batch);
+}
+
+static void
+cache_put_batch(void *job, void *gdata, int thread_index)
+{
+   struct disk_cache_put_batch *batch = (struct disk_cache_put_batch *) job;
+   struct disk_cache *cache = batch->cache;
+   struct disk_cache_put_job **jobs;
+   unsigned count = 0;
+
+   /* Wait for the previous group to be written, then close this one, so
+    * that all the puts in the meantime are written together.
+    */
+   simple_mtx_lock(&cache->put_commit_mtx);
+
+   simple_mtx_lock(&cache->put_batch_mtx);
+   if (cache->put_batch == batch)
+      cache->put_batch = NULL;
+   simple_mtx_unlock(&cache->put_batch_mtx);
+
+   for (struct disk_cache_put_job *dc_job = batch->jobs; dc_job;
+        dc_job = dc_job->next)
+      count++;
+
+   jobs = malloc(count * sizeof(*jobs));
+   if (jobs) {
+      /* Restore the order of the puts. */
+      unsigned i = count;
+      for (struct disk_cache_put_job *dc_job = batch->jobs; dc_job;
+           dc_job = dc_job->next)
+         jobs[--i] = dc_job;
+
+      if (debug_get_bool_option("MESA_DISK_CACHE_SINGLE_FILE", false)) {
+         for (i = 0; i < count; i++)
+            disk_cache_write_item_to_disk_foz(jobs[i]);
+      } else {
+         disk_cache_db_write_items_to_disk(cache, jobs, count);
+      }
+
+      free(jobs);
+   }
+
+   simple_mtx_unlock(&cache->put_commit_mtx);
+}
+
+/* Add the job to the group that is waiting to be written, and queue the
+ * group if it is new.
+ */
+static void
+queue_put_job(struct disk_cache *cache, struct disk_cache_put_job *dc_job,
+              util_queue_execute_func cleanup)
+{
+   if (!use_put_batches(cache)) {
+      util_queue_fence_init(&dc_job->fence);
+      util_queue_add_job(&cache->cache_queue, dc_job, &dc_job->fence,
+                         cache_put, cleanup, dc_job->size);
+      return;
+   }
+
+   simple_mtx_lock(&cache->put_batch_mtx);
+
+   struct disk_cache_put_batch *batch = cache->put_batch;
+   bool new_batch = !batch;
+
+   if (new_batch) {
+      batch = (struct disk_cache_put_batch *) calloc(1, sizeof(*batch));
+      if (!batch) {
+         simple_mtx_unlock(&cache->put_batch_mtx);
+         cleanup(dc_job, NULL, 0);
+         return;
+      }
+
+      batch->cache = cache;
+      util_queue_fence_init(&batch->fence);
+      cache->put_batch = batch;
+   }
+
+   dc_job->next = batch->jobs;
+   batch->jobs = dc_job;
+
+   simple_mtx_unlock(&cache->put_batch_mtx);
+
+   /* The batch can't be written before it's queued, so it's safe to queue
+    * it without the lock.
+    */
+   if (new_batch) {
+      util_queue_add_job(&cache->cache_queue, batch, &batch->fence,
+                         cache_put_batch, destroy_put_batch, 0);
+   }
+}
+
 void
 disk_cache_put(struct disk_cache *cache, const cache_key key,
                const void *data, size_t size,
@@ -402,11 +542,8 @@ disk_cache_put(struct disk_cache *cache, const cache_key key,
    struct disk_cache_put_job *dc_job =
       create_put_job(cache, key, (void*)data, size, cache_item_metadata, false);
 
-   if (dc_job) {
-      util_queue_fence_init(&dc_job->fence);
-      util_queue_add_job(&cache->cache_queue, dc_job, &dc_job->fence,
-                         cache_put, destroy_put_job, dc_job->size);
-   }
+   if (dc_job)
+      queue_put_job(cache, dc_job, destroy_put_job);
 }
 
 void
@@ -428,11 +565,17 @@ disk_cache_put_nocopy(struct disk_cache *cache, const cache_key key,
    struct disk_cache_put_job *dc_job =
       create_put_job(cache, key, data, size, cache_item_metadata, true);
 
-   if (dc_job) {
-      util_queue_fence_init(&dc_job->fence);
-      util_queue_add_job(&cache->cache_queue, dc_job, &dc_job->fence,
-                         cache_put, destroy_put_job_nocopy, dc_job->size);
-   }
+   if (dc_job)
+      queue_put_job(cache, dc_job, destroy_put_job_nocopy);
+}
+
+void
+disk_cache_put_many(struct disk_cache *cache, unsigned count,
+                    const cache_key *keys, const void *const *data,
+                    const size_t *sizes)
+{
+   for (unsigned i = 0; i < count; i++)
+      disk_cache_put(cache, keys[i], data[i], sizes[i], NULL);
 }
 
 void *
@@ -463,6 +606,12 @@ disk_cache_get(struct disk_cache *cache, const cache_key key, size_t *size)
       return blob;
    }
 
+   if (cache->use_ro_cache_db) {
+      void *data = disk_cache_ro_db_load_item(cache, key, size);
+      if (data)
+         return data;
+   }
+
    if (debug_get_bool_option("MESA_DISK_CACHE_SINGLE_FILE", false)) {
       return disk_cache_load_item_foz(cache, key, size);
    } else if (cache->use_cache_db) {
@@ -527,11 +676,8 @@ void
 disk_cache_compute_key(struct disk_cache *cache, const void *data, size_t size,
                        cache_key key)
 {
-   struct mesa_sha1 ctx;
+   struct mesa_sha1 ctx = cache->driver_keys_sha1;
 
-   _mesa_sha1_init(&ctx);
-   _mesa_sha1_update(&ctx, cache->driver_keys_blob,
-                     cache->driver_keys_blob_size);
    _mesa_sha1_update(&ctx, data, size);
    _mesa_sha1_final(&ctx, key);
 }
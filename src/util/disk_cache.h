@@ -228,6 +228,18 @@ disk_cache_put_nocopy(struct disk_cache *cache, const cache_key key,
                       void *data, size_t size,
                       struct cache_item_metadata *cache_item_metadata);
 
+/**
+ * Store \count items in the cache, e.g. all shaders of a pipeline.
+ *
+ * This is equivalent to calling disk_cache_put() for each item, but with the
+ * single file backends, the items are written together with one lock and
+ * index update.
+ */
+void
+disk_cache_put_many(struct disk_cache *cache, unsigned count,
+                    const cache_key *keys, const void *const *data,
+                    const size_t *sizes);
+
 /**
  * Retrieve an item previously stored in the cache with the name <key>.
  *
@@ -302,6 +314,14 @@ disk_cache_put(struct disk_cache *cache, const cache_key key,
    return;
 }
 
+static inline void
+disk_cache_put_many(struct disk_cache *cache, unsigned count,
+                    const cache_key *keys, const void *const *data,
+                    const size_t *sizes)
+{
+   return;
+}
+
 static inline void
 disk_cache_put_nocopy(struct disk_cache *cache, const cache_key key,
                       void *data, size_t size,
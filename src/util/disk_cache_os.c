@@ -33,6 +33,7 @@
 
 #include "util/compress.h"
 #include "util/crc32.h"
+#include "util/u_atomic.h"
 #include "util/disk_cache.h"
 #include "util/disk_cache_os.h"
 
@@ -491,8 +492,10 @@ disk_cache_evict_item(struct disk_cache *cache, char *filename)
 }
 
 static void *
-parse_and_validate_cache_item(struct disk_cache *cache, void *cache_item,
-                              size_t cache_item_size, size_t *size)
+parse_and_validate_cache_item(struct disk_cache *cache,
+                              const struct util_compress_dict *dict,
+                              void *cache_item, size_t cache_item_size,
+                              size_t *size)
 {
    uint8_t *uncompressed_data = NULL;
 
@@ -531,10 +534,12 @@ parse_and_validate_cache_item(struct disk_cache *cache, void *cache_item,
          goto fail;
    }
 
-   /* Load the CRC that was created when the file was written. */
-   struct cache_entry_file_data *cf_data =
-      (struct cache_entry_file_data *)
-         blob_read_bytes(&ci_blob_reader, sizeof(struct cache_entry_file_data));
+   /* Load the CRC that was created when the file was written. The item may
+    * be mapped at any alignment, so copy it out.
+    */
+   struct cache_entry_file_data cf_data_copy;
+   struct cache_entry_file_data *cf_data = &cf_data_copy;
+   blob_copy_bytes(&ci_blob_reader, cf_data, sizeof(*cf_data));
    if (ci_blob_reader.overrun)
       goto fail;
 
@@ -556,8 +561,9 @@ parse_and_validate_cache_item(struct disk_cache *cache, void *cache_item,
 
       memcpy(uncompressed_data, data, cache_data_size);
    } else {
-      if (!util_compress_inflate(data, cache_data_size, uncompressed_data,
-                                 cf_data->uncompressed_size))
+      if (!util_compress_inflate_with_dict(dict, data, cache_data_size,
+                                           uncompressed_data,
+                                           cf_data->uncompressed_size))
          goto fail;
    }
 
@@ -596,7 +602,7 @@ disk_cache_load_item(struct disk_cache *cache, char *filename, size_t *size)
       goto fail;
 
     uint8_t *uncompressed_data =
-       parse_and_validate_cache_item(cache, data, sb.st_size, size);
+       parse_and_validate_cache_item(cache, NULL, data, sb.st_size, size);
    if (!uncompressed_data)
       goto fail;
 
@@ -642,76 +648,76 @@ static bool
 create_cache_item_header_and_blob(struct disk_cache_put_job *dc_job,
                                   struct blob *cache_blob)
 {
-
-   /* Compress the cache item data */
-   size_t max_buf = util_compress_max_compressed_len(dc_job->size);
-   size_t compressed_size;
-   void *compressed_data;
-
-   if (dc_job->cache->compression_disabled) {
-      compressed_size = dc_job->size;
-      compressed_data = dc_job->data;
-   } else {
-      compressed_data = malloc(max_buf);
-      if (compressed_data == NULL)
-         return false;
-      compressed_size =
-         util_compress_deflate(dc_job->data, dc_job->size,
-                              compressed_data, max_buf);
-      if (compressed_size == 0)
-         goto fail;
-   }
-
    /* Copy the driver_keys_blob, this can be used find information about the
     * mesa version that produced the entry or deal with hash collisions,
     * should that ever become a real problem.
     */
    if (!blob_write_bytes(cache_blob, dc_job->cache->driver_keys_blob,
                          dc_job->cache->driver_keys_blob_size))
-      goto fail;
+      return false;
 
    /* Write the cache item metadata. This data can be used to deal with
     * hash collisions, as well as providing useful information to 3rd party
     * tools reading the cache files.
     */
    if (!blob_write_uint32(cache_blob, dc_job->cache_item_metadata.type))
-      goto fail;
+      return false;
 
    if (dc_job->cache_item_metadata.type == CACHE_ITEM_TYPE_GLSL) {
       if (!blob_write_uint32(cache_blob, dc_job->cache_item_metadata.num_keys))
-         goto fail;
+         return false;
 
       size_t metadata_keys_size =
          dc_job->cache_item_metadata.num_keys * sizeof(cache_key);
       if (!blob_write_bytes(cache_blob, dc_job->cache_item_metadata.keys[0],
                             metadata_keys_size))
-         goto fail;
+         return false;
    }
 
-   /* Create CRC of the compressed data. We will read this when restoring the
-    * cache and use it to check for corruption.
+   /* The CRC of the compressed data goes in front of it, fill it in once
+    * the data has been written.
     */
    struct cache_entry_file_data cf_data;
-   cf_data.crc32 = util_hash_crc32(compressed_data, compressed_size);
-   cf_data.uncompressed_size = dc_job->size;
+   intptr_t cf_data_offset = blob_reserve_bytes(cache_blob, sizeof(cf_data));
+   if (cf_data_offset < 0)
+      return false;
 
-   if (!blob_write_bytes(cache_blob, &cf_data, sizeof(cf_data)))
-      goto fail;
+   size_t data_offset = cache_blob->size;
+   size_t compressed_size;
 
-   /* Finally copy the compressed cache blob */
-   if (!blob_write_bytes(cache_blob, compressed_data, compressed_size))
-      goto fail;
+   if (dc_job->cache->compression_disabled) {
+      compressed_size = dc_job->size;
+      if (!blob_write_bytes(cache_blob, dc_job->data, dc_job->size))
+         return false;
+   } else {
+      /* Compress the cache item data straight into the blob rather than
+       * into a temporary buffer that would then have to be copied.
+       */
+      size_t max_buf = util_compress_max_compressed_len(dc_job->size);
+      if (blob_reserve_bytes(cache_blob, max_buf) < 0)
+         return false;
 
-   if (!dc_job->cache->compression_disabled)
-      free(compressed_data);
+      compressed_size =
+         util_compress_deflate_with_dict(p_atomic_read(&dc_job->cache->compress_dict),
+                                         dc_job->data, dc_job->size,
+                                         cache_blob->data + data_offset,
+                                         max_buf);
+      if (compressed_size == 0)
+         return false;
 
-   return true;
+      /* Drop the unused tail of the reservation. */
+      cache_blob->size = data_offset + compressed_size;
+   }
 
- fail:
-   if (!dc_job->cache->compression_disabled)
-      free(compressed_data);
+   /* We will read the CRC when restoring the cache and use it to check for
+    * corruption.
+    */
+   cf_data.crc32 = util_hash_crc32(cache_blob->data + data_offset,
+                                   compressed_size);
+   cf_data.uncompressed_size = dc_job->size;
 
-   return false;
+   return blob_overwrite_bytes(cache_blob, cf_data_offset, &cf_data,
+                               sizeof(cf_data));
 }
 
 void
@@ -955,7 +961,8 @@ disk_cache_load_item_foz(struct disk_cache *cache, const cache_key key,
       return NULL;
 
    uint8_t *uncompressed_data =
-       parse_and_validate_cache_item(cache, cache_item, cache_tem_size, size);
+       parse_and_validate_cache_item(cache, NULL, cache_item, cache_tem_size,
+                                     size);
    free(cache_item);
 
    return uncompressed_data;
@@ -1048,19 +1055,71 @@ disk_cache_destroy_mmap(struct disk_cache *cache)
    munmap(cache->index_mmap, cache->index_mmap_size);
 }
 
+/* Use the dictionary stored in the database, if there is one. */
+static bool
+load_dictionary(struct mesa_cache_db *db, struct util_compress_dict **dict)
+{
+   struct util_compress_dict *new_dict;
+   size_t dict_size;
+   void *dict_data;
+
+   dict_data = mesa_cache_db_read_dictionary(db, &dict_size);
+   if (!dict_data)
+      return false;
+
+   new_dict = util_compress_dict_create(dict_data, dict_size);
+   free(dict_data);
+   if (!new_dict)
+      return false;
+
+   /* Readers use the dictionary without locking, so it's never replaced. */
+   if (p_atomic_cmpxchg_ptr(dict, NULL, new_dict) != NULL)
+      util_compress_dict_destroy(new_dict);
+
+   return true;
+}
+
+static bool
+disk_cache_db_load_dictionary(struct disk_cache *cache)
+{
+   return load_dictionary(&cache->cache_db, &cache->compress_dict);
+}
+
 void *
 disk_cache_db_load_item(struct disk_cache *cache, const cache_key key,
                         size_t *size)
 {
    size_t cache_tem_size = 0;
-   void *cache_item = mesa_cache_db_read_entry(&cache->cache_db, key,
-                                               &cache_tem_size);
+   const void *cache_item =
+      mesa_cache_db_read_entry_mapped(&cache->cache_db, key, &cache_tem_size);
    if (!cache_item)
       return NULL;
 
+   /* Decompress straight from the mapping of the database file. */
    uint8_t *uncompressed_data =
-       parse_and_validate_cache_item(cache, cache_item, cache_tem_size, size);
-   free(cache_item);
+       parse_and_validate_cache_item(cache,
+                                     p_atomic_read(&cache->compress_dict),
+                                     (void *)cache_item, cache_tem_size, size);
+   mesa_cache_db_release_entry(&cache->cache_db);
+
+   /* The entry may have been compressed with the dictionary that another
+    * process stored in the database after we loaded it.
+    */
+   if (!uncompressed_data && !cache->compression_disabled &&
+       !p_atomic_read(&cache->compress_dict) &&
+       disk_cache_db_load_dictionary(cache)) {
+      cache_item = mesa_cache_db_read_entry_mapped(&cache->cache_db, key,
+                                                   &cache_tem_size);
+      if (!cache_item)
+         return NULL;
+
+      uncompressed_data =
+         parse_and_validate_cache_item(cache,
+                                       p_atomic_read(&cache->compress_dict),
+                                       (void *)cache_item, cache_tem_size,
+                                       size);
+      mesa_cache_db_release_entry(&cache->cache_db);
+   }
 
    return uncompressed_data;
 }
@@ -1081,10 +1140,191 @@ disk_cache_db_write_item_to_disk(struct disk_cache_put_job *dc_job)
    return r;
 }
 
+#ifdef HAVE_ZSTD
+/* Entries that are bigger than this compress well enough on their own. */
+#define DICT_MAX_SAMPLE_SIZE (16 * 1024)
+#define DICT_NUM_SAMPLES     256
+#define DICT_SIZE            (16 * 1024)
+
+/* Shader binaries and serialized NIR of the same driver have a lot in
+ * common, but small entries compress poorly on their own. Collect the small
+ * entries of the first puts to train a compression dictionary, and store it
+ * in the database for all the processes that use the cache.
+ *
+ * Only called by the put jobs, which are serialized.
+ */
+static void
+disk_cache_db_train_dictionary(struct disk_cache *cache,
+                               struct disk_cache_put_job **jobs,
+                               unsigned count)
+{
+   if (cache->compression_disabled || cache->dict_training_done ||
+       p_atomic_read(&cache->compress_dict))
+      return;
+
+   for (unsigned i = 0; i < count; i++) {
+      if (jobs[i]->size > DICT_MAX_SAMPLE_SIZE)
+         continue;
+
+      void *sample = util_dynarray_grow_bytes(&cache->dict_samples,
+                                              jobs[i]->size, 1);
+      if (!sample)
+         goto done;
+
+      memcpy(sample, jobs[i]->data, jobs[i]->size);
+      util_dynarray_append(&cache->dict_sample_sizes, size_t, jobs[i]->size);
+   }
+
+   unsigned num_samples =
+      util_dynarray_num_elements(&cache->dict_sample_sizes, size_t);
+   if (num_samples < DICT_NUM_SAMPLES)
+      return;
+
+   /* Another process may have been quicker. */
+   if (disk_cache_db_load_dictionary(cache))
+      goto done;
+
+   void *dict_data = malloc(DICT_SIZE);
+   if (!dict_data)
+      goto done;
+
+   size_t dict_size =
+      util_compress_train_dict(dict_data, DICT_SIZE, cache->dict_samples.data,
+                               cache->dict_sample_sizes.data, num_samples);
+   if (dict_size) {
+      /* If some other process stored its dictionary in the meantime, use
+       * that one instead.
+       */
+      if (mesa_cache_db_set_dictionary(&cache->cache_db, dict_data,
+                                       dict_size)) {
+         struct util_compress_dict *dict =
+            util_compress_dict_create(dict_data, dict_size);
+         if (dict && p_atomic_cmpxchg_ptr(&cache->compress_dict, NULL,
+                                          dict) != NULL)
+            util_compress_dict_destroy(dict);
+      } else {
+         disk_cache_db_load_dictionary(cache);
+      }
+   }
+
+   free(dict_data);
+
+done:
+   /* Don't try again if the training failed, the next process will. */
+   cache->dict_training_done = true;
+   util_dynarray_fini(&cache->dict_samples);
+   util_dynarray_fini(&cache->dict_sample_sizes);
+}
+#endif
+
+bool
+disk_cache_db_write_items_to_disk(struct disk_cache *cache,
+                                  struct disk_cache_put_job **jobs,
+                                  unsigned count)
+{
+   struct blob *cache_blobs = calloc(count, sizeof(*cache_blobs));
+   const uint8_t **keys = malloc(count * sizeof(*keys));
+   const void **blobs = malloc(count * sizeof(*blobs));
+   size_t *sizes = malloc(count * sizeof(*sizes));
+   unsigned num_blobs = 0;
+   bool r = false;
+
+   if (!cache_blobs || !keys || !blobs || !sizes)
+      goto out;
+
+#ifdef HAVE_ZSTD
+   disk_cache_db_train_dictionary(cache, jobs, count);
+#endif
+
+   for (unsigned i = 0; i < count; i++) {
+      struct blob *cache_blob = &cache_blobs[num_blobs];
+      blob_init(cache_blob);
+
+      if (!create_cache_item_header_and_blob(jobs[i], cache_blob)) {
+         blob_finish(cache_blob);
+         continue;
+      }
+
+      keys[num_blobs] = jobs[i]->key;
+      blobs[num_blobs] = cache_blob->data;
+      sizes[num_blobs] = cache_blob->size;
+      num_blobs++;
+   }
+
+   r = mesa_cache_db_entry_write_many(&cache->cache_db, num_blobs,
+                                      keys, blobs, sizes) == num_blobs;
+
+   for (unsigned i = 0; i < num_blobs; i++)
+      blob_finish(&cache_blobs[i]);
+
+out:
+   free(sizes);
+   free(blobs);
+   free(keys);
+   free(cache_blobs);
+   return r;
+}
+
+/* Look up the entry in the prebuilt read-only database. */
+void *
+disk_cache_ro_db_load_item(struct disk_cache *cache, const cache_key key,
+                           size_t *size)
+{
+   size_t cache_tem_size = 0;
+   const void *cache_item =
+      mesa_cache_db_read_entry_mapped(&cache->ro_cache_db, key,
+                                      &cache_tem_size);
+   if (!cache_item)
+      return NULL;
+
+   uint8_t *uncompressed_data =
+       parse_and_validate_cache_item(cache, cache->ro_compress_dict,
+                                     (void *)cache_item, cache_tem_size, size);
+   mesa_cache_db_release_entry(&cache->ro_cache_db);
+
+   return uncompressed_data;
+}
+
+/* Open the prebuilt database given by MESA_DISK_CACHE_READ_ONLY_DB, which
+ * may be shared by all the users of the system. It's mapped, so all the
+ * processes share its pages.
+ */
+bool
+disk_cache_ro_db_open(struct disk_cache *cache)
+{
+   const char *path = getenv("MESA_DISK_CACHE_READ_ONLY_DB");
+   if (!path || !*path)
+      return false;
+
+   if (!mesa_cache_db_open_read_only(&cache->ro_cache_db, path))
+      return false;
+
+   if (!cache->compression_disabled)
+      load_dictionary(&cache->ro_cache_db, &cache->ro_compress_dict);
+
+   return true;
+}
+
+void
+disk_cache_ro_db_close(struct disk_cache *cache)
+{
+   mesa_cache_db_close(&cache->ro_cache_db);
+   util_compress_dict_destroy(cache->ro_compress_dict);
+}
+
 bool
 disk_cache_db_load_cache_index(void *mem_ctx, struct disk_cache *cache)
 {
-   return mesa_cache_db_open(&cache->cache_db, cache->path);
+   if (!mesa_cache_db_open(&cache->cache_db, cache->path))
+      return false;
+
+   util_dynarray_init(&cache->dict_samples, cache);
+   util_dynarray_init(&cache->dict_sample_sizes, cache);
+
+   if (!cache->compression_disabled)
+      disk_cache_db_load_dictionary(cache);
+
+   return true;
 }
 #endif
 
@@ -34,6 +34,8 @@
 
 #include "util/fossilize_db.h"
 #include "util/mesa_cache_db.h"
+#include "util/mesa-sha1.h"
+#include "util/u_dynarray.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -48,6 +50,8 @@ extern "C" {
 /* The number of keys that can be stored in the index. */
 #define CACHE_INDEX_MAX_KEYS (1 << CACHE_INDEX_KEY_BITS)
 
+struct util_compress_dict;
+
 struct disk_cache {
    /* The path to the cache directory. */
    char *path;
@@ -62,6 +66,30 @@ struct disk_cache {
 
    bool use_cache_db;
 
+   /* Compression dictionary of the database cache, set at most once. */
+   struct util_compress_dict *compress_dict;
+
+   /* Prebuilt database that is looked up before the cache, and never
+    * written.
+    */
+   struct mesa_cache_db ro_cache_db;
+   struct util_compress_dict *ro_compress_dict;
+   bool use_ro_cache_db;
+
+   /* Small entries collected by the put jobs to train the dictionary. */
+   struct util_dynarray dict_samples;
+   struct util_dynarray dict_sample_sizes;
+   bool dict_training_done;
+
+   /* Puts that haven't been written yet, for the single file backends.
+    * Everything that is added while the previous group is being written
+    * is written together.
+    */
+   simple_mtx_t put_batch_mtx;
+   struct disk_cache_put_batch *put_batch;
+   /* Serializes writing the groups of puts. */
+   simple_mtx_t put_commit_mtx;
+
    /* Seed for rand, which is used to pick a random directory */
    uint64_t seed_xorshift128plus[2];
 
@@ -82,6 +110,11 @@ struct disk_cache {
    uint8_t *driver_keys_blob;
    size_t driver_keys_blob_size;
 
+   /* SHA-1 state after absorbing driver_keys_blob, the common prefix of
+    * every key computed by disk_cache_compute_key().
+    */
+   struct mesa_sha1 driver_keys_sha1;
+
    disk_cache_put_cb blob_put_cb;
    disk_cache_get_cb blob_get_cb;
 
@@ -99,6 +132,9 @@ struct disk_cache_put_job {
 
    struct disk_cache *cache;
 
+   /* Next job in the same disk_cache_put_batch. */
+   struct disk_cache_put_job *next;
+
    cache_key key;
 
    /* Copy of cache data to be compressed and written. */
@@ -110,6 +146,15 @@ struct disk_cache_put_job {
    struct cache_item_metadata cache_item_metadata;
 };
 
+struct disk_cache_put_batch {
+   struct util_queue_fence fence;
+
+   struct disk_cache *cache;
+
+   /* Jobs in the reverse order of the puts. */
+   struct disk_cache_put_job *jobs;
+};
+
 char *
 disk_cache_generate_cache_dir(void *mem_ctx, const char *gpu_name,
                               const char *driver_id);
@@ -157,9 +202,24 @@ disk_cache_db_load_item(struct disk_cache *cache, const cache_key key,
 bool
 disk_cache_db_write_item_to_disk(struct disk_cache_put_job *dc_job);
 
+bool
+disk_cache_db_write_items_to_disk(struct disk_cache *cache,
+                                  struct disk_cache_put_job **jobs,
+                                  unsigned count);
+
 bool
 disk_cache_db_load_cache_index(void *mem_ctx, struct disk_cache *cache);
 
+void *
+disk_cache_ro_db_load_item(struct disk_cache *cache, const cache_key key,
+                           size_t *size);
+
+bool
+disk_cache_ro_db_open(struct disk_cache *cache);
+
+void
+disk_cache_ro_db_close(struct disk_cache *cache);
+
 #ifdef __cplusplus
 }
 #endif
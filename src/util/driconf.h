@@ -384,6 +384,10 @@
    DRI_CONF_OPT_B(vk_xwayland_wait_ready, def, \
                   "Wait for fences before submitting buffers to Xwayland")
 
+#define DRI_CONF_VK_X11_MAX_PENDING_FRAMES(def) \
+   DRI_CONF_OPT_I(vk_x11_max_pending_frames, def, 0, 8, \
+                  "Throttle vkAcquireNextImageKHR in FIFO mode so that at most this many presents wait for vblank (0 = no limit)")
+
 #define DRI_CONF_MESA_GLTHREAD(def) \
    DRI_CONF_OPT_B(mesa_glthread, def, \
                   "Enable offloading GL driver work to a separate thread")
@@ -51,10 +51,138 @@ util_format_b8g8r8a8_unorm_unpack_rgba_8unorm_neon(uint8_t *restrict dst, const
       util_format_b8g8r8a8_unorm_unpack_rgba_8unorm(dst, src, width);
 }
 
+static void
+util_format_b8g8r8x8_unorm_unpack_rgba_8unorm_neon(uint8_t *restrict dst, const uint8_t *restrict src, unsigned width)
+{
+   while (width >= 16) {
+      uint8x16x4_t load = vld4q_u8(src);
+      uint8x16x4_t swap = { .val = { load.val[2], load.val[1], load.val[0], vdupq_n_u8(0xff) } };
+      vst4q_u8(dst, swap);
+      width -= 16;
+      dst += 16 * 4;
+      src += 16 * 4;
+   }
+   if (width)
+      util_format_b8g8r8x8_unorm_unpack_rgba_8unorm(dst, src, width);
+}
+
+static void
+util_format_r8g8b8x8_unorm_unpack_rgba_8unorm_neon(uint8_t *restrict dst, const uint8_t *restrict src, unsigned width)
+{
+   const uint8x16_t alpha = vreinterpretq_u8_u32(vdupq_n_u32(0xff000000));
+
+   while (width >= 4) {
+      vst1q_u8(dst, vorrq_u8(vld1q_u8(src), alpha));
+      width -= 4;
+      dst += 4 * 4;
+      src += 4 * 4;
+   }
+   if (width)
+      util_format_r8g8b8x8_unorm_unpack_rgba_8unorm(dst, src, width);
+}
+
+/* Replicates the top bits into the bottom ones, which is what
+ * _mesa_unorm_to_unorm() does when widening 5 and 6 bit channels to 8.
+ */
+static void
+util_format_b5g6r5_unorm_unpack_rgba_8unorm_neon(uint8_t *restrict dst, const uint8_t *restrict src, unsigned width)
+{
+   while (width >= 8) {
+      uint16x8_t value = vld1q_u16((const uint16_t *)src);
+      uint16x8_t b = vandq_u16(value, vdupq_n_u16(0x1f));
+      uint16x8_t g = vandq_u16(vshrq_n_u16(value, 5), vdupq_n_u16(0x3f));
+      uint16x8_t r = vshrq_n_u16(value, 11);
+      uint8x8x4_t pixel = { .val = {
+         vmovn_u16(vorrq_u16(vshlq_n_u16(r, 3), vshrq_n_u16(r, 2))),
+         vmovn_u16(vorrq_u16(vshlq_n_u16(g, 2), vshrq_n_u16(g, 4))),
+         vmovn_u16(vorrq_u16(vshlq_n_u16(b, 3), vshrq_n_u16(b, 2))),
+         vdup_n_u8(0xff),
+      } };
+      vst4_u8(dst, pixel);
+      width -= 8;
+      dst += 8 * 4;
+      src += 8 * 2;
+   }
+   if (width)
+      util_format_b5g6r5_unorm_unpack_rgba_8unorm(dst, src, width);
+}
+
+/* Widens 8 unorm channel values to two vectors of floats, computed exactly
+ * like ubyte_to_float().
+ */
+static inline void
+unorm8_to_float_neon(uint8x8_t value, float32x4_t *lo, float32x4_t *hi)
+{
+   uint16x8_t wide = vmovl_u8(value);
+
+   *lo = vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(wide))), 1.0f / 255.0f);
+   *hi = vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(wide))), 1.0f / 255.0f);
+}
+
+static inline void
+unpack_rgba8_float_neon(float *restrict dst, uint8x8x4_t pixel)
+{
+   float32x4x4_t lo, hi;
+
+   for (unsigned c = 0; c < 4; c++)
+      unorm8_to_float_neon(pixel.val[c], &lo.val[c], &hi.val[c]);
+
+   vst4q_f32(dst, lo);
+   vst4q_f32(dst + 4 * 4, hi);
+}
+
+static void
+util_format_b8g8r8a8_unorm_unpack_rgba_float_neon(void *restrict dst_row, const uint8_t *restrict src, unsigned width)
+{
+   float *dst = dst_row;
+
+   while (width >= 8) {
+      uint8x8x4_t load = vld4_u8(src);
+      uint8x8x4_t swap = { .val = { load.val[2], load.val[1], load.val[0], load.val[3] } };
+      unpack_rgba8_float_neon(dst, swap);
+      width -= 8;
+      dst += 8 * 4;
+      src += 8 * 4;
+   }
+   if (width)
+      util_format_b8g8r8a8_unorm_unpack_rgba_float(dst, src, width);
+}
+
+static void
+util_format_r8g8b8a8_unorm_unpack_rgba_float_neon(void *restrict dst_row, const uint8_t *restrict src, unsigned width)
+{
+   float *dst = dst_row;
+
+   while (width >= 8) {
+      unpack_rgba8_float_neon(dst, vld4_u8(src));
+      width -= 8;
+      dst += 8 * 4;
+      src += 8 * 4;
+   }
+   if (width)
+      util_format_r8g8b8a8_unorm_unpack_rgba_float(dst, src, width);
+}
+
 static const struct util_format_unpack_description util_format_unpack_descriptions_neon[] = {
    [PIPE_FORMAT_B8G8R8A8_UNORM] = {
       .unpack_rgba_8unorm = &util_format_b8g8r8a8_unorm_unpack_rgba_8unorm_neon,
-      .unpack_rgba = &util_format_b8g8r8a8_unorm_unpack_rgba_float,
+      .unpack_rgba = &util_format_b8g8r8a8_unorm_unpack_rgba_float_neon,
+   },
+   [PIPE_FORMAT_B8G8R8X8_UNORM] = {
+      .unpack_rgba_8unorm = &util_format_b8g8r8x8_unorm_unpack_rgba_8unorm_neon,
+      .unpack_rgba = &util_format_b8g8r8x8_unorm_unpack_rgba_float,
+   },
+   [PIPE_FORMAT_R8G8B8A8_UNORM] = {
+      .unpack_rgba_8unorm = &util_format_r8g8b8a8_unorm_unpack_rgba_8unorm,
+      .unpack_rgba = &util_format_r8g8b8a8_unorm_unpack_rgba_float_neon,
+   },
+   [PIPE_FORMAT_R8G8B8X8_UNORM] = {
+      .unpack_rgba_8unorm = &util_format_r8g8b8x8_unorm_unpack_rgba_8unorm_neon,
+      .unpack_rgba = &util_format_r8g8b8x8_unorm_unpack_rgba_float,
+   },
+   [PIPE_FORMAT_B5G6R5_UNORM] = {
+      .unpack_rgba_8unorm = &util_format_b5g6r5_unorm_unpack_rgba_8unorm_neon,
+      .unpack_rgba = &util_format_b5g6r5_unorm_unpack_rgba_float,
    },
 };
 
@@ -118,6 +118,23 @@ update_foz_index(struct foz_db *foz_db, FILE *db_idx, unsigned file_idx)
    if (offset == len)
       return;
 
+   /* Index records have a fixed size, so allocate the entries for
+    * everything that was appended in one go instead of one by one.
+    */
+   const size_t record_size = FOSSILIZE_BLOB_HASH_LENGTH +
+                              sizeof(struct foz_payload_header) +
+                              sizeof(uint64_t);
+   size_t max_entries = (len - offset) / record_size;
+   if (max_entries == 0)
+      return;
+
+   struct foz_db_entry *entries =
+      ralloc_array(foz_db->mem_ctx, struct foz_db_entry, max_entries);
+   if (!entries)
+      return;
+
+   size_t num_entries = 0;
+
    fseek(db_idx, offset, SEEK_SET);
    while (offset < len) {
       char bytes_to_read[FOSSILIZE_BLOB_HASH_LENGTH + sizeof(struct foz_payload_header)];
@@ -156,17 +173,16 @@ update_foz_index(struct foz_db *foz_db, FILE *db_idx, unsigned file_idx)
       offset += header->payload_size;
       parsed_offset = offset;
 
-      struct foz_db_entry *entry = ralloc(foz_db->mem_ctx,
-                                          struct foz_db_entry);
+      assert(num_entries < max_entries);
+      struct foz_db_entry *entry = &entries[num_entries++];
       entry->header = *header;
       entry->file_idx = file_idx;
       _mesa_sha1_hex_to_sha1(entry->key, hash_str);
 
-      /* Truncate the entry's hash string to a 64bit hash for use with a
-       * 64bit hash table for looking up file offsets.
+      /* Truncate the entry's hash to a 64bit hash for use with a 64bit hash
+       * table for looking up file offsets.
        */
-      hash_str[16] = '\0';
-      uint64_t key = strtoull(hash_str, NULL, 16);
+      uint64_t key = truncate_hash_to_64bits(entry->key);
 
       entry->offset = cache_offset;
 
@@ -434,7 +434,13 @@ hash_table_insert(struct hash_table *ht, uint32_t hash,
 
    assert(!key_pointer_is_reserved(ht, key));
 
-   if (ht->entries >= ht->max_entries) {
+   /* A table drained down to nothing but tombstones would still probe
+    * through all of them; wipe them once there are enough to be worth it.
+    */
+   if (ht->entries == 0 && ht->deleted_entries * 4 >= ht->max_entries &&
+       ht->deleted_entries) {
+      hash_table_clear_fast(ht);
+   } else if (ht->entries >= ht->max_entries) {
       _mesa_hash_table_rehash(ht, ht->size_index + 1);
    } else if (ht->deleted_entries + ht->entries >= ht->max_entries) {
       _mesa_hash_table_rehash(ht, ht->size_index);
@@ -16,6 +16,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "crc32.h"
@@ -25,17 +27,36 @@
 #include "mesa_cache_db.h"
 #include "os_time.h"
 #include "ralloc.h"
+#include "u_atomic.h"
 #include "u_qsort.h"
 
-#define MESA_CACHE_DB_VERSION          1
+#define MESA_CACHE_DB_VERSION          2
 #define MESA_CACHE_DB_MAGIC            "MESA_DB"
 
+/* Room for the compression dictionary that follows the cache file header.
+ * It's reserved when the file is created, so that a dictionary can be added
+ * to a populated database in place.
+ */
+#define MESA_CACHE_DB_DICT_MAX_SIZE    (32 * 1024)
+
 struct PACKED mesa_db_file_header {
    char magic[8];
    uint32_t version;
    uint64_t uuid;
 };
 
+struct PACKED mesa_db_dict_header {
+   uint32_t size;
+   uint32_t crc;
+};
+
+#define MESA_CACHE_DB_DICT_AREA_SIZE \
+   (sizeof(struct mesa_db_dict_header) + MESA_CACHE_DB_DICT_MAX_SIZE)
+
+/* Offset of the first entry in the cache file */
+#define MESA_CACHE_DB_DATA_OFFSET \
+   (sizeof(struct mesa_db_file_header) + MESA_CACHE_DB_DICT_AREA_SIZE)
+
 struct PACKED mesa_cache_db_file_entry {
    cache_key key;
    uint32_t crc;
@@ -92,6 +113,7 @@ static inline bool mesa_db_truncate(FILE *file, long pos)
 static bool
 mesa_db_lock(struct mesa_cache_db *db)
 {
+   u_rwlock_wrlock(&db->rwlock);
    simple_mtx_lock(&db->flock_mtx);
 
    if (flock(fileno(db->cache.file), LOCK_EX) == -1)
@@ -106,6 +128,7 @@ unlock_cache:
    flock(fileno(db->cache.file), LOCK_UN);
 unlock_mtx:
    simple_mtx_unlock(&db->flock_mtx);
+   u_rwlock_wrunlock(&db->rwlock);
 
    return false;
 }
@@ -116,6 +139,54 @@ mesa_db_unlock(struct mesa_cache_db *db)
    flock(fileno(db->index.file), LOCK_UN);
    flock(fileno(db->cache.file), LOCK_UN);
    simple_mtx_unlock(&db->flock_mtx);
+   u_rwlock_wrunlock(&db->rwlock);
+}
+
+/* The file locks belong to the shared file descriptors, so concurrent
+ * readers of this process share one set of shared file locks. This keeps
+ * other processes from modifying the files while a reader uses the
+ * mapping.
+ */
+static bool
+mesa_db_lock_shared(struct mesa_cache_db *db)
+{
+   u_rwlock_rdlock(&db->rwlock);
+   simple_mtx_lock(&db->flock_mtx);
+
+   if (db->num_readers == 0) {
+      if (flock(fileno(db->cache.file), LOCK_SH) == -1)
+         goto unlock_mtx;
+
+      if (flock(fileno(db->index.file), LOCK_SH) == -1) {
+         flock(fileno(db->cache.file), LOCK_UN);
+         goto unlock_mtx;
+      }
+   }
+
+   db->num_readers++;
+   simple_mtx_unlock(&db->flock_mtx);
+
+   return true;
+
+unlock_mtx:
+   simple_mtx_unlock(&db->flock_mtx);
+   u_rwlock_rdunlock(&db->rwlock);
+
+   return false;
+}
+
+static void
+mesa_db_unlock_shared(struct mesa_cache_db *db)
+{
+   simple_mtx_lock(&db->flock_mtx);
+
+   if (--db->num_readers == 0) {
+      flock(fileno(db->index.file), LOCK_UN);
+      flock(fileno(db->cache.file), LOCK_UN);
+   }
+
+   simple_mtx_unlock(&db->flock_mtx);
+   u_rwlock_rdunlock(&db->rwlock);
 }
 
 static uint64_t to_mesa_cache_db_hash(const uint8_t *cache_key_160bit)
@@ -236,7 +307,7 @@ static bool
 mesa_db_index_entry_valid(struct mesa_index_db_file_entry *entry)
 {
    return entry->size && entry->hash &&
-          (int64_t)entry->cache_db_file_offset >= sizeof(struct mesa_db_file_header);
+          (int64_t)entry->cache_db_file_offset >= MESA_CACHE_DB_DATA_OFFSET;
 }
 
 static bool
@@ -305,6 +376,12 @@ mesa_db_recreate_files(struct mesa_cache_db *db)
        !mesa_db_write_header(&db->index, db->uuid, true))
          return false;
 
+   /* Extending the file fills the dictionary area with zeros, which means
+    * there is no dictionary.
+    */
+   if (!mesa_db_truncate(db->cache.file, MESA_CACHE_DB_DATA_OFFSET))
+      return false;
+
    return true;
 }
 
@@ -323,7 +400,7 @@ mesa_db_load(struct mesa_cache_db *db, bool reload)
        db->cache.uuid != db->index.uuid) {
 
       /* This is unexpected to happen on reload, bail out */
-      if (reload)
+      if (reload || db->read_only)
          goto fail;
 
       if (!mesa_db_recreate_files(db))
@@ -363,6 +440,61 @@ mesa_db_reload(struct mesa_cache_db *db)
    return mesa_db_load(db, true);
 }
 
+static void
+mesa_db_unmap(struct mesa_cache_db *db)
+{
+   if (db->map)
+      munmap((void *)db->map, db->map_size);
+
+   db->map = NULL;
+   db->map_size = 0;
+}
+
+/* Map the whole cache file, must be called under the exclusive lock. */
+static bool
+mesa_db_remap(struct mesa_cache_db *db)
+{
+   struct stat st;
+
+   fflush(db->cache.file);
+
+   if (fstat(fileno(db->cache.file), &st) == -1)
+      return false;
+
+   if (db->map && db->map_size == st.st_size)
+      return true;
+
+   mesa_db_unmap(db);
+
+   if (st.st_size < sizeof(struct mesa_db_file_header))
+      return true;
+
+   void *map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED,
+                    fileno(db->cache.file), 0);
+   if (map == MAP_FAILED)
+      return false;
+
+   db->map = map;
+   db->map_size = st.st_size;
+
+   return true;
+}
+
+/* Pick up the changes done by other processes, must be called under the
+ * exclusive lock.
+ */
+static bool
+mesa_db_refresh(struct mesa_cache_db *db)
+{
+   if (mesa_db_uuid_changed(db) && !mesa_db_reload(db))
+      return false;
+
+   if (!mesa_db_update_index(db))
+      return false;
+
+   return mesa_db_remap(db);
+}
+
 static void
 touch_file(const char* path)
 {
@@ -372,7 +504,8 @@ touch_file(const char* path)
 static bool
 mesa_db_open_file(struct mesa_cache_db_file *db_file,
                   const char *cache_path,
-                  const char *filename)
+                  const char *filename,
+                  bool read_only)
 {
    if (asprintf(&db_file->path, "%s/%s", cache_path, filename) == -1)
       return false;
@@ -380,9 +513,10 @@ mesa_db_open_file(struct mesa_cache_db_file *db_file,
    /* The fopen("r+b") mode doesn't auto-create new file, hence we need to
     * explicitly create the file first.
     */
-   touch_file(db_file->path);
+   if (!read_only)
+      touch_file(db_file->path);
 
-   db_file->file = fopen(db_file->path, "r+b");
+   db_file->file = fopen(db_file->path, read_only ? "rb" : "r+b");
    if (!db_file->file) {
       free(db_file->path);
       return false;
@@ -441,7 +575,7 @@ mesa_db_compact(struct mesa_cache_db *db, int64_t blob_size)
    FILE *compacted_cache = NULL, *compacted_index = NULL;
    struct mesa_index_db_file_entry index_entry;
    struct mesa_index_db_hash_entry **entries;
-   bool success = false, compact = false;
+   bool success = false;
    void *buffer = NULL;
    unsigned int i = 0;
 
@@ -499,59 +633,73 @@ mesa_db_compact(struct mesa_cache_db *db, int64_t blob_size)
        !mesa_db_write_header(&db->index, 0, false))
       goto cleanup;
 
-   /* Sync the file pointers */
-   if (!mesa_db_seek(compacted_cache, ftell(db->cache.file)) ||
-       !mesa_db_seek(compacted_index, ftell(db->index.file)))
+   /* Entries in front of the first evicted one keep their place in both
+    * files. Only check that they are laid out back to back, then seek all
+    * file pointers past them, instead of stepping over each one with a
+    * pair of seeks per file.
+    */
+   long cache_offset = MESA_CACHE_DB_DATA_OFFSET;
+   long index_offset = ftell(db->index.file);
+   unsigned first_evicted;
+
+   for (first_evicted = 0; first_evicted < num_entries; first_evicted++) {
+      if (entries[first_evicted]->evicted)
+         break;
+
+      /* Sanity-check the cache offset */
+      if (entries[first_evicted]->cache_db_file_offset != cache_offset)
+         goto cleanup;
+
+      cache_offset += blob_file_size(entries[first_evicted]->size);
+      index_offset += sizeof(index_entry);
+   }
+
+   /* Sync the file pointers, the dictionary stays as it is */
+   if (!mesa_db_seek(db->cache.file, cache_offset) ||
+       !mesa_db_seek(compacted_cache, cache_offset) ||
+       !mesa_db_seek(db->index.file, index_offset) ||
+       !mesa_db_seek(compacted_index, index_offset))
       goto cleanup;
 
+   long compacted_offset = cache_offset;
+
    /* Do the compaction */
-   for (i = 0; i < num_entries; i++) {
+   for (i = first_evicted; i < num_entries; i++) {
       blob_size = blob_file_size(entries[i]->size);
 
       /* Sanity-check the cache-read offset */
-      if (ftell(db->cache.file) != entries[i]->cache_db_file_offset)
+      if (cache_offset != entries[i]->cache_db_file_offset)
          goto cleanup;
 
+      cache_offset += blob_size;
+
       if (entries[i]->evicted) {
          /* Jump over the evicted entry */
          if (!mesa_db_seek_cur(db->cache.file, blob_size) ||
              !mesa_db_seek_cur(db->index.file, sizeof(index_entry)))
             goto cleanup;
 
-         compact = true;
          continue;
       }
 
-      if (compact) {
-         /* Compact the cache file */
-         if (!mesa_db_read_data(db->cache.file,   buffer, blob_size) ||
-             !mesa_db_cache_entry_valid(buffer) ||
-             !mesa_db_write_data(compacted_cache, buffer, blob_size))
-            goto cleanup;
-
-         /* Compact the index file */
-         if (!mesa_db_read(db->index.file, &index_entry) ||
-             !mesa_db_index_entry_valid(&index_entry) ||
-             index_entry.cache_db_file_offset != entries[i]->cache_db_file_offset ||
-             index_entry.size != entries[i]->size)
-            goto cleanup;
+      /* Compact the cache file */
+      if (!mesa_db_read_data(db->cache.file,   buffer, blob_size) ||
+          !mesa_db_cache_entry_valid(buffer) ||
+          !mesa_db_write_data(compacted_cache, buffer, blob_size))
+         goto cleanup;
 
-         index_entry.cache_db_file_offset = ftell(compacted_cache) - blob_size;
+      /* Compact the index file */
+      if (!mesa_db_read(db->index.file, &index_entry) ||
+          !mesa_db_index_entry_valid(&index_entry) ||
+          index_entry.cache_db_file_offset != entries[i]->cache_db_file_offset ||
+          index_entry.size != entries[i]->size)
+         goto cleanup;
 
-         if (!mesa_db_write(compacted_index, &index_entry))
-            goto cleanup;
-      } else {
-         /* Sanity-check the cache-write offset */
-         if (ftell(compacted_cache) != entries[i]->cache_db_file_offset)
-            goto cleanup;
+      index_entry.cache_db_file_offset = compacted_offset;
+      compacted_offset += blob_size;
 
-         /* Jump over the unchanged entry */
-         if (!mesa_db_seek_cur(db->index.file,  sizeof(index_entry)) ||
-             !mesa_db_seek_cur(compacted_index, sizeof(index_entry)) ||
-             !mesa_db_seek_cur(db->cache.file,  blob_size) ||
-             !mesa_db_seek_cur(compacted_cache, blob_size))
-            goto cleanup;
-      }
+      if (!mesa_db_write(compacted_index, &index_entry))
+         goto cleanup;
    }
 
    fflush(compacted_cache);
@@ -586,13 +734,15 @@ cleanup:
    return success;
 }
 
-bool
-mesa_cache_db_open(struct mesa_cache_db *db, const char *cache_path)
+static bool
+mesa_db_open(struct mesa_cache_db *db, const char *cache_path, bool read_only)
 {
-   if (!mesa_db_open_file(&db->cache, cache_path, "mesa_cache.db"))
+   db->read_only = read_only;
+
+   if (!mesa_db_open_file(&db->cache, cache_path, "mesa_cache.db", read_only))
       return false;
 
-   if (!mesa_db_open_file(&db->index, cache_path, "mesa_cache.idx"))
+   if (!mesa_db_open_file(&db->index, cache_path, "mesa_cache.idx", read_only))
       goto close_cache;
 
    db->mem_ctx = ralloc_context(NULL);
@@ -600,6 +750,10 @@ mesa_cache_db_open(struct mesa_cache_db *db, const char *cache_path)
       goto close_index;
 
    simple_mtx_init(&db->flock_mtx, mtx_plain);
+   u_rwlock_init(&db->rwlock);
+   db->num_readers = 0;
+   db->map = NULL;
+   db->map_size = 0;
 
    db->index_db = _mesa_hash_table_u64_create(NULL);
    if (!db->index_db)
@@ -608,11 +762,18 @@ mesa_cache_db_open(struct mesa_cache_db *db, const char *cache_path)
    if (!mesa_db_load(db, false))
       goto destroy_hash;
 
+   /* Nothing changes a read-only database, so all the lookups can use the
+    * mapping from the start.
+    */
+   if (read_only && !mesa_db_remap(db))
+      goto destroy_hash;
+
    return true;
 
 destroy_hash:
    _mesa_hash_table_u64_destroy(db->index_db);
 destroy_mtx:
+   u_rwlock_destroy(&db->rwlock);
    simple_mtx_destroy(&db->flock_mtx);
 
    ralloc_free(db->mem_ctx);
@@ -624,10 +785,30 @@ close_cache:
    return false;
 }
 
+bool
+mesa_cache_db_open(struct mesa_cache_db *db, const char *cache_path)
+{
+   return mesa_db_open(db, cache_path, false);
+}
+
+/**
+ * Open a prebuilt database that is never written, for example one that is
+ * shared by all the users of the system. The readers don't update the
+ * access times of the entries, nor pick up any changes made to the files
+ * after opening them.
+ */
+bool
+mesa_cache_db_open_read_only(struct mesa_cache_db *db, const char *cache_path)
+{
+   return mesa_db_open(db, cache_path, true);
+}
+
 void
 mesa_cache_db_close(struct mesa_cache_db *db)
 {
+   mesa_db_unmap(db);
    _mesa_hash_table_u64_destroy(db->index_db);
+   u_rwlock_destroy(&db->rwlock);
    simple_mtx_destroy(&db->flock_mtx);
    ralloc_free(db->mem_ctx);
 
@@ -648,93 +829,182 @@ mesa_cache_db_file_entry_size(void)
    return sizeof(struct mesa_cache_db_file_entry);
 }
 
-void *
-mesa_cache_db_read_entry(struct mesa_cache_db *db,
-                         const uint8_t *cache_key_160bit,
-                         size_t *size)
+/* Look up an entry in the mapping, must be called under the shared lock.
+ * Returns NULL if the entry isn't there or the index or the mapping may be
+ * out of date.
+ */
+static const struct mesa_cache_db_file_entry *
+mesa_db_lookup_mapped(struct mesa_cache_db *db,
+                      const uint8_t *cache_key_160bit,
+                      struct mesa_index_db_hash_entry **out_hash_entry)
 {
    uint64_t hash = to_mesa_cache_db_hash(cache_key_160bit);
-   struct mesa_cache_db_file_entry cache_entry;
-   struct mesa_index_db_file_entry index_entry;
+   const struct mesa_cache_db_file_entry *cache_entry;
+   const struct mesa_db_file_header *header;
    struct mesa_index_db_hash_entry *hash_entry;
-   void *data = NULL;
+   struct stat st;
 
-   if (!mesa_db_lock(db))
+   /* Other processes can't modify the files while we hold the shared file
+    * lock, but the file may have been truncated before we took it, and
+    * touching the mapping beyond the end of the file is fatal.
+    */
+   if (!db->map || fstat(fileno(db->cache.file), &st) == -1 ||
+       st.st_size < db->map_size)
       return NULL;
 
-   if (!db->alive)
-      goto fail;
+   /* The UUID changes when the database is compacted. */
+   header = (const struct mesa_db_file_header *)db->map;
+   if (header->uuid != db->uuid)
+      return NULL;
 
-   if (mesa_db_uuid_changed(db) && !mesa_db_reload(db))
-      goto fail_fatal;
+   hash_entry = _mesa_hash_table_u64_search(db->index_db, hash);
+   if (!hash_entry ||
+       hash_entry->cache_db_file_offset + blob_file_size(hash_entry->size) >
+       db->map_size)
+      return NULL;
 
-   if (!mesa_db_update_index(db))
-      goto fail_fatal;
+   cache_entry = (const struct mesa_cache_db_file_entry *)
+      (db->map + hash_entry->cache_db_file_offset);
 
-   hash_entry = _mesa_hash_table_u64_search(db->index_db, hash);
-   if (!hash_entry)
-      goto fail;
+   if (!mesa_db_cache_entry_valid((struct mesa_cache_db_file_entry *)cache_entry) ||
+       cache_entry->size != hash_entry->size ||
+       memcmp(cache_entry->key, cache_key_160bit, sizeof(cache_entry->key)) ||
+       util_hash_crc32(cache_entry + 1, cache_entry->size) != cache_entry->crc)
+      return NULL;
 
-   if (!mesa_db_seek(db->cache.file, hash_entry->cache_db_file_offset) ||
-       !mesa_db_read(db->cache.file, &cache_entry) ||
-       !mesa_db_cache_entry_valid(&cache_entry))
-      goto fail_fatal;
+   *out_hash_entry = hash_entry;
 
-   if (memcmp(cache_entry.key, cache_key_160bit, sizeof(cache_entry.key)))
-      goto fail;
+   return cache_entry;
+}
 
-   data = malloc(cache_entry.size);
-   if (!data)
-      goto fail;
+/**
+ * Return a pointer to the entry data in the mapping of the cache file,
+ * without copying it. Unless NULL is returned, the database stays locked
+ * for reading until mesa_cache_db_release_entry is called, so the caller
+ * should only parse or copy the data. Concurrent readers don't block each
+ * other.
+ */
+const void *
+mesa_cache_db_read_entry_mapped(struct mesa_cache_db *db,
+                                const uint8_t *cache_key_160bit,
+                                size_t *size)
+{
+   const struct mesa_cache_db_file_entry *cache_entry;
+   struct mesa_index_db_hash_entry *hash_entry;
 
-   if (!mesa_db_read_data(db->cache.file, data, cache_entry.size) ||
-       util_hash_crc32(data, cache_entry.size) != cache_entry.crc)
-      goto fail_fatal;
+   for (unsigned attempt = 0; attempt < 2; attempt++) {
+      if (!mesa_db_lock_shared(db))
+         return NULL;
 
-   if (!mesa_db_seek(db->index.file, hash_entry->index_db_file_offset) ||
-       !mesa_db_read(db->index.file, &index_entry) ||
-       !mesa_db_index_entry_valid(&index_entry) ||
-       index_entry.cache_db_file_offset != hash_entry->cache_db_file_offset ||
-       index_entry.size != hash_entry->size)
-      goto fail_fatal;
+      if (!db->alive) {
+         mesa_db_unlock_shared(db);
+         return NULL;
+      }
 
-   index_entry.last_access_time = os_time_get_nano();
-   hash_entry->last_access_time = index_entry.last_access_time;
+      cache_entry = mesa_db_lookup_mapped(db, cache_key_160bit, &hash_entry);
+      if (cache_entry && db->read_only) {
+         *size = cache_entry->size;
 
-   if (!mesa_db_seek(db->index.file, hash_entry->index_db_file_offset) ||
-       !mesa_db_write(db->index.file, &index_entry))
-      goto fail_fatal;
+         return cache_entry + 1;
+      }
 
-   fflush(db->index.file);
+      if (cache_entry) {
+         uint64_t now = os_time_get_nano();
+         off_t offset = hash_entry->index_db_file_offset +
+                        offsetof(struct mesa_index_db_file_entry,
+                                 last_access_time);
+
+         /* Only this field is updated, so do it without the exclusive lock.
+          * Racing writers of the same field all store a recent time.
+          */
+         p_atomic_set(&hash_entry->last_access_time, now);
+         if (pwrite(fileno(db->index.file), &now, sizeof(now), offset) !=
+             sizeof(now)) {
+            mesa_db_unlock_shared(db);
+            return NULL;
+         }
+
+         *size = cache_entry->size;
+
+         return cache_entry + 1;
+      }
 
-   mesa_db_unlock(db);
+      mesa_db_unlock_shared(db);
 
-   *size = cache_entry.size;
+      if (attempt || db->read_only)
+         break;
 
-   return data;
+      /* The entry may have been added or moved by another process. */
+      if (!mesa_db_lock(db))
+         return NULL;
 
-fail_fatal:
-   mesa_db_zap(db);
-fail:
-   free(data);
+      bool refreshed = db->alive && mesa_db_refresh(db);
+      if (db->alive && !refreshed)
+         mesa_db_zap(db);
 
-   mesa_db_unlock(db);
+      mesa_db_unlock(db);
+
+      if (!refreshed)
+         return NULL;
+   }
 
    return NULL;
 }
 
-bool
-mesa_cache_db_entry_write(struct mesa_cache_db *db,
-                          const uint8_t *cache_key_160bit,
-                          const void *blob, size_t blob_size)
+void
+mesa_cache_db_release_entry(struct mesa_cache_db *db)
+{
+   mesa_db_unlock_shared(db);
+}
+
+void *
+mesa_cache_db_read_entry(struct mesa_cache_db *db,
+                         const uint8_t *cache_key_160bit,
+                         size_t *size)
+{
+   size_t entry_size;
+   const void *entry = mesa_cache_db_read_entry_mapped(db, cache_key_160bit,
+                                                       &entry_size);
+   if (!entry)
+      return NULL;
+
+   void *data = malloc(entry_size);
+   if (data) {
+      memcpy(data, entry, entry_size);
+      *size = entry_size;
+   }
+
+   mesa_cache_db_release_entry(db);
+
+   return data;
+}
+
+/**
+ * Append a group of entries with a single lock, index update and flush.
+ * Entries that are already in the database are skipped.
+ *
+ * Returns the number of entries that were written.
+ */
+unsigned
+mesa_cache_db_entry_write_many(struct mesa_cache_db *db, unsigned count,
+                               const uint8_t *const *cache_keys_160bit,
+                               const void *const *blobs,
+                               const size_t *blob_sizes)
 {
-   uint64_t hash = to_mesa_cache_db_hash(cache_key_160bit);
    struct mesa_index_db_hash_entry *hash_entry = NULL;
    struct mesa_cache_db_file_entry cache_entry;
    struct mesa_index_db_file_entry index_entry;
+   uint64_t total_size = 0;
+   unsigned num_written = 0;
+
+   if (db->read_only)
+      return 0;
+
+   for (unsigned i = 0; i < count; i++)
+      total_size += blob_file_size(blob_sizes[i]);
 
    if (!mesa_db_lock(db))
-      return false;
+      return 0;
 
    if (!db->alive)
       goto fail;
@@ -745,67 +1015,232 @@ mesa_cache_db_entry_write(struct mesa_cache_db *db,
    if (!mesa_db_seek_end(db->cache.file))
       goto fail_fatal;
 
-   if (ftell(db->cache.file) + blob_file_size(blob_size) > db->max_cache_size) {
-      if (!mesa_db_compact(db, MAX2(blob_size, db->max_cache_size / 2)))
+   if (ftell(db->cache.file) - MESA_CACHE_DB_DICT_AREA_SIZE + total_size >
+       db->max_cache_size) {
+      if (!mesa_db_compact(db, MAX2(total_size, db->max_cache_size / 2)))
          goto fail_fatal;
    } else {
       if (!mesa_db_update_index(db))
          goto fail_fatal;
    }
 
-   hash_entry = _mesa_hash_table_u64_search(db->index_db, hash);
-   if (hash_entry) {
-      hash_entry = NULL;
-      goto fail;
-   }
-
    if (!mesa_db_seek_end(db->cache.file) ||
        !mesa_db_seek_end(db->index.file))
       goto fail_fatal;
 
-   memcpy(cache_entry.key, cache_key_160bit, sizeof(cache_entry.key));
-   cache_entry.crc = util_hash_crc32(blob, blob_size);
-   cache_entry.size = blob_size;
+   for (unsigned i = 0; i < count; i++) {
+      uint64_t hash = to_mesa_cache_db_hash(cache_keys_160bit[i]);
 
-   index_entry.hash = hash;
-   index_entry.size = blob_size;
-   index_entry.last_access_time = os_time_get_nano();
-   index_entry.cache_db_file_offset = ftell(db->cache.file);
+      if (_mesa_hash_table_u64_search(db->index_db, hash))
+         continue;
 
-   hash_entry = ralloc(db->mem_ctx, struct mesa_index_db_hash_entry);
-   if (!hash_entry)
-      goto fail;
+      memcpy(cache_entry.key, cache_keys_160bit[i], sizeof(cache_entry.key));
+      cache_entry.crc = util_hash_crc32(blobs[i], blob_sizes[i]);
+      cache_entry.size = blob_sizes[i];
 
-   hash_entry->cache_db_file_offset = index_entry.cache_db_file_offset;
-   hash_entry->index_db_file_offset = ftell(db->index.file);
-   hash_entry->last_access_time = index_entry.last_access_time;
-   hash_entry->size = index_entry.size;
+      index_entry.hash = hash;
+      index_entry.size = blob_sizes[i];
+      index_entry.last_access_time = os_time_get_nano();
+      index_entry.cache_db_file_offset = ftell(db->cache.file);
 
-   if (!mesa_db_write(db->cache.file, &cache_entry) ||
-       !mesa_db_write_data(db->cache.file, blob, blob_size) ||
-       !mesa_db_write(db->index.file, &index_entry))
-      goto fail_fatal;
+      hash_entry = ralloc(db->mem_ctx, struct mesa_index_db_hash_entry);
+      if (!hash_entry)
+         break;
+
+      hash_entry->cache_db_file_offset = index_entry.cache_db_file_offset;
+      hash_entry->index_db_file_offset = ftell(db->index.file);
+      hash_entry->last_access_time = index_entry.last_access_time;
+      hash_entry->size = index_entry.size;
+
+      if (!mesa_db_write(db->cache.file, &cache_entry) ||
+          !mesa_db_write_data(db->cache.file, blobs[i], blob_sizes[i]) ||
+          !mesa_db_write(db->index.file, &index_entry))
+         goto fail_fatal;
+
+      _mesa_hash_table_u64_insert(db->index_db, hash, hash_entry);
+      hash_entry = NULL;
+      num_written++;
+   }
 
    fflush(db->cache.file);
    fflush(db->index.file);
 
    db->index.offset = ftell(db->index.file);
 
-   _mesa_hash_table_u64_insert(db->index_db, hash, hash_entry);
-
    mesa_db_unlock(db);
 
-   return true;
+   return num_written;
 
 fail_fatal:
    mesa_db_zap(db);
+   num_written = 0;
 fail:
    mesa_db_unlock(db);
 
    if (hash_entry)
       ralloc_free(hash_entry);
 
-   return false;
+   return num_written;
+}
+
+bool
+mesa_cache_db_entry_write(struct mesa_cache_db *db,
+                          const uint8_t *cache_key_160bit,
+                          const void *blob, size_t blob_size)
+{
+   return mesa_cache_db_entry_write_many(db, 1, &cache_key_160bit,
+                                         &blob, &blob_size) == 1;
+}
+
+/**
+ * Return a copy of the compression dictionary stored in the database, or
+ * NULL if there is none. The caller frees it.
+ */
+void *
+mesa_cache_db_read_dictionary(struct mesa_cache_db *db, size_t *size)
+{
+   struct mesa_db_dict_header dict_header;
+   void *dict = NULL;
+
+   if (!mesa_db_lock(db))
+      return NULL;
+
+   if (!db->alive)
+      goto out;
+
+   if (!mesa_db_seek(db->cache.file, sizeof(struct mesa_db_file_header)) ||
+       !mesa_db_read(db->cache.file, &dict_header) ||
+       !dict_header.size || dict_header.size > MESA_CACHE_DB_DICT_MAX_SIZE)
+      goto out;
+
+   dict = malloc(dict_header.size);
+   if (!dict)
+      goto out;
+
+   if (!mesa_db_read_data(db->cache.file, dict, dict_header.size) ||
+       util_hash_crc32(dict, dict_header.size) != dict_header.crc) {
+      free(dict);
+      dict = NULL;
+      goto out;
+   }
+
+   *size = dict_header.size;
+
+out:
+   mesa_db_unlock(db);
+
+   return dict;
+}
+
+/**
+ * Store the compression dictionary in the database, unless it already has
+ * one. The dictionary is never replaced, the entries compressed with it
+ * would become unreadable.
+ *
+ * Returns false if the dictionary wasn't stored.
+ */
+bool
+mesa_cache_db_set_dictionary(struct mesa_cache_db *db,
+                             const void *dict, size_t size)
+{
+   struct mesa_db_dict_header dict_header;
+   bool success = false;
+
+   if (db->read_only || !size || size > MESA_CACHE_DB_DICT_MAX_SIZE)
+      return false;
+
+   if (!mesa_db_lock(db))
+      return false;
+
+   if (!db->alive)
+      goto out;
+
+   if (mesa_db_uuid_changed(db) && !mesa_db_reload(db)) {
+      mesa_db_zap(db);
+      goto out;
+   }
+
+   if (!mesa_db_seek(db->cache.file, sizeof(struct mesa_db_file_header)) ||
+       !mesa_db_read(db->cache.file, &dict_header) ||
+       dict_header.size)
+      goto out;
+
+   dict_header.size = size;
+   dict_header.crc = util_hash_crc32(dict, size);
+
+   /* Write the header last, so that the dictionary isn't seen before it's
+    * complete.
+    */
+   if (!mesa_db_seek(db->cache.file, sizeof(struct mesa_db_file_header) +
+                                     sizeof(dict_header)) ||
+       !mesa_db_write_data(db->cache.file, dict, size))
+      goto out;
+
+   fflush(db->cache.file);
+
+   if (!mesa_db_seek(db->cache.file, sizeof(struct mesa_db_file_header)) ||
+       !mesa_db_write(db->cache.file, &dict_header))
+      goto out;
+
+   fflush(db->cache.file);
+
+   success = true;
+
+out:
+   mesa_db_unlock(db);
+
+   return success;
+}
+
+/**
+ * Call the callback with each entry of the database, until it returns
+ * false. The database stays locked meanwhile, so this is meant for tools.
+ *
+ * Returns false if the entries couldn't be read or the callback failed.
+ */
+bool
+mesa_cache_db_foreach_entry(struct mesa_cache_db *db,
+                            mesa_cache_db_entry_cb callback, void *data)
+{
+   bool success = false;
+
+   if (!mesa_db_lock(db))
+      return false;
+
+   if (!db->alive)
+      goto out;
+
+   if (!db->read_only && !mesa_db_refresh(db))
+      goto out;
+
+   hash_table_foreach(db->index_db->table, entry) {
+      struct mesa_index_db_hash_entry *hash_entry = entry->data;
+      const struct mesa_cache_db_file_entry *cache_entry;
+
+      if (!db->map ||
+          hash_entry->cache_db_file_offset +
+          blob_file_size(hash_entry->size) > db->map_size)
+         goto out;
+
+      cache_entry = (const struct mesa_cache_db_file_entry *)
+         (db->map + hash_entry->cache_db_file_offset);
+
+      if (!mesa_db_cache_entry_valid((struct mesa_cache_db_file_entry *)cache_entry) ||
+          cache_entry->size != hash_entry->size ||
+          util_hash_crc32(cache_entry + 1, cache_entry->size) != cache_entry->crc)
+         goto out;
+
+      if (!callback(data, cache_entry->key, cache_entry + 1,
+                    cache_entry->size))
+         goto out;
+   }
+
+   success = true;
+
+out:
+   mesa_db_unlock(db);
+
+   return success;
 }
 
 #endif /* DETECT_OS_WINDOWS */
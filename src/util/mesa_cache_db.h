@@ -15,6 +15,7 @@
 #include <stdio.h>
 
 #include "detect_os.h"
+#include "rwlock.h"
 #include "simple_mtx.h"
 
 #ifdef __cplusplus
@@ -37,12 +38,33 @@ struct mesa_cache_db {
    void *mem_ctx;
    uint64_t uuid;
    bool alive;
+   bool read_only;
+
+   /* Taken shared by lookups that hit the in-memory index and the mapping,
+    * and exclusively by everything that modifies them or the files.
+    */
+   struct u_rwlock rwlock;
+   /* Number of threads holding the shared lock, protected by flock_mtx.
+    * The first one takes the shared file lock, the last one drops it.
+    */
+   unsigned num_readers;
+
+   /* Read-only mapping of the cache file. */
+   const uint8_t *map;
+   size_t map_size;
 };
 
+typedef bool (*mesa_cache_db_entry_cb)(void *data,
+                                       const uint8_t *cache_key_160bit,
+                                       const void *blob, size_t blob_size);
+
 #if DETECT_OS_WINDOWS == 0
 bool
 mesa_cache_db_open(struct mesa_cache_db *db, const char *cache_path);
 
+bool
+mesa_cache_db_open_read_only(struct mesa_cache_db *db, const char *cache_path);
+
 void
 mesa_cache_db_close(struct mesa_cache_db *db);
 
@@ -58,10 +80,35 @@ mesa_cache_db_read_entry(struct mesa_cache_db *db,
                          const uint8_t *cache_key_160bit,
                          size_t *size);
 
+const void *
+mesa_cache_db_read_entry_mapped(struct mesa_cache_db *db,
+                                const uint8_t *cache_key_160bit,
+                                size_t *size);
+
+void
+mesa_cache_db_release_entry(struct mesa_cache_db *db);
+
 bool
 mesa_cache_db_entry_write(struct mesa_cache_db *db,
                           const uint8_t *cache_key_160bit,
                           const void *blob, size_t blob_size);
+
+unsigned
+mesa_cache_db_entry_write_many(struct mesa_cache_db *db, unsigned count,
+                               const uint8_t *const *cache_keys_160bit,
+                               const void *const *blobs,
+                               const size_t *blob_sizes);
+
+void *
+mesa_cache_db_read_dictionary(struct mesa_cache_db *db, size_t *size);
+
+bool
+mesa_cache_db_set_dictionary(struct mesa_cache_db *db,
+                             const void *dict, size_t size);
+
+bool
+mesa_cache_db_foreach_entry(struct mesa_cache_db *db,
+                            mesa_cache_db_entry_cb callback, void *data);
 #else
 static inline bool
 mesa_cache_db_open(struct mesa_cache_db *db, const char *cache_path)
@@ -69,6 +116,12 @@ mesa_cache_db_open(struct mesa_cache_db *db, const char *cache_path)
    return false;
 }
 
+static inline bool
+mesa_cache_db_open_read_only(struct mesa_cache_db *db, const char *cache_path)
+{
+   return false;
+}
+
 static inline void
 mesa_cache_db_close(struct mesa_cache_db *db)
 {
@@ -94,6 +147,19 @@ mesa_cache_db_read_entry(struct mesa_cache_db *db,
    return NULL;
 }
 
+static inline const void *
+mesa_cache_db_read_entry_mapped(struct mesa_cache_db *db,
+                                const uint8_t *cache_key_160bit,
+                                size_t *size)
+{
+   return NULL;
+}
+
+static inline void
+mesa_cache_db_release_entry(struct mesa_cache_db *db)
+{
+}
+
 static inline bool
 mesa_cache_db_entry_write(struct mesa_cache_db *db,
                           const uint8_t *cache_key_160bit,
@@ -101,6 +167,35 @@ mesa_cache_db_entry_write(struct mesa_cache_db *db,
 {
    return false;
 }
+
+static inline unsigned
+mesa_cache_db_entry_write_many(struct mesa_cache_db *db, unsigned count,
+                               const uint8_t *const *cache_keys_160bit,
+                               const void *const *blobs,
+                               const size_t *blob_sizes)
+{
+   return 0;
+}
+
+static inline void *
+mesa_cache_db_read_dictionary(struct mesa_cache_db *db, size_t *size)
+{
+   return NULL;
+}
+
+static inline bool
+mesa_cache_db_set_dictionary(struct mesa_cache_db *db,
+                             const void *dict, size_t size)
+{
+   return false;
+}
+
+static inline bool
+mesa_cache_db_foreach_entry(struct mesa_cache_db *db,
+                            mesa_cache_db_entry_cb callback, void *data)
+{
+   return false;
+}
 #endif /* DETECT_OS_WINDOWS */
 
 #ifdef __cplusplus
@@ -95,6 +95,13 @@ util_perfetto_trace_end(enum util_perfetto_category category)
    util_perfetto_update_category_states();
 }
 
+void
+util_perfetto_counter_set(const char *name, double value)
+{
+   TRACE_COUNTER(UTIL_PERFETTO_CATEGORY_DEFAULT_STR,
+                 perfetto::CounterTrack(name), value);
+}
+
 class UtilPerfettoObserver : public perfetto::TrackEventSessionObserver {
  public:
    UtilPerfettoObserver() { perfetto::TrackEvent::AddSessionObserver(this); }
@@ -57,6 +57,10 @@ util_perfetto_trace_begin(enum util_perfetto_category category,
 void
 util_perfetto_trace_end(enum util_perfetto_category category);
 
+/* name must be a string with static storage duration. */
+void
+util_perfetto_counter_set(const char *name, double value);
+
 #else /* HAVE_PERFETTO */
 
 static inline void
@@ -81,6 +85,11 @@ util_perfetto_trace_end(enum util_perfetto_category category)
 {
 }
 
+static inline void
+util_perfetto_counter_set(const char *name, double value)
+{
+}
+
 #endif /* HAVE_PERFETTO */
 
 #ifdef __cplusplus
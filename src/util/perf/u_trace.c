@@ -279,12 +279,54 @@ u_trace_payload_buf_unref(struct u_trace_payload_buf *payload)
       free(payload);
 }
 
+static void *
+get_timestamp_buffer(struct u_trace_context *utctx)
+{
+   void *timestamps = NULL;
+
+   simple_mtx_lock(&utctx->free_ts_buffers_mutex);
+   if (utctx->num_free_ts_buffers > 0)
+      timestamps = utctx->free_ts_buffers[--utctx->num_free_ts_buffers];
+   simple_mtx_unlock(&utctx->free_ts_buffers_mutex);
+
+   if (!timestamps)
+      timestamps = utctx->create_timestamp_buffer(utctx, TIMESTAMP_BUF_SIZE);
+
+   return timestamps;
+}
+
+static void
+put_timestamp_buffer(struct u_trace_context *utctx, void *timestamps)
+{
+   /* Every timestamp read back was written first, either by the GPU or
+    * with U_TRACE_NO_TIMESTAMP by record_timestamp(), so stale values of a
+    * recycled buffer are never observed.
+    */
+   simple_mtx_lock(&utctx->free_ts_buffers_mutex);
+   if (utctx->num_free_ts_buffers < ARRAY_SIZE(utctx->free_ts_buffers)) {
+      utctx->free_ts_buffers[utctx->num_free_ts_buffers++] = timestamps;
+      timestamps = NULL;
+   }
+   simple_mtx_unlock(&utctx->free_ts_buffers_mutex);
+
+   if (timestamps)
+      utctx->delete_timestamp_buffer(utctx, timestamps);
+}
+
+static void
+free_timestamp_buffers(struct u_trace_context *utctx)
+{
+   for (unsigned i = 0; i < utctx->num_free_ts_buffers; i++)
+      utctx->delete_timestamp_buffer(utctx, utctx->free_ts_buffers[i]);
+   utctx->num_free_ts_buffers = 0;
+}
+
 static void
 free_chunk(void *ptr)
 {
    struct u_trace_chunk *chunk = ptr;
 
-   chunk->utctx->delete_timestamp_buffer(chunk->utctx, chunk->timestamps);
+   put_timestamp_buffer(chunk->utctx, chunk->timestamps);
 
    /* Unref payloads attached to this chunk. */
    struct u_trace_payload_buf **payload;
@@ -347,7 +389,7 @@ get_chunk(struct u_trace *ut, size_t payload_size)
    chunk = calloc(1, sizeof(*chunk));
 
    chunk->utctx = ut->utctx;
-   chunk->timestamps = ut->utctx->create_timestamp_buffer(ut->utctx, TIMESTAMP_BUF_SIZE);
+   chunk->timestamps = get_timestamp_buffer(ut->utctx);
    chunk->last = true;
    u_vector_init(&chunk->payloads, 4, sizeof(struct u_trace_payload_buf *));
    if (payload_size > 0) {
@@ -403,7 +445,7 @@ u_trace_state_init(void)
 static void
 queue_init(struct u_trace_context *utctx)
 {
-   if (utctx->queue.jobs)
+   if (util_queue_is_initialized(&utctx->queue))
       return;
 
    bool ret = util_queue_init(&utctx->queue, "traceq", 256, 1,
@@ -442,6 +484,9 @@ u_trace_context_init(struct u_trace_context *utctx,
 
    list_inithead(&utctx->flushed_trace_chunks);
 
+   simple_mtx_init(&utctx->free_ts_buffers_mutex, mtx_plain);
+   utctx->num_free_ts_buffers = 0;
+
    utctx->out = u_trace_state.trace_file;
 
    if (u_trace_state.trace_format_json) {
@@ -486,11 +531,14 @@ u_trace_context_fini(struct u_trace_context *utctx)
       fflush(utctx->out);
    }
 
-   if (!utctx->queue.jobs)
-      return;
-   util_queue_finish(&utctx->queue);
-   util_queue_destroy(&utctx->queue);
-   free_chunks(&utctx->flushed_trace_chunks);
+   if (util_queue_is_initialized(&utctx->queue)) {
+      util_queue_finish(&utctx->queue);
+      util_queue_destroy(&utctx->queue);
+      free_chunks(&utctx->flushed_trace_chunks);
+   }
+
+   free_timestamp_buffers(utctx);
+   simple_mtx_destroy(&utctx->free_ts_buffers_mutex);
 }
 
 #ifdef HAVE_PERFETTO
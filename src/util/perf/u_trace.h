@@ -136,6 +136,8 @@ typedef void (*u_trace_delete_flush_data)(struct u_trace_context *utctx,
  * The trace context provides tracking for "in-flight" traces, once the
  * cmdstream that records timestamps has been flushed.
  */
+#define U_TRACE_MAX_FREE_TS_BUFFERS 32
+
 struct u_trace_context {
    void *pctx;
 
@@ -172,6 +174,14 @@ struct u_trace_context {
 
    /* list of unprocessed trace chunks in fifo order: */
    struct list_head flushed_trace_chunks;
+
+   /* Timestamp buffers of freed chunks, kept around for new chunks so that
+    * continuous tracing doesn't create and delete a buffer per chunk.
+    * Chunks are freed on the processing queue, hence the lock.
+    */
+   simple_mtx_t free_ts_buffers_mutex;
+   void *free_ts_buffers[U_TRACE_MAX_FREE_TS_BUFFERS];
+   unsigned num_free_ts_buffers;
 };
 
 /**
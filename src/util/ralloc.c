@@ -284,19 +284,32 @@ unlink_block(ralloc_header *info)
 static void
 unsafe_free(ralloc_header *info)
 {
-   /* Recursively free any children...don't waste time unlinking them. */
-   ralloc_header *temp;
-   while (info->child != NULL) {
-      temp = info->child;
-      info->child = temp->next;
-      unsafe_free(temp);
-   }
+   /* Free the tree depth first without recursing, so deep trees (long
+    * chains of contexts, big compiler IR) cost no stack.  Children are
+    * popped off their parent's list but otherwise not unlinked, and every
+    * block is freed after all of its children, as before.
+    */
+   ralloc_header *node = info;
+
+   while (true) {
+      while (node->child != NULL)
+         node = node->child;
+
+      ralloc_header *parent = node->parent;
+      if (node != info)
+         parent->child = node->next;
 
-   /* Free the block itself.  Call the destructor first, if any. */
-   if (info->destructor != NULL)
-      info->destructor(PTR_FROM_HEADER(info));
+      /* Free the block itself.  Call the destructor first, if any. */
+      if (node->destructor != NULL)
+         node->destructor(PTR_FROM_HEADER(node));
 
-   free(info);
+      free(node);
+
+      if (node == info)
+         return;
+
+      node = parent;
+   }
 }
 
 void
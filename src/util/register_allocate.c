@@ -585,6 +585,7 @@ ra_alloc_interference_graph(struct ra_regs *regs, unsigned int count)
    g = rzalloc(NULL, struct ra_graph);
    g->regs = regs;
    g->count = count;
+   g->max_count = count;
    ra_realloc_interference_graph(g, count);
 
    return g;
@@ -594,8 +595,40 @@ void
 ra_resize_interference_graph(struct ra_graph *g, unsigned int count)
 {
    g->count = count;
+   g->max_count = MAX2(g->max_count, count);
    if (count > g->alloc)
-      ra_realloc_interference_graph(g, g->alloc * 2);
+      ra_realloc_interference_graph(g, MAX2(count, g->alloc * 2));
+}
+
+/**
+ * Empties the graph so it can be reused for another allocation with \p count
+ * nodes of \p regs, keeping the node and adjacency storage of earlier runs.
+ * Only the part of the graph that was in use gets cleared.
+ */
+void
+ra_reset_interference_graph(struct ra_graph *g, struct ra_regs *regs,
+                            unsigned int count)
+{
+   memset(g->adjacency, 0,
+          BITSET_WORDS(ra_get_num_adjacency_bits(g->max_count)) *
+          sizeof(BITSET_WORD));
+
+   for (unsigned i = 0; i < g->max_count; i++) {
+      struct ra_node *node = g->nodes + i;
+      util_dynarray_clear(&node->adjacency_list);
+      node->class = 0;
+      node->q_total = 0;
+      node->forced_reg = NO_REG;
+      node->reg = NO_REG;
+      node->spill_cost = 0.0f;
+   }
+
+   g->regs = regs;
+   g->select_reg_callback = NULL;
+   g->select_reg_callback_data = NULL;
+   g->count = 0;
+   g->max_count = 0;
+   ra_resize_interference_graph(g, count);
 }
 
 void ra_set_select_reg_callback(struct ra_graph *g,
@@ -89,6 +89,8 @@ struct ra_regs *ra_set_deserialize(void *mem_ctx, struct blob_reader *blob);
 struct ra_graph *ra_alloc_interference_graph(struct ra_regs *regs,
                                              unsigned int count);
 void ra_resize_interference_graph(struct ra_graph *g, unsigned int count);
+void ra_reset_interference_graph(struct ra_graph *g, struct ra_regs *regs,
+                                 unsigned int count);
 void ra_set_node_class(struct ra_graph *g, unsigned int n, struct ra_class *c);
 struct ra_class *ra_get_node_class(struct ra_graph *g, unsigned int n);
 unsigned int ra_add_node(struct ra_graph *g, struct ra_class *c);
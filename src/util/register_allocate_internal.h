@@ -135,6 +135,9 @@ struct ra_graph {
 
    unsigned int alloc; /**< count of nodes allocated. */
 
+   /** Highest count of nodes used since the graph was last reset. */
+   unsigned int max_count;
+
    ra_select_reg_callback select_reg_callback;
    void *select_reg_callback_data;
 
@@ -396,7 +396,13 @@ set_search_or_add(struct set *ht, uint32_t hash, const void *key, bool *found)
 
    assert(!key_pointer_is_reserved(key));
 
-   if (ht->entries >= ht->max_entries) {
+   /* A set drained down to nothing but tombstones would still probe
+    * through all of them; wipe them once there are enough to be worth it.
+    */
+   if (ht->entries == 0 && ht->deleted_entries * 4 >= ht->max_entries &&
+       ht->deleted_entries) {
+      set_clear_fast(ht);
+   } else if (ht->entries >= ht->max_entries) {
       set_rehash(ht, ht->size_index + 1);
    } else if (ht->deleted_entries + ht->entries >= ht->max_entries) {
       set_rehash(ht, ht->size_index);
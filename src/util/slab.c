@@ -129,6 +129,63 @@ void slab_create_child(struct slab_child_pool *pool,
    pool->pages = NULL;
    pool->free = NULL;
    pool->migrated = NULL;
+   pool->outgoing = NULL;
+   pool->num_outgoing = 0;
+   pool->num_pages = 0;
+   pool->num_migrated = 0;
+}
+
+/* Move the elements freed in this pool but owned by other pools to the
+ * migrated lists of their owners. Called with the parent mutex held.
+ *
+ * \return the elements of orphaned pages, to be freed after unlocking
+ */
+static struct slab_element_header *
+slab_return_outgoing_locked(struct slab_child_pool *pool)
+{
+   struct slab_element_header *orphaned = NULL;
+
+   while (pool->outgoing) {
+      struct slab_element_header *elt = pool->outgoing;
+      pool->outgoing = elt->next;
+
+      /* Note: elt->owner must be read with the mutex held, because the
+       * owning child pool may be destroyed by another thread.
+       */
+      intptr_t owner_int = p_atomic_read(&elt->owner);
+
+      if (!(owner_int & 1)) {
+         struct slab_child_pool *owner = (struct slab_child_pool *)owner_int;
+         elt->next = owner->migrated;
+         owner->migrated = elt;
+      } else {
+         elt->next = orphaned;
+         orphaned = elt;
+      }
+   }
+   pool->num_outgoing = 0;
+
+   return orphaned;
+}
+
+static void
+slab_free_orphaned_list(struct slab_element_header *elt)
+{
+   while (elt) {
+      struct slab_element_header *next = elt->next;
+      slab_free_orphaned(elt);
+      elt = next;
+   }
+}
+
+static void
+slab_return_outgoing(struct slab_child_pool *pool)
+{
+   simple_mtx_lock(&pool->parent->mutex);
+   struct slab_element_header *orphaned = slab_return_outgoing_locked(pool);
+   simple_mtx_unlock(&pool->parent->mutex);
+
+   slab_free_orphaned_list(orphaned);
 }
 
 /**
@@ -144,6 +201,8 @@ void slab_destroy_child(struct slab_child_pool *pool)
 
    simple_mtx_lock(&pool->parent->mutex);
 
+   struct slab_element_header *orphaned = slab_return_outgoing_locked(pool);
+
    while (pool->pages) {
       struct slab_page_header *page = pool->pages;
       pool->pages = page->u.next;
@@ -163,6 +222,8 @@ void slab_destroy_child(struct slab_child_pool *pool)
 
    simple_mtx_unlock(&pool->parent->mutex);
 
+   slab_free_orphaned_list(orphaned);
+
    while (pool->free) {
       struct slab_element_header *elt = pool->free;
       pool->free = elt->next;
@@ -194,6 +255,7 @@ slab_add_new_page(struct slab_child_pool *pool)
 
    page->u.next = pool->pages;
    pool->pages = page;
+   pool->num_pages++;
 
    return true;
 }
@@ -210,12 +272,19 @@ slab_alloc(struct slab_child_pool *pool)
 
    if (!pool->free) {
       /* First, collect elements that belong to us but were freed from a
-       * different child pool.
+       * different child pool. The unlocked read is only a hint, there is
+       * no need to take the mutex if nothing was migrated.
        */
-      simple_mtx_lock(&pool->parent->mutex);
-      pool->free = pool->migrated;
-      pool->migrated = NULL;
-      simple_mtx_unlock(&pool->parent->mutex);
+      if (p_atomic_read_relaxed(&pool->migrated) || pool->outgoing) {
+         simple_mtx_lock(&pool->parent->mutex);
+         pool->free = pool->migrated;
+         pool->migrated = NULL;
+         struct slab_element_header *orphaned =
+            slab_return_outgoing_locked(pool);
+         simple_mtx_unlock(&pool->parent->mutex);
+
+         slab_free_orphaned_list(orphaned);
+      }
 
       /* Now allocate a new page. */
       if (!pool->free && !slab_add_new_page(pool))
@@ -269,11 +338,21 @@ void slab_free(struct slab_child_pool *pool, void *ptr)
       return;
    }
 
-   /* The slow case: migration or an orphaned page. */
-   if (pool->parent)
-      simple_mtx_lock(&pool->parent->mutex);
+   /* Migration or an orphaned page: return the element to its owner later,
+    * together with other ones.
+    */
+   if (pool->parent) {
+      elt->next = pool->outgoing;
+      pool->outgoing = elt;
+      pool->num_migrated++;
+      if (++pool->num_outgoing >= SLAB_MIGRATE_BATCH)
+         slab_return_outgoing(pool);
+      return;
+   }
 
-   /* Note: we _must_ re-read elt->owner here because the owning child pool
+   /* The pool was destroyed, free the element right away.
+    *
+    * Note: we _must_ re-read elt->owner here because the owning child pool
     * may have been destroyed by another thread in the meantime.
     */
    owner_int = p_atomic_read(&elt->owner);
@@ -282,12 +361,7 @@ void slab_free(struct slab_child_pool *pool, void *ptr)
       struct slab_child_pool *owner = (struct slab_child_pool *)owner_int;
       elt->next = owner->migrated;
       owner->migrated = elt;
-      if (pool->parent)
-         simple_mtx_unlock(&pool->parent->mutex);
    } else {
-      if (pool->parent)
-         simple_mtx_unlock(&pool->parent->mutex);
-
       slab_free_orphaned(elt);
    }
 }
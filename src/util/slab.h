@@ -33,7 +33,9 @@
  * Allocations obtained from one child pool should usually be freed in the
  * same child pool. Freeing an allocation in a different child pool associated
  * to the same parent is allowed (and requires no locking by the caller), but
- * it is discouraged because it implies a performance penalty.
+ * it is discouraged because it implies a performance penalty. Such
+ * allocations are returned to their pool in batches, so the parent mutex is
+ * only taken once per SLAB_MIGRATE_BATCH of them.
  *
  * For convenience and to ease the transition, there is also a set of wrapper
  * functions around a single parent-child pair.
@@ -51,6 +53,8 @@ extern "C" {
 struct slab_element_header;
 struct slab_page_header;
 
+#define SLAB_MIGRATE_BATCH 32
+
 struct slab_parent_pool {
    simple_mtx_t mutex;
    unsigned element_size;
@@ -72,6 +76,17 @@ struct slab_child_pool {
     * This list is protected by the parent mutex.
     */
    struct slab_element_header *migrated;
+
+   /* Elements owned by other pools that were freed with this pool as the
+    * argument to slab_free, not yet moved to the migrated list of their
+    * owner.
+    */
+   struct slab_element_header *outgoing;
+   unsigned num_outgoing;
+
+   /* Statistics */
+   unsigned num_pages;     /* pages allocated, i.e. the high-water mark */
+   unsigned num_migrated;  /* elements freed to another pool */
 };
 
 void slab_create_parent(struct slab_parent_pool *parent,
@@ -28,6 +28,7 @@
 
 #include "main/macros.h"
 #include "util/streaming-load-memcpy.h"
+#include "util/u_cpu_detect.h"
 #include "x86/common_x86_asm.h"
 #ifdef USE_SSE41
 #include <smmintrin.h>
@@ -90,3 +91,63 @@ util_streaming_load_memcpy(void *restrict dst, void *restrict src, size_t len)
       memcpy(d, s, len);
    }
 }
+
+/* Copies memory from src to dst, using SSE2's MOVNTDQ so that large writes
+ * to write-combined or uncached memory go out as full cachelines without
+ * reading the destination or evicting the source from the cache.
+ */
+void
+util_streaming_store_memcpy(void *restrict dst, const void *restrict src,
+                            size_t len)
+{
+   char *restrict d = dst;
+   const char *restrict s = src;
+
+#ifdef USE_SSE41
+   if (len < 64 || !util_get_cpu_caps()->has_sse2) {
+      memcpy(d, s, len);
+      return;
+   }
+
+   /* memcpy() the misaligned header, only the destination has to be
+    * aligned for MOVNTDQ.
+    */
+   if ((uintptr_t)d & 15) {
+      uintptr_t bytes_before_alignment_boundary = 16 - ((uintptr_t)d & 15);
+
+      memcpy(d, s, bytes_before_alignment_boundary);
+
+      d += bytes_before_alignment_boundary;
+      s += bytes_before_alignment_boundary;
+      len -= bytes_before_alignment_boundary;
+   }
+
+   while (len >= 64) {
+      __m128i *dst_cacheline = (__m128i *)d;
+      const __m128i *src_cacheline = (const __m128i *)s;
+
+      __m128i temp1 = _mm_loadu_si128(src_cacheline + 0);
+      __m128i temp2 = _mm_loadu_si128(src_cacheline + 1);
+      __m128i temp3 = _mm_loadu_si128(src_cacheline + 2);
+      __m128i temp4 = _mm_loadu_si128(src_cacheline + 3);
+
+      _mm_stream_si128(dst_cacheline + 0, temp1);
+      _mm_stream_si128(dst_cacheline + 1, temp2);
+      _mm_stream_si128(dst_cacheline + 2, temp3);
+      _mm_stream_si128(dst_cacheline + 3, temp4);
+
+      d += 64;
+      s += 64;
+      len -= 64;
+   }
+
+   /* Non-temporal stores are weakly ordered, make them visible before
+    * whatever hands the memory to the GPU.
+    */
+   _mm_sfence();
+#endif
+   /* memcpy() the tail. */
+   if (len) {
+      memcpy(d, s, len);
+   }
+}
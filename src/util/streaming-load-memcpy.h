@@ -38,4 +38,11 @@
 void
 util_streaming_load_memcpy(void *restrict dst, void *restrict src, size_t len);
 
+/* Copies memory from src to dst, using SSE2's MOVNTDQ to write to
+ * write-combined or uncached memory without polluting the cache.
+ */
+void
+util_streaming_store_memcpy(void *restrict dst, const void *restrict src,
+                            size_t len);
+
 #endif /* STREAMING_LOAD_MEMCPY_H */
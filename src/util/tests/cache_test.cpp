@@ -459,6 +459,179 @@ test_put_key_and_get_key(const char *driver_id)
    disk_cache_destroy(cache);
 }
 
+static void
+test_put_many_and_get(const char *driver_id)
+{
+   struct disk_cache *cache;
+   cache_key keys[8];
+   char data[8][16];
+   const void *blobs[8];
+   size_t sizes[8];
+
+#ifdef SHADER_CACHE_DISABLE_BY_DEFAULT
+   setenv("MESA_SHADER_CACHE_DISABLE", "false", 1);
+#endif /* SHADER_CACHE_DISABLE_BY_DEFAULT */
+
+   cache = disk_cache_create("test", driver_id, 0);
+
+   for (unsigned i = 0; i < ARRAY_SIZE(keys); i++) {
+      snprintf(data[i], sizeof(data[i]), "put-many-%u", i);
+      disk_cache_compute_key(cache, data[i], sizeof(data[i]), keys[i]);
+      blobs[i] = data[i];
+      sizes[i] = sizeof(data[i]);
+   }
+
+   disk_cache_put_many(cache, ARRAY_SIZE(keys), keys, blobs, sizes);
+
+   /* Put some of them again individually so that the group contains keys
+    * that are already in the cache.
+    */
+   disk_cache_put(cache, keys[0], data[0], sizes[0], NULL);
+   disk_cache_put(cache, keys[3], data[3], sizes[3], NULL);
+
+   disk_cache_wait_for_idle(cache);
+
+   for (unsigned i = 0; i < ARRAY_SIZE(keys); i++) {
+      size_t size;
+      char *result = (char *) disk_cache_get(cache, keys[i], &size);
+      EXPECT_NE(result, nullptr) << "disk_cache_get of a disk_cache_put_many item";
+      if (result) {
+         EXPECT_EQ(size, sizes[i]);
+         EXPECT_STREQ(result, data[i]) << "disk_cache_put_many item contents";
+         free(result);
+      }
+   }
+
+   disk_cache_destroy(cache);
+}
+
+static void
+test_put_and_get_with_dictionary(const char *driver_id)
+{
+   static const char *words[] = {
+      "mov", "add", "mul", "mad", "load_ubo", "store_output", "fsat",
+      "vec4", "ssa_", "r0", "r1", "r2", "const", "block", "if", "loop",
+   };
+   struct disk_cache *cache[2];
+   cache_key keys[300];
+   char data[1024];
+   char *result;
+   size_t size;
+
+#ifdef SHADER_CACHE_DISABLE_BY_DEFAULT
+   setenv("MESA_SHADER_CACHE_DISABLE", "false", 1);
+#endif /* SHADER_CACHE_DISABLE_BY_DEFAULT */
+
+   setenv("MESA_SHADER_CACHE_MAX_SIZE", "16M", 1);
+
+   cache[0] = disk_cache_create("test_dictionary", driver_id, 0);
+
+   /* Put enough similar entries that are small enough to train the
+    * dictionary.
+    */
+   for (unsigned i = 0; i < ARRAY_SIZE(keys); i++) {
+      unsigned seed = i;
+      size_t len = snprintf(data, sizeof(data), "shader %u:", i);
+      while (len < sizeof(data) - 16) {
+         seed = seed * 1103515245 + 12345;
+         len += snprintf(data + len, sizeof(data) - len, " %s%u",
+                         words[(seed >> 16) % ARRAY_SIZE(words)],
+                         (seed >> 8) % 8);
+      }
+
+      disk_cache_compute_key(cache[0], data, sizeof(data), keys[i]);
+      disk_cache_put(cache[0], keys[i], data, sizeof(data), NULL);
+   }
+
+   disk_cache_wait_for_idle(cache[0]);
+
+#ifdef HAVE_ZSTD
+   EXPECT_NE(cache[0]->compress_dict, nullptr) << "dictionary was trained";
+#endif
+
+   /* The second instance loads the dictionary from the database. */
+   cache[1] = disk_cache_create("test_dictionary", driver_id, 0);
+
+#ifdef HAVE_ZSTD
+   EXPECT_NE(cache[1]->compress_dict, nullptr) << "dictionary was loaded";
+#endif
+
+   for (unsigned k = 0; k < ARRAY_SIZE(cache); k++) {
+      for (unsigned i = 0; i < ARRAY_SIZE(keys); i++) {
+         result = (char *) disk_cache_get(cache[k], keys[i], &size);
+         EXPECT_NE(result, nullptr) << "disk_cache_get of existing item (pointer)";
+         EXPECT_EQ(size, sizeof(data)) << "disk_cache_get of existing item (size)";
+         free(result);
+      }
+   }
+
+   disk_cache_destroy(cache[1]);
+   disk_cache_destroy(cache[0]);
+}
+
+static void
+test_put_and_get_read_only_db(const char *driver_id)
+{
+   struct disk_cache *cache;
+   char blob[] = "This is a blob of thirty-seven bytes";
+   char blob2[] = "This blob goes to the writable cache";
+   cache_key blob_key, blob_key2;
+   char *result;
+   size_t size;
+
+#ifdef SHADER_CACHE_DISABLE_BY_DEFAULT
+   setenv("MESA_SHADER_CACHE_DISABLE", "false", 1);
+#endif /* SHADER_CACHE_DISABLE_BY_DEFAULT */
+
+   /* Make the image with the database cache. */
+   setenv("MESA_DISK_CACHE_DATABASE", "true", 1);
+
+   cache = disk_cache_create("test_read_only_db", driver_id, 0);
+   disk_cache_compute_key(cache, blob, sizeof(blob), blob_key);
+   disk_cache_compute_key(cache, blob2, sizeof(blob2), blob_key2);
+   disk_cache_put(cache, blob_key, blob, sizeof(blob), NULL);
+   disk_cache_wait_for_idle(cache);
+
+   char *image_path = strdup(cache->path);
+   disk_cache_destroy(cache);
+
+   /* Layer it under a multi-file cache. */
+   setenv("MESA_DISK_CACHE_DATABASE", "false", 1);
+   setenv("MESA_DISK_CACHE_READ_ONLY_DB", image_path, 1);
+
+   cache = disk_cache_create("test_read_only_db", driver_id, 0);
+   EXPECT_TRUE(cache->use_ro_cache_db) << "read-only database opened";
+
+   result = (char *) disk_cache_get(cache, blob_key, &size);
+   EXPECT_STREQ(result, blob) << "disk_cache_get from the read-only database";
+   EXPECT_EQ(size, sizeof(blob));
+   free(result);
+
+   disk_cache_put(cache, blob_key2, blob2, sizeof(blob2), NULL);
+   disk_cache_wait_for_idle(cache);
+
+   result = (char *) disk_cache_get(cache, blob_key2, &size);
+   EXPECT_STREQ(result, blob2) << "disk_cache_get from the writable cache";
+   free(result);
+
+   disk_cache_destroy(cache);
+
+   unsetenv("MESA_DISK_CACHE_READ_ONLY_DB");
+
+   /* The image was left as it was. */
+   setenv("MESA_DISK_CACHE_DATABASE", "true", 1);
+
+   cache = disk_cache_create("test_read_only_db", driver_id, 0);
+   EXPECT_STREQ(cache->path, image_path);
+
+   result = (char *) disk_cache_get(cache, blob_key2, &size);
+   EXPECT_EQ(result, nullptr) << "read-only database was not written";
+   free(result);
+
+   disk_cache_destroy(cache);
+   free(image_path);
+}
+
 /* To make sure we are not just using the inmemory cache index for the single
  * file cache we test adding and retriving cache items between two different
  * cache instances.
@@ -763,10 +936,16 @@ TEST_F(Cache, Database)
 
    test_put_key_and_get_key(driver_id);
 
+   test_put_many_and_get(driver_id);
+
    test_put_and_get_between_instances(driver_id);
 
    test_put_and_get_between_instances_with_eviction(driver_id);
 
+   test_put_and_get_with_dictionary("make_check");
+
+   test_put_and_get_read_only_db(driver_id);
+
    setenv("MESA_DISK_CACHE_DATABASE", "false", 1);
 
    err = rmrf_local(CACHE_TEST_TMP);
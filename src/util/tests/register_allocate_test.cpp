@@ -279,3 +279,48 @@ TEST_F(ra_test, serialization_roundtrip)
    blob_finish(&blob);
 }
 
+
+TEST_F(ra_test, reset_graph)
+{
+   struct ra_regs *regs = ra_alloc_reg_set(mem_ctx, 4, true);
+   struct ra_class *c = ra_alloc_contig_reg_class(regs, 1);
+   for (int i = 0; i < 4; i++)
+      ra_class_add_reg(c, i);
+   ra_set_finalize(regs, NULL);
+
+   /* A 5-clique can't be colored with 4 registers. */
+   struct ra_graph *g = ra_alloc_interference_graph(regs, 5);
+   for (unsigned i = 0; i < 5; i++) {
+      ra_set_node_class(g, i, c);
+      for (unsigned j = 0; j < i; j++)
+         ra_add_node_interference(g, i, j);
+   }
+   ASSERT_FALSE(ra_allocate(g));
+
+   /* After a reset, a bigger graph without interference must not see any of
+    * the old edges.
+    */
+   ra_reset_interference_graph(g, regs, 40);
+   for (unsigned i = 0; i < 40; i++)
+      ra_set_node_class(g, i, c);
+   for (unsigned i = 0; i < 40; i += 4) {
+      for (unsigned j = i; j < i + 4; j++) {
+         for (unsigned k = i; k < j; k++)
+            ra_add_node_interference(g, j, k);
+      }
+   }
+   ASSERT_TRUE(ra_allocate(g));
+   for (unsigned i = 0; i < 40; i += 4) {
+      for (unsigned j = i; j < i + 4; j++) {
+         for (unsigned k = i; k < j; k++)
+            ASSERT_NE(ra_get_node_reg(g, j), ra_get_node_reg(g, k));
+      }
+   }
+
+   ra_reset_interference_graph(g, regs, 5);
+   for (unsigned i = 0; i < 5; i++)
+      ra_set_node_class(g, i, c);
+   ASSERT_TRUE(ra_allocate(g));
+
+   ralloc_free(g);
+}
@@ -135,6 +135,28 @@ TEST(set, remove_key)
    _mesa_set_destroy(s, NULL);
 }
 
+TEST(set, drain_and_refill)
+{
+   struct set *s = _mesa_set_create(NULL, _mesa_hash_pointer,
+                                    _mesa_key_pointer_equal);
+
+   for (uintptr_t i = 1; i <= 64; i++)
+      _mesa_set_add(s, (const void *)(i * 16));
+   for (uintptr_t i = 1; i <= 64; i++)
+      _mesa_set_remove_key(s, (const void *)(i * 16));
+   EXPECT_EQ(s->entries, 0);
+   EXPECT_EQ(s->deleted_entries, 64);
+
+   /* Adding to a set holding only tombstones drops them. */
+   _mesa_set_add(s, (const void *)16);
+   EXPECT_EQ(s->entries, 1);
+   EXPECT_EQ(s->deleted_entries, 0);
+   EXPECT_TRUE(_mesa_set_search(s, (const void *)16));
+   EXPECT_FALSE(_mesa_set_search(s, (const void *)32));
+
+   _mesa_set_destroy(s, NULL);
+}
+
 static uint32_t hash_int(const void *p)
 {
    int i = *(const int *)p;
@@ -0,0 +1,209 @@
+/*
+ * SPDX-License-Identifier: MIT
+ *
+ * Testing u_queue.h
+ */
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "util/u_queue.h"
+
+namespace {
+
+struct counter {
+   unsigned value;
+};
+
+void
+increment(void *job, void *gdata, int thread_index)
+{
+   p_atomic_inc(&((struct counter *)job)->value);
+}
+
+struct order_job {
+   unsigned *order;
+   unsigned *num;
+   unsigned id;
+};
+
+void
+record(void *job, void *gdata, int thread_index)
+{
+   struct order_job *j = (struct order_job *)job;
+   j->order[p_atomic_inc_return(j->num) - 1] = j->id;
+}
+
+void
+wait_gate(void *job, void *gdata, int thread_index)
+{
+   util_queue_fence_wait((struct util_queue_fence *)job);
+}
+
+class QueueTest : public testing::TestWithParam<unsigned> {};
+
+} // namespace
+
+TEST_P(QueueTest, ManyProducers)
+{
+   const unsigned num_producers = 4, jobs_per_producer = 10000;
+   struct util_queue queue;
+   struct counter counter = { 0 };
+
+   ASSERT_TRUE(util_queue_init(&queue, "test", 8, 4, GetParam(), NULL));
+
+   std::vector<std::thread> producers;
+   for (unsigned p = 0; p < num_producers; p++) {
+      producers.emplace_back([&]() {
+         for (unsigned i = 0; i < jobs_per_producer; i++)
+            util_queue_add_job(&queue, &counter, NULL, increment, NULL, 0);
+      });
+   }
+   for (auto &t : producers)
+      t.join();
+
+   util_queue_finish(&queue);
+   EXPECT_EQ(counter.value, num_producers * jobs_per_producer);
+
+   struct util_queue_stats stats;
+   util_queue_get_stats(&queue, &stats);
+   /* util_queue_finish adds one job per thread */
+   EXPECT_EQ(stats.num_added, stats.num_executed);
+   EXPECT_GE(stats.num_added, num_producers * jobs_per_producer);
+
+   util_queue_destroy(&queue);
+}
+
+TEST_P(QueueTest, Fences)
+{
+   struct util_queue queue;
+   struct counter counter = { 0 };
+   struct util_queue_fence fences[64];
+
+   ASSERT_TRUE(util_queue_init(&queue, "test", 4, 2, GetParam(), NULL));
+
+   for (unsigned i = 0; i < ARRAY_SIZE(fences); i++) {
+      util_queue_fence_init(&fences[i]);
+      util_queue_add_job(&queue, &counter, &fences[i], increment, NULL, 0);
+   }
+   for (unsigned i = 0; i < ARRAY_SIZE(fences); i++) {
+      util_queue_fence_wait(&fences[i]);
+      util_queue_fence_destroy(&fences[i]);
+   }
+   EXPECT_EQ(counter.value, ARRAY_SIZE(fences));
+
+   util_queue_destroy(&queue);
+}
+
+TEST_P(QueueTest, Priorities)
+{
+   struct util_queue queue;
+   struct util_queue_fence gate;
+   unsigned order[3], num = 0;
+   struct order_job jobs[3] = {
+      { order, &num, UTIL_QUEUE_PRIORITY_BACKGROUND },
+      { order, &num, UTIL_QUEUE_PRIORITY_NORMAL },
+      { order, &num, UTIL_QUEUE_PRIORITY_IMMEDIATE },
+   };
+
+   ASSERT_TRUE(util_queue_init(&queue, "test", 4, 1, GetParam(), NULL));
+
+   /* Keep the thread busy until all the jobs are queued. */
+   util_queue_fence_init(&gate);
+   util_queue_fence_reset(&gate);
+   util_queue_add_job(&queue, &gate, NULL, wait_gate, NULL, 0);
+
+   for (unsigned i = 0; i < ARRAY_SIZE(jobs); i++) {
+      util_queue_add_job_with_deps(&queue, &jobs[i], NULL, record, NULL, 0,
+                                   (enum util_queue_priority)jobs[i].id,
+                                   NULL, 0);
+   }
+
+   util_queue_fence_signal(&gate);
+   util_queue_finish(&queue);
+
+   ASSERT_EQ(num, 3u);
+   EXPECT_EQ(order[0], (unsigned)UTIL_QUEUE_PRIORITY_IMMEDIATE);
+   EXPECT_EQ(order[1], (unsigned)UTIL_QUEUE_PRIORITY_NORMAL);
+   EXPECT_EQ(order[2], (unsigned)UTIL_QUEUE_PRIORITY_BACKGROUND);
+
+   util_queue_fence_destroy(&gate);
+   util_queue_destroy(&queue);
+}
+
+TEST_P(QueueTest, Dependencies)
+{
+   const unsigned num_jobs = 64;
+   struct util_queue queue;
+   struct util_queue_fence fences[num_jobs];
+   unsigned order[num_jobs], num = 0;
+   struct order_job jobs[num_jobs];
+
+   ASSERT_TRUE(util_queue_init(&queue, "test", 4, 4, GetParam(), NULL));
+
+   /* A chain where every job depends on the previous two, submitted with
+    * the highest priority so that only the dependencies order them.
+    */
+   for (unsigned i = 0; i < num_jobs; i++) {
+      struct util_queue_fence *deps[2];
+      unsigned num_deps = 0;
+
+      for (unsigned d = 1; d <= 2 && d <= i; d++)
+         deps[num_deps++] = &fences[i - d];
+
+      jobs[i] = { order, &num, i };
+      util_queue_fence_init(&fences[i]);
+      util_queue_add_job_with_deps(&queue, &jobs[i], &fences[i], record, NULL,
+                                   0, UTIL_QUEUE_PRIORITY_IMMEDIATE,
+                                   deps, num_deps);
+   }
+
+   util_queue_fence_wait(&fences[num_jobs - 1]);
+
+   ASSERT_EQ(num, num_jobs);
+   for (unsigned i = 0; i < num_jobs; i++)
+      EXPECT_EQ(order[i], i);
+
+   for (unsigned i = 0; i < num_jobs; i++)
+      util_queue_fence_destroy(&fences[i]);
+   util_queue_destroy(&queue);
+}
+
+TEST_P(QueueTest, DropPendingJob)
+{
+   struct util_queue queue;
+   struct util_queue_fence gate, dep, fence;
+   unsigned order[2], num = 0;
+   struct order_job job = { order, &num, 0 };
+
+   ASSERT_TRUE(util_queue_init(&queue, "test", 4, 1, GetParam(), NULL));
+
+   util_queue_fence_init(&gate);
+   util_queue_fence_reset(&gate);
+   util_queue_fence_init(&dep);
+   util_queue_add_job(&queue, &gate, &dep, wait_gate, NULL, 0);
+
+   util_queue_fence_init(&fence);
+   struct util_queue_fence *deps[] = { &dep };
+   util_queue_add_job_with_deps(&queue, &job, &fence, record, NULL, 0,
+                                UTIL_QUEUE_PRIORITY_NORMAL, deps, 1);
+
+   util_queue_drop_job(&queue, &fence);
+   EXPECT_TRUE(util_queue_fence_is_signalled(&fence));
+
+   util_queue_fence_signal(&gate);
+   util_queue_finish(&queue);
+   EXPECT_EQ(num, 0u);
+
+   util_queue_fence_destroy(&fence);
+   util_queue_fence_destroy(&dep);
+   util_queue_fence_destroy(&gate);
+   util_queue_destroy(&queue);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+   Queue, QueueTest,
+   testing::Values(0u, (unsigned)UTIL_QUEUE_INIT_RESIZE_IF_FULL,
+                   (unsigned)UTIL_QUEUE_INIT_LOCKLESS)
+);
@@ -33,6 +33,7 @@
  */
 
 #include "util/u_idalloc.h"
+#include "util/u_atomic.h"
 #include "util/u_math.h"
 #include <stdlib.h>
 
@@ -158,16 +159,21 @@ util_idalloc_reserve(struct util_idalloc *buf, unsigned id)
    buf->data[id / 32] |= 1u << (id % 32);
 }
 
+#define IDALLOC_MT_NODE_SIZE 1024
+
 void
 util_idalloc_mt_init(struct util_idalloc_mt *buf,
                      unsigned initial_num_ids, bool skip_zero)
 {
-   simple_mtx_init(&buf->mutex, mtx_plain);
-   util_idalloc_init(&buf->buf, initial_num_ids);
+   /* The sparse array allocates its nodes as they're touched, so there's
+    * nothing to preallocate for initial_num_ids.
+    */
+   util_sparse_array_init(&buf->words, sizeof(uint32_t), IDALLOC_MT_NODE_SIZE);
+   buf->lowest_free_idx = 0;
    buf->skip_zero = skip_zero;
 
    if (skip_zero) {
-      ASSERTED unsigned zero = util_idalloc_alloc(&buf->buf);
+      ASSERTED unsigned zero = util_idalloc_mt_alloc(buf);
       assert(zero == 0);
    }
 }
@@ -182,17 +188,27 @@ util_idalloc_mt_init_tc(struct util_idalloc_mt *buf)
 void
 util_idalloc_mt_fini(struct util_idalloc_mt *buf)
 {
-   util_idalloc_fini(&buf->buf);
-   simple_mtx_destroy(&buf->mutex);
+   util_sparse_array_finish(&buf->words);
 }
 
 unsigned
 util_idalloc_mt_alloc(struct util_idalloc_mt *buf)
 {
-   simple_mtx_lock(&buf->mutex);
-   unsigned id = util_idalloc_alloc(&buf->buf);
-   simple_mtx_unlock(&buf->mutex);
-   return id;
+   for (unsigned i = p_atomic_read(&buf->lowest_free_idx);; i++) {
+      uint32_t *word = util_sparse_array_get(&buf->words, i);
+      uint32_t bits = p_atomic_read(word);
+
+      while (bits != 0xffffffff) {
+         unsigned bit = ffs(~bits) - 1;
+         uint32_t old = p_atomic_cmpxchg(word, bits, bits | BITFIELD_BIT(bit));
+         if (old == bits)
+            return i * 32 + bit;
+         bits = old;
+      }
+
+      /* The word is full. Move the hint past it unless someone lowered it. */
+      p_atomic_cmpxchg(&buf->lowest_free_idx, i, i + 1);
+   }
 }
 
 void
@@ -201,7 +217,22 @@ util_idalloc_mt_free(struct util_idalloc_mt *buf, unsigned id)
    if (id == 0 && buf->skip_zero)
       return;
 
-   simple_mtx_lock(&buf->mutex);
-   util_idalloc_free(&buf->buf, id);
-   simple_mtx_unlock(&buf->mutex);
+   unsigned idx = id / 32;
+   uint32_t *word = util_sparse_array_get(&buf->words, idx);
+   uint32_t bits = p_atomic_read(word);
+   while (1) {
+      assert(bits & BITFIELD_BIT(id % 32));
+      uint32_t old = p_atomic_cmpxchg(word, bits, bits & ~BITFIELD_BIT(id % 32));
+      if (old == bits)
+         break;
+      bits = old;
+   }
+
+   unsigned lowest = p_atomic_read(&buf->lowest_free_idx);
+   while (idx < lowest) {
+      unsigned old = p_atomic_cmpxchg(&buf->lowest_free_idx, lowest, idx);
+      if (old == lowest)
+         break;
+      lowest = old;
+   }
 }
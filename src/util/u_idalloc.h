@@ -37,6 +37,7 @@
 #include <inttypes.h>
 #include <stdbool.h>
 #include "simple_mtx.h"
+#include "sparse_array.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -82,10 +83,16 @@ util_idalloc_exists(struct util_idalloc *buf, unsigned id)
          if ((id = i * 32 + u_bit_scan(&mask)), true)
 
 
-/* Thread-safe variant. */
+/* Thread-safe variant.
+ *
+ * It's lock-free: the bit array lives in a util_sparse_array of 32-bit words
+ * that only ever grows, and bits are set and cleared with atomics.
+ * lowest_free_idx is only a hint, so a racing free can leave an ID unused
+ * until a lower one is freed, but IDs are never handed out twice.
+ */
 struct util_idalloc_mt {
-   struct util_idalloc buf;
-   simple_mtx_t mutex;
+   struct util_sparse_array words;
+   unsigned lowest_free_idx;
    bool skip_zero;
 };
 
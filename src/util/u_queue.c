@@ -28,6 +28,7 @@
 
 #include "c11/threads.h"
 #include "util/u_cpu_detect.h"
+#include "util/u_math.h"
 #include "util/os_time.h"
 #include "util/u_string.h"
 #include "util/u_thread.h"
@@ -237,6 +238,312 @@ util_queue_fence_destroy(struct util_queue_fence *fence)
 }
 #endif
 
+/****************************************************************************
+ * UTIL_QUEUE_INIT_LOCKLESS ring
+ *
+ * A bounded multi-producer multi-consumer ring where each slot carries a
+ * sequence number telling whether it's free for the producer or filled for
+ * the consumer at a given position, so that pushing and popping only need a
+ * compare-and-swap on the tail or head position.
+ */
+
+#if UTIL_FUTEX_SUPPORTED
+static inline bool
+util_queue_is_lockless(struct util_queue *queue)
+{
+   return queue->flags & UTIL_QUEUE_INIT_LOCKLESS;
+}
+
+static void
+util_queue_ring_event_signal(uint32_t *event)
+{
+   uint32_t v = p_atomic_add_return(event, 2);
+
+   if (v & 1) {
+      p_atomic_cmpxchg(event, v, v & ~1u);
+      futex_wake(event, INT_MAX);
+   }
+}
+
+/* Wait for util_queue_ring_event_signal, \p v is the value of the event
+ * read before checking the ring for the last time.
+ */
+static void
+util_queue_ring_event_wait(uint32_t *event, uint32_t v)
+{
+   if (!(v & 1)) {
+      if (p_atomic_cmpxchg(event, v, v | 1) != v)
+         return;
+      v |= 1;
+   }
+   futex_wait(event, v, NULL);
+}
+
+static bool
+util_queue_ring_push(struct util_queue_lane *lane,
+                     const struct util_queue_job *job)
+{
+   uint32_t pos = p_atomic_read_relaxed(&lane->ring_tail);
+
+   while (1) {
+      struct util_queue_ring_slot *slot = &lane->ring[pos & lane->ring_mask];
+      int32_t diff = (int32_t)(p_atomic_read(&slot->seq) - pos);
+
+      if (diff == 0) {
+         uint32_t old = p_atomic_cmpxchg(&lane->ring_tail, pos, pos + 1);
+         if (old == pos) {
+            slot->job = *job;
+            p_atomic_set(&slot->seq, pos + 1);
+            return true;
+         }
+         pos = old;
+      } else if (diff < 0) {
+         return false; /* full */
+      } else {
+         pos = p_atomic_read_relaxed(&lane->ring_tail);
+      }
+   }
+}
+
+static bool
+util_queue_ring_pop(struct util_queue_lane *lane, struct util_queue_job *job)
+{
+   uint32_t pos = p_atomic_read_relaxed(&lane->ring_head);
+
+   while (1) {
+      struct util_queue_ring_slot *slot = &lane->ring[pos & lane->ring_mask];
+      int32_t diff = (int32_t)(p_atomic_read(&slot->seq) - (pos + 1));
+
+      if (diff == 0) {
+         uint32_t old = p_atomic_cmpxchg(&lane->ring_head, pos, pos + 1);
+         if (old == pos) {
+            *job = slot->job;
+            p_atomic_set(&slot->seq, pos + lane->ring_mask + 1);
+            return true;
+         }
+         pos = old;
+      } else if (diff < 0) {
+         return false; /* empty */
+      } else {
+         pos = p_atomic_read_relaxed(&lane->ring_head);
+      }
+   }
+}
+
+/* Pop a job from the highest priority lane which has one. */
+static bool
+util_queue_ring_pop_any(struct util_queue *queue, struct util_queue_job *job)
+{
+   for (unsigned i = 0; i < UTIL_QUEUE_NUM_PRIORITIES; i++) {
+      if (util_queue_ring_pop(&queue->lanes[i], job))
+         return true;
+   }
+   return false;
+}
+
+static void
+util_queue_ring_add(struct util_queue *queue, struct util_queue_lane *lane,
+                    const struct util_queue_job *job)
+{
+   int64_t t0 = 0;
+
+   while (!util_queue_ring_push(lane, job)) {
+      uint32_t v = p_atomic_read(&queue->ring_space_futex);
+
+      if (util_queue_ring_push(lane, job))
+         break;
+
+      if (!t0)
+         t0 = os_time_get_nano();
+      util_queue_ring_event_wait(&queue->ring_space_futex, v);
+   }
+
+   if (t0)
+      p_atomic_add(&queue->stats.full_wait_time, os_time_get_nano() - t0);
+
+   util_queue_ring_event_signal(&queue->ring_queued_futex);
+}
+
+/* Return false if the thread must terminate. */
+static bool
+util_queue_ring_get(struct util_queue *queue, unsigned thread_index,
+                    struct util_queue_job *job)
+{
+   while (1) {
+      if (thread_index >= p_atomic_read(&queue->num_threads))
+         return false;
+      if (util_queue_ring_pop_any(queue, job))
+         break;
+
+      uint32_t v = p_atomic_read(&queue->ring_queued_futex);
+
+      if (thread_index >= p_atomic_read(&queue->num_threads))
+         return false;
+      if (util_queue_ring_pop_any(queue, job))
+         break;
+
+      util_queue_ring_event_wait(&queue->ring_queued_futex, v);
+   }
+
+   util_queue_ring_event_signal(&queue->ring_space_futex);
+   return true;
+}
+#else
+static inline bool
+util_queue_is_lockless(struct util_queue *queue)
+{
+   return false;
+}
+#endif
+
+/****************************************************************************
+ * Priority lanes and jobs waiting for their dependencies
+ */
+
+/* A job added with dependencies which weren't all signalled yet. */
+struct util_queue_pending_job {
+   struct list_head head;
+   struct util_queue_job job;
+   enum util_queue_priority priority;
+   unsigned num_deps;
+   struct util_queue_fence *deps[];
+};
+
+/* Remove the first job of the highest priority lane which isn't empty.
+ * Called with queue->lock held.
+ */
+static void
+util_queue_lane_pop(struct util_queue *queue, struct util_queue_job *job)
+{
+   for (unsigned i = 0; i < UTIL_QUEUE_NUM_PRIORITIES; i++) {
+      struct util_queue_lane *lane = &queue->lanes[i];
+
+      if (!lane->num_queued)
+         continue;
+
+      *job = lane->jobs[lane->read_idx];
+      memset(&lane->jobs[lane->read_idx], 0, sizeof(struct util_queue_job));
+      lane->read_idx = (lane->read_idx + 1) % lane->max_jobs;
+      lane->num_queued--;
+      queue->num_queued--;
+      return;
+   }
+
+   unreachable("no queued job");
+}
+
+/* Grow a full lane. */
+static bool
+util_queue_lane_resize(struct util_queue_lane *lane)
+{
+   unsigned new_max_jobs = lane->max_jobs + 8;
+   struct util_queue_job *jobs =
+      (struct util_queue_job*)calloc(new_max_jobs,
+                                     sizeof(struct util_queue_job));
+   if (!jobs)
+      return false;
+
+   /* Copy all queued jobs into the new list. */
+   unsigned num_jobs = 0;
+   unsigned i = lane->read_idx;
+
+   do {
+      jobs[num_jobs++] = lane->jobs[i];
+      i = (i + 1) % lane->max_jobs;
+   } while (i != lane->write_idx);
+
+   assert(num_jobs == lane->num_queued);
+
+   free(lane->jobs);
+   lane->jobs = jobs;
+   lane->read_idx = 0;
+   lane->write_idx = num_jobs;
+   lane->max_jobs = new_max_jobs;
+   return true;
+}
+
+/* Add a job to its lane if there is space, making the lane larger if
+ * allowed. Called with queue->lock held.
+ */
+static bool
+util_queue_lane_try_push(struct util_queue *queue,
+                         enum util_queue_priority priority,
+                         const struct util_queue_job *job)
+{
+   struct util_queue_lane *lane = &queue->lanes[priority];
+
+#if UTIL_FUTEX_SUPPORTED
+   if (util_queue_is_lockless(queue)) {
+      if (!util_queue_ring_push(lane, job))
+         return false;
+      util_queue_ring_event_signal(&queue->ring_queued_futex);
+      return true;
+   }
+#endif
+
+   if (lane->num_queued == lane->max_jobs &&
+       !(queue->flags & UTIL_QUEUE_INIT_RESIZE_IF_FULL &&
+         queue->total_jobs_size + job->job_size < S_256MB &&
+         util_queue_lane_resize(lane)))
+      return false;
+
+   struct util_queue_job *ptr = &lane->jobs[lane->write_idx];
+   assert(ptr->job == NULL);
+   *ptr = *job;
+
+   lane->write_idx = (lane->write_idx + 1) % lane->max_jobs;
+   lane->num_queued++;
+   queue->total_jobs_size += ptr->job_size;
+   queue->num_queued++;
+   cnd_signal(&queue->has_queued_cond);
+   return true;
+}
+
+static bool
+util_queue_pending_job_is_ready(struct util_queue_pending_job *pending)
+{
+   for (unsigned i = 0; i < pending->num_deps; i++) {
+      if (!util_queue_fence_is_signalled(pending->deps[i]))
+         return false;
+   }
+   return true;
+}
+
+/* Move the jobs whose dependencies have all been signalled to their lanes.
+ * Called with queue->lock held.
+ */
+static void
+util_queue_promote_pending_jobs(struct util_queue *queue)
+{
+   list_for_each_entry_safe(struct util_queue_pending_job, pending,
+                            &queue->pending_jobs, head) {
+      /* If the lane is full, this is retried when the next job completes. */
+      if (!util_queue_pending_job_is_ready(pending) ||
+          !util_queue_lane_try_push(queue, pending->priority, &pending->job))
+         continue;
+
+      list_del(&pending->head);
+      p_atomic_dec(&queue->num_pending);
+      free(pending);
+   }
+}
+
+/* Signal the fences of the jobs still waiting for their dependencies when
+ * all threads are being terminated. Called with queue->lock held.
+ */
+static void
+util_queue_signal_pending_jobs(struct util_queue *queue)
+{
+   list_for_each_entry_safe(struct util_queue_pending_job, pending,
+                            &queue->pending_jobs, head) {
+      if (pending->job.fence)
+         util_queue_fence_signal(pending->job.fence);
+      list_del(&pending->head);
+      free(pending);
+   }
+   queue->num_pending = 0;
+}
+
 /****************************************************************************
  * util_queue implementation
  */
@@ -279,11 +586,50 @@ util_queue_thread_func(void *input)
       u_thread_setname(name);
    }
 
+
+#if UTIL_FUTEX_SUPPORTED
+   if (util_queue_is_lockless(queue)) {
+      struct util_queue_job job;
+
+      while (util_queue_ring_get(queue, thread_index, &job)) {
+         p_atomic_add(&queue->stats.wait_time,
+                      os_time_get_nano() - job.add_time);
+         job.execute(job.job, job.global_data, thread_index);
+         p_atomic_inc(&queue->stats.num_executed);
+         if (job.fence)
+            util_queue_fence_signal(job.fence);
+         if (job.cleanup)
+            job.cleanup(job.job, job.global_data, thread_index);
+
+         if (p_atomic_read(&queue->num_pending)) {
+            mtx_lock(&queue->lock);
+            util_queue_promote_pending_jobs(queue);
+            mtx_unlock(&queue->lock);
+         }
+      }
+
+      /* signal remaining jobs if all threads are being terminated */
+      mtx_lock(&queue->lock);
+      if (p_atomic_read(&queue->num_threads) == 0) {
+         while (util_queue_ring_pop_any(queue, &job)) {
+            if (job.fence)
+               util_queue_fence_signal(job.fence);
+         }
+         util_queue_signal_pending_jobs(queue);
+      }
+      mtx_unlock(&queue->lock);
+      return 0;
+   }
+#endif
+
    while (1) {
       struct util_queue_job job;
 
       mtx_lock(&queue->lock);
-      assert(queue->num_queued >= 0 && queue->num_queued <= queue->max_jobs);
+      assert(queue->num_queued >= 0);
+
+      if (queue->num_pending)
+         util_queue_promote_pending_jobs(queue);
 
       /* wait if the queue is empty */
       while (thread_index < queue->num_threads && queue->num_queued == 0)
@@ -295,18 +641,19 @@ util_queue_thread_func(void *input)
          break;
       }
 
-      job = queue->jobs[queue->read_idx];
-      memset(&queue->jobs[queue->read_idx], 0, sizeof(struct util_queue_job));
-      queue->read_idx = (queue->read_idx + 1) % queue->max_jobs;
+      util_queue_lane_pop(queue, &job);
 
-      queue->num_queued--;
-      cnd_signal(&queue->has_space_cond);
+      /* Producers may be waiting on different lanes. */
+      cnd_broadcast(&queue->has_space_cond);
       if (job.job)
          queue->total_jobs_size -= job.job_size;
       mtx_unlock(&queue->lock);
 
       if (job.job) {
+         p_atomic_add(&queue->stats.wait_time,
+                      os_time_get_nano() - job.add_time);
          job.execute(job.job, job.global_data, thread_index);
+         p_atomic_inc(&queue->stats.num_executed);
          if (job.fence)
             util_queue_fence_signal(job.fence);
          if (job.cleanup)
@@ -317,16 +664,22 @@ util_queue_thread_func(void *input)
    /* signal remaining jobs if all threads are being terminated */
    mtx_lock(&queue->lock);
    if (queue->num_threads == 0) {
-      for (unsigned i = queue->read_idx; i != queue->write_idx;
-           i = (i + 1) % queue->max_jobs) {
-         if (queue->jobs[i].job) {
-            if (queue->jobs[i].fence)
-               util_queue_fence_signal(queue->jobs[i].fence);
-            queue->jobs[i].job = NULL;
+      for (unsigned l = 0; l < UTIL_QUEUE_NUM_PRIORITIES; l++) {
+         struct util_queue_lane *lane = &queue->lanes[l];
+
+         for (unsigned i = lane->read_idx; i != lane->write_idx;
+              i = (i + 1) % lane->max_jobs) {
+            if (lane->jobs[i].job) {
+               if (lane->jobs[i].fence)
+                  util_queue_fence_signal(lane->jobs[i].fence);
+               lane->jobs[i].job = NULL;
+            }
          }
+         lane->read_idx = lane->write_idx;
+         lane->num_queued = 0;
       }
-      queue->read_idx = queue->write_idx;
       queue->num_queued = 0;
+      util_queue_signal_pending_jobs(queue);
    }
    mtx_unlock(&queue->lock);
    return 0;
@@ -435,6 +788,10 @@ util_queue_init(struct util_queue *queue,
       snprintf(queue->name, sizeof(queue->name), "%s", name);
    }
 
+#if !UTIL_FUTEX_SUPPORTED
+   flags &= ~UTIL_QUEUE_INIT_LOCKLESS;
+#endif
+
    queue->flags = flags;
    queue->max_threads = num_threads;
    queue->num_threads = (flags & UTIL_QUEUE_INIT_SCALE_THREADS) ? 1 : num_threads;
@@ -448,10 +805,31 @@ util_queue_init(struct util_queue *queue,
    cnd_init(&queue->has_queued_cond);
    cnd_init(&queue->has_space_cond);
 
-   queue->jobs = (struct util_queue_job*)
-                 calloc(max_jobs, sizeof(struct util_queue_job));
-   if (!queue->jobs)
-      goto fail;
+   list_inithead(&queue->pending_jobs);
+
+   for (i = 0; i < UTIL_QUEUE_NUM_PRIORITIES; i++) {
+      struct util_queue_lane *lane = &queue->lanes[i];
+
+      if (util_queue_is_lockless(queue)) {
+         /* The ring position is masked, so the size must be a power of
+          * two.
+          */
+         lane->max_jobs = util_next_power_of_two(MAX2(max_jobs, 2));
+         lane->ring_mask = lane->max_jobs - 1;
+         lane->ring = (struct util_queue_ring_slot*)
+                      calloc(lane->max_jobs, sizeof(struct util_queue_ring_slot));
+         if (!lane->ring)
+            goto fail;
+         for (unsigned j = 0; j < lane->max_jobs; j++)
+            lane->ring[j].seq = j;
+      } else {
+         lane->max_jobs = max_jobs;
+         lane->jobs = (struct util_queue_job*)
+                      calloc(max_jobs, sizeof(struct util_queue_job));
+         if (!lane->jobs)
+            goto fail;
+      }
+   }
 
    queue->threads = (thrd_t*) calloc(queue->max_threads, sizeof(thrd_t));
    if (!queue->threads)
@@ -477,12 +855,15 @@ util_queue_init(struct util_queue *queue,
 fail:
    free(queue->threads);
 
-   if (queue->jobs) {
-      cnd_destroy(&queue->has_space_cond);
-      cnd_destroy(&queue->has_queued_cond);
-      mtx_destroy(&queue->lock);
-      free(queue->jobs);
+   cnd_destroy(&queue->has_space_cond);
+   cnd_destroy(&queue->has_queued_cond);
+   mtx_destroy(&queue->lock);
+   simple_mtx_destroy(&queue->finish_lock);
+   for (i = 0; i < UTIL_QUEUE_NUM_PRIORITIES; i++) {
+      free(queue->lanes[i].jobs);
+      free(queue->lanes[i].ring);
    }
+
    /* also util_queue_is_initialized can be used to check for success */
    memset(queue, 0, sizeof(*queue));
    return false;
@@ -510,6 +891,10 @@ util_queue_kill_threads(struct util_queue *queue, unsigned keep_num_threads,
     */
    queue->num_threads = keep_num_threads;
    cnd_broadcast(&queue->has_queued_cond);
+#if UTIL_FUTEX_SUPPORTED
+   if (util_queue_is_lockless(queue))
+      util_queue_ring_event_signal(&queue->ring_queued_futex);
+#endif
    mtx_unlock(&queue->lock);
 
    for (i = keep_num_threads; i < old_num_threads; i++)
@@ -540,23 +925,41 @@ util_queue_destroy(struct util_queue *queue)
    cnd_destroy(&queue->has_queued_cond);
    simple_mtx_destroy(&queue->finish_lock);
    mtx_destroy(&queue->lock);
-   free(queue->jobs);
+   for (unsigned i = 0; i < UTIL_QUEUE_NUM_PRIORITIES; i++) {
+      free(queue->lanes[i].jobs);
+      free(queue->lanes[i].ring);
+   }
    free(queue->threads);
 }
 
+/**
+ * Add a job to the queue.
+ *
+ * Jobs of a higher priority lane are always started before the jobs of the
+ * lower ones. Within a lane, jobs are started in the order they were added.
+ *
+ * The job is only started once all the \p deps fences are signalled. They
+ * must be fences of jobs of the same queue, so that a dependency graph of
+ * jobs can be submitted at once and the threads pick the jobs up as their
+ * dependencies complete.
+ */
 void
-util_queue_add_job(struct util_queue *queue,
-                   void *job,
-                   struct util_queue_fence *fence,
-                   util_queue_execute_func execute,
-                   util_queue_execute_func cleanup,
-                   const size_t job_size)
+util_queue_add_job_with_deps(struct util_queue *queue,
+                             void *job,
+                             struct util_queue_fence *fence,
+                             util_queue_execute_func execute,
+                             util_queue_execute_func cleanup,
+                             const size_t job_size,
+                             enum util_queue_priority priority,
+                             struct util_queue_fence *const *deps,
+                             unsigned num_deps)
 {
-   struct util_queue_job *ptr;
+   assert(priority < UTIL_QUEUE_NUM_PRIORITIES);
 
-   mtx_lock(&queue->lock);
-   if (queue->num_threads == 0) {
-      mtx_unlock(&queue->lock);
+   struct util_queue_lane *lane = &queue->lanes[priority];
+   struct util_queue_pending_job *pending = NULL;
+
+   if (p_atomic_read(&queue->num_threads) == 0) {
       /* well no good option here, but any leaks will be
        * short-lived as things are shutting down..
        */
@@ -566,7 +969,67 @@ util_queue_add_job(struct util_queue *queue,
    if (fence)
       util_queue_fence_reset(fence);
 
-   assert(queue->num_queued >= 0 && queue->num_queued <= queue->max_jobs);
+   struct util_queue_job entry = {
+      .job = job,
+      .global_data = queue->global_data,
+      .job_size = job_size,
+      .fence = fence,
+      .execute = execute,
+      .cleanup = cleanup,
+      .add_time = os_time_get_nano(),
+   };
+
+   p_atomic_inc(&queue->stats.num_added);
+
+   for (unsigned i = 0; i < num_deps; i++) {
+      if (!util_queue_fence_is_signalled(deps[i])) {
+         pending = (struct util_queue_pending_job*)
+            malloc(sizeof(*pending) + num_deps * sizeof(pending->deps[0]));
+         break;
+      }
+   }
+
+   if (pending) {
+      pending->job = entry;
+      pending->priority = priority;
+      pending->num_deps = num_deps;
+      memcpy(pending->deps, deps, num_deps * sizeof(deps[0]));
+
+      mtx_lock(&queue->lock);
+      p_atomic_inc(&queue->num_pending);
+      list_addtail(&pending->head, &queue->pending_jobs);
+      /* The dependencies may have completed in the meantime. */
+      util_queue_promote_pending_jobs(queue);
+      mtx_unlock(&queue->lock);
+      return;
+   }
+
+   /* Only wait for the dependencies if the allocation failed. */
+   for (unsigned i = 0; i < num_deps; i++)
+      util_queue_fence_wait(deps[i]);
+
+#if UTIL_FUTEX_SUPPORTED
+   if (util_queue_is_lockless(queue)) {
+      /* Scale the number of threads up if there's already one job waiting. */
+      if (queue->flags & UTIL_QUEUE_INIT_SCALE_THREADS &&
+          execute != util_queue_finish_execute &&
+          p_atomic_read(&queue->num_threads) < queue->max_threads &&
+          p_atomic_read(&lane->ring_tail) != p_atomic_read(&lane->ring_head)) {
+         util_queue_adjust_num_threads(queue, queue->num_threads + 1);
+      }
+
+      util_queue_ring_add(queue, lane, &entry);
+      return;
+   }
+#endif
+
+   mtx_lock(&queue->lock);
+   if (queue->num_threads == 0) {
+      mtx_unlock(&queue->lock);
+      return;
+   }
+
+   assert(queue->num_queued >= 0);
 
    /* Scale the number of threads up if there's already one job waiting. */
    if (queue->num_queued > 0 &&
@@ -576,58 +1039,31 @@ util_queue_add_job(struct util_queue *queue,
       util_queue_adjust_num_threads(queue, queue->num_threads + 1);
    }
 
-   if (queue->num_queued == queue->max_jobs) {
-      if (queue->flags & UTIL_QUEUE_INIT_RESIZE_IF_FULL &&
-          queue->total_jobs_size + job_size < S_256MB) {
-         /* If the queue is full, make it larger to avoid waiting for a free
-          * slot.
-          */
-         unsigned new_max_jobs = queue->max_jobs + 8;
-         struct util_queue_job *jobs =
-            (struct util_queue_job*)calloc(new_max_jobs,
-                                           sizeof(struct util_queue_job));
-         assert(jobs);
-
-         /* Copy all queued jobs into the new list. */
-         unsigned num_jobs = 0;
-         unsigned i = queue->read_idx;
-
-         do {
-            jobs[num_jobs++] = queue->jobs[i];
-            i = (i + 1) % queue->max_jobs;
-         } while (i != queue->write_idx);
-
-         assert(num_jobs == queue->num_queued);
-
-         free(queue->jobs);
-         queue->jobs = jobs;
-         queue->read_idx = 0;
-         queue->write_idx = num_jobs;
-         queue->max_jobs = new_max_jobs;
-      } else {
-         /* Wait until there is a free slot. */
-         while (queue->num_queued == queue->max_jobs)
-            cnd_wait(&queue->has_space_cond, &queue->lock);
-      }
-   }
+   if (!util_queue_lane_try_push(queue, priority, &entry)) {
+      /* Wait until there is a free slot. */
+      int64_t t0 = os_time_get_nano();
+      while (lane->num_queued == lane->max_jobs)
+         cnd_wait(&queue->has_space_cond, &queue->lock);
+      p_atomic_add(&queue->stats.full_wait_time, os_time_get_nano() - t0);
 
-   ptr = &queue->jobs[queue->write_idx];
-   assert(ptr->job == NULL);
-   ptr->job = job;
-   ptr->global_data = queue->global_data;
-   ptr->fence = fence;
-   ptr->execute = execute;
-   ptr->cleanup = cleanup;
-   ptr->job_size = job_size;
-
-   queue->write_idx = (queue->write_idx + 1) % queue->max_jobs;
-   queue->total_jobs_size += ptr->job_size;
-
-   queue->num_queued++;
-   cnd_signal(&queue->has_queued_cond);
+      ASSERTED bool pushed = util_queue_lane_try_push(queue, priority, &entry);
+      assert(pushed);
+   }
    mtx_unlock(&queue->lock);
 }
 
+void
+util_queue_add_job(struct util_queue *queue,
+                   void *job,
+                   struct util_queue_fence *fence,
+                   util_queue_execute_func execute,
+                   util_queue_execute_func cleanup,
+                   const size_t job_size)
+{
+   util_queue_add_job_with_deps(queue, job, fence, execute, cleanup, job_size,
+                                UTIL_QUEUE_PRIORITY_NORMAL, NULL, 0);
+}
+
 /**
  * Remove a queued job. If the job hasn't started execution, it's removed from
  * the queue. If the job has started execution, the function waits for it to
@@ -647,23 +1083,50 @@ util_queue_drop_job(struct util_queue *queue, struct util_queue_fence *fence)
       return;
 
    mtx_lock(&queue->lock);
-   for (unsigned i = queue->read_idx; i != queue->write_idx;
-        i = (i + 1) % queue->max_jobs) {
-      if (queue->jobs[i].fence == fence) {
-         if (queue->jobs[i].cleanup)
-            queue->jobs[i].cleanup(queue->jobs[i].job, queue->global_data, -1);
-
-         /* Just clear it. The threads will treat as a no-op job. */
-         memset(&queue->jobs[i], 0, sizeof(queue->jobs[i]));
+   list_for_each_entry(struct util_queue_pending_job, pending,
+                       &queue->pending_jobs, head) {
+      if (pending->job.fence == fence) {
+         if (pending->job.cleanup)
+            pending->job.cleanup(pending->job.job, queue->global_data, -1);
+
+         list_del(&pending->head);
+         p_atomic_dec(&queue->num_pending);
+         free(pending);
          removed = true;
          break;
       }
    }
-   mtx_unlock(&queue->lock);
 
-   if (removed)
+   /* Jobs can't be removed from the middle of the lock-free ring. */
+   for (unsigned l = 0; l < UTIL_QUEUE_NUM_PRIORITIES; l++) {
+      struct util_queue_lane *lane = &queue->lanes[l];
+
+      if (removed || util_queue_is_lockless(queue))
+         break;
+
+      for (unsigned i = lane->read_idx; i != lane->write_idx;
+           i = (i + 1) % lane->max_jobs) {
+         if (lane->jobs[i].fence == fence) {
+            if (lane->jobs[i].cleanup)
+               lane->jobs[i].cleanup(lane->jobs[i].job, queue->global_data, -1);
+
+            /* Just clear it. The threads will treat as a no-op job. */
+            memset(&lane->jobs[i], 0, sizeof(lane->jobs[i]));
+            removed = true;
+            break;
+         }
+      }
+   }
+
+   if (removed) {
+      p_atomic_inc(&queue->stats.num_dropped);
       util_queue_fence_signal(fence);
-   else
+      /* Jobs depending on the dropped one may be ready now. */
+      util_queue_promote_pending_jobs(queue);
+   }
+   mtx_unlock(&queue->lock);
+
+   if (!removed)
       util_queue_fence_wait(fence);
 }
 
@@ -691,10 +1154,14 @@ util_queue_finish(struct util_queue *queue)
    fences = malloc(queue->num_threads * sizeof(*fences));
    util_barrier_init(&barrier, queue->num_threads);
 
+   /* The barrier jobs go into the lowest priority lane, so that they only
+    * start after all the jobs added before them.
+    */
    for (unsigned i = 0; i < queue->num_threads; ++i) {
       util_queue_fence_init(&fences[i]);
-      util_queue_add_job(queue, &barrier, &fences[i],
-                         util_queue_finish_execute, NULL, 0);
+      util_queue_add_job_with_deps(queue, &barrier, &fences[i],
+                                   util_queue_finish_execute, NULL, 0,
+                                   UTIL_QUEUE_PRIORITY_BACKGROUND, NULL, 0);
    }
 
    for (unsigned i = 0; i < queue->num_threads; ++i) {
@@ -715,3 +1182,17 @@ util_queue_get_thread_time_nano(struct util_queue *queue, unsigned thread_index)
 
    return util_thread_get_time_nano(queue->threads[thread_index]);
 }
+
+/**
+ * Return the statistics of the queue since it was created. The values are
+ * read without synchronization and may be slightly out of date.
+ */
+void
+util_queue_get_stats(struct util_queue *queue, struct util_queue_stats *stats)
+{
+   stats->num_added = p_atomic_read(&queue->stats.num_added);
+   stats->num_executed = p_atomic_read(&queue->stats.num_executed);
+   stats->num_dropped = p_atomic_read(&queue->stats.num_dropped);
+   stats->wait_time = p_atomic_read(&queue->stats.wait_time);
+   stats->full_wait_time = p_atomic_read(&queue->stats.full_wait_time);
+}
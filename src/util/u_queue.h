@@ -51,6 +51,12 @@ extern "C" {
 #define UTIL_QUEUE_INIT_RESIZE_IF_FULL            (1 << 1)
 #define UTIL_QUEUE_INIT_SET_FULL_THREAD_AFFINITY  (1 << 2)
 #define UTIL_QUEUE_INIT_SCALE_THREADS             (1 << 3)
+/* Use a lock-free ring with futex wakeups instead of the mutex-protected
+ * one. Ignored if futexes aren't supported. The ring can't be resized, so
+ * UTIL_QUEUE_INIT_RESIZE_IF_FULL has no effect, and util_queue_drop_job
+ * waits for the job instead of removing it.
+ */
+#define UTIL_QUEUE_INIT_LOCKLESS                  (1 << 4)
 
 #if UTIL_FUTEX_SUPPORTED
 #define UTIL_QUEUE_FENCE_FUTEX
@@ -200,6 +206,46 @@ struct util_queue_job {
    struct util_queue_fence *fence;
    util_queue_execute_func execute;
    util_queue_execute_func cleanup;
+   int64_t add_time; /* os_time_get_nano() when the job was added */
+};
+
+/* Slot of the UTIL_QUEUE_INIT_LOCKLESS ring. */
+struct util_queue_ring_slot {
+   /* Sequence number: equal to the producer position when the slot is
+    * free, and to the consumer position + 1 when it holds a job.
+    */
+   uint32_t seq;
+   struct util_queue_job job;
+};
+
+/* Jobs of a higher priority lane are always started first. */
+enum util_queue_priority {
+   UTIL_QUEUE_PRIORITY_IMMEDIATE,
+   UTIL_QUEUE_PRIORITY_NORMAL,
+   UTIL_QUEUE_PRIORITY_BACKGROUND,
+   UTIL_QUEUE_NUM_PRIORITIES,
+};
+
+struct util_queue_lane {
+   int num_queued;
+   int max_jobs;
+   int write_idx, read_idx; /* ring buffer pointers */
+   struct util_queue_job *jobs;
+
+   /* UTIL_QUEUE_INIT_LOCKLESS ring */
+   struct util_queue_ring_slot *ring;
+   uint32_t ring_mask;
+   uint32_t ring_head; /* next position to pop */
+   uint32_t ring_tail; /* next position to push */
+};
+
+/* Statistics of a queue, see util_queue_get_stats. */
+struct util_queue_stats {
+   uint64_t num_added;       /* jobs added */
+   uint64_t num_executed;    /* jobs executed */
+   uint64_t num_dropped;     /* jobs removed by util_queue_drop_job */
+   int64_t wait_time;        /* total time jobs waited in the queue, in ns */
+   int64_t full_wait_time;   /* total time add_job waited for space, in ns */
 };
 
 /* Put this into your context. */
@@ -211,15 +257,26 @@ struct util_queue {
    cnd_t has_space_cond;
    thrd_t *threads;
    unsigned flags;
-   int num_queued;
+   int num_queued; /* in all lanes */
    unsigned max_threads;
    unsigned num_threads; /* decreasing this number will terminate threads */
    int max_jobs;
-   int write_idx, read_idx; /* ring buffer pointers */
    size_t total_jobs_size;  /* memory use of all jobs in the queue */
-   struct util_queue_job *jobs;
+   struct util_queue_lane lanes[UTIL_QUEUE_NUM_PRIORITIES];
    void *global_data;
 
+   /* jobs waiting for their dependencies, protected by lock */
+   struct list_head pending_jobs;
+   unsigned num_pending;
+
+   /* UTIL_QUEUE_INIT_LOCKLESS state. The futex words are bumped by 2 on
+    * every push/pop, bit 0 is set when a thread may be waiting on them.
+    */
+   uint32_t ring_queued_futex;
+   uint32_t ring_space_futex;
+
+   struct util_queue_stats stats;
+
    /* for cleanup at exit(), protected by exit_mutex */
    struct list_head head;
 };
@@ -239,6 +296,15 @@ void util_queue_add_job(struct util_queue *queue,
                         util_queue_execute_func execute,
                         util_queue_execute_func cleanup,
                         const size_t job_size);
+void util_queue_add_job_with_deps(struct util_queue *queue,
+                                  void *job,
+                                  struct util_queue_fence *fence,
+                                  util_queue_execute_func execute,
+                                  util_queue_execute_func cleanup,
+                                  const size_t job_size,
+                                  enum util_queue_priority priority,
+                                  struct util_queue_fence *const *deps,
+                                  unsigned num_deps);
 void util_queue_drop_job(struct util_queue *queue,
                          struct util_queue_fence *fence);
 
@@ -254,6 +320,9 @@ util_queue_adjust_num_threads(struct util_queue *queue, unsigned num_threads);
 int64_t util_queue_get_thread_time_nano(struct util_queue *queue,
                                         unsigned thread_index);
 
+void util_queue_get_stats(struct util_queue *queue,
+                          struct util_queue_stats *stats);
+
 /* util_queue needs to be cleared to zeroes for this to work */
 static inline bool
 util_queue_is_initialized(struct util_queue *queue)
@@ -29,6 +29,7 @@
 
 struct util_vma_hole {
    struct list_head link;
+   struct rb_node node;
    uint64_t offset;
    uint64_t size;
 };
@@ -42,11 +43,65 @@ struct util_vma_hole {
 #define util_vma_foreach_hole_safe_rev(_hole, _heap) \
    list_for_each_entry_safe_rev(struct util_vma_hole, _hole, &(_heap)->holes, link)
 
+static int
+util_vma_hole_cmp(const struct rb_node *a, const struct rb_node *b)
+{
+   const struct util_vma_hole *ha = rb_node_data(struct util_vma_hole, a, node);
+   const struct util_vma_hole *hb = rb_node_data(struct util_vma_hole, b, node);
+
+   if (ha->offset > hb->offset)
+      return -1;
+   if (ha->offset < hb->offset)
+      return 1;
+   return 0;
+}
+
+/* Holes never overlap, so moving a hole's offset within the range it
+ * covered keeps the tree ordered; only creating and deleting holes touches
+ * the tree.
+ */
+static void
+util_vma_heap_insert_hole(struct util_vma_heap *heap,
+                          struct util_vma_hole *hole)
+{
+   rb_tree_insert(&heap->hole_tree, &hole->node, util_vma_hole_cmp);
+}
+
+static void
+util_vma_heap_remove_hole(struct util_vma_heap *heap,
+                          struct util_vma_hole *hole)
+{
+   rb_tree_remove(&heap->hole_tree, &hole->node);
+   list_del(&hole->link);
+   free(hole);
+}
+
+/* Returns the hole with the highest offset <= offset, if any. */
+static struct util_vma_hole *
+util_vma_heap_find_hole_below(struct util_vma_heap *heap, uint64_t offset)
+{
+   struct util_vma_hole *low_hole = NULL;
+   struct rb_node *n = heap->hole_tree.root;
+
+   while (n != NULL) {
+      struct util_vma_hole *hole = rb_node_data(struct util_vma_hole, n, node);
+      if (hole->offset <= offset) {
+         low_hole = hole;
+         n = n->right;
+      } else {
+         n = n->left;
+      }
+   }
+
+   return low_hole;
+}
+
 void
 util_vma_heap_init(struct util_vma_heap *heap,
                    uint64_t start, uint64_t size)
 {
    list_inithead(&heap->holes);
+   rb_tree_init(&heap->hole_tree);
    util_vma_heap_free(heap, start, size);
 
    /* Default to using high addresses */
@@ -92,7 +147,7 @@ util_vma_heap_validate(struct util_vma_heap *heap)
 #endif
 
 static void
-util_vma_hole_alloc(struct util_vma_hole *hole,
+util_vma_hole_alloc(struct util_vma_heap *heap, struct util_vma_hole *hole,
                     uint64_t offset, uint64_t size)
 {
    assert(hole->offset <= offset);
@@ -100,8 +155,7 @@ util_vma_hole_alloc(struct util_vma_hole *hole,
 
    if (offset == hole->offset && size == hole->size) {
       /* Just get rid of the hole. */
-      list_del(&hole->link);
-      free(hole);
+      util_vma_heap_remove_hole(heap, hole);
       return;
    }
 
@@ -136,6 +190,7 @@ util_vma_hole_alloc(struct util_vma_hole *hole,
     * from high to low.
     */
    list_addtail(&high_hole->link, &hole->link);
+   util_vma_heap_insert_hole(heap, high_hole);
 }
 
 uint64_t
@@ -169,7 +224,7 @@ util_vma_heap_alloc(struct util_vma_heap *heap,
          if (offset < hole->offset)
             continue;
 
-         util_vma_hole_alloc(hole, offset, size);
+         util_vma_hole_alloc(heap, hole, offset, size);
          util_vma_heap_validate(heap);
          return offset;
       }
@@ -190,7 +245,7 @@ util_vma_heap_alloc(struct util_vma_heap *heap,
             offset += pad;
          }
 
-         util_vma_hole_alloc(hole, offset, size);
+         util_vma_hole_alloc(heap, hole, offset, size);
          util_vma_heap_validate(heap);
          return offset;
       }
@@ -217,25 +272,16 @@ util_vma_heap_alloc_addr(struct util_vma_heap *heap,
     */
    assert(offset + size == 0 || offset + size > offset);
 
-   /* Find the hole if one exists. */
-   util_vma_foreach_hole_safe(hole, heap) {
-      if (hole->offset > offset)
-         continue;
-
-      /* Holes are ordered high-to-low so the first hole we find with
-       * hole->offset <= is our hole.  If it's not big enough to contain the
-       * requested range, then the allocation fails.
-       */
-      assert(hole->offset <= offset);
-      if (hole->size < offset - hole->offset + size)
-         return false;
-
-      util_vma_hole_alloc(hole, offset, size);
-      return true;
-   }
+   /* The only hole that can contain the range is the highest one starting
+    * at or below offset.  If it's not big enough to contain the requested
+    * range, then the allocation fails.
+    */
+   struct util_vma_hole *hole = util_vma_heap_find_hole_below(heap, offset);
+   if (hole == NULL || hole->size < offset - hole->offset + size)
+      return false;
 
-   /* We didn't find a suitable hole */
-   return false;
+   util_vma_hole_alloc(heap, hole, offset, size);
+   return true;
 }
 
 void
@@ -257,15 +303,17 @@ util_vma_heap_free(struct util_vma_heap *heap,
 
    util_vma_heap_validate(heap);
 
-   /* Find immediately higher and lower holes if they exist. */
-   struct util_vma_hole *high_hole = NULL, *low_hole = NULL;
-   util_vma_foreach_hole(hole, heap) {
-      if (hole->offset <= offset) {
-         low_hole = hole;
-         break;
-      }
-      high_hole = hole;
-   }
+   /* Find immediately higher and lower holes if they exist.  The list is
+    * ordered high to low, so the higher hole sits right before the lower one,
+    * or at the tail if there's no lower hole.
+    */
+   struct util_vma_hole *high_hole = NULL, *low_hole;
+   low_hole = util_vma_heap_find_hole_below(heap, offset);
+
+   struct list_head *high_link = low_hole ? low_hole->link.prev :
+                                            heap->holes.prev;
+   if (high_link != &heap->holes)
+      high_hole = list_entry(high_link, struct util_vma_hole, link);
 
    if (high_hole)
       assert(offset + size <= high_hole->offset);
@@ -280,8 +328,7 @@ util_vma_heap_free(struct util_vma_heap *heap,
    if (low_adjacent && high_adjacent) {
       /* Merge the two holes */
       low_hole->size += size + high_hole->size;
-      list_del(&high_hole->link);
-      free(high_hole);
+      util_vma_heap_remove_hole(heap, high_hole);
    } else if (low_adjacent) {
       /* Merge into the low hole */
       low_hole->size += size;
@@ -301,6 +348,7 @@ util_vma_heap_free(struct util_vma_heap *heap,
          list_add(&hole->link, &high_hole->link);
       else
          list_add(&hole->link, &heap->holes);
+      util_vma_heap_insert_hole(heap, hole);
    }
 
    util_vma_heap_validate(heap);
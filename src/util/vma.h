@@ -28,6 +28,7 @@
 #include <stdio.h>
 
 #include "list.h"
+#include "rb_tree.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -36,6 +37,9 @@ extern "C" {
 struct util_vma_heap {
    struct list_head holes;
 
+   /** The same holes indexed by offset, for finding neighbours on free */
+   struct rb_tree hole_tree;
+
    /** If true, util_vma_heap_alloc will prefer high addresses
     *
     * Default is true.
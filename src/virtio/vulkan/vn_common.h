@@ -109,6 +109,7 @@ enum vn_perf {
    VN_PERF_NO_ASYNC_QUEUE_SUBMIT = 1ull << 2,
    VN_PERF_NO_EVENT_FEEDBACK = 1ull << 3,
    VN_PERF_NO_FENCE_FEEDBACK = 1ull << 4,
+   VN_PERF_NO_ASYNC_IMAGE_CREATE = 1ull << 5,
 };
 
 typedef uint64_t vn_object_id;
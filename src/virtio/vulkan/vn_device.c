@@ -383,10 +383,14 @@ vn_device_init(struct vn_device *dev,
    if (result != VK_SUCCESS)
       goto out_memory_pool_fini;
 
-   result = vn_device_feedback_pool_init(dev);
+   result = vn_image_reqs_cache_init(dev);
    if (result != VK_SUCCESS)
       goto out_buffer_cache_fini;
 
+   result = vn_device_feedback_pool_init(dev);
+   if (result != VK_SUCCESS)
+      goto out_image_reqs_cache_fini;
+
    result = vn_feedback_cmd_pools_init(dev);
    if (result != VK_SUCCESS)
       goto out_feedback_pool_fini;
@@ -403,6 +407,9 @@ out_cmd_pools_fini:
 out_feedback_pool_fini:
    vn_device_feedback_pool_fini(dev);
 
+out_image_reqs_cache_fini:
+   vn_image_reqs_cache_fini(dev);
+
 out_buffer_cache_fini:
    vn_buffer_cache_fini(dev);
 
@@ -480,6 +487,8 @@ vn_DestroyDevice(VkDevice device, const VkAllocationCallbacks *pAllocator)
 
    vn_device_feedback_pool_fini(dev);
 
+   vn_image_reqs_cache_fini(dev);
+
    vn_buffer_cache_fini(dev);
 
    for (uint32_t i = 0; i < ARRAY_SIZE(dev->memory_pools); i++)
@@ -16,6 +16,7 @@
 #include "vn_buffer.h"
 #include "vn_device_memory.h"
 #include "vn_feedback.h"
+#include "vn_image.h"
 
 struct vn_device {
    struct vn_device_base base;
@@ -31,6 +32,7 @@ struct vn_device {
    struct vn_device_memory_pool memory_pools[VK_MAX_MEMORY_TYPES];
 
    struct vn_buffer_cache buffer_cache;
+   struct vn_image_reqs_cache image_reqs_cache;
 
    struct vn_feedback_pool feedback_pool;
 
@@ -45,6 +45,7 @@ vn_device_memory_pool_grow_alloc(struct vn_device *dev,
    vn_object_base_init(&mem->base, VK_OBJECT_TYPE_DEVICE_MEMORY, &dev->base);
    mem->size = size;
    mem->flags = mem_flags;
+   mem->refcount = VN_REFCOUNT_INIT(1);
 
    mem_handle = vn_device_memory_to_handle(mem);
    result = vn_call_vkAllocateMemory(
@@ -60,6 +61,12 @@ vn_device_memory_pool_grow_alloc(struct vn_device *dev,
       goto fail;
    }
 
+   /* pools of memory types that can't be mapped never need a bo */
+   if (!(mem_flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) {
+      *out_mem = mem;
+      return VK_SUCCESS;
+   }
+
    result = vn_renderer_bo_create_from_device_memory(
       dev->renderer, mem->size, mem->base.id, mem->flags, 0, &mem->base_bo);
    if (result != VK_SUCCESS) {
@@ -91,9 +98,7 @@ static struct vn_device_memory *
 vn_device_memory_pool_ref(struct vn_device *dev,
                           struct vn_device_memory *pool_mem)
 {
-   assert(pool_mem->base_bo);
-
-   vn_renderer_bo_ref(dev->renderer, pool_mem->base_bo);
+   vn_refcount_inc(&pool_mem->refcount);
 
    return pool_mem;
 }
@@ -104,11 +109,12 @@ vn_device_memory_pool_unref(struct vn_device *dev,
 {
    const VkAllocationCallbacks *alloc = &dev->base.base.alloc;
 
-   assert(pool_mem->base_bo);
-
-   if (!vn_renderer_bo_unref(dev->renderer, pool_mem->base_bo))
+   if (!vn_refcount_dec(&pool_mem->refcount))
       return;
 
+   if (pool_mem->base_bo)
+      vn_renderer_bo_unref(dev->renderer, pool_mem->base_bo);
+
    /* wait on valid bo_roundtrip_seqno before vkFreeMemory */
    if (pool_mem->bo_roundtrip_seqno_valid)
       vn_instance_wait_roundtrip(dev->instance, pool_mem->bo_roundtrip_seqno);
@@ -205,8 +211,13 @@ vn_device_memory_should_suballocate(const struct vn_device *dev,
     * many more KVM memslots.
     */
 
-   /* consider host-visible memory only */
-   if (!(flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
+   /* Memory types that can't be mapped don't take up memslots, but each
+    * allocation still costs a synchronous vkAllocateMemory on the renderer.
+    * Suballocate them too, except for the ones whose backing storage is
+    * special.
+    */
+   if (flags & (VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT |
+                VK_MEMORY_PROPERTY_PROTECTED_BIT))
       return false;
 
    /* reject larger allocations */
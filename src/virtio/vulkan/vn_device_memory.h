@@ -27,6 +27,8 @@ struct vn_device_memory {
 
    /* non-NULL when suballocated */
    struct vn_device_memory *base_memory;
+   /* only used by pool memories, counts the suballocations and the pool */
+   struct vn_refcount refcount;
    /* non-NULL when mappable or external */
    struct vn_renderer_bo *base_bo;
    /* enforce kernel and ring ordering between memory export and free */
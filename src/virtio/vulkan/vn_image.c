@@ -15,15 +15,171 @@
 #include "venus-protocol/vn_protocol_driver_sampler.h"
 #include "venus-protocol/vn_protocol_driver_sampler_ycbcr_conversion.h"
 
+#include "util/hash_table.h"
+
 #include "vn_android.h"
 #include "vn_device.h"
 #include "vn_device_memory.h"
 #include "vn_wsi.h"
 
+/* image memory requirements cache */
+
+/* Limit the number of cached create infos so that apps creating images of
+ * many different sizes don't grow the cache without bound.
+ */
+#define VN_IMAGE_REQS_CACHE_MAX_ENTRIES 256
+
+struct vn_image_reqs_cache_key {
+   uint32_t flags;
+   uint32_t image_type;
+   uint32_t format;
+   uint32_t width;
+   uint32_t height;
+   uint32_t depth;
+   uint32_t mip_levels;
+   uint32_t array_layers;
+   uint32_t samples;
+   uint32_t tiling;
+   uint32_t usage;
+   uint32_t initial_layout;
+};
+
+struct vn_image_reqs_cache_entry {
+   struct vn_image_reqs_cache_key key;
+
+   uint32_t plane_count;
+   struct vn_image_memory_requirements requirements[4];
+};
+
+static uint32_t
+vn_image_reqs_cache_key_hash(const void *key)
+{
+   return _mesa_hash_data(key, sizeof(struct vn_image_reqs_cache_key));
+}
+
+static bool
+vn_image_reqs_cache_key_equal(const void *a, const void *b)
+{
+   return !memcmp(a, b, sizeof(struct vn_image_reqs_cache_key));
+}
+
+static bool
+vn_image_reqs_cache_key_init(const VkImageCreateInfo *create_info,
+                             struct vn_image_reqs_cache_key *key)
+{
+   if (VN_PERF(NO_ASYNC_IMAGE_CREATE))
+      return false;
+
+   /* cache only VK_SHARING_MODE_EXCLUSIVE and without pNext for simplicity */
+   if (create_info->pNext ||
+       create_info->sharingMode != VK_SHARING_MODE_EXCLUSIVE)
+      return false;
+
+   *key = (struct vn_image_reqs_cache_key){
+      .flags = create_info->flags,
+      .image_type = create_info->imageType,
+      .format = create_info->format,
+      .width = create_info->extent.width,
+      .height = create_info->extent.height,
+      .depth = create_info->extent.depth,
+      .mip_levels = create_info->mipLevels,
+      .array_layers = create_info->arrayLayers,
+      .samples = create_info->samples,
+      .tiling = create_info->tiling,
+      .usage = create_info->usage,
+      .initial_layout = create_info->initialLayout,
+   };
+   return true;
+}
+
+VkResult
+vn_image_reqs_cache_init(struct vn_device *dev)
+{
+   struct vn_image_reqs_cache *cache = &dev->image_reqs_cache;
+
+   cache->ht = _mesa_hash_table_create(NULL, vn_image_reqs_cache_key_hash,
+                                       vn_image_reqs_cache_key_equal);
+   if (!cache->ht)
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+   simple_mtx_init(&cache->mutex, mtx_plain);
+   return VK_SUCCESS;
+}
+
+void
+vn_image_reqs_cache_fini(struct vn_device *dev)
+{
+   const VkAllocationCallbacks *alloc = &dev->base.base.alloc;
+   struct vn_image_reqs_cache *cache = &dev->image_reqs_cache;
+
+   hash_table_foreach(cache->ht, entry)
+      vk_free(alloc, entry->data);
+   _mesa_hash_table_destroy(cache->ht, NULL);
+
+   simple_mtx_destroy(&cache->mutex);
+}
+
+static bool
+vn_image_reqs_cache_get(struct vn_device *dev,
+                        const struct vn_image_reqs_cache_key *key,
+                        struct vn_image *img)
+{
+   struct vn_image_reqs_cache *cache = &dev->image_reqs_cache;
+   bool found = false;
+
+   simple_mtx_lock(&cache->mutex);
+   struct hash_entry *hash_entry = _mesa_hash_table_search(cache->ht, key);
+   if (hash_entry) {
+      const struct vn_image_reqs_cache_entry *entry = hash_entry->data;
+      for (uint32_t i = 0; i < entry->plane_count; i++) {
+         img->requirements[i].memory.memoryRequirements =
+            entry->requirements[i].memory.memoryRequirements;
+         img->requirements[i].dedicated.prefersDedicatedAllocation =
+            entry->requirements[i].dedicated.prefersDedicatedAllocation;
+         img->requirements[i].dedicated.requiresDedicatedAllocation =
+            entry->requirements[i].dedicated.requiresDedicatedAllocation;
+      }
+      found = true;
+   }
+   simple_mtx_unlock(&cache->mutex);
+
+   return found;
+}
+
 static void
-vn_image_init_memory_requirements(struct vn_image *img,
-                                  struct vn_device *dev,
-                                  const VkImageCreateInfo *create_info)
+vn_image_reqs_cache_put(struct vn_device *dev,
+                        const struct vn_image_reqs_cache_key *key,
+                        const struct vn_image *img,
+                        uint32_t plane_count)
+{
+   const VkAllocationCallbacks *alloc = &dev->base.base.alloc;
+   struct vn_image_reqs_cache *cache = &dev->image_reqs_cache;
+
+   simple_mtx_lock(&cache->mutex);
+
+   if (cache->ht->entries >= VN_IMAGE_REQS_CACHE_MAX_ENTRIES ||
+       _mesa_hash_table_search(cache->ht, key))
+      goto out_unlock;
+
+   struct vn_image_reqs_cache_entry *entry =
+      vk_zalloc(alloc, sizeof(*entry), VN_DEFAULT_ALIGN,
+                VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+   if (!entry)
+      goto out_unlock;
+
+   entry->key = *key;
+   entry->plane_count = plane_count;
+   memcpy(entry->requirements, img->requirements,
+          sizeof(*entry->requirements) * plane_count);
+
+   _mesa_hash_table_insert(cache->ht, &entry->key, entry);
+
+out_unlock:
+   simple_mtx_unlock(&cache->mutex);
+}
+
+static uint32_t
+vn_image_get_plane_count(const VkImageCreateInfo *create_info)
 {
    uint32_t plane_count = 1;
    if (create_info->flags & VK_IMAGE_CREATE_DISJOINT_BIT) {
@@ -60,34 +216,25 @@ vn_image_init_memory_requirements(struct vn_image *img,
          break;
       }
    }
-   assert(plane_count <= ARRAY_SIZE(img->requirements));
 
-   /* TODO add a per-device cache for the requirements */
-   for (uint32_t i = 0; i < plane_count; i++) {
-      img->requirements[i].memory.sType =
-         VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
-      img->requirements[i].memory.pNext = &img->requirements[i].dedicated;
-      img->requirements[i].dedicated.sType =
-         VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
-      img->requirements[i].dedicated.pNext = NULL;
-   }
+   return plane_count;
+}
 
+static void
+vn_image_query_memory_requirements(struct vn_image *img,
+                                   struct vn_device *dev,
+                                   uint32_t plane_count)
+{
    VkDevice dev_handle = vn_device_to_handle(dev);
    VkImage img_handle = vn_image_to_handle(img);
    if (plane_count == 1) {
       vn_call_vkGetImageMemoryRequirements2(
-         dev->instance, dev_handle,
+         dev->instance, vn_device_to_handle(dev),
          &(VkImageMemoryRequirementsInfo2){
             .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2,
             .image = img_handle,
          },
          &img->requirements[0].memory);
-
-      /* AHB backed image requires dedicated allocation */
-      if (img->deferred_info) {
-         img->requirements[0].dedicated.prefersDedicatedAllocation = VK_TRUE;
-         img->requirements[0].dedicated.requiresDedicatedAllocation = VK_TRUE;
-      }
    } else {
       for (uint32_t i = 0; i < plane_count; i++) {
          vn_call_vkGetImageMemoryRequirements2(
@@ -107,6 +254,40 @@ vn_image_init_memory_requirements(struct vn_image *img,
    }
 }
 
+static void
+vn_image_init_memory_requirements(struct vn_image *img,
+                                  struct vn_device *dev,
+                                  const VkImageCreateInfo *create_info,
+                                  bool cached)
+{
+   const uint32_t plane_count = vn_image_get_plane_count(create_info);
+   assert(plane_count <= ARRAY_SIZE(img->requirements));
+
+   for (uint32_t i = 0; i < plane_count; i++) {
+      img->requirements[i].memory.sType =
+         VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+      img->requirements[i].memory.pNext = &img->requirements[i].dedicated;
+      img->requirements[i].dedicated.sType =
+         VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+      img->requirements[i].dedicated.pNext = NULL;
+   }
+
+   /* cache hits were already filled in by vn_image_reqs_cache_get */
+   if (!cached) {
+      vn_image_query_memory_requirements(img, dev, plane_count);
+
+      struct vn_image_reqs_cache_key key;
+      if (vn_image_reqs_cache_key_init(create_info, &key))
+         vn_image_reqs_cache_put(dev, &key, img, plane_count);
+   }
+
+   /* AHB backed image requires dedicated allocation */
+   if (img->deferred_info && plane_count == 1) {
+      img->requirements[0].dedicated.prefersDedicatedAllocation = VK_TRUE;
+      img->requirements[0].dedicated.requiresDedicatedAllocation = VK_TRUE;
+   }
+}
+
 static VkResult
 vn_image_deferred_info_init(struct vn_image *img,
                             const VkImageCreateInfo *create_info,
@@ -203,13 +384,24 @@ vn_image_init(struct vn_device *dev,
 
    img->sharing_mode = create_info->sharingMode;
 
-   /* TODO async */
-   result =
-      vn_call_vkCreateImage(dev->instance, device, create_info, NULL, &image);
-   if (result != VK_SUCCESS)
-      return result;
+   /* The memory requirements are the only output we need from the
+    * renderer. When they are already known for an identical create info,
+    * the image can be created asynchronously like cached buffers are.
+    */
+   struct vn_image_reqs_cache_key key;
+   const bool cached = vn_image_reqs_cache_key_init(create_info, &key) &&
+                       vn_image_reqs_cache_get(dev, &key, img);
+   if (cached) {
+      vn_async_vkCreateImage(dev->instance, device, create_info, NULL,
+                             &image);
+   } else {
+      result = vn_call_vkCreateImage(dev->instance, device, create_info,
+                                     NULL, &image);
+      if (result != VK_SUCCESS)
+         return result;
+   }
 
-   vn_image_init_memory_requirements(img, dev, create_info);
+   vn_image_init_memory_requirements(img, dev, create_info, cached);
 
    return VK_SUCCESS;
 }
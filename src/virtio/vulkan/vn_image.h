@@ -23,6 +23,12 @@ struct vn_image_memory_requirements {
    VkMemoryDedicatedRequirements dedicated;
 };
 
+struct vn_image_reqs_cache {
+   /* maps image create infos without pNext to memory requirements */
+   struct hash_table *ht;
+   simple_mtx_t mutex;
+};
+
 struct vn_image_create_deferred_info {
    VkImageCreateInfo create;
    VkImageFormatListCreateInfo list;
@@ -114,4 +120,10 @@ vn_image_create_deferred(struct vn_device *dev,
                          const VkAllocationCallbacks *alloc,
                          struct vn_image **out_img);
 
+VkResult
+vn_image_reqs_cache_init(struct vn_device *dev);
+
+void
+vn_image_reqs_cache_fini(struct vn_device *dev);
+
 #endif /* VN_IMAGE_H */
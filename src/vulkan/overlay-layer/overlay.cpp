@@ -41,6 +41,7 @@
 #include "util/os_time.h"
 #include "util/os_socket.h"
 #include "util/simple_mtx.h"
+#include "util/u_atomic.h"
 #include "util/u_math.h"
 
 #include "vk_enum_to_str.h"
@@ -229,12 +230,36 @@ static inline void ensure_vk_object_map(void)
 #define HKEY(obj) ((uint64_t)(obj))
 #define FIND(type, obj) ((type *)find_object_data(HKEY(obj)))
 
+/* Bumped whenever an object is mapped or unmapped, invalidating the per-thread caches
+ * below.
+ */
+static uint32_t vk_object_to_data_generation = 0;
+
+/* Most lookups are for the command buffer being recorded on the current
+ * thread, so remember the last one to skip the global lock in the draw and
+ * dispatch entry points.
+ */
+static thread_local struct {
+   uint64_t obj;
+   void *data;
+   uint32_t generation;
+} vk_object_cache;
+
 static void *find_object_data(uint64_t obj)
 {
+   uint32_t generation = p_atomic_read(&vk_object_to_data_generation);
+   if (vk_object_cache.data && vk_object_cache.obj == obj &&
+       vk_object_cache.generation == generation)
+      return vk_object_cache.data;
+
    simple_mtx_lock(&vk_object_to_data_mutex);
    ensure_vk_object_map();
    void *data = _mesa_hash_table_u64_search(vk_object_to_data, obj);
    simple_mtx_unlock(&vk_object_to_data_mutex);
+
+   vk_object_cache.obj = obj;
+   vk_object_cache.data = data;
+   vk_object_cache.generation = generation;
    return data;
 }
 
@@ -243,6 +268,7 @@ static void map_object(uint64_t obj, void *data)
    simple_mtx_lock(&vk_object_to_data_mutex);
    ensure_vk_object_map();
    _mesa_hash_table_u64_insert(vk_object_to_data, obj, data);
+   p_atomic_inc(&vk_object_to_data_generation);
    simple_mtx_unlock(&vk_object_to_data_mutex);
 }
 
@@ -250,6 +276,7 @@ static void unmap_object(uint64_t obj)
 {
    simple_mtx_lock(&vk_object_to_data_mutex);
    _mesa_hash_table_u64_remove(vk_object_to_data, obj);
+   p_atomic_inc(&vk_object_to_data_generation);
    simple_mtx_unlock(&vk_object_to_data_mutex);
 }
 
@@ -31,6 +31,7 @@
 #include "vk_alloc.h"
 #include "vk_util.h"
 #include "stdarg.h"
+#include "util/u_atomic.h"
 #include "u_dynarray.h"
 
 void
@@ -163,14 +164,21 @@ vk_common_SetDebugUtilsObjectNameEXT(
       vk_object_base_from_u64_handle(pNameInfo->objectHandle,
                                      pNameInfo->objectType);
 
-   if (object->object_name) {
-      vk_free(&device->alloc, object->object_name);
-      object->object_name = NULL;
+   char *name = NULL;
+   if (pNameInfo->pObjectName) {
+      name = vk_strdup(&device->alloc, pNameInfo->pObjectName,
+                       VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+      if (!name)
+         return VK_ERROR_OUT_OF_HOST_MEMORY;
    }
-   object->object_name = vk_strdup(&device->alloc, pNameInfo->pObjectName,
-                                   VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
-   if (!object->object_name)
-      return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+   /* Swap the name in with a single exchange, so vk_object_base_name()
+    * racing with us sees either name rather than a NULL it would replace
+    * with a generated one.
+    */
+   char *old_name = p_atomic_xchg(&object->object_name, name);
+   if (old_name)
+      vk_free(&device->alloc, old_name);
 
    return VK_SUCCESS;
 }
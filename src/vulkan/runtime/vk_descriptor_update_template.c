@@ -28,6 +28,51 @@
 #include "vk_device.h"
 #include "vk_log.h"
 
+/* Folds next into prev when it continues the same binding where prev stops,
+ * reading the user data at the same stride.  Applications often describe an
+ * array one element per entry, this lets drivers walk it as one run.
+ */
+static bool
+try_merge_entry(struct vk_descriptor_template_entry *prev,
+                const struct vk_descriptor_template_entry *next)
+{
+   if (prev->type != next->type || prev->binding != next->binding ||
+       next->array_element != prev->array_element + prev->array_count)
+      return false;
+
+   /* For inline uniform blocks, element and count are in bytes and the data
+    * is tightly packed.
+    */
+   if (prev->type == VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK) {
+      if (next->offset != prev->offset + prev->array_count)
+         return false;
+
+      prev->array_count += next->array_count;
+      return true;
+   }
+
+   /* The stride of a single element entry doesn't matter */
+   size_t stride;
+   if (prev->array_count > 1)
+      stride = prev->stride;
+   else if (next->array_count > 1)
+      stride = next->stride;
+   else if (next->offset > prev->offset)
+      stride = next->offset - prev->offset;
+   else
+      return false;
+
+   if (next->array_count > 1 && next->stride != stride)
+      return false;
+
+   if (next->offset != prev->offset + prev->array_count * stride)
+      return false;
+
+   prev->stride = stride;
+   prev->array_count += next->array_count;
+   return true;
+}
+
 VKAPI_ATTR VkResult VKAPI_CALL
 vk_common_CreateDescriptorUpdateTemplate(VkDevice _device,
    const VkDescriptorUpdateTemplateCreateInfo *pCreateInfo,
@@ -56,7 +101,6 @@ vk_common_CreateDescriptorUpdateTemplate(VkDevice _device,
       template->set = pCreateInfo->set;
 
    uint32_t entry_idx = 0;
-   template->entry_count = entry_count;
    for (uint32_t i = 0; i < pCreateInfo->descriptorUpdateEntryCount; i++) {
       const VkDescriptorUpdateTemplateEntry *pEntry =
          &pCreateInfo->pDescriptorUpdateEntries[i];
@@ -64,7 +108,7 @@ vk_common_CreateDescriptorUpdateTemplate(VkDevice _device,
       if (pEntry->descriptorCount == 0)
          continue;
 
-      template->entries[entry_idx++] = (struct vk_descriptor_template_entry) {
+      const struct vk_descriptor_template_entry entry = {
          .type = pEntry->descriptorType,
          .binding = pEntry->dstBinding,
          .array_element = pEntry->dstArrayElement,
@@ -72,8 +116,15 @@ vk_common_CreateDescriptorUpdateTemplate(VkDevice _device,
          .offset = pEntry->offset,
          .stride = pEntry->stride,
       };
+
+      if (entry_idx > 0 &&
+          try_merge_entry(&template->entries[entry_idx - 1], &entry))
+         continue;
+
+      template->entries[entry_idx++] = entry;
    }
-   assert(entry_idx == entry_count);
+   assert(entry_idx <= entry_count);
+   template->entry_count = entry_idx;
 
    *pDescriptorUpdateTemplate =
       vk_descriptor_update_template_to_handle(template);
@@ -29,6 +29,7 @@
 #include "drm-uapi/drm.h"
 
 #include "util/os_time.h"
+#include "util/u_atomic.h"
 
 #include "vk_device.h"
 #include "vk_log.h"
@@ -41,6 +42,16 @@ to_drm_syncobj(struct vk_sync *sync)
    return container_of(sync, struct vk_drm_syncobj, base);
 }
 
+static void
+note_signaled_value(struct vk_drm_syncobj *sobj, uint64_t value)
+{
+   /* Racing updates may lose the larger value, which only costs us a
+    * redundant ioctl later.  It never makes the cached value too high.
+    */
+   if (value > p_atomic_read(&sobj->signaled_value))
+      p_atomic_set(&sobj->signaled_value, value);
+}
+
 static VkResult
 vk_drm_syncobj_init(struct vk_device *device,
                     struct vk_sync *sync,
@@ -48,6 +59,8 @@ vk_drm_syncobj_init(struct vk_device *device,
 {
    struct vk_drm_syncobj *sobj = to_drm_syncobj(sync);
 
+   sobj->signaled_value = 0;
+
    uint32_t flags = 0;
    if (!(sync->flags & VK_SYNC_IS_TIMELINE) && initial_value)
       flags |= DRM_SYNCOBJ_CREATE_SIGNALED;
@@ -67,6 +80,7 @@ vk_drm_syncobj_init(struct vk_device *device,
          return vk_errorf(device, VK_ERROR_OUT_OF_HOST_MEMORY,
                           "DRM_IOCTL_SYNCOBJ_CREATE failed: %m");
       }
+      sobj->signaled_value = initial_value;
    }
 
    return VK_SUCCESS;
@@ -101,6 +115,9 @@ vk_drm_syncobj_signal(struct vk_device *device,
                        "DRM_IOCTL_SYNCOBJ_SIGNAL failed: %m");
    }
 
+   if (sync->flags & VK_SYNC_IS_TIMELINE)
+      note_signaled_value(sobj, value);
+
    return VK_SUCCESS;
 }
 
@@ -118,6 +135,8 @@ vk_drm_syncobj_get_value(struct vk_device *device,
                        "DRM_IOCTL_SYNCOBJ_QUERY failed: %m");
    }
 
+   note_signaled_value(sobj, *value);
+
    return VK_SUCCESS;
 }
 
@@ -230,12 +249,19 @@ vk_drm_syncobj_wait_many(struct vk_device *device,
    uint32_t j = 0;
    bool has_timeline = false;
    for (uint32_t i = 0; i < wait_count; i++) {
-      /* The syncobj API doesn't like wait values of 0 but it's safe to skip
-       * them because a wait for 0 is a no-op.
-       */
       if (waits[i].sync->flags & VK_SYNC_IS_TIMELINE) {
-         if (waits[i].wait_value == 0)
+         /* Skip points we already know to be signaled.  This also covers a
+          * wait value of 0, which the syncobj API doesn't like but which is
+          * a no-op anyway.
+          */
+         if (waits[i].wait_value <=
+             p_atomic_read(&to_drm_syncobj(waits[i].sync)->signaled_value)) {
+            if (wait_flags & VK_SYNC_WAIT_ANY) {
+               j = 0;
+               break;
+            }
             continue;
+         }
 
          has_timeline = true;
       }
@@ -245,6 +271,7 @@ vk_drm_syncobj_wait_many(struct vk_device *device,
       j++;
    }
    assert(j <= wait_count);
+   const uint32_t total_wait_count = wait_count;
    wait_count = j;
 
    uint32_t syncobj_wait_flags = DRM_SYNCOBJ_WAIT_FLAGS_WAIT_FOR_SUBMIT;
@@ -277,6 +304,18 @@ vk_drm_syncobj_wait_many(struct vk_device *device,
                            NULL /* first_signaled */);
    }
 
+   /* A successful wait for all points means every one of them signaled,
+    * unless we only waited for them to become available.
+    */
+   if (!err && wait_count > 0 &&
+       !(wait_flags & (VK_SYNC_WAIT_ANY | VK_SYNC_WAIT_PENDING))) {
+      for (uint32_t i = 0; i < total_wait_count; i++) {
+         if (waits[i].sync->flags & VK_SYNC_IS_TIMELINE)
+            note_signaled_value(to_drm_syncobj(waits[i].sync),
+                                waits[i].wait_value);
+      }
+   }
+
    STACK_ARRAY_FINISH(handles);
    STACK_ARRAY_FINISH(wait_values);
 
@@ -309,6 +348,7 @@ vk_drm_syncobj_import_opaque_fd(struct vk_device *device,
    assert(!err);
 
    sobj->syncobj = new_handle;
+   sobj->signaled_value = 0;
 
    return VK_SUCCESS;
 }
@@ -383,6 +423,10 @@ vk_drm_syncobj_move(struct vk_device *device,
       dst_sobj->syncobj = src_sobj->syncobj;
       src_sobj->syncobj = tmp;
 
+      uint64_t tmp_value = dst_sobj->signaled_value;
+      dst_sobj->signaled_value = src_sobj->signaled_value;
+      src_sobj->signaled_value = tmp_value;
+
       return VK_SUCCESS;
    } else {
       int fd;
@@ -34,6 +34,14 @@ extern "C" {
 struct vk_drm_syncobj {
    struct vk_sync base;
    uint32_t syncobj;
+
+   /** Highest timeline point known to have signaled
+    *
+    * Timeline values only ever increase so this is a safe lower bound which
+    * lets waits on already-signaled points skip the ioctl.  Only used for
+    * timeline syncobjs and updated with atomics.
+    */
+   uint64_t signaled_value;
 };
 
 void vk_drm_syncobj_finish(struct vk_device *device,
@@ -352,6 +352,8 @@ vk_input_assembly_state_init(struct vk_input_assembly_state *ia,
     *    set dynamically with vkCmdSetPrimitiveTopology before any drawing
     *    commands."
    */
+   memset(ia, 0, sizeof(*ia));
+
    assert(ia_info->topology <= UINT8_MAX);
    ia->primitive_topology = ia_info->topology;
 
@@ -371,6 +373,8 @@ vk_tessellation_state_init(struct vk_tessellation_state *ts,
                            const BITSET_WORD *dynamic,
                            const VkPipelineTessellationStateCreateInfo *ts_info)
 {
+   memset(ts, 0, sizeof(*ts));
+
    if (IS_DYNAMIC(TS_PATCH_CONTROL_POINTS)) {
       ts->patch_control_points = 0;
    } else {
@@ -486,6 +490,7 @@ vk_rasterization_state_init(struct vk_rasterization_state *rs,
                             const BITSET_WORD *dynamic,
                             const VkPipelineRasterizationStateCreateInfo *rs_info)
 {
+   memset(rs, 0, sizeof(*rs));
    *rs = (struct vk_rasterization_state) {
       .rasterizer_discard_enable = false,
       .conservative_mode = VK_CONSERVATIVE_RASTERIZATION_MODE_DISABLED_EXT,
@@ -601,6 +606,8 @@ vk_fragment_shading_rate_state_init(
    const BITSET_WORD *dynamic,
    const VkPipelineFragmentShadingRateStateCreateInfoKHR *fsr_info)
 {
+   memset(fsr, 0, sizeof(*fsr));
+
    if (fsr_info != NULL) {
       fsr->fragment_size = fsr_info->fragmentSize;
       fsr->combiner_ops[0] = fsr_info->combinerOps[0];
@@ -625,6 +632,8 @@ static void
 vk_sample_locations_state_init(struct vk_sample_locations_state *sl,
                                const VkSampleLocationsInfoEXT *sl_info)
 {
+   memset(sl, 0, sizeof(*sl));
+
    sl->per_pixel = sl_info->sampleLocationsPerPixel;
    sl->grid_size = sl_info->sampleLocationGridSize;
 
@@ -650,6 +659,8 @@ vk_multisample_state_init(struct vk_multisample_state *ms,
                           const BITSET_WORD *dynamic,
                           const VkPipelineMultisampleStateCreateInfo *ms_info)
 {
+   memset(ms, 0, sizeof(*ms));
+
    assert(ms_info->rasterizationSamples <= MESA_VK_MAX_SAMPLES);
    ms->rasterization_samples = ms_info->rasterizationSamples;
    ms->sample_shading_enable = ms_info->sampleShadingEnable;
@@ -1466,6 +1477,78 @@ vk_graphics_pipeline_state_merge(struct vk_graphics_pipeline_state *dst,
 #undef MERGE
 }
 
+static void
+hash_render_pass_state(const struct vk_render_pass_state *rp,
+                       struct mesa_sha1 *ctx)
+{
+   /* The struct is copied around by value and has padding, so go field by
+    * field.  The render pass handle itself isn't state: compatible render
+    * passes should hash the same.
+    */
+#define HASH(field) _mesa_sha1_update(ctx, &rp->field, sizeof(rp->field))
+   HASH(attachment_aspects);
+   HASH(subpass);
+   HASH(view_mask);
+   HASH(color_self_dependencies);
+   HASH(depth_self_dependency);
+   HASH(stencil_self_dependency);
+   HASH(color_attachment_count);
+   HASH(color_attachment_formats);
+   HASH(depth_attachment_format);
+   HASH(stencil_attachment_format);
+   HASH(color_attachment_samples);
+   HASH(depth_stencil_attachment_samples);
+#undef HASH
+}
+
+void
+vk_graphics_pipeline_state_hash(const struct vk_graphics_pipeline_state *state,
+                                struct mesa_sha1 *ctx)
+{
+   vk_graphics_pipeline_state_validate(state);
+
+   _mesa_sha1_update(ctx, state->dynamic, sizeof(state->dynamic));
+   _mesa_sha1_update(ctx, &state->shader_stages, sizeof(state->shader_stages));
+
+   const enum mesa_vk_graphics_state_groups groups =
+      vk_graphics_pipeline_state_groups(state);
+   _mesa_sha1_update(ctx, &groups, sizeof(groups));
+
+   /* Every state is zeroed before being filled, so hashing the bytes is
+    * canonical.  Multisample and render pass state are the exceptions:
+    * the former points to the sample locations and the latter is copied
+    * with struct assignment.
+    */
+#define HASH_STATE(s) \
+   if (state->s != NULL) _mesa_sha1_update(ctx, state->s, sizeof(*state->s))
+
+   HASH_STATE(vi);
+   HASH_STATE(ia);
+   HASH_STATE(ts);
+   HASH_STATE(vp);
+   HASH_STATE(dr);
+   HASH_STATE(rs);
+   HASH_STATE(fsr);
+   HASH_STATE(ds);
+   HASH_STATE(cb);
+
+#undef HASH_STATE
+
+   if (state->ms != NULL) {
+      struct vk_multisample_state ms = *state->ms;
+      ms.sample_locations = NULL;
+      _mesa_sha1_update(ctx, &ms, sizeof(ms));
+
+      if (state->ms->sample_locations != NULL) {
+         _mesa_sha1_update(ctx, state->ms->sample_locations,
+                           sizeof(*state->ms->sample_locations));
+      }
+   }
+
+   if (state->rp != NULL)
+      hash_render_pass_state(state->rp, ctx);
+}
+
 const struct vk_dynamic_graphics_state vk_default_dynamic_graphics_state = {
    .rs = {
       .line = {
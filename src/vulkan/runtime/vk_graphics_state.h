@@ -29,6 +29,7 @@
 #include "vk_limits.h"
 
 #include "util/bitset.h"
+#include "util/mesa-sha1.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -917,6 +918,20 @@ void
 vk_graphics_pipeline_state_merge(struct vk_graphics_pipeline_state *dst,
                                  const struct vk_graphics_pipeline_state *src);
 
+/** Hash the state in a vk_graphics_pipeline_state
+ *
+ * States are hashed by value, so identical state gives the same hash
+ * whether it comes from a complete pipeline or from libraries, which lets
+ * drivers key their pipeline variant caches directly on it.  The render pass
+ * handle is not hashed, only the attachment information derived from it.
+ *
+ * @param[in]  state     The state to hash
+ * @param[in]  sha1_ctx  SHA1 context the state is added to
+ */
+void
+vk_graphics_pipeline_state_hash(const struct vk_graphics_pipeline_state *state,
+                                struct mesa_sha1 *sha1_ctx);
+
 extern const struct vk_dynamic_graphics_state vk_default_dynamic_graphics_state;
 
 /** Initialize a vk_dynamic_graphics_state with defaults
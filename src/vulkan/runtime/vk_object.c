@@ -28,6 +28,7 @@
 #include "vk_device.h"
 #include "util/hash_table.h"
 #include "util/ralloc.h"
+#include "util/u_atomic.h"
 #include "vk_enum_to_str.h"
 
 void
@@ -40,6 +41,7 @@ vk_object_base_init(struct vk_device *device,
    base->device = device;
    base->client_visible = false;
    base->object_name = NULL;
+   memset(base->private_data_inline, 0, sizeof(base->private_data_inline));
    util_sparse_array_init(&base->private_data, sizeof(uint64_t), 8);
 }
 
@@ -236,6 +238,13 @@ vk_object_base_private_data(struct vk_device *device,
 
    struct vk_object_base *obj =
       vk_object_base_from_u64_handle(objectHandle, objectType);
+
+   /* Slot indices start at 1 */
+   if (slot->index <= VK_OBJECT_INLINE_PRIVATE_DATA) {
+      *private_data = &obj->private_data_inline[slot->index - 1];
+      return VK_SUCCESS;
+   }
+
    *private_data = util_sparse_array_get(&obj->private_data, slot->index);
 
    return VK_SUCCESS;
@@ -328,14 +337,26 @@ vk_common_GetPrivateDataEXT(VkDevice _device,
 const char *
 vk_object_base_name(struct vk_object_base *obj)
 {
-   if (obj->object_name)
-      return obj->object_name;
+   char *name = p_atomic_read(&obj->object_name);
+   if (name)
+      return name;
+
+   name = vk_asprintf(&obj->device->alloc,
+                      VK_SYSTEM_ALLOCATION_SCOPE_DEVICE,
+                      "%s(0x%"PRIx64")",
+                      vk_ObjectType_to_ObjectName(obj->type),
+                      (uint64_t)(uintptr_t)obj);
+   if (name == NULL)
+      return NULL;
 
-   obj->object_name = vk_asprintf(&obj->device->alloc,
-                                  VK_SYSTEM_ALLOCATION_SCOPE_DEVICE,
-                                  "%s(0x%"PRIx64")",
-                                  vk_ObjectType_to_ObjectName(obj->type),
-                                  (uint64_t)(uintptr_t)obj);
+   /* This may be called from any thread logging about the object, keep
+    * whichever name got installed first.
+    */
+   char *old = p_atomic_cmpxchg_ptr(&obj->object_name, NULL, name);
+   if (old != NULL) {
+      vk_free(&obj->device->alloc, name);
+      return old;
+   }
 
-   return obj->object_name;
+   return name;
 }
@@ -38,6 +38,9 @@ struct hash_table;
 
 struct vk_device;
 
+/** Number of private data slots stored inline in each vk_object_base */
+#define VK_OBJECT_INLINE_PRIVATE_DATA 2
+
 /** Base struct for all Vulkan objects */
 struct vk_object_base {
    VK_LOADER_DATA _loader_data;
@@ -60,7 +63,12 @@ struct vk_object_base {
    /* True if this object is fully constructed and visible to the client */
    bool client_visible;
 
-   /* For VK_EXT_private_data */
+   /* For VK_EXT_private_data
+    *
+    * The first VK_OBJECT_INLINE_PRIVATE_DATA slots live in the object
+    * itself, the others in the sparse array.
+    */
+   uint64_t private_data_inline[VK_OBJECT_INLINE_PRIVATE_DATA];
    struct util_sparse_array private_data;
 
    /* VK_EXT_debug_utils */
@@ -37,13 +37,53 @@
 #include "util/hash_table.h"
 #include "util/set.h"
 
+/** A single copy of the pInitialData passed to vkCreatePipelineCache()
+ *
+ * Raw data objects created by vk_pipeline_cache_load() point into this
+ * instead of each carrying their own copy of their key and data.  It is
+ * reference counted because the objects may outlive the cache that loaded
+ * them.
+ */
+struct raw_data_storage {
+   uint32_t ref_cnt;
+   size_t size;
+};
+
 struct raw_data_object {
    struct vk_pipeline_cache_object base;
 
+   /* If not NULL, data and key_data point into this */
+   struct raw_data_storage *storage;
+
    const void *data;
    size_t data_size;
 };
 
+static struct raw_data_storage *
+raw_data_storage_create(struct vk_device *device,
+                        const void *data, size_t size)
+{
+   struct raw_data_storage *storage =
+      vk_alloc(&device->alloc, sizeof(*storage) + size, 8,
+               VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+   if (storage == NULL)
+      return NULL;
+
+   p_atomic_set(&storage->ref_cnt, 1);
+   storage->size = size;
+   memcpy(storage + 1, data, size);
+
+   return storage;
+}
+
+static void
+raw_data_storage_unref(struct vk_device *device,
+                       struct raw_data_storage *storage)
+{
+   if (p_atomic_dec_zero(&storage->ref_cnt))
+      vk_free(&device->alloc, storage);
+}
+
 static struct raw_data_object *
 raw_data_object_create(struct vk_device *device,
                        const void *key_data, size_t key_size,
@@ -88,6 +128,9 @@ raw_data_object_destroy(struct vk_pipeline_cache_object *object)
    struct raw_data_object *data_obj =
       container_of(object, struct raw_data_object, base);
 
+   if (data_obj->storage != NULL)
+      raw_data_storage_unref(data_obj->base.device, data_obj->storage);
+
    vk_free(&data_obj->base.device->alloc, data_obj);
 }
 
@@ -123,6 +166,36 @@ raw_data_object_create(struct vk_device *device,
    return data_obj;
 }
 
+/* Creates a raw data object which references key_data and data in storage
+ * rather than copying them.
+ */
+static struct raw_data_object *
+raw_data_object_create_in_storage(struct vk_device *device,
+                                  struct raw_data_storage *storage,
+                                  const void *key_data, size_t key_size,
+                                  const void *data, size_t data_size)
+{
+   struct raw_data_object *data_obj =
+      vk_alloc(&device->alloc, sizeof(*data_obj), 8,
+               VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+   if (data_obj == NULL)
+      return NULL;
+
+   vk_pipeline_cache_object_init(device, &data_obj->base,
+                                 &raw_data_object_ops,
+                                 key_data, key_size);
+   data_obj->storage = storage;
+   data_obj->data = data;
+   data_obj->data_size = data_size;
+
+   /* We know exactly how big this object is when serialized */
+   data_obj->base.data_size = data_size;
+
+   p_atomic_inc(&storage->ref_cnt);
+
+   return data_obj;
+}
+
 static bool
 object_keys_equal(const void *void_a, const void *void_b)
 {
@@ -140,19 +213,27 @@ object_key_hash(const void *void_object)
    return _mesa_hash_data(object->key_data, object->key_size);
 }
 
+static struct vk_pipeline_cache_shard *
+vk_pipeline_cache_get_shard(struct vk_pipeline_cache *cache, uint32_t hash)
+{
+   return &cache->shards[hash % VK_PIPELINE_CACHE_NUM_SHARDS];
+}
+
 static void
-vk_pipeline_cache_lock(struct vk_pipeline_cache *cache)
+vk_pipeline_cache_lock(struct vk_pipeline_cache *cache,
+                       struct vk_pipeline_cache_shard *shard)
 {
 
    if (!(cache->flags & VK_PIPELINE_CACHE_CREATE_EXTERNALLY_SYNCHRONIZED_BIT))
-      simple_mtx_lock(&cache->lock);
+      simple_mtx_lock(&shard->lock);
 }
 
 static void
-vk_pipeline_cache_unlock(struct vk_pipeline_cache *cache)
+vk_pipeline_cache_unlock(struct vk_pipeline_cache *cache,
+                         struct vk_pipeline_cache_shard *shard)
 {
    if (!(cache->flags & VK_PIPELINE_CACHE_CREATE_EXTERNALLY_SYNCHRONIZED_BIT))
-      simple_mtx_unlock(&cache->lock);
+      simple_mtx_unlock(&shard->lock);
 }
 
 static void
@@ -160,16 +241,19 @@ vk_pipeline_cache_remove_object(struct vk_pipeline_cache *cache,
                                 uint32_t hash,
                                 struct vk_pipeline_cache_object *object)
 {
-   vk_pipeline_cache_lock(cache);
+   struct vk_pipeline_cache_shard *shard =
+      vk_pipeline_cache_get_shard(cache, hash);
+
+   vk_pipeline_cache_lock(cache, shard);
    struct set_entry *entry =
-      _mesa_set_search_pre_hashed(cache->object_cache, hash, object);
+      _mesa_set_search_pre_hashed(shard->objects, hash, object);
    if (entry && entry->key == (const void *)object) {
       /* Drop the reference owned by the cache */
       vk_pipeline_cache_object_unref(object);
 
-      _mesa_set_remove(cache->object_cache, entry);
+      _mesa_set_remove(shard->objects, entry);
    }
-   vk_pipeline_cache_unlock(cache);
+   vk_pipeline_cache_unlock(cache, shard);
 
    /* Drop our reference */
    vk_pipeline_cache_object_unref(object);
@@ -184,9 +268,12 @@ vk_pipeline_cache_replace_object(struct vk_pipeline_cache *cache,
 {
    assert(object_keys_equal(search, replace));
 
-   vk_pipeline_cache_lock(cache);
+   struct vk_pipeline_cache_shard *shard =
+      vk_pipeline_cache_get_shard(cache, hash);
+
+   vk_pipeline_cache_lock(cache, shard);
    struct set_entry *entry =
-      _mesa_set_search_pre_hashed(cache->object_cache, hash, search);
+      _mesa_set_search_pre_hashed(shard->objects, hash, search);
 
    struct vk_pipeline_cache_object *found = NULL;
    if (entry) {
@@ -201,9 +288,9 @@ vk_pipeline_cache_replace_object(struct vk_pipeline_cache *cache,
    } else {
       /* I guess the object was purged?  Re-add it to the cache */
       vk_pipeline_cache_object_ref(replace);
-      _mesa_set_add_pre_hashed(cache->object_cache, hash, replace);
+      _mesa_set_add_pre_hashed(shard->objects, hash, replace);
    }
-   vk_pipeline_cache_unlock(cache);
+   vk_pipeline_cache_unlock(cache, shard);
 
    vk_pipeline_cache_object_unref(search);
 
@@ -322,22 +409,25 @@ vk_pipeline_cache_lookup_object(struct vk_pipeline_cache *cache,
 
    struct vk_pipeline_cache_object *object = NULL;
 
-   if (cache != NULL && cache->object_cache != NULL) {
-      vk_pipeline_cache_lock(cache);
+   if (cache != NULL && cache->object_cache) {
+      struct vk_pipeline_cache_shard *shard =
+         vk_pipeline_cache_get_shard(cache, hash);
+
+      vk_pipeline_cache_lock(cache, shard);
       struct set_entry *entry =
-         _mesa_set_search_pre_hashed(cache->object_cache, hash, &key);
+         _mesa_set_search_pre_hashed(shard->objects, hash, &key);
       if (entry) {
          object = vk_pipeline_cache_object_ref((void *)entry->key);
          if (cache_hit != NULL)
             *cache_hit = true;
       }
-      vk_pipeline_cache_unlock(cache);
+      vk_pipeline_cache_unlock(cache, shard);
    }
 
    if (object == NULL) {
 #ifdef ENABLE_SHADER_CACHE
       struct disk_cache *disk_cache = cache->base.device->physical->disk_cache;
-      if (disk_cache != NULL && cache->object_cache != NULL) {
+      if (disk_cache != NULL && cache->object_cache) {
          cache_key cache_key;
          disk_cache_compute_key(disk_cache, key_data, key_size, cache_key);
 
@@ -386,21 +476,22 @@ vk_pipeline_cache_lookup_object(struct vk_pipeline_cache *cache,
    return object;
 }
 
-struct vk_pipeline_cache_object *
-vk_pipeline_cache_add_object(struct vk_pipeline_cache *cache,
-                             struct vk_pipeline_cache_object *object)
+/* Adds an object to the in-memory cache only.  Returns the object now in
+ * the cache and sets *inserted if that is the given one.
+ */
+static struct vk_pipeline_cache_object *
+vk_pipeline_cache_insert_object(struct vk_pipeline_cache *cache,
+                                struct vk_pipeline_cache_object *object,
+                                bool *inserted)
 {
-   assert(object->ops != NULL);
-
-   if (cache->object_cache == NULL)
-      return object;
-
    uint32_t hash = object_key_hash(object);
+   struct vk_pipeline_cache_shard *shard =
+      vk_pipeline_cache_get_shard(cache, hash);
 
-   vk_pipeline_cache_lock(cache);
+   vk_pipeline_cache_lock(cache, shard);
    bool found = false;
    struct set_entry *entry =
-      _mesa_set_search_or_add_pre_hashed(cache->object_cache,
+      _mesa_set_search_or_add_pre_hashed(shard->objects,
                                          hash, object, &found);
 
    struct vk_pipeline_cache_object *found_object = NULL;
@@ -410,11 +501,31 @@ vk_pipeline_cache_add_object(struct vk_pipeline_cache *cache,
       /* The cache now owns a reference */
       vk_pipeline_cache_object_ref(object);
    }
-   vk_pipeline_cache_unlock(cache);
+   vk_pipeline_cache_unlock(cache, shard);
+
+   *inserted = !found;
 
    if (found) {
       vk_pipeline_cache_object_unref(object);
       return found_object;
+   } else {
+      return object;
+   }
+}
+
+struct vk_pipeline_cache_object *
+vk_pipeline_cache_add_object(struct vk_pipeline_cache *cache,
+                             struct vk_pipeline_cache_object *object)
+{
+   assert(object->ops != NULL);
+
+   if (!cache->object_cache)
+      return object;
+
+   bool inserted;
+   object = vk_pipeline_cache_insert_object(cache, object, &inserted);
+   if (!inserted) {
+      return object;
    } else {
       /* If it wasn't in the object cache, it might not be in the disk cache
        * either.  Better try and add it.
@@ -497,6 +608,83 @@ vk_pipeline_cache_add_nir(struct vk_pipeline_cache *cache,
    vk_pipeline_cache_object_unref(cached);
 }
 
+nir_shader *
+vk_pipeline_cache_lookup_nir_with_data(struct vk_pipeline_cache *cache,
+                                       const void *key_data, size_t key_size,
+                                       const struct nir_shader_compiler_options *nir_options,
+                                       bool *cache_hit, void *mem_ctx,
+                                       void **data, size_t *data_size)
+{
+   struct vk_pipeline_cache_object *object =
+      vk_pipeline_cache_lookup_object(cache, key_data, key_size,
+                                      &raw_data_object_ops, cache_hit);
+   if (object == NULL)
+      return NULL;
+
+   struct raw_data_object *data_obj =
+      container_of(object, struct raw_data_object, base);
+
+   struct blob_reader blob;
+   blob_reader_init(&blob, data_obj->data, data_obj->data_size);
+
+   uint32_t driver_data_size = blob_read_uint32(&blob);
+   const void *driver_data = blob_read_bytes(&blob, driver_data_size);
+   if (blob.overrun) {
+      vk_pipeline_cache_object_unref(object);
+      return NULL;
+   }
+
+   void *driver_data_copy = ralloc_size(mem_ctx, MAX2(driver_data_size, 1));
+   memcpy(driver_data_copy, driver_data, driver_data_size);
+
+   nir_shader *nir = nir_deserialize(mem_ctx, nir_options, &blob);
+   vk_pipeline_cache_object_unref(object);
+
+   if (blob.overrun) {
+      ralloc_free(nir);
+      ralloc_free(driver_data_copy);
+      return NULL;
+   }
+
+   *data = driver_data_copy;
+   *data_size = driver_data_size;
+
+   return nir;
+}
+
+void
+vk_pipeline_cache_add_nir_with_data(struct vk_pipeline_cache *cache,
+                                    const void *key_data, size_t key_size,
+                                    const nir_shader *nir,
+                                    const void *data, size_t data_size)
+{
+   assert(data_size <= UINT32_MAX);
+
+   struct blob blob;
+   blob_init(&blob);
+
+   blob_write_uint32(&blob, data_size);
+   blob_write_bytes(&blob, data, data_size);
+   nir_serialize(&blob, nir, false);
+   if (blob.out_of_memory) {
+      vk_logw(VK_LOG_OBJS(cache), "Ran out of memory serializing NIR shader");
+      blob_finish(&blob);
+      return;
+   }
+
+   struct raw_data_object *data_obj =
+      raw_data_object_create(cache->base.device,
+                             key_data, key_size,
+                             blob.data, blob.size);
+   blob_finish(&blob);
+   if (data_obj == NULL)
+      return;
+
+   struct vk_pipeline_cache_object *cached =
+      vk_pipeline_cache_add_object(cache, &data_obj->base);
+   vk_pipeline_cache_object_unref(cached);
+}
+
 static int32_t
 find_type_for_ops(const struct vk_physical_device *pdevice,
                   const struct vk_pipeline_cache_object_ops *ops)
@@ -544,6 +732,23 @@ vk_pipeline_cache_load(struct vk_pipeline_cache *cache,
    if (memcmp(&header, &cache->header, sizeof(header)) != 0)
       return;
 
+   /* Objects are not deserialized here.  Instead, each one is added as a raw
+    * data object pointing into a single copy of the data and only turned
+    * into a real object by vk_pipeline_cache_lookup_object() the first time
+    * it is looked up.  This keeps vkCreatePipelineCache() cheap for large
+    * caches of which the application only uses a small part.
+    *
+    * The copy is needed because the application is free to release
+    * pInitialData as soon as vkCreatePipelineCache() returns.
+    */
+   struct raw_data_storage *storage =
+      raw_data_storage_create(cache->base.device, data, size);
+   if (storage == NULL)
+      return;
+
+   blob_reader_init(&blob, storage + 1, size);
+   blob_skip_bytes(&blob, sizeof(header) + sizeof(uint32_t));
+
    for (uint32_t i = 0; i < count; i++) {
       int32_t type = blob_read_uint32(&blob);
       uint32_t key_size = blob_read_uint32(&blob);
@@ -554,19 +759,31 @@ vk_pipeline_cache_load(struct vk_pipeline_cache *cache,
       if (blob.overrun)
          break;
 
+      /* Skip objects which could never be turned into a real object */
       const struct vk_pipeline_cache_object_ops *ops =
          find_ops_for_type(cache->base.device->physical, type);
-
-      struct vk_pipeline_cache_object *object =
-         vk_pipeline_cache_object_deserialize(cache,
-                                              key_data, key_size,
-                                              data, data_size, ops);
-      if (object == NULL)
+      if (ops != NULL && ops->deserialize == NULL)
          continue;
 
-      object = vk_pipeline_cache_add_object(cache, object);
+      struct raw_data_object *data_obj =
+         raw_data_object_create_in_storage(cache->base.device, storage,
+                                           key_data, key_size,
+                                           data, data_size);
+      if (data_obj == NULL)
+         break;
+
+      /* The application keeps this data itself so there is no point in
+       * writing it to the disk cache here; that would also make loading a
+       * large cache as slow as deserializing it.
+       */
+      bool inserted;
+      struct vk_pipeline_cache_object *object =
+         vk_pipeline_cache_insert_object(cache, &data_obj->base, &inserted);
       vk_pipeline_cache_object_unref(object);
    }
+
+   /* Drop our reference; the objects hold their own */
+   raw_data_storage_unref(cache->base.device, storage);
 }
 
 struct vk_pipeline_cache *
@@ -603,12 +820,21 @@ vk_pipeline_cache_create(struct vk_device *device,
    };
    memcpy(cache->header.uuid, pdevice_props.pipelineCacheUUID, VK_UUID_SIZE);
 
-   simple_mtx_init(&cache->lock, mtx_plain);
+   for (unsigned i = 0; i < VK_PIPELINE_CACHE_NUM_SHARDS; i++)
+      simple_mtx_init(&cache->shards[i].lock, mtx_plain);
 
    if (info->force_enable ||
        debug_get_bool_option("VK_ENABLE_PIPELINE_CACHE", true)) {
-      cache->object_cache = _mesa_set_create(NULL, object_key_hash,
-                                             object_keys_equal);
+      cache->object_cache = true;
+
+      for (unsigned i = 0; i < VK_PIPELINE_CACHE_NUM_SHARDS; i++) {
+         cache->shards[i].objects = _mesa_set_create(NULL, object_key_hash,
+                                                     object_keys_equal);
+         if (cache->shards[i].objects == NULL) {
+            vk_pipeline_cache_destroy(cache, pAllocator);
+            return NULL;
+         }
+      }
    }
 
    if (cache->object_cache && pCreateInfo->initialDataSize > 0) {
@@ -629,9 +855,11 @@ void
 vk_pipeline_cache_destroy(struct vk_pipeline_cache *cache,
                           const VkAllocationCallbacks *pAllocator)
 {
-   if (cache->object_cache)
-      _mesa_set_destroy(cache->object_cache, object_unref_cb);
-   simple_mtx_destroy(&cache->lock);
+   for (unsigned i = 0; i < VK_PIPELINE_CACHE_NUM_SHARDS; i++) {
+      if (cache->shards[i].objects)
+         _mesa_set_destroy(cache->shards[i].objects, object_unref_cb);
+      simple_mtx_destroy(&cache->shards[i].lock);
+   }
    vk_object_free(cache->base.device, pAllocator, cache);
 }
 
@@ -696,11 +924,16 @@ vk_common_GetPipelineCacheData(VkDevice _device,
       return VK_INCOMPLETE;
    }
 
-   vk_pipeline_cache_lock(cache);
-
    VkResult result = VK_SUCCESS;
-   if (cache->object_cache != NULL) {
-      set_foreach(cache->object_cache, entry) {
+   for (unsigned i = 0; i < VK_PIPELINE_CACHE_NUM_SHARDS; i++) {
+      struct vk_pipeline_cache_shard *shard = &cache->shards[i];
+
+      if (shard->objects == NULL)
+         continue;
+
+      vk_pipeline_cache_lock(cache, shard);
+
+      set_foreach(shard->objects, entry) {
          struct vk_pipeline_cache_object *object = (void *)entry->key;
 
          if (object->ops->serialize == NULL)
@@ -734,10 +967,15 @@ vk_common_GetPipelineCacheData(VkDevice _device,
 
          assert(data_size_resv >= 0);
          blob_overwrite_uint32(&blob, data_size_resv, data_size);
+
+         count++;
       }
-   }
 
-   vk_pipeline_cache_unlock(cache);
+      vk_pipeline_cache_unlock(cache, shard);
+
+      if (result != VK_SUCCESS)
+         break;
+   }
 
    blob_overwrite_uint32(&blob, count_offset, count);
 
@@ -759,49 +997,56 @@ vk_common_MergePipelineCaches(VkDevice device,
    if (!dst->object_cache)
       return VK_SUCCESS;
 
-   vk_pipeline_cache_lock(dst);
+   /* An object is in the shard with the same index in every cache. */
+   for (unsigned s = 0; s < VK_PIPELINE_CACHE_NUM_SHARDS; s++) {
+      struct vk_pipeline_cache_shard *dst_shard = &dst->shards[s];
 
-   for (uint32_t i = 0; i < srcCacheCount; i++) {
-      VK_FROM_HANDLE(vk_pipeline_cache, src, pSrcCaches[i]);
+      vk_pipeline_cache_lock(dst, dst_shard);
 
-      if (!src->object_cache)
-         continue;
+      for (uint32_t i = 0; i < srcCacheCount; i++) {
+         VK_FROM_HANDLE(vk_pipeline_cache, src, pSrcCaches[i]);
 
-      assert(src != dst);
-      if (src == dst)
-         continue;
+         if (!src->object_cache)
+            continue;
 
-      vk_pipeline_cache_lock(src);
-
-      set_foreach(src->object_cache, src_entry) {
-         struct vk_pipeline_cache_object *src_object = (void *)src_entry->key;
-
-         bool found_in_dst = false;
-         struct set_entry *dst_entry =
-            _mesa_set_search_or_add_pre_hashed(dst->object_cache,
-                                               src_entry->hash,
-                                               src_object, &found_in_dst);
-         if (found_in_dst) {
-            struct vk_pipeline_cache_object *dst_object = (void *)dst_entry->key;
-            if (dst_object->ops == &raw_data_object_ops &&
-                src_object->ops != &raw_data_object_ops) {
-               /* Even though dst has the object, it only has the blob version
-                * which isn't as useful.  Replace it with the real object.
-                */
-               vk_pipeline_cache_object_unref(dst_object);
-               dst_entry->key = vk_pipeline_cache_object_ref(src_object);
+         assert(src != dst);
+         if (src == dst)
+            continue;
+
+         struct vk_pipeline_cache_shard *src_shard = &src->shards[s];
+
+         vk_pipeline_cache_lock(src, src_shard);
+
+         set_foreach(src_shard->objects, src_entry) {
+            struct vk_pipeline_cache_object *src_object = (void *)src_entry->key;
+
+            bool found_in_dst = false;
+            struct set_entry *dst_entry =
+               _mesa_set_search_or_add_pre_hashed(dst_shard->objects,
+                                                  src_entry->hash,
+                                                  src_object, &found_in_dst);
+            if (found_in_dst) {
+               struct vk_pipeline_cache_object *dst_object = (void *)dst_entry->key;
+               if (dst_object->ops == &raw_data_object_ops &&
+                   src_object->ops != &raw_data_object_ops) {
+                  /* Even though dst has the object, it only has the blob version
+                   * which isn't as useful.  Replace it with the real object.
+                   */
+                  vk_pipeline_cache_object_unref(dst_object);
+                  dst_entry->key = vk_pipeline_cache_object_ref(src_object);
+               }
+            } else {
+               /* We inserted src_object in dst so it needs a reference */
+               assert(dst_entry->key == (const void *)src_object);
+               vk_pipeline_cache_object_ref(src_object);
             }
-         } else {
-            /* We inserted src_object in dst so it needs a reference */
-            assert(dst_entry->key == (const void *)src_object);
-            vk_pipeline_cache_object_ref(src_object);
          }
+
+         vk_pipeline_cache_unlock(src, src_shard);
       }
 
-      vk_pipeline_cache_unlock(src);
+      vk_pipeline_cache_unlock(dst, dst_shard);
    }
 
-   vk_pipeline_cache_unlock(dst);
-
    return VK_SUCCESS;
 }
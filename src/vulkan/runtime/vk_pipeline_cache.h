@@ -151,6 +151,16 @@ vk_pipeline_cache_object_unref(struct vk_pipeline_cache_object *object)
       object->ops->destroy(object);
 }
 
+/** Number of independently locked parts of the object cache */
+#define VK_PIPELINE_CACHE_NUM_SHARDS 16
+
+struct vk_pipeline_cache_shard {
+   /** Protects objects */
+   simple_mtx_t lock;
+
+   struct set *objects;
+};
+
 /** A generic implementation of VkPipelineCache */
 struct vk_pipeline_cache {
    struct vk_object_base base;
@@ -160,10 +170,13 @@ struct vk_pipeline_cache {
 
    struct vk_pipeline_cache_header header;
 
-   /** Protects object_cache */
-   simple_mtx_t lock;
+   /** True if objects are cached in memory */
+   bool object_cache;
 
-   struct set *object_cache;
+   /** The cached objects, spread across the shards by their key hash so that
+    * threads creating different pipelines rarely wait for each other.
+    */
+   struct vk_pipeline_cache_shard shards[VK_PIPELINE_CACHE_NUM_SHARDS];
 };
 
 VK_DEFINE_NONDISP_HANDLE_CASTS(vk_pipeline_cache, base, VkPipelineCache,
@@ -251,6 +264,28 @@ vk_pipeline_cache_add_nir(struct vk_pipeline_cache *cache,
                           const void *key_data, size_t key_size,
                           const struct nir_shader *nir);
 
+/** Looks up a NIR shader stored along with driver-defined data
+ *
+ * This is for drivers which cache NIR after their own lowering passes, when
+ * the NIR alone isn't enough to pick up compilation where it left off.  On
+ * success, *data and *data_size are set to a copy of the data passed to
+ * vk_pipeline_cache_add_nir_with_data(), allocated out of mem_ctx.
+ *
+ * The key space is shared with vk_pipeline_cache_lookup_nir() so drivers
+ * must make sure the two never use the same key.
+ */
+struct nir_shader *
+vk_pipeline_cache_lookup_nir_with_data(struct vk_pipeline_cache *cache,
+                                       const void *key_data, size_t key_size,
+                                       const struct nir_shader_compiler_options *nir_options,
+                                       bool *cache_hit, void *mem_ctx,
+                                       void **data, size_t *data_size);
+void
+vk_pipeline_cache_add_nir_with_data(struct vk_pipeline_cache *cache,
+                                    const void *key_data, size_t key_size,
+                                    const struct nir_shader *nir,
+                                    const void *data, size_t data_size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -472,41 +472,64 @@ vk_queue_submit_thread_func(void *_data)
          continue;
       }
 
-      struct vk_queue_submit *submit =
+      /* Take everything queued so far as one batch.  Submits are only
+       * appended while we work, so the entries up to and including the
+       * current tail can be walked without the lock as long as we don't
+       * look past it.
+       */
+      struct vk_queue_submit *first =
          list_first_entry(&queue->submit.submits,
                           struct vk_queue_submit, link);
+      struct vk_queue_submit *last =
+         list_last_entry(&queue->submit.submits,
+                         struct vk_queue_submit, link);
 
       /* Drop the lock while we wait */
       mtx_unlock(&queue->submit.mutex);
 
-      result = vk_sync_wait_many(queue->base.device,
-                                 submit->wait_count, submit->waits,
-                                 VK_SYNC_WAIT_PENDING, UINT64_MAX);
-      if (unlikely(result != VK_SUCCESS)) {
-         vk_queue_set_lost(queue, "Wait for time points failed");
-         return 1;
-      }
+      struct vk_queue_submit *submit = first;
+      while (true) {
+         result = vk_sync_wait_many(queue->base.device,
+                                    submit->wait_count, submit->waits,
+                                    VK_SYNC_WAIT_PENDING, UINT64_MAX);
+         if (unlikely(result != VK_SUCCESS)) {
+            vk_queue_set_lost(queue, "Wait for time points failed");
+            return 1;
+         }
 
-      result = vk_queue_submit_final(queue, submit);
-      if (unlikely(result != VK_SUCCESS)) {
-         vk_queue_set_lost(queue, "queue::driver_submit failed");
-         return 1;
-      }
+         result = vk_queue_submit_final(queue, submit);
+         if (unlikely(result != VK_SUCCESS)) {
+            vk_queue_set_lost(queue, "queue::driver_submit failed");
+            return 1;
+         }
 
-      /* Do all our cleanup of individual fences etc. outside the lock.
-       * We can't actually remove it from the list yet.  We have to do
-       * that under the lock.
-       */
-      vk_queue_submit_cleanup(queue, submit);
+         /* Do all our cleanup of individual fences etc. outside the lock.
+          * We can't actually remove it from the list yet.  We have to do
+          * that under the lock.
+          */
+         vk_queue_submit_cleanup(queue, submit);
+
+         if (submit == last)
+            break;
+
+         submit = list_entry(submit->link.next, struct vk_queue_submit, link);
+      }
 
       mtx_lock(&queue->submit.mutex);
 
-      /* Only remove the submit from from the list and free it after
+      /* Only remove the submits from the list and free them after
        * queue->submit() has completed.  This ensures that, when
        * vk_queue_drain() completes, there are no more pending jobs.
        */
-      list_del(&submit->link);
-      vk_queue_submit_free(queue, submit);
+      bool batch_done;
+      do {
+         submit = list_first_entry(&queue->submit.submits,
+                                   struct vk_queue_submit, link);
+         batch_done = submit == last;
+
+         list_del(&submit->link);
+         vk_queue_submit_free(queue, submit);
+      } while (!batch_done);
 
       cnd_broadcast(&queue->submit.pop);
    }
@@ -813,6 +813,86 @@ vk_common_CreateRenderPass2(VkDevice _device,
       }
    }
 
+   /* Everything begin_subpass() and vkCmdEndRenderPass2 need from the
+    * dependencies and attachment lists is fixed for the lifetime of the
+    * render pass, so compute it here once instead of on every subpass.
+    */
+   for (uint32_t s = 0; s < pass->subpass_count; s++) {
+      struct vk_subpass *subpass = &pass->subpasses[s];
+
+      subpass->dep_barrier = (VkMemoryBarrier2) {
+         .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+      };
+
+      for (uint32_t d = 0; d < pass->dependency_count; d++) {
+         const struct vk_subpass_dependency *dep = &pass->dependencies[d];
+         if (dep->dst_subpass != s)
+            continue;
+
+         if (dep->flags & VK_DEPENDENCY_VIEW_LOCAL_BIT) {
+            /* From the Vulkan 1.3.204 spec:
+             *
+             *    VUID-VkSubpassDependency2-dependencyFlags-03091
+             *
+             *    "If dependencyFlags includes VK_DEPENDENCY_VIEW_LOCAL_BIT,
+             *    dstSubpass must not be equal to VK_SUBPASS_EXTERNAL"
+             */
+            assert(dep->src_subpass != VK_SUBPASS_EXTERNAL);
+
+            assert(dep->src_subpass < pass->subpass_count);
+            const struct vk_subpass *src_subpass =
+               &pass->subpasses[dep->src_subpass];
+
+            /* Figure out the set of views in the source subpass affected by
+             * this dependency.
+             */
+            uint32_t src_dep_view_mask = subpass->view_mask;
+            if (dep->view_offset >= 0)
+               src_dep_view_mask <<= dep->view_offset;
+            else
+               src_dep_view_mask >>= -dep->view_offset;
+
+            /* From the Vulkan 1.3.204 spec:
+             *
+             *    "If the dependency is view-local, then each view (dstView)
+             *    in the destination subpass depends on the view dstView +
+             *    pViewOffsets[dependency] in the source subpass. If there is
+             *    not such a view in the source subpass, then this dependency
+             *    does not affect that view in the destination subpass."
+             */
+            if (!(src_subpass->view_mask & src_dep_view_mask))
+               continue;
+         }
+
+         subpass->has_dep_barrier = true;
+         subpass->dep_barrier.srcStageMask |= dep->src_stage_mask;
+         subpass->dep_barrier.srcAccessMask |= dep->src_access_mask;
+         subpass->dep_barrier.dstStageMask |= dep->dst_stage_mask;
+         subpass->dep_barrier.dstAccessMask |= dep->dst_access_mask;
+      }
+
+      for (uint32_t a = 0; a < subpass->attachment_count; a++) {
+         const struct vk_subpass_attachment *sp_att = &subpass->attachments[a];
+         if (sp_att->attachment == VK_ATTACHMENT_UNUSED)
+            continue;
+
+         assert(sp_att->attachment < pass->attachment_count);
+         const struct vk_render_pass_attachment *rp_att =
+            &pass->attachments[sp_att->attachment];
+
+         subpass->max_image_barrier_count +=
+            util_bitcount(subpass->view_mask) *
+            util_bitcount(rp_att->aspects);
+      }
+   }
+
+   for (uint32_t a = 0; a < pass->attachment_count; a++) {
+      const struct vk_render_pass_attachment *rp_att = &pass->attachments[a];
+
+      pass->max_final_image_barrier_count +=
+         util_bitcount(pass->view_mask) * util_bitcount(rp_att->aspects);
+   }
+
    *pRenderPass = vk_render_pass_to_handle(pass);
 
    return VK_SUCCESS;
@@ -1869,70 +1949,7 @@ begin_subpass(struct vk_command_buffer *cmd_buffer,
     * number of VkImageMemoryBarriers for layout transitions.
     */
 
-   bool needs_mem_barrier = false;
-   VkMemoryBarrier2 mem_barrier = {
-      .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
-   };
-   for (uint32_t d = 0; d < pass->dependency_count; d++) {
-      const struct vk_subpass_dependency *dep = &pass->dependencies[d];
-      if (dep->dst_subpass != subpass_idx)
-         continue;
-
-      if (dep->flags & VK_DEPENDENCY_VIEW_LOCAL_BIT) {
-         /* From the Vulkan 1.3.204 spec:
-          *
-          *    VUID-VkSubpassDependency2-dependencyFlags-03091
-          *
-          *    "If dependencyFlags includes VK_DEPENDENCY_VIEW_LOCAL_BIT,
-          *    dstSubpass must not be equal to VK_SUBPASS_EXTERNAL"
-          */
-         assert(dep->src_subpass != VK_SUBPASS_EXTERNAL);
-
-         assert(dep->src_subpass < pass->subpass_count);
-         const struct vk_subpass *src_subpass =
-            &pass->subpasses[dep->src_subpass];
-
-         /* Figure out the set of views in the source subpass affected by this
-          * dependency.
-          */
-         uint32_t src_dep_view_mask = subpass->view_mask;
-         if (dep->view_offset >= 0)
-            src_dep_view_mask <<= dep->view_offset;
-         else
-            src_dep_view_mask >>= -dep->view_offset;
-
-         /* From the Vulkan 1.3.204 spec:
-          *
-          *    "If the dependency is view-local, then each view (dstView) in
-          *    the destination subpass depends on the view dstView +
-          *    pViewOffsets[dependency] in the source subpass. If there is not
-          *    such a view in the source subpass, then this dependency does
-          *    not affect that view in the destination subpass."
-          */
-         if (!(src_subpass->view_mask & src_dep_view_mask))
-            continue;
-      }
-
-      needs_mem_barrier = true;
-      mem_barrier.srcStageMask |= dep->src_stage_mask;
-      mem_barrier.srcAccessMask |= dep->src_access_mask;
-      mem_barrier.dstStageMask |= dep->dst_stage_mask;
-      mem_barrier.dstAccessMask |= dep->dst_access_mask;
-   }
-
-   uint32_t max_image_barrier_count = 0;
-   for (uint32_t a = 0; a < subpass->attachment_count; a++) {
-      const struct vk_subpass_attachment *sp_att = &subpass->attachments[a];
-      if (sp_att->attachment == VK_ATTACHMENT_UNUSED)
-         continue;
-
-      assert(sp_att->attachment < pass->attachment_count);
-      const struct vk_render_pass_attachment *rp_att =
-         &pass->attachments[sp_att->attachment];
-
-      max_image_barrier_count += util_bitcount(subpass->view_mask) *
-                                 util_bitcount(rp_att->aspects);
-   }
+   const uint32_t max_image_barrier_count = subpass->max_image_barrier_count;
    STACK_ARRAY(VkImageMemoryBarrier2, image_barriers, max_image_barrier_count);
    uint32_t image_barrier_count = 0;
 
@@ -1953,12 +1970,13 @@ begin_subpass(struct vk_command_buffer *cmd_buffer,
    }
    assert(image_barrier_count <= max_image_barrier_count);
 
-   if (needs_mem_barrier || image_barrier_count > 0) {
+   if (subpass->has_dep_barrier || image_barrier_count > 0) {
       const VkDependencyInfo dependency_info = {
          .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
          .dependencyFlags = 0,
-         .memoryBarrierCount = needs_mem_barrier ? 1 : 0,
-         .pMemoryBarriers = needs_mem_barrier ? &mem_barrier : NULL,
+         .memoryBarrierCount = subpass->has_dep_barrier ? 1 : 0,
+         .pMemoryBarriers = subpass->has_dep_barrier ?
+                            &subpass->dep_barrier : NULL,
          .imageMemoryBarrierCount = image_barrier_count,
          .pImageMemoryBarriers = image_barrier_count > 0 ?
                                  image_barriers : NULL,
@@ -2246,13 +2264,8 @@ vk_common_CmdEndRenderPass2(VkCommandBuffer commandBuffer,
 
    /* Make sure all our attachments end up in their finalLayout */
 
-   uint32_t max_image_barrier_count = 0;
-   for (uint32_t a = 0; a < pass->attachment_count; a++) {
-      const struct vk_render_pass_attachment *rp_att = &pass->attachments[a];
-
-      max_image_barrier_count += util_bitcount(pass->view_mask) *
-                                 util_bitcount(rp_att->aspects);
-   }
+   const uint32_t max_image_barrier_count =
+      pass->max_final_image_barrier_count;
    STACK_ARRAY(VkImageMemoryBarrier2, image_barriers, max_image_barrier_count);
    uint32_t image_barrier_count = 0;
 
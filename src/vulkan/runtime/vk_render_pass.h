@@ -199,6 +199,24 @@ struct vk_subpass {
 
    /** VkMultisampledRenderToSingleSampledInfoEXT for this subpass */
    VkMultisampledRenderToSingleSampledInfoEXT mrtss;
+
+   /** True if any subpass dependency targets this subpass
+    *
+    * If set, dep_barrier has to be emitted before the subpass begins.
+    */
+   bool has_dep_barrier;
+
+   /** Union of all subpass dependencies which target this subpass
+    *
+    * This only depends on the render pass so it is computed once at
+    * vkCreateRenderPass2 time rather than on every vkCmdNextSubpass2.
+    */
+   VkMemoryBarrier2 dep_barrier;
+
+   /** Upper bound on the number of image barriers needed for the layout
+    * transitions at the start of this subpass
+    */
+   uint32_t max_image_barrier_count;
 };
 
 struct vk_render_pass_attachment {
@@ -307,6 +325,11 @@ struct vk_render_pass {
 
    /** VkRenderPassCreateInfo2::pDependencies */
    struct vk_subpass_dependency *dependencies;
+
+   /** Upper bound on the number of image barriers needed for the final
+    * layout transitions in vkCmdEndRenderPass2
+    */
+   uint32_t max_final_image_barrier_count;
 };
 
 VK_DEFINE_NONDISP_HANDLE_CASTS(vk_render_pass, base, VkRenderPass,
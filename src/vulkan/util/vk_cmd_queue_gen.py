@@ -78,6 +78,12 @@ struct vk_device_dispatch_table;
 struct vk_cmd_queue {
    const VkAllocationCallbacks *alloc;
    struct list_head cmds;
+
+   /* Entries and everything they point to are allocated from a linear
+    * arena owned by mem_ctx, so the whole queue is freed at once.
+    */
+   void *mem_ctx;
+   void *lin_ctx;
 };
 
 enum vk_cmd_type {
@@ -151,6 +157,8 @@ struct vk_cmd_queue_entry {
 
 % endfor
 
+void *vk_cmd_queue_zalloc(struct vk_cmd_queue *queue, size_t size);
+
 void vk_free_queue(struct vk_cmd_queue *queue);
 
 static inline void
@@ -158,6 +166,8 @@ vk_cmd_queue_init(struct vk_cmd_queue *queue, VkAllocationCallbacks *alloc)
 {
    queue->alloc = alloc;
    list_inithead(&queue->cmds);
+   queue->mem_ctx = NULL;
+   queue->lin_ctx = NULL;
 }
 
 static inline void
@@ -191,6 +201,8 @@ TEMPLATE_C = Template(COPYRIGHT + """
 #define VK_PROTOTYPES
 #include <vulkan/vulkan.h>
 
+#include "util/ralloc.h"
+
 #include "vk_alloc.h"
 #include "vk_cmd_enqueue_entrypoints.h"
 #include "vk_command_buffer.h"
@@ -209,29 +221,26 @@ const char *vk_cmd_queue_type_names[] = {
 % endfor
 };
 
+void *
+vk_cmd_queue_zalloc(struct vk_cmd_queue *queue, size_t size)
+{
+   if (queue->lin_ctx == NULL) {
+      queue->mem_ctx = ralloc_context(NULL);
+      queue->lin_ctx = linear_alloc_parent(queue->mem_ctx, 0);
+      if (queue->lin_ctx == NULL) {
+         ralloc_free(queue->mem_ctx);
+         queue->mem_ctx = NULL;
+         return NULL;
+      }
+   }
+
+   return linear_zalloc_child(queue->lin_ctx, size);
+}
+
 % for c in commands:
 % if c.guard is not None:
 #ifdef ${c.guard}
 % endif
-static void
-vk_free_${to_underscore(c.name)}(struct vk_cmd_queue *queue,
-${' ' * len('vk_free_' + to_underscore(c.name) + '(')}\\
-struct vk_cmd_queue_entry *cmd)
-{
-   if (cmd->driver_free_cb)
-      cmd->driver_free_cb(queue, cmd);
-   else
-      vk_free(queue->alloc, cmd->driver_data);
-% for p in c.params[1:]:
-% if p.len:
-   vk_free(queue->alloc, (${remove_suffix(p.decl.replace("const", ""), p.name)})cmd->u.${to_struct_field_name(c.name)}.${to_field_name(p.name)});
-% elif '*' in p.decl:
-   ${get_struct_free(c, p, types)}
-% endif
-% endfor
-   vk_free(queue->alloc, cmd);
-}
-
 % if c.name not in manual_commands and c.name not in no_enqueue_commands:
 VkResult vk_enqueue_${to_underscore(c.name)}(struct vk_cmd_queue *queue
 % for p in c.params[1:]:
@@ -239,9 +248,7 @@ VkResult vk_enqueue_${to_underscore(c.name)}(struct vk_cmd_queue *queue
 % endfor
 )
 {
-   struct vk_cmd_queue_entry *cmd = vk_zalloc(queue->alloc,
-                                              sizeof(*cmd), 8,
-                                              VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+   struct vk_cmd_queue_entry *cmd = vk_cmd_queue_zalloc(queue, sizeof(*cmd));
    if (!cmd) return VK_ERROR_OUT_OF_HOST_MEMORY;
 
    cmd->type = ${to_enum_name(c.name)};
@@ -271,8 +278,7 @@ VkResult vk_enqueue_${to_underscore(c.name)}(struct vk_cmd_queue *queue
 
 % if need_error_handling:
 err:
-   if (cmd)
-      vk_free_${to_underscore(c.name)}(queue, cmd);
+   /* The partial entry isn't in the list, the arena reclaims it on reset */
    return VK_ERROR_OUT_OF_HOST_MEMORY;
 % endif
 }
@@ -286,22 +292,17 @@ err:
 void
 vk_free_queue(struct vk_cmd_queue *queue)
 {
-   struct vk_cmd_queue_entry *tmp, *cmd;
-   LIST_FOR_EACH_ENTRY_SAFE(cmd, tmp, &queue->cmds, cmd_link) {
-      switch(cmd->type) {
-% for c in commands:
-% if c.guard is not None:
-#ifdef ${c.guard}
-% endif
-      case ${to_enum_name(c.name)}:
-         vk_free_${to_underscore(c.name)}(queue, cmd);
-         break;
-% if c.guard is not None:
-#endif // ${c.guard}
-% endif
-% endfor
-      }
+   /* Only driver data lives outside of the arena */
+   list_for_each_entry(struct vk_cmd_queue_entry, cmd, &queue->cmds, cmd_link) {
+      if (cmd->driver_free_cb)
+         cmd->driver_free_cb(queue, cmd);
+      else
+         vk_free(queue->alloc, cmd->driver_data);
    }
+
+   ralloc_free(queue->mem_ctx);
+   queue->mem_ctx = NULL;
+   queue->lin_ctx = NULL;
 }
 
 void
@@ -425,7 +426,7 @@ def get_array_copy(command, param):
         field_size = "1"
     else:
         field_size = "sizeof(*%s)" % field_name
-    allocation = "%s = vk_zalloc(queue->alloc, %s * (%s), 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);\n   if (%s == NULL) goto err;\n" % (field_name, field_size, param.len, field_name)
+    allocation = "%s = vk_cmd_queue_zalloc(queue, %s * (%s));\n   if (%s == NULL) goto err;\n" % (field_name, field_size, param.len, field_name)
     const_cast = remove_suffix(param.decl.replace("const", ""), param.name)
     copy = "memcpy((%s)%s, %s, %s * (%s));" % (const_cast, field_name, param.name, field_size, param.len)
     return "%s\n   %s" % (allocation, copy)
@@ -436,7 +437,7 @@ def get_array_member_copy(struct, src_name, member):
         field_size = "sizeof(*%s)" % (field_name)
     else:
         field_size = "sizeof(*%s) * %s->%s" % (field_name, struct, member.len)
-    allocation = "%s = vk_zalloc(queue->alloc, %s, 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);\n   if (%s == NULL) goto err;\n" % (field_name, field_size, field_name)
+    allocation = "%s = vk_cmd_queue_zalloc(queue, %s);\n   if (%s == NULL) goto err;\n" % (field_name, field_size, field_name)
     const_cast = remove_suffix(member.decl.replace("const", ""), member.name)
     copy = "memcpy((%s)%s, %s->%s, %s);" % (const_cast, field_name, src_name, member.name, field_size)
     return "if (%s->%s) {\n   %s\n   %s\n}\n" % (src_name, member.name, allocation, copy)
@@ -466,7 +467,7 @@ def get_struct_copy(dst, src_name, src_type, size, types, level=0):
     global tmp_dst_idx
     global tmp_src_idx
 
-    allocation = "%s = vk_zalloc(queue->alloc, %s, 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);\n      if (%s == NULL) goto err;\n" % (dst, size, dst)
+    allocation = "%s = vk_cmd_queue_zalloc(queue, %s);\n      if (%s == NULL) goto err;\n" % (dst, size, dst)
     copy = "memcpy((void*)%s, %s, %s);" % (dst, src_name, size)
 
     level += 1
@@ -485,19 +486,6 @@ def get_struct_copy(dst, src_name, src_type, size, types, level=0):
     if_stmt = "if (%s) {" % src_name
     return "%s\n      %s\n      %s\n   %s\n   %s   \n   %s   } else {\n      %s\n   }" % (if_stmt, allocation, copy, tmp_dst, tmp_src, member_copies, null_assignment)
 
-def get_struct_free(command, param, types):
-    field_name = "cmd->u.%s.%s" % (to_struct_field_name(command.name), to_field_name(param.name))
-    const_cast = remove_suffix(param.decl.replace("const", ""), param.name)
-    struct_free = "vk_free(queue->alloc, (%s)%s);" % (const_cast, field_name)
-    member_frees = ""
-    if (param.type in types):
-        for member in types[param.type].members:
-            if member.len and member.len != 'null-terminated':
-                member_name = "cmd->u.%s.%s->%s" % (to_struct_field_name(command.name), to_field_name(param.name), member.name)
-                const_cast = remove_suffix(member.decl.replace("const", ""), member.name)
-                member_frees += "vk_free(queue->alloc, (%s)%s);\n" % (const_cast, member_name)
-    return "%s      %s\n" % (member_frees, struct_free)
-
 EntrypointType = namedtuple('EntrypointType', 'name enum members extended_by')
 
 def get_types(doc):
@@ -578,7 +566,6 @@ def main():
         'to_struct_name': to_struct_name,
         'get_array_copy': get_array_copy,
         'get_struct_copy': get_struct_copy,
-        'get_struct_free': get_struct_free,
         'types': types,
         'manual_commands': MANUAL_COMMANDS,
         'no_enqueue_commands': NO_ENQUEUE_COMMANDS,
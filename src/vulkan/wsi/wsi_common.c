@@ -38,6 +38,7 @@
 #include "vk_sync_dummy.h"
 #include "vk_util.h"
 
+#include <inttypes.h>
 #include <time.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -53,6 +54,7 @@ static const struct debug_control debug_control[] = {
    { "sw",           WSI_DEBUG_SW },
    { "noshm",        WSI_DEBUG_NOSHM },
    { "linear",       WSI_DEBUG_LINEAR },
+   { "stats",        WSI_DEBUG_STATS },
    { NULL, },
 };
 
@@ -444,6 +446,14 @@ wsi_swapchain_get_present_mode(struct wsi_device *wsi,
 void
 wsi_swapchain_finish(struct wsi_swapchain *chain)
 {
+   if (WSI_DEBUG & WSI_DEBUG_STATS) {
+      fprintf(stderr, "WSI: swapchain %p: %" PRIu64 " presents, "
+              "%" PRIu64 " buffer blits%s\n", (void *)chain,
+              chain->present_count, chain->blit_count,
+              chain->buffer_blit_queue != VK_NULL_HANDLE ?
+              " (on the blit queue)" : "");
+   }
+
    wsi_destroy_image_info(chain, &chain->image_info);
 
    if (chain->fences) {
@@ -1140,7 +1150,9 @@ wsi_common_queue_present(const struct wsi_device *wsi,
          swapchain->get_wsi_image(swapchain, image_index);
 
       VkQueue submit_queue = queue;
+      swapchain->present_count++;
       if (swapchain->use_buffer_blit) {
+         swapchain->blit_count++;
          if (swapchain->buffer_blit_queue == VK_NULL_HANDLE) {
             submit_info.commandBufferCount = 1;
             submit_info.pCommandBuffers =
@@ -144,6 +144,11 @@ struct wsi_device {
        * true.
        */
       bool xwaylandWaitReady;
+
+      /* Maximum number of FIFO presents waiting for vblank before acquire
+       * starts throttling the application.  0 = no limit.
+       */
+      uint32_t max_pendingFrames;
    } x11;
 
    bool sw;
@@ -35,6 +35,7 @@ struct wsi_swapchain;
 #define WSI_DEBUG_SW          (1ull << 1)
 #define WSI_DEBUG_NOSHM       (1ull << 2)
 #define WSI_DEBUG_LINEAR      (1ull << 3)
+#define WSI_DEBUG_STATS       (1ull << 4)
 
 extern uint64_t WSI_DEBUG;
 
@@ -150,6 +151,12 @@ struct wsi_swapchain {
     */
    VkQueue buffer_blit_queue;
 
+   /* Number of images presented and how many of those needed a blit into a
+    * linear/prime buffer, printed on destroy with MESA_VK_WSI_DEBUG=stats.
+    */
+   uint64_t present_count;
+   uint64_t blit_count;
+
    /* Command pools, one per queue family */
    VkCommandPool *cmd_pools;
 
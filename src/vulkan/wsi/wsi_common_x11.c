@@ -958,6 +958,15 @@ struct x11_swapchain {
    uint32_t                                     stamp;
    atomic_int                                   sent_image_count;
 
+   /* Presentation feedback used to pace acquires in FIFO mode: the time of
+    * the last completed present, the estimated refresh interval and the
+    * number of presents queued by the app and completed by the server.
+    */
+   atomic_uint_least64_t                        last_present_ns;
+   atomic_uint_least64_t                        refresh_ns;
+   uint64_t                                     queued_present_count;
+   atomic_uint_least64_t                        completed_present_count;
+
    bool                                         has_present_queue;
    bool                                         has_acquire_queue;
    VkResult                                     status;
@@ -1073,6 +1082,20 @@ x11_handle_dri3_present_event(struct x11_swapchain *chain,
             if (image->present_queued && image->serial == complete->serial)
                image->present_queued = false;
          }
+
+         /* Keep a running estimate of the refresh interval, smoothed to
+          * ignore the occasional late completion event.
+          */
+         const uint64_t present_ns = complete->ust * 1000;
+         if (chain->last_present_ns && present_ns > chain->last_present_ns &&
+             complete->msc > chain->last_present_msc) {
+            const uint64_t interval = (present_ns - chain->last_present_ns) /
+                                      (complete->msc - chain->last_present_msc);
+            const uint64_t refresh = chain->refresh_ns;
+            chain->refresh_ns = refresh ? (refresh * 7 + interval) / 8 : interval;
+         }
+         chain->last_present_ns = present_ns;
+         chain->completed_present_count++;
          chain->last_present_msc = complete->msc;
       }
 
@@ -1190,6 +1213,41 @@ x11_acquire_next_image_poll_x11(struct x11_swapchain *chain,
    }
 }
 
+/**
+ * Delay an acquire until enough of the queued presents have reached the
+ * screen, so that the application doesn't render too far ahead of scanout.
+ * The time of the next vblanks is predicted from the completion events.
+ */
+static void
+x11_throttle_acquire(struct x11_swapchain *chain, uint64_t timeout)
+{
+   const uint32_t max_pending = chain->base.wsi->x11.max_pendingFrames;
+   if (max_pending == 0 || timeout == 0)
+      return;
+
+   const uint64_t pending =
+      chain->queued_present_count - chain->completed_present_count;
+   if (pending < max_pending)
+      return;
+
+   const uint64_t refresh_ns = chain->refresh_ns;
+   const uint64_t last_present_ns = chain->last_present_ns;
+   if (!refresh_ns || !last_present_ns)
+      return;
+
+   /* In FIFO mode every pending present retires on its own vblank, wait
+    * until one slot is free for the present following this acquire.
+    */
+   const uint64_t target_ns =
+      last_present_ns + (pending - max_pending + 1) * refresh_ns;
+   const uint64_t now_ns = os_time_get_nano();
+   if (target_ns <= now_ns)
+      return;
+
+   MESA_TRACE_SCOPE("throttle acquire");
+   os_time_sleep(MIN2(target_ns - now_ns, timeout) / 1000);
+}
+
 /**
  * Acquire a ready-to-use image from the acquire-queue. Only relevant in fifo
  * presentation mode.
@@ -1200,6 +1258,8 @@ x11_acquire_next_image_from_queue(struct x11_swapchain *chain,
 {
    assert(chain->has_acquire_queue);
 
+   x11_throttle_acquire(chain, timeout);
+
    uint32_t image_index;
    VkResult result = wsi_queue_pull(&chain->acquire_queue,
                                     &image_index, timeout);
@@ -1454,6 +1514,7 @@ x11_queue_present(struct wsi_swapchain *anv_chain,
 
    chain->images[image_index].busy = true;
    if (chain->has_present_queue) {
+      chain->queued_present_count++;
       wsi_queue_push(&chain->present_queue, image_index);
       return chain->status;
    } else {
@@ -2277,6 +2338,10 @@ wsi_x11_init_wsi(struct wsi_device *wsi_device,
          wsi_device->x11.xwaylandWaitReady =
             driQueryOptionb(dri_options, "vk_xwayland_wait_ready");
       }
+      if (driCheckOption(dri_options, "vk_x11_max_pending_frames", DRI_INT)) {
+         wsi_device->x11.max_pendingFrames =
+            driQueryOptioni(dri_options, "vk_x11_max_pending_frames");
+      }
    }
 
    wsi->base.get_support = x11_surface_get_support;